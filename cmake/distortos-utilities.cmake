@@ -7,6 +7,9 @@
 # distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #
 
+# directory with this file, used to find scripts
+set(DISTORTOS_UTILITIES_DIRECTORY ${CMAKE_CURRENT_LIST_DIR})
+
 #
 # Adds `flag` string to cache variable `variable`. Useful for cache variables like `CMAKE_CXX_FLAGS` and similar.
 #
@@ -79,6 +82,27 @@ function(distortosHex target hexFilename)
 			VERBATIM)
 endfunction()
 
+#
+# Generates report with sizes of symbols from output file of `target` to file named `reportFilename`.
+#
+# `distortosInstantiationSizes(target reportFilename group [group ...])`
+#
+# Each `group` is a substring of demangled symbol name, like the name of class template (`distortos::FifoQueue<`), its
+# base class (`distortos::internal::FifoQueueBase::`) or a function template. Total size and number of symbols are
+# printed for each group, report also lists all symbols of each group. Useful to check how much code is generated for
+# each instantiation of templates.
+#
+
+function(distortosInstantiationSizes target reportFilename)
+	add_custom_command(TARGET ${target} POST_BUILD
+			COMMAND ${CMAKE_COMMAND} -D "NM=${CMAKE_NM}" -D "INPUT=$<TARGET_FILE:${target}>"
+					-D "OUTPUT=${reportFilename}" -D "GROUPS=${ARGN}"
+					-P ${DISTORTOS_UTILITIES_DIRECTORY}/instantiationSizes.cmake
+			BYPRODUCTS ${reportFilename}
+			VERBATIM
+			USES_TERMINAL)
+endfunction()
+
 #
 # Generates disassembly of output file of `target` to file named `lssFilename`.
 #
@@ -0,0 +1,63 @@
+#
+# file: instantiationSizes.cmake
+#
+# Script which generates report with sizes of symbols matching given substrings (like names of class templates), used
+# by distortosInstantiationSizes().
+#
+# Expected variables:
+# - NM - nm executable;
+# - INPUT - analyzed file;
+# - OUTPUT - generated report;
+# - GROUPS - list of substrings, each symbol is assigned to all groups which it contains;
+#
+# author: Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+#
+# This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+# distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+
+execute_process(COMMAND ${NM} --demangle --print-size --size-sort --reverse-sort --radix=d ${INPUT}
+		OUTPUT_VARIABLE symbols
+		RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "\"${NM}\" failed with ${result}")
+endif()
+
+string(REGEX MATCHALL "[^\n]+" lines "${symbols}")
+
+set(groupIndex 0)
+foreach(group ${GROUPS})
+	set(groupSize${groupIndex} 0)
+	set(groupSymbols${groupIndex} 0)
+	set(groupDetails${groupIndex} "")
+	math(EXPR groupIndex "${groupIndex} + 1")
+endforeach()
+
+foreach(line ${lines})
+	if(line MATCHES "^[0-9]+ 0*([0-9]+) [A-Za-z] (.+)$")
+		set(size ${CMAKE_MATCH_1})
+		set(name "${CMAKE_MATCH_2}")
+		set(groupIndex 0)
+		foreach(group ${GROUPS})
+			string(FIND "${name}" "${group}" position)
+			if(NOT position EQUAL -1)
+				math(EXPR groupSize${groupIndex} "${groupSize${groupIndex}} + ${size}")
+				math(EXPR groupSymbols${groupIndex} "${groupSymbols${groupIndex}} + 1")
+				string(APPEND groupDetails${groupIndex} "\t${size}\t${name}\n")
+			endif()
+			math(EXPR groupIndex "${groupIndex} + 1")
+		endforeach()
+	endif()
+endforeach()
+
+set(summary "")
+set(details "")
+set(groupIndex 0)
+foreach(group ${GROUPS})
+	string(APPEND summary "${groupSize${groupIndex}}\tbytes in ${groupSymbols${groupIndex}}\tsymbols - ${group}\n")
+	string(APPEND details "\n${group}\n${groupDetails${groupIndex}}")
+	math(EXPR groupIndex "${groupIndex} + 1")
+endforeach()
+
+file(WRITE ${OUTPUT} "Sizes of symbols in ${INPUT}\n\n${summary}${details}")
+message("${summary}")
@@ -0,0 +1,277 @@
+/**
+ * \file
+ * \brief Barrier class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_BARRIER_HPP_
+#define INCLUDE_DISTORTOS_BARRIER_HPP_
+
+#include "distortos/internal/scheduler/ThreadList.hpp"
+
+#include "distortos/TickClock.hpp"
+
+#include <utility>
+
+namespace distortos
+{
+
+/**
+ * \brief Barrier is a reusable synchronization primitive, which blocks a group of threads until all of them arrive
+ *
+ * Similar to std::experimental::barrier - http://en.cppreference.com/w/cpp/experimental/barrier
+ * Similar to POSIX pthread_barrier_t -
+ * http://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_barrier_wait.html
+ *
+ * Barrier's lifetime is divided into phases. Each arrival is a single operation with interrupts masked. When the
+ * expected number of participants arrives, the phase is completed - phase number is incremented, the counter is reset
+ * to the expected number of participants and all threads waiting for this phase are unblocked in one pass of the
+ * scheduler.
+ *
+ * \ingroup synchronization
+ */
+
+class Barrier
+{
+public:
+
+	/// type used for phase number
+	using Phase = uint32_t;
+
+	/// type used for number of participants
+	using Value = unsigned int;
+
+	/**
+	 * \brief Barrier's constructor
+	 *
+	 * \param [in] count is the number of participants expected in each phase
+	 */
+
+	constexpr explicit Barrier(const Value count) :
+			blockedList_{},
+			phase_{},
+			count_{count},
+			expectedCount_{count}
+	{
+
+	}
+
+	/**
+	 * \brief Barrier's destructor
+	 *
+	 * The effect of destroying a barrier upon which other threads are currently blocked is system error.
+	 */
+
+	~Barrier() = default;
+
+	/**
+	 * \brief Arrives at the barrier without waiting.
+	 *
+	 * This function never blocks, so it may be called from interrupt context.
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of phase to which the arrival
+	 * belongs, which may be passed to wait(); error codes:
+	 * - EINVAL - barrier has no participants;
+	 */
+
+	std::pair<int, Phase> arrive();
+
+	/**
+	 * \brief Arrives at the barrier and decrements the number of participants expected in all following phases.
+	 *
+	 * This function never blocks, so it may be called from interrupt context.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EINVAL - barrier has no participants;
+	 */
+
+	int arriveAndDrop();
+
+	/**
+	 * \brief Arrives at the barrier and waits for the current phase to complete.
+	 *
+	 * Arrival and blocking are done in a single operation with interrupts masked. The last thread to arrive doesn't
+	 * block.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 if the phase was completed, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - EINVAL - barrier has no participants;
+	 */
+
+	int arriveAndWait();
+
+	/**
+	 * \return number of participants that still need to arrive to complete current phase
+	 */
+
+	Value getCount() const
+	{
+		return count_;
+	}
+
+	/**
+	 * \return number of participants expected in each phase
+	 */
+
+	Value getExpectedCount() const
+	{
+		return expectedCount_;
+	}
+
+	/**
+	 * \return number of current phase
+	 */
+
+	Phase getPhase() const
+	{
+		return phase_;
+	}
+
+	/**
+	 * \brief Waits for given phase to complete for given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 * \param [in] phase is the number of phase which will be waited for, usually returned by arrive()
+	 *
+	 * \return 0 if \a phase was completed, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - \a phase was not completed before the specified timeout expired;
+	 */
+
+	int tryWaitFor(TickClock::duration duration, Phase phase);
+
+	/**
+	 * \brief Waits for given phase to complete for given duration of time.
+	 *
+	 * Template variant of tryWaitFor(TickClock::duration, Phase).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Rep is type of tick counter
+	 * \tparam Period is std::ratio type representing the tick period of the clock, seconds
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 * \param [in] phase is the number of phase which will be waited for, usually returned by arrive()
+	 *
+	 * \return 0 if \a phase was completed, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - \a phase was not completed before the specified timeout expired;
+	 */
+
+	template<typename Rep, typename Period>
+	int tryWaitFor(const std::chrono::duration<Rep, Period> duration, const Phase phase)
+	{
+		return tryWaitFor(std::chrono::duration_cast<TickClock::duration>(duration), phase);
+	}
+
+	/**
+	 * \brief Waits for given phase to complete until given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 * \param [in] phase is the number of phase which will be waited for, usually returned by arrive()
+	 *
+	 * \return 0 if \a phase was completed, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - \a phase was not completed before the specified timeout expired;
+	 */
+
+	int tryWaitUntil(TickClock::time_point timePoint, Phase phase);
+
+	/**
+	 * \brief Waits for given phase to complete until given time point.
+	 *
+	 * Template variant of tryWaitUntil(TickClock::time_point, Phase).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Duration is a std::chrono::duration type used to measure duration
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 * \param [in] phase is the number of phase which will be waited for, usually returned by arrive()
+	 *
+	 * \return 0 if \a phase was completed, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - \a phase was not completed before the specified timeout expired;
+	 */
+
+	template<typename Duration>
+	int tryWaitUntil(const std::chrono::time_point<TickClock, Duration> timePoint, const Phase phase)
+	{
+		return tryWaitUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint), phase);
+	}
+
+	/**
+	 * \brief Waits for given phase to complete.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] phase is the number of phase which will be waited for, usually returned by arrive()
+	 *
+	 * \return 0 if \a phase was completed, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 */
+
+	int wait(Phase phase);
+
+	Barrier(const Barrier&) = delete;
+	Barrier(Barrier&&) = delete;
+	const Barrier& operator=(const Barrier&) = delete;
+	Barrier& operator=(Barrier&&) = delete;
+
+private:
+
+	/**
+	 * \brief Internal version of arrive().
+	 *
+	 * Internal version with no interrupt masking. If this is the last expected arrival, the phase is completed.
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of phase to which the arrival
+	 * belongs; error codes:
+	 * - EINVAL - barrier has no participants;
+	 */
+
+	std::pair<int, Phase> arriveInternal();
+
+	/**
+	 * \brief Internal version of tryWaitUntil() and wait().
+	 *
+	 * Internal version with no interrupt masking.
+	 *
+	 * \param [in] timePoint is a pointer to time point at which the wait will be terminated, nullptr to wait
+	 * indefinitely
+	 * \param [in] phase is the number of phase which will be waited for
+	 *
+	 * \return 0 if \a phase was completed, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - \a phase was not completed before the specified timeout expired;
+	 */
+
+	int waitInternal(const TickClock::time_point* timePoint, Phase phase);
+
+	/// ThreadControlBlock objects blocked on this barrier
+	internal::ThreadList blockedList_;
+
+	/// number of current phase
+	Phase phase_;
+
+	/// number of participants that still need to arrive to complete current phase
+	Value count_;
+
+	/// number of participants expected in each phase
+	Value expectedCount_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_BARRIER_HPP_
@@ -2,7 +2,7 @@
  * \file
  * \brief FifoQueue class header
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -14,13 +14,11 @@
 
 #include "distortos/internal/synchronization/FifoQueueBase.hpp"
 #include "distortos/internal/synchronization/BoundQueueFunctor.hpp"
-#include "distortos/internal/synchronization/CopyConstructQueueFunctor.hpp"
-#include "distortos/internal/synchronization/MoveConstructQueueFunctor.hpp"
-#include "distortos/internal/synchronization/SwapPopQueueFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreWaitFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreTryWaitFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreTryWaitForFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreTryWaitUntilFunctor.hpp"
+#include "distortos/internal/synchronization/ThunkQueueFunctor.hpp"
 
 #if __GNUC_PREREQ(5, 1) != 1
 // GCC 4.8 doesn't support parameter pack expansion in lambdas
@@ -97,6 +95,24 @@ public:
 		return emplaceInternal(semaphoreWaitFunctor, std::forward<Args>(args)...);
 	}
 
+	/**
+	 * \return max number of elements in queue
+	 */
+
+	size_t getCapacity() const
+	{
+		return fifoQueueBase_.getCapacity();
+	}
+
+	/**
+	 * \return current number of elements in queue
+	 */
+
+	size_t getSize() const
+	{
+		return fifoQueueBase_.getSize();
+	}
+
 	/**
 	 * \brief Pops the oldest (first) element from the queue.
 	 *
@@ -112,8 +128,7 @@ public:
 
 	int pop(T& value)
 	{
-		const internal::SemaphoreWaitFunctor semaphoreWaitFunctor;
-		return popInternal(semaphoreWaitFunctor, value);
+		return fifoQueueBase_.pop(internal::makeSwapPopQueueFunctor(value));
 	}
 
 	/**
@@ -130,8 +145,7 @@ public:
 
 	int push(const T& value)
 	{
-		const internal::SemaphoreWaitFunctor semaphoreWaitFunctor;
-		return pushInternal(semaphoreWaitFunctor, value);
+		return fifoQueueBase_.push(internal::makeCopyConstructQueueFunctor(value));
 	}
 
 	/**
@@ -149,8 +163,26 @@ public:
 
 	int push(T&& value)
 	{
-		const internal::SemaphoreWaitFunctor semaphoreWaitFunctor;
-		return pushInternal(semaphoreWaitFunctor, std::move(value));
+		return fifoQueueBase_.push(internal::makeMoveConstructQueueFunctor(value));
+	}
+
+	/**
+	 * \brief Registers current thread as a producer of the queue.
+	 *
+	 * While \a queueProducer is registered, current thread inherits the priority of the highest priority thread blocked
+	 * on "pop" functions of the queue.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] queueProducer is a reference to QueueProducer object which will be registered
+	 *
+	 * \return 0 if \a queueProducer was registered successfully, error code otherwise:
+	 * - EBUSY - \a queueProducer is already registered;
+	 */
+
+	int registerProducer(QueueProducer& queueProducer)
+	{
+		return fifoQueueBase_.registerProducer(queueProducer);
 	}
 
 	/**
@@ -289,8 +321,7 @@ public:
 
 	int tryPop(T& value)
 	{
-		internal::SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
-		return popInternal(semaphoreTryWaitFunctor, value);
+		return fifoQueueBase_.tryPop(internal::makeSwapPopQueueFunctor(value));
 	}
 
 	/**
@@ -309,8 +340,7 @@ public:
 
 	int tryPopFor(const TickClock::duration duration, T& value)
 	{
-		const internal::SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
-		return popInternal(semaphoreTryWaitForFunctor, value);
+		return fifoQueueBase_.tryPopFor(duration, internal::makeSwapPopQueueFunctor(value));
 	}
 
 	/**
@@ -354,8 +384,7 @@ public:
 
 	int tryPopUntil(const TickClock::time_point timePoint, T& value)
 	{
-		const internal::SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
-		return popInternal(semaphoreTryWaitUntilFunctor, value);
+		return fifoQueueBase_.tryPopUntil(timePoint, internal::makeSwapPopQueueFunctor(value));
 	}
 
 	/**
@@ -394,8 +423,7 @@ public:
 
 	int tryPush(const T& value)
 	{
-		const internal::SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
-		return pushInternal(semaphoreTryWaitFunctor, value);
+		return fifoQueueBase_.tryPush(internal::makeCopyConstructQueueFunctor(value));
 	}
 
 	/**
@@ -411,8 +439,7 @@ public:
 
 	int tryPush(T&& value)
 	{
-		const internal::SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
-		return pushInternal(semaphoreTryWaitFunctor, std::move(value));
+		return fifoQueueBase_.tryPush(internal::makeMoveConstructQueueFunctor(value));
 	}
 
 	/**
@@ -430,8 +457,7 @@ public:
 
 	int tryPushFor(const TickClock::duration duration, const T& value)
 	{
-		const internal::SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
-		return pushInternal(semaphoreTryWaitForFunctor, value);
+		return fifoQueueBase_.tryPushFor(duration, internal::makeCopyConstructQueueFunctor(value));
 	}
 
 	/**
@@ -474,8 +500,7 @@ public:
 
 	int tryPushFor(const TickClock::duration duration, T&& value)
 	{
-		const internal::SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
-		return pushInternal(semaphoreTryWaitForFunctor, std::move(value));
+		return fifoQueueBase_.tryPushFor(duration, internal::makeMoveConstructQueueFunctor(value));
 	}
 
 	/**
@@ -518,8 +543,7 @@ public:
 
 	int tryPushUntil(const TickClock::time_point timePoint, const T& value)
 	{
-		const internal::SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
-		return pushInternal(semaphoreTryWaitUntilFunctor, value);
+		return fifoQueueBase_.tryPushUntil(timePoint, internal::makeCopyConstructQueueFunctor(value));
 	}
 
 	/**
@@ -561,8 +585,7 @@ public:
 
 	int tryPushUntil(const TickClock::time_point timePoint, T&& value)
 	{
-		const internal::SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
-		return pushInternal(semaphoreTryWaitUntilFunctor, std::move(value));
+		return fifoQueueBase_.tryPushUntil(timePoint, internal::makeMoveConstructQueueFunctor(value));
 	}
 
 	/**
@@ -589,6 +612,20 @@ public:
 		return tryPushUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint), std::move(value));
 	}
 
+	/**
+	 * \brief Unregisters producer of the queue.
+	 *
+	 * \param [in] queueProducer is a reference to QueueProducer object which will be unregistered
+	 *
+	 * \return 0 if \a queueProducer was unregistered successfully, error code otherwise:
+	 * - EINVAL - \a queueProducer is not registered in this queue;
+	 */
+
+	int unregisterProducer(QueueProducer& queueProducer)
+	{
+		return fifoQueueBase_.unregisterProducer(queueProducer);
+	}
+
 private:
 
 	/**
@@ -611,53 +648,6 @@ private:
 	template<typename... Args>
 	int emplaceInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, Args&&... args);
 
-	/**
-	 * \brief Pops the oldest (first) element from the queue.
-	 *
-	 * Internal version - builds the Functor object.
-	 *
-	 * \param [in] waitSemaphoreFunctor is a reference to SemaphoreFunctor which will be executed with \a popSemaphore_
-	 * \param [out] value is a reference to object that will be used to return popped value, its contents are swapped
-	 * with the value in the queue's storage and destructed when no longer needed
-	 *
-	 * \return 0 if element was popped successfully, error code otherwise:
-	 * - error codes returned by \a waitSemaphoreFunctor's operator() call;
-	 * - error codes returned by Semaphore::post();
-	 */
-
-	int popInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, T& value);
-
-	/**
-	 * \brief Pushes the element to the queue.
-	 *
-	 * Internal version - builds the Functor object.
-	 *
-	 * \param [in] waitSemaphoreFunctor is a reference to SemaphoreFunctor which will be executed with \a pushSemaphore_
-	 * \param [in] value is a reference to object that will be pushed, value in queue's storage is copy-constructed
-	 *
-	 * \return 0 if element was pushed successfully, error code otherwise:
-	 * - error codes returned by \a waitSemaphoreFunctor's operator() call;
-	 * - error codes returned by Semaphore::post();
-	 */
-
-	int pushInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, const T& value);
-
-	/**
-	 * \brief Pushes the element to the queue.
-	 *
-	 * Internal version - builds the Functor object.
-	 *
-	 * \param [in] waitSemaphoreFunctor is a reference to SemaphoreFunctor which will be executed with \a pushSemaphore_
-	 * \param [in] value is a rvalue reference to object that will be pushed, value in queue's storage is
-	 * move-constructed
-	 *
-	 * \return 0 if element was pushed successfully, error code otherwise:
-	 * - error codes returned by \a waitSemaphoreFunctor's operator() call;
-	 * - error codes returned by Semaphore::post();
-	 */
-
-	int pushInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, T&& value);
-
 	/// contained internal::FifoQueueBase object which implements whole functionality
 	internal::FifoQueueBase fifoQueueBase_;
 };
@@ -681,27 +671,6 @@ int FifoQueue<T>::emplaceInternal(const internal::SemaphoreFunctor& waitSemaphor
 	return fifoQueueBase_.push(waitSemaphoreFunctor, emplaceFunctor);
 }
 
-template<typename T>
-int FifoQueue<T>::popInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, T& value)
-{
-	const internal::SwapPopQueueFunctor<T> swapPopQueueFunctor {value};
-	return fifoQueueBase_.pop(waitSemaphoreFunctor, swapPopQueueFunctor);
-}
-
-template<typename T>
-int FifoQueue<T>::pushInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, const T& value)
-{
-	const internal::CopyConstructQueueFunctor<T> copyConstructQueueFunctor {value};
-	return fifoQueueBase_.push(waitSemaphoreFunctor, copyConstructQueueFunctor);
-}
-
-template<typename T>
-int FifoQueue<T>::pushInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, T&& value)
-{
-	const internal::MoveConstructQueueFunctor<T> moveConstructQueueFunctor {std::move(value)};
-	return fifoQueueBase_.push(waitSemaphoreFunctor, moveConstructQueueFunctor);
-}
-
 }	// namespace distortos
 
 #endif	// INCLUDE_DISTORTOS_FIFOQUEUE_HPP_
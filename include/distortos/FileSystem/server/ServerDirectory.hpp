@@ -0,0 +1,179 @@
+/**
+ * \file
+ * \brief ServerDirectory class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_FILESYSTEM_SERVER_SERVERDIRECTORY_HPP_
+#define INCLUDE_DISTORTOS_FILESYSTEM_SERVER_SERVERDIRECTORY_HPP_
+
+#include "distortos/FileSystem/Directory.hpp"
+
+#include <memory>
+
+namespace distortos
+{
+
+class ServerFileSystem;
+
+/**
+ * ServerDirectory class is a directory in ServerFileSystem.
+ *
+ * All operations are executed by the server thread on the directory of underlying file system.
+ *
+ * \ingroup fileSystem
+ */
+
+class ServerDirectory : public Directory
+{
+	friend class ServerFileSystem;
+
+public:
+
+	/**
+	 * \brief ServerDirectory's destructor
+	 *
+	 * Closes directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 */
+
+	~ServerDirectory() override;
+
+	/**
+	 * \brief Closes directory.
+	 *
+	 * Similar to [closedir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/closedir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the directory is already closed;
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by Directory::close() of underlying directory;
+	 */
+
+	int close() override;
+
+	/**
+	 * \brief Returns current position in the directory.
+	 *
+	 * Similar to [telldir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/telldir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and current position in the directory; error
+	 * codes:
+	 * - EBADF - the directory is not opened;
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by Directory::getPosition() of underlying directory;
+	 */
+
+	std::pair<int, off_t> getPosition() override;
+
+	/**
+	 * \brief Locks the directory for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one operation must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by ServerFileSystem::lock();
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Reads next entry from directory.
+	 *
+	 * Similar to [readdir_r()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/readdir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and next entry from directory; error codes:
+	 * - EBADF - the directory is not opened;
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by Directory::read() of underlying directory;
+	 */
+
+	std::pair<int, struct dirent> read() override;
+
+	/**
+	 * \brief Resets current position in the directory.
+	 *
+	 * Similar to [rewinddir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/rewinddir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the directory is not opened;
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by Directory::rewind() of underlying directory;
+	 */
+
+	int rewind() override;
+
+	/**
+	 * \brief Moves position in the directory.
+	 *
+	 * Similar to [seekdir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/seekdir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] position is the value of position, must be a value previously returned by getPosition()!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the directory is not opened;
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by Directory::seek() of underlying directory;
+	 */
+
+	int seek(off_t position) override;
+
+	/**
+	 * \brief Unlocks the directory which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by ServerFileSystem::unlock();
+	 */
+
+	int unlock() override;
+
+private:
+
+	/**
+	 * \brief ServerDirectory's constructor
+	 *
+	 * \param [in] fileSystem is a reference to owner file system
+	 */
+
+	explicit ServerDirectory(ServerFileSystem& fileSystem) :
+			directory_{},
+			fileSystem_{fileSystem}
+	{
+
+	}
+
+	/// underlying directory, created and destroyed only by the server thread, nullptr if directory is not opened
+	std::unique_ptr<Directory> directory_;
+
+	/// reference to owner file system
+	ServerFileSystem& fileSystem_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_FILESYSTEM_SERVER_SERVERDIRECTORY_HPP_
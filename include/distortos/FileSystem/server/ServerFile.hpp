@@ -0,0 +1,302 @@
+/**
+ * \file
+ * \brief ServerFile class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_FILESYSTEM_SERVER_SERVERFILE_HPP_
+#define INCLUDE_DISTORTOS_FILESYSTEM_SERVER_SERVERFILE_HPP_
+
+#include "distortos/FileSystem/File.hpp"
+
+#include <memory>
+
+namespace distortos
+{
+
+class ServerFileSystem;
+
+/**
+ * ServerFile class is a file in ServerFileSystem.
+ *
+ * All operations are executed by the server thread on the file of underlying file system. If the file has a write
+ * buffer, writes smaller than the buffer are merged in it and forwarded as a single write when the buffer cannot
+ * accommodate more data or when any other operation is done with the file. Error of such deferred write (including
+ * ENOSPC if only part of the buffered data could be written) is returned by the operation which caused it.
+ *
+ * \ingroup fileSystem
+ */
+
+class ServerFile : public File
+{
+	friend class ServerFileSystem;
+
+public:
+
+	/**
+	 * \brief ServerFile's destructor
+	 *
+	 * Closes file.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 */
+
+	~ServerFile() override;
+
+	/**
+	 * \brief Closes file.
+	 *
+	 * Similar to [close()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/close.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the file is already closed;
+	 * - error codes returned by flush();
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::close() of underlying file;
+	 */
+
+	int close() override;
+
+	/**
+	 * \brief Returns current file offset.
+	 *
+	 * Similar to [ftello()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/ftell.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and current file offset, bytes; error codes:
+	 * - EBADF - the file is not opened;
+	 * - error codes returned by flush();
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::getPosition() of underlying file;
+	 */
+
+	std::pair<int, off_t> getPosition() override;
+
+	/**
+	 * \brief Returns size of file.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and size of file, bytes; error codes:
+	 * - EBADF - the file is not opened;
+	 * - error codes returned by flush();
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::getSize() of underlying file;
+	 */
+
+	std::pair<int, off_t> getSize() override;
+
+	/**
+	 * \brief Returns status of file.
+	 *
+	 * Similar to [fstat()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/fstat.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and status of file in `stat` struct; error
+	 * codes:
+	 * - EBADF - the file is not opened;
+	 * - error codes returned by flush();
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::getStatus() of underlying file;
+	 */
+
+	std::pair<int, struct stat> getStatus() override;
+
+	/**
+	 * \brief Tells whether the file is a terminal.
+	 *
+	 * Similar to [isatty()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/isatty.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and bool telling whether the file is a
+	 * terminal (true) or not (false); error codes:
+	 * - EBADF - the file is not opened;
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::isATerminal() of underlying file;
+	 */
+
+	std::pair<int, bool> isATerminal() override;
+
+	/**
+	 * \brief Locks the file for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one operation must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by ServerFileSystem::lock();
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Reads data from file.
+	 *
+	 * Similar to [read()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/read.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [out] buffer is the buffer into which the data will be read
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of read bytes (valid even when
+	 * error code is returned); error codes:
+	 * - EBADF - the file is not opened;
+	 * - error codes returned by flush();
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::read() of underlying file;
+	 */
+
+	std::pair<int, size_t> read(void* buffer, size_t size) override;
+
+	/**
+	 * \brief Resets current file offset.
+	 *
+	 * Similar to [rewind()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/rewind.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the file is not opened;
+	 * - error codes returned by flush();
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::rewind() of underlying file;
+	 */
+
+	int rewind() override;
+
+	/**
+	 * \brief Moves file offset.
+	 *
+	 * Similar to [lseek()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/lseek.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] whence selects the mode of operation: `Whence::beginning` will set file offset to \a offset,
+	 * `Whence::current` will set file offset to its current value plus \a offset, `Whence::end` will set file offset to
+	 * the size of the file plus \a offset
+	 * \param [in] offset is the value of offset, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and current file offset, bytes; error codes:
+	 * - EBADF - the file is not opened;
+	 * - error codes returned by flush();
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::seek() of underlying file;
+	 */
+
+	std::pair<int, off_t> seek(Whence whence, off_t offset) override;
+
+	/**
+	 * \brief Synchronizes state of a file, ensuring all cached writes are finished.
+	 *
+	 * Similar to [fsync()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/fsync.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the file is not opened;
+	 * - error codes returned by flush();
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::synchronize() of underlying file;
+	 */
+
+	int synchronize() override;
+
+	/**
+	 * \brief Unlocks the file which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by ServerFileSystem::unlock();
+	 */
+
+	int unlock() override;
+
+	/**
+	 * \brief Writes data to file.
+	 *
+	 * Similar to [write()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/write.html)
+	 *
+	 * If the file has a write buffer and \a size is smaller than its capacity, the data is only copied to the buffer
+	 * (which is flushed first if it cannot accommodate the data) and the whole \a size is reported as written.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] buffer is the buffer with data that will be written
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of written bytes (valid even when
+	 * error code is returned); error codes:
+	 * - EBADF - the file is not opened;
+	 * - error codes returned by flush();
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::write() of underlying file;
+	 */
+
+	std::pair<int, size_t> write(const void* buffer, size_t size) override;
+
+private:
+
+	/**
+	 * \brief ServerFile's constructor
+	 *
+	 * \param [in] fileSystem is a reference to owner file system
+	 */
+
+	explicit ServerFile(ServerFileSystem& fileSystem) :
+			file_{},
+			writeBuffer_{},
+			fileSystem_{fileSystem},
+			writeBufferUsed_{}
+	{
+
+	}
+
+	/**
+	 * \brief Forwards data collected in write buffer to underlying file.
+	 *
+	 * The write buffer is empty after this call, even if an error is returned.
+	 *
+	 * \pre The file is opened.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - ENOSPC - underlying file accepted only part of data collected in write buffer;
+	 * - error codes returned by ServerFileSystem::execute();
+	 * - error codes returned by File::write() of underlying file;
+	 */
+
+	int flush();
+
+	/// underlying file, created and destroyed only by the server thread, nullptr if file is not opened
+	std::unique_ptr<File> file_;
+
+	/// write buffer, nullptr if merging of writes is disabled or the file is not opened for writing
+	std::unique_ptr<uint8_t[]> writeBuffer_;
+
+	/// reference to owner file system
+	ServerFileSystem& fileSystem_;
+
+	/// number of bytes collected in write buffer
+	size_t writeBufferUsed_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_FILESYSTEM_SERVER_SERVERFILE_HPP_
@@ -0,0 +1,329 @@
+/**
+ * \file
+ * \brief ServerFileSystem class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_FILESYSTEM_SERVER_SERVERFILESYSTEM_HPP_
+#define INCLUDE_DISTORTOS_FILESYSTEM_SERVER_SERVERFILESYSTEM_HPP_
+
+#include "distortos/FileSystem/FileSystem.hpp"
+
+#include "distortos/Mutex.hpp"
+#include "distortos/Semaphore.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+class ServerRequestFunctor;
+
+}	// namespace internal
+
+/**
+ * ServerFileSystem class is a proxy which executes all operations of underlying file system in a dedicated server
+ * thread.
+ *
+ * Only the server thread runs the code of underlying file system (e.g. LittlefsFileSystem), so only this thread needs
+ * a stack large enough for it. Each operation of client thread is passed to the server thread as a lightweight request
+ * - a reference to a functor on client's stack - and client thread waits until the request is executed.
+ *
+ * Optionally, consecutive writes to the same file which are smaller than the size of write buffer are merged in this
+ * buffer and passed to the server thread as a single request, when the buffer is full or when any other operation is
+ * done with the file.
+ *
+ * This class cannot be used directly - use StaticServerFileSystem, which provides the server thread.
+ *
+ * \ingroup fileSystem
+ */
+
+class ServerFileSystem : public FileSystem
+{
+	friend class ServerDirectory;
+	friend class ServerFile;
+
+public:
+
+	/**
+	 * \brief ServerFileSystem's destructor
+	 *
+	 * \pre File system is unmounted.
+	 */
+
+	~ServerFileSystem() override;
+
+	/**
+	 * \brief Unmounts current file system (if any is mounted), formats block device with the file system and mounts it.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] blockDevice is a pointer to block device which will be formatted and mounted, nullptr to reuse
+	 * currently associated block device
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::formatAndMount() of underlying file system;
+	 */
+
+	int formatAndMount(devices::BlockDevice* blockDevice) override;
+
+	/**
+	 * \brief Returns status of file.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path to file for which status should be returned
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and status of file in `stat` struct; error
+	 * codes:
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::getFileStatus() of underlying file system;
+	 */
+
+	std::pair<int, struct stat> getFileStatus(const char* path) override;
+
+	/**
+	 * \brief Returns status of file system.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and status of file system in `statvfs` struct;
+	 * error codes:
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::getStatus() of underlying file system;
+	 */
+
+	std::pair<int, struct statvfs> getStatus() override;
+
+	/**
+	 * \brief Locks the file system for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one operation must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EAGAIN - the lock could not be acquired because the maximum number of recursive locks for file system has been
+	 * exceeded;
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Makes a directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of the directory that will be created
+	 * \param [in] mode is the value of permission bits of the created directory
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::makeDirectory() of underlying file system;
+	 */
+
+	int makeDirectory(const char* path, mode_t mode) override;
+
+	/**
+	 * \brief Mounts file system on provided block device.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] blockDevice is a reference to block device on which the file system will be mounted
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::mount() of underlying file system;
+	 */
+
+	int mount(devices::BlockDevice& blockDevice) override;
+
+	/**
+	 * \brief Opens directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of directory that will be opened
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and `std::unique_ptr` with opened directory;
+	 * error codes:
+	 * - ENOMEM - unable to allocate memory for directory;
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::openDirectory() of underlying file system;
+	 */
+
+	std::pair<int, std::unique_ptr<Directory>> openDirectory(const char* path) override;
+
+	/**
+	 * \brief Opens file.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of file that will be opened
+	 * \param [in] flags are file status flags, for list of available flags and valid combinations see
+	 * [open()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/open.html)
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and `std::unique_ptr` with opened file; error
+	 * codes:
+	 * - ENOMEM - unable to allocate memory for file or its write buffer;
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::openFile() of underlying file system;
+	 */
+
+	std::pair<int, std::unique_ptr<File>> openFile(const char* path, int flags) override;
+
+	/**
+	 * \brief Removes file or directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of file or directory that will be removed
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::remove() of underlying file system;
+	 */
+
+	int remove(const char* path) override;
+
+	/**
+	 * \brief Renames file or directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of file or directory that will be renamed
+	 * \param [in] newPath is the new path of file or directory
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::rename() of underlying file system;
+	 */
+
+	int rename(const char* path, const char* newPath) override;
+
+	/**
+	 * \brief Unlocks the file system which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EPERM - current thread did not lock the file system;
+	 */
+
+	int unlock() override;
+
+	/**
+	 * \brief Unmounts file system from associated block device.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startServer();
+	 * - error codes returned by FileSystem::unmount() of underlying file system;
+	 */
+
+	int unmount() override;
+
+protected:
+
+	/**
+	 * \brief ServerFileSystem's constructor
+	 *
+	 * \param [in] fileSystem is a reference to underlying file system, which must not be used directly
+	 * \param [in] writeBufferSize is the size of write buffer allocated for each file opened for writing, bytes, 0 to
+	 * disable merging of writes
+	 */
+
+	constexpr ServerFileSystem(FileSystem& fileSystem, const size_t writeBufferSize) :
+			mutex_{Mutex::Type::recursive, Mutex::Protocol::priorityInheritance},
+			completionSemaphore_{0},
+			requestSemaphore_{0},
+			fileSystem_{fileSystem},
+			request_{},
+			writeBufferSize_{writeBufferSize}
+	{
+
+	}
+
+	/**
+	 * \brief Requests server thread to exit.
+	 *
+	 * Server thread returns from runServer() after finishing request which is currently executed (if any). No
+	 * operations on the file system, its files or its directories may be started after this call.
+	 */
+
+	void requestServerExit();
+
+	/**
+	 * \brief Function executed by server thread.
+	 *
+	 * Waits for requests from clients, executes them and signals their completion, until exit is requested with
+	 * requestServerExit().
+	 *
+	 * \param [in] fileSystem is a pointer to file system which owns the server thread
+	 */
+
+	static void runServer(ServerFileSystem* fileSystem);
+
+	/**
+	 * \brief Starts server thread, if it was not started yet.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise
+	 */
+
+	virtual int startServer() = 0;
+
+private:
+
+	/**
+	 * \brief Executes request in server thread.
+	 *
+	 * Current thread is blocked until the request is executed.
+	 *
+	 * \pre The file system is locked by current thread.
+	 *
+	 * \param [in] request is a reference to functor which will be executed in server thread
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by Semaphore::post();
+	 * - error codes returned by startServer();
+	 */
+
+	int execute(const internal::ServerRequestFunctor& request);
+
+	/// mutex for serializing access to the object
+	distortos::Mutex mutex_;
+
+	/// semaphore posted by server thread when the request is executed
+	Semaphore completionSemaphore_;
+
+	/// semaphore posted by client thread when new request is ready for server thread
+	Semaphore requestSemaphore_;
+
+	/// reference to underlying file system
+	FileSystem& fileSystem_;
+
+	/// pointer to currently executed request, nullptr when posted to server thread requests its exit
+	const internal::ServerRequestFunctor* request_;
+
+	/// size of write buffer allocated for each file opened for writing, bytes, 0 if merging of writes is disabled
+	size_t writeBufferSize_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_FILESYSTEM_SERVER_SERVERFILESYSTEM_HPP_
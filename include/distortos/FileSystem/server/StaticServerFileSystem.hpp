@@ -0,0 +1,99 @@
+/**
+ * \file
+ * \brief StaticServerFileSystem class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_FILESYSTEM_SERVER_STATICSERVERFILESYSTEM_HPP_
+#define INCLUDE_DISTORTOS_FILESYSTEM_SERVER_STATICSERVERFILESYSTEM_HPP_
+
+#include "distortos/FileSystem/server/ServerFileSystem.hpp"
+
+#include "distortos/StaticThread.hpp"
+
+namespace distortos
+{
+
+/**
+ * \brief StaticServerFileSystem class is a ServerFileSystem with server thread which has automatic storage for stack.
+ *
+ * The server thread is started by the first operation and runs until the file system is destroyed - destructor
+ * terminates the server thread and waits for it, so all files and directories must be closed before that. Its
+ * priority should not be lower than priority of any client thread.
+ *
+ * \tparam StackSize is the size of stack of server thread, bytes
+ *
+ * \ingroup fileSystem
+ */
+
+template<size_t StackSize>
+class StaticServerFileSystem : public ServerFileSystem
+{
+public:
+
+	/**
+	 * \brief StaticServerFileSystem's constructor
+	 *
+	 * \param [in] fileSystem is a reference to underlying file system, which must not be used directly
+	 * \param [in] priority is the priority of server thread
+	 * \param [in] writeBufferSize is the size of write buffer allocated for each file opened for writing, bytes, 0 to
+	 * disable merging of writes, default - 0
+	 */
+
+	StaticServerFileSystem(FileSystem& fileSystem, const uint8_t priority, const size_t writeBufferSize = {}) :
+			ServerFileSystem{fileSystem, writeBufferSize},
+			serverThread_{priority, &ServerFileSystem::runServer, static_cast<ServerFileSystem*>(this)}
+	{
+
+	}
+
+	/**
+	 * \brief StaticServerFileSystem's destructor
+	 *
+	 * Terminates server thread (if it was started) and waits for it to exit.
+	 *
+	 * \pre All files and directories of the file system are closed.
+	 */
+
+	~StaticServerFileSystem() override
+	{
+		if (serverThread_.getState() == ThreadState::created)
+			return;
+
+		requestServerExit();
+		serverThread_.join();
+	}
+
+protected:
+
+	/**
+	 * \brief Starts server thread, if it was not started yet.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by StaticThread::start();
+	 */
+
+	int startServer() override
+	{
+		if (serverThread_.getState() != ThreadState::created)
+			return 0;
+
+		return serverThread_.start();
+	}
+
+private:
+
+	/// server thread
+	StaticThread<StackSize, false, 0, 0, void(*)(ServerFileSystem*), ServerFileSystem*> serverThread_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_FILESYSTEM_SERVER_STATICSERVERFILESYSTEM_HPP_
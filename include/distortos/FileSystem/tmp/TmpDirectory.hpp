@@ -0,0 +1,187 @@
+/**
+ * \file
+ * \brief TmpDirectory class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_FILESYSTEM_TMP_TMPDIRECTORY_HPP_
+#define INCLUDE_DISTORTOS_FILESYSTEM_TMP_TMPDIRECTORY_HPP_
+
+#include "distortos/FileSystem/Directory.hpp"
+
+#include "distortos/internal/FileSystem/TmpStorage.hpp"
+
+namespace distortos
+{
+
+class TmpFileSystem;
+
+/**
+ * TmpDirectory class is a directory in TmpFileSystem.
+ *
+ * \ingroup fileSystem
+ */
+
+class TmpDirectory : public Directory
+{
+	friend class TmpFileSystem;
+
+public:
+
+	/**
+	 * \brief TmpDirectory's destructor
+	 *
+	 * Closes directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 */
+
+	~TmpDirectory() override;
+
+	/**
+	 * \brief Closes directory.
+	 *
+	 * Similar to [closedir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/closedir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the directory is already closed;
+	 */
+
+	int close() override;
+
+	/**
+	 * \brief Returns current position in the directory.
+	 *
+	 * Similar to [telldir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/telldir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and current position in the directory; error
+	 * codes:
+	 * - EBADF - the directory is not opened;
+	 */
+
+	std::pair<int, off_t> getPosition() override;
+
+	/**
+	 * \brief Locks the directory for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one operation must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by TmpFileSystem::lock();
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Reads next entry from directory.
+	 *
+	 * Similar to [readdir_r()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/readdir.html)
+	 *
+	 * `d_name` field is set in all cases. All other fields are zero-initialized. First two entries are "." and "..".
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and next entry from directory; error codes:
+	 * - EBADF - the directory is not opened;
+	 * - ENOENT - current position in the directory is invalid (i.e. end of the directory reached);
+	 */
+
+	std::pair<int, struct dirent> read() override;
+
+	/**
+	 * \brief Resets current position in the directory.
+	 *
+	 * Similar to [rewinddir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/rewinddir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the directory is not opened;
+	 */
+
+	int rewind() override;
+
+	/**
+	 * \brief Moves position in the directory.
+	 *
+	 * Similar to [seekdir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/seekdir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] position is the value of position, must be a value previously returned by getPosition()!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the directory is not opened;
+	 * - EINVAL - \a position is not valid;
+	 */
+
+	int seek(off_t position) override;
+
+	/**
+	 * \brief Unlocks the directory which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by TmpFileSystem::unlock();
+	 */
+
+	int unlock() override;
+
+private:
+
+	/**
+	 * \brief TmpDirectory's constructor
+	 *
+	 * \param [in] fileSystem is a reference to owner file system
+	 */
+
+	constexpr explicit TmpDirectory(TmpFileSystem& fileSystem) :
+			cursor_{},
+			fileSystem_{fileSystem},
+			node_{},
+			position_{}
+	{
+
+	}
+
+	/**
+	 * \brief Opens directory.
+	 *
+	 * \param [in] node is a reference to node of directory that will be opened
+	 */
+
+	void open(internal::TmpNode& node);
+
+	/// cursor which caches last accessed node of the directory
+	internal::TmpCursor<internal::TmpNode> cursor_;
+
+	/// reference to owner file system
+	TmpFileSystem& fileSystem_;
+
+	/// pointer to node of the directory, nullptr if directory is not opened
+	internal::TmpNode* node_;
+
+	/// current position in the directory - 0 for ".", 1 for "..", index of node plus 2 for other entries
+	size_t position_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_FILESYSTEM_TMP_TMPDIRECTORY_HPP_
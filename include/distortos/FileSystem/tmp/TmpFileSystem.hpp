@@ -0,0 +1,289 @@
+/**
+ * \file
+ * \brief TmpFileSystem class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_FILESYSTEM_TMP_TMPFILESYSTEM_HPP_
+#define INCLUDE_DISTORTOS_FILESYSTEM_TMP_TMPFILESYSTEM_HPP_
+
+#include "distortos/FileSystem/FileSystem.hpp"
+
+#include "distortos/internal/FileSystem/TmpStorage.hpp"
+
+#include "distortos/Mutex.hpp"
+
+namespace distortos
+{
+
+/**
+ * TmpFileSystem class is a volatile file system kept entirely in RAM.
+ *
+ * It is intended for scratch files which do not have to survive reset - contents of files are accessed at the speed of
+ * memory and no flash is worn. Contents of files are stored in fixed-size chunks, which are allocated either from
+ * provided pool of memory or from the heap, up to configured limit of size. Nodes of files and directories (with their
+ * names) are always allocated from the heap and are not included in this limit.
+ *
+ * All files and directories are lost when the file system is unmounted.
+ *
+ * \ingroup fileSystem
+ */
+
+class TmpFileSystem : public FileSystem
+{
+	friend class TmpDirectory;
+	friend class TmpFile;
+
+public:
+
+	/// default size of single chunk (including its header), bytes
+	constexpr static size_t defaultChunkSize {256};
+
+	/**
+	 * \brief TmpFileSystem's constructor
+	 *
+	 * \param [in] sizeLimit is the max total size of chunks, bytes; if \a pool is nullptr, then 0 means no limit,
+	 * otherwise it is the size of \a pool, default - 0
+	 * \param [in] chunkSize is the size of single chunk (including its header), bytes, must be a multiple of
+	 * `alignof(void*)` and larger than `sizeof(void*)`, default - defaultChunkSize
+	 * \param [in] pool is a pointer to memory from which chunks are allocated, must be aligned to `alignof(void*)`,
+	 * nullptr to allocate chunks from the heap, default - nullptr
+	 */
+
+	constexpr explicit TmpFileSystem(const size_t sizeLimit = {}, const size_t chunkSize = defaultChunkSize,
+			void* const pool = {}) :
+					storage_{sizeLimit, chunkSize, pool},
+					mutex_{Mutex::Type::recursive, Mutex::Protocol::priorityInheritance},
+					openedCount_{}
+	{
+
+	}
+
+	/**
+	 * \brief TmpFileSystem's destructor
+	 *
+	 * Unmounts file system.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 */
+
+	~TmpFileSystem() override;
+
+	/**
+	 * \brief Unmounts current file system (if any is mounted) and mounts new empty file system.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by unmount() (except EBADF);
+	 * - error codes returned by mount();
+	 */
+
+	int formatAndMount(devices::BlockDevice*) override;
+
+	/**
+	 * \brief Returns status of file.
+	 *
+	 * Similar to [stat()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/stat.html)
+	 *
+	 * `st_mode` field is set in all cases. For files `st_size` field is also set. All other fields are
+	 * zero-initialized.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path to file for which status should be returned
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and status of file in `stat` struct; error
+	 * codes:
+	 * - error codes returned by internal::TmpStorage::find();
+	 */
+
+	std::pair<int, struct stat> getFileStatus(const char* path) override;
+
+	/**
+	 * \brief Returns status of file system.
+	 *
+	 * Similar to [statvfs()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/statvfs.html)
+	 *
+	 * `f_bsize`, `f_frsize`, `f_blocks`, `f_bfree`, `f_bavail` and `f_namemax` fields are set in all cases. All other
+	 * fields are zero-initialized. Blocks are chunks of files.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and status of file system in `statvfs` struct;
+	 * error codes:
+	 * - EBADF - no file system mounted;
+	 */
+
+	std::pair<int, struct statvfs> getStatus() override;
+
+	/**
+	 * \brief Locks the file system for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one operation must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EAGAIN - the lock could not be acquired because the maximum number of recursive locks for file system has been
+	 * exceeded;
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Makes a directory.
+	 *
+	 * Similar to [mkdir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/mkdir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of the directory that will be created
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by internal::TmpStorage::create();
+	 */
+
+	int makeDirectory(const char* path, mode_t) override;
+
+	/**
+	 * \brief Mounts file system on provided block device.
+	 *
+	 * TmpFileSystem does not use any block device - use mount() instead.
+	 *
+	 * \return always ENOTSUP
+	 */
+
+	int mount(devices::BlockDevice&) override;
+
+	/**
+	 * \brief Mounts new empty file system.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by internal::TmpStorage::mount();
+	 */
+
+	int mount();
+
+	/**
+	 * \brief Opens directory.
+	 *
+	 * Similar to [opendir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/opendir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of directory that will be opened
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and `std::unique_ptr` with opened directory;
+	 * error codes:
+	 * - ENOMEM - unable to allocate memory for directory;
+	 * - ENOTDIR - \a path names an existing file;
+	 * - error codes returned by internal::TmpStorage::find();
+	 */
+
+	std::pair<int, std::unique_ptr<Directory>> openDirectory(const char* path) override;
+
+	/**
+	 * \brief Opens file.
+	 *
+	 * Similar to [open()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/open.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of file that will be opened
+	 * \param [in] flags are file status flags, for list of available flags and valid combinations see
+	 * [open()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/open.html)
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and `std::unique_ptr` with opened file; error
+	 * codes:
+	 * - EEXIST - `O_CREAT` and `O_EXCL` are set, and file named by \a path exists;
+	 * - EINVAL - \a flags are not valid;
+	 * - EISDIR - file named by \a path is a directory;
+	 * - ENOMEM - unable to allocate memory for file;
+	 * - error codes returned by internal::TmpStorage::create();
+	 * - error codes returned by internal::TmpStorage::find();
+	 */
+
+	std::pair<int, std::unique_ptr<File>> openFile(const char* path, int flags) override;
+
+	/**
+	 * \brief Removes file or directory.
+	 *
+	 * Similar to [remove()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/remove.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of file or directory that will be removed
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by internal::TmpStorage::remove();
+	 */
+
+	int remove(const char* path) override;
+
+	/**
+	 * \brief Renames file or directory.
+	 *
+	 * Similar to [rename()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/rename.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of file or directory that will be renamed
+	 * \param [in] newPath is the new path of file or directory
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by internal::TmpStorage::rename();
+	 */
+
+	int rename(const char* path, const char* newPath) override;
+
+	/**
+	 * \brief Unlocks the file system which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EPERM - current thread did not lock the file system;
+	 */
+
+	int unlock() override;
+
+	/**
+	 * \brief Unmounts file system, releasing all files and directories.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - no file system mounted;
+	 * - EBUSY - there are opened files or directories;
+	 */
+
+	int unmount() override;
+
+private:
+
+	/// tree of files and directories
+	internal::TmpStorage storage_;
+
+	/// mutex for serializing access to the object
+	distortos::Mutex mutex_;
+
+	/// number of opened files and directories
+	size_t openedCount_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_FILESYSTEM_TMP_TMPFILESYSTEM_HPP_
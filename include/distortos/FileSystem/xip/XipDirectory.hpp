@@ -0,0 +1,192 @@
+/**
+ * \file
+ * \brief XipDirectory class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_FILESYSTEM_XIP_XIPDIRECTORY_HPP_
+#define INCLUDE_DISTORTOS_FILESYSTEM_XIP_XIPDIRECTORY_HPP_
+
+#include "distortos/FileSystem/Directory.hpp"
+
+#include "distortos/internal/FileSystem/XipImage.hpp"
+
+namespace distortos
+{
+
+class XipFileSystem;
+
+/**
+ * XipDirectory class is a directory in XipFileSystem.
+ *
+ * \ingroup fileSystem
+ */
+
+class XipDirectory : public Directory
+{
+	friend class XipFileSystem;
+
+public:
+
+	/**
+	 * \brief XipDirectory's destructor
+	 *
+	 * Closes directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 */
+
+	~XipDirectory() override;
+
+	/**
+	 * \brief Closes directory.
+	 *
+	 * Similar to [closedir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/closedir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the directory is already closed;
+	 */
+
+	int close() override;
+
+	/**
+	 * \brief Returns current position in the directory.
+	 *
+	 * Similar to [telldir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/telldir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and current position in the directory; error
+	 * codes:
+	 * - EBADF - the directory is not opened;
+	 */
+
+	std::pair<int, off_t> getPosition() override;
+
+	/**
+	 * \brief Locks the directory for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one operation must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by XipFileSystem::lock();
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Reads next entry from directory.
+	 *
+	 * Similar to [readdir_r()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/readdir.html)
+	 *
+	 * `d_name` field is set in all cases. All other fields are zero-initialized. Unlike in other file systems, "." and
+	 * ".." entries are not present.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and next entry from directory; error codes:
+	 * - EBADF - the directory is not opened;
+	 * - ENOENT - current position in the directory is invalid (i.e. end of the directory reached);
+	 */
+
+	std::pair<int, struct dirent> read() override;
+
+	/**
+	 * \brief Resets current position in the directory.
+	 *
+	 * Similar to [rewinddir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/rewinddir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the directory is not opened;
+	 */
+
+	int rewind() override;
+
+	/**
+	 * \brief Moves position in the directory.
+	 *
+	 * Similar to [seekdir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/seekdir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] position is the value of position, must be a value previously returned by getPosition()!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the directory is not opened;
+	 * - EINVAL - \a position is not valid;
+	 */
+
+	int seek(off_t position) override;
+
+	/**
+	 * \brief Unlocks the directory which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by XipFileSystem::unlock();
+	 */
+
+	int unlock() override;
+
+private:
+
+	/**
+	 * \brief XipDirectory's constructor
+	 *
+	 * \param [in] fileSystem is a reference to owner file system
+	 */
+
+	constexpr explicit XipDirectory(XipFileSystem& fileSystem) :
+			first_{},
+			last_{},
+			fileSystem_{fileSystem},
+			position_{},
+			opened_{}
+	{
+
+	}
+
+	/**
+	 * \brief Opens directory.
+	 *
+	 * \param [in] entry is a reference to entry of directory that will be opened
+	 */
+
+	void open(const internal::XipImage::Entry& entry);
+
+	/// pointer to first entry which is a descendant of this directory
+	const internal::XipImage::Entry* first_;
+
+	/// pointer to one past last entry which is a descendant of this directory
+	const internal::XipImage::Entry* last_;
+
+	/// reference to owner file system
+	XipFileSystem& fileSystem_;
+
+	/// current position in the directory - index of next entry relative to `first_`
+	size_t position_;
+
+	/// true if directory is opened, false otherwise
+	bool opened_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_FILESYSTEM_XIP_XIPDIRECTORY_HPP_
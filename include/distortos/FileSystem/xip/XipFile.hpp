@@ -0,0 +1,282 @@
+/**
+ * \file
+ * \brief XipFile class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_FILESYSTEM_XIP_XIPFILE_HPP_
+#define INCLUDE_DISTORTOS_FILESYSTEM_XIP_XIPFILE_HPP_
+
+#include "distortos/FileSystem/File.hpp"
+
+#include <cstdint>
+
+namespace distortos
+{
+
+class XipFileSystem;
+
+/**
+ * XipFile class is a file in XipFileSystem.
+ *
+ * Apart from regular File interface, it provides direct access to contents of the file with getData(), which makes
+ * copying the data to RAM buffers unnecessary.
+ *
+ * \ingroup fileSystem
+ */
+
+class XipFile : public File
+{
+	friend class XipFileSystem;
+
+public:
+
+	/**
+	 * \brief XipFile's destructor
+	 *
+	 * Closes file.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 */
+
+	~XipFile() override;
+
+	/**
+	 * \brief Closes file.
+	 *
+	 * Similar to [close()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/close.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the file is already closed;
+	 */
+
+	int close() override;
+
+	/**
+	 * \brief Returns pointer to contents of the file.
+	 *
+	 * The pointer remains valid until the file system is unmounted, which is not possible while the file is opened.
+	 * Size of contents is returned by getSize().
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and pointer to contents of the file in the
+	 * image; error codes:
+	 * - EBADF - the file is not opened;
+	 */
+
+	std::pair<int, const void*> getData();
+
+	/**
+	 * \brief Returns current file offset.
+	 *
+	 * Similar to [ftello()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/ftell.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and current file offset, bytes; error codes:
+	 * - EBADF - the file is not opened;
+	 */
+
+	std::pair<int, off_t> getPosition() override;
+
+	/**
+	 * \brief Returns size of file.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and size of file, bytes; error codes:
+	 * - EBADF - the file is not opened;
+	 */
+
+	std::pair<int, off_t> getSize() override;
+
+	/**
+	 * \brief Returns status of file.
+	 *
+	 * Similar to [fstat()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/fstat.html)
+	 *
+	 * `st_mode` and `st_size` fields are set in all cases. All other fields are zero-initialized.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and status of file in `stat` struct; error
+	 * codes:
+	 * - error codes returned by getSize();
+	 */
+
+	std::pair<int, struct stat> getStatus() override;
+
+	/**
+	 * \brief Tells whether the file is a terminal.
+	 *
+	 * Similar to [isatty()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/isatty.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and bool telling whether the file is a
+	 * terminal (true) or not (false); error codes:
+	 * - EBADF - the file is not opened;
+	 */
+
+	std::pair<int, bool> isATerminal() override;
+
+	/**
+	 * \brief Locks the file for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one operation must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by XipFileSystem::lock();
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Reads data from file.
+	 *
+	 * Similar to [read()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/read.html)
+	 *
+	 * \note Use getData() to access contents of the file without copying.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [out] buffer is the buffer into which the data will be read
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of read bytes (valid even when
+	 * error code is returned); error codes:
+	 * - EBADF - the file is not opened;
+	 * - EINVAL - \a buffer is not valid;
+	 */
+
+	std::pair<int, size_t> read(void* buffer, size_t size) override;
+
+	/**
+	 * \brief Resets current file offset.
+	 *
+	 * Similar to [rewind()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/rewind.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the file is not opened;
+	 */
+
+	int rewind() override;
+
+	/**
+	 * \brief Moves file offset.
+	 *
+	 * Similar to [lseek()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/lseek.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] whence selects the mode of operation: `Whence::beginning` will set file offset to \a offset,
+	 * `Whence::current` will set file offset to its current value plus \a offset, `Whence::end` will set file offset to
+	 * the size of the file plus \a offset
+	 * \param [in] offset is the value of offset, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and current file offset, bytes; error codes:
+	 * - EBADF - the file is not opened;
+	 * - EINVAL - resulting file offset would be negative;
+	 */
+
+	std::pair<int, off_t> seek(Whence whence, off_t offset) override;
+
+	/**
+	 * \brief Synchronizes state of a file, ensuring all cached writes are finished.
+	 *
+	 * Similar to [fsync()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/fsync.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the file is not opened;
+	 */
+
+	int synchronize() override;
+
+	/**
+	 * \brief Unlocks the file which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by XipFileSystem::unlock();
+	 */
+
+	int unlock() override;
+
+	/**
+	 * \brief Writes data to file.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of written bytes (valid even when
+	 * error code is returned); error codes:
+	 * - EBADF - the file is not opened or opened only for reading (always, as XipFileSystem is read-only);
+	 */
+
+	std::pair<int, size_t> write(const void*, size_t) override;
+
+private:
+
+	/**
+	 * \brief XipFile's constructor
+	 *
+	 * \param [in] fileSystem is a reference to owner file system
+	 */
+
+	constexpr explicit XipFile(XipFileSystem& fileSystem) :
+			data_{},
+			fileSystem_{fileSystem},
+			position_{},
+			size_{},
+			opened_{}
+	{
+
+	}
+
+	/**
+	 * \brief Opens file.
+	 *
+	 * \param [in] data is a pointer to contents of the file
+	 * \param [in] size is the size of file, bytes
+	 */
+
+	void open(const uint8_t* data, size_t size);
+
+	/// pointer to contents of the file
+	const uint8_t* data_;
+
+	/// reference to owner file system
+	XipFileSystem& fileSystem_;
+
+	/// current file offset, bytes
+	off_t position_;
+
+	/// size of file, bytes
+	size_t size_;
+
+	/// true if file is opened, false otherwise
+	bool opened_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_FILESYSTEM_XIP_XIPFILE_HPP_
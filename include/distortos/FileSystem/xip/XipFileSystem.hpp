@@ -0,0 +1,277 @@
+/**
+ * \file
+ * \brief XipFileSystem class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_FILESYSTEM_XIP_XIPFILESYSTEM_HPP_
+#define INCLUDE_DISTORTOS_FILESYSTEM_XIP_XIPFILESYSTEM_HPP_
+
+#include "distortos/FileSystem/FileSystem.hpp"
+
+#include "distortos/internal/FileSystem/XipImage.hpp"
+
+#include "distortos/Mutex.hpp"
+
+namespace distortos
+{
+
+/**
+ * XipFileSystem class is a read-only file system in memory-mapped image, which can be executed (accessed) in place.
+ *
+ * The image is generated from a directory tree with scripts/packXipImage.py, either as a raw binary or as a C source
+ * file, and is placed in memory-mapped flash. Paths are looked up with a binary search in the sorted table of entries
+ * and contents of files are never copied to RAM by the file system - XipFile::getData() provides direct access to
+ * them.
+ *
+ * \ingroup fileSystem
+ */
+
+class XipFileSystem : public FileSystem
+{
+	friend class XipDirectory;
+	friend class XipFile;
+
+public:
+
+	/**
+	 * \brief XipFileSystem's constructor
+	 */
+
+	constexpr XipFileSystem() :
+			image_{},
+			mutex_{Mutex::Type::recursive, Mutex::Protocol::priorityInheritance},
+			openedCount_{}
+	{
+
+	}
+
+	/**
+	 * \brief XipFileSystem's destructor
+	 *
+	 * Unmounts file system.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 */
+
+	~XipFileSystem() override;
+
+	/**
+	 * \brief Unmounts current file system (if any is mounted), formats block device with the file system and mounts it.
+	 *
+	 * XipFileSystem is read-only - use scripts/packXipImage.py to generate images.
+	 *
+	 * \return always EROFS
+	 */
+
+	int formatAndMount(devices::BlockDevice*) override;
+
+	/**
+	 * \brief Returns status of file.
+	 *
+	 * Similar to [stat()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/stat.html)
+	 *
+	 * `st_mode` field is set in all cases. For files `st_size` field is also set. All other fields are
+	 * zero-initialized.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path to file for which status should be returned
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and status of file in `stat` struct; error
+	 * codes:
+	 * - EBADF - no file system mounted;
+	 * - error codes returned by internal::XipImage::find();
+	 */
+
+	std::pair<int, struct stat> getFileStatus(const char* path) override;
+
+	/**
+	 * \brief Returns status of file system.
+	 *
+	 * Similar to [statvfs()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/statvfs.html)
+	 *
+	 * `f_bsize`, `f_frsize`, `f_blocks`, `f_files`, `f_flag` and `f_namemax` fields are set in all cases. All other
+	 * fields are zero-initialized.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and status of file system in `statvfs` struct;
+	 * error codes:
+	 * - EBADF - no file system mounted;
+	 */
+
+	std::pair<int, struct statvfs> getStatus() override;
+
+	/**
+	 * \brief Locks the file system for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one operation must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EAGAIN - the lock could not be acquired because the maximum number of recursive locks for file system has been
+	 * exceeded;
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Makes a directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - no file system mounted;
+	 * - EROFS - read-only file system;
+	 */
+
+	int makeDirectory(const char*, mode_t) override;
+
+	/**
+	 * \brief Mounts file system on provided block device.
+	 *
+	 * XipFileSystem needs direct access to its image, which is not provided by BlockDevice interface - use
+	 * mount(const void*, size_t) instead.
+	 *
+	 * \return always ENOTSUP
+	 */
+
+	int mount(devices::BlockDevice&) override;
+
+	/**
+	 * \brief Mounts file system on provided memory-mapped image.
+	 *
+	 * The image is validated, so this function takes time proportional to the size of image's metadata (table of
+	 * entries and their paths), but not to the size of contents of files.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] image is a pointer to image generated by scripts/packXipImage.py, must be aligned to 4
+	 * \param [in] size is the size of memory area with \a image, bytes
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - file system is already mounted;
+	 * - EILSEQ - \a image is not a valid image;
+	 * - EINVAL - \a image is nullptr or is not aligned to 4;
+	 */
+
+	int mount(const void* image, size_t size);
+
+	/**
+	 * \brief Opens directory.
+	 *
+	 * Similar to [opendir()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/opendir.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of directory that will be opened
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and `std::unique_ptr` with opened directory;
+	 * error codes:
+	 * - EBADF - no file system mounted;
+	 * - ENOMEM - unable to allocate memory for directory;
+	 * - ENOTDIR - \a path names an existing file;
+	 * - error codes returned by internal::XipImage::find();
+	 */
+
+	std::pair<int, std::unique_ptr<Directory>> openDirectory(const char* path) override;
+
+	/**
+	 * \brief Opens file.
+	 *
+	 * Similar to [open()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/open.html)
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] path is the path of file that will be opened
+	 * \param [in] flags are file status flags, for list of available flags and valid combinations see
+	 * [open()](http://pubs.opengroup.org/onlinepubs/9699919799/functions/open.html)
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and `std::unique_ptr` with opened file; error
+	 * codes:
+	 * - EBADF - no file system mounted;
+	 * - EEXIST - `O_CREAT` and `O_EXCL` are set, and file named by \a path exists;
+	 * - EINVAL - \a flags are not valid;
+	 * - EISDIR - file named by \a path is a directory;
+	 * - ENOMEM - unable to allocate memory for file;
+	 * - EROFS - either `O_WRONLY`, `O_RDWR`, `O_CREAT` (and file named by \a path does not exist), or `O_TRUNC` are
+	 * set;
+	 * - error codes returned by internal::XipImage::find();
+	 */
+
+	std::pair<int, std::unique_ptr<File>> openFile(const char* path, int flags) override;
+
+	/**
+	 * \brief Removes file or directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - no file system mounted;
+	 * - EROFS - read-only file system;
+	 */
+
+	int remove(const char*) override;
+
+	/**
+	 * \brief Renames file or directory.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - no file system mounted;
+	 * - EROFS - read-only file system;
+	 */
+
+	int rename(const char*, const char*) override;
+
+	/**
+	 * \brief Unlocks the file system which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EPERM - current thread did not lock the file system;
+	 */
+
+	int unlock() override;
+
+	/**
+	 * \brief Unmounts file system from associated image.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - no file system mounted;
+	 * - EBUSY - there are opened files or directories, which access the image directly;
+	 */
+
+	int unmount() override;
+
+private:
+
+	/// parser of mounted image
+	internal::XipImage image_;
+
+	/// mutex for serializing access to the object
+	distortos::Mutex mutex_;
+
+	/// number of opened files and directories
+	size_t openedCount_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_FILESYSTEM_XIP_XIPFILESYSTEM_HPP_
@@ -0,0 +1,75 @@
+/**
+ * \file
+ * \brief HeapStatistics and HeapCallSite structs header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_HEAPSTATISTICS_HPP_
+#define INCLUDE_DISTORTOS_HEAPSTATISTICS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace distortos
+{
+
+/**
+ * HeapStatistics struct contains heap usage statistics of a thread.
+ *
+ * Allocations are charged to the thread which made them, deallocations - to the thread which made them, so when the
+ * memory is passed between threads, the difference between allocated and freed bytes of a single thread is not its
+ * share of the heap. Sizes are usable sizes of blocks, as reported by the allocator.
+ *
+ * \ingroup statistics
+ */
+
+struct HeapStatistics
+{
+	/// total number of allocated bytes
+	uint64_t allocatedBytes;
+
+	/// total number of freed bytes
+	uint64_t freedBytes;
+
+	/// number of successful allocations
+	uint32_t allocationCount;
+
+	/// number of deallocations
+	uint32_t freeCount;
+
+	/// number of times the thread had to wait for the mutex which protects the heap
+	uint32_t contentionCount;
+};
+
+/**
+ * HeapCallSite struct describes a call site of allocation function, as seen by sampling of allocations.
+ *
+ * Only every CONFIG_HEAP_ACCOUNTING_SAMPLING_PERIOD-th allocation is sampled, so all values are estimates of real
+ * values divided by sampling period.
+ *
+ * \ingroup statistics
+ */
+
+struct HeapCallSite
+{
+	/// return address of allocation function - malloc(), calloc(), realloc(), memalign() or operator new
+	const void* address;
+
+	/// number of sampled allocations
+	uint32_t allocationCount;
+
+	/// number of sampled blocks which were not freed yet
+	uint32_t liveBlocks;
+
+	/// total size of sampled blocks which were not freed yet, bytes
+	size_t liveBytes;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_HEAPSTATISTICS_HPP_
@@ -0,0 +1,352 @@
+/**
+ * \file
+ * \brief IpcEndpoint class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_IPCENDPOINT_HPP_
+#define INCLUDE_DISTORTOS_IPCENDPOINT_HPP_
+
+#include "distortos/internal/synchronization/IpcCallControlBlock.hpp"
+#include "distortos/internal/synchronization/IpcReceiverControlBlock.hpp"
+
+namespace distortos
+{
+
+/**
+ * \brief IpcEndpoint is a synchronous client/server rendezvous with direct handoff and priority donation
+ *
+ * Similar to L4 IPC endpoints - client thread "calls" the endpoint with a small fixed-size message and is blocked until
+ * some server thread "receives" the call and "replies" to it. The message is copied directly between the buffers of
+ * client and server, without any intermediate queue.
+ *
+ * When a server is already waiting in receive(), the client unblocks it and blocks itself in a single critical section,
+ * so the whole handoff costs just one context switch. From the moment the call is received until it is replied, the
+ * server inherits the effective priority of the client, exactly as if the client was blocked on a mutex with
+ * priorityInheritance protocol owned by the server - this also works transitively.
+ *
+ * Pending calls (made when no server is waiting) are received in the order of client's effective priority, and calls of
+ * clients with equal priority are received in FIFO order.
+ *
+ * \ingroup synchronization
+ */
+
+class IpcEndpoint
+{
+public:
+
+	/**
+	 * \brief IpcEndpoint's constructor
+	 */
+
+	constexpr IpcEndpoint() :
+			activeCallList_{},
+			pendingCallList_{},
+			receiverList_{}
+	{
+
+	}
+
+	/**
+	 * \brief IpcEndpoint's destructor
+	 *
+	 * It is safe to destroy an endpoint upon which no threads are currently blocked and for which no calls are being
+	 * served. The effect of destroying an endpoint in other cases is system error.
+	 */
+
+	~IpcEndpoint() = default;
+
+	/**
+	 * \brief Calls the endpoint.
+	 *
+	 * The request is passed to a server waiting in receive() or - if there is no such server - the call is queued until
+	 * some server receives it. The calling thread is blocked until the call is replied.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in,out] message is a reference to message, which contains the request on entry and the reply on
+	 * successful return
+	 *
+	 * \return 0 if the call was replied, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal, the call was abandoned;
+	 */
+
+	int call(IpcMessage& message);
+
+	/**
+	 * \brief Receives a call.
+	 *
+	 * If there are pending calls, the one made by the client with the highest effective priority is received
+	 * immediately. Otherwise the calling thread is blocked until some client calls the endpoint. After a successful
+	 * return the calling thread must eventually reply() to the call - until then it inherits the effective priority of
+	 * the client.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [out] message is a reference to message to which the request will be written
+	 *
+	 * \return 0 if a call was received, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 */
+
+	int receive(IpcMessage& message);
+
+	/**
+	 * \brief Replies to a call.
+	 *
+	 * The reply is copied to client's message, the client is unblocked and the priority inherited from the client is
+	 * dropped. If the calling thread received more than one call and has not replied to them yet, the most recently
+	 * received call is replied.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] message is a reference to reply message
+	 *
+	 * \return 0 if the call was replied, error code otherwise:
+	 * - EPERM - the calling thread has no call to reply to, either because no call was received or because the client
+	 * has stopped waiting for the reply (timeout or signal);
+	 */
+
+	int reply(const IpcMessage& message);
+
+	/**
+	 * \brief Tries to call the endpoint for given duration of time.
+	 *
+	 * Similar to call(), but the whole call (waiting for a server and waiting for the reply) is terminated when the
+	 * specified timeout expires. If the call was already received when the timeout expires, the server is notified
+	 * about that only by the failure of its reply().
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the call will be abandoned
+	 * \param [in,out] message is a reference to message, which contains the request on entry and the reply on
+	 * successful return
+	 *
+	 * \return 0 if the call was replied, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal, the call was abandoned;
+	 * - ETIMEDOUT - the call was not replied before the specified timeout expired, the call was abandoned;
+	 */
+
+	int tryCallFor(TickClock::duration duration, IpcMessage& message);
+
+	/**
+	 * \brief Tries to call the endpoint for given duration of time.
+	 *
+	 * Template variant of tryCallFor(TickClock::duration duration, IpcMessage& message).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Rep is type of tick counter
+	 * \tparam Period is std::ratio type representing the tick period of the clock, seconds
+	 *
+	 * \param [in] duration is the duration after which the call will be abandoned
+	 * \param [in,out] message is a reference to message, which contains the request on entry and the reply on
+	 * successful return
+	 *
+	 * \return 0 if the call was replied, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal, the call was abandoned;
+	 * - ETIMEDOUT - the call was not replied before the specified timeout expired, the call was abandoned;
+	 */
+
+	template<typename Rep, typename Period>
+	int tryCallFor(const std::chrono::duration<Rep, Period> duration, IpcMessage& message)
+	{
+		return tryCallFor(std::chrono::duration_cast<TickClock::duration>(duration), message);
+	}
+
+	/**
+	 * \brief Tries to call the endpoint until given time point.
+	 *
+	 * Similar to call(), but the whole call (waiting for a server and waiting for the reply) is terminated when the
+	 * specified timeout expires. If the call was already received when the timeout expires, the server is notified
+	 * about that only by the failure of its reply().
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the call will be abandoned
+	 * \param [in,out] message is a reference to message, which contains the request on entry and the reply on
+	 * successful return
+	 *
+	 * \return 0 if the call was replied, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal, the call was abandoned;
+	 * - ETIMEDOUT - the call was not replied before the specified timeout expired, the call was abandoned;
+	 */
+
+	int tryCallUntil(TickClock::time_point timePoint, IpcMessage& message);
+
+	/**
+	 * \brief Tries to call the endpoint until given time point.
+	 *
+	 * Template variant of tryCallUntil(TickClock::time_point timePoint, IpcMessage& message).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Duration is a std::chrono::duration type used to measure duration
+	 *
+	 * \param [in] timePoint is the time point at which the call will be abandoned
+	 * \param [in,out] message is a reference to message, which contains the request on entry and the reply on
+	 * successful return
+	 *
+	 * \return 0 if the call was replied, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal, the call was abandoned;
+	 * - ETIMEDOUT - the call was not replied before the specified timeout expired, the call was abandoned;
+	 */
+
+	template<typename Duration>
+	int tryCallUntil(const std::chrono::time_point<TickClock, Duration> timePoint, IpcMessage& message)
+	{
+		return tryCallUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint), message);
+	}
+
+	/**
+	 * \brief Tries to receive a call.
+	 *
+	 * Similar to receive(), but if there are no pending calls, the function returns immediately.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [out] message is a reference to message to which the request will be written
+	 *
+	 * \return 0 if a call was received, error code otherwise:
+	 * - EAGAIN - no call is pending;
+	 */
+
+	int tryReceive(IpcMessage& message);
+
+	/**
+	 * \brief Tries to receive a call for given duration of time.
+	 *
+	 * Similar to receive(), but the wait is terminated when the specified timeout expires.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated without receiving a call
+	 * \param [out] message is a reference to message to which the request will be written
+	 *
+	 * \return 0 if a call was received, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no call was received before the specified timeout expired;
+	 */
+
+	int tryReceiveFor(TickClock::duration duration, IpcMessage& message);
+
+	/**
+	 * \brief Tries to receive a call for given duration of time.
+	 *
+	 * Template variant of tryReceiveFor(TickClock::duration duration, IpcMessage& message).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Rep is type of tick counter
+	 * \tparam Period is std::ratio type representing the tick period of the clock, seconds
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated without receiving a call
+	 * \param [out] message is a reference to message to which the request will be written
+	 *
+	 * \return 0 if a call was received, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no call was received before the specified timeout expired;
+	 */
+
+	template<typename Rep, typename Period>
+	int tryReceiveFor(const std::chrono::duration<Rep, Period> duration, IpcMessage& message)
+	{
+		return tryReceiveFor(std::chrono::duration_cast<TickClock::duration>(duration), message);
+	}
+
+	/**
+	 * \brief Tries to receive a call until given time point.
+	 *
+	 * Similar to receive(), but the wait is terminated when the specified timeout expires.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated without receiving a call
+	 * \param [out] message is a reference to message to which the request will be written
+	 *
+	 * \return 0 if a call was received, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no call was received before the specified timeout expired;
+	 */
+
+	int tryReceiveUntil(TickClock::time_point timePoint, IpcMessage& message);
+
+	/**
+	 * \brief Tries to receive a call until given time point.
+	 *
+	 * Template variant of tryReceiveUntil(TickClock::time_point timePoint, IpcMessage& message).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Duration is a std::chrono::duration type used to measure duration
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated without receiving a call
+	 * \param [out] message is a reference to message to which the request will be written
+	 *
+	 * \return 0 if a call was received, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no call was received before the specified timeout expired;
+	 */
+
+	template<typename Duration>
+	int tryReceiveUntil(const std::chrono::time_point<TickClock, Duration> timePoint, IpcMessage& message)
+	{
+		return tryReceiveUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint), message);
+	}
+
+	IpcEndpoint(const IpcEndpoint&) = delete;
+	IpcEndpoint(IpcEndpoint&&) = delete;
+	const IpcEndpoint& operator=(const IpcEndpoint&) = delete;
+	IpcEndpoint& operator=(IpcEndpoint&&) = delete;
+
+private:
+
+	/**
+	 * \brief Internal version of call(), tryCallFor() and tryCallUntil().
+	 *
+	 * \param [in] timePoint is a pointer to time point at which the call will be abandoned, nullptr to wait
+	 * indefinitely
+	 * \param [in,out] message is a reference to message, which contains the request on entry and the reply on
+	 * successful return
+	 *
+	 * \return 0 if the call was replied, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal, the call was abandoned;
+	 * - ETIMEDOUT - the call was not replied before the specified timeout expired, the call was abandoned;
+	 */
+
+	int callInternal(const TickClock::time_point* timePoint, IpcMessage& message);
+
+	/**
+	 * \brief Internal version of receive(), tryReceive(), tryReceiveFor() and tryReceiveUntil().
+	 *
+	 * \param [in] block selects whether the calling thread may be blocked when no call is pending
+	 * \param [in] timePoint is a pointer to time point at which the wait will be terminated without receiving a call,
+	 * nullptr to wait indefinitely, ignored if \a block is false
+	 * \param [out] message is a reference to message to which the request will be written
+	 *
+	 * \return 0 if a call was received, error code otherwise:
+	 * - EAGAIN - no call is pending and \a block is false;
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no call was received before the specified timeout expired;
+	 */
+
+	int receiveInternal(bool block, const TickClock::time_point* timePoint, IpcMessage& message);
+
+	/// calls which were received and are waiting for reply, most recently received first
+	internal::IpcCallList activeCallList_;
+
+	/// calls which are waiting for a server, in the order in which they were made
+	internal::IpcCallList pendingCallList_;
+
+	/// servers waiting for a call, in the order in which they started waiting
+	internal::IpcReceiverList receiverList_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_IPCENDPOINT_HPP_
@@ -0,0 +1,35 @@
+/**
+ * \file
+ * \brief IpcMessage type header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_IPCMESSAGE_HPP_
+#define INCLUDE_DISTORTOS_IPCMESSAGE_HPP_
+
+#include <array>
+
+#include <cstdint>
+
+namespace distortos
+{
+
+/**
+ * \brief IpcMessage is a fixed-size message exchanged with IpcEndpoint
+ *
+ * The message is small enough to be copied with a few load/store multiple instructions, so it is passed by value
+ * between client and server, without any intermediate buffer.
+ *
+ * \ingroup synchronization
+ */
+
+using IpcMessage = std::array<uint32_t, 4>;
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_IPCMESSAGE_HPP_
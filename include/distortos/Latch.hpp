@@ -0,0 +1,237 @@
+/**
+ * \file
+ * \brief Latch class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_LATCH_HPP_
+#define INCLUDE_DISTORTOS_LATCH_HPP_
+
+#include "distortos/internal/scheduler/ThreadList.hpp"
+
+#include "distortos/TickClock.hpp"
+
+namespace distortos
+{
+
+/**
+ * \brief Latch is a one-shot synchronization primitive, which blocks threads until its counter is decremented to zero
+ *
+ * Similar to std::experimental::latch - http://en.cppreference.com/w/cpp/experimental/latch
+ *
+ * Decrementing the counter is a single operation with interrupts masked, so it may be done from interrupt context.
+ * When the counter reaches zero, all waiting threads are unblocked in one pass of the scheduler. Once the counter is
+ * zero it stays zero - the latch cannot be reused.
+ *
+ * \ingroup synchronization
+ */
+
+class Latch
+{
+public:
+
+	/// type used for latch's counter
+	using Value = unsigned int;
+
+	/**
+	 * \brief Latch's constructor
+	 *
+	 * \param [in] count is the initial value of the counter
+	 */
+
+	constexpr explicit Latch(const Value count) :
+			blockedList_{},
+			count_{count}
+	{
+
+	}
+
+	/**
+	 * \brief Latch's destructor
+	 *
+	 * The effect of destroying a latch upon which other threads are currently blocked is system error.
+	 */
+
+	~Latch() = default;
+
+	/**
+	 * \brief Decrements the counter and waits until it reaches zero.
+	 *
+	 * Decrementing and blocking are done in a single operation with interrupts masked.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] value is the value by which the counter will be decremented, default - 1
+	 *
+	 * \return 0 if the counter reached zero, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - EINVAL - \a value is 0 or greater than current value of the counter;
+	 */
+
+	int arriveAndWait(Value value = 1);
+
+	/**
+	 * \brief Decrements the counter.
+	 *
+	 * If the counter reaches zero, all threads waiting for the latch are unblocked.
+	 *
+	 * \param [in] value is the value by which the counter will be decremented, default - 1
+	 *
+	 * \return 0 if the counter was decremented successfully, error code otherwise:
+	 * - EINVAL - \a value is 0 or greater than current value of the counter;
+	 */
+
+	int countDown(Value value = 1);
+
+	/**
+	 * \return current value of the counter
+	 */
+
+	Value getCount() const
+	{
+		return count_;
+	}
+
+	/**
+	 * \brief Tests whether the counter reached zero.
+	 *
+	 * \return 0 if the counter reached zero, error code otherwise:
+	 * - EAGAIN - the counter did not reach zero yet;
+	 */
+
+	int tryWait() const;
+
+	/**
+	 * \brief Waits for the counter to reach zero for given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 *
+	 * \return 0 if the counter reached zero, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - the counter did not reach zero before the specified timeout expired;
+	 */
+
+	int tryWaitFor(TickClock::duration duration);
+
+	/**
+	 * \brief Waits for the counter to reach zero for given duration of time.
+	 *
+	 * Template variant of tryWaitFor(TickClock::duration).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Rep is type of tick counter
+	 * \tparam Period is std::ratio type representing the tick period of the clock, seconds
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 *
+	 * \return 0 if the counter reached zero, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - the counter did not reach zero before the specified timeout expired;
+	 */
+
+	template<typename Rep, typename Period>
+	int tryWaitFor(const std::chrono::duration<Rep, Period> duration)
+	{
+		return tryWaitFor(std::chrono::duration_cast<TickClock::duration>(duration));
+	}
+
+	/**
+	 * \brief Waits for the counter to reach zero until given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 *
+	 * \return 0 if the counter reached zero, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - the counter did not reach zero before the specified timeout expired;
+	 */
+
+	int tryWaitUntil(TickClock::time_point timePoint);
+
+	/**
+	 * \brief Waits for the counter to reach zero until given time point.
+	 *
+	 * Template variant of tryWaitUntil(TickClock::time_point).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Duration is a std::chrono::duration type used to measure duration
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 *
+	 * \return 0 if the counter reached zero, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - the counter did not reach zero before the specified timeout expired;
+	 */
+
+	template<typename Duration>
+	int tryWaitUntil(const std::chrono::time_point<TickClock, Duration> timePoint)
+	{
+		return tryWaitUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint));
+	}
+
+	/**
+	 * \brief Waits for the counter to reach zero.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 if the counter reached zero, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 */
+
+	int wait();
+
+	Latch(const Latch&) = delete;
+	Latch(Latch&&) = delete;
+	const Latch& operator=(const Latch&) = delete;
+	Latch& operator=(Latch&&) = delete;
+
+private:
+
+	/**
+	 * \brief Internal version of countDown().
+	 *
+	 * Internal version with no interrupt masking.
+	 *
+	 * \param [in] value is the value by which the counter will be decremented
+	 *
+	 * \return 0 if the counter was decremented successfully, error code otherwise:
+	 * - EINVAL - \a value is 0 or greater than current value of the counter;
+	 */
+
+	int countDownInternal(Value value);
+
+	/**
+	 * \brief Internal version of tryWaitUntil() and wait().
+	 *
+	 * Internal version with no interrupt masking.
+	 *
+	 * \param [in] timePoint is a pointer to time point at which the wait will be terminated, nullptr to wait
+	 * indefinitely
+	 *
+	 * \return 0 if the counter reached zero, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - the counter did not reach zero before the specified timeout expired;
+	 */
+
+	int waitInternal(const TickClock::time_point* timePoint);
+
+	/// ThreadControlBlock objects blocked on this latch
+	internal::ThreadList blockedList_;
+
+	/// current value of the counter
+	Value count_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_LATCH_HPP_
@@ -0,0 +1,205 @@
+/**
+ * \file
+ * \brief LatestValue class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_LATESTVALUE_HPP_
+#define INCLUDE_DISTORTOS_LATESTVALUE_HPP_
+
+#include "distortos/internal/synchronization/LatestValueBase.hpp"
+
+#include <type_traits>
+
+namespace distortos
+{
+
+/**
+ * \brief LatestValue class is a sequence lock which shares the latest value (like sensor state or control setpoint)
+ * between threads and interrupts.
+ *
+ * Writes never wait - new value is copied with interrupts masked, so any number of threads and interrupts may write.
+ * Reads don't lock anything - the copy is retried if a write happened in the meantime, so readers are never blocked
+ * by writers and there is no priority inversion. Each write increments the sequence number, which can be used to
+ * detect new values and to wait for them with wait(), tryWaitFor() or tryWaitUntil().
+ *
+ * As values are copied with memcpy(), T must be trivially copyable. Reads retry for as long as they are interrupted
+ * by writes, so values should be small and writes should not be more frequent than the time needed to copy a value.
+ *
+ * \tparam T is the type of shared value
+ *
+ * \ingroup synchronization
+ */
+
+template<typename T>
+class LatestValue
+{
+	static_assert(std::is_trivially_copyable<T>::value == true, "LatestValue requires trivially copyable type!");
+
+public:
+
+	/// type of sequence number
+	using Sequence = internal::LatestValueBase::Sequence;
+
+	/**
+	 * \brief LatestValue's constructor
+	 *
+	 * \param [in] value is the initial value, default - value-initialized T
+	 */
+
+	constexpr explicit LatestValue(const T& value = T{}) :
+			latestValueBase_{},
+			value_(value)
+	{
+
+	}
+
+	/**
+	 * \return current sequence number, incremented by 2 with each write
+	 */
+
+	Sequence getSequence() const
+	{
+		return latestValueBase_.getSequence();
+	}
+
+	/**
+	 * \brief Reads the latest value.
+	 *
+	 * \param [out] value is a reference to object to which the latest value will be copied
+	 *
+	 * \return sequence number of read value
+	 */
+
+	Sequence read(T& value) const
+	{
+		return latestValueBase_.read(&value, &value_, sizeof(value_));
+	}
+
+	/**
+	 * \brief Tries to wait for a value newer than the one with given sequence number for a given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 * \param [in] sequence is the sequence number of last known value, usually returned by read()
+	 *
+	 * \return 0 if value with different sequence number is available, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no new value was written before the specified timeout expired;
+	 */
+
+	int tryWaitFor(const TickClock::duration duration, const Sequence sequence)
+	{
+		return latestValueBase_.tryWaitFor(duration, sequence);
+	}
+
+	/**
+	 * \brief Tries to wait for a value newer than the one with given sequence number for a given duration of time.
+	 *
+	 * Template variant of tryWaitFor(TickClock::duration, Sequence).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Rep is type of tick counter
+	 * \tparam Period is std::ratio type representing the tick period of the clock, seconds
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 * \param [in] sequence is the sequence number of last known value, usually returned by read()
+	 *
+	 * \return 0 if value with different sequence number is available, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no new value was written before the specified timeout expired;
+	 */
+
+	template<typename Rep, typename Period>
+	int tryWaitFor(const std::chrono::duration<Rep, Period> duration, const Sequence sequence)
+	{
+		return tryWaitFor(std::chrono::duration_cast<TickClock::duration>(duration), sequence);
+	}
+
+	/**
+	 * \brief Tries to wait for a value newer than the one with given sequence number until a given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 * \param [in] sequence is the sequence number of last known value, usually returned by read()
+	 *
+	 * \return 0 if value with different sequence number is available, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no new value was written before the specified timeout expired;
+	 */
+
+	int tryWaitUntil(const TickClock::time_point timePoint, const Sequence sequence)
+	{
+		return latestValueBase_.tryWaitUntil(timePoint, sequence);
+	}
+
+	/**
+	 * \brief Tries to wait for a value newer than the one with given sequence number until a given time point.
+	 *
+	 * Template variant of tryWaitUntil(TickClock::time_point, Sequence).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Duration is a std::chrono::duration type used to measure duration
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 * \param [in] sequence is the sequence number of last known value, usually returned by read()
+	 *
+	 * \return 0 if value with different sequence number is available, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no new value was written before the specified timeout expired;
+	 */
+
+	template<typename Duration>
+	int tryWaitUntil(const std::chrono::time_point<TickClock, Duration> timePoint, const Sequence sequence)
+	{
+		return tryWaitUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint), sequence);
+	}
+
+	/**
+	 * \brief Waits for a value newer than the one with given sequence number.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] sequence is the sequence number of last known value, usually returned by read()
+	 *
+	 * \return 0 if value with different sequence number is available, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 */
+
+	int wait(const Sequence sequence)
+	{
+		return latestValueBase_.wait(sequence);
+	}
+
+	/**
+	 * \brief Writes new value and unblocks all threads waiting for it.
+	 *
+	 * \param [in] value is a reference to new value
+	 */
+
+	void write(const T& value)
+	{
+		latestValueBase_.write(&value_, &value, sizeof(value_));
+	}
+
+private:
+
+	/// internal::LatestValueBase object which implements base functionality
+	internal::LatestValueBase latestValueBase_;
+
+	/// shared value
+	T value_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_LATESTVALUE_HPP_
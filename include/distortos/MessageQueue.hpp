@@ -2,7 +2,7 @@
  * \file
  * \brief MessageQueue class header
  *
- * \author Copyright (C) 2015-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2015-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -14,13 +14,11 @@
 
 #include "distortos/internal/synchronization/MessageQueueBase.hpp"
 #include "distortos/internal/synchronization/BoundQueueFunctor.hpp"
-#include "distortos/internal/synchronization/CopyConstructQueueFunctor.hpp"
-#include "distortos/internal/synchronization/MoveConstructQueueFunctor.hpp"
-#include "distortos/internal/synchronization/SwapPopQueueFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreWaitFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreTryWaitFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreTryWaitForFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreTryWaitUntilFunctor.hpp"
+#include "distortos/internal/synchronization/ThunkQueueFunctor.hpp"
 
 #if __GNUC_PREREQ(5, 1) != 1
 // GCC 4.8 doesn't support parameter pack expansion in lambdas
@@ -113,6 +111,24 @@ public:
 		return emplaceInternal(semaphoreWaitFunctor, priority, std::forward<Args>(args)...);
 	}
 
+	/**
+	 * \return max number of elements in queue
+	 */
+
+	size_t getCapacity() const
+	{
+		return messageQueueBase_.getCapacity();
+	}
+
+	/**
+	 * \return current number of elements in queue
+	 */
+
+	size_t getSize() const
+	{
+		return messageQueueBase_.getSize();
+	}
+
 	/**
 	 * \brief Pops oldest element with highest priority from the queue.
 	 *
@@ -131,8 +147,7 @@ public:
 
 	int pop(uint8_t& priority, T& value)
 	{
-		const internal::SemaphoreWaitFunctor semaphoreWaitFunctor;
-		return popInternal(semaphoreWaitFunctor, priority, value);
+		return messageQueueBase_.pop(priority, internal::makeSwapPopQueueFunctor(value));
 	}
 
 	/**
@@ -152,8 +167,7 @@ public:
 
 	int push(const uint8_t priority, const T& value)
 	{
-		const internal::SemaphoreWaitFunctor semaphoreWaitFunctor;
-		return pushInternal(semaphoreWaitFunctor, priority, value);
+		return messageQueueBase_.push(priority, internal::makeCopyConstructQueueFunctor(value));
 	}
 
 	/**
@@ -174,8 +188,7 @@ public:
 
 	int push(const uint8_t priority, T&& value)
 	{
-		const internal::SemaphoreWaitFunctor semaphoreWaitFunctor;
-		return pushInternal(semaphoreWaitFunctor, priority, std::move(value));
+		return messageQueueBase_.push(priority, internal::makeMoveConstructQueueFunctor(value));
 	}
 
 	/**
@@ -330,8 +343,7 @@ public:
 
 	int tryPop(uint8_t& priority, T& value)
 	{
-		const internal::SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
-		return popInternal(semaphoreTryWaitFunctor, priority, value);
+		return messageQueueBase_.tryPop(priority, internal::makeSwapPopQueueFunctor(value));
 	}
 
 	/**
@@ -353,8 +365,7 @@ public:
 
 	int tryPopFor(const TickClock::duration duration, uint8_t& priority, T& value)
 	{
-		const internal::SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
-		return popInternal(semaphoreTryWaitForFunctor, priority, value);
+		return messageQueueBase_.tryPopFor(duration, priority, internal::makeSwapPopQueueFunctor(value));
 	}
 
 	/**
@@ -402,8 +413,7 @@ public:
 
 	int tryPopUntil(const TickClock::time_point timePoint, uint8_t& priority, T& value)
 	{
-		const internal::SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
-		return popInternal(semaphoreTryWaitUntilFunctor, priority, value);
+		return messageQueueBase_.tryPopUntil(timePoint, priority, internal::makeSwapPopQueueFunctor(value));
 	}
 
 	/**
@@ -446,8 +456,7 @@ public:
 
 	int tryPush(const uint8_t priority, const T& value)
 	{
-		const internal::SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
-		return pushInternal(semaphoreTryWaitFunctor, priority, value);
+		return messageQueueBase_.tryPush(priority, internal::makeCopyConstructQueueFunctor(value));
 	}
 
 	/**
@@ -466,8 +475,7 @@ public:
 
 	int tryPush(const uint8_t priority, T&& value)
 	{
-		const internal::SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
-		return pushInternal(semaphoreTryWaitFunctor, priority, std::move(value));
+		return messageQueueBase_.tryPush(priority, internal::makeMoveConstructQueueFunctor(value));
 	}
 
 	/**
@@ -488,8 +496,7 @@ public:
 
 	int tryPushFor(const TickClock::duration duration, const uint8_t priority, const T& value)
 	{
-		const internal::SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
-		return pushInternal(semaphoreTryWaitForFunctor, priority, value);
+		return messageQueueBase_.tryPushFor(duration, priority, internal::makeCopyConstructQueueFunctor(value));
 	}
 
 	/**
@@ -536,8 +543,7 @@ public:
 
 	int tryPushFor(const TickClock::duration duration, const uint8_t priority, T&& value)
 	{
-		const internal::SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
-		return pushInternal(semaphoreTryWaitForFunctor, priority, std::move(value));
+		return messageQueueBase_.tryPushFor(duration, priority, internal::makeMoveConstructQueueFunctor(value));
 	}
 
 	/**
@@ -584,8 +590,7 @@ public:
 
 	int tryPushUntil(const TickClock::time_point timePoint, const uint8_t priority, const T& value)
 	{
-		const internal::SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
-		return pushInternal(semaphoreTryWaitUntilFunctor, priority, value);
+		return messageQueueBase_.tryPushUntil(timePoint, priority, internal::makeCopyConstructQueueFunctor(value));
 	}
 
 	/**
@@ -632,8 +637,7 @@ public:
 
 	int tryPushUntil(const TickClock::time_point timePoint, const uint8_t priority, T&& value)
 	{
-		const internal::SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
-		return pushInternal(semaphoreTryWaitUntilFunctor, priority, std::move(value));
+		return messageQueueBase_.tryPushUntil(timePoint, priority, internal::makeMoveConstructQueueFunctor(value));
 	}
 
 	/**
@@ -684,56 +688,6 @@ private:
 	template<typename... Args>
 	int emplaceInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, uint8_t priority, Args&&... args);
 
-	/**
-	 * \brief Pops oldest element with highest priority from the queue.
-	 *
-	 * Internal version - builds the Functor object.
-	 *
-	 * \param [in] waitSemaphoreFunctor is a reference to SemaphoreFunctor which will be executed with \a popSemaphore_
-	 * \param [out] priority is a reference to variable that will be used to return priority of popped value
-	 * \param [out] value is a reference to object that will be used to return popped value, its contents are swapped
-	 * with the value in the queue's storage and destructed when no longer needed
-	 *
-	 * \return 0 if element was popped successfully, error code otherwise:
-	 * - error codes returned by \a waitSemaphoreFunctor's operator() call;
-	 * - error codes returned by Semaphore::post();
-	 */
-
-	int popInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, uint8_t& priority, T& value);
-
-	/**
-	 * \brief Pushes the element to the queue.
-	 *
-	 * Internal version - builds the Functor object.
-	 *
-	 * \param [in] waitSemaphoreFunctor is a reference to SemaphoreFunctor which will be executed with \a pushSemaphore_
-	 * \param [in] priority is the priority of new element
-	 * \param [in] value is a reference to object that will be pushed, value in queue's storage is copy-constructed
-	 *
-	 * \return 0 if element was pushed successfully, error code otherwise:
-	 * - error codes returned by \a waitSemaphoreFunctor's operator() call;
-	 * - error codes returned by Semaphore::post();
-	 */
-
-	int pushInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, uint8_t priority, const T& value);
-
-	/**
-	 * \brief Pushes the element to the queue.
-	 *
-	 * Internal version - builds the Functor object.
-	 *
-	 * \param [in] waitSemaphoreFunctor is a reference to SemaphoreFunctor which will be executed with \a pushSemaphore_
-	 * \param [in] priority is the priority of new element
-	 * \param [in] value is a rvalue reference to object that will be pushed, value in queue's storage is
-	 * move-constructed
-	 *
-	 * \return 0 if element was pushed successfully, error code otherwise:
-	 * - error codes returned by \a waitSemaphoreFunctor's operator() call;
-	 * - error codes returned by Semaphore::post();
-	 */
-
-	int pushInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, uint8_t priority, T&& value);
-
 	/// contained internal::MessageQueueBase object which implements whole functionality
 	internal::MessageQueueBase messageQueueBase_;
 };
@@ -759,29 +713,6 @@ int MessageQueue<T>::emplaceInternal(const internal::SemaphoreFunctor& waitSemap
 	return messageQueueBase_.push(waitSemaphoreFunctor, priority, emplaceFunctor);
 }
 
-template<typename T>
-int MessageQueue<T>::popInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, uint8_t& priority, T& value)
-{
-	const internal::SwapPopQueueFunctor<T> swapPopQueueFunctor {value};
-	return messageQueueBase_.pop(waitSemaphoreFunctor, priority, swapPopQueueFunctor);
-}
-
-template<typename T>
-int MessageQueue<T>::pushInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, const uint8_t priority,
-		const T& value)
-{
-	const internal::CopyConstructQueueFunctor<T> copyConstructQueueFunctor {value};
-	return messageQueueBase_.push(waitSemaphoreFunctor, priority, copyConstructQueueFunctor);
-}
-
-template<typename T>
-int MessageQueue<T>::pushInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, const uint8_t priority,
-		T&& value)
-{
-	const internal::MoveConstructQueueFunctor<T> moveConstructQueueFunctor {std::move(value)};
-	return messageQueueBase_.push(waitSemaphoreFunctor, priority, moveConstructQueueFunctor);
-}
-
 }	// namespace distortos
 
 #endif	// INCLUDE_DISTORTOS_MESSAGEQUEUE_HPP_
@@ -0,0 +1,100 @@
+/**
+ * \file
+ * \brief QueueProducer class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_QUEUEPRODUCER_HPP_
+#define INCLUDE_DISTORTOS_QUEUEPRODUCER_HPP_
+
+#include "distortos/internal/synchronization/MutexControlBlock.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+class FifoQueueBase;
+
+}	// namespace internal
+
+/**
+ * \brief QueueProducer class is a registration of producer thread in FifoQueue or RawFifoQueue, which enables priority
+ * inheritance across queue blocking.
+ *
+ * While the object is registered in a queue, the thread which registered it inherits the priority of the highest
+ * priority consumer blocked on this queue - just like the owner of Mutex with Mutex::Protocol::priorityInheritance
+ * inherits the priority of threads waiting for that mutex. This bounds the time a high priority consumer waits for the
+ * element from a low priority producer.
+ *
+ * Internally the registration is an owned mutex with Mutex::Protocol::priorityProtect, whose priority ceiling is
+ * adjusted by the queue to the effective priority of the first consumer waiting for an element, so all mechanisms
+ * related to boosted priority (including transitive boosting when the producer waits for a mutex with
+ * Mutex::Protocol::priorityInheritance) work unchanged.
+ *
+ * Boost is recalculated when a consumer is about to block, after each pop and after each push. If a consumer stops
+ * waiting due to timeout or signal, the boost is recalculated when this consumer resumes execution.
+ *
+ * \warning The object must be unregistered before the thread which registered it terminates.
+ *
+ * \ingroup queues
+ */
+
+class QueueProducer : private internal::MutexControlBlock
+{
+	friend internal::FifoQueueBase;
+
+public:
+
+	/**
+	 * \brief QueueProducer's constructor
+	 */
+
+	constexpr QueueProducer() :
+			MutexControlBlock{Type::normal, Protocol::priorityProtect, {}},
+			producerListNode{},
+			fifoQueueBase_{}
+	{
+
+	}
+
+	/**
+	 * \brief QueueProducer's destructor
+	 *
+	 * If the object is still registered in a queue, it is unregistered.
+	 */
+
+	~QueueProducer();
+
+	/**
+	 * \return true if the object is currently registered in a queue, false otherwise
+	 */
+
+	bool isRegistered() const
+	{
+		return fifoQueueBase_ != nullptr;
+	}
+
+	QueueProducer(const QueueProducer&) = delete;
+	QueueProducer(QueueProducer&&) = delete;
+	const QueueProducer& operator=(const QueueProducer&) = delete;
+	QueueProducer& operator=(QueueProducer&&) = delete;
+
+private:
+
+	/// node for intrusive list of producers registered in FifoQueueBase
+	estd::IntrusiveListNode producerListNode;
+
+	/// pointer to FifoQueueBase in which the object is registered, nullptr if not registered
+	internal::FifoQueueBase* fifoQueueBase_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_QUEUEPRODUCER_HPP_
@@ -2,7 +2,7 @@
  * \file
  * \brief RawFifoQueue class header
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -45,6 +45,24 @@ public:
 
 	RawFifoQueue(StorageUniquePointer&& storageUniquePointer, size_t elementSize, size_t maxElements);
 
+	/**
+	 * \return max number of elements in queue
+	 */
+
+	size_t getCapacity() const
+	{
+		return fifoQueueBase_.getCapacity();
+	}
+
+	/**
+	 * \return current number of elements in queue
+	 */
+
+	size_t getSize() const
+	{
+		return fifoQueueBase_.getSize();
+	}
+
 	/**
 	 * \brief Pops the oldest (first) element from the queue.
 	 *
@@ -119,6 +137,25 @@ public:
 		return push(&data, sizeof(data));
 	}
 
+	/**
+	 * \brief Registers current thread as a producer of the queue.
+	 *
+	 * While \a queueProducer is registered, current thread inherits the priority of the highest priority thread blocked
+	 * on "pop" functions of the queue.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] queueProducer is a reference to QueueProducer object which will be registered
+	 *
+	 * \return 0 if \a queueProducer was registered successfully, error code otherwise:
+	 * - EBUSY - \a queueProducer is already registered;
+	 */
+
+	int registerProducer(QueueProducer& queueProducer)
+	{
+		return fifoQueueBase_.registerProducer(queueProducer);
+	}
+
 	/**
 	 * \brief Tries to pop the oldest (first) element from the queue.
 	 *
@@ -450,6 +487,20 @@ public:
 		return tryPushUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint), &data, sizeof(data));
 	}
 
+	/**
+	 * \brief Unregisters producer of the queue.
+	 *
+	 * \param [in] queueProducer is a reference to QueueProducer object which will be unregistered
+	 *
+	 * \return 0 if \a queueProducer was unregistered successfully, error code otherwise:
+	 * - EINVAL - \a queueProducer is not registered in this queue;
+	 */
+
+	int unregisterProducer(QueueProducer& queueProducer)
+	{
+		return fifoQueueBase_.unregisterProducer(queueProducer);
+	}
+
 private:
 
 	/**
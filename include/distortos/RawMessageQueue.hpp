@@ -65,6 +65,24 @@ public:
 	RawMessageQueue(EntryStorageUniquePointer&& entryStorageUniquePointer,
 			ValueStorageUniquePointer&& valueStorageUniquePointer, size_t elementSize, size_t maxElements);
 
+	/**
+	 * \return max number of elements in queue
+	 */
+
+	size_t getCapacity() const
+	{
+		return messageQueueBase_.getCapacity();
+	}
+
+	/**
+	 * \return current number of elements in queue
+	 */
+
+	size_t getSize() const
+	{
+		return messageQueueBase_.getSize();
+	}
+
 	/**
 	 * \brief Pops oldest element with highest priority from the queue.
 	 *
@@ -0,0 +1,351 @@
+/**
+ * \file
+ * \brief RingQueue class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_RINGQUEUE_HPP_
+#define INCLUDE_DISTORTOS_RINGQUEUE_HPP_
+
+#include "distortos/internal/synchronization/FifoQueueBase.hpp"
+#include "distortos/internal/synchronization/BoundQueueFunctor.hpp"
+#include "distortos/internal/synchronization/SemaphoreTryWaitFunctor.hpp"
+#include "distortos/internal/synchronization/SemaphoreWaitFunctor.hpp"
+#include "distortos/internal/synchronization/ThunkQueueFunctor.hpp"
+
+namespace distortos
+{
+
+/**
+ * \brief RingQueue class is a lossy FIFO queue for thread-thread, thread-interrupt or interrupt-interrupt
+ * communication, which overwrites the oldest element when a new element is pushed to a full queue. It supports multiple
+ * readers and multiple writers. It is implemented as a wrapper for internal::FifoQueueBase.
+ *
+ * Push functions never block, so they may be used from interrupt context and producers never stall on slow consumers.
+ * The number of overwritten elements is counted and can be checked with getOverflowCount().
+ *
+ * \tparam T is the type of data in queue
+ *
+ * \ingroup queues
+ */
+
+template<typename T>
+class RingQueue
+{
+public:
+
+	/// type of uninitialized storage for data
+	using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+	/// unique_ptr (with deleter) to Storage[]
+	using StorageUniquePointer =
+			std::unique_ptr<Storage[], internal::FifoQueueBase::StorageUniquePointer::deleter_type>;
+
+	/**
+	 * \brief RingQueue's constructor
+	 *
+	 * \param [in] storageUniquePointer is a rvalue reference to StorageUniquePointer with storage for queue elements
+	 * (sufficiently large for \a maxElements, each sizeof(T) bytes long) and appropriate deleter
+	 * \param [in] maxElements is the number of elements in storage array
+	 */
+
+	RingQueue(StorageUniquePointer&& storageUniquePointer, const size_t maxElements) :
+			fifoQueueBase_{{storageUniquePointer.release(), storageUniquePointer.get_deleter()}, sizeof(T),
+					maxElements},
+			overflowCount_{}
+	{
+
+	}
+
+	/**
+	 * \brief RingQueue's destructor
+	 *
+	 * Destroys all remaining elements in the queue.
+	 */
+
+	~RingQueue()
+	{
+		const auto destroyFunctor = internal::makeDestroyQueueFunctor<T>();
+		while (fifoQueueBase_.tryPop(destroyFunctor) == 0);
+	}
+
+	/**
+	 * \brief Emplaces the element in the queue, overwriting the oldest (first) element if the queue is full.
+	 *
+	 * \tparam Args are types of arguments for constructor of T
+	 *
+	 * \param [in] args are arguments for constructor of T
+	 *
+	 * \return 0 if element was emplaced successfully, error code otherwise:
+	 * - error codes returned by internal::FifoQueueBase::overwritingPush();
+	 */
+
+	template<typename... Args>
+	int emplace(Args&&... args)
+	{
+		const auto emplaceFunctor = internal::makeBoundQueueFunctor(
+				[&args...](void* const storage)
+				{
+					new (storage) T{std::forward<Args>(args)...};
+				});
+		return fifoQueueBase_.overwritingPush(internal::makeDestroyQueueFunctor<T>(), emplaceFunctor, overflowCount_);
+	}
+
+	/**
+	 * \return max number of elements in queue
+	 */
+
+	size_t getCapacity() const
+	{
+		return fifoQueueBase_.getCapacity();
+	}
+
+	/**
+	 * \return number of elements which were overwritten (dropped) since the queue was constructed
+	 */
+
+	size_t getOverflowCount() const
+	{
+		return overflowCount_;
+	}
+
+	/**
+	 * \return current number of elements in queue
+	 */
+
+	size_t getSize() const
+	{
+		return fifoQueueBase_.getSize();
+	}
+
+	/**
+	 * \brief Pops the oldest (first) element from the queue.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [out] value is a reference to object that will be used to return popped value, its contents are swapped
+	 * with the value in the queue's storage and destructed when no longer needed
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::wait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int pop(T& value)
+	{
+		return fifoQueueBase_.pop(internal::makeSwapPopQueueFunctor(value));
+	}
+
+	/**
+	 * \brief Pops several oldest elements from the queue.
+	 *
+	 * Waits until at least one element is available, then pops all available elements (up to \a maxElements) at once.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [out] values is a pointer to array of objects that will be used to return popped values, their contents
+	 * are swapped with the values in the queue's storage and destructed when no longer needed
+	 * \param [in] maxElements is the number of objects in \a values array
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of popped elements; error codes:
+	 * - error codes returned by internal::FifoQueueBase::popBatch();
+	 * - error codes returned by Semaphore::wait();
+	 */
+
+	std::pair<int, size_t> popBatch(T* const values, const size_t maxElements)
+	{
+		const internal::SemaphoreWaitFunctor semaphoreWaitFunctor;
+		return popBatchInternal(semaphoreWaitFunctor, values, maxElements);
+	}
+
+	/**
+	 * \brief Pushes the element to the queue, overwriting the oldest (first) element if the queue is full.
+	 *
+	 * \param [in] value is a reference to object that will be pushed, value in queue's storage is copy-constructed
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by internal::FifoQueueBase::overwritingPush();
+	 */
+
+	int push(const T& value)
+	{
+		return fifoQueueBase_.overwritingPush(internal::makeDestroyQueueFunctor<T>(),
+				internal::makeCopyConstructQueueFunctor(value), overflowCount_);
+	}
+
+	/**
+	 * \brief Pushes the element to the queue, overwriting the oldest (first) element if the queue is full.
+	 *
+	 * \param [in] value is a rvalue reference to object that will be pushed, value in queue's storage is
+	 * move-constructed
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by internal::FifoQueueBase::overwritingPush();
+	 */
+
+	int push(T&& value)
+	{
+		return fifoQueueBase_.overwritingPush(internal::makeDestroyQueueFunctor<T>(),
+				internal::makeMoveConstructQueueFunctor(value), overflowCount_);
+	}
+
+	/**
+	 * \brief Tries to pop the oldest (first) element from the queue.
+	 *
+	 * \param [out] value is a reference to object that will be used to return popped value, its contents are swapped
+	 * with the value in the queue's storage and destructed when no longer needed
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPop(T& value)
+	{
+		return fifoQueueBase_.tryPop(internal::makeSwapPopQueueFunctor(value));
+	}
+
+	/**
+	 * \brief Tries to pop several oldest elements from the queue.
+	 *
+	 * Pops all available elements (up to \a maxElements) at once.
+	 *
+	 * \param [out] values is a pointer to array of objects that will be used to return popped values, their contents
+	 * are swapped with the values in the queue's storage and destructed when no longer needed
+	 * \param [in] maxElements is the number of objects in \a values array
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of popped elements; error codes:
+	 * - error codes returned by internal::FifoQueueBase::popBatch();
+	 * - error codes returned by Semaphore::tryWait();
+	 */
+
+	std::pair<int, size_t> tryPopBatch(T* const values, const size_t maxElements)
+	{
+		const internal::SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
+		return popBatchInternal(semaphoreTryWaitFunctor, values, maxElements);
+	}
+
+	/**
+	 * \brief Tries to pop the oldest (first) element from the queue for a given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the call will be terminated without popping the element
+	 * \param [out] value is a reference to object that will be used to return popped value, its contents are swapped
+	 * with the value in the queue's storage and destructed when no longer needed
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitFor();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPopFor(const TickClock::duration duration, T& value)
+	{
+		return fifoQueueBase_.tryPopFor(duration, internal::makeSwapPopQueueFunctor(value));
+	}
+
+	/**
+	 * \brief Tries to pop the oldest (first) element from the queue for a given duration of time.
+	 *
+	 * Template variant of tryPopFor(TickClock::duration, T&).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Rep is type of tick counter
+	 * \tparam Period is std::ratio type representing the tick period of the clock, seconds
+	 *
+	 * \param [in] duration is the duration after which the call will be terminated without popping the element
+	 * \param [out] value is a reference to object that will be used to return popped value, its contents are swapped
+	 * with the value in the queue's storage and destructed when no longer needed
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitFor();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	template<typename Rep, typename Period>
+	int tryPopFor(const std::chrono::duration<Rep, Period> duration, T& value)
+	{
+		return tryPopFor(std::chrono::duration_cast<TickClock::duration>(duration), value);
+	}
+
+	/**
+	 * \brief Tries to pop the oldest (first) element from the queue until a given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the call will be terminated without popping the element
+	 * \param [out] value is a reference to object that will be used to return popped value, its contents are swapped
+	 * with the value in the queue's storage and destructed when no longer needed
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitUntil();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPopUntil(const TickClock::time_point timePoint, T& value)
+	{
+		return fifoQueueBase_.tryPopUntil(timePoint, internal::makeSwapPopQueueFunctor(value));
+	}
+
+	/**
+	 * \brief Tries to pop the oldest (first) element from the queue until a given time point.
+	 *
+	 * Template variant of tryPopUntil(TickClock::time_point, T&).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Duration is a std::chrono::duration type used to measure duration
+	 *
+	 * \param [in] timePoint is the time point at which the call will be terminated without popping the element
+	 * \param [out] value is a reference to object that will be used to return popped value, its contents are swapped
+	 * with the value in the queue's storage and destructed when no longer needed
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitUntil();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	template<typename Duration>
+	int tryPopUntil(const std::chrono::time_point<TickClock, Duration> timePoint, T& value)
+	{
+		return tryPopUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint), value);
+	}
+
+private:
+
+	/**
+	 * \brief Pops several oldest elements from the queue.
+	 *
+	 * Internal version - builds the Functor object.
+	 *
+	 * \param [in] waitSemaphoreFunctor is a reference to SemaphoreFunctor which will be executed for the first element
+	 * \param [out] values is a pointer to array of objects that will be used to return popped values
+	 * \param [in] maxElements is the number of objects in \a values array
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of popped elements; error codes:
+	 * - error codes returned by internal::FifoQueueBase::popBatch();
+	 */
+
+	std::pair<int, size_t> popBatchInternal(const internal::SemaphoreFunctor& waitSemaphoreFunctor, T* values,
+			const size_t maxElements)
+	{
+		return fifoQueueBase_.popBatch(waitSemaphoreFunctor, internal::makeSwapPopBatchQueueFunctor(values),
+				maxElements);
+	}
+
+	/// contained internal::FifoQueueBase object which implements base functionality
+	internal::FifoQueueBase fifoQueueBase_;
+
+	/// number of elements which were overwritten (dropped) since the queue was constructed
+	size_t overflowCount_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_RINGQUEUE_HPP_
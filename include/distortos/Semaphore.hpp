@@ -2,7 +2,7 @@
  * \file
  * \brief Semaphore class header
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -19,6 +19,13 @@
 namespace distortos
 {
 
+namespace internal
+{
+
+class FifoQueueBase;
+
+}	// namespace internal
+
 /**
  * \brief Semaphore is the basic synchronization primitive
  *
@@ -29,6 +36,8 @@ namespace distortos
 
 class Semaphore
 {
+	friend internal::FifoQueueBase;
+
 public:
 
 	/// type used for semaphore's "value"
@@ -64,6 +73,15 @@ public:
 
 	~Semaphore() = default;
 
+	/**
+	 * \return max value of semaphore
+	 */
+
+	Value getMaxValue() const
+	{
+		return maxValue_;
+	}
+
 	/**
 	 * \brief Gets current value of semaphore.
 	 *
@@ -93,7 +111,28 @@ public:
 	 * - EOVERFLOW - the maximum allowable value for a semaphore would be exceeded;
 	 */
 
-	int post();
+	int post()
+	{
+		return post(1);
+	}
+
+	/**
+	 * \brief Unlocks the semaphore, releasing multiple units at once.
+	 *
+	 * Value of the semaphore is increased by \a units in one atomic operation. Then the threads blocked waiting for the
+	 * semaphore are unblocked in the usual order (the highest priority first, the longest waiting first among threads
+	 * with equal priority), as long as the request of the first remaining thread can be satisfied. A thread requesting
+	 * more units than are available stops this pass, so threads waiting for large amounts are not starved by threads
+	 * requesting smaller amounts.
+	 *
+	 * \param [in] units is the number of units that will be released
+	 *
+	 * \return 0 if the calling process successfully "posted" the semaphore, error code otherwise:
+	 * - EINVAL - \a units is 0;
+	 * - EOVERFLOW - the maximum allowable value for a semaphore would be exceeded;
+	 */
+
+	int post(Value units);
 
 	/**
 	 * \brief Tries to lock the semaphore.
@@ -104,11 +143,32 @@ public:
 	 * value is currently positive. Otherwise, it shall not lock the semaphore. Upon successful return, the state of the
 	 * semaphore shall be locked and shall remain locked until unlock() function is executed.
 	 *
+	 * Threads which are already waiting for the semaphore are not overtaken - see tryWait(Value).
+	 *
 	 * \return 0 if the calling process successfully performed the semaphore lock operation, error code otherwise:
 	 * - EAGAIN - semaphore was already locked, so it cannot be immediately locked by the tryWait() operation;
 	 */
 
-	int tryWait();
+	int tryWait()
+	{
+		return tryWait(1);
+	}
+
+	/**
+	 * \brief Tries to lock the semaphore, acquiring multiple units at once.
+	 *
+	 * Units are acquired only if the value of the semaphore is at least \a units and no thread with the same or higher
+	 * priority is already waiting for the semaphore. In interrupt context units are acquired only if no thread is
+	 * waiting for the semaphore, regardless of the priority of interrupted thread. Units are never acquired partially.
+	 *
+	 * \param [in] units is the number of units that will be acquired
+	 *
+	 * \return 0 if the calling process successfully performed the semaphore lock operation, error code otherwise:
+	 * - EAGAIN - requested units cannot be immediately acquired;
+	 * - EINVAL - \a units is 0 or greater than max value of semaphore;
+	 */
+
+	int tryWait(Value units);
 
 	/**
 	 * \brief Tries to lock the semaphore for given duration of time.
@@ -131,7 +191,10 @@ public:
 	 * - ETIMEDOUT - the semaphore could not be locked before the specified timeout expired;
 	 */
 
-	int tryWaitFor(TickClock::duration duration);
+	int tryWaitFor(const TickClock::duration duration)
+	{
+		return tryWaitFor(duration, 1);
+	}
 
 	/**
 	 * \brief Tries to lock the semaphore for given duration of time.
@@ -156,6 +219,49 @@ public:
 		return tryWaitFor(std::chrono::duration_cast<TickClock::duration>(duration));
 	}
 
+	/**
+	 * \brief Tries to lock the semaphore for given duration of time, acquiring multiple units at once.
+	 *
+	 * Same as tryWaitFor(TickClock::duration), but \a units are acquired atomically, as in tryWait(Value).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated without locking the semaphore
+	 * \param [in] units is the number of units that will be acquired
+	 *
+	 * \return 0 if the calling process successfully performed the semaphore lock operation, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - EINVAL - \a units is 0 or greater than max value of semaphore;
+	 * - ETIMEDOUT - the semaphore could not be locked before the specified timeout expired;
+	 */
+
+	int tryWaitFor(TickClock::duration duration, Value units);
+
+	/**
+	 * \brief Tries to lock the semaphore for given duration of time, acquiring multiple units at once.
+	 *
+	 * Template variant of tryWaitFor(TickClock::duration, Value).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Rep is type of tick counter
+	 * \tparam Period is std::ratio type representing the tick period of the clock, seconds
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated without locking the semaphore
+	 * \param [in] units is the number of units that will be acquired
+	 *
+	 * \return 0 if the calling process successfully performed the semaphore lock operation, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - EINVAL - \a units is 0 or greater than max value of semaphore;
+	 * - ETIMEDOUT - the semaphore could not be locked before the specified timeout expired;
+	 */
+
+	template<typename Rep, typename Period>
+	int tryWaitFor(const std::chrono::duration<Rep, Period> duration, const Value units)
+	{
+		return tryWaitFor(std::chrono::duration_cast<TickClock::duration>(duration), units);
+	}
+
 	/**
 	 * \brief Tries to lock the semaphore until given time point.
 	 *
@@ -177,7 +283,10 @@ public:
 	 * - ETIMEDOUT - the semaphore could not be locked before the specified timeout expired;
 	 */
 
-	int tryWaitUntil(TickClock::time_point timePoint);
+	int tryWaitUntil(const TickClock::time_point timePoint)
+	{
+		return tryWaitUntil(timePoint, 1);
+	}
 
 	/**
 	 * \brief Tries to lock the semaphore until given time point.
@@ -201,6 +310,48 @@ public:
 		return tryWaitUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint));
 	}
 
+	/**
+	 * \brief Tries to lock the semaphore until given time point, acquiring multiple units at once.
+	 *
+	 * Same as tryWaitUntil(TickClock::time_point), but \a units are acquired atomically, as in tryWait(Value).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated without locking the semaphore
+	 * \param [in] units is the number of units that will be acquired
+	 *
+	 * \return 0 if the calling process successfully performed the semaphore lock operation, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - EINVAL - \a units is 0 or greater than max value of semaphore;
+	 * - ETIMEDOUT - the semaphore could not be locked before the specified timeout expired;
+	 */
+
+	int tryWaitUntil(TickClock::time_point timePoint, Value units);
+
+	/**
+	 * \brief Tries to lock the semaphore until given time point, acquiring multiple units at once.
+	 *
+	 * Template variant of tryWaitUntil(TickClock::time_point, Value).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Duration is a std::chrono::duration type used to measure duration
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated without locking the semaphore
+	 * \param [in] units is the number of units that will be acquired
+	 *
+	 * \return 0 if the calling process successfully performed the semaphore lock operation, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - EINVAL - \a units is 0 or greater than max value of semaphore;
+	 * - ETIMEDOUT - the semaphore could not be locked before the specified timeout expired;
+	 */
+
+	template<typename Duration>
+	int tryWaitUntil(const std::chrono::time_point<TickClock, Duration> timePoint, const Value units)
+	{
+		return tryWaitUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint), units);
+	}
+
 	/**
 	 * \brief Locks the semaphore.
 	 *
@@ -217,7 +368,27 @@ public:
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 */
 
-	int wait();
+	int wait()
+	{
+		return wait(1);
+	}
+
+	/**
+	 * \brief Locks the semaphore, acquiring multiple units at once.
+	 *
+	 * If \a units cannot be acquired immediately (as in tryWait(Value)), the calling thread shall block until all of
+	 * them can be acquired atomically or the call is interrupted by a signal.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] units is the number of units that will be acquired
+	 *
+	 * \return 0 if the calling process successfully performed the semaphore lock operation, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - EINVAL - \a units is 0 or greater than max value of semaphore;
+	 */
+
+	int wait(Value units);
 
 	Semaphore(const Semaphore&) = delete;
 	Semaphore(Semaphore&&) = default;
@@ -227,15 +398,40 @@ public:
 private:
 
 	/**
-	 * \brief Internal version of tryWait().
+	 * \brief Internal version of tryWait(Value).
 	 *
-	 * Internal version with no interrupt masking.
+	 * Internal version with no interrupt masking and no validation of \a units.
+	 *
+	 * \param [in] units is the number of units that will be acquired
 	 *
 	 * \return 0 if the calling process successfully performed the semaphore lock operation, error code otherwise:
-	 * - EAGAIN - semaphore was already locked, so it cannot be immediately locked by the tryWait() operation;
+	 * - EAGAIN - requested units cannot be immediately acquired;
+	 */
+
+	int tryWaitInternal(Value units);
+
+	/**
+	 * \brief Unblocks threads from the beginning of blockedList_ as long as their requests can be satisfied.
+	 *
+	 * \attention this function must be called with interrupts masked
+	 */
+
+	void unblockWaiters();
+
+	/**
+	 * \brief Implementation of tryWaitUntil(TickClock::time_point, Value) and wait(Value).
+	 *
+	 * \param [in] timePoint is a pointer to time point at which the wait will be terminated without locking the
+	 * semaphore, nullptr to wait indefinitely
+	 * \param [in] units is the number of units that will be acquired
+	 *
+	 * \return 0 if the calling process successfully performed the semaphore lock operation, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - EINVAL - \a units is 0 or greater than max value of semaphore;
+	 * - ETIMEDOUT - the semaphore could not be locked before the specified timeout expired;
 	 */
 
-	int tryWaitInternal();
+	int waitInternal(const TickClock::time_point* timePoint, Value units);
 
 	/// ThreadControlBlock objects blocked on this semaphore
 	internal::ThreadList blockedList_;
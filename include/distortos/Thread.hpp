@@ -14,6 +14,7 @@
 
 #include "distortos/distortosConfiguration.h"
 
+#include "distortos/HeapStatistics.hpp"
 #include "distortos/SchedulingPolicy.hpp"
 #include "distortos/SignalSet.hpp"
 #include "distortos/ThreadState.hpp"
@@ -90,6 +91,16 @@ public:
 
 	virtual uint8_t getEffectivePriority() const = 0;
 
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+	/**
+	 * \return heap usage statistics of the thread
+	 */
+
+	virtual HeapStatistics getHeapStatistics() const = 0;
+
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
 	/**
 	 * \return identifier of thread, default-constructed ThreadIdentifier if this object doesn't represent a valid
 	 * thread of execution (e.g. after the thread is detached)
@@ -121,6 +132,13 @@ public:
 
 	virtual uint8_t getPriority() const = 0;
 
+	/**
+	 * \return number of system ticks during which the thread was running - it is the thread which was current when
+	 * the tick interrupt occurred, so the value is a statistical approximation of consumed CPU time
+	 */
+
+	virtual uint64_t getRunTickCount() const = 0;
+
 	/**
 	 * \return scheduling policy of the thread
 	 */
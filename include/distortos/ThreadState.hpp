@@ -2,7 +2,7 @@
  * \file
  * \brief ThreadState enum class header
  *
- * \author Copyright (C) 2015-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2015-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -43,6 +43,14 @@ enum class ThreadState : uint8_t
 	blockedOnMutex,
 	/// thread is blocked on ConditionVariable
 	blockedOnConditionVariable,
+	/// thread is blocked on IpcEndpoint, waiting for its call to be received and replied
+	blockedOnIpcEndpointCall,
+	/// thread is blocked on IpcEndpoint, waiting for a call
+	blockedOnIpcEndpointReceive,
+	/// thread is blocked on LatestValue or TripleBuffer, waiting for a new value
+	blockedOnNewValue,
+	/// thread is blocked on Barrier or Latch
+	blockedOnBarrier,
 
 #if CONFIG_SIGNALS_ENABLE == 1
 
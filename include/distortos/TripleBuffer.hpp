@@ -0,0 +1,210 @@
+/**
+ * \file
+ * \brief TripleBuffer class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_TRIPLEBUFFER_HPP_
+#define INCLUDE_DISTORTOS_TRIPLEBUFFER_HPP_
+
+#include "distortos/internal/synchronization/TripleBufferBase.hpp"
+
+namespace distortos
+{
+
+/**
+ * \brief TripleBuffer class hands off frames (like samples of sensors or rendered images) from single producer to
+ * single consumer without copying and without blocking the producer.
+ *
+ * Producer fills the "back" buffer (getWriteBuffer()) and publishes it with publish(). Consumer takes the latest
+ * published frame with update() (or waits for it with wait(), tryWaitFor() or tryWaitUntil()) and then uses the "front"
+ * buffer (getReadBuffer()). Frames published while consumer was busy are replaced by newer ones. Both sides only
+ * exchange indexes of buffers with interrupts masked for a few instructions, so producer and consumer may run in
+ * threads or interrupts and neither of them ever waits for the other.
+ *
+ * \tparam T is the type of frame
+ *
+ * \ingroup synchronization
+ */
+
+template<typename T>
+class TripleBuffer
+{
+public:
+
+	/**
+	 * \brief TripleBuffer's constructor
+	 *
+	 * All buffers are value-initialized.
+	 */
+
+	constexpr TripleBuffer() :
+			tripleBufferBase_{},
+			buffers_{}
+	{
+
+	}
+
+	/**
+	 * \return reference to "front" buffer with the latest taken frame, owned by consumer
+	 */
+
+	T& getReadBuffer()
+	{
+		return buffers_[tripleBufferBase_.getFrontIndex()];
+	}
+
+	/**
+	 * \return reference to "back" buffer, owned by producer
+	 */
+
+	T& getWriteBuffer()
+	{
+		return buffers_[tripleBufferBase_.getBackIndex()];
+	}
+
+	/**
+	 * \brief Publishes "back" buffer as the latest frame and unblocks consumer waiting for it.
+	 *
+	 * After this call getWriteBuffer() returns a different buffer, contents of which are not specified.
+	 */
+
+	void publish()
+	{
+		tripleBufferBase_.publish();
+	}
+
+	/**
+	 * \brief Tries to wait for new frame for a given duration of time and takes it if it is available.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 *
+	 * \return 0 if new frame was taken (it is available via getReadBuffer()), error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no frame was published before the specified timeout expired;
+	 */
+
+	int tryWaitFor(const TickClock::duration duration)
+	{
+		return tripleBufferBase_.tryWaitFor(duration);
+	}
+
+	/**
+	 * \brief Tries to wait for new frame for a given duration of time and takes it if it is available.
+	 *
+	 * Template variant of tryWaitFor(TickClock::duration).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Rep is type of tick counter
+	 * \tparam Period is std::ratio type representing the tick period of the clock, seconds
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 *
+	 * \return 0 if new frame was taken (it is available via getReadBuffer()), error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no frame was published before the specified timeout expired;
+	 */
+
+	template<typename Rep, typename Period>
+	int tryWaitFor(const std::chrono::duration<Rep, Period> duration)
+	{
+		return tryWaitFor(std::chrono::duration_cast<TickClock::duration>(duration));
+	}
+
+	/**
+	 * \brief Tries to wait for new frame until a given time point and takes it if it is available.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 *
+	 * \return 0 if new frame was taken (it is available via getReadBuffer()), error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no frame was published before the specified timeout expired;
+	 */
+
+	int tryWaitUntil(const TickClock::time_point timePoint)
+	{
+		return tripleBufferBase_.tryWaitUntil(timePoint);
+	}
+
+	/**
+	 * \brief Tries to wait for new frame until a given time point and takes it if it is available.
+	 *
+	 * Template variant of tryWaitUntil(TickClock::time_point).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Duration is a std::chrono::duration type used to measure duration
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 *
+	 * \return 0 if new frame was taken (it is available via getReadBuffer()), error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no frame was published before the specified timeout expired;
+	 */
+
+	template<typename Duration>
+	int tryWaitUntil(const std::chrono::time_point<TickClock, Duration> timePoint)
+	{
+		return tryWaitUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint));
+	}
+
+	/**
+	 * \brief Takes the latest published frame if it is available.
+	 *
+	 * \return true if new frame was taken (it is available via getReadBuffer()), false if no frame was published since
+	 * last call (getReadBuffer() still returns the same frame)
+	 */
+
+	bool update()
+	{
+		return tripleBufferBase_.update();
+	}
+
+	/**
+	 * \brief Waits for new frame and takes it.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 if new frame was taken (it is available via getReadBuffer()), error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 */
+
+	int wait()
+	{
+		return tripleBufferBase_.wait();
+	}
+
+	/**
+	 * \brief Copies value to "back" buffer and publishes it.
+	 *
+	 * \param [in] value is a reference to new frame
+	 */
+
+	void write(const T& value)
+	{
+		getWriteBuffer() = value;
+		publish();
+	}
+
+private:
+
+	/// internal::TripleBufferBase object which manages indexes of buffers
+	internal::TripleBufferBase tripleBufferBase_;
+
+	/// buffers for frames
+	T buffers_[3];
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_TRIPLEBUFFER_HPP_
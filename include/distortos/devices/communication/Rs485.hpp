@@ -2,7 +2,7 @@
  * \file
  * \brief Rs485 class header
  *
- * \author Copyright (C) 2016 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2016-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -25,6 +25,9 @@ class OutputPin;
 /**
  * Rs485 class is a RS-485 variant of serial port with an interface similar to standard files
  *
+ * On multidrop buses SerialPort::setMuteMode() with UartWakeup::addressMark and 9-bit characters can be used to
+ * receive only frames addressed to this node.
+ *
  * \ingroup devices
  */
 
@@ -2,7 +2,7 @@
  * \file
  * \brief SerialPort class header
  *
- * \author Copyright (C) 2016-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2016-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -14,6 +14,7 @@
 
 #include "distortos/devices/communication/UartBase.hpp"
 #include "distortos/devices/communication/UartParity.hpp"
+#include "distortos/devices/communication/UartWakeup.hpp"
 
 #include "distortos/Mutex.hpp"
 
@@ -25,6 +26,7 @@ class Semaphore;
 namespace devices
 {
 
+class IoRequest;
 class UartLowLevel;
 
 /**
@@ -275,6 +277,23 @@ public:
 		volatile size_t writePosition_;
 	};
 
+	/**
+	 * \brief Type of receive hook, called from interrupt context for each received character.
+	 *
+	 * The hook gets the data that was just received, before it becomes visible to readers. It may modify the data in
+	 * place and it may drop some of it - kept data must be moved to the beginning of the buffer.
+	 *
+	 * \param [in] serialPort is a reference to SerialPort which received the data
+	 * \param [in,out] buffer is a pointer to received data
+	 * \param [in] size is the size of received data, bytes
+	 *
+	 * \return pair with number of bytes (from the beginning of \a buffer) that will be passed to readers, must be even
+	 * if selected character length is greater than 8 bits, and a flag which - when true - wakes up the blocked reader
+	 * or completes pending asynchronous read even if the requested minimum size was not reached yet
+	 */
+
+	using ReceiveHook = std::pair<size_t, bool>(*)(SerialPort& serialPort, uint8_t* buffer, size_t size);
+
 	/**
 	 * \brief SerialPort's constructor
 	 *
@@ -293,13 +312,18 @@ public:
 					writeMutex_{Mutex::Protocol::priorityInheritance},
 					readBuffer_{readBuffer, (readBufferSize / 2) * 2},
 					writeBuffer_{writeBuffer, (writeBufferSize / 2) * 2},
+					readRequestBuffer_{static_cast<void*>(nullptr), 0},
+					writeRequestBuffer_{static_cast<void*>(nullptr), 0},
 					currentReadBuffer_{&readBuffer_},
 					currentWriteBuffer_{&writeBuffer_},
 					nextReadBuffer_{},
 					nextWriteBuffer_{},
+					readRequest_{},
+					writeRequest_{},
 					readSemaphore_{},
 					transmitSemaphore_{},
 					writeSemaphore_{},
+					receiveHook_{},
 					readLimit_{},
 					writeLimit_{},
 					uart_{uart},
@@ -307,6 +331,8 @@ public:
 					characterLength_{},
 					parity_{},
 					_2StopBits_{},
+					wakeup_{},
+					nodeAddress_{},
 					openCount_{},
 					readInProgress_{},
 					transmitInProgress_{},
@@ -325,12 +351,26 @@ public:
 
 	~SerialPort() override;
 
+	/**
+	 * \brief Cancels asynchronous operation started with startRead() or startWrite().
+	 *
+	 * Pending operation is stopped and the request is completed immediately with ECANCELED (or with 0 if the operation
+	 * was finished in the meantime) and with the number of bytes that were already transferred.
+	 *
+	 * \param [in] request is a reference to IoRequest which should be cancelled
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EINVAL - \a request is not pending on this device;
+	 */
+
+	int cancel(IoRequest& request);
+
 	/**
 	 * \brief Closes SerialPort.
 	 *
 	 * Does nothing if any user still has this device opened. Otherwise all transfers and low-level driver are stopped.
-	 * If any write transfer is still in progress, this function will wait for physical end of transmission before
-	 * shutting the device down.
+	 * Pending asynchronous operations are cancelled. If any write transfer is still in progress, this function will
+	 * wait for physical end of transmission before shutting the device down.
 	 *
 	 * If the function is interrupted by a signal, the device is not closed - the user should try to close it again.
 	 *
@@ -348,6 +388,7 @@ public:
 	 * \brief Opens SerialPort.
 	 *
 	 * Does nothing if any user already has this device opened. Otherwise low-level driver and buffered reads are
+	 * started. Mute mode configured with setMuteMode() is applied to low-level driver before buffered reads are
 	 * started.
 	 *
 	 * \warning This function must not be called from interrupt context!
@@ -361,6 +402,7 @@ public:
 	 * - EINVAL - provided arguments don't match current configuration of already opened device;
 	 * - EMFILE - this device is already opened too many times;
 	 * - ENOBUFS - read and/or write buffers are too small;
+	 * - error codes returned by UartLowLevel::setMuteMode();
 	 * - error codes returned by UartLowLevel::start();
 	 * - error codes returned by UartLowLevel::startRead();
 	 */
@@ -391,6 +433,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be read without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous read is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be read before the specified timeout expired;
@@ -400,6 +443,99 @@ public:
 	std::pair<int, size_t> read(void* buffer, size_t size, size_t minSize = 1,
 			const TickClock::time_point* timePoint = nullptr);
 
+	/**
+	 * \brief Configures mute mode of receiver.
+	 *
+	 * Mute mode is used on multidrop buses (e.g. RS-485) to receive only frames addressed to this node. While the
+	 * receiver is muted, received characters are discarded by hardware and don't generate any interrupts. With
+	 * UartWakeup::addressMark the receiver is woken up by address character - the one with most significant bit set,
+	 * so usually 9-bit characters are used - which matches \a nodeAddress, and it is muted again by address character
+	 * which doesn't match. With UartWakeup::idleLine the receiver is woken up by idle line, calling this function again
+	 * mutes it until the next idle line.
+	 *
+	 * The configuration is retained when the device is closed and applied each time it is opened. If the device is
+	 * opened, this function waits for physical end of transmission and the configuration is applied immediately.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] wakeup selects wakeup method, UartWakeup::none disables mute mode
+	 * \param [in] nodeAddress is the address of this node used with UartWakeup::addressMark, ignored otherwise,
+	 * default - 0
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - error codes returned by UartLowLevel::setMuteMode();
+	 */
+
+	int setMuteMode(UartWakeup wakeup, uint8_t nodeAddress = {});
+
+	/**
+	 * \brief Sets receive hook.
+	 *
+	 * When receive hook is set, reception is done one character at a time and each received character is passed to the
+	 * hook from interrupt context, so that it may be consumed, filtered or marked before it is passed to readers and so
+	 * that the reader can be woken up as soon as the hook decides. This allows reacting to specific characters (e.g.
+	 * XON/XOFF or sync bytes) without the overhead of thread wakeup.
+	 *
+	 * Receive hook may be set or changed at any time, it is retained when the device is closed.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] receiveHook is the function called for each received character, nullptr to disable receive hook
+	 */
+
+	void setReceiveHook(ReceiveHook receiveHook);
+
+	/**
+	 * \brief Starts asynchronous read from SerialPort.
+	 *
+	 * This function never blocks. Data available in internal buffer is copied to \a buffer immediately, all following
+	 * data is received directly to \a buffer. \a request is completed when at least \a minSize bytes (but no more than
+	 * \a size) were read - possibly from interrupt context - with the number of read bytes as the transferred amount.
+	 * Until that moment \a buffer must remain valid and read() cannot be used. Only one asynchronous read may be
+	 * pending at any given moment.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] request is a reference to IoRequest which will be completed when the operation is finished
+	 * \param [out] buffer is the buffer to which the data will be written
+	 * \param [in] size is the size of \a buffer, bytes, must be even if selected character length is greater than 8
+	 * bits
+	 * \param [in] minSize is the minimum size of read, bytes, default - 1
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - EBUSY - other read is in progress or \a request is already pending;
+	 * - EINVAL - \a buffer and/or \a size are invalid;
+	 * - error codes returned by UartLowLevel::startRead();
+	 */
+
+	int startRead(IoRequest& request, void* buffer, size_t size, size_t minSize = 1);
+
+	/**
+	 * \brief Starts asynchronous write to SerialPort.
+	 *
+	 * This function never blocks. Data is transmitted directly from \a buffer after all data already present in
+	 * internal buffer. \a request is completed when all \a size bytes were written - possibly from interrupt context -
+	 * with the number of written bytes as the transferred amount. Until that moment \a buffer must remain valid and
+	 * write() cannot be used. Only one asynchronous write may be pending at any given moment.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] request is a reference to IoRequest which will be completed when the operation is finished
+	 * \param [in] buffer is the buffer with data that will be transmitted
+	 * \param [in] size is the size of \a buffer, bytes, must be even if selected character length is greater than 8
+	 * bits
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - EBUSY - other write is in progress or \a request is already pending;
+	 * - EINVAL - \a buffer and/or \a size are invalid;
+	 * - error codes returned by UartLowLevel::startWrite();
+	 */
+
+	int startWrite(IoRequest& request, const void* buffer, size_t size);
+
 	/**
 	 * \brief Wrapper for read() with relative timeout
 	 *
@@ -415,6 +551,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be read without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous read is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be read before the specified timeout expired;
@@ -447,6 +584,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be read without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous read is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be read before the specified timeout expired;
@@ -475,6 +613,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be read without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous read is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be read before the specified timeout expired;
@@ -506,6 +645,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be read without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous read is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be read before the specified timeout expired;
@@ -534,6 +674,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be written without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous write is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be written before the specified timeout expired;
@@ -566,6 +707,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be written without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous write is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be written before the specified timeout expired;
@@ -594,6 +736,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be written without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous write is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be written before the specified timeout expired;
@@ -623,6 +766,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be written without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous write is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be written before the specified timeout expired;
@@ -660,6 +804,7 @@ public:
 	 * error code is returned); error codes:
 	 * - EAGAIN - no data can be written without blocking and non-blocking operation was requested (\a minSize is 0);
 	 * - EBADF - the device is not opened;
+	 * - EBUSY - asynchronous write is pending;
 	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
 	 * - EINVAL - \a buffer and/or \a size are invalid;
 	 * - ETIMEDOUT - required amount of data could not be written before the specified timeout expired;
@@ -676,10 +821,12 @@ protected:
 	 *
 	 * Called by low-level UART driver when whole read buffer is filled.
 	 *
+	 * - passes received data to receive hook (if it is set);
 	 * - updates position of read circular buffer;
 	 * - changes current buffer to next one (if there is any next buffer and if current one is full);
 	 * - updates size limit of read operations;
-	 * - notifies any thread waiting for this event (if size limit of read operations reached 0);
+	 * - notifies any thread waiting for this event or completes pending asynchronous read (if size limit of read
+	 * operations reached 0 or if receive hook requested that);
 	 * - clears "read in progress" flag;
 	 * - starts next read operation if current read buffer is not full;
 	 *
@@ -732,6 +879,7 @@ protected:
 	 * - updates size limit of write operations;
 	 * - clears "write in progress" flag;
 	 * - notifies any thread waiting for this event (if size limit of write operations reached 0);
+	 * - completes pending asynchronous write (if all its data was transferred);
 	 * - starts next write operation if current write buffer is not empty;
 	 *
 	 * \param [in] bytesWritten is the number of bytes written by low-level UART driver (and read from write buffer)
@@ -741,6 +889,44 @@ protected:
 
 private:
 
+	/**
+	 * \brief Cancels pending asynchronous read, if any.
+	 *
+	 * Read operation is stopped, the request is completed and read operation to internal buffer is restarted.
+	 */
+
+	void cancelReadRequest();
+
+	/**
+	 * \brief Cancels pending asynchronous write, if any.
+	 *
+	 * Write operation is stopped, the request is completed and write operation from internal buffer is restarted.
+	 */
+
+	void cancelWriteRequest();
+
+	/**
+	 * \brief Completes pending asynchronous read and restores internal circular read buffer.
+	 *
+	 * \note This function must be called from interrupt context or with interrupts masked, when read operation is not
+	 * in progress.
+	 *
+	 * \param [in] ret is the return code with which the request will be completed
+	 */
+
+	void completeReadRequest(int ret);
+
+	/**
+	 * \brief Completes pending asynchronous write and restores internal circular write buffer.
+	 *
+	 * \note This function must be called from interrupt context or with interrupts masked, when write operation is not
+	 * in progress.
+	 *
+	 * \param [in] ret is the return code with which the request will be completed
+	 */
+
+	void completeWriteRequest(int ret);
+
 	/**
 	 * \brief Reads data from circular buffer and calls startReadWrapper().
 	 *
@@ -773,8 +959,8 @@ private:
 	 *
 	 * Does nothing if read is already in progress or if read circular buffer is full. Otherwise sets "read in progress"
 	 * flag, starts read operation with size that is the smallest of: size of first available write block, half the size
-	 * of read circular buffer (only for internal buffer) and current size limit of read operations (only if it's not
-	 * equal to 0).
+	 * of read circular buffer (only for internal buffer), current size limit of read operations (only if it's not
+	 * equal to 0) and size of single character (only if receive hook is set).
 	 *
 	 * \return 0 on success, error code otherwise:
 	 * - error codes returned by UartLowLevel::startRead();
@@ -818,6 +1004,15 @@ private:
 
 	size_t stopWriteWrapper();
 
+	/**
+	 * \brief Waits for physical end of write operation.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 */
+
+	int waitForTransmitComplete();
+
 	/**
 	 * \brief Implementation of basic write() functionality
 	 *
@@ -845,10 +1040,10 @@ private:
 
 	int writeToCircularBufferAndStartWrite(CircularBuffer& buffer);
 
-	/// mutex used to serialize access to read(), close() and open()
+	/// mutex used to serialize access to read(), close(), open() and setMuteMode()
 	Mutex readMutex_;
 
-	/// mutex used to serialize access to write(), close() and open()
+	/// mutex used to serialize access to write(), close(), open() and setMuteMode()
 	Mutex writeMutex_;
 
 	/// internal instance of circular buffer for read operations
@@ -857,6 +1052,12 @@ private:
 	/// internal instance of circular buffer for write operations
 	CircularBuffer writeBuffer_;
 
+	/// circular buffer wrapping the buffer of pending asynchronous read
+	CircularBuffer readRequestBuffer_;
+
+	/// circular buffer wrapping the buffer of pending asynchronous write
+	CircularBuffer writeRequestBuffer_;
+
 	/// pointer to current circular buffer for read operations, always valid
 	CircularBuffer* volatile currentReadBuffer_;
 
@@ -869,6 +1070,12 @@ private:
 	/// pointer to next circular buffer for write operations, used when \a currentWriteBuffer_ becomes empty
 	CircularBuffer* volatile nextWriteBuffer_;
 
+	/// pointer to pending asynchronous read request, nullptr if none
+	IoRequest* volatile readRequest_;
+
+	/// pointer to pending asynchronous write request, nullptr if none
+	IoRequest* volatile writeRequest_;
+
 	/// pointer to semaphore used for "read complete" event notifications
 	Semaphore* volatile readSemaphore_;
 
@@ -878,6 +1085,9 @@ private:
 	/// pointer to semaphore used for "write complete" event notifications
 	Semaphore* volatile writeSemaphore_;
 
+	/// receive hook called for each received character, nullptr if not set
+	volatile ReceiveHook receiveHook_;
+
 	/// size limit of read operations, 0 if no limiting is needed, bytes
 	volatile size_t readLimit_;
 
@@ -898,6 +1108,11 @@ private:
 
 	/// current configuration of stop bits: 1 (false) or 2 (true)
 	bool _2StopBits_;
+	/// current wakeup method of receiver in mute mode, UartWakeup::none if mute mode is disabled
+	UartWakeup wakeup_;
+
+	/// current node address used with UartWakeup::addressMark
+	uint8_t nodeAddress_;
 
 	/// number of times this device was opened but not yet closed
 	uint8_t openCount_;
@@ -24,6 +24,7 @@ class Semaphore;
 namespace devices
 {
 
+class IoRequest;
 class SpiDevice;
 class SpiDeviceProxy;
 class SpiMaster;
@@ -56,11 +57,28 @@ public:
 	/**
 	 * \brief SpiMasterProxy's destructor
 	 *
+	 * The effect of destroying a proxy with pending asynchronous transaction is undefined.
+	 *
 	 * \warning This function must not be called from interrupt context!
 	 */
 
 	~SpiMasterProxy() override;
 
+	/**
+	 * \brief Requests cancellation of asynchronous transaction started with startTransaction().
+	 *
+	 * Transfer which is already in progress cannot be stopped, so the transaction is finished after that transfer and
+	 * the request is completed with ECANCELED and with the number of successfully completed operations.
+	 *
+	 * \param [in] request is a reference to IoRequest which should be cancelled
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - the last operation of transaction is already in progress, so it cannot be cancelled;
+	 * - EINVAL - \a request is not pending on this proxy;
+	 */
+
+	int cancel(IoRequest& request);
+
 	/**
 	 * \brief Configures parameters of associated SPI master.
 	 *
@@ -90,6 +108,7 @@ public:
 	 * \return pair with return code (0 on success, error code otherwise) and number of successfully completed
 	 * operations from \a operationsRange; error codes:
 	 * - EBADF - associated SPI device or associated SPI master are not opened;
+	 * - EBUSY - asynchronous transaction is pending;
 	 * - EINVAL - \a operationsRange has no operations;
 	 * - EIO - failure detected by low-level SPI master driver;
 	 * - error codes returned by SpiMasterLowLevel::startTransfer();
@@ -97,6 +116,32 @@ public:
 
 	std::pair<int, size_t> executeTransaction(SpiMasterOperationsRange operationsRange);
 
+	/**
+	 * \brief Starts series of operations as a single atomic asynchronous transaction.
+	 *
+	 * This function never blocks. The transaction is finished when all operations are complete or when any error is
+	 * detected - then \a request is completed (usually from interrupt context) with the number of successfully
+	 * completed operations from \a operationsRange as the transferred amount. Until that moment \a operationsRange,
+	 * this proxy and - if used - SpiDeviceSelectGuard must remain valid. Only one transaction may be pending at any
+	 * given moment.
+	 *
+	 * Error codes with which \a request may be completed:
+	 * - ECANCELED - transaction was cancelled with cancel();
+	 * - EIO - failure detected by low-level SPI master driver;
+	 * - error codes returned by SpiMasterLowLevel::startTransfer();
+	 *
+	 * \param [in] request is a reference to IoRequest which will be completed when the transaction is finished
+	 * \param [in] operationsRange is the range of operations that will be executed
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - associated SPI device or associated SPI master are not opened;
+	 * - EBUSY - other transaction is pending or \a request is already pending;
+	 * - EINVAL - \a operationsRange has no operations;
+	 * - error codes returned by SpiMasterLowLevel::startTransfer();
+	 */
+
+	int startTransaction(IoRequest& request, SpiMasterOperationsRange operationsRange);
+
 	SpiMasterProxy(const SpiMasterProxy&) = delete;
 	SpiMasterProxy& operator=(const SpiMasterProxy&) = delete;
 
@@ -115,7 +160,7 @@ private:
 	SpiMaster& getSpiMaster() const;
 
 	/**
-	 * \brief Notifies waiting thread about completion of transaction.
+	 * \brief Notifies waiting thread or completes pending request after completion of transaction.
 	 *
 	 * \param [in] ret is the last error code returned by transaction handling code, default - 0
 	 */
@@ -127,8 +172,9 @@ private:
 	 *
 	 * Called by low-level SPI master driver when the transfer is physically finished.
 	 *
-	 * Handles the next operation from the currently handled transaction. If there are no more operations, waiting
-	 * thread is notified about completion of transaction.
+	 * Handles the next operation from the currently handled transaction. If there are no more operations (or if
+	 * cancellation of asynchronous transaction was requested), waiting thread is notified about completion of
+	 * transaction or pending request is completed.
 	 *
 	 * \param [in] errorSet is the set of error bits
 	 * \param [in] bytesTransfered is the number of bytes transferred by low-level SPI master driver (read from write
@@ -149,6 +195,15 @@ private:
 
 	/// pointer to semaphore used to notify waiting thread about completion of transaction
 	Semaphore* volatile semaphore_;
+
+	/// pointer to request of pending asynchronous transaction, nullptr if none
+	IoRequest* volatile request_;
+
+	/// number of operations in pending asynchronous transaction
+	size_t requestOperations_;
+
+	/// true if cancellation of pending asynchronous transaction was requested, false otherwise
+	volatile bool cancelRequested_;
 };
 
 }	// namespace devices
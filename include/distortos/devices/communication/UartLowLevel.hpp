@@ -2,7 +2,7 @@
  * \file
  * \brief UartLowLevel class header
  *
- * \author Copyright (C) 2016-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2016-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -13,6 +13,7 @@
 #define INCLUDE_DISTORTOS_DEVICES_COMMUNICATION_UARTLOWLEVEL_HPP_
 
 #include "distortos/devices/communication/UartParity.hpp"
+#include "distortos/devices/communication/UartWakeup.hpp"
 
 #include <utility>
 
@@ -42,6 +43,26 @@ public:
 
 	virtual ~UartLowLevel() = 0;
 
+	/**
+	 * \brief Configures mute mode of receiver.
+	 *
+	 * When mute mode is enabled, the receiver is muted immediately. Characters received while the receiver is muted are
+	 * discarded by hardware - they are not reported with UartBase::readCompleteEvent() and they don't generate any
+	 * interrupts. Receiver is woken up by selected event - idle line or address character with matching node address.
+	 * Address character is the one which has its most significant bit set (bit 8 when character length is 9 bits).
+	 * Calling this function again with the same configuration mutes the receiver again.
+	 *
+	 * \param [in] wakeup selects wakeup method, UartWakeup::none disables mute mode
+	 * \param [in] address is the node address used with UartWakeup::addressMark, ignored otherwise
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not started;
+	 * - EBUSY - read and/or write are in progress;
+	 * - EINVAL - \a address is invalid;
+	 */
+
+	virtual int setMuteMode(UartWakeup wakeup, uint8_t address) = 0;
+
 	/**
 	 * \brief Starts low-level UART driver.
 	 *
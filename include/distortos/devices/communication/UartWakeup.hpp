@@ -0,0 +1,44 @@
+/**
+ * \file
+ * \brief UartWakeup enum class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_COMMUNICATION_UARTWAKEUP_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_COMMUNICATION_UARTWAKEUP_HPP_
+
+#include <cstdint>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/**
+ * UART receiver wakeup method, used to leave mute mode
+ *
+ * \ingroup devices
+ */
+
+enum class UartWakeup : uint8_t
+{
+	/// mute mode is disabled, all received characters are reported
+	none,
+	/// receiver is woken up by idle line, it can be muted again until the next idle line
+	idleLine,
+	/// receiver is woken up by address character (most significant bit set) with matching node address and is muted
+	/// again by address character with different node address
+	addressMark,
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_COMMUNICATION_UARTWAKEUP_HPP_
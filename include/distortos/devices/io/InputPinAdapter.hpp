@@ -0,0 +1,68 @@
+/**
+ * \file
+ * \brief InputPinAdapter class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_IO_INPUTPINADAPTER_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_IO_INPUTPINADAPTER_HPP_
+
+#include "distortos/devices/io/InputPin.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/**
+ * InputPinAdapter class is an adapter which provides InputPin interface for any non-virtual pin type (for example
+ * chip::StaticInputPin), so that it can be used where InputPin is required.
+ *
+ * \tparam T is the type of adapted pin, must provide `bool get() const` member function
+ *
+ * \ingroup devices
+ */
+
+template<typename T>
+class InputPinAdapter : public InputPin
+{
+public:
+
+	/**
+	 * \brief InputPinAdapter's constructor
+	 *
+	 * \param [in] pin is a reference to adapted pin
+	 */
+
+	constexpr explicit InputPinAdapter(const T& pin) :
+			pin_{pin}
+	{
+
+	}
+
+	/**
+	 * \return current state of pin
+	 */
+
+	bool get() const override
+	{
+		return pin_.get();
+	}
+
+private:
+
+	/// reference to adapted pin
+	const T& pin_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_IO_INPUTPINADAPTER_HPP_
@@ -0,0 +1,202 @@
+/**
+ * \file
+ * \brief IoCompletionQueue class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_IO_IOCOMPLETIONQUEUE_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_IO_IOCOMPLETIONQUEUE_HPP_
+
+#include "distortos/devices/io/IoRequest.hpp"
+
+#include "distortos/Semaphore.hpp"
+#include "distortos/TickClock.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/**
+ * IoCompletionQueue class is a FIFO queue of completed IoRequest objects.
+ *
+ * Requests associated with the queue are pushed to it by devices when they are completed (possibly from interrupt
+ * context). Single thread can start operations on several devices and then wait for completion of any of them by
+ * popping requests from this queue, optionally with a timeout.
+ *
+ * \ingroup devices
+ */
+
+class IoCompletionQueue
+{
+	friend class IoRequest;
+
+public:
+
+	/**
+	 * \brief IoCompletionQueue's constructor
+	 */
+
+	constexpr IoCompletionQueue() :
+			list_{},
+			semaphore_{0}
+	{
+
+	}
+
+	/**
+	 * \brief IoCompletionQueue's destructor
+	 *
+	 * The effect of destroying a queue which is still associated with pending requests is undefined.
+	 */
+
+	~IoCompletionQueue() = default;
+
+	/**
+	 * \brief Pops the oldest completed request from the queue.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [out] request is a reference to pointer into which the address of popped request will be written
+	 *
+	 * \return 0 if request was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::wait();
+	 */
+
+	int pop(IoRequest*& request);
+
+	/**
+	 * \brief Tries to pop the oldest completed request from the queue.
+	 *
+	 * \param [out] request is a reference to pointer into which the address of popped request will be written
+	 *
+	 * \return 0 if request was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWait();
+	 */
+
+	int tryPop(IoRequest*& request);
+
+	/**
+	 * \brief Tries to pop the oldest completed request from the queue for a given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated without popping the request
+	 * \param [out] request is a reference to pointer into which the address of popped request will be written
+	 *
+	 * \return 0 if request was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitFor();
+	 */
+
+	int tryPopFor(TickClock::duration duration, IoRequest*& request);
+
+	/**
+	 * \brief Tries to pop the oldest completed request from the queue for a given duration of time.
+	 *
+	 * Template variant of tryPopFor(TickClock::duration, IoRequest*&).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Rep is type of tick counter
+	 * \tparam Period is std::ratio type representing the tick period of the clock, seconds
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated without popping the request
+	 * \param [out] request is a reference to pointer into which the address of popped request will be written
+	 *
+	 * \return 0 if request was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitFor();
+	 */
+
+	template<typename Rep, typename Period>
+	int tryPopFor(const std::chrono::duration<Rep, Period> duration, IoRequest*& request)
+	{
+		return tryPopFor(std::chrono::duration_cast<TickClock::duration>(duration), request);
+	}
+
+	/**
+	 * \brief Tries to pop the oldest completed request from the queue until a given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated without popping the request
+	 * \param [out] request is a reference to pointer into which the address of popped request will be written
+	 *
+	 * \return 0 if request was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitUntil();
+	 */
+
+	int tryPopUntil(TickClock::time_point timePoint, IoRequest*& request);
+
+	/**
+	 * \brief Tries to pop the oldest completed request from the queue until a given time point.
+	 *
+	 * Template variant of tryPopUntil(TickClock::time_point, IoRequest*&).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \tparam Duration is a std::chrono::duration type used to measure duration
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated without popping the request
+	 * \param [out] request is a reference to pointer into which the address of popped request will be written
+	 *
+	 * \return 0 if request was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitUntil();
+	 */
+
+	template<typename Duration>
+	int tryPopUntil(const std::chrono::time_point<TickClock, Duration> timePoint, IoRequest*& request)
+	{
+		return tryPopUntil(std::chrono::time_point_cast<TickClock::duration>(timePoint), request);
+	}
+
+	IoCompletionQueue(const IoCompletionQueue&) = delete;
+	IoCompletionQueue(IoCompletionQueue&&) = delete;
+	const IoCompletionQueue& operator=(const IoCompletionQueue&) = delete;
+	IoCompletionQueue& operator=(IoCompletionQueue&&) = delete;
+
+private:
+
+	/// type of intrusive list of completed requests
+	using List = estd::IntrusiveList<IoRequest, &IoRequest::node_>;
+
+	/**
+	 * \brief Pops the oldest completed request from the list.
+	 *
+	 * Internal version - after successful wait for \a semaphore_.
+	 *
+	 * \param [in] ret is the value returned by the wait for \a semaphore_
+	 * \param [out] request is a reference to pointer into which the address of popped request will be written
+	 *
+	 * \return \a ret
+	 */
+
+	int popInternal(int ret, IoRequest*& request);
+
+	/**
+	 * \brief Pushes completed request to the queue.
+	 *
+	 * \note This function may be called from interrupt context.
+	 *
+	 * \param [in] request is a reference to completed request
+	 */
+
+	void push(IoRequest& request);
+
+	/// intrusive list of completed requests
+	List list_;
+
+	/// semaphore with value equal to the number of requests in \a list_
+	Semaphore semaphore_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_IO_IOCOMPLETIONQUEUE_HPP_
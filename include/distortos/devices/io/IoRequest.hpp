@@ -0,0 +1,207 @@
+/**
+ * \file
+ * \brief IoRequest class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_IO_IOREQUEST_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_IO_IOREQUEST_HPP_
+
+#include "estd/IntrusiveList.hpp"
+
+#include <utility>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+class IoCompletionQueue;
+
+/**
+ * IoRequest class is a descriptor of single asynchronous I/O operation.
+ *
+ * The object is passed to one of "start...()" functions of a device (e.g. SerialPort::startRead(),
+ * SpiMasterProxy::startTransaction() or AsyncBlockDevice::startProgram()), which return immediately. When the operation
+ * is finished - successfully, with an error or because it was cancelled - the device completes the request. Completed
+ * request is either pushed to associated IoCompletionQueue or passed to associated callback. This allows single thread
+ * to keep several devices busy at the same time.
+ *
+ * Completion may happen in interrupt context, in the context of device's worker thread or - if the operation could be
+ * finished immediately - in the context of the thread which started the operation.
+ *
+ * The same object may be reused for next operation after it was completed and - if it has associated IoCompletionQueue
+ * - after it was popped from that queue.
+ *
+ * \ingroup devices
+ */
+
+class IoRequest
+{
+	friend class IoCompletionQueue;
+
+public:
+
+	/// type of function called on completion of request, may be called from interrupt context
+	using Callback = void(*)(IoRequest& request);
+
+	/**
+	 * \brief IoRequest's constructor
+	 *
+	 * Request constructed with this constructor has no completion notification, its state must be polled with
+	 * isPending().
+	 */
+
+	constexpr IoRequest() :
+			IoRequest{nullptr, nullptr}
+	{
+
+	}
+
+	/**
+	 * \brief IoRequest's constructor
+	 *
+	 * \param [in] completionQueue is a reference to IoCompletionQueue to which the request will be pushed when it is
+	 * completed
+	 */
+
+	constexpr explicit IoRequest(IoCompletionQueue& completionQueue) :
+			IoRequest{&completionQueue, nullptr}
+	{
+
+	}
+
+	/**
+	 * \brief IoRequest's constructor
+	 *
+	 * \param [in] callback is the function called when the request is completed, may be called from interrupt context
+	 */
+
+	constexpr explicit IoRequest(const Callback callback) :
+			IoRequest{nullptr, callback}
+	{
+
+	}
+
+	/**
+	 * \brief IoRequest's destructor
+	 *
+	 * The effect of destroying a request which is pending or which is linked in IoCompletionQueue is undefined.
+	 */
+
+	~IoRequest() = default;
+
+	/**
+	 * \brief Reverts the effect of begin() without any notification.
+	 *
+	 * This function is meant to be used by device drivers, when the operation could not be started after the request
+	 * was marked as pending.
+	 */
+
+	void abort()
+	{
+		pending_ = false;
+	}
+
+	/**
+	 * \brief Marks the request as pending.
+	 *
+	 * This function is meant to be used by device drivers.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - request is already pending or was not yet popped from its IoCompletionQueue;
+	 */
+
+	int begin();
+
+	/**
+	 * \brief Completes the request.
+	 *
+	 * Result is saved, request is marked as not pending and then it is either pushed to associated IoCompletionQueue or
+	 * passed to associated callback.
+	 *
+	 * This function is meant to be used by device drivers, it may be called from interrupt context.
+	 *
+	 * \param [in] ret is the return code of operation, 0 on success, error code otherwise
+	 * \param [in] size is the amount of data transferred by the operation, its unit depends on the device
+	 */
+
+	void complete(int ret, size_t size);
+
+	/**
+	 * \return pair with return code of the last completed operation (0 on success, error code otherwise) and the amount
+	 * of data transferred by that operation, its unit depends on the device; error codes:
+	 * - ECANCELED - operation was cancelled;
+	 * - error codes specific to the device which executed the operation;
+	 */
+
+	std::pair<int, size_t> getResult() const
+	{
+		return {ret_, size_};
+	}
+
+	/**
+	 * \return true if the request is pending (it was started, but it was not completed yet), false otherwise
+	 */
+
+	bool isPending() const
+	{
+		return pending_;
+	}
+
+	IoRequest(const IoRequest&) = delete;
+	IoRequest(IoRequest&&) = delete;
+	const IoRequest& operator=(const IoRequest&) = delete;
+	IoRequest& operator=(IoRequest&&) = delete;
+
+private:
+
+	/**
+	 * \brief IoRequest's constructor
+	 *
+	 * \param [in] completionQueue is a pointer to IoCompletionQueue to which the request will be pushed when it is
+	 * completed, nullptr if not used
+	 * \param [in] callback is the function called when the request is completed, nullptr if not used
+	 */
+
+	constexpr IoRequest(IoCompletionQueue* const completionQueue, const Callback callback) :
+			node_{},
+			completionQueue_{completionQueue},
+			callback_{callback},
+			size_{},
+			ret_{},
+			pending_{}
+	{
+
+	}
+
+	/// node for intrusive list in IoCompletionQueue
+	estd::IntrusiveListNode node_;
+
+	/// pointer to IoCompletionQueue to which the request will be pushed when it is completed, nullptr if not used
+	IoCompletionQueue* completionQueue_;
+
+	/// function called when the request is completed, nullptr if not used
+	Callback callback_;
+
+	/// amount of data transferred by the last completed operation
+	volatile size_t size_;
+
+	/// return code of the last completed operation
+	volatile int ret_;
+
+	/// true if the request is pending, false otherwise
+	volatile bool pending_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_IO_IOREQUEST_HPP_
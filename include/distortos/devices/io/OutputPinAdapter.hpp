@@ -0,0 +1,79 @@
+/**
+ * \file
+ * \brief OutputPinAdapter class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_IO_OUTPUTPINADAPTER_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_IO_OUTPUTPINADAPTER_HPP_
+
+#include "distortos/devices/io/OutputPin.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/**
+ * OutputPinAdapter class is an adapter which provides OutputPin interface for any non-virtual pin type (for example
+ * chip::StaticOutputPin), so that it can be used where OutputPin is required (for example in SpiDevice or Rs485).
+ *
+ * \tparam T is the type of adapted pin, must provide `bool get() const` and `void set(bool)` member functions
+ *
+ * \ingroup devices
+ */
+
+template<typename T>
+class OutputPinAdapter : public OutputPin
+{
+public:
+
+	/**
+	 * \brief OutputPinAdapter's constructor
+	 *
+	 * \param [in] pin is a reference to adapted pin
+	 */
+
+	constexpr explicit OutputPinAdapter(T& pin) :
+			pin_{pin}
+	{
+
+	}
+
+	/**
+	 * \return current state of pin
+	 */
+
+	bool get() const override
+	{
+		return pin_.get();
+	}
+
+	/**
+	 * \brief Sets state of pin.
+	 *
+	 * \param [in] state is the new state of pin
+	 */
+
+	void set(const bool state) override
+	{
+		pin_.set(state);
+	}
+
+private:
+
+	/// reference to adapted pin
+	T& pin_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_IO_OUTPUTPINADAPTER_HPP_
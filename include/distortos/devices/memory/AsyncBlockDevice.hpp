@@ -0,0 +1,292 @@
+/**
+ * \file
+ * \brief AsyncBlockDevice class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_MEMORY_ASYNCBLOCKDEVICE_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_MEMORY_ASYNCBLOCKDEVICE_HPP_
+
+#include "distortos/Semaphore.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+class BlockDevice;
+class IoRequest;
+
+/**
+ * AsyncBlockDevice class is an adapter which executes operations of any BlockDevice asynchronously, using IoRequest
+ * objects.
+ *
+ * Operations are executed by a worker thread with blocking BlockDevice interface, one at a time. The worker thread is
+ * provided by derived class (see StaticAsyncBlockDevice), is started with the first operation and runs until its exit
+ * is requested with requestWorkerExit(). Requests are
+ * completed in the context of worker thread. Block device must be opened and closed directly, with BlockDevice::open()
+ * and BlockDevice::close().
+ *
+ * \ingroup devices
+ */
+
+class AsyncBlockDevice
+{
+public:
+
+	/**
+	 * \brief AsyncBlockDevice's destructor
+	 *
+	 * The effect of destroying an object with pending request is undefined.
+	 */
+
+	virtual ~AsyncBlockDevice();
+
+	/**
+	 * \brief Cancels request which was not yet taken by worker thread.
+	 *
+	 * Cancelled request is completed immediately with ECANCELED. Operation which is already executed by worker thread
+	 * cannot be cancelled.
+	 *
+	 * \param [in] request is a reference to IoRequest which should be cancelled
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - operation is already executed by worker thread, so it cannot be cancelled;
+	 * - EINVAL - \a request is not pending on this device;
+	 */
+
+	int cancel(IoRequest& request);
+
+	/**
+	 * \brief Starts asynchronous erase of block device.
+	 *
+	 * \a request is completed with the result of BlockDevice::erase() and with 0 as the transferred amount.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] request is a reference to IoRequest which will be completed when the operation is finished
+	 * \param [in] address is the address of range that will be erased, must be a multiple of erase block size
+	 * \param [in] size is the size of erased range, bytes, must be a multiple of erase block size
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startOperation();
+	 */
+
+	int startErase(IoRequest& request, uint64_t address, uint64_t size);
+
+	/**
+	 * \brief Starts asynchronous program of data to block device.
+	 *
+	 * \a request is completed with the result of BlockDevice::program() - return code and number of programmed bytes.
+	 * Until that moment \a buffer must remain valid.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] request is a reference to IoRequest which will be completed when the operation is finished
+	 * \param [in] address is the address of data that will be programmed, must be a multiple of program block size
+	 * \param [in] buffer is the buffer with data that will be programmed
+	 * \param [in] size is the size of \a buffer, bytes, must be a multiple of program block size
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startOperation();
+	 */
+
+	int startProgram(IoRequest& request, uint64_t address, const void* buffer, size_t size);
+
+	/**
+	 * \brief Starts asynchronous read of data from block device.
+	 *
+	 * \a request is completed with the result of BlockDevice::read() - return code and number of read bytes. Until that
+	 * moment \a buffer must remain valid.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] request is a reference to IoRequest which will be completed when the operation is finished
+	 * \param [in] address is the address of data that will be read, must be a multiple of read block size
+	 * \param [out] buffer is the buffer into which the data will be read
+	 * \param [in] size is the size of \a buffer, bytes, must be a multiple of read block size
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startOperation();
+	 */
+
+	int startRead(IoRequest& request, uint64_t address, void* buffer, size_t size);
+
+	/**
+	 * \brief Starts asynchronous synchronization of block device.
+	 *
+	 * \a request is completed with the result of BlockDevice::synchronize() and with 0 as the transferred amount.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] request is a reference to IoRequest which will be completed when the operation is finished
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startOperation();
+	 */
+
+	int startSynchronize(IoRequest& request);
+
+	/**
+	 * \brief Starts asynchronous trim of block device.
+	 *
+	 * \a request is completed with the result of BlockDevice::trim() and with 0 as the transferred amount.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] request is a reference to IoRequest which will be completed when the operation is finished
+	 * \param [in] address is the address of range that will be trimmed, must be a multiple of erase block size
+	 * \param [in] size is the size of trimmed range, bytes, must be a multiple of erase block size
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startOperation();
+	 */
+
+	int startTrim(IoRequest& request, uint64_t address, uint64_t size);
+
+	AsyncBlockDevice(const AsyncBlockDevice&) = delete;
+	const AsyncBlockDevice& operator=(const AsyncBlockDevice&) = delete;
+
+protected:
+
+	/**
+	 * \brief AsyncBlockDevice's constructor
+	 *
+	 * \param [in] device is a reference to underlying block device
+	 */
+
+	constexpr explicit AsyncBlockDevice(BlockDevice& device) :
+			requestSemaphore_{0},
+			programBuffer_{},
+			readBuffer_{},
+			address_{},
+			size_{},
+			device_{device},
+			request_{},
+			executing_{},
+			exitRequested_{},
+			operation_{}
+	{
+
+	}
+
+	/**
+	 * \brief Requests worker thread to exit.
+	 *
+	 * Worker thread returns from runWorker() after finishing operation which is currently executed (if any). No
+	 * operations may be started after this call.
+	 *
+	 * \pre No request is pending on this device.
+	 */
+
+	void requestWorkerExit();
+
+	/**
+	 * \brief Main function of worker thread.
+	 *
+	 * Waits for requests and executes them, until exit is requested with requestWorkerExit().
+	 *
+	 * \param [in] asyncBlockDevice is a pointer to AsyncBlockDevice object which owns the worker thread
+	 */
+
+	static void runWorker(AsyncBlockDevice* asyncBlockDevice);
+
+	/**
+	 * \brief Starts worker thread, if it was not started yet.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise
+	 */
+
+	virtual int startWorker() = 0;
+
+private:
+
+	/// operation executed by worker thread
+	enum class Operation : uint8_t
+	{
+		/// erase
+		erase,
+		/// program
+		program,
+		/// read
+		read,
+		/// synchronize
+		synchronize,
+		/// trim
+		trim,
+	};
+
+	/**
+	 * \brief Executes pending request, if it was not cancelled, and completes it.
+	 *
+	 * Called by worker thread.
+	 */
+
+	void execute();
+
+	/**
+	 * \brief Starts asynchronous operation.
+	 *
+	 * Worker thread is started if needed, request is saved and worker thread is notified.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] request is a reference to IoRequest which will be completed when the operation is finished
+	 * \param [in] operation is the operation that will be executed
+	 * \param [in] address is the address of operation
+	 * \param [in] size is the size of operation, bytes
+	 * \param [in] programBuffer is the buffer with data for program operation, nullptr otherwise
+	 * \param [in] readBuffer is the buffer for data of read operation, nullptr otherwise
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - other request is pending on this device or \a request is already pending;
+	 * - error codes returned by startWorker();
+	 */
+
+	int startOperation(IoRequest& request, Operation operation, uint64_t address, uint64_t size,
+			const void* programBuffer, void* readBuffer);
+
+	/// semaphore posted when new request is ready for worker thread
+	Semaphore requestSemaphore_;
+
+	/// buffer with data for program operation
+	const void* programBuffer_;
+
+	/// buffer for data of read operation
+	void* readBuffer_;
+
+	/// address of operation
+	uint64_t address_;
+
+	/// size of operation, bytes
+	uint64_t size_;
+
+	/// reference to underlying block device
+	BlockDevice& device_;
+
+	/// pointer to pending request, nullptr if none
+	IoRequest* volatile request_;
+
+	/// true if pending request is executed by worker thread, false otherwise
+	volatile bool executing_;
+
+	/// true if worker thread should exit, false otherwise
+	volatile bool exitRequested_;
+
+	/// operation of pending request
+	Operation operation_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_MEMORY_ASYNCBLOCKDEVICE_HPP_
@@ -0,0 +1,407 @@
+/**
+ * \file
+ * \brief CompositeBlockDevice class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_MEMORY_COMPOSITEBLOCKDEVICE_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_MEMORY_COMPOSITEBLOCKDEVICE_HPP_
+
+#include "distortos/devices/memory/BlockDevice.hpp"
+#include "distortos/devices/memory/CompositeBlockDeviceMember.hpp"
+
+#include "distortos/Mutex.hpp"
+
+#include "estd/ContiguousRange.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/**
+ * CompositeBlockDevice class is a block device which presents several underlying block devices as one.
+ *
+ * In striped mode consecutive erase blocks are interleaved across all underlying devices, so the size of composite
+ * device is the number of devices multiplied by the size of the smallest one. In mirrored mode all underlying devices
+ * hold identical data - erase, program and trim operations are executed on all of them, while reads are distributed
+ * between them. Size of composite device in this mode is the size of the smallest underlying device.
+ *
+ * Members with helper threads (StaticCompositeBlockDeviceMember) execute their part of each operation concurrently, so
+ * when underlying devices use separate buses, throughput of large sequential operations scales with the number of
+ * buses. Parts of operations for members without helper threads (CompositeBlockDeviceMember) are executed by the
+ * calling thread.
+ *
+ * Read, program and erase block sizes of composite device are the largest respective sizes of underlying devices, all
+ * smaller sizes must be divisors of these values.
+ *
+ * \ingroup devices
+ */
+
+class CompositeBlockDevice : public BlockDevice
+{
+	friend class CompositeBlockDeviceMember;
+
+public:
+
+	/// mode of composite device
+	enum class Mode : uint8_t
+	{
+		/// erase blocks interleaved across all underlying devices
+		striped,
+		/// identical data on all underlying devices
+		mirrored,
+	};
+
+	/// range of pointers to members
+	using MembersRange = estd::ContiguousRange<CompositeBlockDeviceMember* const>;
+
+	/**
+	 * \brief CompositeBlockDevice's constructor
+	 *
+	 * \param [in] mode is the mode of composite device
+	 * \param [in] membersRange is the range of pointers to members, each underlying device may be used only once
+	 */
+
+	constexpr CompositeBlockDevice(const Mode mode, const MembersRange membersRange) :
+			mutex_{Mutex::Type::recursive, Mutex::Protocol::priorityInheritance},
+			membersRange_{membersRange},
+			size_{},
+			eraseBlockSize_{},
+			nextReader_{},
+			programBlockSize_{},
+			readBlockSize_{},
+			mode_{mode},
+			openCount_{}
+	{
+
+	}
+
+	/**
+	 * \brief CompositeBlockDevice's destructor
+	 *
+	 * \pre Device is closed.
+	 */
+
+	~CompositeBlockDevice() override;
+
+	/**
+	 * \brief Closes device.
+	 *
+	 * \note Even if error code is returned, the device must not be used from the context which opened it (until it is
+	 * successfully opened again).
+	 *
+	 * All underlying devices are closed when the device is closed for the last time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is already completely closed;
+	 * - error codes returned by BlockDevice::close() of underlying devices;
+	 */
+
+	int close() override;
+
+	/**
+	 * \brief Erases blocks on a device.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] address is the address of range that will be erased, must be a multiple of erase block size
+	 * \param [in] size is the size of erased range, bytes, must be a multiple of erase block size
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a size are not valid;
+	 * - ENOSPC - selected range is greater than size of device;
+	 * - error codes returned by BlockDevice::erase() of underlying devices;
+	 */
+
+	int erase(uint64_t address, uint64_t size) override;
+
+	/**
+	 * \return erase block size, bytes
+	 */
+
+	size_t getEraseBlockSize() const override;
+
+	/**
+	 * \return pair with bool telling whether erased value is defined (true) or not (false) and value of erased bytes
+	 * (valid only if defined); erased value is defined only if it is defined and identical for all underlying devices
+	 */
+
+	std::pair<bool, uint8_t> getErasedValue() const override;
+
+	/**
+	 * \return program block size, bytes
+	 */
+
+	size_t getProgramBlockSize() const override;
+
+	/**
+	 * \return read block size, bytes
+	 */
+
+	size_t getReadBlockSize() const override;
+
+	/**
+	 * \return size of device, bytes
+	 */
+
+	uint64_t getSize() const override;
+
+	/**
+	 * \brief Locks the device for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one transaction must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EAGAIN - the lock could not be acquired because the maximum number of recursive locks for device has been
+	 * exceeded;
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Opens device.
+	 *
+	 * When the device is opened for the first time, all underlying devices are opened, geometry of composite device is
+	 * calculated and helper threads are started (if they were not started yet).
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EINVAL - there are no members or block sizes of underlying devices are not compatible;
+	 * - EMFILE - this device is already opened too many times;
+	 * - error codes returned by BlockDevice::open() of underlying devices;
+	 * - error codes returned by CompositeBlockDeviceMember::startHelper();
+	 */
+
+	int open() override;
+
+	/**
+	 * \brief Programs data to a device.
+	 *
+	 * Selected range of blocks must have been erased prior to being programmed.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] address is the address of data that will be programmed, must be a multiple of program block size
+	 * \param [in] buffer is the buffer with data that will be programmed
+	 * \param [in] size is the size of \a buffer, bytes, must be a multiple of program block size
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of programmed bytes (valid even
+	 * when error code is returned); error codes:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a buffer and/or \a size are not valid;
+	 * - ENOSPC - selected range is greater than size of device;
+	 * - error codes returned by BlockDevice::program() of underlying devices;
+	 */
+
+	std::pair<int, size_t> program(uint64_t address, const void* buffer, size_t size) override;
+
+	/**
+	 * \brief Reads data from a device.
+	 *
+	 * In mirrored mode reads of at least one erase block per underlying device are split between all underlying
+	 * devices, smaller reads are executed by the device which was least recently used for reading.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] address is the address of data that will be read, must be a multiple of read block size
+	 * \param [out] buffer is the buffer into which the data will be read
+	 * \param [in] size is the size of \a buffer, bytes, must be a multiple of read block size
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of read bytes (valid even when
+	 * error code is returned); error codes:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a buffer and/or \a size are not valid;
+	 * - ENOSPC - selected range is greater than size of device;
+	 * - error codes returned by BlockDevice::read() of underlying devices;
+	 */
+
+	std::pair<int, size_t> read(uint64_t address, void* buffer, size_t size) override;
+
+	/**
+	 * \brief Synchronizes state of a device, ensuring all cached writes are finished.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - error codes returned by BlockDevice::synchronize() of underlying devices;
+	 */
+
+	int synchronize() override;
+
+	/**
+	 * \brief Trims unused blocks on a device.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] address is the address of range that will be trimmed, must be a multiple of erase block size
+	 * \param [in] size is the size of trimmed range, bytes, must be a multiple of erase block size
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a size are not valid;
+	 * - ENOSPC - selected range is greater than size of device;
+	 * - error codes returned by BlockDevice::trim() of underlying devices;
+	 */
+
+	int trim(uint64_t address, uint64_t size) override;
+
+	/**
+	 * \brief Unlocks the device which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EPERM - current thread did not lock the device;
+	 */
+
+	int unlock() override;
+
+private:
+
+	/// operation executed on members
+	using Operation = CompositeBlockDeviceMember::Operation;
+
+	/**
+	 * \brief Checks whether range of device is valid.
+	 *
+	 * \param [in] address is the address of range
+	 * \param [in] size is the size of range, bytes
+	 * \param [in] blockSize is the size of block, \a address and \a size must be a multiple of this value
+	 *
+	 * \return 0 if range is valid, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a size are not valid;
+	 * - ENOSPC - selected range is greater than size of device;
+	 */
+
+	int checkRange(uint64_t address, uint64_t size, size_t blockSize) const;
+
+	/**
+	 * \brief Closes first underlying devices.
+	 *
+	 * \param [in] count is the number of underlying devices that will be closed
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by BlockDevice::close() of underlying devices;
+	 */
+
+	int closeMembers(size_t count);
+
+	/**
+	 * \brief Executes operation on all members which take part in it.
+	 *
+	 * Requests are posted to helper threads first, then parts for members without helper threads are executed by
+	 * current thread and finally current thread waits for helper threads.
+	 *
+	 * \param [in] operation is the operation that will be executed
+	 * \param [in] address is the address of range, bytes
+	 * \param [in] programBuffer is the buffer with data for program operation, nullptr for other operations
+	 * \param [out] readBuffer is the buffer for data of read operation, nullptr for other operations
+	 * \param [in] size is the size of range, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of bytes from the beginning of
+	 * range which were processed successfully by all members; error codes:
+	 * - error codes returned by executeMember();
+	 */
+
+	std::pair<int, uint64_t> execute(Operation operation, uint64_t address, const void* programBuffer,
+			void* readBuffer, uint64_t size);
+
+	/**
+	 * \brief Executes request of one member.
+	 *
+	 * Result of execution is saved in \a member.
+	 *
+	 * \param [in] member is a reference to member with request
+	 */
+
+	void executeMember(CompositeBlockDeviceMember& member);
+
+	/**
+	 * \brief Executes request of one member on one contiguous range of its underlying device.
+	 *
+	 * \param [in] member is a reference to member with request
+	 * \param [in] address is the address in composite device, bytes
+	 * \param [in] deviceAddress is the address in underlying device, bytes
+	 * \param [in] size is the size of range, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of processed bytes; error codes:
+	 * - error codes returned by functions of underlying device;
+	 */
+
+	std::pair<int, uint64_t> executeRange(CompositeBlockDeviceMember& member, uint64_t address, uint64_t deviceAddress,
+			uint64_t size) const;
+
+	/**
+	 * \brief Tells whether member takes part in execution of operation.
+	 *
+	 * \param [in] operation is the operation that will be executed
+	 * \param [in] address is the address of range, bytes
+	 * \param [in] size is the size of range, bytes
+	 * \param [in] index is the index of member
+	 *
+	 * \return true if member with index \a index takes part in execution of operation, false otherwise
+	 */
+
+	bool isParticipating(Operation operation, uint64_t address, uint64_t size, size_t index) const;
+
+	/**
+	 * \return true if read of given size is split between all members in mirrored mode, false otherwise
+	 *
+	 * \param [in] size is the size of read, bytes
+	 */
+
+	bool isReadSplit(uint64_t size) const;
+
+	/// mutex used to serialize access to this object
+	Mutex mutex_;
+
+	/// range of pointers to members
+	MembersRange membersRange_;
+
+	/// size of device, bytes
+	uint64_t size_;
+
+	/// erase block size, bytes, also size of stripe in striped mode
+	size_t eraseBlockSize_;
+
+	/// index of member which will execute next read which is not split, used only in mirrored mode
+	size_t nextReader_;
+
+	/// program block size, bytes
+	size_t programBlockSize_;
+
+	/// read block size, bytes
+	size_t readBlockSize_;
+
+	/// mode of composite device
+	Mode mode_;
+
+	/// number of times this device was opened but not yet closed
+	uint8_t openCount_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_MEMORY_COMPOSITEBLOCKDEVICE_HPP_
@@ -0,0 +1,183 @@
+/**
+ * \file
+ * \brief CompositeBlockDeviceMember class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_MEMORY_COMPOSITEBLOCKDEVICEMEMBER_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_MEMORY_COMPOSITEBLOCKDEVICEMEMBER_HPP_
+
+#include "distortos/Semaphore.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+class BlockDevice;
+class CompositeBlockDevice;
+
+/**
+ * CompositeBlockDeviceMember class is a single underlying block device of CompositeBlockDevice.
+ *
+ * Operations on this type of member are executed by the thread which uses CompositeBlockDevice, one member after
+ * another. StaticCompositeBlockDeviceMember has a helper thread, so operations on such members are executed
+ * concurrently.
+ *
+ * \ingroup devices
+ */
+
+class CompositeBlockDeviceMember
+{
+	friend class CompositeBlockDevice;
+
+public:
+
+	/**
+	 * \brief CompositeBlockDeviceMember's constructor
+	 *
+	 * \param [in] device is a reference to underlying block device
+	 */
+
+	constexpr explicit CompositeBlockDeviceMember(BlockDevice& device) :
+			CompositeBlockDeviceMember{device, false}
+	{
+
+	}
+
+	/**
+	 * \brief CompositeBlockDeviceMember's destructor
+	 */
+
+	virtual ~CompositeBlockDeviceMember();
+
+	CompositeBlockDeviceMember(const CompositeBlockDeviceMember&) = delete;
+	const CompositeBlockDeviceMember& operator=(const CompositeBlockDeviceMember&) = delete;
+
+protected:
+
+	/**
+	 * \brief CompositeBlockDeviceMember's constructor
+	 *
+	 * \param [in] device is a reference to underlying block device
+	 * \param [in] helper selects whether this member has a helper thread (true) or not (false)
+	 */
+
+	constexpr CompositeBlockDeviceMember(BlockDevice& device, const bool helper) :
+			completionSemaphore_{0},
+			requestSemaphore_{0},
+			programBuffer_{},
+			readBuffer_{},
+			address_{},
+			size_{},
+			stop_{},
+			composite_{},
+			device_{device},
+			index_{},
+			ret_{},
+			helper_{helper},
+			operation_{}
+	{
+
+	}
+
+	/**
+	 * \brief Requests helper thread to exit.
+	 *
+	 * Helper thread returns from runHelper() after finishing request which is currently executed (if any). This
+	 * function must not be called when CompositeBlockDevice which contains this member is opened.
+	 */
+
+	void requestHelperExit();
+
+	/**
+	 * \brief Function executed by helper thread.
+	 *
+	 * Waits for requests from CompositeBlockDevice, executes them and signals their completion, until exit is
+	 * requested with requestHelperExit().
+	 *
+	 * \param [in] member is a pointer to member which owns the helper thread
+	 */
+
+	static void runHelper(CompositeBlockDeviceMember* member);
+
+	/**
+	 * \brief Starts helper thread, if this member has one and it was not started yet.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise
+	 */
+
+	virtual int startHelper();
+
+private:
+
+	/// operation executed on member
+	enum class Operation : uint8_t
+	{
+		/// erase
+		erase,
+		/// terminate helper thread
+		exit,
+		/// program
+		program,
+		/// read
+		read,
+		/// synchronize
+		synchronize,
+		/// trim
+		trim,
+	};
+
+	/// semaphore posted by helper thread when the request is executed
+	Semaphore completionSemaphore_;
+
+	/// semaphore posted by CompositeBlockDevice when new request is ready for helper thread
+	Semaphore requestSemaphore_;
+
+	/// buffer with data for program operation
+	const void* programBuffer_;
+
+	/// buffer for data of read operation
+	void* readBuffer_;
+
+	/// address of request in CompositeBlockDevice, bytes
+	uint64_t address_;
+
+	/// size of request, bytes
+	uint64_t size_;
+
+	/// address in CompositeBlockDevice at which execution of request stopped - end of request on success
+	uint64_t stop_;
+
+	/// pointer to CompositeBlockDevice which issued the request
+	CompositeBlockDevice* composite_;
+
+	/// reference to underlying block device
+	BlockDevice& device_;
+
+	/// index of member in CompositeBlockDevice
+	size_t index_;
+
+	/// result of request
+	int ret_;
+
+	/// true if member has a helper thread, false otherwise
+	bool helper_;
+
+	/// operation of request
+	Operation operation_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_MEMORY_COMPOSITEBLOCKDEVICEMEMBER_HPP_
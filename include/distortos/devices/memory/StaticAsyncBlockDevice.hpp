@@ -0,0 +1,102 @@
+/**
+ * \file
+ * \brief StaticAsyncBlockDevice class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_MEMORY_STATICASYNCBLOCKDEVICE_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_MEMORY_STATICASYNCBLOCKDEVICE_HPP_
+
+#include "distortos/devices/memory/AsyncBlockDevice.hpp"
+
+#include "distortos/StaticThread.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/**
+ * \brief StaticAsyncBlockDevice class is an AsyncBlockDevice with its own worker thread, which has automatic storage
+ * for stack.
+ *
+ * The worker thread is started with the first operation and runs until the object is destroyed - destructor terminates
+ * the worker thread and waits for it.
+ *
+ * \tparam StackSize is the size of stack of worker thread, bytes
+ *
+ * \ingroup devices
+ */
+
+template<size_t StackSize>
+class StaticAsyncBlockDevice : public AsyncBlockDevice
+{
+public:
+
+	/**
+	 * \brief StaticAsyncBlockDevice's constructor
+	 *
+	 * \param [in] device is a reference to underlying block device
+	 * \param [in] priority is the priority of worker thread
+	 */
+
+	StaticAsyncBlockDevice(BlockDevice& device, const uint8_t priority) :
+			AsyncBlockDevice{device},
+			workerThread_{priority, &AsyncBlockDevice::runWorker, static_cast<AsyncBlockDevice*>(this)}
+	{
+
+	}
+
+	/**
+	 * \brief StaticAsyncBlockDevice's destructor
+	 *
+	 * Terminates worker thread (if it was started) and waits for it to exit.
+	 *
+	 * \pre No request is pending on this device.
+	 */
+
+	~StaticAsyncBlockDevice() override
+	{
+		if (workerThread_.getState() == ThreadState::created)
+			return;
+
+		requestWorkerExit();
+		workerThread_.join();
+	}
+
+protected:
+
+	/**
+	 * \brief Starts worker thread, if it was not started yet.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by StaticThread::start();
+	 */
+
+	int startWorker() override
+	{
+		if (workerThread_.getState() != ThreadState::created)
+			return 0;
+
+		return workerThread_.start();
+	}
+
+private:
+
+	/// worker thread
+	StaticThread<StackSize, false, 0, 0, void(*)(AsyncBlockDevice*), AsyncBlockDevice*> workerThread_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_MEMORY_STATICASYNCBLOCKDEVICE_HPP_
@@ -0,0 +1,107 @@
+/**
+ * \file
+ * \brief StaticCompositeBlockDeviceMember class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_MEMORY_STATICCOMPOSITEBLOCKDEVICEMEMBER_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_MEMORY_STATICCOMPOSITEBLOCKDEVICEMEMBER_HPP_
+
+#include "distortos/devices/memory/CompositeBlockDeviceMember.hpp"
+
+#include "distortos/StaticThread.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/**
+ * \brief StaticCompositeBlockDeviceMember class is a member of CompositeBlockDevice with its own helper thread, which
+ * has automatic storage for stack.
+ *
+ * Operations on such members are executed by their helper threads concurrently, so members should use separate buses
+ * (e.g. separate SpiMaster objects). The helper thread is started when CompositeBlockDevice is opened for the first
+ * time and runs until the member is destroyed - destructor terminates the helper thread and waits for it, so
+ * CompositeBlockDevice must be closed before any of its members is destroyed. To get any concurrency, its priority must
+ * not be lower than priority of threads which use CompositeBlockDevice.
+ *
+ * \tparam StackSize is the size of stack of helper thread, bytes
+ *
+ * \ingroup devices
+ */
+
+template<size_t StackSize>
+class StaticCompositeBlockDeviceMember : public CompositeBlockDeviceMember
+{
+public:
+
+	/**
+	 * \brief StaticCompositeBlockDeviceMember's constructor
+	 *
+	 * \param [in] device is a reference to underlying block device
+	 * \param [in] priority is the priority of helper thread
+	 */
+
+	StaticCompositeBlockDeviceMember(BlockDevice& device, const uint8_t priority) :
+			CompositeBlockDeviceMember{device, true},
+			helperThread_{priority, &CompositeBlockDeviceMember::runHelper,
+					static_cast<CompositeBlockDeviceMember*>(this)}
+	{
+
+	}
+
+	/**
+	 * \brief StaticCompositeBlockDeviceMember's destructor
+	 *
+	 * Terminates helper thread (if it was started) and waits for it to exit.
+	 *
+	 * \pre CompositeBlockDevice which contains this member is closed.
+	 */
+
+	~StaticCompositeBlockDeviceMember() override
+	{
+		if (helperThread_.getState() == ThreadState::created)
+			return;
+
+		requestHelperExit();
+		helperThread_.join();
+	}
+
+protected:
+
+	/**
+	 * \brief Starts helper thread, if it was not started yet.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by StaticThread::start();
+	 */
+
+	int startHelper() override
+	{
+		if (helperThread_.getState() != ThreadState::created)
+			return 0;
+
+		return helperThread_.start();
+	}
+
+private:
+
+	/// helper thread
+	StaticThread<StackSize, false, 0, 0, void(*)(CompositeBlockDeviceMember*), CompositeBlockDeviceMember*>
+			helperThread_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_MEMORY_STATICCOMPOSITEBLOCKDEVICEMEMBER_HPP_
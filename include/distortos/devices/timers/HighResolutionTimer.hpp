@@ -0,0 +1,156 @@
+/**
+ * \file
+ * \brief HighResolutionTimer class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMER_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMER_HPP_
+
+#include "estd/IntrusiveList.hpp"
+
+#include <chrono>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+class HighResolutionTimerService;
+
+/**
+ * HighResolutionTimer class is a software timer with resolution of hardware counter used by associated
+ * HighResolutionTimerService.
+ *
+ * Timer's function is executed from interrupt context of hardware timer. All functions of this class may be used from
+ * interrupt context, including timer's own function.
+ *
+ * \ingroup devices
+ */
+
+class HighResolutionTimer
+{
+	friend class HighResolutionTimerService;
+
+public:
+
+	/// type of timer's function, called from interrupt context
+	using Function = void(*)(HighResolutionTimer& highResolutionTimer);
+
+	/**
+	 * \brief HighResolutionTimer's constructor
+	 *
+	 * \param [in] service is a reference to HighResolutionTimerService which will run this timer
+	 * \param [in] function is the function executed when the timer expires
+	 */
+
+	constexpr HighResolutionTimer(HighResolutionTimerService& service, const Function function) :
+			node_{},
+			service_{service},
+			function_{function},
+			deadline_{},
+			period_{}
+	{
+
+	}
+
+	/**
+	 * \brief HighResolutionTimer's destructor
+	 *
+	 * Stops the timer.
+	 */
+
+	~HighResolutionTimer();
+
+	/**
+	 * \return expiration time point of the timer, counter ticks, valid only if the timer is running
+	 */
+
+	uint64_t getDeadline() const
+	{
+		return deadline_;
+	}
+
+	/**
+	 * \return true if the timer is running, false otherwise
+	 */
+
+	bool isRunning() const
+	{
+		return node_.isLinked();
+	}
+
+	/**
+	 * \brief Starts the timer.
+	 *
+	 * \param [in] delay is the duration after which the timer will expire, rounded up to counter ticks
+	 * \param [in] period is the period used to restart repetitive timer, rounded up to counter ticks, 0 for one-shot
+	 * timer, default - 0
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by startAt();
+	 */
+
+	int start(std::chrono::nanoseconds delay, std::chrono::nanoseconds period = {});
+
+	/**
+	 * \brief Starts the timer.
+	 *
+	 * If the timer is already running, it is restarted with new parameters.
+	 *
+	 * \param [in] deadline is the time point at which the timer will expire, counter ticks - same units as values
+	 * returned by HighResolutionTimerService::getTime()
+	 * \param [in] period is the period used to restart repetitive timer, counter ticks, 0 for one-shot timer, default
+	 * - 0
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - associated HighResolutionTimerService is not started;
+	 */
+
+	int startAt(uint64_t deadline, uint64_t period = {});
+
+	/**
+	 * \brief Stops the timer.
+	 *
+	 * Does nothing if the timer is not running. Repetitive timer may also be stopped from its own function.
+	 */
+
+	void stop();
+
+private:
+
+	/**
+	 * \brief Executes timer's function and restarts repetitive timer.
+	 *
+	 * \note this is called by HighResolutionTimerService from interrupt context
+	 */
+
+	void run();
+
+	/// node for intrusive list of HighResolutionTimerService
+	estd::IntrusiveListNode node_;
+
+	/// reference to HighResolutionTimerService which runs this timer
+	HighResolutionTimerService& service_;
+
+	/// function executed when the timer expires
+	Function function_;
+
+	/// expiration time point, counter ticks
+	uint64_t deadline_;
+
+	/// period used to restart repetitive timer, counter ticks, 0 for one-shot timer
+	uint64_t period_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMER_HPP_
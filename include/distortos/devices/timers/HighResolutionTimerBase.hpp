@@ -0,0 +1,52 @@
+/**
+ * \file
+ * \brief HighResolutionTimerBase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMERBASE_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMERBASE_HPP_
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/**
+ * HighResolutionTimerBase class is an interface with callbacks for low-level high-resolution timer driver, which can
+ * serve as a base for high-level high-resolution timer drivers
+ *
+ * \ingroup devices
+ */
+
+class HighResolutionTimerBase
+{
+public:
+
+	/**
+	 * \brief HighResolutionTimerBase's destructor
+	 */
+
+	virtual ~HighResolutionTimerBase() = 0;
+
+	/**
+	 * \brief "Compare match" event
+	 *
+	 * Called by low-level high-resolution timer driver when the counter reaches the value set with
+	 * HighResolutionTimerLowLevel::setCompare() or after HighResolutionTimerLowLevel::triggerCompareMatch() was called.
+	 */
+
+	virtual void compareMatchEvent() = 0;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMERBASE_HPP_
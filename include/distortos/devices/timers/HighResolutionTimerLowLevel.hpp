@@ -0,0 +1,109 @@
+/**
+ * \file
+ * \brief HighResolutionTimerLowLevel class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMERLOWLEVEL_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMERLOWLEVEL_HPP_
+
+#include <cstdint>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+class HighResolutionTimerBase;
+
+/**
+ * HighResolutionTimerLowLevel class is an interface for low-level high-resolution timer driver - a free-running
+ * hardware counter with one compare channel
+ *
+ * \ingroup devices
+ */
+
+class HighResolutionTimerLowLevel
+{
+public:
+
+	/**
+	 * \brief HighResolutionTimerLowLevel's destructor
+	 */
+
+	virtual ~HighResolutionTimerLowLevel() = 0;
+
+	/**
+	 * \return current value of counter
+	 */
+
+	virtual uint32_t getCounter() const = 0;
+
+	/**
+	 * \return frequency of counter, Hz
+	 */
+
+	virtual uint32_t getFrequency() const = 0;
+
+	/**
+	 * \return maximum value of counter, after which it wraps around to 0, must be equal to 2^n - 1
+	 */
+
+	virtual uint32_t getMaxCounter() const = 0;
+
+	/**
+	 * \brief Sets value of compare channel.
+	 *
+	 * Any pending compare match is cleared. HighResolutionTimerBase::compareMatchEvent() will be executed when the
+	 * counter reaches \a value. If the counter is already past \a value, this will happen only after the counter wraps
+	 * around.
+	 *
+	 * \param [in] value is the new value of compare channel
+	 */
+
+	virtual void setCompare(uint32_t value) = 0;
+
+	/**
+	 * \brief Starts low-level high-resolution timer driver.
+	 *
+	 * Counter is started and compare match interrupt is enabled.
+	 *
+	 * \param [in] highResolutionTimerBase is a reference to HighResolutionTimerBase object that will be associated with
+	 * this one
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not stopped;
+	 */
+
+	virtual int start(HighResolutionTimerBase& highResolutionTimerBase) = 0;
+
+	/**
+	 * \brief Stops low-level high-resolution timer driver.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not started;
+	 */
+
+	virtual int stop() = 0;
+
+	/**
+	 * \brief Triggers compare match by software.
+	 *
+	 * HighResolutionTimerBase::compareMatchEvent() will be executed as soon as possible, regardless of the values of
+	 * counter and compare channel.
+	 */
+
+	virtual void triggerCompareMatch() = 0;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMERLOWLEVEL_HPP_
@@ -0,0 +1,210 @@
+/**
+ * \file
+ * \brief HighResolutionTimerService class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMERSERVICE_HPP_
+#define INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMERSERVICE_HPP_
+
+#include "distortos/devices/timers/HighResolutionTimer.hpp"
+#include "distortos/devices/timers/HighResolutionTimerBase.hpp"
+
+#include "estd/SortedIntrusiveList.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+class HighResolutionTimerLowLevel;
+
+/**
+ * HighResolutionTimerService class multiplexes any number of HighResolutionTimer objects onto single free-running
+ * hardware counter with one compare channel.
+ *
+ * Running timers are kept on a list sorted by expiration time point and the compare channel is always set to the
+ * nearest one. Counter of any width is extended to 64 bits in software - for that purpose the compare channel is also
+ * set to expire at least twice per counter period, even if no timers are running.
+ *
+ * \ingroup devices
+ */
+
+class HighResolutionTimerService : private HighResolutionTimerBase
+{
+	friend class HighResolutionTimer;
+
+public:
+
+	/**
+	 * \brief HighResolutionTimerService's constructor
+	 *
+	 * \param [in] timer is a reference to low-level implementation of HighResolutionTimerLowLevel interface
+	 */
+
+	constexpr explicit HighResolutionTimerService(HighResolutionTimerLowLevel& timer) :
+			list_{},
+			timer_{timer},
+			time_{},
+			lastCounter_{},
+			started_{}
+	{
+
+	}
+
+	/**
+	 * \brief HighResolutionTimerService's destructor
+	 *
+	 * Does nothing if the service is already stopped. If it's not, low-level driver is stopped.
+	 */
+
+	~HighResolutionTimerService() override;
+
+	/**
+	 * \brief Gets current time.
+	 *
+	 * \note This function may be called from interrupt context.
+	 *
+	 * \return current time, counter ticks since first start of the service
+	 */
+
+	uint64_t getTime();
+
+	/**
+	 * \brief Starts the service.
+	 *
+	 * Low-level driver is started and compare channel is set.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the service is already started;
+	 * - error codes returned by HighResolutionTimerLowLevel::start();
+	 */
+
+	int start();
+
+	/**
+	 * \brief Stops the service.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the service is not started;
+	 * - EBUSY - some timers are running;
+	 * - error codes returned by HighResolutionTimerLowLevel::stop();
+	 */
+
+	int stop();
+
+	/**
+	 * \brief Converts duration to counter ticks.
+	 *
+	 * \param [in] duration is the duration that will be converted, negative values are treated as 0
+	 *
+	 * \return \a duration converted to counter ticks, rounded up
+	 */
+
+	uint64_t toTicks(std::chrono::nanoseconds duration) const;
+
+private:
+
+	/// functor which gives ascending expiration time point order of elements on the list
+	struct AscendingDeadline
+	{
+		/**
+		 * \brief AscendingDeadline's constructor
+		 */
+
+		constexpr AscendingDeadline()
+		{
+
+		}
+
+		/**
+		 * \brief AscendingDeadline's function call operator
+		 *
+		 * \param [in] left is the object on the left side of comparison
+		 * \param [in] right is the object on the right side of comparison
+		 *
+		 * \return true if left's expiration time point is greater than right's expiration time point
+		 */
+
+		bool operator()(const HighResolutionTimer& left, const HighResolutionTimer& right) const
+		{
+			return left.getDeadline() > right.getDeadline();
+		}
+	};
+
+	/// sorted intrusive list of running timers
+	using List = estd::SortedIntrusiveList<AscendingDeadline, HighResolutionTimer, &HighResolutionTimer::node_>;
+
+	/**
+	 * \brief Adds timer to the list of running timers.
+	 *
+	 * If the timer becomes the first one on the list, compare channel is set again.
+	 *
+	 * \warning This function must be called with interrupts masked!
+	 *
+	 * \param [in] highResolutionTimer is a reference to timer that will be added, it must not be running
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the service is not started;
+	 */
+
+	int add(HighResolutionTimer& highResolutionTimer);
+
+	/**
+	 * \brief "Compare match" event
+	 *
+	 * Called by low-level high-resolution timer driver when compare channel expires.
+	 *
+	 * Executes all timers that reached their expiration time point and sets compare channel again.
+	 */
+
+	void compareMatchEvent() override;
+
+	/**
+	 * \brief Sets compare channel to the expiration time point of the first running timer.
+	 *
+	 * Compare channel is never set more than half of counter period ahead. If the selected value already passed when
+	 * the compare channel was set, compare match is triggered by software.
+	 *
+	 * \warning This function must be called with interrupts masked!
+	 */
+
+	void program();
+
+	/**
+	 * \brief Updates current time with the value of counter.
+	 *
+	 * \warning This function must be called with interrupts masked!
+	 *
+	 * \return current time, counter ticks since first start of the service
+	 */
+
+	uint64_t updateTime();
+
+	/// list of running timers
+	List list_;
+
+	/// reference to low-level implementation of HighResolutionTimerLowLevel interface
+	HighResolutionTimerLowLevel& timer_;
+
+	/// current time, counter ticks since first start of the service
+	uint64_t time_;
+
+	/// value of counter which corresponds to \a time_
+	uint32_t lastCounter_;
+
+	/// true if the service is started, false otherwise
+	bool started_;
+};
+
+}	// namespace devices
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_DEVICES_TIMERS_HIGHRESOLUTIONTIMERSERVICE_HPP_
@@ -0,0 +1,84 @@
+/**
+ * \file
+ * \brief BoundServerRequestFunctor class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_BOUNDSERVERREQUESTFUNCTOR_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_BOUNDSERVERREQUESTFUNCTOR_HPP_
+
+#include "distortos/internal/FileSystem/ServerRequestFunctor.hpp"
+
+#include <utility>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/**
+ * \brief BoundServerRequestFunctor is a type-erased ServerRequestFunctor which calls its bound functor
+ *
+ * \tparam F is the type of bound functor, it will be called without any arguments
+ */
+
+template<typename F>
+class BoundServerRequestFunctor : public ServerRequestFunctor
+{
+public:
+
+	/**
+	 * \brief BoundServerRequestFunctor's constructor
+	 *
+	 * \param [in] boundFunctor is a rvalue reference to bound functor which will be used to move-construct internal
+	 * bound functor
+	 */
+
+	constexpr explicit BoundServerRequestFunctor(F&& boundFunctor) :
+			boundFunctor_{std::move(boundFunctor)}
+	{
+
+	}
+
+	/**
+	 * \brief Calls the bound functor.
+	 */
+
+	void operator()() const override
+	{
+		boundFunctor_();
+	}
+
+private:
+
+	/// bound functor
+	F boundFunctor_;
+};
+
+/**
+ * \brief Helper factory function to make BoundServerRequestFunctor object with deduced template arguments
+ *
+ * \tparam F is the type of bound functor, it will be called without any arguments
+ *
+ * \param [in] boundFunctor is a rvalue reference to bound functor which will be used to move-construct returned object
+ *
+ * \return BoundServerRequestFunctor object with deduced template arguments
+ */
+
+template<typename F>
+constexpr BoundServerRequestFunctor<F> makeBoundServerRequestFunctor(F&& boundFunctor)
+{
+	return BoundServerRequestFunctor<F>{std::move(boundFunctor)};
+}
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_BOUNDSERVERREQUESTFUNCTOR_HPP_
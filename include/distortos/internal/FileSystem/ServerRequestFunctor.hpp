@@ -0,0 +1,37 @@
+/**
+ * \file
+ * \brief ServerRequestFunctor class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_SERVERREQUESTFUNCTOR_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_SERVERREQUESTFUNCTOR_HPP_
+
+#include "estd/TypeErasedFunctor.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/**
+ * \brief ServerRequestFunctor is a type-erased interface for functors which are passed by clients of ServerFileSystem
+ * to its server thread and executed there.
+ */
+
+class ServerRequestFunctor : public estd::TypeErasedFunctor<void()>
+{
+
+};
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_SERVERREQUESTFUNCTOR_HPP_
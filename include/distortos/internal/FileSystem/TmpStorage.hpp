@@ -0,0 +1,465 @@
+/**
+ * \file
+ * \brief TmpStorage class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_TMPSTORAGE_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_TMPSTORAGE_HPP_
+
+#include <utility>
+
+#include <cstddef>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/// chunk of file contents, followed by its payload
+struct TmpChunk
+{
+	/// pointer to next chunk of the same file, nullptr if this is the last chunk
+	TmpChunk* next;
+};
+
+/// node of TmpFileSystem - file or directory
+struct TmpNode
+{
+	/// pointer to parent directory, nullptr for root directory
+	TmpNode* parent;
+
+	/// pointer to next node in parent directory, nullptr if this is the last node
+	TmpNode* nextSibling;
+
+	/// pointer to first node in this directory, nullptr if directory is empty or if this node is a file
+	TmpNode* firstChild;
+
+	/// pointer to first chunk of this file, nullptr if file has no chunks or if this node is a directory
+	TmpChunk* firstChunk;
+
+	/// pointer to last chunk of this file, nullptr if file has no chunks or if this node is a directory
+	TmpChunk* lastChunk;
+
+	/// null-terminated name of node
+	char* name;
+
+	/// number of chunks of this file
+	size_t chunksCount;
+
+	/// value incremented each time cursors of this node are invalidated - chunks of file are released or list of nodes
+	/// in directory is changed
+	size_t generation;
+
+	/// number of opened files or directories which use this node
+	size_t openedCount;
+
+	/// size of file, bytes
+	size_t size;
+
+	/// true if node is a directory, false if it is a file
+	bool directory;
+};
+
+/// cursor which caches position in the list of chunks of a file or in the list of nodes of a directory
+template<typename T>
+struct TmpCursor
+{
+	/// cached element of list
+	T* element;
+
+	/// index of `element` in the list
+	size_t index;
+
+	/// value of TmpNode::generation for which `element` is valid
+	size_t generation;
+};
+
+/**
+ * TmpStorage class is a tree of files and directories kept in RAM, used by TmpFileSystem.
+ *
+ * Contents of files are stored in fixed-size chunks which are allocated either from provided pool of memory or from the
+ * heap. In both cases the total size of chunks is limited. Nodes with their names are allocated from the heap and are
+ * not included in this limit.
+ *
+ * TmpStorage is not thread-safe - all accesses must be serialized by the user.
+ */
+
+class TmpStorage
+{
+public:
+
+	/**
+	 * \brief TmpStorage's constructor
+	 *
+	 * \param [in] sizeLimit is the max total size of chunks, bytes; if \a pool is nullptr, then 0 means no limit,
+	 * otherwise it is the size of \a pool
+	 * \param [in] chunkSize is the size of single chunk (including its header), bytes, must be a multiple of alignment
+	 * of TmpChunk and larger than its size
+	 * \param [in] pool is a pointer to memory from which chunks are allocated, must be aligned to alignment of
+	 * TmpChunk, nullptr to allocate chunks from the heap
+	 */
+
+	constexpr TmpStorage(const size_t sizeLimit, const size_t chunkSize, void* const pool) :
+			root_{},
+			freeChunks_{},
+			pool_{static_cast<char*>(pool)},
+			chunkSize_{chunkSize},
+			chunksLimit_{},
+			poolUsed_{},
+			sizeLimit_{sizeLimit},
+			usedChunks_{},
+			mounted_{}
+	{
+
+	}
+
+	/**
+	 * \brief TmpStorage's destructor
+	 *
+	 * Releases all nodes and chunks.
+	 */
+
+	~TmpStorage()
+	{
+		unmount();
+	}
+
+	/**
+	 * \brief Creates file or directory.
+	 *
+	 * \param [in] path is the path of file or directory that will be created
+	 * \param [in] directory selects whether directory (true) or file (false) will be created
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and pointer to created node; error codes:
+	 * - EEXIST - named file exists;
+	 * - ENOMEM - unable to allocate memory for node;
+	 * - ENOTDIR - \a path names a file, but ends with '/';
+	 * - error codes returned by lookUp();
+	 */
+
+	std::pair<int, TmpNode*> create(const char* path, bool directory);
+
+	/**
+	 * \brief Finds file or directory.
+	 *
+	 * \param [in] path is the path of file or directory
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and pointer to found node; error codes:
+	 * - ENOENT - no such file or directory;
+	 * - ENOTDIR - \a path names a file, but ends with '/';
+	 * - error codes returned by lookUp();
+	 */
+
+	std::pair<int, TmpNode*> find(const char* path);
+
+	/**
+	 * \brief Returns node from directory.
+	 *
+	 * \param [in] directory is a reference to directory node
+	 * \param [in,out] cursor is a reference to cursor used for \a directory
+	 * \param [in] index is the index of node in \a directory
+	 *
+	 * \return pointer to node with index \a index in \a directory, nullptr if \a index is out of range
+	 */
+
+	TmpNode* getChild(TmpNode& directory, TmpCursor<TmpNode>& cursor, size_t index) const;
+
+	/**
+	 * \return size of single chunk, bytes
+	 */
+
+	size_t getChunkSize() const
+	{
+		return chunkSize_;
+	}
+
+	/**
+	 * \return max number of chunks
+	 */
+
+	size_t getChunksLimit() const
+	{
+		return chunksLimit_;
+	}
+
+	/**
+	 * \return number of allocated chunks
+	 */
+
+	size_t getUsedChunks() const
+	{
+		return usedChunks_;
+	}
+
+	/**
+	 * \return true if storage is mounted, false otherwise
+	 */
+
+	bool isMounted() const
+	{
+		return mounted_;
+	}
+
+	/**
+	 * \brief Validates configuration and mounts empty storage.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - storage is already mounted;
+	 * - EINVAL - configuration passed to constructor is not valid;
+	 */
+
+	int mount();
+
+	/**
+	 * \brief Reads data from file.
+	 *
+	 * \param [in] file is a reference to file node
+	 * \param [in,out] cursor is a reference to cursor used for \a file
+	 * \param [in] position is the position in \a file from which data will be read, bytes
+	 * \param [out] buffer is the buffer into which the data will be read
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return number of read bytes
+	 */
+
+	size_t read(TmpNode& file, TmpCursor<TmpChunk>& cursor, size_t position, void* buffer, size_t size) const;
+
+	/**
+	 * \brief Removes file or directory.
+	 *
+	 * \param [in] path is the path of file or directory that will be removed
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - file or directory named by \a path is opened;
+	 * - EINVAL - \a path names root directory or ends with "." or "..";
+	 * - ENOENT - no such file or directory;
+	 * - ENOTDIR - \a path names a file, but ends with '/';
+	 * - ENOTEMPTY - \a path names a directory which is not empty;
+	 * - error codes returned by lookUp();
+	 */
+
+	int remove(const char* path);
+
+	/**
+	 * \brief Renames file or directory.
+	 *
+	 * \param [in] path is the path of file or directory that will be renamed
+	 * \param [in] newPath is the new path of file or directory
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EEXIST - file or directory named by \a newPath exists;
+	 * - EINVAL - \a path names root directory or ends with "." or "..", \a newPath names a descendant of \a path;
+	 * - ENOENT - no such file or directory;
+	 * - ENOMEM - unable to allocate memory for new name;
+	 * - ENOTDIR - \a path and/or \a newPath name a file, but end with '/';
+	 * - error codes returned by lookUp();
+	 */
+
+	int rename(const char* path, const char* newPath);
+
+	/**
+	 * \brief Releases all chunks of file and sets its size to 0.
+	 *
+	 * \param [in] file is a reference to file node
+	 */
+
+	void truncate(TmpNode& file);
+
+	/**
+	 * \brief Releases all nodes and chunks and unmounts storage.
+	 */
+
+	void unmount();
+
+	/**
+	 * \brief Writes data to file.
+	 *
+	 * If \a position is beyond the end of \a file, the gap is filled with zeroes.
+	 *
+	 * \param [in] file is a reference to file node
+	 * \param [in,out] cursor is a reference to cursor used for \a file
+	 * \param [in] position is the position in \a file at which data will be written, bytes
+	 * \param [in] buffer is the buffer with data that will be written
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of written bytes (valid even when
+	 * error code is returned); error codes:
+	 * - ENOSPC - size limit of storage was reached;
+	 */
+
+	std::pair<int, size_t> write(TmpNode& file, TmpCursor<TmpChunk>& cursor, size_t position, const void* buffer,
+			size_t size);
+
+	TmpStorage(const TmpStorage&) = delete;
+	const TmpStorage& operator=(const TmpStorage&) = delete;
+
+private:
+
+	/// result of lookUp()
+	struct LookUpResult
+	{
+		/// pointer to directory containing last component of path, nullptr if path has no such component
+		TmpNode* parent;
+
+		/// pointer to node named by path, nullptr if last component of path does not exist
+		TmpNode* node;
+
+		/// pointer to last component of path, nullptr if path has no last component which may be created or removed
+		const char* name;
+
+		/// length of `name`, bytes
+		size_t nameLength;
+
+		/// true if path ends with '/', false otherwise
+		bool directoryRequired;
+	};
+
+	/**
+	 * \brief Allocates one chunk.
+	 *
+	 * \return pointer to allocated chunk, nullptr if size limit was reached or memory could not be allocated
+	 */
+
+	TmpChunk* allocateChunk();
+
+	/**
+	 * \brief Releases node with all its chunks and descendants.
+	 *
+	 * \param [in] node is a reference to released node
+	 */
+
+	void destroy(TmpNode& node);
+
+	/**
+	 * \brief Makes sure file has at least given number of chunks.
+	 *
+	 * \param [in] file is a reference to file node
+	 * \param [in] chunksCount is the required number of chunks
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - ENOSPC - size limit of storage was reached;
+	 */
+
+	int extend(TmpNode& file, size_t chunksCount);
+
+	/**
+	 * \brief Returns chunk of file.
+	 *
+	 * \param [in] file is a reference to file node
+	 * \param [in,out] cursor is a reference to cursor used for \a file
+	 * \param [in] index is the index of chunk, must be less than TmpNode::chunksCount of \a file
+	 *
+	 * \return pointer to chunk with index \a index
+	 */
+
+	TmpChunk* getChunk(TmpNode& file, TmpCursor<TmpChunk>& cursor, size_t index) const;
+
+	/**
+	 * \return size of payload of single chunk, bytes
+	 */
+
+	size_t getPayloadSize() const
+	{
+		return chunkSize_ - sizeof(TmpChunk);
+	}
+
+	/**
+	 * \brief Links node into directory.
+	 *
+	 * \param [in] directory is a reference to directory node
+	 * \param [in] node is a reference to linked node
+	 */
+
+	static void link(TmpNode& directory, TmpNode& node);
+
+	/**
+	 * \brief Resolves path.
+	 *
+	 * Empty components of path are ignored, "." and ".." components are supported.
+	 *
+	 * \param [in] path is the resolved path
+	 * \param [out] result is a reference to variable for result of resolution
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - storage is not mounted;
+	 * - EINVAL - \a path is not valid;
+	 * - ENAMETOOLONG - length of component of \a path is longer than allowed maximum;
+	 * - ENOENT - prefix component of \a path does not name an existing directory;
+	 * - ENOTDIR - prefix component of \a path names an existing file;
+	 */
+
+	int lookUp(const char* path, LookUpResult& result);
+
+	/**
+	 * \brief Copies data to file, allocating chunks when needed.
+	 *
+	 * \param [in] file is a reference to file node
+	 * \param [in,out] cursor is a reference to cursor used for \a file
+	 * \param [in] position is the position in \a file at which data will be written, must not be greater than
+	 * TmpNode::size of \a file, bytes
+	 * \param [in] buffer is the buffer with data that will be written, nullptr to write zeroes
+	 * \param [in] size is the size of data that will be written, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of written bytes; error codes:
+	 * - error codes returned by extend();
+	 */
+
+	std::pair<int, size_t> program(TmpNode& file, TmpCursor<TmpChunk>& cursor, size_t position, const char* buffer,
+			size_t size);
+
+	/**
+	 * \brief Releases one chunk.
+	 *
+	 * \param [in] chunk is a pointer to released chunk
+	 */
+
+	void releaseChunk(TmpChunk* chunk);
+
+	/**
+	 * \brief Unlinks node from its parent directory.
+	 *
+	 * \param [in] node is a reference to unlinked node
+	 */
+
+	static void unlink(TmpNode& node);
+
+	/// root directory
+	TmpNode root_;
+
+	/// list of released chunks which can be reused
+	TmpChunk* freeChunks_;
+
+	/// pointer to memory from which chunks are allocated, nullptr if chunks are allocated from the heap
+	char* pool_;
+
+	/// size of single chunk (including its header), bytes
+	size_t chunkSize_;
+
+	/// max number of chunks
+	size_t chunksLimit_;
+
+	/// size of part of `pool_` that was already used for chunks, bytes
+	size_t poolUsed_;
+
+	/// max total size of chunks, bytes; if `pool_` is nullptr, then 0 means no limit, otherwise it is the size of pool
+	size_t sizeLimit_;
+
+	/// number of allocated chunks
+	size_t usedChunks_;
+
+	/// true if storage is mounted, false otherwise
+	bool mounted_;
+};
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_TMPSTORAGE_HPP_
@@ -0,0 +1,224 @@
+/**
+ * \file
+ * \brief XipImage class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_XIPIMAGE_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_XIPIMAGE_HPP_
+
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/**
+ * XipImage class is a parser of read-only, memory-mapped image generated by scripts/packXipImage.py.
+ *
+ * Layout of the image (all fields are little-endian):
+ * - header - magic "XIP1", CRC-32 of metadata following this field, size of image, size of metadata (header, entries
+ * and paths) and number of entries;
+ * - table of entries - one for each file and directory, sorted by full path, with '/' ordered before all other
+ * characters - this way all descendants of each directory directly follow it in the table;
+ * - null-terminated full paths of entries, without leading '/';
+ * - contents of files, each aligned to value selected during generation of the image.
+ *
+ * The image is validated once in mount(), so that all later accesses can trust it. Lookup of a path is a binary search
+ * in the table of entries, contents of files are accessed in place.
+ */
+
+class XipImage
+{
+public:
+
+	/// entry of file or directory
+	struct Entry
+	{
+		/// offset of null-terminated full path of entry, bytes
+		uint32_t pathOffset;
+
+		/// offset of file contents, bytes (ignored for directories)
+		uint32_t dataOffset;
+
+		/// size of file, bytes, or number of entries which are descendants of directory
+		uint32_t size;
+
+		/// length of full path of entry, bytes
+		uint16_t pathLength;
+
+		/// type of entry - fileType or directoryType
+		uint8_t type;
+
+		/// reserved, always 0
+		uint8_t reserved;
+	};
+
+	/// type of entry which is a file
+	constexpr static uint8_t fileType {1};
+
+	/// type of entry which is a directory
+	constexpr static uint8_t directoryType {2};
+
+	/**
+	 * \brief XipImage's constructor
+	 */
+
+	constexpr XipImage() :
+			rootEntry_{},
+			entries_{},
+			image_{},
+			imageSize_{}
+	{
+
+	}
+
+	/**
+	 * \brief Finds entry of file or directory.
+	 *
+	 * Leading and trailing '/' characters in \a path are ignored, empty path names root directory.
+	 *
+	 * \pre Image is mounted.
+	 *
+	 * \param [in] path is the path of file or directory
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and pointer to found entry; error codes:
+	 * - EINVAL - \a path is not valid;
+	 * - ENAMETOOLONG - length of \a path is longer than allowed maximum;
+	 * - ENOENT - no such file or directory;
+	 * - ENOTDIR - component of \a path names an existing file where directory was expected;
+	 */
+
+	std::pair<int, const Entry*> find(const char* path) const;
+
+	/**
+	 * \pre Image is mounted.
+	 *
+	 * \param [in] entry is a reference to file entry
+	 *
+	 * \return pointer to contents of file
+	 */
+
+	const uint8_t* getData(const Entry& entry) const
+	{
+		return static_cast<const uint8_t*>(image_) + entry.dataOffset;
+	}
+
+	/**
+	 * \pre Image is mounted.
+	 *
+	 * \param [in] entry is a reference to directory entry
+	 *
+	 * \return pair with pointers to first entry in \a entry directory and one past last entry which is its descendant
+	 */
+
+	std::pair<const Entry*, const Entry*> getDescendants(const Entry& entry) const
+	{
+		const auto first = &entry == &rootEntry_ ? entries_ : &entry + 1;
+		return {first, first + entry.size};
+	}
+
+	/**
+	 * \return number of entries in mounted image, 0 if image is not mounted
+	 */
+
+	size_t getEntriesCount() const
+	{
+		return rootEntry_.size;
+	}
+
+	/**
+	 * \return size of image, bytes, 0 if image is not mounted
+	 */
+
+	size_t getImageSize() const
+	{
+		return imageSize_;
+	}
+
+	/**
+	 * \pre Image is mounted.
+	 *
+	 * \param [in] entry is a reference to entry
+	 *
+	 * \return null-terminated name of \a entry - last component of its full path
+	 */
+
+	const char* getName(const Entry& entry) const;
+
+	/**
+	 * \return true if image is mounted, false otherwise
+	 */
+
+	bool isMounted() const
+	{
+		return image_ != nullptr;
+	}
+
+	/**
+	 * \brief Validates image and mounts it.
+	 *
+	 * \param [in] image is a pointer to image, must be aligned to 4
+	 * \param [in] size is the size of memory area with \a image, bytes
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - image is already mounted;
+	 * - EILSEQ - \a image is not a valid image;
+	 * - EINVAL - \a image is nullptr or is not aligned to 4;
+	 */
+
+	int mount(const void* image, size_t size);
+
+	/**
+	 * \brief Unmounts image.
+	 */
+
+	void unmount()
+	{
+		rootEntry_ = {};
+		entries_ = {};
+		image_ = {};
+		imageSize_ = {};
+	}
+
+private:
+
+	/**
+	 * \brief Looks up entry with given full path in the table of entries.
+	 *
+	 * \param [in] path is the full path, without leading and trailing '/'
+	 * \param [in] length is the length of \a path, bytes
+	 *
+	 * \return pointer to found entry, nullptr if no entry has full path equal to \a path
+	 */
+
+	const Entry* lookUp(const char* path, size_t length) const;
+
+	/// entry of root directory
+	Entry rootEntry_;
+
+	/// pointer to table of entries
+	const Entry* entries_;
+
+	/// pointer to mounted image, nullptr if no image is mounted
+	const void* image_;
+
+	/// size of mounted image, bytes
+	size_t imageSize_;
+};
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_FILESYSTEM_XIPIMAGE_HPP_
@@ -0,0 +1,183 @@
+/**
+ * \file
+ * \brief ThreadCache class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_MEMORY_THREADCACHE_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_MEMORY_THREADCACHE_HPP_
+
+#include "distortos/distortosConfiguration.h"
+
+#if CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+
+#include <cstddef>
+#include <cstdint>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions' declarations
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Locks backing heap for the time of transfer of a batch of blocks between ThreadCache and heap.
+ *
+ * Lock must be recursive - malloc() and free() called while it is held lock the heap on their own.
+ */
+
+void lockBackingHeap();
+
+/**
+ * \brief Unlocks backing heap locked with lockBackingHeap().
+ */
+
+void unlockBackingHeap();
+
+/**
+ * \brief ThreadCache class is a front end of heap which keeps free blocks of several size classes for exclusive use by
+ * single thread.
+ *
+ * Each block is obtained from backing heap (malloc()) with a small header which holds its size class, so it can be
+ * deallocated without any information about its size. Allocations and deallocations of blocks which fit one of size
+ * classes are served from per-class lists of free blocks without locking. Only when the list is empty, a batch of
+ * blocks is allocated from backing heap, and only when the list grows above two batches, a batch of blocks is returned
+ * to backing heap - in both cases backing heap is locked once for the whole batch. Larger blocks are always allocated
+ * directly from backing heap.
+ *
+ * Object of this class must be used by single thread only, it must not be used from interrupt context. Free blocks
+ * are not returned to backing heap automatically - flush() must be called before the object is destroyed.
+ */
+
+class ThreadCache
+{
+public:
+
+	/// number of size classes
+	constexpr static size_t sizeClassesCount {10};
+
+	/// size of the largest block which is served from lists of free blocks, bytes
+	constexpr static size_t maxCachedSize {256};
+
+	/// number of blocks transferred between cache and backing heap in one batch
+	constexpr static size_t batchSize {CONFIG_THREAD_CACHING_ALLOCATOR_BATCH_SIZE};
+
+	/**
+	 * \brief ThreadCache's constructor
+	 */
+
+	constexpr ThreadCache() :
+			freeLists_{}
+	{
+
+	}
+
+	/**
+	 * \brief Allocates block of memory.
+	 *
+	 * \param [in] size is the size of block, bytes
+	 *
+	 * \return pointer to allocated block, aligned to alignof(std::max_align_t), nullptr if allocation failed
+	 */
+
+	void* allocate(size_t size);
+
+	/**
+	 * \brief Deallocates block of memory.
+	 *
+	 * Block may be deallocated by any ThreadCache object, not only by the one which allocated it.
+	 *
+	 * \param [in] block is a pointer to block allocated with allocate() of any ThreadCache object, nullptr is ignored
+	 */
+
+	void deallocate(void* block);
+
+	/**
+	 * \brief Returns all free blocks to backing heap.
+	 */
+
+	void flush();
+
+	/**
+	 * \param [in] sizeClass is the index of size class, [0; sizeClassesCount)
+	 *
+	 * \return number of free blocks of \a sizeClass kept in the cache
+	 */
+
+	size_t getFreeBlocksCount(const size_t sizeClass) const
+	{
+		return freeLists_[sizeClass].count;
+	}
+
+	/**
+	 * \param [in] size is the size of block, bytes
+	 *
+	 * \return index of the smallest size class which can hold block of \a size bytes, sizeClassesCount if \a size is
+	 * larger than maxCachedSize
+	 */
+
+	static size_t getSizeClass(size_t size);
+
+	ThreadCache(const ThreadCache&) = delete;
+	ThreadCache(ThreadCache&&) = delete;
+	const ThreadCache& operator=(const ThreadCache&) = delete;
+	ThreadCache& operator=(ThreadCache&&) = delete;
+
+private:
+
+	/// node of list of free blocks, placed in the block itself
+	struct FreeBlock
+	{
+		/// pointer to next free block, nullptr if this is the last one
+		FreeBlock* next;
+	};
+
+	/// list of free blocks of single size class
+	struct FreeList
+	{
+		/// pointer to first free block, nullptr if list is empty
+		FreeBlock* head;
+
+		/// number of blocks on the list
+		size_t count;
+	};
+
+	/**
+	 * \brief Allocates a batch of blocks of given size class from backing heap and adds them to list of free blocks.
+	 *
+	 * \param [in] sizeClass is the index of size class, [0; sizeClassesCount)
+	 *
+	 * \return number of blocks added to list of free blocks
+	 */
+
+	size_t refill(size_t sizeClass);
+
+	/**
+	 * \brief Returns blocks from list of free blocks of given size class to backing heap.
+	 *
+	 * \param [in] sizeClass is the index of size class, [0; sizeClassesCount)
+	 * \param [in] count is the number of blocks that will be returned
+	 */
+
+	void release(size_t sizeClass, size_t count);
+
+	/// lists of free blocks, one for each size class
+	FreeList freeLists_[sizeClassesCount];
+};
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_MEMORY_THREADCACHE_HPP_
@@ -0,0 +1,196 @@
+/**
+ * \file
+ * \brief PerformanceMonitorFrameWriter class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_MONITOR_PERFORMANCEMONITORFRAMEWRITER_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_MONITOR_PERFORMANCEMONITORFRAMEWRITER_HPP_
+
+#include "distortos/internal/storage/updateCrc32.hpp"
+
+#include <algorithm>
+
+#include <cstring>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/**
+ * PerformanceMonitorFrameWriter class is used to assemble and transmit single frame of PerformanceMonitor.
+ *
+ * Format of frames is described in documentation of PerformanceMonitor class.
+ *
+ * \tparam Output is the type of object used for transmission of frame, it must have `write(const void*, size_t)`
+ * member function - e.g. devices::SerialPort
+ */
+
+template<typename Output>
+class PerformanceMonitorFrameWriter
+{
+public:
+
+	/**
+	 * \brief PerformanceMonitorFrameWriter's constructor
+	 *
+	 * Transmits header of frame.
+	 *
+	 * \param [in] output is a reference to object used for transmission of frame
+	 * \param [in] type is the type of frame
+	 * \param [in] payloadSize is the size of payload, bytes
+	 */
+
+	PerformanceMonitorFrameWriter(Output& output, const uint8_t type, const size_t payloadSize) :
+			buffer_{},
+			output_{output},
+			crc_{},
+			used_{}
+	{
+		// magic is transmitted directly, as it is not covered by CRC-32 of frame
+		const uint8_t magic[] {'P', 'M'};
+		output_.write(magic, sizeof(magic));
+		writeU8(type);
+		writeU16(payloadSize);
+	}
+
+	/**
+	 * \brief Transmits CRC-32 of frame.
+	 */
+
+	void finish()
+	{
+		flush();
+		const auto crc = crc_;
+		writeU32(crc);
+		flush();
+	}
+
+	/**
+	 * \brief Writes name - uint8_t length followed by up to 255 characters.
+	 *
+	 * \param [in] name is the name that will be written, nullptr is treated as empty string
+	 */
+
+	void writeName(const char* const name)
+	{
+		const auto length = getNameLength(name);
+		writeU8(length);
+		write(name, length);
+	}
+
+	/**
+	 * \brief Writes uint8_t value.
+	 *
+	 * \param [in] value is the value that will be written
+	 */
+
+	void writeU8(const uint8_t value)
+	{
+		write(&value, sizeof(value));
+	}
+
+	/**
+	 * \brief Writes uint16_t value.
+	 *
+	 * \param [in] value is the value that will be written
+	 */
+
+	void writeU16(const uint16_t value)
+	{
+		const uint8_t bytes[] {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8)};
+		write(bytes, sizeof(bytes));
+	}
+
+	/**
+	 * \brief Writes uint32_t value.
+	 *
+	 * \param [in] value is the value that will be written
+	 */
+
+	void writeU32(const uint32_t value)
+	{
+		const uint8_t bytes[]
+		{
+				static_cast<uint8_t>(value),
+				static_cast<uint8_t>(value >> 8),
+				static_cast<uint8_t>(value >> 16),
+				static_cast<uint8_t>(value >> 24),
+		};
+		write(bytes, sizeof(bytes));
+	}
+
+	/**
+	 * \param [in] name is the name, nullptr is treated as empty string
+	 *
+	 * \return length of \a name which is written to frame
+	 */
+
+	static uint8_t getNameLength(const char* const name)
+	{
+		return name != nullptr ? strnlen(name, UINT8_MAX) : 0;
+	}
+
+private:
+
+	/**
+	 * \brief Transmits data collected in buffer and updates CRC-32 of frame.
+	 */
+
+	void flush()
+	{
+		if (used_ == 0)
+			return;
+
+		crc_ = updateCrc32(crc_, buffer_, used_);
+		output_.write(buffer_, used_);
+		used_ = {};
+	}
+
+	/**
+	 * \brief Writes data to buffer, transmitting it when it is full.
+	 *
+	 * \param [in] data is a pointer to data that will be written
+	 * \param [in] size is the size of \a data, bytes
+	 */
+
+	void write(const void* const data, size_t size)
+	{
+		auto input = static_cast<const uint8_t*>(data);
+		while (size != 0)
+		{
+			const auto chunk = std::min(size, sizeof(buffer_) - used_);
+			memcpy(buffer_ + used_, input, chunk);
+			used_ += chunk;
+			input += chunk;
+			size -= chunk;
+			if (used_ == sizeof(buffer_))
+				flush();
+		}
+	}
+
+	/// buffer for data of frame
+	uint8_t buffer_[64];
+
+	/// reference to object used for transmission of frame
+	Output& output_;
+
+	/// CRC-32 of data transmitted after magic
+	uint32_t crc_;
+
+	/// number of bytes collected in buffer
+	size_t used_;
+};
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_MONITOR_PERFORMANCEMONITORFRAMEWRITER_HPP_
@@ -0,0 +1,43 @@
+/**
+ * \file
+ * \brief Header of heap accounting
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_NEWLIB_HEAPACCOUNTING_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_NEWLIB_HEAPACCOUNTING_HPP_
+
+#include "distortos/distortosConfiguration.h"
+
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions' declarations
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Recursively locks Mutex used for malloc() and free() locking.
+ *
+ * If the mutex is owned by another thread, contention is charged to current thread before it blocks.
+ */
+
+void lockMallocMutex();
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_NEWLIB_HEAPACCOUNTING_HPP_
@@ -266,6 +266,18 @@ public:
 
 	void unblock(ThreadList::iterator iterator, UnblockReason unblockReason = UnblockReason::unblockRequest);
 
+	/**
+	 * \brief Unblocks all threads from provided container, transferring them to "runnable" container.
+	 *
+	 * All threads are unblocked in one pass with interrupts masked, context switch is requested (if required) only
+	 * once at the end.
+	 *
+	 * \param [in] container is a reference to container with blocked threads
+	 * \param [in] unblockReason is the reason of unblocking of the threads, default - UnblockReason::unblockRequest
+	 */
+
+	void unblockAll(ThreadList& container, UnblockReason unblockReason = UnblockReason::unblockRequest);
+
 	/**
 	 * \brief Yields time slot of the scheduler to next thread.
 	 */
@@ -81,6 +81,16 @@ public:
 
 	uint8_t getEffectivePriority() const override;
 
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+	/**
+	 * \return heap usage statistics of the thread
+	 */
+
+	HeapStatistics getHeapStatistics() const override;
+
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
 	/**
 	 * \return identifier of thread, default-constructed ThreadIdentifier if this object doesn't represent a valid
 	 * thread of execution (e.g. after the thread is detached)
@@ -112,6 +122,13 @@ public:
 
 	uint8_t getPriority() const override;
 
+	/**
+	 * \return number of system ticks during which the thread was running - it is the thread which was current when
+	 * the tick interrupt occurred, so the value is a statistical approximation of consumed CPU time
+	 */
+
+	uint64_t getRunTickCount() const override;
+
 	/**
 	 * \return scheduling policy of the thread
 	 */
@@ -2,7 +2,7 @@
  * \file
  * \brief ThreadControlBlock class header
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -12,6 +12,8 @@
 #ifndef INCLUDE_DISTORTOS_INTERNAL_SCHEDULER_THREADCONTROLBLOCK_HPP_
 #define INCLUDE_DISTORTOS_INTERNAL_SCHEDULER_THREADCONTROLBLOCK_HPP_
 
+#include "distortos/internal/memory/ThreadCache.hpp"
+
 #include "distortos/internal/scheduler/RoundRobinQuantum.hpp"
 #include "distortos/internal/scheduler/Stack.hpp"
 #include "distortos/internal/scheduler/ThreadListNode.hpp"
@@ -19,6 +21,7 @@
 
 #include "distortos/internal/synchronization/MutexList.hpp"
 
+#include "distortos/HeapStatistics.hpp"
 #include "distortos/SchedulingPolicy.hpp"
 #include "distortos/ThreadState.hpp"
 
@@ -91,6 +94,28 @@ public:
 		unblockFunctor_ = unblockFunctor;
 	}
 
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+	/**
+	 * \return reference to heap usage statistics of the thread
+	 */
+
+	HeapStatistics& getHeapStatistics()
+	{
+		return heapStatistics_;
+	}
+
+	/**
+	 * \return const reference to heap usage statistics of the thread
+	 */
+
+	const HeapStatistics& getHeapStatistics() const
+	{
+		return heapStatistics_;
+	}
+
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
 	/**
 	 * \return pointer to list that has this object
 	 */
@@ -118,6 +143,16 @@ public:
 		return owner_;
 	}
 
+	/**
+	 * \return number of units requested by the thread blocked on Semaphore, valid only while the thread is blocked on
+	 * Semaphore
+	 */
+
+	unsigned int getRequestedSemaphoreUnits() const
+	{
+		return requestedSemaphoreUnits_;
+	}
+
 	/**
 	 * \return reference to internal RoundRobinQuantum object
 	 */
@@ -127,6 +162,15 @@ public:
 		return roundRobinQuantum_;
 	}
 
+	/**
+	 * \return number of system ticks during which the thread was running
+	 */
+
+	uint64_t getRunTickCount() const
+	{
+		return runTickCount_;
+	}
+
 	/**
 	 * \return scheduling policy of the thread
 	 */
@@ -186,6 +230,30 @@ public:
 		return state_;
 	}
 
+#if CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+
+	/**
+	 * \return reference to cache of free blocks of the thread, used by global operator new and operator delete
+	 */
+
+	ThreadCache& getThreadCache()
+	{
+		return threadCache_;
+	}
+
+#endif	// CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+
+	/**
+	 * \brief Increments number of system ticks during which the thread was running.
+	 *
+	 * \note This function should be called only from tick interrupt handler, for current thread.
+	 */
+
+	void incrementRunTickCount()
+	{
+		++runTickCount_;
+	}
+
 	/**
 	 * \brief Sets the list that has this object.
 	 *
@@ -220,6 +288,16 @@ public:
 		priorityInheritanceMutexControlBlock_ = priorityInheritanceMutexControlBlock;
 	}
 
+	/**
+	 * \param [in] requestedSemaphoreUnits is the number of units requested by the thread which is going to be blocked on
+	 * Semaphore
+	 */
+
+	void setRequestedSemaphoreUnits(const unsigned int requestedSemaphoreUnits)
+	{
+		requestedSemaphoreUnits_ = requestedSemaphoreUnits;
+	}
+
 	/**
 	 * param [in] schedulingPolicy is the new scheduling policy of the thread
 	 */
@@ -313,9 +391,29 @@ private:
 	/// pointer to MutexControlBlock (with priorityInheritance protocol) that blocks this thread
 	const MutexControlBlock* priorityInheritanceMutexControlBlock_;
 
+	/// number of units requested by the thread blocked on Semaphore
+	unsigned int requestedSemaphoreUnits_;
+
 	/// sequence number, one half of thread identifier
 	uintptr_t sequenceNumber_;
 
+	/// number of system ticks during which the thread was running
+	uint64_t runTickCount_;
+
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+	/// heap usage statistics of the thread
+	HeapStatistics heapStatistics_;
+
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+#if CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+
+	/// cache of free blocks of the thread
+	ThreadCache threadCache_;
+
+#endif	// CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+
 #if CONFIG_SIGNALS_ENABLE == 1
 
 	/// pointer to SignalsReceiverControlBlock object for this thread, nullptr if this thread cannot receive signals
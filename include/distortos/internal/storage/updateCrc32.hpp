@@ -0,0 +1,62 @@
+/**
+ * \file
+ * \brief updateCrc32() and updateCrc32Software() declarations
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_STORAGE_UPDATECRC32_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_STORAGE_UPDATECRC32_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions' declarations
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Updates CRC-32 (as used by Ethernet, zlib, PNG, ...) with data.
+ *
+ * This is the CRC-32 facility used by storage engines and file systems. The implementation is selected during
+ * configuration - by default it is updateCrc32Software(), but chip may provide a backend which uses hardware CRC unit.
+ * All implementations give identical results.
+ *
+ * \param [in] crc is the CRC-32 of preceding data, 0 for first chunk
+ * \param [in] buffer is the buffer with data
+ * \param [in] size is the size of \a buffer, bytes
+ *
+ * \return CRC-32 of preceding data and \a buffer
+ */
+
+uint32_t updateCrc32(uint32_t crc, const void* buffer, size_t size);
+
+/**
+ * \brief Updates CRC-32 (as used by Ethernet, zlib, PNG, ...) with data, software implementation.
+ *
+ * Table-driven slice-by-4 algorithm, which processes 4 bytes per iteration using 4 kB of lookup tables.
+ *
+ * \param [in] crc is the CRC-32 of preceding data, 0 for first chunk
+ * \param [in] buffer is the buffer with data
+ * \param [in] size is the size of \a buffer, bytes
+ *
+ * \return CRC-32 of preceding data and \a buffer
+ */
+
+uint32_t updateCrc32Software(uint32_t crc, const void* buffer, size_t size);
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_STORAGE_UPDATECRC32_HPP_
@@ -2,7 +2,7 @@
  * \file
  * \brief FifoQueueBase class header
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -12,12 +12,15 @@
 #ifndef INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_FIFOQUEUEBASE_HPP_
 #define INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_FIFOQUEUEBASE_HPP_
 
+#include "distortos/QueueProducer.hpp"
 #include "distortos/Semaphore.hpp"
+#include "distortos/TickClock.hpp"
 
 #include "distortos/internal/synchronization/QueueFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreFunctor.hpp"
 
 #include <memory>
+#include <utility>
 
 namespace distortos
 {
@@ -50,6 +53,15 @@ public:
 
 	~FifoQueueBase();
 
+	/**
+	 * \return max number of elements in queue
+	 */
+
+	size_t getCapacity() const
+	{
+		return pushSemaphore_.getMaxValue();
+	}
+
 	/**
 	 * \return size of single queue element, bytes
 	 */
@@ -59,6 +71,52 @@ public:
 		return elementSize_;
 	}
 
+	/**
+	 * \return current number of elements in queue
+	 */
+
+	size_t getSize() const
+	{
+		return popSemaphore_.getValue();
+	}
+
+	/**
+	 * \brief Pushes the element to the queue, overwriting the oldest (first) element if the queue is full.
+	 *
+	 * This function never blocks, so it may be called from interrupt context. The newest element is never dropped -
+	 * the oldest element is overwritten even if it was already assigned to a consumer which was unblocked, but didn't
+	 * run yet (that consumer will get the next element). This function must not be mixed with blocking push functions
+	 * on the same queue.
+	 *
+	 * \param [in] dropFunctor is a reference to QueueFunctor which will destroy the oldest element if the queue is
+	 * full - it will get readPosition_ as argument
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get
+	 * writePosition_ as argument
+	 * \param [in,out] overflowCount is a reference to counter of overwritten elements, incremented (with interrupts
+	 * masked) each time the oldest element is dropped
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - EAGAIN - capacity of the queue is 0;
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int overwritingPush(const QueueFunctor& dropFunctor, const QueueFunctor& functor, size_t& overflowCount);
+
+	/**
+	 * \brief Pops the oldest (first) element from the queue.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get
+	 * readPosition_ as argument
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::wait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int pop(const QueueFunctor& functor);
+
 	/**
 	 * \brief Implementation of pop() using type-erased functor
 	 *
@@ -66,15 +124,51 @@ public:
 	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get
 	 * readPosition_ as argument
 	 *
+	 * If any producer is registered and the calling thread is about to block, registered producers inherit its
+	 * priority. Boosted priority of registered producers is recalculated after the operation.
+	 *
 	 * \return 0 if element was popped successfully, error code otherwise:
 	 * - error codes returned by \a waitSemaphoreFunctor's operator() call;
 	 * - error codes returned by Semaphore::post();
 	 */
 
-	int pop(const SemaphoreFunctor& waitSemaphoreFunctor, const QueueFunctor& functor)
-	{
-		return popPush(waitSemaphoreFunctor, functor, popSemaphore_, pushSemaphore_, readPosition_);
-	}
+	int pop(const SemaphoreFunctor& waitSemaphoreFunctor, const QueueFunctor& functor);
+
+	/**
+	 * \brief Pops several oldest elements from the queue.
+	 *
+	 * Waits for the first element with \a waitSemaphoreFunctor, then pops all other available elements (up to
+	 * \a maxElements) without waiting. Whole batch is popped with interrupts masked.
+	 *
+	 * \param [in] waitSemaphoreFunctor is a reference to SemaphoreFunctor which will be executed with \a popSemaphore_
+	 * for the first element
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get
+	 * readPosition_ as argument, once for each popped element
+	 * \param [in] maxElements is the max number of elements that will be popped
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of popped elements; error codes:
+	 * - EINVAL - \a maxElements is 0;
+	 * - error codes returned by \a waitSemaphoreFunctor's operator() call;
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	std::pair<int, size_t> popBatch(const SemaphoreFunctor& waitSemaphoreFunctor, const QueueFunctor& functor,
+			size_t maxElements);
+
+	/**
+	 * \brief Pushes the element to the queue.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get
+	 * writePosition_ as argument
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by Semaphore::wait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int push(const QueueFunctor& functor);
 
 	/**
 	 * \brief Implementation of push() using type-erased functor
@@ -83,18 +177,152 @@ public:
 	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get
 	 * writePosition_ as argument
 	 *
+	 * If any producer is registered, its boosted priority is recalculated after the operation.
+	 *
 	 * \return 0 if element was pushed successfully, error code otherwise:
 	 * - error codes returned by \a waitSemaphoreFunctor's operator() call;
 	 * - error codes returned by Semaphore::post();
 	 */
 
-	int push(const SemaphoreFunctor& waitSemaphoreFunctor, const QueueFunctor& functor)
-	{
-		return popPush(waitSemaphoreFunctor, functor, pushSemaphore_, popSemaphore_, writePosition_);
-	}
+	int push(const SemaphoreFunctor& waitSemaphoreFunctor, const QueueFunctor& functor);
+
+	/**
+	 * \brief Registers current thread as a producer of the queue.
+	 *
+	 * While \a queueProducer is registered, current thread inherits the priority of the highest priority thread blocked
+	 * on "pop" functions of the queue.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] queueProducer is a reference to QueueProducer object which will be registered
+	 *
+	 * \return 0 if \a queueProducer was registered successfully, error code otherwise:
+	 * - EBUSY - \a queueProducer is already registered;
+	 */
+
+	int registerProducer(QueueProducer& queueProducer);
+
+	/**
+	 * \brief Tries to pops the oldest (first) element from the queue.
+	 *
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get
+	 * readPosition_ as argument
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPop(const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to pops the oldest (first) element from the queue for a given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the call will be terminated without popping the element
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get
+	 * readPosition_ as argument
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitFor();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPopFor(TickClock::duration duration, const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to pops the oldest (first) element from the queue until a given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the call will be terminated without popping the element
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get
+	 * readPosition_ as argument
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitUntil();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPopUntil(TickClock::time_point timePoint, const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to pushes the element to the queue.
+	 *
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get
+	 * writePosition_ as argument
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPush(const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to pushes the element to the queue for a given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the call will be terminated without pushing the element
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get
+	 * writePosition_ as argument
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitFor();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPushFor(TickClock::duration duration, const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to pushes the element to the queue until a given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the call will be terminated without pushing the element
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get
+	 * writePosition_ as argument
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitUntil();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPushUntil(TickClock::time_point timePoint, const QueueFunctor& functor);
+
+	/**
+	 * \brief Unregisters producer of the queue.
+	 *
+	 * Priority of the thread which registered \a queueProducer is no longer boosted by consumers of the queue.
+	 *
+	 * \param [in] queueProducer is a reference to QueueProducer object which will be unregistered
+	 *
+	 * \return 0 if \a queueProducer was unregistered successfully, error code otherwise:
+	 * - EINVAL - \a queueProducer is not registered in this queue;
+	 */
+
+	int unregisterProducer(QueueProducer& queueProducer);
 
 private:
 
+	/// intrusive list of QueueProducer objects
+	using QueueProducerList = estd::IntrusiveList<QueueProducer, &QueueProducer::producerListNode>;
+
+	/**
+	 * \brief Moves position to the next element of storage, wrapping around at the end of storage.
+	 *
+	 * \param [in,out] position is a reference to position in storage, readPosition_ or writePosition_
+	 */
+
+	void incrementPosition(void*& position) const
+	{
+		position = static_cast<uint8_t*>(position) + elementSize_;
+		if (position >= storageEnd_)
+			position = storageUniquePointer_.get();
+	}
+
 	/**
 	 * \brief Implementation of pop() and push() using type-erased functor
 	 *
@@ -116,6 +344,23 @@ private:
 	int popPush(const SemaphoreFunctor& waitSemaphoreFunctor, const QueueFunctor& functor, Semaphore& waitSemaphore,
 			Semaphore& postSemaphore, void*& storage);
 
+	/**
+	 * \brief Updates boosted priority of all registered producers.
+	 *
+	 * Producers inherit the effective priority of the first thread blocked on \a popSemaphore_ (if any) or \a priority,
+	 * whichever is higher. Context switch is requested if the current thread is no longer the highest priority runnable
+	 * thread.
+	 *
+	 * \attention this function must be called with interrupts masked
+	 *
+	 * \param [in] priority is the additional priority which should be inherited by producers, default - 0
+	 */
+
+	void updateProducersPriority(uint8_t priority = {});
+
+	/// list of registered producers
+	QueueProducerList producerList_;
+
 	/// semaphore guarding access to "pop" functions - its value is equal to the number of available elements
 	Semaphore popSemaphore_;
 
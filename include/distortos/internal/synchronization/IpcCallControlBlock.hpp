@@ -0,0 +1,135 @@
+/**
+ * \file
+ * \brief IpcCallControlBlock class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_IPCCALLCONTROLBLOCK_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_IPCCALLCONTROLBLOCK_HPP_
+
+#include "distortos/internal/synchronization/MutexControlBlock.hpp"
+
+#include "distortos/IpcMessage.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/**
+ * \brief IpcCallControlBlock class is a control block of a single call made through IpcEndpoint
+ *
+ * The object lives on the stack of the client for the whole duration of the call. Once the call is received, the
+ * server becomes the "owner" of this object, which is handled exactly like a mutex with priorityInheritance protocol -
+ * the client is blocked on it, so its effective priority is donated to the server until the call is replied.
+ */
+
+class IpcCallControlBlock : public MutexControlBlock
+{
+public:
+
+	/**
+	 * \brief IpcCallControlBlock's constructor
+	 *
+	 * \param [in] message is a reference to client's message, it holds the request before the call is received and
+	 * the reply after the call is finished
+	 */
+
+	constexpr explicit IpcCallControlBlock(IpcMessage& message) :
+			MutexControlBlock{Type::normal, Protocol::priorityInheritance, {}},
+			callListNode{},
+			message_{message}
+	{
+
+	}
+
+	/**
+	 * \brief Accepts the call on behalf of the server.
+	 *
+	 * Server becomes the owner of the call. If the client is already blocked on the call, its effective priority is
+	 * immediately donated to the server.
+	 *
+	 * \param [in] server is a reference to ThreadControlBlock of server thread which received the call
+	 */
+
+	void accept(ThreadControlBlock& server);
+
+	/**
+	 * \brief Abandons the call, detaching it from the server (if any).
+	 *
+	 * \attention This function should be called only when the client stopped waiting for the call to finish.
+	 */
+
+	void abandon();
+
+	/**
+	 * \brief Blocks current (client) thread on the call.
+	 *
+	 * \param [in] timePoint is a pointer to time point at which the wait will be terminated, nullptr to wait
+	 * indefinitely
+	 *
+	 * \return 0 if the call was replied, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - the call was not replied before the specified timeout expired;
+	 */
+
+	int block(const TickClock::time_point* timePoint);
+
+	/**
+	 * \brief Finishes the call - copies the reply to client's message and unblocks the client.
+	 *
+	 * Boosted priority of the server is recalculated without the contribution of the client.
+	 *
+	 * \attention This function must be called by the server which accepted the call.
+	 *
+	 * \param [in] message is a reference to reply message
+	 */
+
+	void finish(const IpcMessage& message);
+
+	/**
+	 * \return pointer to ThreadControlBlock of client blocked on the call, nullptr if client is not blocked
+	 */
+
+	ThreadControlBlock* getClient()
+	{
+		return getBlockedList().empty() == false ? &getBlockedList().front() : nullptr;
+	}
+
+	/**
+	 * \return reference to client's message
+	 */
+
+	IpcMessage& getMessage() const
+	{
+		return message_;
+	}
+
+	/// node for intrusive list of calls in IpcEndpoint
+	estd::IntrusiveListNode callListNode;
+
+	IpcCallControlBlock(const IpcCallControlBlock&) = delete;
+	IpcCallControlBlock(IpcCallControlBlock&&) = delete;
+	const IpcCallControlBlock& operator=(const IpcCallControlBlock&) = delete;
+	IpcCallControlBlock& operator=(IpcCallControlBlock&&) = delete;
+
+private:
+
+	/// reference to client's message
+	IpcMessage& message_;
+};
+
+/// intrusive list of calls (IPC call control blocks)
+using IpcCallList = estd::IntrusiveList<IpcCallControlBlock, &IpcCallControlBlock::callListNode>;
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_IPCCALLCONTROLBLOCK_HPP_
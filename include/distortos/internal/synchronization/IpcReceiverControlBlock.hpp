@@ -0,0 +1,109 @@
+/**
+ * \file
+ * \brief IpcReceiverControlBlock class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_IPCRECEIVERCONTROLBLOCK_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_IPCRECEIVERCONTROLBLOCK_HPP_
+
+#include "distortos/internal/scheduler/ThreadList.hpp"
+
+#include "distortos/IpcMessage.hpp"
+#include "distortos/TickClock.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/**
+ * \brief IpcReceiverControlBlock class is a control block of server thread waiting for a call in IpcEndpoint
+ *
+ * The object lives on the stack of the server while it is blocked. Client which finds a waiting server copies its
+ * message directly to server's buffer and unblocks it, so no intermediate copy is required.
+ */
+
+class IpcReceiverControlBlock
+{
+public:
+
+	/**
+	 * \brief IpcReceiverControlBlock's constructor
+	 *
+	 * \param [out] message is a reference to server's message, to which the request will be written
+	 */
+
+	constexpr explicit IpcReceiverControlBlock(IpcMessage& message) :
+			receiverListNode{},
+			blockedList_{},
+			message_{message}
+	{
+
+	}
+
+	/**
+	 * \brief Blocks current (server) thread until a call is delivered.
+	 *
+	 * \param [in] timePoint is a pointer to time point at which the wait will be terminated, nullptr to wait
+	 * indefinitely
+	 *
+	 * \return 0 if a call was delivered, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - no call was delivered before the specified timeout expired;
+	 */
+
+	int block(const TickClock::time_point* timePoint);
+
+	/**
+	 * \brief Delivers the request to the server and unblocks it.
+	 *
+	 * \attention Server must be blocked on this object.
+	 *
+	 * \param [in] message is a reference to request message
+	 */
+
+	void deliver(const IpcMessage& message);
+
+	/**
+	 * \return reference to ThreadControlBlock of server blocked on this object
+	 *
+	 * \attention Server must be blocked on this object.
+	 */
+
+	ThreadControlBlock& getServer()
+	{
+		return blockedList_.front();
+	}
+
+	/// node for intrusive list of receivers in IpcEndpoint
+	estd::IntrusiveListNode receiverListNode;
+
+	IpcReceiverControlBlock(const IpcReceiverControlBlock&) = delete;
+	IpcReceiverControlBlock(IpcReceiverControlBlock&&) = delete;
+	const IpcReceiverControlBlock& operator=(const IpcReceiverControlBlock&) = delete;
+	IpcReceiverControlBlock& operator=(IpcReceiverControlBlock&&) = delete;
+
+private:
+
+	/// server's ThreadControlBlock blocked on this object
+	ThreadList blockedList_;
+
+	/// reference to server's message
+	IpcMessage& message_;
+};
+
+/// intrusive list of receivers (IPC receiver control blocks)
+using IpcReceiverList = estd::IntrusiveList<IpcReceiverControlBlock, &IpcReceiverControlBlock::receiverListNode>;
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_IPCRECEIVERCONTROLBLOCK_HPP_
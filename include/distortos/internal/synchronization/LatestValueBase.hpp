@@ -0,0 +1,114 @@
+/**
+ * \file
+ * \brief LatestValueBase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_LATESTVALUEBASE_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_LATESTVALUEBASE_HPP_
+
+#include "distortos/internal/synchronization/UpdateNotifier.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/// LatestValueBase class implements basic functionality of LatestValue template class
+class LatestValueBase
+{
+public:
+
+	/// type of sequence number
+	using Sequence = UpdateNotifier::Sequence;
+
+	/**
+	 * \brief LatestValueBase's constructor
+	 */
+
+	constexpr LatestValueBase() :
+			updateNotifier_{}
+	{
+
+	}
+
+	/**
+	 * \return current sequence number, incremented by 2 with each write
+	 */
+
+	Sequence getSequence() const
+	{
+		return updateNotifier_.getSequence();
+	}
+
+	/**
+	 * \brief Reads consistent copy of value.
+	 *
+	 * Copy is retried until no write was done during the copy.
+	 *
+	 * \param [out] buffer is a pointer to buffer to which the value will be copied
+	 * \param [in] storage is a pointer to storage of value
+	 * \param [in] size is the size of value, bytes
+	 *
+	 * \return sequence number of copied value
+	 */
+
+	Sequence read(void* buffer, const void* storage, size_t size) const;
+
+	/**
+	 * \brief Wrapper for UpdateNotifier::tryWaitFor()
+	 */
+
+	int tryWaitFor(const TickClock::duration duration, const Sequence sequence)
+	{
+		return updateNotifier_.tryWaitFor(duration, sequence);
+	}
+
+	/**
+	 * \brief Wrapper for UpdateNotifier::tryWaitUntil()
+	 */
+
+	int tryWaitUntil(const TickClock::time_point timePoint, const Sequence sequence)
+	{
+		return updateNotifier_.tryWaitUntil(timePoint, sequence);
+	}
+
+	/**
+	 * \brief Wrapper for UpdateNotifier::wait()
+	 */
+
+	int wait(const Sequence sequence)
+	{
+		return updateNotifier_.wait(sequence);
+	}
+
+	/**
+	 * \brief Writes new value and unblocks all threads waiting for it.
+	 *
+	 * Sequence number is odd while the write is in progress. Whole write is done with interrupts masked, so it never
+	 * waits and concurrent writes are serialized.
+	 *
+	 * \param [out] storage is a pointer to storage of value
+	 * \param [in] data is a pointer to new value
+	 * \param [in] size is the size of value, bytes
+	 */
+
+	void write(void* storage, const void* data, size_t size);
+
+private:
+
+	/// sequence counter and list of threads waiting for new value
+	UpdateNotifier updateNotifier_;
+};
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_LATESTVALUEBASE_HPP_
@@ -2,7 +2,7 @@
  * \file
  * \brief MessageQueueBase class header
  *
- * \author Copyright (C) 2015-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2015-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -13,6 +13,7 @@
 #define INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_MESSAGEQUEUEBASE_HPP_
 
 #include "distortos/Semaphore.hpp"
+#include "distortos/TickClock.hpp"
 
 #include "distortos/internal/synchronization/QueueFunctor.hpp"
 #include "distortos/internal/synchronization/SemaphoreFunctor.hpp"
@@ -144,6 +145,40 @@ public:
 
 	~MessageQueueBase();
 
+	/**
+	 * \return max number of elements in queue
+	 */
+
+	size_t getCapacity() const
+	{
+		return pushSemaphore_.getMaxValue();
+	}
+
+	/**
+	 * \return current number of elements in queue
+	 */
+
+	size_t getSize() const
+	{
+		return popSemaphore_.getValue();
+	}
+
+	/**
+	 * \brief Pops oldest element with highest priority from the queue.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [out] priority is a reference to variable that will be used to return priority of popped value
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get a
+	 * pointer to storage with element
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::wait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int pop(uint8_t& priority, const QueueFunctor& functor);
+
 	/**
 	 * \brief Implementation of pop() using type-erased functor
 	 *
@@ -159,6 +194,22 @@ public:
 
 	int pop(const SemaphoreFunctor& waitSemaphoreFunctor, uint8_t& priority, const QueueFunctor& functor);
 
+	/**
+	 * \brief Pushes the element to the queue.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] priority is the priority of new element
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get a
+	 * pointer to storage for element
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by Semaphore::wait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int push(uint8_t priority, const QueueFunctor& functor);
+
 	/**
 	 * \brief Implementation of push() using type-erased functor
 	 *
@@ -174,6 +225,102 @@ public:
 
 	int push(const SemaphoreFunctor& waitSemaphoreFunctor, uint8_t priority, const QueueFunctor& functor);
 
+	/**
+	 * \brief Tries to pop oldest element with highest priority from the queue.
+	 *
+	 * \param [out] priority is a reference to variable that will be used to return priority of popped value
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get a
+	 * pointer to storage with element
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPop(uint8_t& priority, const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to pop oldest element with highest priority from the queue for a given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the call will be terminated without popping the element
+	 * \param [out] priority is a reference to variable that will be used to return priority of popped value
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get a
+	 * pointer to storage with element
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitFor();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPopFor(TickClock::duration duration, uint8_t& priority, const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to pop oldest element with highest priority from the queue until a given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the call will be terminated without popping the element
+	 * \param [out] priority is a reference to variable that will be used to return priority of popped value
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to popping - it will get a
+	 * pointer to storage with element
+	 *
+	 * \return 0 if element was popped successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitUntil();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPopUntil(TickClock::time_point timePoint, uint8_t& priority, const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to push the element to the queue.
+	 *
+	 * \param [in] priority is the priority of new element
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get a
+	 * pointer to storage for element
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWait();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPush(uint8_t priority, const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to push the element to the queue for a given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the call will be terminated without pushing the element
+	 * \param [in] priority is the priority of new element
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get a
+	 * pointer to storage for element
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitFor();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPushFor(TickClock::duration duration, uint8_t priority, const QueueFunctor& functor);
+
+	/**
+	 * \brief Tries to push the element to the queue until a given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the call will be terminated without pushing the element
+	 * \param [in] priority is the priority of new element
+	 * \param [in] functor is a reference to QueueFunctor which will execute actions related to pushing - it will get a
+	 * pointer to storage for element
+	 *
+	 * \return 0 if element was pushed successfully, error code otherwise:
+	 * - error codes returned by Semaphore::tryWaitUntil();
+	 * - error codes returned by Semaphore::post();
+	 */
+
+	int tryPushUntil(TickClock::time_point timePoint, uint8_t priority, const QueueFunctor& functor);
+
 private:
 
 	/**
@@ -2,7 +2,7 @@
  * \file
  * \brief MutexControlBlock class header
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -127,6 +127,16 @@ protected:
 
 	void doLock();
 
+	/**
+	 * \brief Performs actual locking of previously unlocked mutex on behalf of given thread.
+	 *
+	 * \attention mutex must be unlocked
+	 *
+	 * \param [in] owner is a reference to ThreadControlBlock of thread which will become the owner of the mutex
+	 */
+
+	void doLock(ThreadControlBlock& owner);
+
 	/**
 	 * \brief Performs unlocking or transfer of lock from current owner to next thread on the list.
 	 *
@@ -137,6 +147,15 @@ protected:
 
 	void doUnlockOrTransferLock();
 
+	/**
+	 * \return reference to list of ThreadControlBlock objects blocked on mutex
+	 */
+
+	ThreadList& getBlockedList()
+	{
+		return blockedList_;
+	}
+
 	/**
 	 * \return priority ceiling of mutex, valid only when protocol_ == Protocol::priorityProtect
 	 */
@@ -173,6 +192,17 @@ protected:
 		return static_cast<Type>((typeProtocol_ >> typeShift) & ((1 << typeWidth) - 1));
 	}
 
+	/**
+	 * \brief Changes priority ceiling of mutex and updates boosted priority of current owner (if any).
+	 *
+	 * \attention this function should be called with interrupts masked and only when protocol_ ==
+	 * Protocol::priorityProtect
+	 *
+	 * \param [in] priorityCeiling is the new priority ceiling of mutex
+	 */
+
+	void setPriorityCeiling(uint8_t priorityCeiling);
+
 private:
 
 	/**
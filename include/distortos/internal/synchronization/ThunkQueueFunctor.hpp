@@ -0,0 +1,237 @@
+/**
+ * \file
+ * \brief ThunkQueueFunctor class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_THUNKQUEUEFUNCTOR_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_THUNKQUEUEFUNCTOR_HPP_
+
+#include "distortos/internal/synchronization/QueueFunctor.hpp"
+
+#include <new>
+#include <utility>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/**
+ * \brief ThunkQueueFunctor is a QueueFunctor which calls a plain function with pointer to queue's storage and pointer
+ * to user's object.
+ *
+ * Unlike functors templated on the type of element, this class is not a template, so its virtual function and vtable
+ * are emitted only once. The only code generated for each type of element are the thunks - copyConstructThunk(),
+ * destroyThunk(), moveConstructThunk(), swapPopBatchThunk() and swapPopThunk().
+ */
+
+class ThunkQueueFunctor : public QueueFunctor
+{
+public:
+
+	/// type of thunk - first argument is a pointer to queue's storage, second one is a pointer to user's object
+	using Thunk = void(void*, void*);
+
+	/**
+	 * \brief ThunkQueueFunctor's constructor
+	 *
+	 * \param [in] thunk is a reference to thunk which will be called with queue's storage and \a object
+	 * \param [in] object is a pointer to user's object which will be passed to \a thunk
+	 */
+
+	constexpr ThunkQueueFunctor(Thunk& thunk, void* const object) :
+			object_{object},
+			thunk_{thunk}
+	{
+
+	}
+
+	/**
+	 * \brief Calls the thunk which will execute some action on queue's storage and user's object.
+	 *
+	 * \param [in,out] storage is a pointer to storage with/for element
+	 */
+
+	void operator()(void* storage) const override;
+
+private:
+
+	/// pointer to user's object which will be passed to \a thunk_
+	void* object_;
+
+	/// reference to thunk
+	Thunk& thunk_;
+};
+
+/**
+ * \brief Copy-constructs the element in the queue's storage.
+ *
+ * \tparam T is the type of element
+ *
+ * \param [in,out] storage is a pointer to storage for element
+ * \param [in] object is a pointer to object of type T that will be used as argument of copy constructor
+ */
+
+template<typename T>
+void copyConstructThunk(void* const storage, void* const object)
+{
+	new (storage) T{*static_cast<const T*>(object)};
+}
+
+/**
+ * \brief Destroys the element in the queue's storage.
+ *
+ * \tparam T is the type of element
+ *
+ * \param [in,out] storage is a pointer to storage with element
+ */
+
+template<typename T>
+void destroyThunk(void* const storage, void*)
+{
+	static_cast<T*>(storage)->~T();
+}
+
+/**
+ * \brief Move-constructs the element in the queue's storage.
+ *
+ * \tparam T is the type of element
+ *
+ * \param [in,out] storage is a pointer to storage for element
+ * \param [in] object is a pointer to object of type T that will be used as argument of move constructor
+ */
+
+template<typename T>
+void moveConstructThunk(void* const storage, void* const object)
+{
+	new (storage) T{std::move(*static_cast<T*>(object))};
+}
+
+/**
+ * \brief Swaps the element in the queue's storage with user's object and destroys the element when no longer needed.
+ *
+ * \tparam T is the type of element
+ *
+ * \param [in,out] storage is a pointer to storage with element
+ * \param [out] object is a pointer to object of type T that will be used to return popped value
+ */
+
+template<typename T>
+void swapPopThunk(void* const storage, void* const object)
+{
+	auto& swappedValue = *static_cast<T*>(storage);
+	using std::swap;
+	swap(*static_cast<T*>(object), swappedValue);
+	swappedValue.~T();
+}
+
+/**
+ * \brief Pops the element from the queue's storage to the next object of array using swap.
+ *
+ * \tparam T is the type of element
+ *
+ * \param [in,out] storage is a pointer to storage with element
+ * \param [in,out] object is a pointer to pointer to object of type T that will be used to return popped value, the
+ * pointer is incremented after each call
+ */
+
+template<typename T>
+void swapPopBatchThunk(void* const storage, void* const object)
+{
+	auto& position = *static_cast<T**>(object);
+	swapPopThunk<T>(storage, position);
+	++position;
+}
+
+/**
+ * \brief Helper factory function to make ThunkQueueFunctor which copy-constructs the element in the queue's storage
+ *
+ * \tparam T is the type of element
+ *
+ * \param [in] value is a reference to object that will be used as argument of copy constructor
+ *
+ * \return ThunkQueueFunctor object bound to \a value and copyConstructThunk<T>()
+ */
+
+template<typename T>
+constexpr ThunkQueueFunctor makeCopyConstructQueueFunctor(const T& value)
+{
+	return ThunkQueueFunctor{copyConstructThunk<T>, const_cast<T*>(&value)};
+}
+
+/**
+ * \brief Helper factory function to make ThunkQueueFunctor which destroys the element in the queue's storage
+ *
+ * \tparam T is the type of element
+ *
+ * \return ThunkQueueFunctor object bound to destroyThunk<T>()
+ */
+
+template<typename T>
+constexpr ThunkQueueFunctor makeDestroyQueueFunctor()
+{
+	return ThunkQueueFunctor{destroyThunk<T>, nullptr};
+}
+
+/**
+ * \brief Helper factory function to make ThunkQueueFunctor which move-constructs the element in the queue's storage
+ *
+ * \tparam T is the type of element
+ *
+ * \param [in] value is a reference to object that will be used as argument of move constructor
+ *
+ * \return ThunkQueueFunctor object bound to \a value and moveConstructThunk<T>()
+ */
+
+template<typename T>
+constexpr ThunkQueueFunctor makeMoveConstructQueueFunctor(T& value)
+{
+	return ThunkQueueFunctor{moveConstructThunk<T>, &value};
+}
+
+/**
+ * \brief Helper factory function to make ThunkQueueFunctor which pops elements from the queue's storage to consecutive
+ * objects of array using swap
+ *
+ * \tparam T is the type of element
+ *
+ * \param [in,out] position is a reference to pointer to next object of array that will be used to return popped
+ * value, the pointer is incremented after each call of the functor
+ *
+ * \return ThunkQueueFunctor object bound to \a position and swapPopBatchThunk<T>()
+ */
+
+template<typename T>
+constexpr ThunkQueueFunctor makeSwapPopBatchQueueFunctor(T*& position)
+{
+	return ThunkQueueFunctor{swapPopBatchThunk<T>, &position};
+}
+
+/**
+ * \brief Helper factory function to make ThunkQueueFunctor which pops the element from the queue's storage using swap
+ *
+ * \tparam T is the type of element
+ *
+ * \param [out] value is a reference to object that will be used to return popped value
+ *
+ * \return ThunkQueueFunctor object bound to \a value and swapPopThunk<T>()
+ */
+
+template<typename T>
+constexpr ThunkQueueFunctor makeSwapPopQueueFunctor(T& value)
+{
+	return ThunkQueueFunctor{swapPopThunk<T>, &value};
+}
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_THUNKQUEUEFUNCTOR_HPP_
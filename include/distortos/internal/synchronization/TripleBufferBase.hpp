@@ -0,0 +1,140 @@
+/**
+ * \file
+ * \brief TripleBufferBase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_TRIPLEBUFFERBASE_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_TRIPLEBUFFERBASE_HPP_
+
+#include "distortos/internal/synchronization/UpdateNotifier.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/**
+ * \brief TripleBufferBase class implements basic functionality of TripleBuffer template class
+ *
+ * Only indexes of buffers are managed here - "back" buffer is owned by producer, "front" buffer is owned by consumer
+ * and "middle" buffer holds the latest published frame which was not yet taken by consumer.
+ */
+
+class TripleBufferBase
+{
+public:
+
+	/**
+	 * \brief TripleBufferBase's constructor
+	 */
+
+	constexpr TripleBufferBase() :
+			updateNotifier_{},
+			readSequence_{},
+			backIndex_{0},
+			frontIndex_{1},
+			middleIndex_{2}
+	{
+
+	}
+
+	/**
+	 * \return index of "back" buffer, owned by producer
+	 */
+
+	uint8_t getBackIndex() const
+	{
+		return backIndex_;
+	}
+
+	/**
+	 * \return index of "front" buffer, owned by consumer
+	 */
+
+	uint8_t getFrontIndex() const
+	{
+		return frontIndex_;
+	}
+
+	/**
+	 * \brief Publishes "back" buffer.
+	 *
+	 * "Back" and "middle" buffers are exchanged and all threads waiting for new frame are unblocked.
+	 */
+
+	void publish();
+
+	/**
+	 * \brief Tries to wait for new frame for a given duration of time and takes it if it is available.
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 *
+	 * \return 0 if new frame was taken, error code otherwise:
+	 * - error codes returned by UpdateNotifier::tryWaitFor();
+	 */
+
+	int tryWaitFor(TickClock::duration duration);
+
+	/**
+	 * \brief Tries to wait for new frame until a given time point and takes it if it is available.
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 *
+	 * \return 0 if new frame was taken, error code otherwise:
+	 * - error codes returned by UpdateNotifier::tryWaitUntil();
+	 */
+
+	int tryWaitUntil(TickClock::time_point timePoint);
+
+	/**
+	 * \brief Takes new frame if it is available.
+	 *
+	 * If a frame was published since last call, "front" and "middle" buffers are exchanged.
+	 *
+	 * \return true if new frame was taken, false otherwise
+	 */
+
+	bool update();
+
+	/**
+	 * \brief Waits for new frame and takes it.
+	 *
+	 * \return 0 if new frame was taken, error code otherwise:
+	 * - error codes returned by UpdateNotifier::wait();
+	 */
+
+	int wait();
+
+	TripleBufferBase(const TripleBufferBase&) = delete;
+	const TripleBufferBase& operator=(const TripleBufferBase&) = delete;
+
+private:
+
+	/// sequence counter (incremented by each publish()) and list of threads waiting for new frame
+	UpdateNotifier updateNotifier_;
+
+	/// value of sequence counter when the frame in "front" buffer was taken
+	UpdateNotifier::Sequence readSequence_;
+
+	/// index of "back" buffer
+	uint8_t backIndex_;
+
+	/// index of "front" buffer
+	uint8_t frontIndex_;
+
+	/// index of "middle" buffer
+	uint8_t middleIndex_;
+};
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_TRIPLEBUFFERBASE_HPP_
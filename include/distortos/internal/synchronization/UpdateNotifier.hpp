@@ -0,0 +1,136 @@
+/**
+ * \file
+ * \brief UpdateNotifier class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_UPDATENOTIFIER_HPP_
+#define INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_UPDATENOTIFIER_HPP_
+
+#include "distortos/internal/scheduler/ThreadList.hpp"
+
+#include "distortos/TickClock.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/**
+ * \brief UpdateNotifier class is a sequence counter with a list of threads waiting for its change.
+ *
+ * It is used by LatestValue and TripleBuffer to let threads block until a new value is available.
+ */
+
+class UpdateNotifier
+{
+public:
+
+	/// type of sequence counter
+	using Sequence = uint32_t;
+
+	/**
+	 * \brief UpdateNotifier's constructor
+	 */
+
+	constexpr UpdateNotifier() :
+			blockedList_{},
+			sequence_{}
+	{
+
+	}
+
+	/**
+	 * \return current value of sequence counter
+	 */
+
+	Sequence getSequence() const
+	{
+		return sequence_;
+	}
+
+	/**
+	 * \brief Increments sequence counter.
+	 *
+	 * \warning This function must be called with interrupts masked!
+	 */
+
+	void increment()
+	{
+		sequence_ = sequence_ + 1;
+	}
+
+	/**
+	 * \brief Unblocks all threads waiting for change of sequence counter.
+	 *
+	 * \warning This function must be called with interrupts masked!
+	 */
+
+	void notifyAll();
+
+	/**
+	 * \brief Tries to wait until sequence counter is different than given value, for a given duration of time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] duration is the duration after which the wait will be terminated
+	 * \param [in] sequence is the value of sequence counter which is considered "old"
+	 *
+	 * \return 0 if sequence counter is different than \a sequence, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - sequence counter was not changed before the specified timeout expired;
+	 */
+
+	int tryWaitFor(TickClock::duration duration, Sequence sequence);
+
+	/**
+	 * \brief Tries to wait until sequence counter is different than given value, until a given time point.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] timePoint is the time point at which the wait will be terminated
+	 * \param [in] sequence is the value of sequence counter which is considered "old"
+	 *
+	 * \return 0 if sequence counter is different than \a sequence, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 * - ETIMEDOUT - sequence counter was not changed before the specified timeout expired;
+	 */
+
+	int tryWaitUntil(TickClock::time_point timePoint, Sequence sequence);
+
+	/**
+	 * \brief Waits until sequence counter is different than given value.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] sequence is the value of sequence counter which is considered "old"
+	 *
+	 * \return 0 if sequence counter is different than \a sequence, error code otherwise:
+	 * - EINTR - the wait was interrupted by an unmasked, caught signal;
+	 */
+
+	int wait(Sequence sequence);
+
+	UpdateNotifier(const UpdateNotifier&) = delete;
+	const UpdateNotifier& operator=(const UpdateNotifier&) = delete;
+
+private:
+
+	/// ThreadControlBlock objects blocked on this object
+	ThreadList blockedList_;
+
+	/// sequence counter, incremented on each update
+	volatile Sequence sequence_;
+};
+
+}	// namespace internal
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_INTERNAL_SYNCHRONIZATION_UPDATENOTIFIER_HPP_
@@ -0,0 +1,124 @@
+/**
+ * \file
+ * \brief MonitoredQueue class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_MONITOR_MONITOREDQUEUE_HPP_
+#define INCLUDE_DISTORTOS_MONITOR_MONITOREDQUEUE_HPP_
+
+#include <cstddef>
+
+namespace distortos
+{
+
+/**
+ * MonitoredQueue class is a registration of queue in PerformanceMonitor.
+ *
+ * Any queue with getCapacity() and getSize() member functions - FifoQueue, MessageQueue, RawFifoQueue,
+ * RawMessageQueue and their static and dynamic variants - can be registered.
+ *
+ * \ingroup statistics
+ */
+
+class MonitoredQueue
+{
+public:
+
+	/**
+	 * \brief MonitoredQueue's constructor
+	 *
+	 * \tparam Queue is the type of monitored queue
+	 *
+	 * \param [in] name is the name of queue, displayed by the viewer, only first 255 characters are used
+	 * \param [in] queue is a reference to monitored queue
+	 */
+
+	template<typename Queue>
+	constexpr MonitoredQueue(const char* const name, const Queue& queue) :
+			name_{name},
+			queue_{&queue},
+			getCapacityFunction_{getCapacity<Queue>},
+			getSizeFunction_{getSize<Queue>}
+	{
+
+	}
+
+	/**
+	 * \return maximum number of elements in queue
+	 */
+
+	size_t getCapacity() const
+	{
+		return getCapacityFunction_(queue_);
+	}
+
+	/**
+	 * \return name of queue
+	 */
+
+	const char* getName() const
+	{
+		return name_;
+	}
+
+	/**
+	 * \return current number of elements in queue
+	 */
+
+	size_t getSize() const
+	{
+		return getSizeFunction_(queue_);
+	}
+
+private:
+
+	/**
+	 * \tparam Queue is the type of monitored queue
+	 *
+	 * \param [in] queue is a pointer to monitored queue
+	 *
+	 * \return maximum number of elements in \a queue
+	 */
+
+	template<typename Queue>
+	static size_t getCapacity(const void* const queue)
+	{
+		return static_cast<const Queue*>(queue)->getCapacity();
+	}
+
+	/**
+	 * \tparam Queue is the type of monitored queue
+	 *
+	 * \param [in] queue is a pointer to monitored queue
+	 *
+	 * \return current number of elements in \a queue
+	 */
+
+	template<typename Queue>
+	static size_t getSize(const void* const queue)
+	{
+		return static_cast<const Queue*>(queue)->getSize();
+	}
+
+	/// name of queue
+	const char* name_;
+
+	/// pointer to monitored queue
+	const void* queue_;
+
+	/// pointer to function which returns maximum number of elements in queue
+	size_t (* getCapacityFunction_)(const void*);
+
+	/// pointer to function which returns current number of elements in queue
+	size_t (* getSizeFunction_)(const void*);
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_MONITOR_MONITOREDQUEUE_HPP_
@@ -0,0 +1,39 @@
+/**
+ * \file
+ * \brief MonitoredThread struct header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_MONITOR_MONITOREDTHREAD_HPP_
+#define INCLUDE_DISTORTOS_MONITOR_MONITOREDTHREAD_HPP_
+
+namespace distortos
+{
+
+class Thread;
+
+/**
+ * MonitoredThread struct is a registration of thread in PerformanceMonitor.
+ *
+ * Threads in distortos have no names, so the name which is displayed by the viewer is provided here.
+ *
+ * \ingroup statistics
+ */
+
+struct MonitoredThread
+{
+	/// name of thread, displayed by the viewer, only first 255 characters are used
+	const char* name;
+
+	/// reference to monitored thread
+	const Thread& thread;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_MONITOR_MONITOREDTHREAD_HPP_
@@ -0,0 +1,154 @@
+/**
+ * \file
+ * \brief PerformanceMonitor class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_MONITOR_PERFORMANCEMONITOR_HPP_
+#define INCLUDE_DISTORTOS_MONITOR_PERFORMANCEMONITOR_HPP_
+
+#include "distortos/monitor/MonitoredQueue.hpp"
+#include "distortos/monitor/MonitoredThread.hpp"
+
+#include "distortos/TickClock.hpp"
+
+#include "estd/ContiguousRange.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+class SerialPort;
+
+}	// namespace devices
+
+/**
+ * PerformanceMonitor class periodically collects runtime statistics and streams them over SerialPort.
+ *
+ * Each sample contains tick count, context switch count, heap usage, run tick count (CPU share), state, priorities and
+ * stack high water mark of each registered thread and current number of elements in each registered queue. Frames with
+ * names and static properties of registered objects are sent before the first sample and then periodically, so the
+ * viewer (scripts/performanceMonitor.py) may be attached at any time.
+ *
+ * Collection is done by a dedicated thread (see StaticPerformanceMonitor), which should have the lowest priority above
+ * idle thread. Interrupts are masked only for the duration of reading individual values.
+ *
+ * Every frame has following format (all values are little-endian):
+ * - magic - 'P', 'M';
+ * - uint8_t type - 1 for description frame, 2 for sample frame;
+ * - uint16_t size of payload, bytes;
+ * - payload;
+ * - uint32_t CRC-32 of type, size and payload;
+ *
+ * Payload of description frame:
+ * - uint8_t version of protocol - 1;
+ * - uint8_t number of threads;
+ * - uint8_t number of queues;
+ * - uint8_t reserved;
+ * - uint32_t frequency of TickClock, Hz;
+ * - for each thread - uint32_t stack size, uint8_t length of name and name;
+ * - for each queue - uint32_t capacity, uint8_t length of name and name;
+ *
+ * Payload of sample frame:
+ * - uint32_t sequence number;
+ * - uint32_t tick count;
+ * - uint32_t context switch count;
+ * - uint32_t number of used bytes of heap;
+ * - uint32_t total size of heap, bytes;
+ * - for each thread - uint32_t run tick count, uint32_t stack high water mark, uint8_t state, uint8_t priority,
+ * uint8_t effective priority, uint8_t reserved;
+ * - for each queue - uint32_t current number of elements;
+ *
+ * Counters are truncated to 32 bits, the viewer computes differences between consecutive samples modulo 2^32.
+ *
+ * \ingroup statistics
+ */
+
+class PerformanceMonitor
+{
+public:
+
+	/// range of registered queues
+	using QueuesRange = estd::ContiguousRange<const MonitoredQueue>;
+
+	/// range of registered threads
+	using ThreadsRange = estd::ContiguousRange<const MonitoredThread>;
+
+	/// number of samples after which description frame is repeated
+	constexpr static uint32_t descriptionInterval {10};
+
+	/// version of protocol
+	constexpr static uint8_t protocolVersion {1};
+
+	/**
+	 * \brief PerformanceMonitor's constructor
+	 *
+	 * \param [in] serialPort is a reference to serial port used for transmission of frames, it must be opened by the
+	 * user
+	 * \param [in] period is the period of sampling
+	 * \param [in] threadsRange is the range of registered threads, at most 255 elements
+	 * \param [in] queuesRange is the range of registered queues, at most 255 elements, default - empty range
+	 */
+
+	constexpr PerformanceMonitor(devices::SerialPort& serialPort, const TickClock::duration period,
+			const ThreadsRange threadsRange, const QueuesRange queuesRange = {}) :
+			queuesRange_{queuesRange},
+			threadsRange_{threadsRange},
+			period_{period},
+			serialPort_{serialPort}
+	{
+
+	}
+
+protected:
+
+	/**
+	 * \brief Main function of monitor thread.
+	 *
+	 * Sends description frame followed by sample frames, repeating the description every descriptionInterval samples.
+	 * Errors of transmission are ignored - affected frame is rejected by the viewer.
+	 *
+	 * \param [in] performanceMonitor is a pointer to PerformanceMonitor object
+	 */
+
+	static void run(PerformanceMonitor* performanceMonitor);
+
+private:
+
+	/**
+	 * \brief Sends description frame.
+	 */
+
+	void sendDescription() const;
+
+	/**
+	 * \brief Collects and sends sample frame.
+	 *
+	 * \param [in] sequence is the sequence number of sample
+	 */
+
+	void sendSample(uint32_t sequence) const;
+
+	/// range of registered queues
+	QueuesRange queuesRange_;
+
+	/// range of registered threads
+	ThreadsRange threadsRange_;
+
+	/// period of sampling
+	TickClock::duration period_;
+
+	/// reference to serial port used for transmission of frames
+	devices::SerialPort& serialPort_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_MONITOR_PERFORMANCEMONITOR_HPP_
@@ -0,0 +1,86 @@
+/**
+ * \file
+ * \brief StaticPerformanceMonitor class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_MONITOR_STATICPERFORMANCEMONITOR_HPP_
+#define INCLUDE_DISTORTOS_MONITOR_STATICPERFORMANCEMONITOR_HPP_
+
+#include "distortos/monitor/PerformanceMonitor.hpp"
+
+#include "distortos/StaticThread.hpp"
+
+namespace distortos
+{
+
+/**
+ * \brief StaticPerformanceMonitor class is a PerformanceMonitor with monitor thread which has automatic storage for
+ * stack.
+ *
+ * \tparam StackSize is the size of stack of monitor thread, bytes
+ *
+ * \ingroup statistics
+ */
+
+template<size_t StackSize>
+class StaticPerformanceMonitor : public PerformanceMonitor
+{
+public:
+
+	/**
+	 * \brief StaticPerformanceMonitor's constructor
+	 *
+	 * \param [in] serialPort is a reference to serial port used for transmission of frames, it must be opened by the
+	 * user
+	 * \param [in] priority is the priority of monitor thread, should be the lowest priority above idle thread
+	 * \param [in] period is the period of sampling
+	 * \param [in] threadsRange is the range of registered threads, at most 255 elements
+	 * \param [in] queuesRange is the range of registered queues, at most 255 elements, default - empty range
+	 */
+
+	StaticPerformanceMonitor(devices::SerialPort& serialPort, const uint8_t priority, const TickClock::duration period,
+			const ThreadsRange threadsRange, const QueuesRange queuesRange = {}) :
+			PerformanceMonitor{serialPort, period, threadsRange, queuesRange},
+			thread_{priority, &PerformanceMonitor::run, static_cast<PerformanceMonitor*>(this)}
+	{
+
+	}
+
+	/**
+	 * \return reference to monitor thread, which may be registered in the monitor to watch its own stack usage
+	 */
+
+	const Thread& getThread() const
+	{
+		return thread_;
+	}
+
+	/**
+	 * \brief Starts monitor thread.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by StaticThread::start();
+	 */
+
+	int start()
+	{
+		return thread_.start();
+	}
+
+private:
+
+	/// monitor thread
+	StaticThread<StackSize, false, 0, 0, void(*)(PerformanceMonitor*), PerformanceMonitor*> thread_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_MONITOR_STATICPERFORMANCEMONITOR_HPP_
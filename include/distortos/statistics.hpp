@@ -2,7 +2,7 @@
  * \file
  * \brief statistics namespace header
  *
- * \author Copyright (C) 2014-2015 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -12,7 +12,9 @@
 #ifndef INCLUDE_DISTORTOS_STATISTICS_HPP_
 #define INCLUDE_DISTORTOS_STATISTICS_HPP_
 
-#include <cstdint>
+#include "distortos/distortosConfiguration.h"
+
+#include "distortos/HeapStatistics.hpp"
 
 namespace distortos
 {
@@ -29,6 +31,32 @@ namespace statistics
 
 uint64_t getContextSwitchCount();
 
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+/**
+ * \brief Gets call sites of allocation functions seen by sampling of allocations.
+ *
+ * Call sites are sorted by the total size of live sampled blocks, in descending order. When the table of sampled
+ * blocks is full, new allocations are only counted, so values of live blocks may be lower than real ones.
+ *
+ * \warning This function must not be called from interrupt context!
+ *
+ * \param [out] buffer is a pointer to array to which call sites will be written
+ * \param [in] size is the number of elements in \a buffer
+ *
+ * \return number of call sites written to \a buffer, always 0 if CONFIG_HEAP_ACCOUNTING_CALL_SITES is 0
+ */
+
+size_t getHeapCallSites(HeapCallSite* buffer, size_t size);
+
+/**
+ * \return heap usage statistics of all threads, including the ones which already terminated
+ */
+
+HeapStatistics getHeapStatistics();
+
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
 /// \}
 
 }	// namespace statistics
@@ -0,0 +1,414 @@
+/**
+ * \file
+ * \brief CircularLog class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_STORAGE_CIRCULARLOG_HPP_
+#define INCLUDE_DISTORTOS_STORAGE_CIRCULARLOG_HPP_
+
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+class BlockDevice;
+
+}	// namespace devices
+
+/**
+ * CircularLog class is an append-only ring of records, stored directly on a block device.
+ *
+ * The block device is divided into sectors (erase blocks). Each used sector starts with a header containing its
+ * sequence number, records are appended one after another until they don't fit in the sector. Then the next sector
+ * (possibly the oldest one, which gets erased) is opened. Each record has a header with its size, sequence number and
+ * CRC-32 of the header and the data. Record's header is programmed after its data, so a record interrupted by power
+ * failure is never considered valid.
+ *
+ * Mounting is done with a binary search for the newest sector, followed by a scan of this single sector. Appending a
+ * record is O(1) and - except for the last partial program block of data and the header - the data is programmed
+ * directly from the buffer provided by the user.
+ *
+ * Records are read with Cursor objects, which can be used concurrently with appends. Records overwritten by the ring
+ * are detected by the cursor.
+ *
+ * All functions lock the associated block device for the duration of the operation, so the block device should not be
+ * shared with anything else.
+ *
+ * \ingroup storage
+ */
+
+class CircularLog
+{
+public:
+
+	/// position of a record in CircularLog
+	class Cursor
+	{
+		friend class CircularLog;
+
+	public:
+
+		/**
+		 * \brief Cursor's constructor
+		 */
+
+		constexpr Cursor() :
+				offset_{},
+				recordSequence_{},
+				sectorSequence_{}
+		{
+
+		}
+
+		/**
+		 * \return sequence number of the record which was read with this cursor most recently
+		 */
+
+		uint32_t getRecordSequence() const
+		{
+			return recordSequence_;
+		}
+
+	private:
+
+		/**
+		 * \brief Cursor's constructor
+		 *
+		 * \param [in] sectorSequence is the sequence number of sector
+		 * \param [in] offset is the offset of record in sector, bytes
+		 */
+
+		constexpr Cursor(const uint32_t sectorSequence, const size_t offset) :
+				offset_{offset},
+				recordSequence_{},
+				sectorSequence_{sectorSequence}
+		{
+
+		}
+
+		/// offset of record in sector, bytes
+		size_t offset_;
+
+		/// sequence number of the record which was read with this cursor most recently
+		uint32_t recordSequence_;
+
+		/// sequence number of sector
+		uint32_t sectorSequence_;
+	};
+
+	/**
+	 * \brief CircularLog's constructor
+	 *
+	 * \param [in] blockDevice is a reference to block device on which the log is stored
+	 * \param [in] buffer is a pointer to buffer used for assembling headers and partial program blocks and for
+	 * verifying records during mount, its size must be a multiple of program block size of \a blockDevice, which is
+	 * not smaller than 16 bytes
+	 * \param [in] bufferSize is the size of \a buffer, bytes
+	 */
+
+	constexpr CircularLog(devices::BlockDevice& blockDevice, void* const buffer, const size_t bufferSize) :
+			blockDevice_{blockDevice},
+			buffer_{buffer},
+			bufferSize_{bufferSize},
+			headOffset_{},
+			programBlockSize_{},
+			sectorSize_{},
+			sectorsCount_{},
+			validSectors_{},
+			headSector_{},
+			headSequence_{},
+			nextRecordSequence_{},
+			erasedValue_{},
+			mounted_{}
+	{
+
+	}
+
+	/**
+	 * \brief CircularLog's destructor
+	 *
+	 * Unmounts the log if it is mounted.
+	 */
+
+	~CircularLog();
+
+	/**
+	 * \brief Appends a record to the log.
+	 *
+	 * If the record doesn't fit in the newest sector, the next sector is erased and opened, which discards the oldest
+	 * records if the log is full.
+	 *
+	 * \param [in] buffer is the buffer with data of the record
+	 * \param [in] size is the size of \a buffer, bytes, [1; getMaxRecordSize()]
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the log is not mounted;
+	 * - EINVAL - \a buffer and/or \a size are not valid;
+	 * - EMSGSIZE - \a size is greater than getMaxRecordSize();
+	 * - error codes returned by BlockDevice::erase();
+	 * - error codes returned by BlockDevice::program();
+	 */
+
+	int append(const void* buffer, size_t size);
+
+	/**
+	 * \brief Formats the log.
+	 *
+	 * The whole block device is erased, an erased block device is an empty log.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - the log is mounted;
+	 * - error codes returned by BlockDevice::erase();
+	 * - error codes returned by BlockDevice::open();
+	 */
+
+	int format();
+
+	/**
+	 * \return maximal size of single record, bytes, 0 if the log is not mounted
+	 */
+
+	size_t getMaxRecordSize() const;
+
+	/**
+	 * \return pair with return code (0 on success, error code otherwise) and cursor positioned after the newest record,
+	 * which can be used to read only records appended after this call; error codes:
+	 * - EBADF - the log is not mounted;
+	 */
+
+	std::pair<int, Cursor> getHead();
+
+	/**
+	 * \return pair with return code (0 on success, error code otherwise) and cursor positioned at the oldest record;
+	 * error codes:
+	 * - EBADF - the log is not mounted;
+	 */
+
+	std::pair<int, Cursor> getTail();
+
+	/**
+	 * \brief Locks the log for exclusive use by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by BlockDevice::lock();
+	 */
+
+	int lock();
+
+	/**
+	 * \brief Mounts the log.
+	 *
+	 * The block device is opened, the newest sector is found with binary search and its records are verified. If the
+	 * newest sector contains a record interrupted by power failure (or if erased value of block device is not defined),
+	 * the next append will open a new sector.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - the log is already mounted;
+	 * - EILSEQ - block device doesn't contain a valid log;
+	 * - EINVAL - geometry of block device and/or size of buffer are not valid;
+	 * - error codes returned by BlockDevice::open();
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	int mount();
+
+	/**
+	 * \brief Reads next record.
+	 *
+	 * \param [in,out] cursor is a reference to cursor which selects the record, on success it is advanced to next
+	 * record
+	 * \param [out] buffer is the buffer into which the record will be read
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and size of record, bytes (valid also with
+	 * EMSGSIZE); error codes:
+	 * - EBADF - the log is not mounted;
+	 * - EINVAL - \a buffer is not valid;
+	 * - EMSGSIZE - \a size is smaller than size of record, \a cursor is not advanced;
+	 * - ENODATA - there are no more records;
+	 * - EOVERFLOW - the record selected by \a cursor was overwritten, \a cursor was moved to the oldest record;
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	std::pair<int, size_t> read(Cursor& cursor, void* buffer, size_t size);
+
+	/**
+	 * \brief Synchronizes state of the log, ensuring all appended records are written to block device.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the log is not mounted;
+	 * - error codes returned by BlockDevice::synchronize();
+	 */
+
+	int synchronize();
+
+	/**
+	 * \brief Unlocks the log which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by BlockDevice::unlock();
+	 */
+
+	int unlock();
+
+	/**
+	 * \brief Unmounts the log.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the log is not mounted;
+	 * - error codes returned by BlockDevice::close();
+	 * - error codes returned by BlockDevice::synchronize();
+	 */
+
+	int unmount();
+
+	CircularLog(const CircularLog&) = delete;
+	const CircularLog& operator=(const CircularLog&) = delete;
+
+private:
+
+	struct SectorHeader;
+
+	/**
+	 * \brief Opens next sector.
+	 *
+	 * Next sector is erased and its header is programmed.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by BlockDevice::erase();
+	 * - error codes returned by BlockDevice::program();
+	 */
+
+	int advanceHead();
+
+	/**
+	 * \brief Checks whether range of sector is erased.
+	 *
+	 * \param [in] sector is the index of sector
+	 * \param [in] begin is the offset of beginning of checked range, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and true if range from \a begin to the end of
+	 * sector is erased, false otherwise; error codes:
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	std::pair<int, bool> isErased(size_t sector, size_t begin) const;
+
+	/**
+	 * \brief Programs data padded to program block size.
+	 *
+	 * Aligned part of data is programmed directly, the remainder is copied to buffer, padded with erased value and
+	 * programmed.
+	 *
+	 * \param [in] address is the address of data
+	 * \param [in] buffer is the buffer with data
+	 * \param [in] size is the size of \a buffer, bytes, must not be greater than getMaxRecordSize()
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by BlockDevice::program();
+	 */
+
+	int programPadded(uint64_t address, const void* buffer, size_t size) const;
+
+	/**
+	 * \brief Reads and verifies header of sector.
+	 *
+	 * \param [in] sector is the index of sector
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and header of sector, which is valid only if
+	 * its magic field is equal to expected value; error codes:
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	std::pair<int, SectorHeader> readSectorHeader(size_t sector) const;
+
+	/**
+	 * \brief Reads and verifies record.
+	 *
+	 * \param [in] sector is the index of sector
+	 * \param [in] offset is the offset of record in sector, bytes
+	 * \param [out] buffer is the buffer into which the data of record will be read, nullptr to use internal buffer
+	 * \param [in] size is the size of \a buffer, bytes, ignored if \a buffer is nullptr
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and pair with size and sequence number of
+	 * the record, size is 0 if record is not valid; error codes:
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	std::pair<int, std::pair<size_t, uint32_t>> readRecord(size_t sector, size_t offset, void* buffer,
+			size_t size) const;
+
+	/**
+	 * \param [in] size is the size of data, bytes
+	 *
+	 * \return \a size rounded up to program block size
+	 */
+
+	size_t roundUp(const size_t size) const
+	{
+		return (size + programBlockSize_ - 1) / programBlockSize_ * programBlockSize_;
+	}
+
+	/// reference to block device on which the log is stored
+	devices::BlockDevice& blockDevice_;
+
+	/// pointer to buffer used for assembling headers and partial program blocks and for verifying records
+	void* buffer_;
+
+	/// size of \a buffer_, bytes
+	size_t bufferSize_;
+
+	/// offset in newest sector at which next record will be appended, bytes
+	size_t headOffset_;
+
+	/// program block size of block device, bytes
+	size_t programBlockSize_;
+
+	/// size of sector (erase block size of block device), bytes
+	size_t sectorSize_;
+
+	/// number of sectors
+	size_t sectorsCount_;
+
+	/// number of sectors with valid records, including the newest one
+	size_t validSectors_;
+
+	/// index of newest sector
+	size_t headSector_;
+
+	/// sequence number of newest sector
+	uint32_t headSequence_;
+
+	/// sequence number of next appended record
+	uint32_t nextRecordSequence_;
+
+	/// erased value of block device
+	uint8_t erasedValue_;
+
+	/// true if the log is mounted, false otherwise
+	bool mounted_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_STORAGE_CIRCULARLOG_HPP_
@@ -0,0 +1,495 @@
+/**
+ * \file
+ * \brief KeyValueStore class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_STORAGE_KEYVALUESTORE_HPP_
+#define INCLUDE_DISTORTOS_STORAGE_KEYVALUESTORE_HPP_
+
+#include <utility>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+class BlockDevice;
+
+}	// namespace devices
+
+/**
+ * KeyValueStore class is a log-structured store of small values (configuration, calibration data, ...) identified with
+ * numeric keys, stored directly on a block device.
+ *
+ * The block device is divided into two or more sectors (erase blocks), which are used in round-robin order - one of
+ * them is always kept erased. Each change of a value is appended to the newest sector as a single record, assembled
+ * and programmed with a single operation. When the newest sector is full, the erased sector is opened, all live values
+ * from the oldest sector are copied to it and the oldest sector is erased, which spreads erase cycles evenly over all
+ * sectors.
+ *
+ * Changes of multiple values may be committed atomically - after power failure either all or none of them are visible.
+ *
+ * All live values are mirrored in RAM, in storage provided by the user, and indexed with a hash table rebuilt during
+ * mount. Reading a value is O(1) and doesn't access the block device. No memory is allocated dynamically.
+ *
+ * All functions lock the associated block device for the duration of the operation, so the block device should not be
+ * shared with anything else.
+ *
+ * \ingroup storage
+ */
+
+class KeyValueStore
+{
+public:
+
+	/// single change of value, used by commit()
+	struct Change
+	{
+		/// key of value
+		uint32_t key;
+
+		/// pointer to new value, nullptr to remove the value
+		const void* data;
+
+		/// size of new value, bytes, ignored if \a data is nullptr
+		size_t size;
+	};
+
+	/// storage for one entry of hash index
+	class Slot
+	{
+		friend class KeyValueStore;
+
+	public:
+
+		/**
+		 * \brief Slot's constructor
+		 */
+
+		constexpr Slot() :
+				key_{},
+				offset_{},
+				sector_{}
+		{
+
+		}
+
+	private:
+
+		/// key of value
+		uint32_t key_;
+
+		/// offset of value in storage for values, emptySlot if this slot is not used
+		uint32_t offset_;
+
+		/// index of sector which contains the newest record of this value
+		uint32_t sector_;
+	};
+
+	/**
+	 * \brief KeyValueStore's constructor
+	 *
+	 * \param [in] blockDevice is a reference to block device on which the store is located
+	 * \param [in] slots is a pointer to array with storage for hash index, its size must be greater than the maximum
+	 * number of values in the store
+	 * \param [in] slotsCount is the number of elements in \a slots array
+	 * \param [in] values is a pointer to storage for RAM copy of all values, aligned to 4 bytes, each value takes its
+	 * size rounded up to 4 bytes plus 8 bytes
+	 * \param [in] valuesSize is the size of \a values, bytes
+	 * \param [in] buffer is a pointer to buffer used for assembling and verifying records, its size must be a multiple
+	 * of program block size of \a blockDevice, each record takes its value's size plus 12 bytes
+	 * \param [in] bufferSize is the size of \a buffer, bytes
+	 */
+
+	constexpr KeyValueStore(devices::BlockDevice& blockDevice, Slot* const slots, const size_t slotsCount,
+			void* const values, const size_t valuesSize, void* const buffer, const size_t bufferSize) :
+					blockDevice_{blockDevice},
+					buffer_{buffer},
+					bufferSize_{bufferSize},
+					slots_{slots},
+					slotsCount_{slotsCount},
+					values_{values},
+					valuesSize_{valuesSize},
+					headOffset_{},
+					programBlockSize_{},
+					sectorSize_{},
+					sectorsCount_{},
+					usedSlots_{},
+					usedValues_{},
+					liveValues_{},
+					headSector_{},
+					headSequence_{},
+					erasedValue_{},
+					mounted_{}
+	{
+
+	}
+
+	/**
+	 * \brief KeyValueStore's destructor
+	 *
+	 * Unmounts the store if it is mounted.
+	 */
+
+	~KeyValueStore();
+
+	/**
+	 * \brief Atomically commits changes of multiple values.
+	 *
+	 * Either all changes are visible after power failure, or none of them are. Changes equal to current state of the
+	 * store are skipped.
+	 *
+	 * \param [in] changes is a pointer to array with changes
+	 * \param [in] count is the number of elements in \a changes array, [1; 255]
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the store is not mounted;
+	 * - EINVAL - \a changes and/or \a count are not valid;
+	 * - EMSGSIZE - size of at least one value is greater than getMaxValueSize() or all records don't fit in one sector;
+	 * - ENOSPC - there is not enough space in the index, in RAM storage for values or on the block device;
+	 * - error codes returned by BlockDevice::erase();
+	 * - error codes returned by BlockDevice::program();
+	 */
+
+	int commit(const Change* changes, size_t count);
+
+	/**
+	 * \brief Formats the store.
+	 *
+	 * The whole block device is erased, an erased block device is an empty store.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - the store is mounted;
+	 * - error codes returned by BlockDevice::erase();
+	 * - error codes returned by BlockDevice::open();
+	 */
+
+	int format();
+
+	/**
+	 * \brief Reads value.
+	 *
+	 * \param [in] key is the key of value
+	 * \param [out] buffer is the buffer into which the value will be read
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and size of value, bytes (valid also with
+	 * EMSGSIZE); error codes:
+	 * - EBADF - the store is not mounted;
+	 * - EMSGSIZE - \a size is smaller than size of value;
+	 * - ENOENT - there is no value with given key;
+	 */
+
+	std::pair<int, size_t> get(uint32_t key, void* buffer, size_t size);
+
+	/**
+	 * \return maximal size of single value, bytes, 0 if the store is not mounted
+	 */
+
+	size_t getMaxValueSize() const;
+
+	/**
+	 * \brief Locks the store for exclusive use by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by BlockDevice::lock();
+	 */
+
+	int lock();
+
+	/**
+	 * \brief Mounts the store.
+	 *
+	 * The block device is opened, all records are verified and replayed into RAM. If garbage collection was interrupted
+	 * by power failure, it is completed.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBUSY - the store is already mounted;
+	 * - EILSEQ - block device doesn't contain a valid store;
+	 * - EINVAL - geometry of block device and/or sizes of provided storage are not valid;
+	 * - ENOSPC - there is not enough space in the index or in RAM storage for values;
+	 * - error codes returned by BlockDevice::erase();
+	 * - error codes returned by BlockDevice::open();
+	 * - error codes returned by BlockDevice::program();
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	int mount();
+
+	/**
+	 * \brief Removes value.
+	 *
+	 * \param [in] key is the key of value
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - ENOENT - there is no value with given key;
+	 * - error codes returned by commit();
+	 */
+
+	int remove(uint32_t key);
+
+	/**
+	 * \brief Sets value.
+	 *
+	 * In the common case this is a single program operation of block device.
+	 *
+	 * \param [in] key is the key of value
+	 * \param [in] data is a pointer to new value
+	 * \param [in] size is the size of new value, bytes
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by commit();
+	 */
+
+	int set(uint32_t key, const void* data, size_t size);
+
+	/**
+	 * \brief Unlocks the store which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by BlockDevice::unlock();
+	 */
+
+	int unlock();
+
+	/**
+	 * \brief Unmounts the store.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the store is not mounted;
+	 * - error codes returned by BlockDevice::close();
+	 * - error codes returned by BlockDevice::synchronize();
+	 */
+
+	int unmount();
+
+	KeyValueStore(const KeyValueStore&) = delete;
+	const KeyValueStore& operator=(const KeyValueStore&) = delete;
+
+private:
+
+	/**
+	 * \brief Opens next sector.
+	 *
+	 * The erased sector is opened, then garbage is collected from the oldest sector.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by BlockDevice::program();
+	 * - error codes returned by collect();
+	 */
+
+	int advanceHead();
+
+	/**
+	 * \brief Applies change to RAM copy of values and to the index.
+	 *
+	 * \param [in] key is the key of value
+	 * \param [in] data is a pointer to new value, nullptr to remove the value
+	 * \param [in] size is the size of new value, bytes
+	 * \param [in] sector is the index of sector which contains the record with this change
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - ENOSPC - there is not enough space in the index or in RAM storage for values;
+	 */
+
+	int apply(uint32_t key, const void* data, size_t size, size_t sector);
+
+	/**
+	 * \brief Collects garbage from sector.
+	 *
+	 * All live values from the sector are copied to the newest sector, then the sector is erased.
+	 *
+	 * \param [in] sector is the index of collected sector
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - ENOSPC - live values don't fit in the newest sector;
+	 * - error codes returned by BlockDevice::erase();
+	 * - error codes returned by BlockDevice::program();
+	 */
+
+	int collect(size_t sector);
+
+	/**
+	 * \brief Compacts RAM storage for values, removing all values which were overwritten or removed.
+	 */
+
+	void compactValues();
+
+	/**
+	 * \brief Finds beginning of erased tail of sector.
+	 *
+	 * \param [in] sector is the index of sector
+	 * \param [in] begin is the offset from which the sector is checked, bytes, must be a multiple of program block size
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and offset from which the sector is erased
+	 * (\a begin if the whole checked range is erased, size of sector if erased value of block device is not defined),
+	 * rounded up to program block size; error codes:
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	std::pair<int, size_t> findErasedTail(size_t sector, size_t begin) const;
+
+	/**
+	 * \brief Finds slot of value.
+	 *
+	 * \param [in] key is the key of value
+	 *
+	 * \return index of slot with \a key if it is used or index of empty slot in which \a key would be placed
+	 */
+
+	size_t findSlot(uint32_t key) const;
+
+	/**
+	 * \brief Programs one record at the end of newest sector.
+	 *
+	 * \param [in] key is the key of value
+	 * \param [in] data is a pointer to value, may be nullptr if \a size is 0
+	 * \param [in] size is the size of value, bytes
+	 * \param [in] remaining is the number of records which follow this one in the same commit
+	 * \param [in] flags are the flags of record
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - error codes returned by BlockDevice::program();
+	 */
+
+	int programRecord(uint32_t key, const void* data, size_t size, uint8_t remaining, uint8_t flags);
+
+	/**
+	 * \brief Reads and verifies record.
+	 *
+	 * On success the record is available in the buffer.
+	 *
+	 * \param [in] sector is the index of sector
+	 * \param [in] offset is the offset of record in sector, bytes
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and size of record (including header and
+	 * padding), bytes, 0 if record is not valid; error codes:
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	std::pair<int, size_t> readRecord(size_t sector, size_t offset) const;
+
+	/**
+	 * \brief Reads and verifies header of sector.
+	 *
+	 * \param [in] sector is the index of sector
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and pair with true if header is valid (false
+	 * otherwise) and sequence number of sector; error codes:
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	std::pair<int, std::pair<bool, uint32_t>> readSectorHeader(size_t sector) const;
+
+	/**
+	 * \brief Removes value from the index, moving following entries of the same cluster back.
+	 *
+	 * \param [in] slot is the index of slot with removed value
+	 */
+
+	void removeSlot(size_t slot);
+
+	/**
+	 * \brief Replays all valid records from sector into RAM.
+	 *
+	 * Records of a commit are replayed only if all of them are valid. Replay stops at first invalid record, unless it
+	 * is followed by a resynchronization record, which is programmed during mount after a record interrupted by power
+	 * failure.
+	 *
+	 * \param [in] sector is the index of sector
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and offset of the first invalid record,
+	 * bytes; error codes:
+	 * - error codes returned by apply();
+	 * - error codes returned by BlockDevice::read();
+	 */
+
+	std::pair<int, size_t> replaySector(size_t sector);
+
+	/**
+	 * \param [in] size is the size of data, bytes
+	 *
+	 * \return \a size rounded up to program block size
+	 */
+
+	size_t roundUp(const size_t size) const
+	{
+		return (size + programBlockSize_ - 1) / programBlockSize_ * programBlockSize_;
+	}
+
+	/// reference to block device on which the store is located
+	devices::BlockDevice& blockDevice_;
+
+	/// pointer to buffer used for assembling and verifying records
+	void* buffer_;
+
+	/// size of \a buffer_, bytes
+	size_t bufferSize_;
+
+	/// pointer to array with storage for hash index
+	Slot* slots_;
+
+	/// number of elements in \a slots_ array
+	size_t slotsCount_;
+
+	/// pointer to storage for RAM copy of all values
+	void* values_;
+
+	/// size of \a values_, bytes
+	size_t valuesSize_;
+
+	/// offset in newest sector at which next record will be programmed, bytes
+	size_t headOffset_;
+
+	/// program block size of block device, bytes
+	size_t programBlockSize_;
+
+	/// size of sector (erase block size of block device), bytes
+	size_t sectorSize_;
+
+	/// number of sectors
+	size_t sectorsCount_;
+
+	/// number of used slots of hash index
+	size_t usedSlots_;
+
+	/// number of used bytes in storage for values, including values which were overwritten or removed
+	size_t usedValues_;
+
+	/// number of bytes in storage for values used by live values
+	size_t liveValues_;
+
+	/// index of newest sector
+	size_t headSector_;
+
+	/// sequence number of newest sector
+	uint32_t headSequence_;
+
+	/// erased value of block device
+	uint8_t erasedValue_;
+
+	/// true if the store is mounted, false otherwise
+	bool mounted_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_STORAGE_KEYVALUESTORE_HPP_
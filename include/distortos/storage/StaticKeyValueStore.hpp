@@ -0,0 +1,67 @@
+/**
+ * \file
+ * \brief StaticKeyValueStore class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef INCLUDE_DISTORTOS_STORAGE_STATICKEYVALUESTORE_HPP_
+#define INCLUDE_DISTORTOS_STORAGE_STATICKEYVALUESTORE_HPP_
+
+#include "distortos/storage/KeyValueStore.hpp"
+
+#include <array>
+
+namespace distortos
+{
+
+/**
+ * \brief StaticKeyValueStore class is a variant of KeyValueStore that has automatic storage for hash index, RAM copy of
+ * values and buffer.
+ *
+ * \tparam SlotsCount is the number of slots of hash index, must be greater than the maximum number of values
+ * \tparam ValuesSize is the size of storage for RAM copy of values, bytes, each value takes its size rounded up to 4
+ * bytes plus 8 bytes
+ * \tparam BufferSize is the size of buffer, bytes, must be a multiple of program block size of block device, each
+ * record takes its value's size plus 12 bytes
+ *
+ * \ingroup storage
+ */
+
+template<size_t SlotsCount, size_t ValuesSize, size_t BufferSize>
+class StaticKeyValueStore : public KeyValueStore
+{
+public:
+
+	/**
+	 * \brief StaticKeyValueStore's constructor
+	 *
+	 * \param [in] blockDevice is a reference to block device on which the store is located
+	 */
+
+	explicit StaticKeyValueStore(devices::BlockDevice& blockDevice) :
+			KeyValueStore{blockDevice, slots_.data(), slots_.size(), values_.data(), sizeof(values_), buffer_.data(),
+					buffer_.size()}
+	{
+
+	}
+
+private:
+
+	/// storage for hash index
+	std::array<Slot, SlotsCount> slots_;
+
+	/// storage for RAM copy of values
+	std::array<uint32_t, (ValuesSize + sizeof(uint32_t) - 1) / sizeof(uint32_t)> values_;
+
+	/// buffer used for assembling and verifying records
+	std::array<uint8_t, BufferSize> buffer_;
+};
+
+}	// namespace distortos
+
+#endif	// INCLUDE_DISTORTOS_STORAGE_STATICKEYVALUESTORE_HPP_
@@ -0,0 +1,182 @@
+#!/usr/bin/env python
+
+#
+# file: packXipImage.py
+#
+# author: Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+#
+# This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+# distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+
+from __future__ import print_function
+
+import argparse
+import common
+import os
+import posixpath
+import struct
+import sys
+import zlib
+
+# magic value of image - "XIP1"
+magic = 0x31504958
+
+# format of image header - magic, CRC-32, size of image, size of metadata, number of entries
+headerFormat = '<IIIII'
+
+# format of entry - offset of path, offset of data, size, length of path, type, reserved
+entryFormat = '<IIIHBB'
+
+# type of entry which is a file
+fileType = 1
+
+# type of entry which is a directory
+directoryType = 2
+
+# max length of name of file or directory
+nameMax = 255
+
+def alignUp(value, alignment):
+	"""Align value up and return it.
+
+	* `value` is the value that will be aligned
+	* `alignment` is the alignment, must be a power of 2
+	"""
+	return (value + alignment - 1) // alignment * alignment
+
+def collectEntries(inputPath):
+	"""Collect files and directories from input path and return list of them, sorted in the order of image's table of
+	entries.
+
+	Each element of the list is a tuple with path (relative to `inputPath`, with '/' as separator, as `bytes`) and
+	filesystem path of file or `None` for directory.
+
+	* `inputPath` is the path of directory with contents of the image
+	"""
+	entries = []
+	for currentDirectory, directories, filenames in os.walk(inputPath, followlinks = True):
+		relativeDirectory = os.path.relpath(currentDirectory, inputPath).replace(os.sep, '/')
+		for name in directories + filenames:
+			if len(name.encode('utf-8')) > nameMax:
+				sys.exit('error: name "{}" is longer than {} bytes'.format(name, nameMax))
+			path = name if relativeDirectory == '.' else posixpath.join(relativeDirectory, name)
+			filesystemPath = os.path.join(currentDirectory, name)
+			entries.append((path.encode('utf-8'), filesystemPath if name in filenames else None))
+
+	# '/' must be ordered before all other characters, so that descendants of each directory directly follow it
+	entries.sort(key = lambda entry: entry[0].replace(b'/', b'\x00'))
+	return entries
+
+def packImage(entries, alignment):
+	"""Pack entries into image and return it as `bytes`.
+
+	* `entries` is the list of entries returned by `collectEntries()`
+	* `alignment` is the alignment of contents of each file, must be a power of 2 and at least 4
+	"""
+	entrySize = struct.calcsize(entryFormat)
+	headerSize = struct.calcsize(headerFormat)
+	pathsOffset = headerSize + len(entries) * entrySize
+	paths = bytearray()
+	pathOffsets = []
+	for path, filesystemPath in entries:
+		if len(path) > 0xffff:
+			sys.exit('error: path "{}" is too long'.format(path.decode('utf-8')))
+		pathOffsets.append(pathsOffset + len(paths))
+		paths += path + b'\x00'
+
+	metadataSize = pathsOffset + len(paths)
+	data = bytearray()
+	dataOffset = alignUp(metadataSize, alignment)
+	table = bytearray()
+	for index, (path, filesystemPath) in enumerate(entries):
+		if filesystemPath is None:
+			prefix = path + b'/'
+			descendants = 0
+			for descendantPath, _ in entries[index + 1:]:
+				if descendantPath.startswith(prefix) == False:
+					break
+				descendants += 1
+			table += struct.pack(entryFormat, pathOffsets[index], 0, descendants, len(path), directoryType, 0)
+		else:
+			with open(filesystemPath, 'rb') as file:
+				contents = file.read()
+			data += b'\x00' * (alignUp(len(data), alignment) - len(data))
+			offset = dataOffset + len(data) if len(contents) != 0 else 0
+			table += struct.pack(entryFormat, pathOffsets[index], offset, len(contents), len(path), fileType, 0)
+			data += contents
+
+	imageSize = dataOffset + len(data)
+	if imageSize > 0xffffffff:
+		sys.exit('error: image is too large')
+
+	metadata = struct.pack('<III', imageSize, metadataSize, len(entries)) + table + paths
+	crc = zlib.crc32(metadata) & 0xffffffff
+	image = struct.pack('<II', magic, crc) + metadata
+	return bytes(image + b'\x00' * (dataOffset - metadataSize) + data)
+
+def writeCSource(outputFile, image, name, alignment, section, inputPath):
+	"""Write image as C source file.
+
+	* `outputFile` is the file to which the source will be written
+	* `image` is the packed image
+	* `name` is the name of array with image
+	* `alignment` is the alignment of array with image
+	* `section` is the name of section in which the array will be placed, `None` to use default section
+	* `inputPath` is the path of directory with contents of the image
+	"""
+	attributes = 'aligned({})'.format(alignment)
+	if section is not None:
+		attributes += ', section("{}")'.format(section)
+	outputFile.write('/**\n')
+	outputFile.write(' * \\file\n')
+	outputFile.write(' * \\brief XIP image generated from "{}" by packXipImage.py\n'.format(inputPath))
+	outputFile.write(' *\n')
+	outputFile.write(' * Do not edit - changes will be overwritten!\n')
+	outputFile.write(' */\n\n')
+	outputFile.write('#include <stddef.h>\n')
+	outputFile.write('#include <stdint.h>\n\n')
+	outputFile.write('/** XIP image */\n')
+	outputFile.write('const uint8_t {}[{}] __attribute__ (({})) =\n{{\n'.format(name, len(image), attributes))
+	for offset in range(0, len(image), 16):
+		chunk = image[offset:offset + 16]
+		outputFile.write('\t\t' + ' '.join('0x{:02x},'.format(byte) for byte in bytearray(chunk)) + '\n')
+	outputFile.write('};\n\n')
+	outputFile.write('/** size of XIP image, bytes */\n')
+	outputFile.write('const size_t {}Size = sizeof({});\n'.format(name, name))
+
+########################################################################################################################
+# main
+########################################################################################################################
+
+if __name__ == '__main__':
+	parser = argparse.ArgumentParser(description = 'Pack directory tree into read-only image for XipFileSystem')
+	parser.add_argument('inputPath', help = 'input directory')
+	parser.add_argument('outputFile', help = 'output file')
+	parser.add_argument('-a', '--alignment', type = int, default = 4,
+			help = 'alignment of contents of each file, power of 2, at least 4, default - 4')
+	parser.add_argument('-f', '--format', choices = ['binary', 'c'], default = 'binary',
+			help = 'format of output file, default - binary')
+	parser.add_argument('-n', '--name', help = 'name of array with image in C source file, default - sanitized name of '
+			'output file')
+	parser.add_argument('-s', '--section', help = 'section of array with image in C source file, default - none')
+	arguments = parser.parse_args()
+
+	if arguments.alignment < 4 or arguments.alignment & (arguments.alignment - 1) != 0:
+		sys.exit('error: alignment must be a power of 2, at least 4')
+	if os.path.isdir(arguments.inputPath) == False:
+		sys.exit('error: "{}" is not a directory'.format(arguments.inputPath))
+
+	entries = collectEntries(arguments.inputPath)
+	image = packImage(entries, arguments.alignment)
+
+	if arguments.format == 'binary':
+		with open(arguments.outputFile, 'wb') as outputFile:
+			outputFile.write(image)
+	else:
+		name = arguments.name or common.sanitize(os.path.splitext(os.path.basename(arguments.outputFile))[0],
+				'[^0-9A-Za-z_]')
+		with open(arguments.outputFile, 'w') as outputFile:
+			writeCSource(outputFile, image, name, arguments.alignment, arguments.section, arguments.inputPath)
+
+	print('Packed {} entries into {} ({} bytes)'.format(len(entries), arguments.outputFile, len(image)))
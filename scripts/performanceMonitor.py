@@ -0,0 +1,261 @@
+#!/usr/bin/env python
+
+#
+# file: performanceMonitor.py
+#
+# author: Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+#
+# This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+# distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+
+from __future__ import division
+from __future__ import print_function
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+# magic value of frame - "PM"
+magic = b'PM'
+
+# format of frame header (after magic) - type, size of payload
+headerFormat = '<BH'
+
+# format of frame trailer - CRC-32 of header (without magic) and payload
+trailerFormat = '<I'
+
+# type of description frame
+descriptionType = 1
+
+# type of sample frame
+sampleType = 2
+
+# supported version of protocol
+protocolVersion = 1
+
+# max size of payload
+payloadMax = 65535
+
+# format of description header - version, number of threads, number of queues, reserved, frequency of TickClock
+descriptionHeaderFormat = '<BBBBI'
+
+# format of sample header - sequence, tick count, context switch count, used heap, total heap
+sampleHeaderFormat = '<IIIII'
+
+# format of thread in sample - run tick count, stack high water mark, state, priority, effective priority, reserved
+sampleThreadFormat = '<IIBBBB'
+
+# format of queue in sample - number of elements
+sampleQueueFormat = '<I'
+
+# names of values of distortos::ThreadState, "waitingForSignal" is present only when signals are enabled
+threadStates = ['created', 'runnable', 'terminated', 'sleeping', 'semaphore', 'suspended', 'mutex', 'condvar',
+		'ipcCall', 'ipcReceive', 'newValue', 'barrier', 'signal', 'detached']
+
+class FrameReader(object):
+	"""Extracts valid frames from a stream of bytes, resynchronizing after corrupted or partial frames."""
+
+	def __init__(self, stream):
+		"""FrameReader's constructor
+
+		* `stream` is the object with `read(size)` function
+		"""
+		self.stream = stream
+		self.buffer = b''
+
+	def read(self):
+		"""Read next valid frame and return tuple with its type and payload, or `None` at the end of stream."""
+		headerSize = len(magic) + struct.calcsize(headerFormat)
+		trailerSize = struct.calcsize(trailerFormat)
+		while True:
+			position = self.buffer.find(magic)
+			if position < 0:
+				self.buffer = self.buffer[-(len(magic) - 1):]
+			else:
+				self.buffer = self.buffer[position:]
+				if len(self.buffer) >= headerSize:
+					frameType, size = struct.unpack_from(headerFormat, self.buffer, len(magic))
+					if len(self.buffer) >= headerSize + size + trailerSize:
+						data = self.buffer[len(magic):headerSize + size]
+						crc, = struct.unpack_from(trailerFormat, self.buffer, headerSize + size)
+						if zlib.crc32(data) & 0xffffffff == crc:
+							self.buffer = self.buffer[headerSize + size + trailerSize:]
+							return frameType, data[struct.calcsize(headerFormat):]
+						# corrupted frame or false magic - skip it and search for the next one
+						self.buffer = self.buffer[1:]
+						continue
+			chunk = self.stream.read(256)
+			if not chunk:
+				return None
+			self.buffer += chunk
+
+def readName(payload, offset):
+	"""Read name (length followed by characters) from payload and return tuple with name and offset after it.
+
+	* `payload` is the payload of frame
+	* `offset` is the offset of name in `payload`
+	"""
+	length = bytearray(payload[offset:offset + 1])[0]
+	name = payload[offset + 1:offset + 1 + length].decode('utf-8', 'replace')
+	return name, offset + 1 + length
+
+def parseDescription(payload):
+	"""Parse payload of description frame and return dictionary with its contents, or `None` if it is not supported.
+
+	* `payload` is the payload of description frame
+	"""
+	version, threadsCount, queuesCount, _, frequency = struct.unpack_from(descriptionHeaderFormat, payload)
+	if version != protocolVersion:
+		return None
+	offset = struct.calcsize(descriptionHeaderFormat)
+	threads = []
+	for _ in range(threadsCount):
+		stackSize, = struct.unpack_from('<I', payload, offset)
+		name, offset = readName(payload, offset + 4)
+		threads.append((name, stackSize))
+	queues = []
+	for _ in range(queuesCount):
+		capacity, = struct.unpack_from('<I', payload, offset)
+		name, offset = readName(payload, offset + 4)
+		queues.append((name, capacity))
+	return {'frequency': frequency, 'threads': threads, 'queues': queues}
+
+def parseSample(payload, description):
+	"""Parse payload of sample frame and return dictionary with its contents, or `None` if it does not match the
+	description.
+
+	* `payload` is the payload of sample frame
+	* `description` is the dictionary returned by `parseDescription()`
+	"""
+	threadSize = struct.calcsize(sampleThreadFormat)
+	queueSize = struct.calcsize(sampleQueueFormat)
+	offset = struct.calcsize(sampleHeaderFormat)
+	if len(payload) != offset + len(description['threads']) * threadSize + len(description['queues']) * queueSize:
+		return None
+	sequence, tickCount, contextSwitchCount, heapUsed, heapSize = struct.unpack_from(sampleHeaderFormat, payload)
+	threads = []
+	for _ in description['threads']:
+		threads.append(struct.unpack_from(sampleThreadFormat, payload, offset))
+		offset += threadSize
+	queues = []
+	for _ in description['queues']:
+		queues.append(struct.unpack_from(sampleQueueFormat, payload, offset)[0])
+		offset += queueSize
+	return {'sequence': sequence, 'tickCount': tickCount, 'contextSwitchCount': contextSwitchCount,
+			'heapUsed': heapUsed, 'heapSize': heapSize, 'threads': threads, 'queues': queues}
+
+def formatSample(description, previous, sample, signals):
+	"""Format sample as a `top`-like table and return list of lines.
+
+	CPU share of threads and context switch rate are computed from the difference between `previous` and `sample`.
+
+	* `description` is the dictionary returned by `parseDescription()`
+	* `previous` is the previous sample, `None` if not available
+	* `sample` is the sample that will be formatted
+	* `signals` selects whether the target has signals enabled
+	"""
+	states = threadStates if signals == True else [state for state in threadStates if state != 'signal']
+	ticks = 0
+	if previous is not None:
+		ticks = (sample['tickCount'] - previous['tickCount']) & 0xffffffff
+	contextSwitchRate = 0.0
+	if ticks != 0:
+		contextSwitchRate = (((sample['contextSwitchCount'] - previous['contextSwitchCount']) & 0xffffffff) *
+				description['frequency'] / ticks)
+	lines = []
+	lines.append('sample {}, uptime {:.1f} s, {:.0f} context switches/s, heap {} / {} bytes'.format(
+			sample['sequence'], sample['tickCount'] / description['frequency'], contextSwitchRate, sample['heapUsed'],
+			sample['heapSize']))
+	lines.append('')
+	lines.append('{:<24} {:>6} {:<10} {:>4} {:>4} {:>15}'.format('THREAD', 'CPU%', 'STATE', 'PRIO', 'EFF',
+			'STACK'))
+	for index, (name, stackSize) in enumerate(description['threads']):
+		runTickCount, stackHighWaterMark, state, priority, effectivePriority, _ = sample['threads'][index]
+		cpu = '-'
+		if ticks != 0:
+			runTicks = (runTickCount - previous['threads'][index][0]) & 0xffffffff
+			cpu = '{:.1f}'.format(100 * runTicks / ticks)
+		stateName = states[state] if state < len(states) else str(state)
+		lines.append('{:<24} {:>6} {:<10} {:>4} {:>4} {:>15}'.format(name[:24], cpu, stateName, priority,
+				effectivePriority, '{}/{}'.format(stackHighWaterMark, stackSize)))
+	if description['queues']:
+		lines.append('')
+		lines.append('{:<24} {:>15}'.format('QUEUE', 'SIZE'))
+		for index, (name, capacity) in enumerate(description['queues']):
+			lines.append('{:<24} {:>15}'.format(name[:24], '{}/{}'.format(sample['queues'][index], capacity)))
+	return lines
+
+def run(frameReader, show, signals):
+	"""Read frames and show each sample.
+
+	* `frameReader` is the FrameReader object
+	* `show` is the function which is called with list of lines of each sample
+	* `signals` selects whether the target has signals enabled
+	"""
+	description = None
+	previous = None
+	while True:
+		frame = frameReader.read()
+		if frame is None:
+			return
+		frameType, payload = frame
+		if frameType == descriptionType:
+			newDescription = parseDescription(payload)
+			if newDescription != description:
+				description = newDescription
+				previous = None
+		elif frameType == sampleType and description is not None:
+			sample = parseSample(payload, description)
+			if sample is not None:
+				show(formatSample(description, previous, sample, signals))
+				previous = sample
+
+########################################################################################################################
+# main
+########################################################################################################################
+
+if __name__ == '__main__':
+	parser = argparse.ArgumentParser(description = 'Display statistics streamed by PerformanceMonitor')
+	parser.add_argument('input', help = 'serial port (requires pyserial) or file with captured stream')
+	parser.add_argument('-b', '--baudrate', type = int, default = 115200,
+			help = 'baudrate of serial port, default - 115200')
+	parser.add_argument('-n', '--no-signals', action = 'store_true',
+			help = 'target has signals disabled (CONFIG_SIGNALS_ENABLE is not set)')
+	parser.add_argument('-p', '--plain', action = 'store_true',
+			help = 'print each sample instead of using full-screen display')
+	arguments = parser.parse_args()
+
+	if os.path.isfile(arguments.input) == True:
+		stream = open(arguments.input, 'rb')
+	else:
+		try:
+			import serial
+		except ImportError:
+			sys.exit('error: pyserial is required to read from serial port')
+		stream = serial.Serial(arguments.input, arguments.baudrate)
+
+	signals = arguments.no_signals == False
+	frameReader = FrameReader(stream)
+	try:
+		if arguments.plain == True:
+			def printLines(lines):
+				print('\n'.join(lines) + '\n')
+			run(frameReader, printLines, signals)
+		else:
+			import curses
+			def display(screen):
+				def showLines(lines):
+					screen.erase()
+					height, width = screen.getmaxyx()
+					for row, line in enumerate(lines[:height - 1]):
+						screen.addstr(row, 0, line[:width - 1])
+					screen.refresh()
+				run(frameReader, showLines, signals)
+			curses.wrapper(display)
+	except KeyboardInterrupt:
+		pass
+	finally:
+		stream.close()
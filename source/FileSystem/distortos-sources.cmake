@@ -14,3 +14,6 @@ target_sources(distortos PRIVATE
 		${CMAKE_CURRENT_LIST_DIR}/openFile.cpp)
 
 include(${CMAKE_CURRENT_LIST_DIR}/littlefs/distortos-sources.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/server/distortos-sources.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/tmp/distortos-sources.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/xip/distortos-sources.cmake)
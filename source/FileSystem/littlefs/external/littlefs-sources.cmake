@@ -7,8 +7,8 @@
 # distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #
 
+# lfs_util.c is not compiled - its only function, lfs_crc(), is provided by distortos (see ../lfs_crc.cpp)
 add_library(littlefs STATIC
-		${CMAKE_CURRENT_LIST_DIR}/littlefs/lfs_util.c
 		${CMAKE_CURRENT_LIST_DIR}/littlefs/lfs.c)
 set_target_properties(littlefs PROPERTIES
 		C_STANDARD 99
@@ -0,0 +1,33 @@
+/**
+ * \file
+ * \brief lfs_crc() implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/storage/updateCrc32.hpp"
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Updates CRC-32 used by littlefs with data.
+ *
+ * Replacement for software implementation from littlefs' lfs_util.c, which uses CRC-32 facility of distortos. littlefs
+ * does not invert CRC-32 before and after calculation, so the state passed to and returned from updateCrc32() is
+ * inverted here.
+ *
+ * \param [in,out] crc is a pointer to CRC-32 of preceding data, 0xffffffff for first chunk
+ * \param [in] buffer is the buffer with data
+ * \param [in] size is the size of \a buffer, bytes
+ */
+
+extern "C" void lfs_crc(uint32_t* const crc, const void* const buffer, const size_t size)
+{
+	*crc = ~distortos::internal::updateCrc32(~*crc, buffer, size);
+}
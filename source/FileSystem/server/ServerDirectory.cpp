@@ -0,0 +1,130 @@
+/**
+ * \file
+ * \brief ServerDirectory class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/server/ServerDirectory.hpp"
+
+#include "distortos/FileSystem/server/ServerFileSystem.hpp"
+
+#include "distortos/internal/FileSystem/BoundServerRequestFunctor.hpp"
+
+#include <mutex>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+ServerDirectory::~ServerDirectory()
+{
+	close();
+}
+
+int ServerDirectory::close()
+{
+	const std::lock_guard<ServerDirectory> lockGuard {*this};
+
+	if (directory_ == nullptr)
+		return EBADF;
+
+	// underlying directory is destroyed by the server thread, as its destructor may need the large stack of this thread
+	int ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = directory_->close();
+				directory_.reset();
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+std::pair<int, off_t> ServerDirectory::getPosition()
+{
+	const std::lock_guard<ServerDirectory> lockGuard {*this};
+
+	if (directory_ == nullptr)
+		return {EBADF, {}};
+
+	std::pair<int, off_t> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = directory_->getPosition();
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+int ServerDirectory::lock()
+{
+	return fileSystem_.lock();
+}
+
+std::pair<int, struct dirent> ServerDirectory::read()
+{
+	const std::lock_guard<ServerDirectory> lockGuard {*this};
+
+	if (directory_ == nullptr)
+		return {EBADF, {}};
+
+	std::pair<int, struct dirent> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = directory_->read();
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+int ServerDirectory::rewind()
+{
+	const std::lock_guard<ServerDirectory> lockGuard {*this};
+
+	if (directory_ == nullptr)
+		return EBADF;
+
+	int ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = directory_->rewind();
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+int ServerDirectory::seek(const off_t position)
+{
+	const std::lock_guard<ServerDirectory> lockGuard {*this};
+
+	if (directory_ == nullptr)
+		return EBADF;
+
+	int ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, position, &ret]()
+			{
+				ret = directory_->seek(position);
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+int ServerDirectory::unlock()
+{
+	return fileSystem_.unlock();
+}
+
+}	// namespace distortos
@@ -0,0 +1,321 @@
+/**
+ * \file
+ * \brief ServerFile class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/server/ServerFile.hpp"
+
+#include "distortos/FileSystem/server/ServerFileSystem.hpp"
+
+#include "distortos/internal/FileSystem/BoundServerRequestFunctor.hpp"
+
+#include <mutex>
+
+#include <cstring>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+ServerFile::~ServerFile()
+{
+	close();
+}
+
+int ServerFile::close()
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return EBADF;
+
+	const auto flushRet = flush();
+
+	// underlying file is destroyed by the server thread, as its destructor may need the large stack of this thread
+	int ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = file_->close();
+				file_.reset();
+			}));
+	writeBuffer_.reset();
+	if (flushRet != 0)
+		return flushRet;
+	return executeRet != 0 ? executeRet : ret;
+}
+
+std::pair<int, off_t> ServerFile::getPosition()
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return {EBADF, {}};
+
+	{
+		const auto ret = flush();
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	std::pair<int, off_t> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = file_->getPosition();
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+std::pair<int, off_t> ServerFile::getSize()
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return {EBADF, {}};
+
+	{
+		const auto ret = flush();
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	std::pair<int, off_t> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = file_->getSize();
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+std::pair<int, struct stat> ServerFile::getStatus()
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return {EBADF, {}};
+
+	{
+		const auto ret = flush();
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	std::pair<int, struct stat> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = file_->getStatus();
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+std::pair<int, bool> ServerFile::isATerminal()
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return {EBADF, {}};
+
+	std::pair<int, bool> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = file_->isATerminal();
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+int ServerFile::lock()
+{
+	return fileSystem_.lock();
+}
+
+std::pair<int, size_t> ServerFile::read(void* const buffer, const size_t size)
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return {EBADF, {}};
+
+	{
+		const auto ret = flush();
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	std::pair<int, size_t> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, buffer, size, &ret]()
+			{
+				ret = file_->read(buffer, size);
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+int ServerFile::rewind()
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return EBADF;
+
+	{
+		const auto ret = flush();
+		if (ret != 0)
+			return ret;
+	}
+
+	int ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = file_->rewind();
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+std::pair<int, off_t> ServerFile::seek(const Whence whence, const off_t offset)
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return {EBADF, {}};
+
+	{
+		const auto ret = flush();
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	std::pair<int, off_t> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, whence, offset, &ret]()
+			{
+				ret = file_->seek(whence, offset);
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+int ServerFile::synchronize()
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return EBADF;
+
+	{
+		const auto ret = flush();
+		if (ret != 0)
+			return ret;
+	}
+
+	int ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = file_->synchronize();
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+int ServerFile::unlock()
+{
+	return fileSystem_.unlock();
+}
+
+std::pair<int, size_t> ServerFile::write(const void* const buffer, const size_t size)
+{
+	const std::lock_guard<ServerFile> lockGuard {*this};
+
+	if (file_ == nullptr)
+		return {EBADF, {}};
+
+	const auto capacity = fileSystem_.writeBufferSize_;
+	if (writeBuffer_ != nullptr && buffer != nullptr && size < capacity)
+	{
+		if (size > capacity - writeBufferUsed_)
+		{
+			const auto ret = flush();
+			if (ret != 0)
+				return {ret, {}};
+		}
+
+		memcpy(writeBuffer_.get() + writeBufferUsed_, buffer, size);
+		writeBufferUsed_ += size;
+		return {{}, size};
+	}
+
+	{
+		const auto ret = flush();
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	std::pair<int, size_t> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, buffer, size, &ret]()
+			{
+				ret = file_->write(buffer, size);
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int ServerFile::flush()
+{
+	if (writeBufferUsed_ == 0)
+		return 0;
+
+	std::pair<int, size_t> ret {};
+	const auto executeRet = fileSystem_.execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = file_->write(writeBuffer_.get(), writeBufferUsed_);
+			}));
+	const auto used = writeBufferUsed_;
+	writeBufferUsed_ = {};
+	if (executeRet != 0)
+		return executeRet;
+	if (ret.first != 0)
+		return ret.first;
+
+	// the data was already reported as written, so a short write of the buffer must not be silently ignored
+	return ret.second == used ? 0 : ENOSPC;
+}
+
+}	// namespace distortos
@@ -0,0 +1,258 @@
+/**
+ * \file
+ * \brief ServerFileSystem class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/server/ServerFileSystem.hpp"
+
+#include "distortos/FileSystem/server/ServerDirectory.hpp"
+#include "distortos/FileSystem/server/ServerFile.hpp"
+
+#include "distortos/internal/FileSystem/BoundServerRequestFunctor.hpp"
+
+#include <mutex>
+
+#include <fcntl.h>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+ServerFileSystem::~ServerFileSystem()
+{
+
+}
+
+int ServerFileSystem::formatAndMount(devices::BlockDevice* const blockDevice)
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	int ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, blockDevice, &ret]()
+			{
+				ret = fileSystem_.formatAndMount(blockDevice);
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+std::pair<int, struct stat> ServerFileSystem::getFileStatus(const char* const path)
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	std::pair<int, struct stat> ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, path, &ret]()
+			{
+				ret = fileSystem_.getFileStatus(path);
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+std::pair<int, struct statvfs> ServerFileSystem::getStatus()
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	std::pair<int, struct statvfs> ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = fileSystem_.getStatus();
+			}));
+	if (executeRet != 0)
+		return {executeRet, {}};
+
+	return ret;
+}
+
+int ServerFileSystem::lock()
+{
+	return mutex_.lock();
+}
+
+int ServerFileSystem::makeDirectory(const char* const path, const mode_t mode)
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	int ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, path, mode, &ret]()
+			{
+				ret = fileSystem_.makeDirectory(path, mode);
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+int ServerFileSystem::mount(devices::BlockDevice& blockDevice)
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	int ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, &blockDevice, &ret]()
+			{
+				ret = fileSystem_.mount(blockDevice);
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+std::pair<int, std::unique_ptr<Directory>> ServerFileSystem::openDirectory(const char* const path)
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	std::unique_ptr<ServerDirectory> directory {new (std::nothrow) ServerDirectory{*this}};
+	if (directory == nullptr)
+		return {ENOMEM, std::unique_ptr<ServerDirectory>{}};
+
+	std::pair<int, std::unique_ptr<Directory>> ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, path, &ret]()
+			{
+				ret = fileSystem_.openDirectory(path);
+			}));
+	if (executeRet != 0)
+		return {executeRet, std::unique_ptr<ServerDirectory>{}};
+	if (ret.first != 0)
+		return {ret.first, std::unique_ptr<ServerDirectory>{}};
+
+	directory->directory_ = std::move(ret.second);
+	return {0, std::move(directory)};
+}
+
+std::pair<int, std::unique_ptr<File>> ServerFileSystem::openFile(const char* const path, const int flags)
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	std::unique_ptr<ServerFile> file {new (std::nothrow) ServerFile{*this}};
+	if (file == nullptr)
+		return {ENOMEM, std::unique_ptr<ServerFile>{}};
+
+	constexpr int mask {O_RDONLY | O_WRONLY | O_RDWR};
+	if (writeBufferSize_ != 0 && (flags & mask) != O_RDONLY)
+	{
+		file->writeBuffer_.reset(new (std::nothrow) uint8_t[writeBufferSize_]);
+		if (file->writeBuffer_ == nullptr)
+			return {ENOMEM, std::unique_ptr<ServerFile>{}};
+	}
+
+	std::pair<int, std::unique_ptr<File>> ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, path, flags, &ret]()
+			{
+				ret = fileSystem_.openFile(path, flags);
+			}));
+	if (executeRet != 0)
+		return {executeRet, std::unique_ptr<ServerFile>{}};
+	if (ret.first != 0)
+		return {ret.first, std::unique_ptr<ServerFile>{}};
+
+	file->file_ = std::move(ret.second);
+	return {0, std::move(file)};
+}
+
+int ServerFileSystem::remove(const char* const path)
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	int ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, path, &ret]()
+			{
+				ret = fileSystem_.remove(path);
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+int ServerFileSystem::rename(const char* const path, const char* const newPath)
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	int ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, path, newPath, &ret]()
+			{
+				ret = fileSystem_.rename(path, newPath);
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+int ServerFileSystem::unlock()
+{
+	return mutex_.unlock();
+}
+
+int ServerFileSystem::unmount()
+{
+	const std::lock_guard<ServerFileSystem> lockGuard {*this};
+
+	int ret {};
+	const auto executeRet = execute(internal::makeBoundServerRequestFunctor(
+			[this, &ret]()
+			{
+				ret = fileSystem_.unmount();
+			}));
+	return executeRet != 0 ? executeRet : ret;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| protected functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void ServerFileSystem::requestServerExit()
+{
+	request_ = {};
+	requestSemaphore_.post();
+}
+
+void ServerFileSystem::runServer(ServerFileSystem* const fileSystem)
+{
+	while (1)
+	{
+		while (fileSystem->requestSemaphore_.wait() != 0);
+
+		if (fileSystem->request_ == nullptr)
+			return;
+
+		(*fileSystem->request_)();
+		fileSystem->completionSemaphore_.post();
+	}
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int ServerFileSystem::execute(const internal::ServerRequestFunctor& request)
+{
+	{
+		const auto ret = startServer();
+		if (ret != 0)
+			return ret;
+	}
+
+	request_ = &request;
+	{
+		const auto ret = requestSemaphore_.post();
+		if (ret != 0)
+			return ret;
+	}
+
+	while (completionSemaphore_.wait() != 0);
+
+	request_ = {};
+	return 0;
+}
+
+}	// namespace distortos
@@ -0,0 +1,134 @@
+/**
+ * \file
+ * \brief TmpDirectory class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/tmp/TmpDirectory.hpp"
+
+#include "distortos/FileSystem/tmp/TmpFileSystem.hpp"
+
+#include "distortos/assert.h"
+
+#include <mutex>
+
+#include <cstring>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+TmpDirectory::~TmpDirectory()
+{
+	close();
+}
+
+int TmpDirectory::close()
+{
+	const std::lock_guard<TmpDirectory> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return EBADF;
+
+	assert(node_->openedCount != 0);
+	--node_->openedCount;
+	node_ = {};
+	assert(fileSystem_.openedCount_ != 0);
+	--fileSystem_.openedCount_;
+	return 0;
+}
+
+std::pair<int, off_t> TmpDirectory::getPosition()
+{
+	const std::lock_guard<TmpDirectory> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return {EBADF, {}};
+
+	return {{}, static_cast<off_t>(position_)};
+}
+
+int TmpDirectory::lock()
+{
+	return fileSystem_.lock();
+}
+
+std::pair<int, struct dirent> TmpDirectory::read()
+{
+	const std::lock_guard<TmpDirectory> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return {EBADF, {}};
+
+	dirent directoryEntry {};
+	if (position_ < 2)
+		strcpy(directoryEntry.d_name, position_ == 0 ? "." : "..");
+	else
+	{
+		const auto node = fileSystem_.storage_.getChild(*node_, cursor_, position_ - 2);
+		if (node == nullptr)
+			return {ENOENT, {}};
+
+		// length of name was verified when the node was created
+		strcpy(directoryEntry.d_name, node->name);
+	}
+
+	++position_;
+	return {{}, directoryEntry};
+}
+
+int TmpDirectory::rewind()
+{
+	const std::lock_guard<TmpDirectory> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return EBADF;
+
+	position_ = {};
+	return 0;
+}
+
+int TmpDirectory::seek(const off_t position)
+{
+	const std::lock_guard<TmpDirectory> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return EBADF;
+
+	if (position < 0)
+		return EINVAL;
+
+	position_ = position;
+	return 0;
+}
+
+int TmpDirectory::unlock()
+{
+	return fileSystem_.unlock();
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void TmpDirectory::open(internal::TmpNode& node)
+{
+	assert(node_ == nullptr);
+	assert(node.directory == true);
+
+	cursor_ = {};
+	node_ = &node;
+	position_ = {};
+	++node.openedCount;
+	++fileSystem_.openedCount_;
+}
+
+}	// namespace distortos
@@ -0,0 +1,191 @@
+/**
+ * \file
+ * \brief TmpFile class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/tmp/TmpFile.hpp"
+
+#include "distortos/FileSystem/tmp/TmpFileSystem.hpp"
+
+#include "distortos/assert.h"
+
+#include <mutex>
+
+#include <fcntl.h>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+TmpFile::~TmpFile()
+{
+	close();
+}
+
+int TmpFile::close()
+{
+	const std::lock_guard<TmpFile> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return EBADF;
+
+	assert(node_->openedCount != 0);
+	--node_->openedCount;
+	node_ = {};
+	assert(fileSystem_.openedCount_ != 0);
+	--fileSystem_.openedCount_;
+	return 0;
+}
+
+std::pair<int, off_t> TmpFile::getPosition()
+{
+	const std::lock_guard<TmpFile> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return {EBADF, {}};
+
+	return {{}, position_};
+}
+
+std::pair<int, off_t> TmpFile::getSize()
+{
+	const std::lock_guard<TmpFile> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return {EBADF, {}};
+
+	return {{}, static_cast<off_t>(node_->size)};
+}
+
+std::pair<int, struct stat> TmpFile::getStatus()
+{
+	const auto ret = getSize();
+	if (ret.first != 0)
+		return {ret.first, {}};
+
+	struct stat status {};
+	status.st_mode = S_IFREG;
+	status.st_size = ret.second;
+	return {{}, status};
+}
+
+std::pair<int, bool> TmpFile::isATerminal()
+{
+	const std::lock_guard<TmpFile> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return {EBADF, {}};
+
+	return {{}, {}};
+}
+
+int TmpFile::lock()
+{
+	return fileSystem_.lock();
+}
+
+std::pair<int, size_t> TmpFile::read(void* const buffer, const size_t size)
+{
+	const std::lock_guard<TmpFile> lockGuard {*this};
+
+	if (node_ == nullptr || readable_ == false)
+		return {EBADF, {}};
+
+	if (buffer == nullptr && size != 0)
+		return {EINVAL, {}};
+
+	const auto readSize = fileSystem_.storage_.read(*node_, cursor_, position_, buffer, size);
+	position_ += readSize;
+	return {{}, readSize};
+}
+
+int TmpFile::rewind()
+{
+	const std::lock_guard<TmpFile> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return EBADF;
+
+	position_ = {};
+	return 0;
+}
+
+std::pair<int, off_t> TmpFile::seek(const Whence whence, const off_t offset)
+{
+	const std::lock_guard<TmpFile> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return {EBADF, {}};
+
+	const off_t base {whence == Whence::beginning ? 0 : whence == Whence::current ? position_ :
+			static_cast<off_t>(node_->size)};
+	if (offset < -base)
+		return {EINVAL, {}};
+
+	position_ = base + offset;
+	return {{}, position_};
+}
+
+int TmpFile::synchronize()
+{
+	const std::lock_guard<TmpFile> lockGuard {*this};
+
+	if (node_ == nullptr)
+		return EBADF;
+
+	return 0;
+}
+
+int TmpFile::unlock()
+{
+	return fileSystem_.unlock();
+}
+
+std::pair<int, size_t> TmpFile::write(const void* const buffer, const size_t size)
+{
+	const std::lock_guard<TmpFile> lockGuard {*this};
+
+	if (node_ == nullptr || writable_ == false)
+		return {EBADF, {}};
+
+	if (buffer == nullptr && size != 0)
+		return {EINVAL, {}};
+
+	if (append_ == true)
+		position_ = node_->size;
+
+	const auto ret = fileSystem_.storage_.write(*node_, cursor_, position_, buffer, size);
+	position_ += ret.second;
+	return ret;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void TmpFile::open(internal::TmpNode& node, const int flags)
+{
+	assert(node_ == nullptr);
+	assert(node.directory == false);
+
+	const auto accessMode = flags & (O_RDONLY | O_WRONLY | O_RDWR);
+	cursor_ = {};
+	node_ = &node;
+	position_ = {};
+	append_ = (flags & O_APPEND) != 0;
+	readable_ = accessMode != O_WRONLY;
+	writable_ = accessMode != O_RDONLY;
+	++node.openedCount;
+	++fileSystem_.openedCount_;
+}
+
+}	// namespace distortos
@@ -0,0 +1,187 @@
+/**
+ * \file
+ * \brief TmpFileSystem class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/tmp/TmpFileSystem.hpp"
+
+#include "distortos/FileSystem/tmp/TmpDirectory.hpp"
+#include "distortos/FileSystem/tmp/TmpFile.hpp"
+
+#include <mutex>
+
+#include <fcntl.h>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+TmpFileSystem::~TmpFileSystem()
+{
+	unmount();
+}
+
+int TmpFileSystem::formatAndMount(devices::BlockDevice*)
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	{
+		const auto ret = unmount();
+		if (ret != 0 && ret != EBADF)
+			return ret;
+	}
+
+	return mount();
+}
+
+std::pair<int, struct stat> TmpFileSystem::getFileStatus(const char* const path)
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	const auto ret = storage_.find(path);
+	if (ret.first != 0)
+		return {ret.first, {}};
+
+	struct stat status {};
+	const auto node = ret.second;
+	status.st_mode = node->directory == true ? S_IFDIR : S_IFREG;
+	if (node->directory == false)
+		status.st_size = node->size;
+	return {{}, status};
+}
+
+std::pair<int, struct statvfs> TmpFileSystem::getStatus()
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	if (storage_.isMounted() == false)
+		return {EBADF, {}};
+
+	struct statvfs status {};
+	status.f_bsize = storage_.getChunkSize();
+	status.f_frsize = status.f_bsize;
+	status.f_blocks = storage_.getChunksLimit();
+	status.f_bfree = storage_.getChunksLimit() - storage_.getUsedChunks();
+	status.f_bavail = status.f_bfree;
+	status.f_namemax = sizeof(dirent::d_name) - 1;
+	return {{}, status};
+}
+
+int TmpFileSystem::lock()
+{
+	return mutex_.lock();
+}
+
+int TmpFileSystem::makeDirectory(const char* const path, mode_t)
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	return storage_.create(path, true).first;
+}
+
+int TmpFileSystem::mount(devices::BlockDevice&)
+{
+	return ENOTSUP;
+}
+
+int TmpFileSystem::mount()
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	return storage_.mount();
+}
+
+std::pair<int, std::unique_ptr<Directory>> TmpFileSystem::openDirectory(const char* const path)
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	const auto ret = storage_.find(path);
+	if (ret.first != 0)
+		return {ret.first, std::unique_ptr<TmpDirectory>{}};
+	if (ret.second->directory == false)
+		return {ENOTDIR, std::unique_ptr<TmpDirectory>{}};
+
+	std::unique_ptr<TmpDirectory> directory {new (std::nothrow) TmpDirectory{*this}};
+	if (directory == nullptr)
+		return {ENOMEM, std::unique_ptr<TmpDirectory>{}};
+
+	directory->open(*ret.second);
+	return {0, std::move(directory)};
+}
+
+std::pair<int, std::unique_ptr<File>> TmpFileSystem::openFile(const char* const path, const int flags)
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	constexpr int mask {O_RDONLY | O_WRONLY | O_RDWR};
+	const auto accessMode = flags & mask;
+	if (accessMode != O_RDONLY && accessMode != O_WRONLY && accessMode != O_RDWR)
+		return {EINVAL, std::unique_ptr<TmpFile>{}};
+
+	// allocate file first, so that failure does not leave newly created node behind
+	std::unique_ptr<TmpFile> file {new (std::nothrow) TmpFile{*this}};
+	if (file == nullptr)
+		return {ENOMEM, std::unique_ptr<TmpFile>{}};
+
+	auto ret = storage_.find(path);
+	if (ret.first == ENOENT && (flags & O_CREAT) != 0)
+		ret = storage_.create(path, false);
+	else if (ret.first == 0 && (flags & O_CREAT) != 0 && (flags & O_EXCL) != 0)
+		return {EEXIST, std::unique_ptr<TmpFile>{}};
+	if (ret.first != 0)
+		return {ret.first, std::unique_ptr<TmpFile>{}};
+
+	const auto node = ret.second;
+	if (node->directory == true)
+		return {EISDIR, std::unique_ptr<TmpFile>{}};
+
+	if ((flags & O_TRUNC) != 0 && accessMode != O_RDONLY)
+		storage_.truncate(*node);
+
+	file->open(*node, flags);
+	return {0, std::move(file)};
+}
+
+int TmpFileSystem::remove(const char* const path)
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	return storage_.remove(path);
+}
+
+int TmpFileSystem::rename(const char* const path, const char* const newPath)
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	return storage_.rename(path, newPath);
+}
+
+int TmpFileSystem::unlock()
+{
+	return mutex_.unlock();
+}
+
+int TmpFileSystem::unmount()
+{
+	const std::lock_guard<TmpFileSystem> lockGuard {*this};
+
+	if (storage_.isMounted() == false)
+		return EBADF;
+
+	if (openedCount_ != 0)
+		return EBUSY;
+
+	storage_.unmount();
+	return 0;
+}
+
+}	// namespace distortos
@@ -0,0 +1,500 @@
+/**
+ * \file
+ * \brief TmpStorage class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/FileSystem/TmpStorage.hpp"
+
+#include "distortos/assert.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <new>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// max length of name of file or directory, bytes
+constexpr size_t nameMax {sizeof(dirent::d_name) - 1};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+std::pair<int, TmpNode*> TmpStorage::create(const char* const path, const bool directory)
+{
+	LookUpResult result;
+	{
+		const auto ret = lookUp(path, result);
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	if (result.node != nullptr)
+		return {EEXIST, {}};
+	if (directory == false && result.directoryRequired == true)
+		return {ENOTDIR, {}};
+
+	assert(result.parent != nullptr && result.name != nullptr);
+
+	const auto node = new (std::nothrow) TmpNode{};
+	if (node == nullptr)
+		return {ENOMEM, {}};
+
+	node->name = new (std::nothrow) char[result.nameLength + 1];
+	if (node->name == nullptr)
+	{
+		delete node;
+		return {ENOMEM, {}};
+	}
+
+	memcpy(node->name, result.name, result.nameLength);
+	node->name[result.nameLength] = '\0';
+	node->directory = directory;
+	link(*result.parent, *node);
+	return {{}, node};
+}
+
+std::pair<int, TmpNode*> TmpStorage::find(const char* const path)
+{
+	LookUpResult result;
+	{
+		const auto ret = lookUp(path, result);
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	if (result.node == nullptr)
+		return {ENOENT, {}};
+	if (result.directoryRequired == true && result.node->directory == false)
+		return {ENOTDIR, {}};
+
+	return {{}, result.node};
+}
+
+TmpNode* TmpStorage::getChild(TmpNode& directory, TmpCursor<TmpNode>& cursor, const size_t index) const
+{
+	if (cursor.element == nullptr || cursor.generation != directory.generation || cursor.index > index)
+		cursor = {directory.firstChild, {}, directory.generation};
+
+	while (cursor.element != nullptr && cursor.index < index)
+	{
+		cursor.element = cursor.element->nextSibling;
+		++cursor.index;
+	}
+
+	return cursor.element;
+}
+
+int TmpStorage::mount()
+{
+	if (mounted_ == true)
+		return EBUSY;
+
+	if (chunkSize_ <= sizeof(TmpChunk) || chunkSize_ % alignof(TmpChunk) != 0)
+		return EINVAL;
+
+	if (pool_ != nullptr)
+	{
+		if (reinterpret_cast<uintptr_t>(pool_) % alignof(TmpChunk) != 0 || sizeLimit_ < chunkSize_)
+			return EINVAL;
+
+		chunksLimit_ = sizeLimit_ / chunkSize_;
+	}
+	else
+		chunksLimit_ = sizeLimit_ != 0 ? sizeLimit_ / chunkSize_ : SIZE_MAX;
+
+	root_ = {};
+	root_.directory = true;
+	freeChunks_ = {};
+	poolUsed_ = {};
+	usedChunks_ = {};
+	mounted_ = true;
+	return 0;
+}
+
+size_t TmpStorage::read(TmpNode& file, TmpCursor<TmpChunk>& cursor, const size_t position, void* const buffer,
+		const size_t size) const
+{
+	if (position >= file.size)
+		return 0;
+
+	const auto payloadSize = getPayloadSize();
+	const auto readSize = std::min(size, file.size - position);
+	const auto bufferChar = static_cast<char*>(buffer);
+	size_t done {};
+	while (done < readSize)
+	{
+		const auto offset = (position + done) % payloadSize;
+		const auto chunk = getChunk(file, cursor, (position + done) / payloadSize);
+		const auto chunkSize = std::min(payloadSize - offset, readSize - done);
+		memcpy(bufferChar + done, reinterpret_cast<const char*>(chunk + 1) + offset, chunkSize);
+		done += chunkSize;
+	}
+
+	return readSize;
+}
+
+int TmpStorage::remove(const char* const path)
+{
+	LookUpResult result;
+	{
+		const auto ret = lookUp(path, result);
+		if (ret != 0)
+			return ret;
+	}
+
+	const auto node = result.node;
+	if (node == nullptr)
+		return ENOENT;
+	if (result.name == nullptr)
+		return EINVAL;
+	if (result.directoryRequired == true && node->directory == false)
+		return ENOTDIR;
+	if (node->openedCount != 0)
+		return EBUSY;
+	if (node->firstChild != nullptr)
+		return ENOTEMPTY;
+
+	unlink(*node);
+	destroy(*node);
+	return 0;
+}
+
+int TmpStorage::rename(const char* const path, const char* const newPath)
+{
+	LookUpResult result;
+	{
+		const auto ret = lookUp(path, result);
+		if (ret != 0)
+			return ret;
+	}
+
+	const auto node = result.node;
+	if (node == nullptr)
+		return ENOENT;
+	if (result.name == nullptr)
+		return EINVAL;
+	if (result.directoryRequired == true && node->directory == false)
+		return ENOTDIR;
+
+	LookUpResult newResult;
+	{
+		const auto ret = lookUp(newPath, newResult);
+		if (ret != 0)
+			return ret;
+	}
+
+	if (newResult.node == node)
+		return 0;
+	if (newResult.node != nullptr)
+		return EEXIST;
+	if (newResult.directoryRequired == true && node->directory == false)
+		return ENOTDIR;
+
+	for (auto directory = newResult.parent; directory != nullptr; directory = directory->parent)
+		if (directory == node)
+			return EINVAL;
+
+	const auto name = new (std::nothrow) char[newResult.nameLength + 1];
+	if (name == nullptr)
+		return ENOMEM;
+
+	memcpy(name, newResult.name, newResult.nameLength);
+	name[newResult.nameLength] = '\0';
+	delete[] node->name;
+	node->name = name;
+	unlink(*node);
+	link(*newResult.parent, *node);
+	return 0;
+}
+
+void TmpStorage::truncate(TmpNode& file)
+{
+	while (file.firstChunk != nullptr)
+	{
+		const auto chunk = file.firstChunk;
+		file.firstChunk = chunk->next;
+		releaseChunk(chunk);
+	}
+
+	file.lastChunk = {};
+	file.chunksCount = {};
+	file.size = {};
+	++file.generation;
+}
+
+void TmpStorage::unmount()
+{
+	if (mounted_ == false)
+		return;
+
+	while (root_.firstChild != nullptr)
+	{
+		const auto node = root_.firstChild;
+		unlink(*node);
+		destroy(*node);
+	}
+
+	if (pool_ == nullptr)
+		while (freeChunks_ != nullptr)
+		{
+			const auto chunk = freeChunks_;
+			freeChunks_ = chunk->next;
+			::operator delete(chunk);
+		}
+
+	freeChunks_ = {};
+	mounted_ = {};
+}
+
+std::pair<int, size_t> TmpStorage::write(TmpNode& file, TmpCursor<TmpChunk>& cursor, const size_t position,
+		const void* const buffer, const size_t size)
+{
+	if (size == 0)
+		return {{}, {}};
+	if (position > SIZE_MAX - size)
+		return {ENOSPC, {}};
+
+	if (position > file.size)
+	{
+		const auto ret = program(file, cursor, file.size, nullptr, position - file.size);
+		if (ret.first != 0)
+			return {ret.first, {}};
+	}
+
+	return program(file, cursor, position, static_cast<const char*>(buffer), size);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+TmpChunk* TmpStorage::allocateChunk()
+{
+	if (usedChunks_ >= chunksLimit_)
+		return nullptr;
+
+	TmpChunk* chunk;
+	if (freeChunks_ != nullptr)
+	{
+		chunk = freeChunks_;
+		freeChunks_ = chunk->next;
+	}
+	else if (pool_ != nullptr)
+	{
+		chunk = reinterpret_cast<TmpChunk*>(pool_ + poolUsed_);
+		poolUsed_ += chunkSize_;
+	}
+	else
+	{
+		chunk = static_cast<TmpChunk*>(::operator new(chunkSize_, std::nothrow));
+		if (chunk == nullptr)
+			return nullptr;
+	}
+
+	++usedChunks_;
+	chunk->next = {};
+	return chunk;
+}
+
+void TmpStorage::destroy(TmpNode& node)
+{
+	while (node.firstChild != nullptr)
+	{
+		const auto child = node.firstChild;
+		unlink(*child);
+		destroy(*child);
+	}
+
+	truncate(node);
+	delete[] node.name;
+	delete &node;
+}
+
+int TmpStorage::extend(TmpNode& file, const size_t chunksCount)
+{
+	while (file.chunksCount < chunksCount)
+	{
+		const auto chunk = allocateChunk();
+		if (chunk == nullptr)
+			return ENOSPC;
+
+		if (file.lastChunk != nullptr)
+			file.lastChunk->next = chunk;
+		else
+			file.firstChunk = chunk;
+		file.lastChunk = chunk;
+		++file.chunksCount;
+	}
+
+	return 0;
+}
+
+TmpChunk* TmpStorage::getChunk(TmpNode& file, TmpCursor<TmpChunk>& cursor, const size_t index) const
+{
+	assert(index < file.chunksCount);
+
+	// appending to the file is the most common case
+	if (index == file.chunksCount - 1)
+		return file.lastChunk;
+
+	if (cursor.element == nullptr || cursor.generation != file.generation || cursor.index > index)
+		cursor = {file.firstChunk, {}, file.generation};
+
+	while (cursor.index < index)
+	{
+		cursor.element = cursor.element->next;
+		++cursor.index;
+	}
+
+	return cursor.element;
+}
+
+void TmpStorage::link(TmpNode& directory, TmpNode& node)
+{
+	node.parent = &directory;
+	node.nextSibling = directory.firstChild;
+	directory.firstChild = &node;
+	++directory.generation;
+}
+
+int TmpStorage::lookUp(const char* path, LookUpResult& result)
+{
+	if (mounted_ == false)
+		return EBADF;
+	if (path == nullptr)
+		return EINVAL;
+
+	result = {};
+	result.node = &root_;
+	while (1)
+	{
+		while (*path == '/')
+			++path;
+		if (*path == '\0')
+			return 0;
+
+		const auto directory = result.node;
+		if (directory == nullptr)
+			return ENOENT;
+		if (directory->directory == false)
+			return ENOTDIR;
+
+		auto end = path;
+		while (*end != '\0' && *end != '/')
+			++end;
+
+		const auto length = static_cast<size_t>(end - path);
+		if (length > nameMax)
+			return ENAMETOOLONG;
+
+		result.directoryRequired = *end == '/';
+		if (length == 1 && path[0] == '.')
+		{
+			result.parent = {};
+			result.name = {};
+		}
+		else if (length == 2 && path[0] == '.' && path[1] == '.')
+		{
+			result.parent = {};
+			result.node = directory->parent != nullptr ? directory->parent : directory;
+			result.name = {};
+		}
+		else
+		{
+			result.parent = directory;
+			result.node = directory->firstChild;
+			while (result.node != nullptr &&
+					(strncmp(result.node->name, path, length) != 0 || result.node->name[length] != '\0'))
+				result.node = result.node->nextSibling;
+			result.name = path;
+			result.nameLength = length;
+		}
+
+		path = end;
+	}
+}
+
+std::pair<int, size_t> TmpStorage::program(TmpNode& file, TmpCursor<TmpChunk>& cursor, const size_t position,
+		const char* const buffer, const size_t size)
+{
+	assert(position <= file.size);
+
+	const auto payloadSize = getPayloadSize();
+	const auto extendRet = extend(file, (position + size - 1) / payloadSize + 1);
+	const auto capacity = file.chunksCount * payloadSize;
+	const auto programSize = extendRet == 0 ? size : capacity > position ? std::min(size, capacity - position) : 0;
+	size_t done {};
+	while (done < programSize)
+	{
+		const auto offset = (position + done) % payloadSize;
+		const auto chunk = getChunk(file, cursor, (position + done) / payloadSize);
+		const auto chunkSize = std::min(payloadSize - offset, programSize - done);
+		const auto destination = reinterpret_cast<char*>(chunk + 1) + offset;
+		if (buffer != nullptr)
+			memcpy(destination, buffer + done, chunkSize);
+		else
+			memset(destination, 0, chunkSize);
+		done += chunkSize;
+	}
+
+	file.size = std::max(file.size, position + done);
+	return {extendRet, done};
+}
+
+void TmpStorage::releaseChunk(TmpChunk* const chunk)
+{
+	assert(usedChunks_ != 0);
+	--usedChunks_;
+
+	if (pool_ == nullptr)
+	{
+		::operator delete(chunk);
+		return;
+	}
+
+	chunk->next = freeChunks_;
+	freeChunks_ = chunk;
+}
+
+void TmpStorage::unlink(TmpNode& node)
+{
+	const auto directory = node.parent;
+	assert(directory != nullptr);
+
+	auto next = &directory->firstChild;
+	while (*next != &node)
+		next = &(*next)->nextSibling;
+	*next = node.nextSibling;
+	node.parent = {};
+	node.nextSibling = {};
+	++directory->generation;
+}
+
+}	// namespace internal
+
+}	// namespace distortos
@@ -0,0 +1,129 @@
+/**
+ * \file
+ * \brief XipDirectory class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/xip/XipDirectory.hpp"
+
+#include "distortos/FileSystem/xip/XipFileSystem.hpp"
+
+#include "distortos/assert.h"
+
+#include <mutex>
+
+#include <cstring>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+XipDirectory::~XipDirectory()
+{
+	close();
+}
+
+int XipDirectory::close()
+{
+	const std::lock_guard<XipDirectory> lockGuard {*this};
+
+	if (opened_ == false)
+		return EBADF;
+
+	opened_ = {};
+	assert(fileSystem_.openedCount_ != 0);
+	--fileSystem_.openedCount_;
+	return 0;
+}
+
+std::pair<int, off_t> XipDirectory::getPosition()
+{
+	const std::lock_guard<XipDirectory> lockGuard {*this};
+
+	if (opened_ == false)
+		return {EBADF, {}};
+
+	return {{}, static_cast<off_t>(position_)};
+}
+
+int XipDirectory::lock()
+{
+	return fileSystem_.lock();
+}
+
+std::pair<int, struct dirent> XipDirectory::read()
+{
+	const std::lock_guard<XipDirectory> lockGuard {*this};
+
+	if (opened_ == false)
+		return {EBADF, {}};
+
+	const auto entry = first_ + position_;
+	if (entry >= last_)
+		return {ENOENT, {}};
+
+	// skip all descendants of subdirectory, so that next read returns next entry of this directory
+	position_ += 1 + (entry->type == internal::XipImage::directoryType ? entry->size : 0);
+
+	dirent directoryEntry {};
+	// length of name was verified when the image was mounted
+	strcpy(directoryEntry.d_name, fileSystem_.image_.getName(*entry));
+	return {{}, directoryEntry};
+}
+
+int XipDirectory::rewind()
+{
+	const std::lock_guard<XipDirectory> lockGuard {*this};
+
+	if (opened_ == false)
+		return EBADF;
+
+	position_ = {};
+	return 0;
+}
+
+int XipDirectory::seek(const off_t position)
+{
+	const std::lock_guard<XipDirectory> lockGuard {*this};
+
+	if (opened_ == false)
+		return EBADF;
+
+	if (position < 0 || position > last_ - first_)
+		return EINVAL;
+
+	position_ = position;
+	return 0;
+}
+
+int XipDirectory::unlock()
+{
+	return fileSystem_.unlock();
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void XipDirectory::open(const internal::XipImage::Entry& entry)
+{
+	assert(opened_ == false);
+	assert(entry.type == internal::XipImage::directoryType);
+
+	const auto descendants = fileSystem_.image_.getDescendants(entry);
+	first_ = descendants.first;
+	last_ = descendants.second;
+	position_ = {};
+	opened_ = true;
+	++fileSystem_.openedCount_;
+}
+
+}	// namespace distortos
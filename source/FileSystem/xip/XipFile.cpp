@@ -0,0 +1,186 @@
+/**
+ * \file
+ * \brief XipFile class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/xip/XipFile.hpp"
+
+#include "distortos/FileSystem/xip/XipFileSystem.hpp"
+
+#include "distortos/assert.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <cstring>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+XipFile::~XipFile()
+{
+	close();
+}
+
+int XipFile::close()
+{
+	const std::lock_guard<XipFile> lockGuard {*this};
+
+	if (opened_ == false)
+		return EBADF;
+
+	opened_ = {};
+	assert(fileSystem_.openedCount_ != 0);
+	--fileSystem_.openedCount_;
+	return 0;
+}
+
+std::pair<int, const void*> XipFile::getData()
+{
+	const std::lock_guard<XipFile> lockGuard {*this};
+
+	if (opened_ == false)
+		return {EBADF, {}};
+
+	return {{}, data_};
+}
+
+std::pair<int, off_t> XipFile::getPosition()
+{
+	const std::lock_guard<XipFile> lockGuard {*this};
+
+	if (opened_ == false)
+		return {EBADF, {}};
+
+	return {{}, position_};
+}
+
+std::pair<int, off_t> XipFile::getSize()
+{
+	const std::lock_guard<XipFile> lockGuard {*this};
+
+	if (opened_ == false)
+		return {EBADF, {}};
+
+	return {{}, static_cast<off_t>(size_)};
+}
+
+std::pair<int, struct stat> XipFile::getStatus()
+{
+	const auto ret = getSize();
+	if (ret.first != 0)
+		return {ret.first, {}};
+
+	struct stat status {};
+	status.st_mode = S_IFREG;
+	status.st_size = ret.second;
+	return {{}, status};
+}
+
+std::pair<int, bool> XipFile::isATerminal()
+{
+	const std::lock_guard<XipFile> lockGuard {*this};
+
+	if (opened_ == false)
+		return {EBADF, {}};
+
+	return {{}, {}};
+}
+
+int XipFile::lock()
+{
+	return fileSystem_.lock();
+}
+
+std::pair<int, size_t> XipFile::read(void* const buffer, const size_t size)
+{
+	const std::lock_guard<XipFile> lockGuard {*this};
+
+	if (opened_ == false)
+		return {EBADF, {}};
+
+	if (buffer == nullptr && size != 0)
+		return {EINVAL, {}};
+
+	if (static_cast<size_t>(position_) >= size_)
+		return {{}, {}};
+
+	const auto readSize = std::min(size, size_ - static_cast<size_t>(position_));
+	memcpy(buffer, data_ + position_, readSize);
+	position_ += readSize;
+	return {{}, readSize};
+}
+
+int XipFile::rewind()
+{
+	const std::lock_guard<XipFile> lockGuard {*this};
+
+	if (opened_ == false)
+		return EBADF;
+
+	position_ = {};
+	return 0;
+}
+
+std::pair<int, off_t> XipFile::seek(const Whence whence, const off_t offset)
+{
+	const std::lock_guard<XipFile> lockGuard {*this};
+
+	if (opened_ == false)
+		return {EBADF, {}};
+
+	const off_t base {whence == Whence::beginning ? 0 : whence == Whence::current ? position_ :
+			static_cast<off_t>(size_)};
+	if (offset < -base)
+		return {EINVAL, {}};
+
+	position_ = base + offset;
+	return {{}, position_};
+}
+
+int XipFile::synchronize()
+{
+	const std::lock_guard<XipFile> lockGuard {*this};
+
+	if (opened_ == false)
+		return EBADF;
+
+	return 0;
+}
+
+int XipFile::unlock()
+{
+	return fileSystem_.unlock();
+}
+
+std::pair<int, size_t> XipFile::write(const void*, size_t)
+{
+	return {EBADF, {}};
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void XipFile::open(const uint8_t* const data, const size_t size)
+{
+	assert(opened_ == false);
+
+	data_ = data;
+	size_ = size;
+	position_ = {};
+	opened_ = true;
+	++fileSystem_.openedCount_;
+}
+
+}	// namespace distortos
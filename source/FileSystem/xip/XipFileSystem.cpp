@@ -0,0 +1,193 @@
+/**
+ * \file
+ * \brief XipFileSystem class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/xip/XipFileSystem.hpp"
+
+#include "distortos/FileSystem/xip/XipDirectory.hpp"
+#include "distortos/FileSystem/xip/XipFile.hpp"
+
+#include <mutex>
+
+#include <fcntl.h>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+XipFileSystem::~XipFileSystem()
+{
+	unmount();
+}
+
+int XipFileSystem::formatAndMount(devices::BlockDevice*)
+{
+	return EROFS;
+}
+
+std::pair<int, struct stat> XipFileSystem::getFileStatus(const char* const path)
+{
+	const std::lock_guard<XipFileSystem> lockGuard {*this};
+
+	if (image_.isMounted() == false)
+		return {EBADF, {}};
+
+	const auto ret = image_.find(path);
+	if (ret.first != 0)
+		return {ret.first, {}};
+
+	struct stat status {};
+	const auto entry = ret.second;
+	status.st_mode = entry->type == internal::XipImage::directoryType ? S_IFDIR : S_IFREG;
+	if (entry->type == internal::XipImage::fileType)
+		status.st_size = entry->size;
+	return {{}, status};
+}
+
+std::pair<int, struct statvfs> XipFileSystem::getStatus()
+{
+	const std::lock_guard<XipFileSystem> lockGuard {*this};
+
+	if (image_.isMounted() == false)
+		return {EBADF, {}};
+
+	struct statvfs status {};
+	status.f_bsize = 1;
+	status.f_frsize = status.f_bsize;
+	status.f_blocks = image_.getImageSize();
+	status.f_files = image_.getEntriesCount();
+	status.f_flag = ST_RDONLY;
+	status.f_namemax = sizeof(dirent::d_name) - 1;
+	return {{}, status};
+}
+
+int XipFileSystem::lock()
+{
+	return mutex_.lock();
+}
+
+int XipFileSystem::makeDirectory(const char*, mode_t)
+{
+	const std::lock_guard<XipFileSystem> lockGuard {*this};
+
+	if (image_.isMounted() == false)
+		return EBADF;
+
+	return EROFS;
+}
+
+int XipFileSystem::mount(devices::BlockDevice&)
+{
+	return ENOTSUP;
+}
+
+int XipFileSystem::mount(const void* const image, const size_t size)
+{
+	const std::lock_guard<XipFileSystem> lockGuard {*this};
+
+	return image_.mount(image, size);
+}
+
+std::pair<int, std::unique_ptr<Directory>> XipFileSystem::openDirectory(const char* const path)
+{
+	const std::lock_guard<XipFileSystem> lockGuard {*this};
+
+	if (image_.isMounted() == false)
+		return {EBADF, std::unique_ptr<XipDirectory>{}};
+
+	const auto ret = image_.find(path);
+	if (ret.first != 0)
+		return {ret.first, std::unique_ptr<XipDirectory>{}};
+	if (ret.second->type != internal::XipImage::directoryType)
+		return {ENOTDIR, std::unique_ptr<XipDirectory>{}};
+
+	std::unique_ptr<XipDirectory> directory {new (std::nothrow) XipDirectory{*this}};
+	if (directory == nullptr)
+		return {ENOMEM, std::unique_ptr<XipDirectory>{}};
+
+	directory->open(*ret.second);
+	return {{}, std::move(directory)};
+}
+
+std::pair<int, std::unique_ptr<File>> XipFileSystem::openFile(const char* const path, const int flags)
+{
+	const std::lock_guard<XipFileSystem> lockGuard {*this};
+
+	if (image_.isMounted() == false)
+		return {EBADF, std::unique_ptr<XipFile>{}};
+
+	constexpr int mask {O_RDONLY | O_WRONLY | O_RDWR};
+	const auto accessMode = flags & mask;
+	if (accessMode != O_RDONLY && accessMode != O_WRONLY && accessMode != O_RDWR)
+		return {EINVAL, std::unique_ptr<XipFile>{}};
+
+	const auto ret = image_.find(path);
+	if (ret.first == ENOENT && (flags & O_CREAT) != 0)
+		return {EROFS, std::unique_ptr<XipFile>{}};
+	if (ret.first != 0)
+		return {ret.first, std::unique_ptr<XipFile>{}};
+	if (ret.second->type != internal::XipImage::fileType)
+		return {EISDIR, std::unique_ptr<XipFile>{}};
+	if ((flags & O_CREAT) != 0 && (flags & O_EXCL) != 0)
+		return {EEXIST, std::unique_ptr<XipFile>{}};
+	if (accessMode != O_RDONLY || (flags & O_TRUNC) != 0)
+		return {EROFS, std::unique_ptr<XipFile>{}};
+
+	std::unique_ptr<XipFile> file {new (std::nothrow) XipFile{*this}};
+	if (file == nullptr)
+		return {ENOMEM, std::unique_ptr<XipFile>{}};
+
+	file->open(image_.getData(*ret.second), ret.second->size);
+	return {{}, std::move(file)};
+}
+
+int XipFileSystem::remove(const char*)
+{
+	const std::lock_guard<XipFileSystem> lockGuard {*this};
+
+	if (image_.isMounted() == false)
+		return EBADF;
+
+	return EROFS;
+}
+
+int XipFileSystem::rename(const char*, const char*)
+{
+	const std::lock_guard<XipFileSystem> lockGuard {*this};
+
+	if (image_.isMounted() == false)
+		return EBADF;
+
+	return EROFS;
+}
+
+int XipFileSystem::unlock()
+{
+	return mutex_.unlock();
+}
+
+int XipFileSystem::unmount()
+{
+	const std::lock_guard<XipFileSystem> lockGuard {*this};
+
+	if (image_.isMounted() == false)
+		return EBADF;
+
+	if (openedCount_ != 0)
+		return EBUSY;
+
+	image_.unmount();
+	return 0;
+}
+
+}	// namespace distortos
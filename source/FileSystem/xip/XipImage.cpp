@@ -0,0 +1,284 @@
+/**
+ * \file
+ * \brief XipImage class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/FileSystem/XipImage.hpp"
+
+#include "distortos/internal/storage/updateCrc32.hpp"
+
+#include <dirent.h>
+
+#include <algorithm>
+
+#include <cerrno>
+#include <cstring>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// header of image
+struct Header
+{
+	/// magic value, always `magic`
+	uint32_t magic;
+
+	/// CRC-32 of metadata, starting from `imageSize` field
+	uint32_t crc;
+
+	/// size of image, bytes
+	uint32_t imageSize;
+
+	/// size of metadata - header, table of entries and paths, bytes
+	uint32_t metadataSize;
+
+	/// number of entries in the table of entries
+	uint32_t entriesCount;
+};
+
+static_assert(sizeof(Header) == 20, "Invalid size of Header!");
+static_assert(sizeof(XipImage::Entry) == 16, "Invalid size of XipImage::Entry!");
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// magic value of image - "XIP1"
+constexpr uint32_t magic {0x31504958};
+
+/// offset of first byte protected by Header::crc
+constexpr size_t crcProtectedOffset {offsetof(Header, imageSize)};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Compares two paths in the order used by the table of entries.
+ *
+ * The paths are compared as strings of unsigned characters, with '/' ordered before all other characters.
+ *
+ * \param [in] left is the first path
+ * \param [in] leftLength is the length of \a left, bytes
+ * \param [in] right is the second path
+ * \param [in] rightLength is the length of \a right, bytes
+ *
+ * \return negative value if \a left is ordered before \a right, 0 if both paths are equal, positive value otherwise
+ */
+
+int comparePaths(const char* const left, const size_t leftLength, const char* const right, const size_t rightLength)
+{
+	const auto length = std::min(leftLength, rightLength);
+	for (size_t i {}; i < length; ++i)
+	{
+		const auto leftCharacter = left[i] == '/' ? 0 : static_cast<uint8_t>(left[i]);
+		const auto rightCharacter = right[i] == '/' ? 0 : static_cast<uint8_t>(right[i]);
+		if (leftCharacter != rightCharacter)
+			return leftCharacter < rightCharacter ? -1 : 1;
+	}
+
+	return leftLength < rightLength ? -1 : leftLength > rightLength ? 1 : 0;
+}
+
+/**
+ * \brief Tests whether path is a descendant of directory.
+ *
+ * \param [in] directory is the path of directory
+ * \param [in] directoryLength is the length of \a directory, bytes
+ * \param [in] path is the tested path
+ * \param [in] pathLength is the length of \a path, bytes
+ *
+ * \return true if \a path is a descendant of \a directory, false otherwise
+ */
+
+bool isDescendant(const char* const directory, const size_t directoryLength, const char* const path,
+		const size_t pathLength)
+{
+	return pathLength > directoryLength && path[directoryLength] == '/' &&
+			memcmp(directory, path, directoryLength) == 0;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+std::pair<int, const XipImage::Entry*> XipImage::find(const char* path) const
+{
+	if (path == nullptr)
+		return {EINVAL, {}};
+
+	while (*path == '/')
+		++path;
+
+	auto length = strlen(path);
+	bool trailingSlash {};
+	while (length != 0 && path[length - 1] == '/')
+	{
+		--length;
+		trailingSlash = true;
+	}
+
+	if (length == 0)
+		return {{}, &rootEntry_};
+	if (length > UINT16_MAX)
+		return {ENAMETOOLONG, {}};
+
+	{
+		const auto entry = lookUp(path, length);
+		if (entry != nullptr)
+			return {trailingSlash == true && entry->type != directoryType ? ENOTDIR : 0, entry};
+	}
+
+	// path was not found - check whether all of its prefix components name existing directories
+	for (size_t i {}; i < length; ++i)
+		if (path[i] == '/')
+		{
+			const auto entry = lookUp(path, i);
+			if (entry == nullptr)
+				break;
+			if (entry->type != directoryType)
+				return {ENOTDIR, {}};
+		}
+
+	return {ENOENT, {}};
+}
+
+const char* XipImage::getName(const Entry& entry) const
+{
+	const auto path = static_cast<const char*>(image_) + entry.pathOffset;
+	auto length = entry.pathLength;
+	while (length != 0 && path[length - 1] != '/')
+		--length;
+	return path + length;
+}
+
+int XipImage::mount(const void* const image, const size_t size)
+{
+	if (image_ != nullptr)
+		return EBUSY;
+
+	if (image == nullptr || reinterpret_cast<uintptr_t>(image) % alignof(Header) != 0)
+		return EINVAL;
+
+	if (size < sizeof(Header))
+		return EILSEQ;
+
+	const auto imageUint8 = static_cast<const uint8_t*>(image);
+	Header header;
+	memcpy(&header, imageUint8, sizeof(header));
+	if (header.magic != magic || header.imageSize > size || header.metadataSize > header.imageSize ||
+			header.metadataSize < sizeof(header) ||
+			header.entriesCount > (header.metadataSize - sizeof(header)) / sizeof(Entry))
+		return EILSEQ;
+
+	if (updateCrc32({}, imageUint8 + crcProtectedOffset, header.metadataSize - crcProtectedOffset) != header.crc)
+		return EILSEQ;
+
+	const auto entries = reinterpret_cast<const Entry*>(imageUint8 + sizeof(header));
+	const auto paths = reinterpret_cast<const char*>(imageUint8);
+	const auto pathsOffset = sizeof(header) + header.entriesCount * sizeof(Entry);
+	for (size_t i {}; i < header.entriesCount; ++i)
+	{
+		const auto& entry = entries[i];
+		if (entry.pathLength == 0 || entry.reserved != 0 || entry.pathOffset < pathsOffset ||
+				static_cast<uint64_t>(entry.pathOffset) + entry.pathLength >= header.metadataSize)
+			return EILSEQ;
+
+		const auto path = paths + entry.pathOffset;
+		if (path[entry.pathLength] != '\0' || memchr(path, '\0', entry.pathLength) != nullptr || path[0] == '/' ||
+				path[entry.pathLength - 1] == '/')
+			return EILSEQ;
+
+		if (i != 0 && comparePaths(paths + entries[i - 1].pathOffset, entries[i - 1].pathLength, path,
+				entry.pathLength) >= 0)
+			return EILSEQ;
+
+		size_t nameOffset {entry.pathLength};
+		while (nameOffset != 0 && path[nameOffset - 1] != '/')
+			--nameOffset;
+		if (entry.pathLength - nameOffset >= sizeof(dirent::d_name))
+			return EILSEQ;
+
+		if (entry.type == fileType)
+		{
+			if (entry.size != 0 && (entry.dataOffset < header.metadataSize ||
+					static_cast<uint64_t>(entry.dataOffset) + entry.size > header.imageSize))
+				return EILSEQ;
+		}
+		else if (entry.type == directoryType)
+		{
+			if (entry.size > header.entriesCount - i - 1)
+				return EILSEQ;
+
+			// table is sorted, so checking last descendant and the entry following it is enough
+			const auto& last = entries[i + entry.size];
+			if (entry.size != 0 && isDescendant(path, entry.pathLength, paths + last.pathOffset,
+					last.pathLength) == false)
+				return EILSEQ;
+			if (i + entry.size + 1 < header.entriesCount)
+			{
+				const auto& next = entries[i + entry.size + 1];
+				if (isDescendant(path, entry.pathLength, paths + next.pathOffset, next.pathLength) == true)
+					return EILSEQ;
+			}
+		}
+		else
+			return EILSEQ;
+	}
+
+	rootEntry_ = {};
+	rootEntry_.size = header.entriesCount;
+	rootEntry_.type = directoryType;
+	entries_ = entries;
+	image_ = image;
+	imageSize_ = header.imageSize;
+	return 0;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+const XipImage::Entry* XipImage::lookUp(const char* const path, const size_t length) const
+{
+	const auto paths = static_cast<const char*>(image_);
+	size_t low {};
+	size_t high {rootEntry_.size};
+	while (low < high)
+	{
+		const auto middle = low + (high - low) / 2;
+		const auto& entry = entries_[middle];
+		const auto result = comparePaths(paths + entry.pathOffset, entry.pathLength, path, length);
+		if (result == 0)
+			return &entry;
+
+		if (result < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return nullptr;
+}
+
+}	// namespace internal
+
+}	// namespace distortos
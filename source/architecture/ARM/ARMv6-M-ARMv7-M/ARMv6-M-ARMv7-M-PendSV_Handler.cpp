@@ -12,6 +12,8 @@
 #include "distortos/internal/scheduler/getScheduler.hpp"
 #include "distortos/internal/scheduler/Scheduler.hpp"
 
+#include "ARMv7-M-fpuContextOwnership.hpp"
+
 #include "distortos/chip/CMSIS-proxy.h"
 
 #ifdef CONFIG_CHECK_STACK_POINTER_RANGE_CONTEXT_SWITCH_ENABLE
@@ -51,6 +53,8 @@ void checkStackPointerWrapper(const void* const stackPointer)
 /**
  * \brief Wrapper for void* distortos::internal::getScheduler().switchContext(void*)
  *
+ * If ownership of FPU context is enabled, appropriate hooks are executed before and after the switch.
+ *
  * \param [in] stackPointer is the current value of current thread's stack pointer
  *
  * \return new thread's stack pointer
@@ -58,7 +62,18 @@ void checkStackPointerWrapper(const void* const stackPointer)
 
 void* schedulerSwitchContextWrapper(void* const stackPointer)
 {
+#ifdef CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
+
+	architecture::fpuContextSwitchOutHook();
+	const auto newStackPointer = internal::getScheduler().switchContext(stackPointer);
+	architecture::fpuContextSwitchedInHook();
+	return newStackPointer;
+
+#else	// !def CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
+
 	return internal::getScheduler().switchContext(stackPointer);
+
+#endif	// !def CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
 }
 
 }	// namespace
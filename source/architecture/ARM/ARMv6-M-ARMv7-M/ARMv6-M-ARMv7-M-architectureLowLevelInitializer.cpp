@@ -39,6 +39,11 @@ void architectureLowLevelInitializer()
 #endif	// def CONFIG_ARCHITECTURE_ARM_CORTEX_M3_R1P1
 #if __FPU_PRESENT == 1 && __FPU_USED == 1
 	SCB->CPACR |= 3 << 10 * 2 | 3 << 11 * 2;	// full access to CP10 and CP11
+#ifdef CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
+	// FPU context is never stacked by hardware, it is saved and restored only when its ownership changes
+	FPU->FPCCR &= ~(FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk);
+	SCB->SHCSR |= SCB_SHCSR_USGFAULTENA_Msk;	// NOCP UsageFault is used to transfer ownership of FPU context
+#endif	// def CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
 #endif	// __FPU_PRESENT == 1 && __FPU_USED == 1
 }
 
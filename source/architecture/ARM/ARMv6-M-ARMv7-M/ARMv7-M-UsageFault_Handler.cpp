@@ -0,0 +1,78 @@
+/**
+ * \file
+ * \brief UsageFault_Handler() for ARMv7-M
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ARMv7-M-fpuContextOwnership.hpp"
+
+#ifdef CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
+
+#include "distortos/chip/CMSIS-proxy.h"
+
+#include "distortos/FATAL_ERROR.h"
+
+namespace distortos
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Handles UsageFault.
+ *
+ * The only UsageFault which is handled is NOCP in Thread mode - current thread tries to use FPU without owning FPU
+ * context, so the ownership is transferred to it and the faulting instruction is retried. Any other UsageFault is fatal.
+ *
+ * \param [in] exceptionReturn is the EXC_RETURN value of UsageFault
+ */
+
+void usageFaultHandler(const uint32_t exceptionReturn)
+{
+	if ((SCB->CFSR & SCB_CFSR_NOCP_Msk) == 0)
+		FATAL_ERROR("Unhandled UsageFault!");
+
+	if ((exceptionReturn & 1 << 3) == 0)	// fault in Handler mode?
+		FATAL_ERROR("Floating-point instruction executed in interrupt handler!");
+
+	SCB->CFSR = SCB_CFSR_NOCP_Msk;	// clear the flag
+	architecture::acquireFpuContext();
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief UsageFault_Handler() for ARMv7-M
+ *
+ * Transfers ownership of FPU context to current thread on its first floating-point instruction.
+ */
+
+extern "C" __attribute__ ((naked)) void UsageFault_Handler()
+{
+	asm volatile
+	(
+			"	mov			r0, lr								\n"	// 1st argument - EXC_RETURN value
+			"	b			%[usageFaultHandler]				\n"	// usageFaultHandler() returns directly to thread
+
+			::	[usageFaultHandler] "i" (usageFaultHandler)
+	);
+
+	__builtin_unreachable();
+}
+
+}	// namespace distortos
+
+#endif	// def CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
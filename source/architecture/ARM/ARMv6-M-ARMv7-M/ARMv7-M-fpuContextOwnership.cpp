@@ -0,0 +1,196 @@
+/**
+ * \file
+ * \brief Definitions of functions managing ownership of FPU context for ARMv7-M
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ARMv7-M-fpuContextOwnership.hpp"
+
+#ifdef CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
+
+#include "distortos/chip/CMSIS-proxy.h"
+
+#if __FPU_PRESENT != 1 || __FPU_USED != 1
+#error "FPU context ownership requires FPU which is present and used!"
+#endif	// __FPU_PRESENT != 1 || __FPU_USED != 1
+
+#ifdef CONFIG_SIGNALS_ENABLE
+#error "FPU context ownership cannot be used with signals, as signal handlers could corrupt FPU context of thread!"
+#endif	// def CONFIG_SIGNALS_ENABLE
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+#include "distortos/FATAL_ERROR.h"
+
+#include <array>
+
+namespace distortos
+{
+
+namespace architecture
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// saved FPU context of a thread which lost ownership of FPU context
+struct SavedFpuContext
+{
+	/// thread to which this FPU context belongs, nullptr if this slot is free
+	const internal::ThreadControlBlock* threadControlBlock;
+
+	/// values of s0-s31 registers
+	uint32_t registers[32];
+
+	/// value of FPSCR register
+	uint32_t fpscr;
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// mask of bits in CPACR register which enable full access to CP10 and CP11
+constexpr uint32_t coprocessorAccessMask {3 << 10 * 2 | 3 << 11 * 2};
+
+/// thread which owns FPU context - its floating-point registers are live in FPU, nullptr if there's no owner
+const internal::ThreadControlBlock* fpuContextOwner;
+
+/// array with slots for saved FPU contexts
+std::array<SavedFpuContext, CONFIG_ARCHITECTURE_ARMV7_M_SAVED_FPU_CONTEXTS> savedFpuContexts;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Finds slot with saved FPU context of selected thread.
+ *
+ * \param [in] threadControlBlock is a pointer to ThreadControlBlock of thread which saved FPU context will be searched
+ * for, nullptr to search for free slot
+ *
+ * \return pointer to found slot, nullptr if no slot matches
+ */
+
+SavedFpuContext* findSavedFpuContext(const internal::ThreadControlBlock* const threadControlBlock)
+{
+	for (auto& savedFpuContext : savedFpuContexts)
+		if (savedFpuContext.threadControlBlock == threadControlBlock)
+			return &savedFpuContext;
+
+	return nullptr;
+}
+
+/**
+ * \brief Enables or disables access to CP10 and CP11.
+ *
+ * \param [in] enable selects whether access to CP10 and CP11 will be enabled (true) or disabled (false)
+ */
+
+void setCoprocessorAccess(const bool enable)
+{
+	const auto cpacr = SCB->CPACR;
+	SCB->CPACR = enable == true ? cpacr | coprocessorAccessMask : cpacr & ~coprocessorAccessMask;
+	__DSB();
+	__ISB();
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void acquireFpuContext()
+{
+	const auto& currentThreadControlBlock = internal::getScheduler().getCurrentThreadControlBlock();
+
+	// copy is made to free the slot before it is needed for FPU context of previous owner
+	const auto savedFpuContext = findSavedFpuContext(&currentThreadControlBlock);
+	SavedFpuContext restoredFpuContext;
+	if (savedFpuContext != nullptr)
+	{
+		restoredFpuContext = *savedFpuContext;
+		savedFpuContext->threadControlBlock = {};
+	}
+
+	setCoprocessorAccess(true);
+
+	if (fpuContextOwner != nullptr)	// FPU registers hold context of another thread?
+	{
+		const auto freeSavedFpuContext = findSavedFpuContext(nullptr);
+		if (freeSavedFpuContext == nullptr)
+			FATAL_ERROR("No free slot for saved FPU context!");
+
+		// s0-s31 are intentionally not listed as clobbered - compiler must not preserve any of them here
+		asm volatile
+		(
+				"	vstmia		%[registers], {s0-s31}		\n"
+
+				::	[registers] "r" (freeSavedFpuContext->registers)
+				:	"memory"
+		);
+		freeSavedFpuContext->fpscr = __get_FPSCR();
+		freeSavedFpuContext->threadControlBlock = fpuContextOwner;
+	}
+
+	fpuContextOwner = &currentThreadControlBlock;
+
+	if (savedFpuContext == nullptr)	// first use of FPU by this thread?
+	{
+		__set_FPSCR(FPU->FPDSCR);
+		return;
+	}
+
+	asm volatile
+	(
+			"	vldmia		%[registers], {s0-s31}		\n"
+
+			::	[registers] "r" (restoredFpuContext.registers)
+			:	"memory"
+	);
+	__set_FPSCR(restoredFpuContext.fpscr);
+}
+
+void fpuContextSwitchOutHook()
+{
+	const auto& currentThreadControlBlock = internal::getScheduler().getCurrentThreadControlBlock();
+
+	if (currentThreadControlBlock.getState() == ThreadState::terminated)
+	{
+		if (fpuContextOwner == &currentThreadControlBlock)
+			fpuContextOwner = {};
+
+		const auto savedFpuContext = findSavedFpuContext(&currentThreadControlBlock);
+		if (savedFpuContext != nullptr)
+			savedFpuContext->threadControlBlock = {};
+
+		return;
+	}
+
+	// access is enabled only for the owner, except the period before the first context switch, when FPU may be used
+	// freely by main thread
+	if ((SCB->CPACR & coprocessorAccessMask) != 0)
+		fpuContextOwner = &currentThreadControlBlock;
+}
+
+void fpuContextSwitchedInHook()
+{
+	setCoprocessorAccess(&internal::getScheduler().getCurrentThreadControlBlock() == fpuContextOwner);
+}
+
+}	// namespace architecture
+
+}	// namespace distortos
+
+#endif	// def CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
@@ -0,0 +1,59 @@
+/**
+ * \file
+ * \brief Declarations of functions managing ownership of FPU context for ARMv7-M
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SOURCE_ARCHITECTURE_ARM_ARMV6_M_ARMV7_M_ARMV7_M_FPUCONTEXTOWNERSHIP_HPP_
+#define SOURCE_ARCHITECTURE_ARM_ARMV6_M_ARMV7_M_ARMV7_M_FPUCONTEXTOWNERSHIP_HPP_
+
+#include "distortos/distortosConfiguration.h"
+
+#ifdef CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
+
+namespace distortos
+{
+
+namespace architecture
+{
+
+/**
+ * \brief Acquires ownership of FPU context for current thread.
+ *
+ * Called from UsageFault_Handler() when current thread executes its first floating-point instruction after it was
+ * switched in without owning FPU context. Access to CP10 and CP11 is enabled, FPU context of previous owner (if any) is
+ * saved and FPU context of current thread (if it was saved before) is restored.
+ */
+
+void acquireFpuContext();
+
+/**
+ * \brief Hook function executed in PendSV_Handler() when context of current thread is about to be switched out.
+ *
+ * If FPU context of current thread is live, current thread becomes its owner. If current thread is terminated, its FPU
+ * context is discarded.
+ */
+
+void fpuContextSwitchOutHook();
+
+/**
+ * \brief Hook function executed in PendSV_Handler() after context of new thread was switched in.
+ *
+ * Access to CP10 and CP11 is enabled only if the new thread owns FPU context - for any other thread first
+ * floating-point instruction will cause UsageFault with NOCP flag.
+ */
+
+void fpuContextSwitchedInHook();
+
+}	// namespace architecture
+
+}	// namespace distortos
+
+#endif	// def CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE
+
+#endif	// SOURCE_ARCHITECTURE_ARM_ARMV6_M_ARMV7_M_ARMV7_M_FPUCONTEXTOWNERSHIP_HPP_
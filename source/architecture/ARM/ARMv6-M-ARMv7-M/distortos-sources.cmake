@@ -7,6 +7,46 @@
 # distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 #
 
+# signal handlers are executed on the stack of interrupted thread, where no floating-point frame is stacked, so they
+# could corrupt live floating-point registers of this thread
+if(CONFIG_ARCHITECTURE_ARMV7_M AND NOT distortos_Scheduler_02_Support_for_signals)
+
+	distortosSetConfiguration(BOOLEAN
+			distortos_Architecture_02_FPU_context_ownership
+			OFF
+			HELP "Enable software-managed ownership of FPU context.
+
+			When enabled, FPU context is never stacked by hardware and is not saved or restored during regular context
+			switches. Access to FPU is disabled for all threads except the one which owns FPU context. First
+			floating-point instruction executed by any other thread causes UsageFault (NOCP), in which FPU context of
+			previous owner is saved and FPU context of current thread is restored. This reduces cost of context switches
+			and stack usage when only a few threads use FPU.
+
+			Interrupt handlers must not use FPU. Threads must not execute their first floating-point instruction after
+			being switched in with interrupts masked via PRIMASK register (\"Interrupt priority disabled in critical
+			sections\" set to 0), as in that case UsageFault escalates to HardFault.
+
+			This option is available only when support for signals is disabled. Signal handlers are executed on the
+			stack of interrupted thread and - as no floating-point frame is stacked - they could corrupt live
+			floating-point registers of this thread."
+			OUTPUT_NAME CONFIG_ARCHITECTURE_ARMV7_M_FPU_CONTEXT_OWNERSHIP_ENABLE)
+
+	if(distortos_Architecture_02_FPU_context_ownership)
+
+		distortosSetConfiguration(INTEGER
+				distortos_Architecture_03_Saved_FPU_contexts
+				2
+				MIN 1
+				HELP "Number of slots for saved FPU contexts.
+
+				Each thread which used FPU, but doesn't own FPU context at the moment, needs one slot (136 bytes). This
+				should be equal to the number of threads using FPU minus one."
+				OUTPUT_NAME CONFIG_ARCHITECTURE_ARMV7_M_SAVED_FPU_CONTEXTS)
+
+	endif(distortos_Architecture_02_FPU_context_ownership)
+
+endif(CONFIG_ARCHITECTURE_ARMV7_M AND NOT distortos_Scheduler_02_Support_for_signals)
+
 target_include_directories(distortos PUBLIC
 		${CMAKE_CURRENT_LIST_DIR}/include
 		${CMAKE_CURRENT_LIST_DIR}/external/CMSIS)
@@ -26,7 +66,9 @@ target_sources(distortos PRIVATE
 		${CMAKE_CURRENT_LIST_DIR}/ARMv6-M-ARMv7-M-startScheduling.cpp
 		${CMAKE_CURRENT_LIST_DIR}/ARMv6-M-ARMv7-M-supervisorCall.cpp
 		${CMAKE_CURRENT_LIST_DIR}/ARMv6-M-ARMv7-M-SVC_Handler.cpp
-		${CMAKE_CURRENT_LIST_DIR}/ARMv6-M-ARMv7-M-SysTick_Handler.cpp)
+		${CMAKE_CURRENT_LIST_DIR}/ARMv6-M-ARMv7-M-SysTick_Handler.cpp
+		${CMAKE_CURRENT_LIST_DIR}/ARMv7-M-fpuContextOwnership.cpp
+		${CMAKE_CURRENT_LIST_DIR}/ARMv7-M-UsageFault_Handler.cpp)
 
 doxygen(INPUT ${CMAKE_CURRENT_LIST_DIR}
 		INCLUDE_PATH ${CMAKE_CURRENT_LIST_DIR}/include ${CMAKE_CURRENT_LIST_DIR}/external/CMSIS
@@ -192,3 +192,5 @@ target_sources(distortos PRIVATE
 doxygen(INPUT ${CMAKE_CURRENT_LIST_DIR}
 		INCLUDE_PATH ${CMAKE_CURRENT_LIST_DIR}/include ${CMAKE_CURRENT_LIST_DIR}/external/CMSIS-STM32F0
 		EXCLUDE ${CMAKE_CURRENT_LIST_DIR}/external)
+
+include(${CMAKE_CURRENT_LIST_DIR}/../peripherals/CRCv2/distortos-sources.cmake)
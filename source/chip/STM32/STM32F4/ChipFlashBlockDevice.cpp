@@ -0,0 +1,374 @@
+/**
+ * \file
+ * \brief ChipFlashBlockDevice class implementation for STM32F4
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/chip/ChipFlashBlockDevice.hpp"
+
+#include "distortos/chip/CMSIS-proxy.h"
+#include "distortos/chip/STM32F4-FLASH.hpp"
+
+#include "distortos/ThisThread.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+#include <cerrno>
+#include <cstring>
+
+namespace distortos
+{
+
+namespace chip
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// mutex used to serialize access to flash controller, shared by all ChipFlashBlockDevice objects
+Mutex flashControllerMutex {Mutex::Protocol::priorityInheritance};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Resets data cache if it is enabled, so that no stale data is read after erase or program operation.
+ */
+
+void resetDataCache()
+{
+	if ((FLASH->ACR & FLASH_ACR_DCEN) != 0)
+		enableDataCache();
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+ChipFlashBlockDevice::~ChipFlashBlockDevice()
+{
+
+}
+
+int ChipFlashBlockDevice::close()
+{
+	const std::lock_guard<ChipFlashBlockDevice> lockGuard {*this};
+
+	if (openCount_ == 0)	// device is not open anymore?
+		return EBADF;
+
+	const auto ret = openCount_ == 1 ? flushSectorBuffer() : 0;	// flush on last close
+	--openCount_;
+	return ret;
+}
+
+int ChipFlashBlockDevice::erase(const uint64_t address, const uint64_t size)
+{
+	const std::lock_guard<ChipFlashBlockDevice> lockGuard {*this};
+
+	const auto sectorSize = getEraseBlockSize();
+
+	{
+		const auto ret = checkRange(address, size, sectorSize);
+		if (ret != 0)
+			return ret;
+	}
+
+	const auto firstSector = address / sectorSize;
+	const auto lastSector = (address + size) / sectorSize;
+
+	if (dirtyBegin_ != dirtyEnd_ && bufferedSector_ >= firstSector && bufferedSector_ < lastSector)
+		dirtyEnd_ = dirtyBegin_;	// contents of sector buffer would be erased anyway
+
+	for (auto sector = firstSector; sector < lastSector; ++sector)
+	{
+		int ret;
+
+		{
+			const std::lock_guard<Mutex> flashControllerLockGuard {flashControllerMutex};
+
+			unlockFlash();
+			startFlashSectorErase(firstSector_ + sector);
+			while (isFlashBusy() == true)
+				ThisThread::sleepFor(TickClock::duration{1});
+			ret = finishFlashOperation();
+			lockFlash();
+		}
+
+		resetDataCache();
+
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+size_t ChipFlashBlockDevice::getEraseBlockSize() const
+{
+	return getFlashSectorSize(firstSector_);
+}
+
+std::pair<bool, uint8_t> ChipFlashBlockDevice::getErasedValue() const
+{
+	return {true, 0xff};
+}
+
+size_t ChipFlashBlockDevice::getProgramBlockSize() const
+{
+	return flashProgramSize;
+}
+
+size_t ChipFlashBlockDevice::getReadBlockSize() const
+{
+	return 1;
+}
+
+uint64_t ChipFlashBlockDevice::getSize() const
+{
+	return static_cast<uint64_t>(getEraseBlockSize()) * sectorsCount_;
+}
+
+int ChipFlashBlockDevice::lock()
+{
+	return mutex_.lock();
+}
+
+int ChipFlashBlockDevice::open()
+{
+	const std::lock_guard<ChipFlashBlockDevice> lockGuard {*this};
+
+	if (openCount_ == std::numeric_limits<decltype(openCount_)>::max())	// device is already opened too many times?
+		return EMFILE;
+
+	if (openCount_ == 0)	// first open?
+	{
+		if (sectorsCount_ == 0 || firstSector_ + sectorsCount_ > 2 * flashSectorsPerBank)
+			return EINVAL;
+
+		const auto sectorSize = getEraseBlockSize();
+		for (uint8_t sector {}; sector < sectorsCount_; ++sector)
+			if (getFlashSectorSize(firstSector_ + sector) != sectorSize)
+				return EINVAL;
+
+		const auto flashSize = *reinterpret_cast<const uint16_t*>(FLASHSIZE_BASE) * size_t{1024};
+		if (getFlashSectorAddress(firstSector_) + getSize() > flashAddress + flashSize)
+			return EINVAL;
+	}
+
+	++openCount_;
+	return 0;
+}
+
+std::pair<int, size_t> ChipFlashBlockDevice::program(const uint64_t address, const void* const buffer,
+		const size_t size)
+{
+	if (buffer == nullptr)
+		return {EINVAL, {}};
+
+	const std::lock_guard<ChipFlashBlockDevice> lockGuard {*this};
+
+	{
+		const auto ret = checkRange(address, size, flashProgramSize);
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	const auto deviceAddress = getFlashSectorAddress(firstSector_);
+
+	if (sectorBuffer_ == nullptr)
+	{
+		const auto ret = writeFlash(deviceAddress + address, buffer, size);
+		return {ret, ret == 0 ? size : 0};
+	}
+
+	const auto sectorSize = getEraseBlockSize();
+	const auto bufferUint8 = static_cast<const uint8_t*>(buffer);
+	size_t programmed {};
+	while (programmed < size)
+	{
+		const uint8_t sector = (address + programmed) / sectorSize;
+		const size_t offset = (address + programmed) % sectorSize;
+		const auto chunk = std::min(size - programmed, sectorSize - offset);
+
+		if (dirtyBegin_ != dirtyEnd_ && sector != bufferedSector_)
+		{
+			const auto ret = flushSectorBuffer();
+			if (ret != 0)
+				return {ret, programmed};
+		}
+
+		if (dirtyBegin_ == dirtyEnd_)	// sector buffer is empty?
+		{
+			bufferedSector_ = sector;
+			dirtyBegin_ = offset;
+			dirtyEnd_ = offset;
+		}
+
+		// gaps between dirty range and new data are filled with current contents of flash
+		const auto sectorAddress = reinterpret_cast<const uint8_t*>(deviceAddress + sector * sectorSize);
+		if (offset < dirtyBegin_)
+		{
+			memcpy(sectorBuffer_ + offset, sectorAddress + offset, dirtyBegin_ - offset);
+			dirtyBegin_ = offset;
+		}
+		if (offset + chunk > dirtyEnd_)
+		{
+			memcpy(sectorBuffer_ + dirtyEnd_, sectorAddress + dirtyEnd_, offset + chunk - dirtyEnd_);
+			dirtyEnd_ = offset + chunk;
+		}
+
+		memcpy(sectorBuffer_ + offset, bufferUint8 + programmed, chunk);
+		programmed += chunk;
+	}
+
+	return {{}, programmed};
+}
+
+std::pair<int, size_t> ChipFlashBlockDevice::read(const uint64_t address, void* const buffer, const size_t size)
+{
+	if (buffer == nullptr)
+		return {EINVAL, {}};
+
+	const std::lock_guard<ChipFlashBlockDevice> lockGuard {*this};
+
+	{
+		const auto ret = checkRange(address, size, 1);
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	const auto deviceAddress = getFlashSectorAddress(firstSector_);
+	memcpy(buffer, reinterpret_cast<const void*>(deviceAddress + address), size);
+
+	if (dirtyBegin_ == dirtyEnd_)	// sector buffer is empty?
+		return {{}, size};
+
+	// overlay data coalesced in sector buffer which was not yet written to flash
+	const auto dirtyAddress = static_cast<uint64_t>(bufferedSector_) * getEraseBlockSize();
+	const auto begin = std::max(address, dirtyAddress + dirtyBegin_);
+	const auto end = std::min(address + size, dirtyAddress + dirtyEnd_);
+	if (begin < end)
+		memcpy(static_cast<uint8_t*>(buffer) + (begin - address), sectorBuffer_ + (begin - dirtyAddress),
+				end - begin);
+
+	return {{}, size};
+}
+
+int ChipFlashBlockDevice::synchronize()
+{
+	const std::lock_guard<ChipFlashBlockDevice> lockGuard {*this};
+
+	if (openCount_ == 0)
+		return EBADF;
+
+	return flushSectorBuffer();
+}
+
+int ChipFlashBlockDevice::trim(const uint64_t address, const uint64_t size)
+{
+	const std::lock_guard<ChipFlashBlockDevice> lockGuard {*this};
+
+	return checkRange(address, size, getEraseBlockSize());
+}
+
+int ChipFlashBlockDevice::unlock()
+{
+	return mutex_.unlock();
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int ChipFlashBlockDevice::checkRange(const uint64_t address, const uint64_t size, const size_t blockSize) const
+{
+	if (openCount_ == 0)
+		return EBADF;
+
+	if (size == 0 || address % blockSize != 0 || size % blockSize != 0)
+		return EINVAL;
+
+	if (address + size > getSize())
+		return ENOSPC;
+
+	return 0;
+}
+
+int ChipFlashBlockDevice::flushSectorBuffer()
+{
+	if (dirtyBegin_ == dirtyEnd_)	// sector buffer is empty?
+		return 0;
+
+	const auto sectorAddress = getFlashSectorAddress(firstSector_) + bufferedSector_ * getEraseBlockSize();
+	const auto isUnitChanged = [this, sectorAddress](const size_t offset)
+			{
+				return memcmp(sectorBuffer_ + offset, reinterpret_cast<const void*>(sectorAddress + offset),
+						flashProgramSize) != 0;
+			};
+
+	auto begin = dirtyBegin_;
+	const auto end = dirtyEnd_;
+	dirtyEnd_ = dirtyBegin_;	// sector buffer is empty even if programming fails
+
+	// only runs of program units which differ from contents of flash are programmed
+	while (begin < end)
+	{
+		while (begin < end && isUnitChanged(begin) == false)
+			begin += flashProgramSize;
+
+		auto runEnd = begin;
+		while (runEnd < end && isUnitChanged(runEnd) == true)
+			runEnd += flashProgramSize;
+
+		if (runEnd != begin)
+		{
+			const auto ret = writeFlash(sectorAddress + begin, sectorBuffer_ + begin, runEnd - begin);
+			if (ret != 0)
+				return ret;
+		}
+
+		begin = runEnd;
+	}
+
+	return 0;
+}
+
+int ChipFlashBlockDevice::writeFlash(const uintptr_t address, const void* const buffer, const size_t size) const
+{
+	int ret;
+
+	{
+		const std::lock_guard<Mutex> flashControllerLockGuard {flashControllerMutex};
+
+		unlockFlash();
+		ret = programFlash(address, buffer, size);
+		lockFlash();
+	}
+
+	resetDataCache();
+
+	if (ret != 0)
+		return ret;
+
+	// flash which was not erased doesn't report any error, so verify programmed data
+	return memcmp(reinterpret_cast<const void*>(address), buffer, size) == 0 ? 0 : EIO;
+}
+
+}	// namespace chip
+
+}	// namespace distortos
@@ -0,0 +1,131 @@
+/**
+ * \file
+ * \brief Implementation of FLASH programming functions for STM32F4
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/chip/STM32F4-FLASH.hpp"
+
+#include "distortos/chip/CMSIS-proxy.h"
+
+#include <type_traits>
+
+#include <cerrno>
+
+/// attributes of function which is executed from RAM - .ramfunc.* input sections are placed by linker script in .data
+/// output section, which is copied to RAM during startup
+#define STM32F4_FLASH_RAM_FUNCTION	__attribute__ ((section(".ramfunc.STM32F4-FLASH-programming"), long_call, noinline))
+
+namespace distortos
+{
+
+namespace chip
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// type of single flash program unit
+using FlashProgramUnit = std::conditional<flashProgramSize == 4, uint32_t,
+		std::conditional<flashProgramSize == 2, uint16_t, uint8_t>::type>::type;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// first key which must be written to FLASH->KEYR to unlock flash control register
+constexpr uint32_t flashKey1 {0x45670123};
+
+/// second key which must be written to FLASH->KEYR to unlock flash control register
+constexpr uint32_t flashKey2 {0xcdef89ab};
+
+/// mask with all error flags in FLASH->SR
+#ifdef FLASH_SR_RDERR
+constexpr uint32_t flashErrorFlags {FLASH_SR_WRPERR | FLASH_SR_PGAERR | FLASH_SR_PGPERR | FLASH_SR_PGSERR |
+		FLASH_SR_RDERR};
+#else	// !def FLASH_SR_RDERR
+constexpr uint32_t flashErrorFlags {FLASH_SR_WRPERR | FLASH_SR_PGAERR | FLASH_SR_PGPERR | FLASH_SR_PGSERR};
+#endif	// !def FLASH_SR_RDERR
+
+/// value of PSIZE field in FLASH->CR matching flashProgramSize
+constexpr uint32_t flashCrPsize {(flashProgramSize == 4 ? 2u : flashProgramSize == 2 ? 1u : 0u) << FLASH_CR_PSIZE_Pos};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int finishFlashOperation()
+{
+	const auto errors = FLASH->SR & flashErrorFlags;
+	FLASH->SR = errors;	// error flags are cleared by writing 1
+	FLASH->CR = FLASH->CR & ~(FLASH_CR_SER | FLASH_CR_SNB | FLASH_CR_PG);
+	return errors == 0 ? 0 : EIO;
+}
+
+bool isFlashBusy()
+{
+	return (FLASH->SR & FLASH_SR_BSY) != 0;
+}
+
+void lockFlash()
+{
+	FLASH->CR = FLASH->CR | FLASH_CR_LOCK;
+}
+
+STM32F4_FLASH_RAM_FUNCTION int programFlash(const uintptr_t address, const void* const buffer, const size_t size)
+{
+	FLASH->SR = flashErrorFlags;
+	FLASH->CR = (FLASH->CR & ~(FLASH_CR_SER | FLASH_CR_SNB | FLASH_CR_PSIZE)) | flashCrPsize | FLASH_CR_PG;
+
+	const auto bufferUint8 = static_cast<const uint8_t*>(buffer);
+	uint32_t errors {};
+	for (size_t offset {}; offset < size && errors == 0; offset += flashProgramSize)
+	{
+		// unit is assembled manually, as memcpy() is not available in RAM
+		FlashProgramUnit unit {};
+		for (size_t i {}; i < flashProgramSize; ++i)
+			unit |= static_cast<FlashProgramUnit>(bufferUint8[offset + i]) << i * 8;
+
+		*reinterpret_cast<volatile FlashProgramUnit*>(address + offset) = unit;
+		while ((FLASH->SR & FLASH_SR_BSY) != 0);
+		errors = FLASH->SR & flashErrorFlags;
+	}
+
+	FLASH->SR = errors;
+	FLASH->CR = FLASH->CR & ~FLASH_CR_PG;
+	return errors == 0 ? 0 : EIO;
+}
+
+STM32F4_FLASH_RAM_FUNCTION void startFlashSectorErase(const uint8_t sector)
+{
+	// sectors of second bank are numbered from 16 in SNB field
+	const uint32_t snb = sector < flashSectorsPerBank ? sector : sector + 4;
+	FLASH->SR = flashErrorFlags;
+	FLASH->CR = (FLASH->CR & ~(FLASH_CR_PG | FLASH_CR_SNB | FLASH_CR_PSIZE)) | snb << FLASH_CR_SNB_Pos | flashCrPsize |
+			FLASH_CR_SER;
+	FLASH->CR = FLASH->CR | FLASH_CR_STRT;
+}
+
+void unlockFlash()
+{
+	if ((FLASH->CR & FLASH_CR_LOCK) == 0)
+		return;
+
+	FLASH->KEYR = flashKey1;
+	FLASH->KEYR = flashKey2;
+}
+
+}	// namespace chip
+
+}	// namespace distortos
@@ -352,8 +352,10 @@ target_include_directories(distortos PUBLIC
 		${CMAKE_CURRENT_LIST_DIR}/external/CMSIS-STM32F4)
 
 target_sources(distortos PRIVATE
+		${CMAKE_CURRENT_LIST_DIR}/ChipFlashBlockDevice.cpp
 		${CMAKE_CURRENT_LIST_DIR}/STM32F4-chipLowLevelInitializer.cpp
 		${CMAKE_CURRENT_LIST_DIR}/STM32F4-FLASH.cpp
+		${CMAKE_CURRENT_LIST_DIR}/STM32F4-FLASH-programming.cpp
 		${CMAKE_CURRENT_LIST_DIR}/STM32F4-PWR.cpp
 		${CMAKE_CURRENT_LIST_DIR}/STM32F4-RCC.cpp)
 
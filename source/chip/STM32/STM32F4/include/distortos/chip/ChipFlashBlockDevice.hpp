@@ -0,0 +1,327 @@
+/**
+ * \file
+ * \brief ChipFlashBlockDevice class header for STM32F4
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SOURCE_CHIP_STM32_STM32F4_INCLUDE_DISTORTOS_CHIP_CHIPFLASHBLOCKDEVICE_HPP_
+#define SOURCE_CHIP_STM32_STM32F4_INCLUDE_DISTORTOS_CHIP_CHIPFLASHBLOCKDEVICE_HPP_
+
+#include "distortos/devices/memory/BlockDevice.hpp"
+
+#include "distortos/Mutex.hpp"
+
+namespace distortos
+{
+
+namespace chip
+{
+
+/**
+ * ChipFlashBlockDevice class is a block device which uses a range of sectors of internal flash of STM32F4.
+ *
+ * All sectors in the range must have identical size, so the range may consist either of 16 kB sectors or of 128 kB
+ * sectors, possibly crossing the boundary between banks. Sectors used by the application must obviously not be
+ * included in the range. Sector layout of 1 MB devices with dual bank option (DB1M) enabled is not supported.
+ *
+ * Program and erase routines are executed from RAM, so when the range is in a different bank than application code,
+ * other threads keep running during these operations. Otherwise CPU is stalled until each operation is finished.
+ *
+ * If sector-sized buffer is provided, programmed data is coalesced in this buffer and written to flash when other
+ * sector is programmed or when synchronize() or close() is called. Without the buffer all programs are written to
+ * flash immediately.
+ *
+ * \ingroup devices
+ */
+
+class ChipFlashBlockDevice : public devices::BlockDevice
+{
+public:
+
+	/**
+	 * \brief ChipFlashBlockDevice's constructor
+	 *
+	 * \param [in] firstSector is the number of first flash sector used by the device
+	 * \param [in] sectorsCount is the number of consecutive flash sectors used by the device
+	 * \param [in] sectorBuffer is a pointer to buffer used to coalesce programmed data, its size must be equal to size
+	 * of single sector, nullptr to write programmed data to flash immediately, default - nullptr
+	 */
+
+	constexpr ChipFlashBlockDevice(const uint8_t firstSector, const uint8_t sectorsCount,
+			uint8_t* const sectorBuffer = {}) :
+					mutex_{Mutex::Type::recursive, Mutex::Protocol::priorityInheritance},
+					sectorBuffer_{sectorBuffer},
+					dirtyBegin_{},
+					dirtyEnd_{},
+					bufferedSector_{},
+					firstSector_{firstSector},
+					openCount_{},
+					sectorsCount_{sectorsCount}
+	{
+
+	}
+
+	/**
+	 * \brief ChipFlashBlockDevice's destructor
+	 *
+	 * \pre Device is closed.
+	 */
+
+	~ChipFlashBlockDevice() override;
+
+	/**
+	 * \brief Closes device.
+	 *
+	 * \note Even if error code is returned, the device must not be used from the context which opened it (until it is
+	 * successfully opened again).
+	 *
+	 * Data coalesced in sector buffer is written to flash when the device is closed for the last time.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is already completely closed;
+	 * - error codes returned by synchronize();
+	 */
+
+	int close() override;
+
+	/**
+	 * \brief Erases blocks on a device.
+	 *
+	 * Sectors are erased one by one, current thread sleeps while waiting for each erase to finish.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] address is the address of range that will be erased, must be a multiple of erase block size
+	 * \param [in] size is the size of erased range, bytes, must be a multiple of erase block size
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a size are not valid;
+	 * - EIO - flash reported an error;
+	 * - ENOSPC - selected range is greater than size of device;
+	 */
+
+	int erase(uint64_t address, uint64_t size) override;
+
+	/**
+	 * \return erase block size, bytes
+	 */
+
+	size_t getEraseBlockSize() const override;
+
+	/**
+	 * \return pair with bool telling whether erased value is defined (true) or not (false) and value of erased bytes
+	 * (valid only if defined);
+	 */
+
+	std::pair<bool, uint8_t> getErasedValue() const override;
+
+	/**
+	 * \return program block size, bytes
+	 */
+
+	size_t getProgramBlockSize() const override;
+
+	/**
+	 * \return read block size, bytes
+	 */
+
+	size_t getReadBlockSize() const override;
+
+	/**
+	 * \return size of device, bytes
+	 */
+
+	uint64_t getSize() const override;
+
+	/**
+	 * \brief Locks the device for exclusive use by current thread.
+	 *
+	 * When the object is locked, any call to any member function from other thread will be blocked until the object is
+	 * unlocked. Locking is optional, but may be useful when more than one transaction must be done atomically.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EAGAIN - the lock could not be acquired because the maximum number of recursive locks for device has been
+	 * exceeded;
+	 */
+
+	int lock() override;
+
+	/**
+	 * \brief Opens device.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EINVAL - range of sectors is not valid or sectors in the range don't have identical size;
+	 * - EMFILE - this device is already opened too many times;
+	 */
+
+	int open() override;
+
+	/**
+	 * \brief Programs data to a device.
+	 *
+	 * Selected range of blocks must have been erased prior to being programmed.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] address is the address of data that will be programmed, must be a multiple of program block size
+	 * \param [in] buffer is the buffer with data that will be programmed
+	 * \param [in] size is the size of \a buffer, bytes, must be a multiple of program block size
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of programmed bytes (valid even
+	 * when error code is returned); error codes:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a buffer and/or \a size are not valid;
+	 * - EIO - flash reported an error or programmed data doesn't match;
+	 * - ENOSPC - selected range is greater than size of device;
+	 */
+
+	std::pair<int, size_t> program(uint64_t address, const void* buffer, size_t size) override;
+
+	/**
+	 * \brief Reads data from a device.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] address is the address of data that will be read, must be a multiple of read block size
+	 * \param [out] buffer is the buffer into which the data will be read
+	 * \param [in] size is the size of \a buffer, bytes, must be a multiple of read block size
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and number of read bytes (valid even when
+	 * error code is returned); error codes:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a buffer and/or \a size are not valid;
+	 * - ENOSPC - selected range is greater than size of device;
+	 */
+
+	std::pair<int, size_t> read(uint64_t address, void* buffer, size_t size) override;
+
+	/**
+	 * \brief Synchronizes state of a device, ensuring all cached writes are finished.
+	 *
+	 * Data coalesced in sector buffer is written to flash.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - EIO - flash reported an error or programmed data doesn't match;
+	 */
+
+	int synchronize() override;
+
+	/**
+	 * \brief Trims unused blocks on a device.
+	 *
+	 * This function does nothing except validating arguments.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \param [in] address is the address of range that will be trimmed, must be a multiple of erase block size
+	 * \param [in] size is the size of trimmed range, bytes, must be a multiple of erase block size
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a size are not valid;
+	 * - ENOSPC - selected range is greater than size of device;
+	 */
+
+	int trim(uint64_t address, uint64_t size) override;
+
+	/**
+	 * \brief Unlocks the device which was previously locked by current thread.
+	 *
+	 * \note Locks are recursive.
+	 *
+	 * \warning This function must not be called from interrupt context!
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EPERM - current thread did not lock the device;
+	 */
+
+	int unlock() override;
+
+private:
+
+	/**
+	 * \brief Checks whether range of device is valid.
+	 *
+	 * \param [in] address is the address of range
+	 * \param [in] size is the size of range, bytes
+	 * \param [in] blockSize is the size of block, \a address and \a size must be a multiple of this value
+	 *
+	 * \return 0 if range is valid, error code otherwise:
+	 * - EBADF - the device is not opened;
+	 * - EINVAL - \a address and/or \a size are not valid;
+	 * - ENOSPC - selected range is greater than size of device;
+	 */
+
+	int checkRange(uint64_t address, uint64_t size, size_t blockSize) const;
+
+	/**
+	 * \brief Writes data coalesced in sector buffer to flash.
+	 *
+	 * Only program units which differ from current contents of flash are programmed.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EIO - flash reported an error or programmed data doesn't match;
+	 */
+
+	int flushSectorBuffer();
+
+	/**
+	 * \brief Programs data to flash, with flash control register unlocked only for the duration of the operation.
+	 *
+	 * \param [in] address is the address of flash that will be programmed
+	 * \param [in] buffer is the buffer with data that will be programmed
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EIO - flash reported an error or programmed data doesn't match;
+	 */
+
+	int writeFlash(uintptr_t address, const void* buffer, size_t size) const;
+
+	/// mutex used to serialize access to this object
+	Mutex mutex_;
+
+	/// pointer to sector-sized buffer used to coalesce programmed data, nullptr if not used
+	uint8_t* sectorBuffer_;
+
+	/// offset of beginning of dirty range in sector buffer, bytes
+	size_t dirtyBegin_;
+
+	/// offset of end of dirty range in sector buffer, bytes, sector buffer is empty if equal to dirtyBegin_
+	size_t dirtyEnd_;
+
+	/// number of sector (relative to firstSector_) which is currently in sector buffer
+	uint8_t bufferedSector_;
+
+	/// number of first flash sector used by the device
+	uint8_t firstSector_;
+
+	/// number of times this device was opened but not yet closed
+	uint8_t openCount_;
+
+	/// number of consecutive flash sectors used by the device
+	uint8_t sectorsCount_;
+};
+
+}	// namespace chip
+
+}	// namespace distortos
+
+#endif	// SOURCE_CHIP_STM32_STM32F4_INCLUDE_DISTORTOS_CHIP_CHIPFLASHBLOCKDEVICE_HPP_
@@ -2,7 +2,7 @@
  * \file
  * \brief Header for FLASH-related functions for STM32F4
  *
- * \author Copyright (C) 2015 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2015-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -14,6 +14,7 @@
 
 #include "distortos/distortosConfiguration.h"
 
+#include <cstddef>
 #include <cstdint>
 
 namespace distortos
@@ -34,10 +35,53 @@ constexpr uint8_t maxFlashLatency {7};
 constexpr uint8_t maxFlashLatency {15};
 #endif
 
+/// size of single flash program operation (program parallelism), bytes - widest one allowed by configured supply
+/// voltage, x64 parallelism is not used as it requires external Vpp
+#if CONFIG_CHIP_STM32F4_VDD_MV >= 2700
+constexpr size_t flashProgramSize {4};
+#elif CONFIG_CHIP_STM32F4_VDD_MV >= 2100
+constexpr size_t flashProgramSize {2};
+#else
+constexpr size_t flashProgramSize {1};
+#endif
+
+/// address of beginning of flash
+constexpr uintptr_t flashAddress {0x08000000};
+
+/// offset of second bank of flash (sectors 12-23), bytes
+constexpr uintptr_t flashBank2Offset {0x100000};
+
+/// number of sectors in single bank of flash
+constexpr uint8_t flashSectorsPerBank {12};
+
 /*---------------------------------------------------------------------------------------------------------------------+
 | global functions' declarations
 +---------------------------------------------------------------------------------------------------------------------*/
 
+/**
+ * \param [in] sector is the number of flash sector, [0; 2 * flashSectorsPerBank)
+ *
+ * \return size of \a sector, bytes
+ */
+
+constexpr size_t getFlashSectorSize(const uint8_t sector)
+{
+	return sector % flashSectorsPerBank < 4 ? 16 * 1024 : sector % flashSectorsPerBank == 4 ? 64 * 1024 : 128 * 1024;
+}
+
+/**
+ * \param [in] sector is the number of flash sector, [0; 2 * flashSectorsPerBank)
+ *
+ * \return address of beginning of \a sector
+ */
+
+constexpr uintptr_t getFlashSectorAddress(const uint8_t sector)
+{
+	return flashAddress + (sector >= flashSectorsPerBank ? flashBank2Offset : 0) +
+			(sector % flashSectorsPerBank < 4 ? sector % flashSectorsPerBank * 16 * 1024 :
+			sector % flashSectorsPerBank == 4 ? 64 * 1024 : (sector % flashSectorsPerBank - 4) * 128 * 1024);
+}
+
 /**
  * \brief Configures flash latency.
  *
@@ -85,6 +129,72 @@ void enableDataCache();
 
 void enableInstructionCache();
 
+/**
+ * \brief Finishes flash erase or program operation.
+ *
+ * Error flags are checked and cleared, SER and PG bits are cleared.
+ *
+ * \pre Flash is not busy.
+ *
+ * \return 0 on success, error code otherwise:
+ * - EIO - flash reported an error during last operation;
+ */
+
+int finishFlashOperation();
+
+/**
+ * \return true if flash erase or program operation is in progress, false otherwise
+ */
+
+bool isFlashBusy();
+
+/**
+ * \brief Locks flash control register.
+ */
+
+void lockFlash();
+
+/**
+ * \brief Programs data to flash.
+ *
+ * The function is executed from RAM and busy-waits until each program operation is finished, so execution of code from
+ * the other bank of flash (if present) is not stalled. When \a address is in the same bank as the code which is being
+ * executed, CPU is stalled until the function returns.
+ *
+ * \pre Flash control register is unlocked.
+ * \pre \a address and \a size are multiples of flashProgramSize.
+ * \pre Programmed range was erased.
+ *
+ * \param [in] address is the address of flash that will be programmed
+ * \param [in] buffer is the buffer with data that will be programmed, no alignment requirements
+ * \param [in] size is the size of \a buffer, bytes
+ *
+ * \return 0 on success, error code otherwise:
+ * - EIO - flash reported an error;
+ */
+
+__attribute__ ((long_call)) int programFlash(uintptr_t address, const void* buffer, size_t size);
+
+/**
+ * \brief Starts erase of single flash sector.
+ *
+ * The function is executed from RAM. Caller should poll isFlashBusy() and call finishFlashOperation() when erase is
+ * done.
+ *
+ * \pre Flash control register is unlocked.
+ * \pre Flash is not busy.
+ *
+ * \param [in] sector is the number of flash sector which will be erased, [0; 2 * flashSectorsPerBank)
+ */
+
+__attribute__ ((long_call)) void startFlashSectorErase(uint8_t sector);
+
+/**
+ * \brief Unlocks flash control register.
+ */
+
+void unlockFlash();
+
 }	// namespace chip
 
 }	// namespace distortos
@@ -257,3 +257,5 @@ target_sources(distortos PRIVATE
 doxygen(INPUT ${CMAKE_CURRENT_LIST_DIR}
 		INCLUDE_PATH ${CMAKE_CURRENT_LIST_DIR}/include ${CMAKE_CURRENT_LIST_DIR}/external/CMSIS-STM32F7
 		EXCLUDE ${CMAKE_CURRENT_LIST_DIR}/external)
+
+include(${CMAKE_CURRENT_LIST_DIR}/../peripherals/CRCv2/distortos-sources.cmake)
@@ -334,3 +334,5 @@ target_sources(distortos PRIVATE
 doxygen(INPUT ${CMAKE_CURRENT_LIST_DIR}
 		INCLUDE_PATH ${CMAKE_CURRENT_LIST_DIR}/include ${CMAKE_CURRENT_LIST_DIR}/external/CMSIS-STM32L4
 		EXCLUDE ${CMAKE_CURRENT_LIST_DIR}/external)
+
+include(${CMAKE_CURRENT_LIST_DIR}/../peripherals/CRCv2/distortos-sources.cmake)
@@ -0,0 +1,98 @@
+/**
+ * \file
+ * \brief updateCrc32() definition for CRCv2 in STM32
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/storage/updateCrc32.hpp"
+
+#include "distortos/chip/CMSIS-proxy.h"
+
+#include "distortos/BIND_LOW_LEVEL_INITIALIZER.h"
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <algorithm>
+
+#include <cstring>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// max number of bytes processed by CRC unit with masked interrupts
+constexpr size_t chunkSize {64};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Low-level initializer of CRC unit
+ *
+ * This function is called before constructors for global and static objects via BIND_LOW_LEVEL_INITIALIZER().
+ */
+
+void crcLowLevelInitializer()
+{
+#if defined(RCC_AHBENR_CRCEN)
+	RCC->AHBENR |= RCC_AHBENR_CRCEN;
+#else	// !defined(RCC_AHBENR_CRCEN)
+	RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+#endif	// !defined(RCC_AHBENR_CRCEN)
+}
+
+BIND_LOW_LEVEL_INITIALIZER(50, crcLowLevelInitializer);
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+uint32_t updateCrc32(uint32_t crc, const void* const buffer, const size_t size)
+{
+	// CRC unit uses polynomial 0x4c11db7 and processes data MSB first, so reflected CRC-32 is obtained with reversal of
+	// each input byte and of the output; current state is restored via (non-reflected) initial value register
+	crc = ~crc;
+	auto bufferUint8 = static_cast<const uint8_t*>(buffer);
+	auto left = size;
+	while (left != 0)
+	{
+		auto chunk = std::min(left, chunkSize);
+		left -= chunk;
+
+		const InterruptMaskingLock interruptMaskingLock;
+
+		CRC->INIT = __RBIT(crc);
+		CRC->CR = CRC_CR_REV_OUT | CRC_CR_REV_IN_0 | CRC_CR_RESET;
+		for (; chunk >= 4; chunk -= 4)
+		{
+			uint32_t word;
+			memcpy(&word, bufferUint8, sizeof(word));
+			CRC->DR = __REV(word);	// first byte must be most significant
+			bufferUint8 += 4;
+		}
+		for (; chunk != 0; --chunk)
+			*reinterpret_cast<volatile uint8_t*>(&CRC->DR) = *bufferUint8++;
+		crc = CRC->DR;
+	}
+	return ~crc;
+}
+
+}	// namespace internal
+
+}	// namespace distortos
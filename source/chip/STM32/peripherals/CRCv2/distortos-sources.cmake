@@ -0,0 +1,26 @@
+#
+# file: distortos-sources.cmake
+#
+# author: Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+#
+# This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+# distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+
+distortosSetConfiguration(BOOLEAN
+		distortos_Peripherals_CRC
+		OFF
+		HELP "Use CRC unit for CRC-32 calculations.
+
+		When enabled, CRC-32 used by storage engines and file systems (e.g. littlefs) is calculated by the CRC unit
+		instead of the slice-by-4 software implementation. The CRC unit must not be used by the application in that
+		case."
+		OUTPUT_NAME CONFIG_CHIP_STM32_CRCV2_ENABLE)
+
+if(distortos_Peripherals_CRC)
+	set(STORAGE_HARDWARE_CRC32_ENABLE ON)
+	target_sources(distortos PRIVATE
+			${CMAKE_CURRENT_LIST_DIR}/STM32-CRCv2-updateCrc32.cpp)
+endif()
+
+doxygen(INPUT ${CMAKE_CURRENT_LIST_DIR})
@@ -0,0 +1,82 @@
+/**
+ * \file
+ * \brief StaticInputPin class header for GPIOv1 in STM32
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SOURCE_CHIP_STM32_PERIPHERALS_GPIOV1_INCLUDE_DISTORTOS_CHIP_STATICINPUTPIN_HPP_
+#define SOURCE_CHIP_STM32_PERIPHERALS_GPIOV1_INCLUDE_DISTORTOS_CHIP_STATICINPUTPIN_HPP_
+
+#include "distortos/chip/STM32-GPIOv1.hpp"
+
+namespace distortos
+{
+
+namespace chip
+{
+
+/**
+ * StaticInputPin class is a single input pin of GPIOv1 in STM32 with identifier and inverted mode fixed at compile
+ * time.
+ *
+ * Unlike ChipInputPin, this class is not derived from devices::InputPin and has no data members - get() is a single
+ * read of IDR register with address and mask known at compile time. Use devices::InputPinAdapter where
+ * devices::InputPin interface is required.
+ *
+ * \tparam pin is the identifier of pin
+ * \tparam inverted selects whether the pin is inverted (true) - get() returns true when GPIO state is low and false
+ * when GPIO state is high - or not (false), default - false, not inverted
+ *
+ * \ingroup devices
+ */
+
+template<Pin pin, bool inverted = false>
+class StaticInputPin
+{
+public:
+
+	/**
+	 * \brief StaticInputPin's constructor
+	 *
+	 * \param [in] pull is the desired pull-up/pull-down configuration of pin, default - PinPull::none
+	 */
+
+	explicit StaticInputPin(const PinPull pull = {})
+	{
+		configureInputPin(pin, pull);
+	}
+
+	/**
+	 * \return current state of pin
+	 */
+
+	bool get() const
+	{
+		return static_cast<bool>(getPort().IDR & (1 << pinNumber)) != inverted;
+	}
+
+private:
+
+	/// number of pin in its port
+	constexpr static uint8_t pinNumber {static_cast<uint32_t>(pin) & 15};
+
+	/**
+	 * \return reference to GPIO port of pin
+	 */
+
+	static GPIO_TypeDef& getPort()
+	{
+		return *reinterpret_cast<GPIO_TypeDef*>(static_cast<uint32_t>(pin) & ~15);
+	}
+};
+
+}	// namespace chip
+
+}	// namespace distortos
+
+#endif	// SOURCE_CHIP_STM32_PERIPHERALS_GPIOV1_INCLUDE_DISTORTOS_CHIP_STATICINPUTPIN_HPP_
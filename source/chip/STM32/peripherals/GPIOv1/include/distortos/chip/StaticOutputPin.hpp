@@ -0,0 +1,104 @@
+/**
+ * \file
+ * \brief StaticOutputPin class header for GPIOv1 in STM32
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SOURCE_CHIP_STM32_PERIPHERALS_GPIOV1_INCLUDE_DISTORTOS_CHIP_STATICOUTPUTPIN_HPP_
+#define SOURCE_CHIP_STM32_PERIPHERALS_GPIOV1_INCLUDE_DISTORTOS_CHIP_STATICOUTPUTPIN_HPP_
+
+#include "distortos/chip/STM32-GPIOv1.hpp"
+
+namespace distortos
+{
+
+namespace chip
+{
+
+/**
+ * StaticOutputPin class is a single output pin of GPIOv1 in STM32 with identifier and inverted mode fixed at compile
+ * time.
+ *
+ * Unlike ChipOutputPin, this class is not derived from devices::OutputPin and has no data members - get() is a single
+ * read of IDR register and set() is a single write to BSRR register, both with addresses and masks known at compile
+ * time. Use devices::OutputPinAdapter where devices::OutputPin interface is required.
+ *
+ * \tparam pin is the identifier of pin
+ * \tparam inverted selects whether the pin is inverted (true) - get() returns true when GPIO state is low and false
+ * when GPIO state is high, set() sets GPIO state to low when argument is true and to high when argument is false - or
+ * not (false), default - false, not inverted
+ *
+ * \ingroup devices
+ */
+
+template<Pin pin, bool inverted = false>
+class StaticOutputPin
+{
+public:
+
+	/**
+	 * \brief StaticOutputPin's constructor
+	 *
+	 * \param [in] openDrain is the desired output type of pin: push-pull (false) or open-drain (true),
+	 * default - push-pull (false)
+	 * \param [in] outputSpeed is the desired output speed of pin, default - PinOutputSpeed::_2Mhz
+	 * \param [in] initialState is the initial state of pin, default - false
+	 */
+
+	explicit StaticOutputPin(const bool openDrain = {}, const PinOutputSpeed outputSpeed = {},
+			const bool initialState = {})
+	{
+		configureOutputPin(pin, openDrain, outputSpeed, initialState != inverted);
+	}
+
+	/**
+	 * \return current state of pin
+	 */
+
+	bool get() const
+	{
+		return static_cast<bool>(getPort().IDR & (1 << pinNumber)) != inverted;
+	}
+
+	/**
+	 * \brief Sets state of pin.
+	 *
+	 * \param [in] state is the new state of pin
+	 */
+
+	void set(const bool state)
+	{
+		getPort().BSRR = state != inverted ? setMask : resetMask;
+	}
+
+private:
+
+	/// number of pin in its port
+	constexpr static uint8_t pinNumber {static_cast<uint32_t>(pin) & 15};
+
+	/// value written to BSRR register to set GPIO state to high
+	constexpr static uint32_t setMask {1 << pinNumber};
+
+	/// value written to BSRR register to set GPIO state to low
+	constexpr static uint32_t resetMask {1 << (pinNumber + 16)};
+
+	/**
+	 * \return reference to GPIO port of pin
+	 */
+
+	static GPIO_TypeDef& getPort()
+	{
+		return *reinterpret_cast<GPIO_TypeDef*>(static_cast<uint32_t>(pin) & ~15);
+	}
+};
+
+}	// namespace chip
+
+}	// namespace distortos
+
+#endif	// SOURCE_CHIP_STM32_PERIPHERALS_GPIOV1_INCLUDE_DISTORTOS_CHIP_STATICOUTPUTPIN_HPP_
@@ -12,6 +12,7 @@
 #include "distortos/chip/ChipSpiMasterLowLevel.hpp"
 
 #include "distortos/chip/getBusFrequency.hpp"
+#include "distortos/chip/STM32-SPIv2.hpp"
 #include "distortos/chip/STM32-bit-banding.h"
 
 #include "distortos/devices/communication/SpiMasterBase.hpp"
@@ -24,6 +25,8 @@
 
 #endif	// !def DISTORTOS_BITBANDING_SUPPORTED
 
+#include <algorithm>
+
 #include <cerrno>
 
 namespace distortos
@@ -57,7 +60,6 @@ public:
 			speBbAddress_{STM32_BITBAND_IMPLEMENTATION(spiBase, SPI_TypeDef, CR1, SPI_CR1_SPE)},
 			errieBbAddress_{STM32_BITBAND_IMPLEMENTATION(spiBase, SPI_TypeDef, CR2, SPI_CR2_ERRIE)},
 			rxneieBbAddress_{STM32_BITBAND_IMPLEMENTATION(spiBase, SPI_TypeDef, CR2, SPI_CR2_RXNEIE)},
-			txeieBbAddress_{STM32_BITBAND_IMPLEMENTATION(spiBase, SPI_TypeDef, CR2, SPI_CR2_TXEIE)},
 			rccEnBbAddress_{rccEnBbAddress},
 			rccRstBbAddress_{rccRstBbAddress}
 	{
@@ -158,23 +160,6 @@ public:
 #endif	// !def DISTORTOS_BITBANDING_SUPPORTED
 	}
 
-	/**
-	 * \brief Enables or disables TXE interrupt of SPI.
-	 *
-	 * \param [in] enable selects whether the interrupt will be enabled (true) or disabled (false)
-	 */
-
-	void enableTxeInterrupt(const bool enable) const
-	{
-#ifdef DISTORTOS_BITBANDING_SUPPORTED
-		*reinterpret_cast<volatile unsigned long*>(txeieBbAddress_) = enable;
-#else	// !def DISTORTOS_BITBANDING_SUPPORTED
-		auto& spi = getSpi();
-		const InterruptMaskingLock interruptMaskingLock;
-		spi.CR2 = (spi.CR2 & ~SPI_CR2_TXEIE) | (enable == true ? SPI_CR2_TXEIE : 0);
-#endif	// !def DISTORTOS_BITBANDING_SUPPORTED
-	}
-
 	/**
 	 * \return peripheral clock frequency, Hz
 	 */
@@ -253,9 +238,6 @@ private:
 	/// address of bitband alias of RXNEIE bit in SPI_CR2 register
 	uintptr_t rxneieBbAddress_;
 
-	/// address of bitband alias of TXEIE bit in SPI_CR2 register
-	uintptr_t txeieBbAddress_;
-
 	/// address of bitband alias of appropriate SPIxEN bit in RCC register
 	uintptr_t rccEnBbAddress_;
 
@@ -370,8 +352,7 @@ std::pair<int, uint32_t> ChipSpiMasterLowLevel::configure(const devices::SpiMode
 			lsbFirst << SPI_CR1_LSBFIRST_Pos | br << SPI_CR1_BR_Pos |
 			(mode == devices::SpiMode::cpol1cpha0 || mode == devices::SpiMode::cpol1cpha1) << SPI_CR1_CPOL_Pos |
 			(mode == devices::SpiMode::cpol0cpha1 || mode == devices::SpiMode::cpol1cpha1) << SPI_CR1_CPHA_Pos;
-	spi.CR2 = (spi.CR2 & ~(SPI_CR2_FRXTH | SPI_CR2_DS)) | (wordLength <= 8) << SPI_CR2_FRXTH_Pos |
-			(wordLength - 1) << SPI_CR2_DS_Pos;
+	spi.CR2 = (spi.CR2 & ~SPI_CR2_DS) | (wordLength - 1) << SPI_CR2_DS_Pos;
 
 	dummyData_ = dummyData;
 
@@ -382,8 +363,8 @@ void ChipSpiMasterLowLevel::interruptHandler()
 {
 	bool done {};
 	auto& spi = parameters_.getSpi();
-	const auto sr = spi.SR;
-	const auto cr2 = spi.CR2;
+	const uint32_t sr = spi.SR;
+	const uint32_t cr2 = spi.CR2;
 	const auto wordLength = Parameters::getWordLength(cr2);
 
 	if ((sr & (SPI_SR_MODF | SPI_SR_OVR | SPI_SR_CRCERR)) != 0 && (cr2 & SPI_CR2_ERRIE) != 0)	// error?
@@ -396,8 +377,8 @@ void ChipSpiMasterLowLevel::interruptHandler()
 		}
 		if ((sr & SPI_SR_OVR) != 0)	// overrun error?
 		{
-			spi.DR;
-			spi.SR;	// clears OVR flag
+			static_cast<void>(spi.DR);
+			static_cast<void>(spi.SR);	// clears OVR flag
 			errorSet_[devices::SpiMasterErrorSet::overrunError] = true;
 		}
 		if ((sr & SPI_SR_CRCERR) != 0)	// CRC error?
@@ -406,61 +387,46 @@ void ChipSpiMasterLowLevel::interruptHandler()
 			errorSet_[devices::SpiMasterErrorSet::crcError] = true;
 		}
 
-		parameters_.enableTxeInterrupt(false);
-
 		if ((sr & SPI_SR_BSY) == 0)
 			done = true;
 	}
 	else if ((sr & SPI_SR_RXNE) != 0 && (cr2 & SPI_CR2_RXNEIE) != 0)	// read?
 	{
-		const uint16_t word = wordLength <= 8 ? *reinterpret_cast<volatile uint8_t*>(&spi.DR) : spi.DR;
 		const auto readBuffer = readBuffer_;
+		const auto size = size_;
 		auto readPosition = readPosition_;
-		if (readBuffer != nullptr)
+		// with FRXTH cleared RXNE is set when RX FIFO holds at least 16 bits - single long frame or two short frames
+		auto packed = (cr2 & SPI_CR2_FRXTH) == 0;
+		do
 		{
-			readBuffer[readPosition++] = word;
-			if (wordLength > 8)
-				readBuffer[readPosition++] = word >> 8;
-		}
-		else
-			readPosition += (wordLength + 8 - 1) / 8;
+			const uint16_t word = packed == true ? readDataRegister16(spi) : readDataRegister8(spi);
+			if (readBuffer != nullptr)
+			{
+				readBuffer[readPosition] = word;
+				if (packed == true)
+					readBuffer[readPosition + 1] = word >> 8;
+			}
+			readPosition += packed == true ? 2 : 1;
+
+			if (wordLength <= 8 && size - readPosition == 1)	// only one short frame left?
+			{
+				spi.CR2 = cr2 | SPI_CR2_FRXTH;
+				packed = false;
+			}
+		} while (readPosition != size && (spi.SR & SPI_SR_RXNE) != 0);
 		readPosition_ = readPosition;
-		if (readPosition == size_)
+
+		if (readPosition == size)
 		{
 			parameters_.enableRxneInterrupt(false);
 			done = true;
 		}
 		else
-			parameters_.enableTxeInterrupt(true);
-	}
-	else if ((sr & SPI_SR_TXE) != 0 && (cr2 & SPI_CR2_TXEIE) != 0)	// write?
-	{
-		const auto writeBuffer = writeBuffer_;
-		auto writePosition = writePosition_;
-		uint16_t word;
-		if (writeBuffer != nullptr)
-		{
-			const uint16_t characterLow = writeBuffer[writePosition++];
-			const uint16_t characterHigh = wordLength > 8 ? writeBuffer[writePosition++] : 0;
-			word = characterLow | characterHigh << 8;
-		}
-		else
-		{
-			writePosition += (wordLength + 8 - 1) / 8;
-			word = dummyData_;
-		}
-		writePosition_ = writePosition;
-		if (wordLength <= 8)
-			*reinterpret_cast<volatile uint8_t*>(&spi.DR) = word;
-		else
-			spi.DR = word;
-
-		parameters_.enableTxeInterrupt(false);
+			fillTxFifo(wordLength);
 	}
 
 	if (done == true)	// transfer finished of failed?
 	{
-		parameters_.enableTxeInterrupt(false);
 		parameters_.enableRxneInterrupt(false);
 		parameters_.enableErrInterrupt(false);
 		const auto errorSet = errorSet_;
@@ -506,7 +472,8 @@ int ChipSpiMasterLowLevel::startTransfer(devices::SpiMasterBase& spiMasterBase,
 	if (isTransferInProgress() == true)
 		return EBUSY;
 
-	if (size % ((parameters_.getWordLength() + 8 - 1) / 8) != 0)
+	const auto wordLength = parameters_.getWordLength();
+	if (size % ((wordLength + 8 - 1) / 8) != 0)
 		return EINVAL;
 
 	spiMasterBase_ = &spiMasterBase;
@@ -516,9 +483,15 @@ int ChipSpiMasterLowLevel::startTransfer(devices::SpiMasterBase& spiMasterBase,
 	readPosition_ = 0;
 	writePosition_ = 0;
 
+	// FRXTH may be cleared (RXNE set when RX FIFO holds at least 16 bits) only if at least 16 bits will be received
+	auto& spi = parameters_.getSpi();
+	spi.CR2 = (spi.CR2 & ~SPI_CR2_FRXTH) | (size == 1) << SPI_CR2_FRXTH_Pos;
+
+	// interrupts are still disabled, so the FIFO can be filled without any locks
+	fillTxFifo(wordLength);
+
 	parameters_.enableErrInterrupt(true);
 	parameters_.enableRxneInterrupt(true);
-	parameters_.enableTxeInterrupt(true);
 	return 0;
 }
 
@@ -536,6 +509,42 @@ int ChipSpiMasterLowLevel::stop()
 	return 0;
 }
 
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void ChipSpiMasterLowLevel::fillTxFifo(const uint8_t wordLength)
+{
+	auto& spi = parameters_.getSpi();
+	const auto writeBuffer = writeBuffer_;
+	const size_t size = size_;
+	const size_t readPosition = readPosition_;
+	auto writePosition = writePosition_;
+	// number of bytes which were written but not yet read never exceeds the size of RX FIFO, so it cannot overflow
+	const auto end = std::min(size, readPosition + spiFifoSize);
+	while (writePosition != end)
+	{
+		if (wordLength > 8 || end - writePosition >= 2)	// single long frame or two short frames?
+		{
+			uint16_t word;
+			if (writeBuffer != nullptr)
+				word = writeBuffer[writePosition] | writeBuffer[writePosition + 1] << 8;
+			else if (wordLength > 8)
+				word = dummyData_;
+			else
+				word = (dummyData_ & 0xff) | (dummyData_ & 0xff) << 8;
+			writeDataRegister16(spi, word);
+			writePosition += 2;
+		}
+		else
+		{
+			writeDataRegister8(spi, writeBuffer != nullptr ? writeBuffer[writePosition] : dummyData_);
+			++writePosition;
+		}
+	}
+	writePosition_ = writePosition;
+}
+
 }	// namespace chip
 
 }	// namespace distortos
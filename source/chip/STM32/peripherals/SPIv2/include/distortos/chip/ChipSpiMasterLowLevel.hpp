@@ -133,15 +133,11 @@ public:
 	/**
 	 * \brief Interrupt handler
 	 *
-	 * This code handles only one SPI event. If there are more events to handle, NVIC controller will keep the interrupt
-	 * pending, so it will be executed again immediately. Thanks to ARM's tail-chaining the time between exiting
-	 * previous instance and entering next instance is very short - just 6 core cycles, which is less than any manual
-	 * loop in the code. Speed gain is not significant (around 1-2%, depending on SPI clock frequency) and not linear
-	 * (for very high frequencies of SPI's clock the code with loop is significantly faster), but this version has two
-	 * major advantages:
-	 * - the code is simpler (and shorter),
-	 * - the code with loop doesn't work for some SPI clock frequencies (with divider == 8 almost all transfers fail due
-	 * to overflow).
+	 * Transfer is driven only by RXNE interrupt. Each instance reads everything that is available in RX FIFO - two
+	 * short frames (up to 8 bits) are read with a single 16-bit access - and then refills TX FIFO. The number of bytes
+	 * which were written but not yet read never exceeds the size of RX FIFO, so RX FIFO cannot overflow and TXE
+	 * interrupt is not needed. Compared to servicing each frame with separate TXE and RXNE interrupts, this reduces the
+	 * number of interrupts 4 times for short frames and 2 times for long frames.
 	 *
 	 * \note this must not be called by user code
 	 */
@@ -191,6 +187,17 @@ public:
 
 private:
 
+	/**
+	 * \brief Writes frames to TX FIFO of SPI.
+	 *
+	 * Frames are written until the end of transfer or until the number of bytes which were written but not yet read
+	 * reaches the size of RX FIFO. Two short frames (up to 8 bits) are written with a single 16-bit access.
+	 *
+	 * \param [in] wordLength is the current word length, bits, [minWordLength; maxWordLength]
+	 */
+
+	void fillTxFifo(uint8_t wordLength);
+
 	/**
 	 * \return true if driver is started, false otherwise
 	 */
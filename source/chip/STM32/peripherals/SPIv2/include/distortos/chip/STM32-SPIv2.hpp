@@ -0,0 +1,90 @@
+/**
+ * \file
+ * \brief Header for SPIv2 functions for STM32
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef SOURCE_CHIP_STM32_PERIPHERALS_SPIV2_INCLUDE_DISTORTOS_CHIP_STM32_SPIV2_HPP_
+#define SOURCE_CHIP_STM32_PERIPHERALS_SPIV2_INCLUDE_DISTORTOS_CHIP_STM32_SPIV2_HPP_
+
+#include "distortos/chip/CMSIS-proxy.h"
+
+namespace distortos
+{
+
+namespace chip
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// size of RX FIFO and TX FIFO of SPIv2, bytes
+constexpr size_t spiFifoSize {4};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Reads 8 bits from RX FIFO of SPI.
+ *
+ * \param [in] spi is a reference to SPI_TypeDef object
+ *
+ * \return single frame (up to 8 bits) read from RX FIFO
+ */
+
+inline uint8_t readDataRegister8(SPI_TypeDef& spi)
+{
+	return *reinterpret_cast<volatile uint8_t*>(&spi.DR);
+}
+
+/**
+ * \brief Reads 16 bits from RX FIFO of SPI.
+ *
+ * \param [in] spi is a reference to SPI_TypeDef object
+ *
+ * \return single frame (9 - 16 bits) or two packed frames (up to 8 bits each, first one in lower byte) read from RX
+ * FIFO
+ */
+
+inline uint16_t readDataRegister16(SPI_TypeDef& spi)
+{
+	return *reinterpret_cast<volatile uint16_t*>(&spi.DR);
+}
+
+/**
+ * \brief Writes 8 bits to TX FIFO of SPI.
+ *
+ * \param [in] spi is a reference to SPI_TypeDef object
+ * \param [in] value is the single frame (up to 8 bits) that will be written to TX FIFO
+ */
+
+inline void writeDataRegister8(SPI_TypeDef& spi, const uint8_t value)
+{
+	*reinterpret_cast<volatile uint8_t*>(&spi.DR) = value;
+}
+
+/**
+ * \brief Writes 16 bits to TX FIFO of SPI.
+ *
+ * \param [in] spi is a reference to SPI_TypeDef object
+ * \param [in] value is the single frame (9 - 16 bits) or two packed frames (up to 8 bits each, first one in lower
+ * byte) that will be written to TX FIFO
+ */
+
+inline void writeDataRegister16(SPI_TypeDef& spi, const uint16_t value)
+{
+	*reinterpret_cast<volatile uint16_t*>(&spi.DR) = value;
+}
+
+}	// namespace chip
+
+}	// namespace distortos
+
+#endif	// SOURCE_CHIP_STM32_PERIPHERALS_SPIV2_INCLUDE_DISTORTOS_CHIP_STM32_SPIV2_HPP_
@@ -2,7 +2,7 @@
  * \file
  * \brief ChipUartLowLevel class implementation for USARTv1 in STM32
  *
- * \author Copyright (C) 2016-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2016-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -16,6 +16,8 @@
 
 #include "distortos/devices/communication/UartBase.hpp"
 
+#include "distortos/InterruptMaskingLock.hpp"
+
 #include <cerrno>
 
 namespace distortos
@@ -320,6 +322,31 @@ void ChipUartLowLevel::interruptHandler()
 	}
 }
 
+int ChipUartLowLevel::setMuteMode(const devices::UartWakeup wakeup, const uint8_t address)
+{
+	if (isStarted() == false)
+		return EBADF;
+
+	if (isReadInProgress() == true || isWriteInProgress() == true)
+		return EBUSY;
+
+	const auto addressMark = wakeup == devices::UartWakeup::addressMark;
+	if (addressMark == true && address > (USART_CR2_ADD >> USART_CR2_ADD_Pos))
+		return EINVAL;
+
+	auto& uart = parameters_.getUart();
+	const InterruptMaskingLock interruptMaskingLock;
+	uart.CR2 = (uart.CR2 & ~USART_CR2_ADD) | (addressMark == true ? address << USART_CR2_ADD_Pos : 0);
+	uart.CR1 = (uart.CR1 & ~(USART_CR1_WAKE | USART_CR1_RWU)) | addressMark << USART_CR1_WAKE_Pos;
+	if (wakeup == devices::UartWakeup::none)
+		return 0;
+
+	if ((uart.SR & USART_SR_RXNE) != 0)	// RWU bit cannot be set while RXNE flag is set, drop pending character
+		uart.DR;
+	uart.CR1 |= USART_CR1_RWU;
+	return 0;
+}
+
 std::pair<int, uint32_t> ChipUartLowLevel::start(devices::UartBase& uartBase, const uint32_t baudRate,
 		const uint8_t characterLength, const devices::UartParity parity, const bool _2StopBits)
 {
@@ -2,7 +2,7 @@
  * \file
  * \brief ChipUartLowLevel class header for USARTv1 in STM32
  *
- * \author Copyright (C) 2016-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2016-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -145,6 +145,27 @@ public:
 
 	void interruptHandler();
 
+	/**
+	 * \brief Configures mute mode of receiver.
+	 *
+	 * When mute mode is enabled, the receiver is muted immediately. Characters received while the receiver is muted are
+	 * discarded by hardware - they are not reported with UartBase::readCompleteEvent() and they don't generate any
+	 * interrupts. Receiver is woken up by selected event - idle line or address character with matching node address.
+	 * Address character is the one which has its most significant bit set (bit 8 when character length is 9 bits), only
+	 * 4 least significant bits of this character are compared with node address.
+	 * Calling this function again with the same configuration mutes the receiver again.
+	 *
+	 * \param [in] wakeup selects wakeup method, UartWakeup::none disables mute mode
+	 * \param [in] address is the node address used with UartWakeup::addressMark, [0; 15], ignored otherwise
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not started;
+	 * - EBUSY - read and/or write are in progress;
+	 * - EINVAL - \a address is invalid;
+	 */
+
+	int setMuteMode(devices::UartWakeup wakeup, uint8_t address) override;
+
 	/**
 	 * \brief Starts low-level UART driver.
 	 *
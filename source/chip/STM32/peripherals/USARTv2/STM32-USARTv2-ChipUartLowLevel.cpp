@@ -2,7 +2,7 @@
  * \file
  * \brief ChipUartLowLevel class implementation for USARTv2 in STM32
  *
- * \author Copyright (C) 2016-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2016-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -16,12 +16,8 @@
 
 #include "distortos/devices/communication/UartBase.hpp"
 
-#ifndef DISTORTOS_BITBANDING_SUPPORTED
-
 #include "distortos/InterruptMaskingLock.hpp"
 
-#endif	// !def DISTORTOS_BITBANDING_SUPPORTED
-
 #include <cerrno>
 
 #if !defined(USART_CR1_M0)
@@ -442,6 +438,32 @@ void ChipUartLowLevel::interruptHandler()
 	}
 }
 
+int ChipUartLowLevel::setMuteMode(const devices::UartWakeup wakeup, const uint8_t address)
+{
+	if (isStarted() == false)
+		return EBADF;
+
+	auto& uart = parameters_.getUart();
+	if (isReadInProgress() == true || isWriteInProgress() == true || (uart.ISR & USART_ISR_TC) == 0)
+		return EBUSY;
+
+	const auto addressMark = wakeup == devices::UartWakeup::addressMark;
+	// with ADDM7 set node address is compared with all bits of frame except the most significant one
+	const auto frameLength = parameters_.getCharacterLength() + ((uart.CR1 & USART_CR1_PCE) != 0);
+	if (addressMark == true && address >= 1u << (frameLength - 1))
+		return EINVAL;
+
+	const InterruptMaskingLock interruptMaskingLock;
+	const auto cr1 = uart.CR1 & ~(USART_CR1_WAKE | USART_CR1_MME);
+	uart.CR1 = cr1 & ~USART_CR1_UE;	// WAKE bit and ADD field can be modified only when USART is disabled
+	uart.CR2 = (uart.CR2 & ~(USART_CR2_ADD | USART_CR2_ADDM7)) |
+			(addressMark == true ? address << USART_CR2_ADD_Pos | USART_CR2_ADDM7 : 0);
+	uart.CR1 = cr1 | addressMark << USART_CR1_WAKE_Pos | (wakeup != devices::UartWakeup::none) << USART_CR1_MME_Pos;
+	if (wakeup != devices::UartWakeup::none)
+		uart.RQR = USART_RQR_MMRQ;
+	return 0;
+}
+
 std::pair<int, uint32_t> ChipUartLowLevel::start(devices::UartBase& uartBase, const uint32_t baudRate,
 		const uint8_t characterLength, const devices::UartParity parity, const bool _2StopBits)
 {
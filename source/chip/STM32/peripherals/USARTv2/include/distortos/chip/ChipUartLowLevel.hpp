@@ -2,7 +2,7 @@
  * \file
  * \brief ChipUartLowLevel class header for USARTv2 in STM32
  *
- * \author Copyright (C) 2016-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2016-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -163,6 +163,29 @@ public:
 
 	void interruptHandler();
 
+	/**
+	 * \brief Configures mute mode of receiver.
+	 *
+	 * When mute mode is enabled, the receiver is muted immediately. Characters received while the receiver is muted are
+	 * discarded by hardware - they are not reported with UartBase::readCompleteEvent() and they don't generate any
+	 * interrupts. Receiver is woken up by selected event - idle line or address character with matching node address.
+	 * Address character is the one which has its most significant bit set (bit 8 when character length is 9 bits), all
+	 * remaining bits of this character are compared with node address - 6 bits for 7-bit frames, 7 bits for 8-bit
+	 * frames and 8 bits for 9-bit frames (frame length includes parity bit).
+	 * Calling this function again with the same configuration mutes the receiver again.
+	 *
+	 * \param [in] wakeup selects wakeup method, UartWakeup::none disables mute mode
+	 * \param [in] address is the node address used with UartWakeup::addressMark, [0; 63] for 7-bit frames, [0; 127]
+	 * for 8-bit frames, [0; 255] for 9-bit frames, ignored otherwise
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not started;
+	 * - EBUSY - read and/or write are in progress or transmission is not complete yet;
+	 * - EINVAL - \a address is out of range for configured frame length;
+	 */
+
+	int setMuteMode(devices::UartWakeup wakeup, uint8_t address) override;
+
 	/**
 	 * \brief Starts low-level UART driver.
 	 *
@@ -13,6 +13,8 @@
 
 #include "distortos/devices/communication/UartLowLevel.hpp"
 
+#include "distortos/devices/io/IoRequest.hpp"
+
 #include "distortos/internal/CHECK_FUNCTION_CONTEXT.hpp"
 
 #include "distortos/InterruptMaskingLock.hpp"
@@ -104,11 +106,27 @@ SerialPort::~SerialPort()
 	const std::lock_guard<Mutex> readLockGuard {readMutex_};
 	const std::lock_guard<Mutex> writeLockGuard {writeMutex_};
 
+	cancelReadRequest();
+	cancelWriteRequest();
 	uart_.stopRead();
 	uart_.stopWrite();
 	uart_.stop();
 }
 
+int SerialPort::cancel(IoRequest& request)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (readRequest_ == &request)
+		cancelReadRequest();
+	else if (writeRequest_ == &request)
+		cancelWriteRequest();
+	else
+		return EINVAL;
+
+	return 0;
+}
+
 int SerialPort::close()
 {
 	const std::lock_guard<Mutex> readLockGuard {readMutex_};
@@ -119,22 +137,13 @@ int SerialPort::close()
 
 	if (openCount_ == 1)	// last close?
 	{
-		while (transmitInProgress_ == true)	// wait for physical end of write operation
+		cancelReadRequest();
+		cancelWriteRequest();
+
 		{
-			Semaphore semaphore {0};
-			transmitSemaphore_ = &semaphore;
-			const auto transmitSemaphoreScopeGuard = estd::makeScopeGuard(
-					[this]()
-					{
-						transmitSemaphore_ = {};
-					});
-
-			if (transmitInProgress_ == true)
-			{
-				const auto ret = semaphore.wait();
-				if (ret != 0)
-					return ret;
-			}
+			const auto ret = waitForTransmitComplete();
+			if (ret != 0)
+				return ret;
 		}
 
 		stopReadWrapper();
@@ -170,16 +179,26 @@ int SerialPort::open(const uint32_t baudRate, const uint8_t characterLength, con
 			if (ret.first != 0)
 				return ret.first;
 		}
-		{
-			const auto ret = startReadWrapper();
-			if (ret != 0)
-				return ret;
-		}
 
 		baudRate_ = baudRate;
 		characterLength_ = characterLength;
 		parity_ = parity;
 		_2StopBits_ = _2StopBits;
+
+		if (wakeup_ != UartWakeup::none)
+		{
+			const auto ret = uart_.setMuteMode(wakeup_, nodeAddress_);
+			if (ret != 0)
+			{
+				uart_.stop();
+				return ret;
+			}
+		}
+		{
+			const auto ret = startReadWrapper();
+			if (ret != 0)
+				return ret;
+		}
 	}
 	else	// if (openCount_ != 0)
 	{
@@ -213,6 +232,9 @@ std::pair<int, size_t> SerialPort::read(void* const buffer, const size_t size, c
 	if (openCount_ == 0)
 		return {EBADF, {}};
 
+	if (readRequest_ != nullptr)
+		return {EBUSY, {}};
+
 	if (characterLength_ > 8 && size % 2 != 0)
 		return {EINVAL, {}};
 
@@ -222,6 +244,189 @@ std::pair<int, size_t> SerialPort::read(void* const buffer, const size_t size, c
 	return {ret != 0 || bytesRead != 0 ? ret : EAGAIN, bytesRead};
 }
 
+int SerialPort::setMuteMode(const UartWakeup wakeup, const uint8_t nodeAddress)
+{
+	const std::lock_guard<Mutex> readLockGuard {readMutex_};
+	const std::lock_guard<Mutex> writeLockGuard {writeMutex_};
+
+	if (openCount_ != 0)
+	{
+		{
+			const auto ret = waitForTransmitComplete();
+			if (ret != 0)
+				return ret;
+		}
+
+		const InterruptMaskingLock interruptMaskingLock;
+
+		stopReadWrapper();
+		const auto ret = uart_.setMuteMode(wakeup, nodeAddress);
+		startReadWrapper();
+		if (ret != 0)
+			return ret;
+	}
+
+	wakeup_ = wakeup;
+	nodeAddress_ = nodeAddress;
+	return 0;
+}
+
+void SerialPort::setReceiveHook(const ReceiveHook receiveHook)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	// restart read operation, as its size depends on presence of receive hook
+	const auto readInProgress = readInProgress_;
+	if (readInProgress == true)
+		stopReadWrapper();
+	receiveHook_ = receiveHook;
+	if (readInProgress == true)
+		startReadWrapper();
+}
+
+int SerialPort::startRead(IoRequest& request, void* const buffer, const size_t size, const size_t minSize)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	if (buffer == nullptr || size == 0)
+		return EINVAL;
+
+	{
+		const auto ret = readMutex_.tryLock();
+		if (ret != 0)
+			return ret;
+	}
+
+	const std::lock_guard<Mutex> readLockGuard {readMutex_, std::adopt_lock};
+
+	if (openCount_ == 0)
+		return EBADF;
+
+	if (readRequest_ != nullptr)
+		return EBUSY;
+
+	if (characterLength_ > 8 && size % 2 != 0)
+		return EINVAL;
+
+	{
+		const auto ret = request.begin();
+		if (ret != 0)
+			return ret;
+	}
+
+	// when character length is greater than 8 bits, round up "minSize" value
+	const auto adjustedMinSize = std::min(size, characterLength_ <= 8 ? minSize : ((minSize + 1) / 2) * 2);
+
+	readRequestBuffer_ = CircularBuffer{buffer, size};
+
+	// initially read as much data as possible from circular buffer with interrupts enabled
+	{
+		const auto ret = readFromCircularBufferAndStartRead(readRequestBuffer_);
+		if (ret != 0)
+		{
+			request.abort();
+			return ret;
+		}
+	}
+
+	if (readRequestBuffer_.getSize() < adjustedMinSize)
+	{
+		// Current read transfer (if any) must be stopped to get the data it already received. Unlike read(), this data
+		// is copied with interrupts masked, because the request may be completed in interrupt context as soon as the
+		// interrupts are enabled. The amount of this data never exceeds the size of single transfer to internal buffer.
+		const InterruptMaskingLock interruptMaskingLock;
+		stopReadWrapper();
+		while (copySingleBlock(readBuffer_, readRequestBuffer_) != 0);
+		const auto bytesRead = readRequestBuffer_.getSize();
+
+		if (adjustedMinSize > bytesRead)	// is asynchronous read required?
+		{
+			// arrange read operation directly to request's buffer
+			nextReadBuffer_ = &readBuffer_;
+			currentReadBuffer_ = &readRequestBuffer_;
+			readLimit_ = adjustedMinSize - bytesRead;
+			readRequest_ = &request;
+		}
+
+		const auto ret = startReadWrapper();
+		if (ret != 0)
+		{
+			readLimit_ = {};
+			readRequest_ = {};
+			nextReadBuffer_ = {};
+			currentReadBuffer_ = &readBuffer_;
+			request.abort();
+			return ret;
+		}
+
+		if (readRequest_ != nullptr)
+			return 0;
+	}
+
+	request.complete(0, readRequestBuffer_.getSize());
+	return 0;
+}
+
+int SerialPort::startWrite(IoRequest& request, const void* const buffer, const size_t size)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	if (buffer == nullptr || size == 0)
+		return EINVAL;
+
+	{
+		const auto ret = writeMutex_.tryLock();
+		if (ret != 0)
+			return ret;
+	}
+
+	const std::lock_guard<Mutex> writeLockGuard {writeMutex_, std::adopt_lock};
+
+	if (openCount_ == 0)
+		return EBADF;
+
+	if (writeRequest_ != nullptr)
+		return EBUSY;
+
+	if (characterLength_ > 8 && size % 2 != 0)
+		return EINVAL;
+
+	{
+		const auto ret = request.begin();
+		if (ret != 0)
+			return ret;
+	}
+
+	writeRequestBuffer_ = CircularBuffer{buffer, size};	// buffer is read-only
+	writeRequestBuffer_.increaseWritePosition(size);	// make the buffer "full"
+
+	// Current write transfer (if any) must be stopped for a short moment to arrange write operation directly from
+	// request's buffer - either immediately (if internal buffer is empty) or after internal buffer is emptied.
+	const InterruptMaskingLock interruptMaskingLock;
+	stopWriteWrapper();
+	if (writeBuffer_.isEmpty() == true)	// internal buffer is empty?
+	{
+		currentWriteBuffer_ = &writeRequestBuffer_;	// start with request's buffer
+		nextWriteBuffer_ = &writeBuffer_;
+	}
+	else
+		nextWriteBuffer_ = &writeRequestBuffer_;
+	writeRequest_ = &request;
+
+	const auto ret = startWriteWrapper();
+	if (ret != 0)
+	{
+		writeRequest_ = {};
+		nextWriteBuffer_ = {};
+		currentWriteBuffer_ = &writeBuffer_;
+		request.abort();
+	}
+
+	return ret;
+}
+
 std::pair<int, size_t> SerialPort::write(const void* const buffer, const size_t size, const size_t minSize,
 		const TickClock::time_point* const timePoint)
 {
@@ -242,6 +447,9 @@ std::pair<int, size_t> SerialPort::write(const void* const buffer, const size_t
 	if (openCount_ == 0)
 		return {EBADF, {}};
 
+	if (writeRequest_ != nullptr)
+		return {EBUSY, {}};
+
 	if (characterLength_ > 8 && size % 2 != 0)
 		return {EINVAL, {}};
 
@@ -259,7 +467,12 @@ std::pair<int, size_t> SerialPort::write(const void* const buffer, const size_t
 void SerialPort::readCompleteEvent(const size_t bytesRead)
 {
 	const auto currentReadBuffer = currentReadBuffer_;
-	currentReadBuffer->increaseWritePosition(bytesRead);
+	// with receive hook reads are done one character at a time, so data returned by stopRead() never skips the hook
+	const auto receiveHook = receiveHook_;
+	const auto hookRet = receiveHook != nullptr && bytesRead != 0 ?
+			receiveHook(*this, currentReadBuffer->getWriteBlock().first, bytesRead) : std::make_pair(bytesRead, false);
+	const auto bytesKept = hookRet.first;
+	currentReadBuffer->increaseWritePosition(bytesKept);
 
 	const auto nextReadBuffer = nextReadBuffer_;
 	if (nextReadBuffer != nullptr && currentReadBuffer->isFull() == true)
@@ -269,7 +482,8 @@ void SerialPort::readCompleteEvent(const size_t bytesRead)
 	}
 
 	const auto oldReadLimit = readLimit_;
-	const auto newReadLimit = oldReadLimit - (bytesRead < oldReadLimit ? bytesRead : oldReadLimit);
+	const auto newReadLimit = hookRet.second == true ? 0 :
+			oldReadLimit - (bytesKept < oldReadLimit ? bytesKept : oldReadLimit);
 	readLimit_ = newReadLimit;
 	if (newReadLimit == 0 && oldReadLimit != 0)
 	{
@@ -279,6 +493,9 @@ void SerialPort::readCompleteEvent(const size_t bytesRead)
 			readSemaphore->post();
 			readSemaphore_ = {};
 		}
+
+		if (readRequest_ != nullptr)
+			completeReadRequest(0);
 	}
 
 	readInProgress_ = false;
@@ -333,6 +550,9 @@ void SerialPort::writeCompleteEvent(const size_t bytesWritten)
 		}
 	}
 
+	if (writeRequest_ != nullptr && writeRequestBuffer_.isEmpty() == true)
+		completeWriteRequest(0);
+
 	writeInProgress_ = false;
 
 	startWriteWrapper();
@@ -342,6 +562,49 @@ void SerialPort::writeCompleteEvent(const size_t bytesWritten)
 | private functions
 +---------------------------------------------------------------------------------------------------------------------*/
 
+void SerialPort::cancelReadRequest()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (readRequest_ == nullptr)
+		return;
+
+	stopReadWrapper();
+	completeReadRequest(readLimit_ == 0 ? 0 : ECANCELED);
+	startReadWrapper();
+}
+
+void SerialPort::cancelWriteRequest()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (writeRequest_ == nullptr)
+		return;
+
+	stopWriteWrapper();
+	completeWriteRequest(writeRequestBuffer_.isEmpty() == true ? 0 : ECANCELED);
+	startWriteWrapper();
+}
+
+void SerialPort::completeReadRequest(const int ret)
+{
+	const auto request = readRequest_;
+	readRequest_ = {};
+	readLimit_ = {};
+	nextReadBuffer_ = {};
+	currentReadBuffer_ = &readBuffer_;
+	request->complete(ret, readRequestBuffer_.getSize());
+}
+
+void SerialPort::completeWriteRequest(const int ret)
+{
+	const auto request = writeRequest_;
+	writeRequest_ = {};
+	nextWriteBuffer_ = {};
+	currentWriteBuffer_ = &writeBuffer_;
+	request->complete(ret, writeRequestBuffer_.getCapacity() - writeRequestBuffer_.getSize());
+}
+
 int SerialPort::readFromCircularBufferAndStartRead(CircularBuffer& buffer)
 {
 	while (copySingleBlock(readBuffer_, buffer) != 0)
@@ -445,8 +708,9 @@ int SerialPort::startReadWrapper()
 	const auto readBufferHalf = currentReadBuffer == &readBuffer_ ?
 			((currentReadBuffer->getCapacity() / 2 + 1) / 2) * 2 : SIZE_MAX;
 	const auto readLimit = readLimit_;
+	const size_t characterSize = receiveHook_ != nullptr ? (characterLength_ <= 8 ? 1 : 2) : SIZE_MAX;
 	return uart_.startRead(writeBlock.first,
-			std::min({writeBlock.second, readBufferHalf, readLimit != 0 ? readLimit : SIZE_MAX}));
+			std::min({writeBlock.second, readBufferHalf, readLimit != 0 ? readLimit : SIZE_MAX, characterSize}));
 }
 
 int SerialPort::startWriteWrapper()
@@ -488,6 +752,29 @@ size_t SerialPort::stopWriteWrapper()
 	return bytesWritten;
 }
 
+int SerialPort::waitForTransmitComplete()
+{
+	while (transmitInProgress_ == true)	// wait for physical end of write operation
+	{
+		Semaphore semaphore {0};
+		transmitSemaphore_ = &semaphore;
+		const auto transmitSemaphoreScopeGuard = estd::makeScopeGuard(
+				[this]()
+				{
+					transmitSemaphore_ = {};
+				});
+
+		if (transmitInProgress_ == true)
+		{
+			const auto ret = semaphore.wait();
+			if (ret != 0)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
 int SerialPort::writeImplementation(CircularBuffer& buffer, const size_t minSize,
 		const TickClock::time_point* const timePoint)
 {
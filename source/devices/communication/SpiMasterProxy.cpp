@@ -16,9 +16,12 @@
 #include "distortos/devices/communication/SpiMasterLowLevel.hpp"
 #include "distortos/devices/communication/SpiMasterOperation.hpp"
 
+#include "distortos/devices/io/IoRequest.hpp"
+
 #include "distortos/internal/CHECK_FUNCTION_CONTEXT.hpp"
 
 #include "distortos/assert.h"
+#include "distortos/InterruptMaskingLock.hpp"
 #include "distortos/Semaphore.hpp"
 
 #include "estd/ScopeGuard.hpp"
@@ -37,16 +40,35 @@ SpiMasterProxy::SpiMasterProxy(const SpiDeviceProxy& spiDeviceProxy) :
 		operationsRange_{},
 		spiDeviceProxy_{spiDeviceProxy},
 		ret_{},
-		semaphore_{}
+		semaphore_{},
+		request_{},
+		requestOperations_{},
+		cancelRequested_{}
 {
 	getSpiMaster().mutex_.lock();
 }
 
 SpiMasterProxy::~SpiMasterProxy()
 {
+	assert(request_ == nullptr && "Asynchronous transaction is still pending!");
+
 	getSpiMaster().mutex_.unlock();
 }
 
+int SpiMasterProxy::cancel(IoRequest& request)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (request_ != &request)
+		return EINVAL;
+
+	if (operationsRange_.size() <= 1)	// last operation is in progress?
+		return EBUSY;
+
+	cancelRequested_ = true;
+	return 0;
+}
+
 std::pair<int, uint32_t> SpiMasterProxy::configure(const SpiMode mode, const uint32_t clockFrequency,
 		const uint8_t wordLength, const bool lsbFirst, const uint32_t dummyData) const
 {
@@ -68,6 +90,9 @@ std::pair<int, size_t> SpiMasterProxy::executeTransaction(const SpiMasterOperati
 	if (spiDeviceProxy_.isOpened() == false || spiMaster.openCount_ == 0)
 		return {EBADF, {}};
 
+	if (request_ != nullptr)
+		return {EBUSY, {}};
+
 	Semaphore semaphore {0};
 	semaphore_ = &semaphore;
 	operationsRange_ = operationsRange;
@@ -94,6 +119,44 @@ std::pair<int, size_t> SpiMasterProxy::executeTransaction(const SpiMasterOperati
 	return {ret_, handledOperations};
 }
 
+int SpiMasterProxy::startTransaction(IoRequest& request, const SpiMasterOperationsRange operationsRange)
+{
+	if (operationsRange.size() == 0)
+		return EINVAL;
+
+	auto& spiMaster = getSpiMaster();
+	if (spiDeviceProxy_.isOpened() == false || spiMaster.openCount_ == 0)
+		return EBADF;
+
+	if (request_ != nullptr)
+		return EBUSY;
+
+	{
+		const auto ret = request.begin();
+		if (ret != 0)
+			return ret;
+	}
+
+	request_ = &request;
+	requestOperations_ = operationsRange.size();
+	cancelRequested_ = {};
+	operationsRange_ = operationsRange;
+	ret_ = {};
+
+	const auto transfer = operationsRange_.begin()->getTransfer();
+	assert(transfer != nullptr);
+	const auto ret = spiMaster.spiMaster_.startTransfer(*this, transfer->getWriteBuffer(), transfer->getReadBuffer(),
+			transfer->getSize());
+	if (ret != 0)
+	{
+		operationsRange_ = {};
+		request_ = {};
+		request.abort();
+	}
+
+	return ret;
+}
+
 /*---------------------------------------------------------------------------------------------------------------------+
 | private functions
 +---------------------------------------------------------------------------------------------------------------------*/
@@ -111,6 +174,17 @@ SpiMaster& SpiMasterProxy::getSpiMaster() const
 void SpiMasterProxy::notifyWaiter(const int ret)
 {
 	ret_ = ret;
+
+	const auto request = request_;
+	if (request != nullptr)
+	{
+		const auto handledOperations = requestOperations_ - operationsRange_.size();
+		operationsRange_ = {};
+		request_ = {};
+		request->complete(ret, handledOperations);
+		return;
+	}
+
 	const auto semaphore = semaphore_;
 	assert(semaphore != nullptr);
 	semaphore->post();
@@ -136,6 +210,12 @@ void SpiMasterProxy::transferCompleteEvent(SpiMasterErrorSet errorSet, size_t by
 		return;
 	}
 
+	if (cancelRequested_ == true)	// cancellation of asynchronous transaction was requested?
+	{
+		notifyWaiter(ECANCELED);
+		return;
+	}
+
 	{
 		const auto nextTransfer = operationsRange_.begin()->getTransfer();
 		assert(nextTransfer != nullptr && "Invalid type of next operation!");
@@ -0,0 +1,74 @@
+/**
+ * \file
+ * \brief IoCompletionQueue class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/io/IoCompletionQueue.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int IoCompletionQueue::pop(IoRequest*& request)
+{
+	return popInternal(semaphore_.wait(), request);
+}
+
+int IoCompletionQueue::tryPop(IoRequest*& request)
+{
+	return popInternal(semaphore_.tryWait(), request);
+}
+
+int IoCompletionQueue::tryPopFor(const TickClock::duration duration, IoRequest*& request)
+{
+	return popInternal(semaphore_.tryWaitFor(duration), request);
+}
+
+int IoCompletionQueue::tryPopUntil(const TickClock::time_point timePoint, IoRequest*& request)
+{
+	return popInternal(semaphore_.tryWaitUntil(timePoint), request);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int IoCompletionQueue::popInternal(const int ret, IoRequest*& request)
+{
+	if (ret != 0)
+		return ret;
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	request = &list_.front();
+	list_.pop_front();
+	return 0;
+}
+
+void IoCompletionQueue::push(IoRequest& request)
+{
+	{
+		const InterruptMaskingLock interruptMaskingLock;
+		list_.push_back(request);
+	}
+
+	semaphore_.post();
+}
+
+}	// namespace devices
+
+}	// namespace distortos
@@ -0,0 +1,62 @@
+/**
+ * \file
+ * \brief IoRequest class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/io/IoRequest.hpp"
+
+#include "distortos/devices/io/IoCompletionQueue.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int IoRequest::begin()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (pending_ == true || node_.isLinked() == true)
+		return EBUSY;
+
+	pending_ = true;
+	return 0;
+}
+
+void IoRequest::complete(const int ret, const size_t size)
+{
+	{
+		const InterruptMaskingLock interruptMaskingLock;
+
+		ret_ = ret;
+		size_ = size;
+		pending_ = false;
+
+		const auto completionQueue = completionQueue_;
+		if (completionQueue != nullptr)
+			completionQueue->push(*this);
+	}
+
+	const auto callback = callback_;
+	if (callback != nullptr)
+		callback(*this);
+}
+
+}	// namespace devices
+
+}	// namespace distortos
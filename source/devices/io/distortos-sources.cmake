@@ -8,4 +8,6 @@
 #
 
 target_sources(distortos PRIVATE
-		${CMAKE_CURRENT_LIST_DIR}/InputPin.cpp)
+		${CMAKE_CURRENT_LIST_DIR}/InputPin.cpp
+		${CMAKE_CURRENT_LIST_DIR}/IoCompletionQueue.cpp
+		${CMAKE_CURRENT_LIST_DIR}/IoRequest.cpp)
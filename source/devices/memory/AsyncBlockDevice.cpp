@@ -0,0 +1,179 @@
+/**
+ * \file
+ * \brief AsyncBlockDevice class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/memory/AsyncBlockDevice.hpp"
+
+#include "distortos/devices/io/IoRequest.hpp"
+
+#include "distortos/devices/memory/BlockDevice.hpp"
+
+#include "distortos/internal/CHECK_FUNCTION_CONTEXT.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+AsyncBlockDevice::~AsyncBlockDevice()
+{
+
+}
+
+int AsyncBlockDevice::cancel(IoRequest& request)
+{
+	{
+		const InterruptMaskingLock interruptMaskingLock;
+
+		if (request_ != &request)
+			return EINVAL;
+
+		if (executing_ == true)
+			return EBUSY;
+
+		request_ = {};
+	}
+
+	request.complete(ECANCELED, {});
+	return 0;
+}
+
+int AsyncBlockDevice::startErase(IoRequest& request, const uint64_t address, const uint64_t size)
+{
+	return startOperation(request, Operation::erase, address, size, nullptr, nullptr);
+}
+
+int AsyncBlockDevice::startProgram(IoRequest& request, const uint64_t address, const void* const buffer,
+		const size_t size)
+{
+	return startOperation(request, Operation::program, address, size, buffer, nullptr);
+}
+
+int AsyncBlockDevice::startRead(IoRequest& request, const uint64_t address, void* const buffer, const size_t size)
+{
+	return startOperation(request, Operation::read, address, size, nullptr, buffer);
+}
+
+int AsyncBlockDevice::startSynchronize(IoRequest& request)
+{
+	return startOperation(request, Operation::synchronize, {}, {}, nullptr, nullptr);
+}
+
+int AsyncBlockDevice::startTrim(IoRequest& request, const uint64_t address, const uint64_t size)
+{
+	return startOperation(request, Operation::trim, address, size, nullptr, nullptr);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| protected functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void AsyncBlockDevice::requestWorkerExit()
+{
+	exitRequested_ = true;
+	requestSemaphore_.post();
+}
+
+void AsyncBlockDevice::runWorker(AsyncBlockDevice* const asyncBlockDevice)
+{
+	while (1)
+	{
+		while (asyncBlockDevice->requestSemaphore_.wait() != 0);
+
+		if (asyncBlockDevice->exitRequested_ == true)
+			return;
+
+		asyncBlockDevice->execute();
+	}
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void AsyncBlockDevice::execute()
+{
+	{
+		const InterruptMaskingLock interruptMaskingLock;
+
+		if (request_ == nullptr)	// request was cancelled before it was taken by worker thread?
+			return;
+
+		executing_ = true;
+	}
+
+	std::pair<int, size_t> ret {};
+	if (operation_ == Operation::erase)
+		ret.first = device_.erase(address_, size_);
+	else if (operation_ == Operation::program)
+		ret = device_.program(address_, programBuffer_, size_);
+	else if (operation_ == Operation::read)
+		ret = device_.read(address_, readBuffer_, size_);
+	else if (operation_ == Operation::synchronize)
+		ret.first = device_.synchronize();
+	else	// if (operation_ == Operation::trim)
+		ret.first = device_.trim(address_, size_);
+
+	const auto request = request_;
+
+	{
+		const InterruptMaskingLock interruptMaskingLock;
+		request_ = {};
+		executing_ = false;
+	}
+
+	request->complete(ret.first, ret.second);
+}
+
+int AsyncBlockDevice::startOperation(IoRequest& request, const Operation operation, const uint64_t address,
+		const uint64_t size, const void* const programBuffer, void* const readBuffer)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	{
+		const auto ret = startWorker();
+		if (ret != 0)
+			return ret;
+	}
+
+	{
+		const InterruptMaskingLock interruptMaskingLock;
+
+		if (request_ != nullptr)
+			return EBUSY;
+
+		const auto ret = request.begin();
+		if (ret != 0)
+			return ret;
+
+		programBuffer_ = programBuffer;
+		readBuffer_ = readBuffer;
+		address_ = address;
+		size_ = size;
+		operation_ = operation;
+		request_ = &request;
+	}
+
+	requestSemaphore_.post();
+	return 0;
+}
+
+}	// namespace devices
+
+}	// namespace distortos
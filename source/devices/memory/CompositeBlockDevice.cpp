@@ -0,0 +1,421 @@
+/**
+ * \file
+ * \brief CompositeBlockDevice class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/memory/CompositeBlockDevice.hpp"
+
+#include "distortos/assert.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+CompositeBlockDevice::~CompositeBlockDevice()
+{
+	assert(openCount_ == 0);
+}
+
+int CompositeBlockDevice::close()
+{
+	const std::lock_guard<CompositeBlockDevice> lockGuard {*this};
+
+	if (openCount_ == 0)	// device is not open anymore?
+		return EBADF;
+
+	const auto ret = openCount_ == 1 ? closeMembers(membersRange_.size()) : 0;	// close members on last close
+	--openCount_;
+	return ret;
+}
+
+int CompositeBlockDevice::erase(const uint64_t address, const uint64_t size)
+{
+	const std::lock_guard<CompositeBlockDevice> lockGuard {*this};
+
+	{
+		const auto ret = checkRange(address, size, eraseBlockSize_);
+		if (ret != 0)
+			return ret;
+	}
+
+	return execute(Operation::erase, address, nullptr, nullptr, size).first;
+}
+
+size_t CompositeBlockDevice::getEraseBlockSize() const
+{
+	return eraseBlockSize_;
+}
+
+std::pair<bool, uint8_t> CompositeBlockDevice::getErasedValue() const
+{
+	if (membersRange_.size() == 0)
+		return {};
+
+	const auto erasedValue = membersRange_.begin()[0]->device_.getErasedValue();
+	for (const auto member : membersRange_)
+		if (member->device_.getErasedValue() != erasedValue)
+			return {};
+
+	return erasedValue;
+}
+
+size_t CompositeBlockDevice::getProgramBlockSize() const
+{
+	return programBlockSize_;
+}
+
+size_t CompositeBlockDevice::getReadBlockSize() const
+{
+	return readBlockSize_;
+}
+
+uint64_t CompositeBlockDevice::getSize() const
+{
+	return size_;
+}
+
+int CompositeBlockDevice::lock()
+{
+	return mutex_.lock();
+}
+
+int CompositeBlockDevice::open()
+{
+	const std::lock_guard<CompositeBlockDevice> lockGuard {*this};
+
+	if (openCount_ == std::numeric_limits<decltype(openCount_)>::max())	// device is already opened too many times?
+		return EMFILE;
+
+	if (openCount_ == 0)	// first open?
+	{
+		const auto count = membersRange_.size();
+		if (count == 0)
+			return EINVAL;
+
+		for (size_t i {}; i < count; ++i)
+		{
+			const auto ret = membersRange_.begin()[i]->device_.open();
+			if (ret != 0)
+			{
+				closeMembers(i);
+				return ret;
+			}
+		}
+
+		size_t eraseBlockSize {};
+		size_t programBlockSize {};
+		size_t readBlockSize {};
+		auto memberSize = std::numeric_limits<uint64_t>::max();
+		for (const auto member : membersRange_)
+		{
+			eraseBlockSize = std::max(eraseBlockSize, member->device_.getEraseBlockSize());
+			programBlockSize = std::max(programBlockSize, member->device_.getProgramBlockSize());
+			readBlockSize = std::max(readBlockSize, member->device_.getReadBlockSize());
+			memberSize = std::min(memberSize, member->device_.getSize());
+		}
+
+		auto valid = eraseBlockSize != 0 && programBlockSize != 0 && readBlockSize != 0 &&
+				eraseBlockSize % programBlockSize == 0 && eraseBlockSize % readBlockSize == 0 &&
+				memberSize >= eraseBlockSize;
+		for (size_t i {}; valid == true && i < count; ++i)
+		{
+			const auto& device = membersRange_.begin()[i]->device_;
+			valid = eraseBlockSize % device.getEraseBlockSize() == 0 &&
+					programBlockSize % device.getProgramBlockSize() == 0 &&
+					readBlockSize % device.getReadBlockSize() == 0;
+		}
+		if (valid == false)
+		{
+			closeMembers(count);
+			return EINVAL;
+		}
+
+		for (size_t i {}; i < count; ++i)
+		{
+			auto& member = *membersRange_.begin()[i];
+			member.composite_ = this;
+			member.index_ = i;
+			const auto ret = member.startHelper();
+			if (ret != 0)
+			{
+				closeMembers(count);
+				return ret;
+			}
+		}
+
+		memberSize = memberSize / eraseBlockSize * eraseBlockSize;
+		size_ = mode_ == Mode::striped ? memberSize * count : memberSize;
+		eraseBlockSize_ = eraseBlockSize;
+		programBlockSize_ = programBlockSize;
+		readBlockSize_ = readBlockSize;
+		nextReader_ = {};
+	}
+
+	++openCount_;
+	return 0;
+}
+
+std::pair<int, size_t> CompositeBlockDevice::program(const uint64_t address, const void* const buffer,
+		const size_t size)
+{
+	const std::lock_guard<CompositeBlockDevice> lockGuard {*this};
+
+	if (buffer == nullptr)
+		return {EINVAL, {}};
+
+	{
+		const auto ret = checkRange(address, size, programBlockSize_);
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	const auto ret = execute(Operation::program, address, buffer, nullptr, size);
+	return {ret.first, ret.second};
+}
+
+std::pair<int, size_t> CompositeBlockDevice::read(const uint64_t address, void* const buffer, const size_t size)
+{
+	const std::lock_guard<CompositeBlockDevice> lockGuard {*this};
+
+	if (buffer == nullptr)
+		return {EINVAL, {}};
+
+	{
+		const auto ret = checkRange(address, size, readBlockSize_);
+		if (ret != 0)
+			return {ret, {}};
+	}
+
+	const auto ret = execute(Operation::read, address, nullptr, buffer, size);
+	return {ret.first, ret.second};
+}
+
+int CompositeBlockDevice::synchronize()
+{
+	const std::lock_guard<CompositeBlockDevice> lockGuard {*this};
+
+	if (openCount_ == 0)
+		return EBADF;
+
+	return execute(Operation::synchronize, {}, nullptr, nullptr, {}).first;
+}
+
+int CompositeBlockDevice::trim(const uint64_t address, const uint64_t size)
+{
+	const std::lock_guard<CompositeBlockDevice> lockGuard {*this};
+
+	{
+		const auto ret = checkRange(address, size, eraseBlockSize_);
+		if (ret != 0)
+			return ret;
+	}
+
+	return execute(Operation::trim, address, nullptr, nullptr, size).first;
+}
+
+int CompositeBlockDevice::unlock()
+{
+	return mutex_.unlock();
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int CompositeBlockDevice::checkRange(const uint64_t address, const uint64_t size, const size_t blockSize) const
+{
+	if (openCount_ == 0)
+		return EBADF;
+
+	if (size == 0 || address % blockSize != 0 || size % blockSize != 0)
+		return EINVAL;
+
+	if (address + size > getSize())
+		return ENOSPC;
+
+	return 0;
+}
+
+int CompositeBlockDevice::closeMembers(const size_t count)
+{
+	int ret {};
+	for (size_t i {}; i < count; ++i)
+	{
+		const auto closeRet = membersRange_.begin()[i]->device_.close();
+		if (ret == 0)
+			ret = closeRet;
+	}
+
+	return ret;
+}
+
+std::pair<int, uint64_t> CompositeBlockDevice::execute(const Operation operation, const uint64_t address,
+		const void* const programBuffer, void* const readBuffer, const uint64_t size)
+{
+	const auto count = membersRange_.size();
+	const auto members = membersRange_.begin();
+
+	size_t participants {};
+	for (size_t i {}; i < count; ++i)
+	{
+		auto& member = *members[i];
+		member.programBuffer_ = programBuffer;
+		member.readBuffer_ = readBuffer;
+		member.address_ = address;
+		member.size_ = size;
+		member.stop_ = address + size;
+		member.ret_ = {};
+		member.operation_ = operation;
+		participants += isParticipating(operation, address, size, i);
+	}
+
+	// there's nothing to gain from helper threads if only one member takes part in the operation
+	const auto concurrent = participants > 1;
+	for (size_t i {}; i < count; ++i)
+		if (concurrent == true && members[i]->helper_ == true && isParticipating(operation, address, size, i) == true)
+			members[i]->requestSemaphore_.post();
+
+	for (size_t i {}; i < count; ++i)
+		if ((concurrent == false || members[i]->helper_ == false) &&
+				isParticipating(operation, address, size, i) == true)
+			executeMember(*members[i]);
+
+	for (size_t i {}; i < count; ++i)
+		if (concurrent == true && members[i]->helper_ == true && isParticipating(operation, address, size, i) == true)
+			while (members[i]->completionSemaphore_.wait() != 0);
+
+	if (mode_ == Mode::mirrored && operation == Operation::read && isReadSplit(size) == false)
+		nextReader_ = (nextReader_ + 1) % count;
+
+	int ret {};
+	auto stop = address + size;
+	for (size_t i {}; i < count; ++i)
+		if (members[i]->ret_ != 0 && (ret == 0 || members[i]->stop_ < stop))
+		{
+			ret = members[i]->ret_;
+			stop = members[i]->stop_;
+		}
+
+	return {ret, stop - address};
+}
+
+void CompositeBlockDevice::executeMember(CompositeBlockDeviceMember& member)
+{
+	if (member.operation_ == Operation::synchronize)
+	{
+		member.ret_ = member.device_.synchronize();
+		return;
+	}
+
+	const auto count = membersRange_.size();
+	const auto index = member.index_;
+	const auto end = member.address_ + member.size_;
+
+	if (mode_ == Mode::mirrored)
+	{
+		auto begin = member.address_;
+		auto rangeEnd = end;
+		if (member.operation_ == Operation::read && isReadSplit(member.size_) == true)
+		{
+			// each member reads its own share of the range, shares consist of whole read blocks
+			const auto blocks = member.size_ / readBlockSize_;
+			begin = member.address_ + blocks * index / count * readBlockSize_;
+			rangeEnd = member.address_ + blocks * (index + 1) / count * readBlockSize_;
+		}
+
+		const auto ret = executeRange(member, begin, begin, rangeEnd - begin);
+		if (ret.first != 0)
+		{
+			member.ret_ = ret.first;
+			member.stop_ = begin + ret.second;
+		}
+		return;
+	}
+
+	// in striped mode stripe number N is stored in member number N % count, at stripe number N / count
+	const auto firstStripe = member.address_ / eraseBlockSize_;
+	for (auto stripe = firstStripe + (index + count - firstStripe % count) % count; stripe * eraseBlockSize_ < end;
+			stripe += count)
+	{
+		const auto begin = std::max(member.address_, stripe * eraseBlockSize_);
+		const auto rangeEnd = std::min(end, (stripe + 1) * eraseBlockSize_);
+		const auto deviceAddress = stripe / count * eraseBlockSize_ + begin % eraseBlockSize_;
+		const auto ret = executeRange(member, begin, deviceAddress, rangeEnd - begin);
+		if (ret.first != 0)
+		{
+			member.ret_ = ret.first;
+			member.stop_ = begin + ret.second;
+			return;
+		}
+	}
+}
+
+std::pair<int, uint64_t> CompositeBlockDevice::executeRange(CompositeBlockDeviceMember& member,
+		const uint64_t address, const uint64_t deviceAddress, const uint64_t size) const
+{
+	const auto offset = address - member.address_;
+	auto& device = member.device_;
+
+	if (member.operation_ == Operation::erase)
+		return {device.erase(deviceAddress, size), {}};
+
+	if (member.operation_ == Operation::program)
+	{
+		const auto ret = device.program(deviceAddress, static_cast<const uint8_t*>(member.programBuffer_) + offset,
+				size);
+		return {ret.first, ret.second};
+	}
+
+	if (member.operation_ == Operation::read)
+	{
+		const auto ret = device.read(deviceAddress, static_cast<uint8_t*>(member.readBuffer_) + offset, size);
+		return {ret.first, ret.second};
+	}
+
+	assert(member.operation_ == Operation::trim);
+	return {device.trim(deviceAddress, size), {}};
+}
+
+bool CompositeBlockDevice::isParticipating(const Operation operation, const uint64_t address, const uint64_t size,
+		const size_t index) const
+{
+	const auto count = membersRange_.size();
+
+	if (mode_ == Mode::mirrored)
+		return operation != Operation::read || isReadSplit(size) == true || index == nextReader_;
+
+	if (operation == Operation::synchronize)
+		return true;
+
+	const auto firstStripe = address / eraseBlockSize_;
+	const auto stripes = (address + size - 1) / eraseBlockSize_ - firstStripe + 1;
+	return stripes >= count || (index + count - firstStripe % count) % count < stripes;
+}
+
+bool CompositeBlockDevice::isReadSplit(const uint64_t size) const
+{
+	const auto count = membersRange_.size();
+	return count > 1 && size >= count * static_cast<uint64_t>(eraseBlockSize_);
+}
+
+}	// namespace devices
+
+}	// namespace distortos
@@ -0,0 +1,62 @@
+/**
+ * \file
+ * \brief CompositeBlockDeviceMember class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/memory/CompositeBlockDeviceMember.hpp"
+
+#include "distortos/devices/memory/CompositeBlockDevice.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+CompositeBlockDeviceMember::~CompositeBlockDeviceMember()
+{
+
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| protected functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void CompositeBlockDeviceMember::requestHelperExit()
+{
+	operation_ = Operation::exit;
+	requestSemaphore_.post();
+}
+
+void CompositeBlockDeviceMember::runHelper(CompositeBlockDeviceMember* const member)
+{
+	while (1)
+	{
+		while (member->requestSemaphore_.wait() != 0);
+
+		if (member->operation_ == Operation::exit)
+			return;
+
+		member->composite_->executeMember(*member);
+		member->completionSemaphore_.post();
+	}
+}
+
+int CompositeBlockDeviceMember::startHelper()
+{
+	return 0;
+}
+
+}	// namespace devices
+
+}	// namespace distortos
@@ -8,6 +8,9 @@
 #
 
 target_sources(distortos PRIVATE
+		${CMAKE_CURRENT_LIST_DIR}/AsyncBlockDevice.cpp
 		${CMAKE_CURRENT_LIST_DIR}/BlockDevice.cpp
+		${CMAKE_CURRENT_LIST_DIR}/CompositeBlockDevice.cpp
+		${CMAKE_CURRENT_LIST_DIR}/CompositeBlockDeviceMember.cpp
 		${CMAKE_CURRENT_LIST_DIR}/SpiEeprom.cpp
 		${CMAKE_CURRENT_LIST_DIR}/SpiSdMmcCard.cpp)
@@ -0,0 +1,77 @@
+/**
+ * \file
+ * \brief HighResolutionTimer class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/timers/HighResolutionTimer.hpp"
+
+#include "distortos/devices/timers/HighResolutionTimerService.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+HighResolutionTimer::~HighResolutionTimer()
+{
+	stop();
+}
+
+int HighResolutionTimer::start(const std::chrono::nanoseconds delay, const std::chrono::nanoseconds period)
+{
+	return startAt(service_.getTime() + service_.toTicks(delay), service_.toTicks(period));
+}
+
+int HighResolutionTimer::startAt(const uint64_t deadline, const uint64_t period)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	stop();
+	deadline_ = deadline;
+	period_ = period;
+	return service_.add(*this);
+}
+
+void HighResolutionTimer::stop()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (isRunning() == true)
+		node_.unlink();
+	period_ = {};
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void HighResolutionTimer::run()
+{
+	function_(*this);
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	// was timer restarted or stopped in timer's function or is this a one-shot timer?
+	if (isRunning() == true || period_ == 0)
+		return;
+
+	deadline_ += period_;	// this is a repetitive timer, so restart it
+	service_.add(*this);
+}
+
+}	// namespace devices
+
+}	// namespace distortos
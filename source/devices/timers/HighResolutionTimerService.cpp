@@ -0,0 +1,163 @@
+/**
+ * \file
+ * \brief HighResolutionTimerService class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/timers/HighResolutionTimerService.hpp"
+
+#include "distortos/devices/timers/HighResolutionTimerLowLevel.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace devices
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+HighResolutionTimerService::~HighResolutionTimerService()
+{
+	if (started_ == false)
+		return;
+
+	timer_.stop();
+}
+
+uint64_t HighResolutionTimerService::getTime()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+	return updateTime();
+}
+
+int HighResolutionTimerService::start()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (started_ == true)
+		return EBADF;
+
+	{
+		const auto ret = timer_.start(*this);
+		if (ret != 0)
+			return ret;
+	}
+
+	lastCounter_ = timer_.getCounter();
+	started_ = true;
+	program();
+	return 0;
+}
+
+int HighResolutionTimerService::stop()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (started_ == false)
+		return EBADF;
+
+	if (list_.empty() == false)
+		return EBUSY;
+
+	updateTime();
+
+	{
+		const auto ret = timer_.stop();
+		if (ret != 0)
+			return ret;
+	}
+
+	started_ = false;
+	return 0;
+}
+
+uint64_t HighResolutionTimerService::toTicks(const std::chrono::nanoseconds duration) const
+{
+	if (duration <= decltype(duration){})
+		return 0;
+
+	constexpr uint64_t nanosecondsPerSecond {std::nano::den};
+	const uint64_t nanoseconds = duration.count();
+	const uint64_t frequency = timer_.getFrequency();
+	return nanoseconds / nanosecondsPerSecond * frequency +
+			(nanoseconds % nanosecondsPerSecond * frequency + nanosecondsPerSecond - 1) / nanosecondsPerSecond;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int HighResolutionTimerService::add(HighResolutionTimer& highResolutionTimer)
+{
+	if (started_ == false)
+		return EBADF;
+
+	list_.insert(highResolutionTimer);
+	if (&list_.front() == &highResolutionTimer)
+		program();
+	return 0;
+}
+
+void HighResolutionTimerService::compareMatchEvent()
+{
+	// execute all timers that reached their expiration time point
+	while (1)
+	{
+		HighResolutionTimer* highResolutionTimer;
+
+		{
+			const InterruptMaskingLock interruptMaskingLock;
+
+			if (started_ == false)
+				return;
+
+			if (list_.empty() == true || list_.front().getDeadline() > updateTime())
+			{
+				program();
+				return;
+			}
+
+			highResolutionTimer = &list_.front();
+			list_.pop_front();
+		}
+
+		highResolutionTimer->run();
+	}
+}
+
+void HighResolutionTimerService::program()
+{
+	const auto maxCounter = timer_.getMaxCounter();
+	const auto now = updateTime();
+	// compare match must happen at least once per counter period, otherwise wrap-arounds of counter would be missed
+	auto compare = now + (static_cast<uint64_t>(maxCounter) + 1) / 2;
+	if (list_.empty() == false && list_.front().getDeadline() < compare)
+		compare = list_.front().getDeadline();
+
+	timer_.setCompare((lastCounter_ + (compare - now)) & maxCounter);
+	if (updateTime() >= compare)	// selected value already passed?
+		timer_.triggerCompareMatch();
+}
+
+uint64_t HighResolutionTimerService::updateTime()
+{
+	const auto counter = timer_.getCounter();
+	time_ += (counter - lastCounter_) & timer_.getMaxCounter();
+	lastCounter_ = counter;
+	return time_;
+}
+
+}	// namespace devices
+
+}	// namespace distortos
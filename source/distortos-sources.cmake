@@ -17,8 +17,10 @@ doxygen(INPUT ${CMAKE_CURRENT_LIST_DIR}/fatalErrorHandler.cpp
 		${CMAKE_CURRENT_LIST_DIR}/FileSystem
 		${CMAKE_CURRENT_LIST_DIR}/gcc
 		${CMAKE_CURRENT_LIST_DIR}/memory
+		${CMAKE_CURRENT_LIST_DIR}/monitor
 		${CMAKE_CURRENT_LIST_DIR}/newlib
 		${CMAKE_CURRENT_LIST_DIR}/scheduler
+		${CMAKE_CURRENT_LIST_DIR}/storage
 		${CMAKE_CURRENT_LIST_DIR}/synchronization
 		${CMAKE_CURRENT_LIST_DIR}/threads)
 
@@ -28,7 +30,9 @@ include(${CMAKE_CURRENT_LIST_DIR}/devices/distortos-sources.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/FileSystem/distortos-sources.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/gcc/distortos-sources.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/memory/distortos-sources.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/monitor/distortos-sources.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/newlib/distortos-sources.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/scheduler/distortos-sources.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/storage/distortos-sources.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/synchronization/distortos-sources.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/threads/distortos-sources.cmake)
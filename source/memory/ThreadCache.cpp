@@ -0,0 +1,206 @@
+/**
+ * \file
+ * \brief ThreadCache class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/memory/ThreadCache.hpp"
+
+#include <new>
+
+#include <cstdlib>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// size of header of each block, keeps the payload aligned just like storage returned by malloc()
+constexpr size_t headerSize {alignof(std::max_align_t)};
+
+static_assert(headerSize >= sizeof(size_t), "Header of block is too small to hold size class!");
+
+/// sizes of size classes, bytes
+constexpr uint16_t sizeClasses[ThreadCache::sizeClassesCount] {8, 16, 24, 32, 48, 64, 96, 128, 192, 256};
+
+static_assert(sizeClasses[ThreadCache::sizeClassesCount - 1] == ThreadCache::maxCachedSize,
+		"The largest size class does not match ThreadCache::maxCachedSize!");
+static_assert(ThreadCache::batchSize >= 1, "Size of batch must be at least 1!");
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \param [in] block is a pointer to block allocated with ThreadCache::allocate()
+ *
+ * \return reference to size class saved in the header of \a block
+ */
+
+size_t& getHeader(void* const block)
+{
+	return *reinterpret_cast<size_t*>(static_cast<uint8_t*>(block) - headerSize);
+}
+
+/**
+ * \brief Allocates block from backing heap and saves its size class in the header.
+ *
+ * \param [in] size is the size of block, bytes
+ * \param [in] sizeClass is the index of size class saved in the header
+ *
+ * \return pointer to allocated block, nullptr if allocation failed
+ */
+
+void* allocateFromBackingHeap(const size_t size, const size_t sizeClass)
+{
+	if (size > SIZE_MAX - headerSize)
+		return nullptr;
+
+	const auto storage = static_cast<uint8_t*>(malloc(headerSize + size));
+	if (storage == nullptr)
+		return nullptr;
+
+	const auto block = storage + headerSize;
+	getHeader(block) = sizeClass;
+	return block;
+}
+
+/**
+ * \brief Returns block to backing heap.
+ *
+ * \param [in] block is a pointer to block allocated with allocateFromBackingHeap()
+ */
+
+void freeToBackingHeap(void* const block)
+{
+	free(static_cast<uint8_t*>(block) - headerSize);
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public member variables
++---------------------------------------------------------------------------------------------------------------------*/
+
+constexpr size_t ThreadCache::sizeClassesCount;
+
+constexpr size_t ThreadCache::maxCachedSize;
+
+constexpr size_t ThreadCache::batchSize;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void* ThreadCache::allocate(const size_t size)
+{
+	const auto sizeClass = getSizeClass(size);
+	if (sizeClass == sizeClassesCount)
+		return allocateFromBackingHeap(size, sizeClass);
+
+	auto& freeList = freeLists_[sizeClass];
+	if (freeList.head == nullptr && refill(sizeClass) == 0)
+		return nullptr;
+
+	const auto freeBlock = freeList.head;
+	freeList.head = freeBlock->next;
+	--freeList.count;
+	return freeBlock;
+}
+
+void ThreadCache::deallocate(void* const block)
+{
+	if (block == nullptr)
+		return;
+
+	const auto sizeClass = getHeader(block);
+	if (sizeClass >= sizeClassesCount)
+	{
+		freeToBackingHeap(block);
+		return;
+	}
+
+	auto& freeList = freeLists_[sizeClass];
+	freeList.head = new (block) FreeBlock{freeList.head};
+	++freeList.count;
+
+	if (freeList.count > 2 * batchSize)
+		release(sizeClass, batchSize);
+}
+
+void ThreadCache::flush()
+{
+	for (size_t sizeClass {}; sizeClass < sizeClassesCount; ++sizeClass)
+		if (freeLists_[sizeClass].count != 0)
+			release(sizeClass, freeLists_[sizeClass].count);
+}
+
+size_t ThreadCache::getSizeClass(const size_t size)
+{
+	size_t sizeClass {};
+	while (sizeClass < sizeClassesCount && sizeClasses[sizeClass] < size)
+		++sizeClass;
+	return sizeClass;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+size_t ThreadCache::refill(const size_t sizeClass)
+{
+	auto& freeList = freeLists_[sizeClass];
+	size_t count {};
+
+	lockBackingHeap();
+
+	while (count < batchSize)
+	{
+		const auto block = allocateFromBackingHeap(sizeClasses[sizeClass], sizeClass);
+		if (block == nullptr)
+			break;
+
+		freeList.head = new (block) FreeBlock{freeList.head};
+		++count;
+	}
+
+	unlockBackingHeap();
+
+	freeList.count += count;
+	return count;
+}
+
+void ThreadCache::release(const size_t sizeClass, size_t count)
+{
+	auto& freeList = freeLists_[sizeClass];
+
+	lockBackingHeap();
+
+	while (count != 0 && freeList.head != nullptr)
+	{
+		const auto freeBlock = freeList.head;
+		freeList.head = freeBlock->next;
+		--freeList.count;
+		--count;
+		freeToBackingHeap(freeBlock);
+	}
+
+	unlockBackingHeap();
+}
+
+}	// namespace internal
+
+}	// namespace distortos
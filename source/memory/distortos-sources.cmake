@@ -10,3 +10,9 @@
 target_sources(distortos PRIVATE
 		${CMAKE_CURRENT_LIST_DIR}/DeferredThreadDeleter.cpp
 		${CMAKE_CURRENT_LIST_DIR}/getDeferredThreadDeleter.cpp)
+
+if(distortos_Memory_04_Thread_caching_allocator)
+	target_sources(distortos PRIVATE
+			${CMAKE_CURRENT_LIST_DIR}/ThreadCache.cpp
+			${CMAKE_CURRENT_LIST_DIR}/threadCachingAllocator.cpp)
+endif()
@@ -0,0 +1,145 @@
+/**
+ * \file
+ * \brief Thread-caching allocator - replacements of global operator new and operator delete
+ *
+ * All variants of global operator new and operator delete are replaced with functions which use ThreadCache of current
+ * thread, so most allocations and deallocations of small objects don't lock the mutex which protects the heap.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/memory/ThreadCache.hpp"
+
+#include "distortos/internal/newlib/heapAccounting.hpp"
+#include "distortos/internal/newlib/locking.hpp"
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+#include "distortos/FATAL_ERROR.h"
+
+#include <new>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \return reference to ThreadCache of current thread
+ */
+
+ThreadCache& getCurrentThreadCache()
+{
+	return getScheduler().getCurrentThreadControlBlock().getThreadCache();
+}
+
+/**
+ * \brief Allocates block of memory, calls fatal error handler if allocation fails.
+ *
+ * \param [in] size is the size of block, bytes
+ *
+ * \return pointer to allocated block
+ */
+
+void* allocateOrFail(const size_t size)
+{
+	const auto block = getCurrentThreadCache().allocate(size);
+	if (block == nullptr)
+		FATAL_ERROR("Out of memory!");
+	return block;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void lockBackingHeap()
+{
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+	lockMallocMutex();
+#else	// CONFIG_HEAP_ACCOUNTING_ENABLE != 1
+	getMallocMutex().lock();
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE != 1
+}
+
+void unlockBackingHeap()
+{
+	getMallocMutex().unlock();
+}
+
+}	// namespace internal
+
+}	// namespace distortos
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void* operator new(const size_t size)
+{
+	return distortos::internal::allocateOrFail(size);
+}
+
+void* operator new(const size_t size, const std::nothrow_t&) noexcept
+{
+	return distortos::internal::getCurrentThreadCache().allocate(size);
+}
+
+void* operator new[](const size_t size)
+{
+	return distortos::internal::allocateOrFail(size);
+}
+
+void* operator new[](const size_t size, const std::nothrow_t&) noexcept
+{
+	return distortos::internal::getCurrentThreadCache().allocate(size);
+}
+
+void operator delete(void* const block) noexcept
+{
+	distortos::internal::getCurrentThreadCache().deallocate(block);
+}
+
+void operator delete(void* const block, const std::nothrow_t&) noexcept
+{
+	distortos::internal::getCurrentThreadCache().deallocate(block);
+}
+
+void operator delete[](void* const block) noexcept
+{
+	distortos::internal::getCurrentThreadCache().deallocate(block);
+}
+
+void operator delete[](void* const block, const std::nothrow_t&) noexcept
+{
+	distortos::internal::getCurrentThreadCache().deallocate(block);
+}
+
+#if defined(__cpp_sized_deallocation)
+
+void operator delete(void* const block, size_t) noexcept
+{
+	distortos::internal::getCurrentThreadCache().deallocate(block);
+}
+
+void operator delete[](void* const block, size_t) noexcept
+{
+	distortos::internal::getCurrentThreadCache().deallocate(block);
+}
+
+#endif	// defined(__cpp_sized_deallocation)
@@ -0,0 +1,141 @@
+/**
+ * \file
+ * \brief PerformanceMonitor class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/monitor/PerformanceMonitor.hpp"
+
+#include "distortos/devices/communication/SerialPort.hpp"
+
+#include "distortos/internal/monitor/PerformanceMonitorFrameWriter.hpp"
+
+#include "distortos/statistics.hpp"
+#include "distortos/ThisThread.hpp"
+#include "distortos/Thread.hpp"
+
+#include <malloc.h>
+
+#include <algorithm>
+
+namespace distortos
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// PerformanceMonitorFrameWriter which transmits frames over SerialPort
+using FrameWriter = internal::PerformanceMonitorFrameWriter<devices::SerialPort>;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// type of description frame
+constexpr uint8_t descriptionFrameType {1};
+
+/// type of sample frame
+constexpr uint8_t sampleFrameType {2};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| protected functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void PerformanceMonitor::run(PerformanceMonitor* const performanceMonitor)
+{
+	auto timePoint = TickClock::now();
+	uint32_t sequence {};
+	while (1)
+	{
+		if (sequence % descriptionInterval == 0)
+			performanceMonitor->sendDescription();
+
+		performanceMonitor->sendSample(sequence++);
+
+		timePoint += performanceMonitor->period_;
+		ThisThread::sleepUntil(timePoint);
+	}
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void PerformanceMonitor::sendDescription() const
+{
+	const uint8_t threadsCount = std::min(threadsRange_.size(), size_t{UINT8_MAX});
+	const uint8_t queuesCount = std::min(queuesRange_.size(), size_t{UINT8_MAX});
+
+	size_t payloadSize {4 + 4};
+	for (size_t i {}; i < threadsCount; ++i)
+		payloadSize += 4 + 1 + FrameWriter::getNameLength(threadsRange_[i].name);
+	for (size_t i {}; i < queuesCount; ++i)
+		payloadSize += 4 + 1 + FrameWriter::getNameLength(queuesRange_[i].getName());
+
+	FrameWriter frameWriter {serialPort_, descriptionFrameType, payloadSize};
+	frameWriter.writeU8(protocolVersion);
+	frameWriter.writeU8(threadsCount);
+	frameWriter.writeU8(queuesCount);
+	frameWriter.writeU8({});
+	frameWriter.writeU32(TickClock::period::den / TickClock::period::num);
+
+	for (size_t i {}; i < threadsCount; ++i)
+	{
+		frameWriter.writeU32(threadsRange_[i].thread.getStackSize());
+		frameWriter.writeName(threadsRange_[i].name);
+	}
+	for (size_t i {}; i < queuesCount; ++i)
+	{
+		frameWriter.writeU32(queuesRange_[i].getCapacity());
+		frameWriter.writeName(queuesRange_[i].getName());
+	}
+
+	frameWriter.finish();
+}
+
+void PerformanceMonitor::sendSample(const uint32_t sequence) const
+{
+	const uint8_t threadsCount = std::min(threadsRange_.size(), size_t{UINT8_MAX});
+	const uint8_t queuesCount = std::min(queuesRange_.size(), size_t{UINT8_MAX});
+	const size_t payloadSize = 5 * 4 + threadsCount * (4 + 4 + 4) + queuesCount * 4;
+
+	// values are read one by one, interrupts are masked by individual getters only for the time of reading single value
+	const auto tickCount = TickClock::now().time_since_epoch().count();
+	const auto contextSwitchCount = statistics::getContextSwitchCount();
+	const auto mallinfoResult = mallinfo();
+
+	FrameWriter frameWriter {serialPort_, sampleFrameType, payloadSize};
+	frameWriter.writeU32(sequence);
+	frameWriter.writeU32(tickCount);
+	frameWriter.writeU32(contextSwitchCount);
+	frameWriter.writeU32(mallinfoResult.uordblks);
+	frameWriter.writeU32(mallinfoResult.arena);
+
+	for (size_t i {}; i < threadsCount; ++i)
+	{
+		const auto& thread = threadsRange_[i].thread;
+		frameWriter.writeU32(thread.getRunTickCount());
+		frameWriter.writeU32(thread.getStackHighWaterMark());
+		frameWriter.writeU8(static_cast<uint8_t>(thread.getState()));
+		frameWriter.writeU8(thread.getPriority());
+		frameWriter.writeU8(thread.getEffectivePriority());
+		frameWriter.writeU8({});
+	}
+	for (size_t i {}; i < queuesCount; ++i)
+		frameWriter.writeU32(queuesRange_[i].getSize());
+
+	frameWriter.finish();
+}
+
+}	// namespace distortos
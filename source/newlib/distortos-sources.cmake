@@ -12,3 +12,26 @@ target_sources(distortos PRIVATE
 		${CMAKE_CURRENT_LIST_DIR}/locking.cpp
 		${CMAKE_CURRENT_LIST_DIR}/sbrk_r.cpp
 		${CMAKE_CURRENT_LIST_DIR}/syscallsStubs.cpp)
+
+if(distortos_Memory_00_Heap_accounting)
+	target_sources(distortos PRIVATE
+			${CMAKE_CURRENT_LIST_DIR}/heapAccounting.cpp)
+	target_link_libraries(distortos PUBLIC
+			-Wl,--wrap=_calloc_r
+			-Wl,--wrap=_free_r
+			-Wl,--wrap=_malloc_r
+			-Wl,--wrap=_memalign_r
+			-Wl,--wrap=_realloc_r
+			-Wl,--wrap=calloc
+			-Wl,--wrap=free
+			-Wl,--wrap=malloc
+			-Wl,--wrap=realloc)
+	# operator new of thread-caching allocator must not lock the heap for allocations served from the cache
+	if(NOT distortos_Memory_04_Thread_caching_allocator)
+		target_link_libraries(distortos PUBLIC
+				-Wl,--wrap=_Znaj
+				-Wl,--wrap=_ZnajRKSt9nothrow_t
+				-Wl,--wrap=_Znwj
+				-Wl,--wrap=_ZnwjRKSt9nothrow_t)
+	endif()
+endif()
@@ -0,0 +1,720 @@
+/**
+ * \file
+ * \brief Implementation of heap accounting
+ *
+ * Allocation functions of newlib and operator new are wrapped with linker's `--wrap` option. Each allocation and
+ * deallocation is charged to current thread and every CONFIG_HEAP_ACCOUNTING_SAMPLING_PERIOD-th allocation is recorded
+ * in the table of call sites. All state is protected by the mutex used for malloc() and free() locking, which is held
+ * for the whole duration of each wrapper.
+ *
+ * When thread-caching allocator is enabled, operator new is not wrapped, as that would lock the mutex on each
+ * allocation served from the cache of thread. Refills and trims of the cache allocate and free blocks with malloc()
+ * and free(), so only these transfers are charged.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/newlib/heapAccounting.hpp"
+
+#include "distortos/internal/newlib/locking.hpp"
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+#include "distortos/statistics.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+#if CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE != 1
+
+static_assert(std::is_same<size_t, unsigned int>::value == true,
+		"Mangled names of wrapped operator new assume that size_t is unsigned int!");
+
+#endif	// CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE != 1
+
+extern "C"
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions' declarations
++---------------------------------------------------------------------------------------------------------------------*/
+
+size_t _malloc_usable_size_r(_reent* reent, void* pointer);
+void* __real__calloc_r(_reent* reent, size_t count, size_t size);
+void __real__free_r(_reent* reent, void* pointer);
+void* __real__malloc_r(_reent* reent, size_t size);
+void* __real__memalign_r(_reent* reent, size_t alignment, size_t size);
+void* __real__realloc_r(_reent* reent, void* pointer, size_t size);
+
+#if CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE != 1
+
+void* __real__Znaj(size_t size);
+void* __real__ZnajRKSt9nothrow_t(size_t size, const std::nothrow_t& nothrow);
+void* __real__Znwj(size_t size);
+void* __real__ZnwjRKSt9nothrow_t(size_t size, const std::nothrow_t& nothrow);
+
+#endif	// CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE != 1
+
+}	// extern "C"
+
+namespace distortos
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// HeapScope class is a RAII wrapper which locks the heap and marks the outermost call of wrapped functions
+class HeapScope
+{
+public:
+
+	/**
+	 * \brief HeapScope's constructor
+	 *
+	 * Locks the mutex used for malloc() and free() locking. If this is the outermost scope, \a callSite is saved. If
+	 * \a accounting is true and no outer scope does the accounting, this scope takes this role - nested calls of
+	 * wrapped functions (e.g. _malloc_r() called by _realloc_r() of newlib) are not charged again.
+	 *
+	 * \param [in] callSite is the return address of wrapped function
+	 * \param [in] accounting selects whether this scope wants to charge the operation
+	 */
+
+	HeapScope(const void* callSite, bool accounting);
+
+	/**
+	 * \brief HeapScope's destructor
+	 *
+	 * Clears the state owned by this scope and unlocks the mutex used for malloc() and free() locking.
+	 */
+
+	~HeapScope();
+
+	/**
+	 * \return return address of the outermost wrapped function
+	 */
+
+	const void* getCallSite() const
+	{
+		return callSite_;
+	}
+
+	/**
+	 * \return true if this scope should charge the operation, false otherwise
+	 */
+
+	bool isAccounting() const
+	{
+		return ownsAccounting_;
+	}
+
+	HeapScope(const HeapScope&) = delete;
+	HeapScope(HeapScope&&) = delete;
+	const HeapScope& operator=(const HeapScope&) = delete;
+	HeapScope& operator=(HeapScope&&) = delete;
+
+private:
+
+	/// return address of the outermost wrapped function
+	const void* callSite_;
+
+	/// true if this scope is the outermost one
+	bool ownsCallSite_;
+
+	/// true if this scope charges the operation
+	bool ownsAccounting_;
+
+	/// return address of the outermost wrapped function which is currently executed, nullptr if none
+	static const void* currentCallSite_;
+
+	/// true if the operation is already being charged by an outer scope
+	static bool accountingInProgress_;
+};
+
+#if CONFIG_HEAP_ACCOUNTING_CALL_SITES > 0
+
+/// SampledBlock struct is a live block recorded by sampling of allocations
+struct SampledBlock
+{
+	/// pointer to block
+	const void* pointer;
+
+	/// usable size of block, bytes
+	size_t size;
+
+	/// index of call site in callSites array
+	size_t callSiteIndex;
+};
+
+#endif	// CONFIG_HEAP_ACCOUNTING_CALL_SITES > 0
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// heap usage statistics of all threads
+HeapStatistics globalHeapStatistics;
+
+#if CONFIG_HEAP_ACCOUNTING_CALL_SITES > 0
+
+/// table of call sites
+HeapCallSite callSites[CONFIG_HEAP_ACCOUNTING_CALL_SITES];
+
+/// table of live sampled blocks
+SampledBlock sampledBlocks[CONFIG_HEAP_ACCOUNTING_SAMPLED_BLOCKS];
+
+/// number of used entries in sampledBlocks
+size_t sampledBlocksCount;
+
+/// number of allocations left until next sample
+size_t samplingCountdown {CONFIG_HEAP_ACCOUNTING_SAMPLING_PERIOD};
+
+#endif	// CONFIG_HEAP_ACCOUNTING_CALL_SITES > 0
+
+const void* HeapScope::currentCallSite_;
+bool HeapScope::accountingInProgress_;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+#if CONFIG_HEAP_ACCOUNTING_CALL_SITES > 0
+
+/**
+ * \brief Finds call site in the table, adding it if it is not there yet.
+ *
+ * When the table is full, an entry without live blocks and with the lowest number of allocations is replaced.
+ *
+ * \param [in] address is the address of call site
+ *
+ * \return index of call site in callSites array, CONFIG_HEAP_ACCOUNTING_CALL_SITES if the table is full
+ */
+
+size_t findCallSite(const void* const address)
+{
+	auto candidate = CONFIG_HEAP_ACCOUNTING_CALL_SITES;
+	for (size_t i {}; i < CONFIG_HEAP_ACCOUNTING_CALL_SITES; ++i)
+	{
+		auto& callSite = callSites[i];
+		if (callSite.address == address)
+			return i;
+		if (callSite.liveBlocks == 0 && (candidate == CONFIG_HEAP_ACCOUNTING_CALL_SITES ||
+				callSite.allocationCount < callSites[candidate].allocationCount))
+			candidate = i;
+	}
+
+	if (candidate != CONFIG_HEAP_ACCOUNTING_CALL_SITES)
+		callSites[candidate] = {address, {}, {}, {}};
+	return candidate;
+}
+
+/**
+ * \brief Records allocation in the tables of call sites and sampled blocks, if it is selected by sampling.
+ *
+ * \param [in] pointer is a pointer to allocated block
+ * \param [in] size is the usable size of allocated block, bytes
+ * \param [in] callSite is the address of call site
+ */
+
+void sampleAllocation(const void* const pointer, const size_t size, const void* const callSite)
+{
+	if (--samplingCountdown != 0)
+		return;
+
+	samplingCountdown = CONFIG_HEAP_ACCOUNTING_SAMPLING_PERIOD;
+
+	const auto callSiteIndex = findCallSite(callSite);
+	if (callSiteIndex == CONFIG_HEAP_ACCOUNTING_CALL_SITES)
+		return;
+
+	++callSites[callSiteIndex].allocationCount;
+
+	if (sampledBlocksCount == CONFIG_HEAP_ACCOUNTING_SAMPLED_BLOCKS)
+		return;
+
+	sampledBlocks[sampledBlocksCount++] = {pointer, size, callSiteIndex};
+	callSites[callSiteIndex].liveBytes += size;
+	++callSites[callSiteIndex].liveBlocks;
+}
+
+/**
+ * \brief Removes block from the table of sampled blocks, if it is there.
+ *
+ * \param [in] pointer is a pointer to freed block
+ */
+
+void sampleFree(const void* const pointer)
+{
+	const auto end = sampledBlocks + sampledBlocksCount;
+	const auto iterator = std::find_if(sampledBlocks, end,
+			[pointer](const SampledBlock& sampledBlock)
+			{
+				return sampledBlock.pointer == pointer;
+			});
+	if (iterator == end)
+		return;
+
+	auto& callSite = callSites[iterator->callSiteIndex];
+	callSite.liveBytes -= iterator->size;
+	--callSite.liveBlocks;
+	*iterator = sampledBlocks[--sampledBlocksCount];
+}
+
+#endif	// CONFIG_HEAP_ACCOUNTING_CALL_SITES > 0
+
+/**
+ * \brief Charges allocation to current thread.
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] pointer is a pointer to allocated block, nullptr if allocation failed
+ * \param [in] callSite is the address of call site
+ */
+
+void chargeAllocation(_reent* const reent, void* const pointer, const void* const callSite)
+{
+	if (pointer == nullptr)
+		return;
+
+	const auto size = _malloc_usable_size_r(reent, pointer);
+
+	{
+		const InterruptMaskingLock interruptMaskingLock;
+
+		for (const auto heapStatistics :
+				{&internal::getScheduler().getCurrentThreadControlBlock().getHeapStatistics(), &globalHeapStatistics})
+		{
+			heapStatistics->allocatedBytes += size;
+			++heapStatistics->allocationCount;
+		}
+	}
+
+#if CONFIG_HEAP_ACCOUNTING_CALL_SITES > 0
+	sampleAllocation(pointer, size, callSite);
+#else	// CONFIG_HEAP_ACCOUNTING_CALL_SITES == 0
+	static_cast<void>(callSite);
+#endif	// CONFIG_HEAP_ACCOUNTING_CALL_SITES == 0
+}
+
+/**
+ * \brief Charges deallocation to current thread.
+ *
+ * \param [in] pointer is a pointer to block that is going to be freed
+ * \param [in] size is the usable size of block that is going to be freed, bytes
+ */
+
+void chargeFree(const void* const pointer, const size_t size)
+{
+	{
+		const InterruptMaskingLock interruptMaskingLock;
+
+		for (const auto heapStatistics :
+				{&internal::getScheduler().getCurrentThreadControlBlock().getHeapStatistics(), &globalHeapStatistics})
+		{
+			heapStatistics->freedBytes += size;
+			++heapStatistics->freeCount;
+		}
+	}
+
+#if CONFIG_HEAP_ACCOUNTING_CALL_SITES > 0
+	sampleFree(pointer);
+#else	// CONFIG_HEAP_ACCOUNTING_CALL_SITES == 0
+	static_cast<void>(pointer);
+#endif	// CONFIG_HEAP_ACCOUNTING_CALL_SITES == 0
+}
+
+/**
+ * \brief Implementation of wrapped _calloc_r() and calloc().
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] count is the number of elements
+ * \param [in] size is the size of single element, bytes
+ * \param [in] callSite is the return address of wrapped function
+ *
+ * \return pointer to allocated block, nullptr on failure
+ */
+
+void* callocWrapper(_reent* const reent, const size_t count, const size_t size, const void* const callSite)
+{
+	const HeapScope heapScope {callSite, true};
+	const auto pointer = __real__calloc_r(reent, count, size);
+	if (heapScope.isAccounting() == true)
+		chargeAllocation(reent, pointer, heapScope.getCallSite());
+	return pointer;
+}
+
+/**
+ * \brief Implementation of wrapped _free_r() and free().
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] pointer is a pointer to block that will be freed
+ * \param [in] callSite is the return address of wrapped function
+ */
+
+void freeWrapper(_reent* const reent, void* const pointer, const void* const callSite)
+{
+	const HeapScope heapScope {callSite, true};
+	if (heapScope.isAccounting() == true && pointer != nullptr)
+		chargeFree(pointer, _malloc_usable_size_r(reent, pointer));
+	__real__free_r(reent, pointer);
+}
+
+/**
+ * \brief Implementation of wrapped _malloc_r() and malloc().
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] size is the size of block, bytes
+ * \param [in] callSite is the return address of wrapped function
+ *
+ * \return pointer to allocated block, nullptr on failure
+ */
+
+void* mallocWrapper(_reent* const reent, const size_t size, const void* const callSite)
+{
+	const HeapScope heapScope {callSite, true};
+	const auto pointer = __real__malloc_r(reent, size);
+	if (heapScope.isAccounting() == true)
+		chargeAllocation(reent, pointer, heapScope.getCallSite());
+	return pointer;
+}
+
+/**
+ * \brief Implementation of wrapped _realloc_r() and realloc().
+ *
+ * Reallocation is charged as deallocation of old block followed by allocation of new block.
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] pointer is a pointer to block that will be reallocated
+ * \param [in] size is the new size of block, bytes
+ * \param [in] callSite is the return address of wrapped function
+ *
+ * \return pointer to reallocated block, nullptr on failure or when \a size is 0
+ */
+
+void* reallocWrapper(_reent* const reent, void* const pointer, const size_t size, const void* const callSite)
+{
+	const HeapScope heapScope {callSite, true};
+	if (heapScope.isAccounting() == false)
+		return __real__realloc_r(reent, pointer, size);
+
+	const auto oldSize = pointer != nullptr ? _malloc_usable_size_r(reent, pointer) : 0;
+	const auto newPointer = __real__realloc_r(reent, pointer, size);
+	if (newPointer == nullptr && size != 0)
+		return newPointer;	// old block is untouched
+
+	if (pointer != nullptr)
+		chargeFree(pointer, oldSize);
+	chargeAllocation(reent, newPointer, heapScope.getCallSite());
+	return newPointer;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| HeapScope's public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+HeapScope::HeapScope(const void* const callSite, const bool accounting) :
+		callSite_{},
+		ownsCallSite_{},
+		ownsAccounting_{}
+{
+	internal::lockMallocMutex();
+
+	ownsCallSite_ = currentCallSite_ == nullptr;
+	if (ownsCallSite_ == true)
+		currentCallSite_ = callSite;
+	callSite_ = currentCallSite_;
+
+	ownsAccounting_ = accounting == true && accountingInProgress_ == false;
+	if (ownsAccounting_ == true)
+		accountingInProgress_ = true;
+}
+
+HeapScope::~HeapScope()
+{
+	if (ownsAccounting_ == true)
+		accountingInProgress_ = false;
+	if (ownsCallSite_ == true)
+		currentCallSite_ = {};
+
+	internal::getMallocMutex().unlock();
+}
+
+}	// namespace
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void lockMallocMutex()
+{
+	auto& mutex = getMallocMutex();
+	if (mutex.tryLock() == 0)
+		return;
+
+	{
+		const InterruptMaskingLock interruptMaskingLock;
+		++getScheduler().getCurrentThreadControlBlock().getHeapStatistics().contentionCount;
+		++globalHeapStatistics.contentionCount;
+	}
+
+	mutex.lock();
+}
+
+}	// namespace internal
+
+namespace statistics
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+size_t getHeapCallSites(HeapCallSite* const buffer, const size_t size)
+{
+#if CONFIG_HEAP_ACCOUNTING_CALL_SITES > 0
+
+	const HeapScope heapScope {{}, false};
+
+	const auto end = std::partial_sort_copy(std::begin(callSites), std::end(callSites), buffer, buffer + size,
+			[](const HeapCallSite& left, const HeapCallSite& right)
+			{
+				if ((left.address == nullptr) != (right.address == nullptr))
+					return right.address == nullptr;
+				return left.liveBytes > right.liveBytes;
+			});
+	const auto count = std::find_if(buffer, end,
+			[](const HeapCallSite& callSite)
+			{
+				return callSite.address == nullptr;
+			}) - buffer;
+	return count;
+
+#else	// CONFIG_HEAP_ACCOUNTING_CALL_SITES == 0
+
+	static_cast<void>(buffer);
+	static_cast<void>(size);
+	return 0;
+
+#endif	// CONFIG_HEAP_ACCOUNTING_CALL_SITES == 0
+}
+
+HeapStatistics getHeapStatistics()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+	return globalHeapStatistics;
+}
+
+}	// namespace statistics
+
+}	// namespace distortos
+
+extern "C"
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Wrapper for _calloc_r().
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] count is the number of elements
+ * \param [in] size is the size of single element, bytes
+ *
+ * \return pointer to allocated block, nullptr on failure
+ */
+
+void* __wrap__calloc_r(_reent* const reent, const size_t count, const size_t size)
+{
+	return distortos::callocWrapper(reent, count, size, __builtin_return_address(0));
+}
+
+/**
+ * \brief Wrapper for _free_r().
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] pointer is a pointer to block that will be freed
+ */
+
+void __wrap__free_r(_reent* const reent, void* const pointer)
+{
+	distortos::freeWrapper(reent, pointer, __builtin_return_address(0));
+}
+
+/**
+ * \brief Wrapper for _malloc_r().
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] size is the size of block, bytes
+ *
+ * \return pointer to allocated block, nullptr on failure
+ */
+
+void* __wrap__malloc_r(_reent* const reent, const size_t size)
+{
+	return distortos::mallocWrapper(reent, size, __builtin_return_address(0));
+}
+
+/**
+ * \brief Wrapper for _memalign_r().
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] alignment is the required alignment of block, bytes
+ * \param [in] size is the size of block, bytes
+ *
+ * \return pointer to allocated block, nullptr on failure
+ */
+
+void* __wrap__memalign_r(_reent* const reent, const size_t alignment, const size_t size)
+{
+	const distortos::HeapScope heapScope {__builtin_return_address(0), true};
+	const auto pointer = __real__memalign_r(reent, alignment, size);
+	if (heapScope.isAccounting() == true)
+		distortos::chargeAllocation(reent, pointer, heapScope.getCallSite());
+	return pointer;
+}
+
+/**
+ * \brief Wrapper for _realloc_r().
+ *
+ * \param [in] reent is a pointer to newlib's reentrancy structure
+ * \param [in] pointer is a pointer to block that will be reallocated
+ * \param [in] size is the new size of block, bytes
+ *
+ * \return pointer to reallocated block, nullptr on failure or when \a size is 0
+ */
+
+void* __wrap__realloc_r(_reent* const reent, void* const pointer, const size_t size)
+{
+	return distortos::reallocWrapper(reent, pointer, size, __builtin_return_address(0));
+}
+
+#if CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE != 1
+
+/**
+ * \brief Wrapper for operator new[](size_t).
+ *
+ * \param [in] size is the size of block, bytes
+ *
+ * \return pointer to allocated block
+ */
+
+void* __wrap__Znaj(const size_t size)
+{
+	const distortos::HeapScope heapScope {__builtin_return_address(0), false};
+	return __real__Znaj(size);
+}
+
+/**
+ * \brief Wrapper for operator new[](size_t, const std::nothrow_t&).
+ *
+ * \param [in] size is the size of block, bytes
+ * \param [in] nothrow is a reference to std::nothrow
+ *
+ * \return pointer to allocated block, nullptr on failure
+ */
+
+void* __wrap__ZnajRKSt9nothrow_t(const size_t size, const std::nothrow_t& nothrow)
+{
+	const distortos::HeapScope heapScope {__builtin_return_address(0), false};
+	return __real__ZnajRKSt9nothrow_t(size, nothrow);
+}
+
+/**
+ * \brief Wrapper for operator new(size_t).
+ *
+ * \param [in] size is the size of block, bytes
+ *
+ * \return pointer to allocated block
+ */
+
+void* __wrap__Znwj(const size_t size)
+{
+	const distortos::HeapScope heapScope {__builtin_return_address(0), false};
+	return __real__Znwj(size);
+}
+
+/**
+ * \brief Wrapper for operator new(size_t, const std::nothrow_t&).
+ *
+ * \param [in] size is the size of block, bytes
+ * \param [in] nothrow is a reference to std::nothrow
+ *
+ * \return pointer to allocated block, nullptr on failure
+ */
+
+void* __wrap__ZnwjRKSt9nothrow_t(const size_t size, const std::nothrow_t& nothrow)
+{
+	const distortos::HeapScope heapScope {__builtin_return_address(0), false};
+	return __real__ZnwjRKSt9nothrow_t(size, nothrow);
+}
+
+#endif	// CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE != 1
+
+/**
+ * \brief Wrapper for calloc().
+ *
+ * \param [in] count is the number of elements
+ * \param [in] size is the size of single element, bytes
+ *
+ * \return pointer to allocated block, nullptr on failure
+ */
+
+void* __wrap_calloc(const size_t count, const size_t size)
+{
+	return distortos::callocWrapper(_REENT, count, size, __builtin_return_address(0));
+}
+
+/**
+ * \brief Wrapper for free().
+ *
+ * \param [in] pointer is a pointer to block that will be freed
+ */
+
+void __wrap_free(void* const pointer)
+{
+	distortos::freeWrapper(_REENT, pointer, __builtin_return_address(0));
+}
+
+/**
+ * \brief Wrapper for malloc().
+ *
+ * \param [in] size is the size of block, bytes
+ *
+ * \return pointer to allocated block, nullptr on failure
+ */
+
+void* __wrap_malloc(const size_t size)
+{
+	return distortos::mallocWrapper(_REENT, size, __builtin_return_address(0));
+}
+
+/**
+ * \brief Wrapper for realloc().
+ *
+ * \param [in] pointer is a pointer to block that will be reallocated
+ * \param [in] size is the new size of block, bytes
+ *
+ * \return pointer to reallocated block, nullptr on failure or when \a size is 0
+ */
+
+void* __wrap_realloc(void* const pointer, const size_t size)
+{
+	return distortos::reallocWrapper(_REENT, pointer, size, __builtin_return_address(0));
+}
+
+}	// extern "C"
@@ -2,7 +2,7 @@
  * \file
  * \brief Implementation of newlib locking
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -11,6 +11,8 @@
 
 #include "distortos/internal/newlib/locking.hpp"
 
+#include "distortos/internal/newlib/heapAccounting.hpp"
+
 #if __GNUC_PREREQ(5, 1) != 1
 // GCC 4.x doesn't fully support constexpr constructors
 #error "GCC 5.1 is the minimum version supported by distortos"
@@ -80,6 +82,16 @@ void __retarget_lock_acquire(const _LOCK_T lock)
 
 void __retarget_lock_acquire_recursive(const _LOCK_T lock)
 {
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+	if (lock == &__lock___malloc_recursive_mutex)
+	{
+		distortos::internal::lockMallocMutex();
+		return;
+	}
+
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
 	lock->lock();
 }
 
@@ -211,7 +223,11 @@ extern "C"
 
 void __malloc_lock()
 {
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+	distortos::internal::lockMallocMutex();
+#else	// CONFIG_HEAP_ACCOUNTING_ENABLE != 1
 	distortos::internal::getMallocMutex().lock();
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE != 1
 }
 
 /**
@@ -270,6 +270,7 @@ bool Scheduler::tickInterruptHandler()
 
 	++tickCount_;
 
+	getCurrentThreadControlBlock().incrementRunTickCount();
 	getCurrentThreadControlBlock().getRoundRobinQuantum().decrement();
 
 	// if the object is on the "runnable" list, it uses SchedulingPolicy::roundRobin and it used its round-robin
@@ -296,6 +297,16 @@ void Scheduler::unblock(const ThreadList::iterator iterator, const UnblockReason
 	maybeRequestContextSwitch();
 }
 
+void Scheduler::unblockAll(ThreadList& container, const UnblockReason unblockReason)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	while (container.empty() == false)
+		unblockInternal(container.begin(), unblockReason);
+
+	maybeRequestContextSwitch();
+}
+
 void Scheduler::yield()
 {
 	const InterruptMaskingLock interruptMaskingLock;
@@ -2,7 +2,7 @@
  * \file
  * \brief ThreadControlBlock class implementation
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -57,6 +57,14 @@ ThreadControlBlock::ThreadControlBlock(internal::Stack&& stack, const uint8_t pr
 				list_{},
 				owner_{owner},
 				priorityInheritanceMutexControlBlock_{},
+				requestedSemaphoreUnits_{},
+				runTickCount_{},
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+				heapStatistics_{},
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+#if CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+				threadCache_{},
+#endif	// CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
 				signalsReceiverControlBlock_{signalsReceiver != nullptr ?
 						&signalsReceiver->signalsReceiverControlBlock_ : nullptr},
 				threadGroupControlBlock_{threadGroupControlBlock},
@@ -82,6 +90,14 @@ ThreadControlBlock::ThreadControlBlock(internal::Stack&& stack, const uint8_t pr
 				list_{},
 				owner_{owner},
 				priorityInheritanceMutexControlBlock_{},
+				requestedSemaphoreUnits_{},
+				runTickCount_{},
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+				heapStatistics_{},
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+#if CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+				threadCache_{},
+#endif	// CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
 				threadGroupControlBlock_{threadGroupControlBlock},
 				unblockFunctor_{},
 				roundRobinQuantum_{},
@@ -0,0 +1,582 @@
+/**
+ * \file
+ * \brief CircularLog class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/storage/CircularLog.hpp"
+
+#include "distortos/devices/memory/BlockDevice.hpp"
+
+#include "distortos/internal/storage/updateCrc32.hpp"
+
+#include "estd/ScopeGuard.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// header of sector
+struct CircularLog::SectorHeader
+{
+	/// magic value, equal to sectorMagic if header is valid
+	uint32_t magic;
+
+	/// sequence number of sector
+	uint32_t sequence;
+
+	/// sequence number of first record in sector
+	uint32_t firstRecordSequence;
+
+	/// CRC-32 of all preceding fields
+	uint32_t crc;
+};
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// header of record
+struct RecordHeader
+{
+	/// CRC-32 of all following fields and data of record
+	uint32_t crc;
+
+	/// sequence number of record
+	uint32_t sequence;
+
+	/// size of data of record, bytes
+	uint32_t size;
+
+	/// bitwise complement of size
+	uint32_t sizeComplement;
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// magic value of valid sector header - "CLOG"
+constexpr uint32_t sectorMagic {0x474f4c43};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+CircularLog::~CircularLog()
+{
+	if (mounted_ == true)
+		unmount();
+}
+
+int CircularLog::append(const void* const buffer, const size_t size)
+{
+	if (buffer == nullptr || size == 0)
+		return EINVAL;
+
+	const std::lock_guard<CircularLog> lockGuard {*this};
+
+	if (mounted_ == false)
+		return EBADF;
+
+	if (size > getMaxRecordSize())
+		return EMSGSIZE;
+
+	const auto recordHeaderSize = roundUp(sizeof(RecordHeader));
+	const auto recordSize = recordHeaderSize + roundUp(size);
+	if (headOffset_ + recordSize > sectorSize_)
+	{
+		const auto ret = advanceHead();
+		if (ret != 0)
+			return ret;
+	}
+
+	const auto offset = headOffset_;
+	const auto address = static_cast<uint64_t>(headSector_) * sectorSize_ + offset;
+	headOffset_ = sectorSize_;	// if anything fails, next record will be appended in next sector
+
+	{
+		const auto ret = programPadded(address + recordHeaderSize, buffer, size);
+		if (ret != 0)
+			return ret;
+	}
+
+	RecordHeader recordHeader;
+	recordHeader.sequence = nextRecordSequence_;
+	recordHeader.size = size;
+	recordHeader.sizeComplement = ~recordHeader.size;
+	recordHeader.crc = internal::updateCrc32(internal::updateCrc32({}, &recordHeader.sequence,
+			sizeof(recordHeader) - sizeof(recordHeader.crc)), buffer, size);
+
+	{
+		// header is programmed last, record becomes valid only when it is completely programmed
+		const auto ret = programPadded(address, &recordHeader, sizeof(recordHeader));
+		if (ret != 0)
+			return ret;
+	}
+
+	headOffset_ = offset + recordSize;
+	++nextRecordSequence_;
+	return 0;
+}
+
+int CircularLog::format()
+{
+	const std::lock_guard<CircularLog> lockGuard {*this};
+
+	if (mounted_ == true)
+		return EBUSY;
+
+	{
+		const auto ret = blockDevice_.open();
+		if (ret != 0)
+			return ret;
+	}
+
+	const auto closeScopeGuard = estd::makeScopeGuard([this]()
+			{
+				blockDevice_.close();
+			});
+
+	const auto eraseBlockSize = blockDevice_.getEraseBlockSize();
+	return blockDevice_.erase(0, blockDevice_.getSize() / eraseBlockSize * eraseBlockSize);
+}
+
+size_t CircularLog::getMaxRecordSize() const
+{
+	if (mounted_ == false)
+		return 0;
+
+	return sectorSize_ - roundUp(sizeof(SectorHeader)) - roundUp(sizeof(RecordHeader));
+}
+
+std::pair<int, CircularLog::Cursor> CircularLog::getHead()
+{
+	const std::lock_guard<CircularLog> lockGuard {*this};
+
+	if (mounted_ == false)
+		return {EBADF, {}};
+
+	if (headOffset_ + roundUp(sizeof(RecordHeader)) >= sectorSize_)	// next record will be appended in next sector?
+		return {{}, {headSequence_ + 1, roundUp(sizeof(SectorHeader))}};
+
+	return {{}, {headSequence_, headOffset_}};
+}
+
+std::pair<int, CircularLog::Cursor> CircularLog::getTail()
+{
+	const std::lock_guard<CircularLog> lockGuard {*this};
+
+	if (mounted_ == false)
+		return {EBADF, {}};
+
+	// for empty log this is the sector which will be opened by first append
+	return {{}, {headSequence_ + 1 - static_cast<uint32_t>(validSectors_), roundUp(sizeof(SectorHeader))}};
+}
+
+int CircularLog::lock()
+{
+	return blockDevice_.lock();
+}
+
+int CircularLog::mount()
+{
+	const std::lock_guard<CircularLog> lockGuard {*this};
+
+	if (mounted_ == true)
+		return EBUSY;
+
+	{
+		const auto ret = blockDevice_.open();
+		if (ret != 0)
+			return ret;
+	}
+
+	auto closeScopeGuard = estd::makeScopeGuard([this]()
+			{
+				blockDevice_.close();
+			});
+
+	programBlockSize_ = blockDevice_.getProgramBlockSize();
+	sectorSize_ = blockDevice_.getEraseBlockSize();
+	sectorsCount_ = sectorSize_ != 0 ? blockDevice_.getSize() / sectorSize_ : 0;
+	const auto readBlockSize = blockDevice_.getReadBlockSize();
+	const auto erasedValue = blockDevice_.getErasedValue();
+	erasedValue_ = erasedValue.first == true ? erasedValue.second : UINT8_MAX;
+
+	if (sectorsCount_ < 2 || programBlockSize_ == 0 || readBlockSize == 0 || programBlockSize_ % readBlockSize != 0 ||
+			sectorSize_ % programBlockSize_ != 0 || bufferSize_ < roundUp(sizeof(SectorHeader)) ||
+			bufferSize_ % programBlockSize_ != 0 ||
+			sectorSize_ <= roundUp(sizeof(SectorHeader)) + roundUp(sizeof(RecordHeader)))
+		return EINVAL;
+
+	// first sector may be invalid only if the log is empty or if it was being erased when the log was full
+	size_t base {};
+	auto headerRet = readSectorHeader(base);
+	if (headerRet.first != 0)
+		return headerRet.first;
+	if (headerRet.second.magic != sectorMagic)
+	{
+		base = 1;
+		headerRet = readSectorHeader(base);
+		if (headerRet.first != 0)
+			return headerRet.first;
+	}
+
+	if (headerRet.second.magic != sectorMagic)	// empty log?
+	{
+		if (erasedValue.first == true)
+		{
+			const auto ret = blockDevice_.read(0, buffer_, roundUp(sizeof(SectorHeader)));
+			if (ret.first != 0)
+				return ret.first;
+
+			const auto bufferUint8 = static_cast<const uint8_t*>(buffer_);
+			if (std::any_of(bufferUint8, bufferUint8 + roundUp(sizeof(SectorHeader)),
+					[this](const uint8_t value)
+					{
+						return value != erasedValue_;
+					}) == true)
+				return EILSEQ;
+		}
+
+		// first append will open first sector
+		headSector_ = sectorsCount_ - 1;
+		headSequence_ = UINT32_MAX;
+		headOffset_ = sectorSize_;
+		validSectors_ = 0;
+		nextRecordSequence_ = 0;
+		mounted_ = true;
+		closeScopeGuard.release();
+		return 0;
+	}
+
+	// binary search for the last sector which continues the sequence of base sector
+	const auto baseSequence = headerRet.second.sequence;
+	auto headHeader = headerRet.second;
+	size_t low {base};
+	size_t high {sectorsCount_};
+	while (high - low > 1)
+	{
+		const auto middle = low + (high - low) / 2;
+		const auto ret = readSectorHeader(middle);
+		if (ret.first != 0)
+			return ret.first;
+
+		if (ret.second.magic == sectorMagic && ret.second.sequence == baseSequence + (middle - base))
+		{
+			low = middle;
+			headHeader = ret.second;
+		}
+		else
+			high = middle;
+	}
+
+	headSector_ = low;
+	headSequence_ = headHeader.sequence;
+	validSectors_ = headSector_ - base + 1;
+
+	// sectors after the newest one may contain older records, only one of them may be invalid (interrupted erase)
+	for (size_t distance {1}; distance <= 2 && validSectors_ < sectorsCount_; ++distance)
+	{
+		const auto ret = readSectorHeader((headSector_ + distance) % sectorsCount_);
+		if (ret.first != 0)
+			return ret.first;
+
+		if (ret.second.magic == sectorMagic &&
+				ret.second.sequence == headSequence_ - static_cast<uint32_t>(sectorsCount_ - distance))
+		{
+			validSectors_ = std::max(validSectors_, sectorsCount_ + 1 - distance);
+			break;
+		}
+	}
+
+	// scan all records in the newest sector
+	auto offset = roundUp(sizeof(SectorHeader));
+	nextRecordSequence_ = headHeader.firstRecordSequence;
+	while (1)
+	{
+		const auto ret = readRecord(headSector_, offset, nullptr, {});
+		if (ret.first != 0)
+			return ret.first;
+		if (ret.second.first == 0 || ret.second.second != nextRecordSequence_)
+			break;
+
+		offset += roundUp(sizeof(RecordHeader)) + roundUp(ret.second.first);
+		++nextRecordSequence_;
+	}
+
+	headOffset_ = sectorSize_;
+	if (erasedValue.first == true)
+	{
+		// programming is possible only if the remaining part of sector was not touched by interrupted append
+		const auto ret = isErased(headSector_, offset);
+		if (ret.first != 0)
+			return ret.first;
+		if (ret.second == true)
+			headOffset_ = offset;
+	}
+
+	mounted_ = true;
+	closeScopeGuard.release();
+	return 0;
+}
+
+std::pair<int, size_t> CircularLog::read(Cursor& cursor, void* const buffer, const size_t size)
+{
+	if (buffer == nullptr)
+		return {EINVAL, {}};
+
+	const std::lock_guard<CircularLog> lockGuard {*this};
+
+	if (mounted_ == false)
+		return {EBADF, {}};
+
+	while (1)
+	{
+		const uint32_t distance = headSequence_ - cursor.sectorSequence_;
+		if (distance == UINT32_MAX)	// cursor points to sector which will be opened by next append?
+			return {ENODATA, {}};
+		if (distance >= validSectors_)
+		{
+			cursor = getTail().second;
+			return {EOVERFLOW, {}};
+		}
+		if (distance == 0 && cursor.offset_ >= headOffset_)
+			return {ENODATA, {}};
+
+		const auto sector = (headSector_ + sectorsCount_ - distance) % sectorsCount_;
+		const auto ret = readRecord(sector, cursor.offset_, buffer, size);
+		if (ret.first != 0 && ret.first != EMSGSIZE)
+			return {ret.first, {}};
+
+		if (ret.second.first == 0)	// no more valid records in this sector?
+		{
+			if (distance == 0)
+				return {ENODATA, {}};
+
+			++cursor.sectorSequence_;
+			cursor.offset_ = roundUp(sizeof(SectorHeader));
+			continue;
+		}
+
+		if (ret.first == EMSGSIZE)
+			return {EMSGSIZE, ret.second.first};
+
+		cursor.offset_ += roundUp(sizeof(RecordHeader)) + roundUp(ret.second.first);
+		cursor.recordSequence_ = ret.second.second;
+		return {{}, ret.second.first};
+	}
+}
+
+int CircularLog::synchronize()
+{
+	const std::lock_guard<CircularLog> lockGuard {*this};
+
+	if (mounted_ == false)
+		return EBADF;
+
+	return blockDevice_.synchronize();
+}
+
+int CircularLog::unlock()
+{
+	return blockDevice_.unlock();
+}
+
+int CircularLog::unmount()
+{
+	const std::lock_guard<CircularLog> lockGuard {*this};
+
+	if (mounted_ == false)
+		return EBADF;
+
+	const auto synchronizeRet = blockDevice_.synchronize();
+	const auto closeRet = blockDevice_.close();
+	mounted_ = false;
+
+	return synchronizeRet != 0 ? synchronizeRet : closeRet;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int CircularLog::advanceHead()
+{
+	const auto sector = (headSector_ + 1) % sectorsCount_;
+	if (validSectors_ == sectorsCount_)	// oldest sector will be lost?
+		--validSectors_;
+
+	const auto address = static_cast<uint64_t>(sector) * sectorSize_;
+
+	{
+		const auto ret = blockDevice_.erase(address, sectorSize_);
+		if (ret != 0)
+			return ret;
+	}
+
+	SectorHeader sectorHeader;
+	sectorHeader.magic = sectorMagic;
+	sectorHeader.sequence = headSequence_ + 1;
+	sectorHeader.firstRecordSequence = nextRecordSequence_;
+	sectorHeader.crc = internal::updateCrc32({}, &sectorHeader, sizeof(sectorHeader) - sizeof(sectorHeader.crc));
+
+	{
+		const auto ret = programPadded(address, &sectorHeader, sizeof(sectorHeader));
+		if (ret != 0)
+			return ret;
+	}
+
+	headSector_ = sector;
+	++headSequence_;
+	headOffset_ = roundUp(sizeof(SectorHeader));
+	++validSectors_;
+	return 0;
+}
+
+std::pair<int, bool> CircularLog::isErased(const size_t sector, size_t begin) const
+{
+	const auto bufferUint8 = static_cast<const uint8_t*>(buffer_);
+	while (begin < sectorSize_)
+	{
+		const auto chunk = std::min(bufferSize_, sectorSize_ - begin);
+		const auto ret = blockDevice_.read(static_cast<uint64_t>(sector) * sectorSize_ + begin, buffer_, chunk);
+		if (ret.first != 0)
+			return {ret.first, {}};
+
+		if (std::any_of(bufferUint8, bufferUint8 + chunk,
+				[this](const uint8_t value)
+				{
+					return value != erasedValue_;
+				}) == true)
+			return {{}, false};
+
+		begin += chunk;
+	}
+
+	return {{}, true};
+}
+
+int CircularLog::programPadded(const uint64_t address, const void* const buffer, const size_t size) const
+{
+	const auto alignedSize = size / programBlockSize_ * programBlockSize_;
+	if (alignedSize != 0)
+	{
+		const auto ret = blockDevice_.program(address, buffer, alignedSize);
+		if (ret.first != 0)
+			return ret.first;
+	}
+
+	if (alignedSize == size)
+		return 0;
+
+	const auto bufferUint8 = static_cast<uint8_t*>(buffer_);
+	memcpy(bufferUint8, static_cast<const uint8_t*>(buffer) + alignedSize, size - alignedSize);
+	memset(bufferUint8 + size - alignedSize, erasedValue_, programBlockSize_ - (size - alignedSize));
+	const auto ret = blockDevice_.program(address + alignedSize, buffer_, programBlockSize_);
+	return ret.first;
+}
+
+std::pair<int, CircularLog::SectorHeader> CircularLog::readSectorHeader(const size_t sector) const
+{
+	const auto ret = blockDevice_.read(static_cast<uint64_t>(sector) * sectorSize_, buffer_,
+			roundUp(sizeof(SectorHeader)));
+	if (ret.first != 0)
+		return {ret.first, {}};
+
+	SectorHeader sectorHeader;
+	memcpy(&sectorHeader, buffer_, sizeof(sectorHeader));
+	if (sectorHeader.crc != internal::updateCrc32({}, &sectorHeader, sizeof(sectorHeader) - sizeof(sectorHeader.crc)))
+		sectorHeader.magic = {};
+	return {{}, sectorHeader};
+}
+
+std::pair<int, std::pair<size_t, uint32_t>> CircularLog::readRecord(const size_t sector, const size_t offset,
+		void* const buffer, const size_t size) const
+{
+	const auto recordHeaderSize = roundUp(sizeof(RecordHeader));
+	if (offset + recordHeaderSize > sectorSize_)
+		return {{}, {}};
+
+	const auto address = static_cast<uint64_t>(sector) * sectorSize_ + offset;
+
+	{
+		const auto ret = blockDevice_.read(address, buffer_, recordHeaderSize);
+		if (ret.first != 0)
+			return {ret.first, {}};
+	}
+
+	RecordHeader recordHeader;
+	memcpy(&recordHeader, buffer_, sizeof(recordHeader));
+	if (recordHeader.size == 0 || recordHeader.size != ~recordHeader.sizeComplement ||
+			recordHeader.size > sectorSize_ - offset - recordHeaderSize ||
+			offset + recordHeaderSize + roundUp(recordHeader.size) > sectorSize_)
+		return {{}, {}};
+
+	auto crc = internal::updateCrc32({}, &recordHeader.sequence, sizeof(recordHeader) - sizeof(recordHeader.crc));
+	const auto dataAddress = address + recordHeaderSize;
+
+	if (buffer != nullptr && recordHeader.size <= size)
+	{
+		// aligned part is read directly, the remainder through internal buffer
+		const auto alignedSize = recordHeader.size / programBlockSize_ * programBlockSize_;
+		if (alignedSize != 0)
+		{
+			const auto ret = blockDevice_.read(dataAddress, buffer, alignedSize);
+			if (ret.first != 0)
+				return {ret.first, {}};
+		}
+		if (alignedSize != recordHeader.size)
+		{
+			const auto ret = blockDevice_.read(dataAddress + alignedSize, buffer_, programBlockSize_);
+			if (ret.first != 0)
+				return {ret.first, {}};
+
+			memcpy(static_cast<uint8_t*>(buffer) + alignedSize, buffer_, recordHeader.size - alignedSize);
+		}
+
+		crc = internal::updateCrc32(crc, buffer, recordHeader.size);
+	}
+	else
+	{
+		size_t verified {};
+		while (verified < recordHeader.size)
+		{
+			const auto chunk = std::min(bufferSize_, roundUp(recordHeader.size - verified));
+			const auto ret = blockDevice_.read(dataAddress + verified, buffer_, chunk);
+			if (ret.first != 0)
+				return {ret.first, {}};
+
+			crc = internal::updateCrc32(crc, buffer_, std::min(chunk, recordHeader.size - verified));
+			verified += chunk;
+		}
+	}
+
+	if (crc != recordHeader.crc)
+		return {{}, {}};
+
+	return {buffer != nullptr && recordHeader.size > size ? EMSGSIZE : 0, {recordHeader.size, recordHeader.sequence}};
+}
+
+}	// namespace distortos
@@ -0,0 +1,843 @@
+/**
+ * \file
+ * \brief KeyValueStore class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/storage/KeyValueStore.hpp"
+
+#include "distortos/devices/memory/BlockDevice.hpp"
+
+#include "distortos/internal/storage/updateCrc32.hpp"
+
+#include "estd/ScopeGuard.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+namespace distortos
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// header of sector
+struct SectorHeader
+{
+	/// magic value, equal to sectorMagic if header is valid
+	uint32_t magic;
+
+	/// sequence number of sector
+	uint32_t sequence;
+
+	/// CRC-32 of all preceding fields
+	uint32_t crc;
+};
+
+/// header of record
+struct RecordHeader
+{
+	/// CRC-32 of all following fields and data of record
+	uint32_t crc;
+
+	/// key of value, offset of interrupted record for resynchronization record
+	uint32_t key;
+
+	/// size of value, bytes
+	uint16_t size;
+
+	/// number of records which follow this one in the same commit
+	uint8_t remaining;
+
+	/// flags of record
+	uint8_t flags;
+};
+
+static_assert(sizeof(RecordHeader) == 12, "Invalid size of RecordHeader!");
+
+/// header of value in RAM storage
+struct ValueHeader
+{
+	/// key of value
+	uint32_t key;
+
+	/// size of value, bytes
+	uint32_t size;
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// magic value of valid sector header - "KVS1"
+constexpr uint32_t sectorMagic {0x3153564b};
+
+/// value of Slot::offset_ for empty slot
+constexpr uint32_t emptySlot {UINT32_MAX};
+
+/// flag of record which removes value
+constexpr uint8_t removedFlag {1 << 0};
+
+/// flag of resynchronization record, which follows a record interrupted by power failure
+constexpr uint8_t resyncFlag {1 << 1};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \param [in] size is the size of value, bytes
+ *
+ * \return size of value with its header in RAM storage, bytes
+ */
+
+constexpr size_t getValueBlockSize(const size_t size)
+{
+	return sizeof(ValueHeader) + (size + sizeof(uint32_t) - 1) / sizeof(uint32_t) * sizeof(uint32_t);
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+KeyValueStore::~KeyValueStore()
+{
+	if (mounted_ == true)
+		unmount();
+}
+
+int KeyValueStore::commit(const Change* const changes, const size_t count)
+{
+	if (changes == nullptr || count == 0 || count > UINT8_MAX)
+		return EINVAL;
+
+	const std::lock_guard<KeyValueStore> lockGuard {*this};
+
+	if (mounted_ == false)
+		return EBADF;
+
+	const auto maxValueSize = getMaxValueSize();
+	const auto valuesUint8 = static_cast<uint8_t*>(values_);
+
+	// change which doesn't modify the value is skipped, unless the same key is changed again in this commit
+	const auto isSkipped = [this, changes, count, valuesUint8](const size_t index)
+			{
+				const auto& change = changes[index];
+				for (size_t i {}; i < count; ++i)
+					if (i != index && changes[i].key == change.key)
+						return false;
+
+				const auto& slot = slots_[findSlot(change.key)];
+				if (slot.offset_ == emptySlot)
+					return change.data == nullptr;
+				if (change.data == nullptr)
+					return false;
+
+				ValueHeader valueHeader;
+				memcpy(&valueHeader, valuesUint8 + slot.offset_, sizeof(valueHeader));
+				return valueHeader.size == change.size &&
+						memcmp(valuesUint8 + slot.offset_ + sizeof(valueHeader), change.data, change.size) == 0;
+			};
+
+	size_t records {};
+	size_t recordsSize {};
+	size_t newSlots {};
+	size_t newValues {};
+	for (size_t i {}; i < count; ++i)
+	{
+		const auto& change = changes[i];
+		const auto size = change.data != nullptr ? change.size : 0;
+		if (size > maxValueSize)
+			return EMSGSIZE;
+
+		if (isSkipped(i) == true)
+			continue;
+
+		++records;
+		recordsSize += roundUp(sizeof(RecordHeader) + size);
+		if (change.data != nullptr)
+		{
+			newValues += getValueBlockSize(size);
+			if (slots_[findSlot(change.key)].offset_ == emptySlot)
+				++newSlots;
+		}
+	}
+
+	if (records == 0)
+		return 0;
+
+	if (recordsSize > sectorSize_ - roundUp(sizeof(SectorHeader)))
+		return EMSGSIZE;
+
+	if (usedSlots_ + newSlots >= slotsCount_ || liveValues_ + newValues > valuesSize_)
+		return ENOSPC;
+
+	// each opened sector collects garbage from the oldest one, give up when all sectors were tried
+	for (size_t attempt {}; headOffset_ + recordsSize > sectorSize_; ++attempt)
+	{
+		if (attempt == sectorsCount_)
+			return ENOSPC;
+
+		const auto ret = advanceHead();
+		if (ret != 0)
+			return ret;
+	}
+
+	for (size_t i {}; i < count; ++i)
+	{
+		if (isSkipped(i) == true)
+			continue;
+
+		--records;
+		const auto& change = changes[i];
+		const auto ret = programRecord(change.key, change.data, change.data != nullptr ? change.size : 0, records,
+				change.data != nullptr ? 0 : removedFlag);
+		if (ret != 0)
+			return ret;
+	}
+
+	// changes are applied to RAM only when the whole commit is programmed
+	for (size_t i {}; i < count; ++i)
+	{
+		if (isSkipped(i) == true)
+			continue;
+
+		const auto& change = changes[i];
+		const auto ret = apply(change.key, change.data, change.size, headSector_);
+		if (ret != 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+int KeyValueStore::format()
+{
+	const std::lock_guard<KeyValueStore> lockGuard {*this};
+
+	if (mounted_ == true)
+		return EBUSY;
+
+	{
+		const auto ret = blockDevice_.open();
+		if (ret != 0)
+			return ret;
+	}
+
+	const auto closeScopeGuard = estd::makeScopeGuard([this]()
+			{
+				blockDevice_.close();
+			});
+
+	const auto eraseBlockSize = blockDevice_.getEraseBlockSize();
+	return blockDevice_.erase(0, blockDevice_.getSize() / eraseBlockSize * eraseBlockSize);
+}
+
+std::pair<int, size_t> KeyValueStore::get(const uint32_t key, void* const buffer, const size_t size)
+{
+	const std::lock_guard<KeyValueStore> lockGuard {*this};
+
+	if (mounted_ == false)
+		return {EBADF, {}};
+
+	const auto& slot = slots_[findSlot(key)];
+	if (slot.offset_ == emptySlot)
+		return {ENOENT, {}};
+
+	const auto valuesUint8 = static_cast<const uint8_t*>(values_);
+	ValueHeader valueHeader;
+	memcpy(&valueHeader, valuesUint8 + slot.offset_, sizeof(valueHeader));
+	if (valueHeader.size > size)
+		return {EMSGSIZE, valueHeader.size};
+
+	memcpy(buffer, valuesUint8 + slot.offset_ + sizeof(valueHeader), valueHeader.size);
+	return {{}, valueHeader.size};
+}
+
+size_t KeyValueStore::getMaxValueSize() const
+{
+	if (mounted_ == false)
+		return 0;
+
+	const auto maxRecordSize = std::min(bufferSize_, sectorSize_ - roundUp(sizeof(SectorHeader)));
+	return std::min<size_t>(maxRecordSize - sizeof(RecordHeader), UINT16_MAX);
+}
+
+int KeyValueStore::lock()
+{
+	return blockDevice_.lock();
+}
+
+int KeyValueStore::mount()
+{
+	const std::lock_guard<KeyValueStore> lockGuard {*this};
+
+	if (mounted_ == true)
+		return EBUSY;
+
+	{
+		const auto ret = blockDevice_.open();
+		if (ret != 0)
+			return ret;
+	}
+
+	auto closeScopeGuard = estd::makeScopeGuard([this]()
+			{
+				blockDevice_.close();
+			});
+
+	programBlockSize_ = blockDevice_.getProgramBlockSize();
+	sectorSize_ = blockDevice_.getEraseBlockSize();
+	sectorsCount_ = sectorSize_ != 0 ? blockDevice_.getSize() / sectorSize_ : 0;
+	const auto readBlockSize = blockDevice_.getReadBlockSize();
+	const auto erasedValue = blockDevice_.getErasedValue();
+	erasedValue_ = erasedValue.first == true ? erasedValue.second : UINT8_MAX;
+
+	if (sectorsCount_ < 2 || programBlockSize_ == 0 || readBlockSize == 0 || programBlockSize_ % readBlockSize != 0 ||
+			sectorSize_ % programBlockSize_ != 0 || bufferSize_ % programBlockSize_ != 0 ||
+			bufferSize_ < roundUp(sizeof(RecordHeader)) || sectorSize_ < roundUp(sizeof(SectorHeader)) + bufferSize_ ||
+			slots_ == nullptr || slotsCount_ < 2 || values_ == nullptr ||
+			reinterpret_cast<uintptr_t>(values_) % alignof(ValueHeader) != 0 || valuesSize_ > UINT32_MAX)
+		return EINVAL;
+
+	for (size_t i {}; i < slotsCount_; ++i)
+		slots_[i].offset_ = emptySlot;
+	usedSlots_ = {};
+	usedValues_ = {};
+	liveValues_ = {};
+
+	bool found {};
+	for (size_t sector {}; sector < sectorsCount_; ++sector)
+	{
+		const auto ret = readSectorHeader(sector);
+		if (ret.first != 0)
+			return ret.first;
+
+		if (ret.second.first == true && (found == false || ret.second.second - headSequence_ < UINT32_MAX / 2))
+		{
+			found = true;
+			headSector_ = sector;
+			headSequence_ = ret.second.second;
+		}
+	}
+
+	if (found == false)	// empty store?
+	{
+		if (erasedValue.first == true)
+		{
+			const auto ret = findErasedTail(0, {});
+			if (ret.first != 0)
+				return ret.first;
+			if (ret.second < roundUp(sizeof(SectorHeader)))	// header of first sector is erased?
+			{
+				const auto eraseRet = blockDevice_.erase(0, sectorSize_);
+				if (eraseRet != 0)
+					return eraseRet;
+			}
+			else if (ret.second != 0)
+				return EILSEQ;
+		}
+		else
+		{
+			const auto ret = blockDevice_.erase(0, sectorSize_);
+			if (ret != 0)
+				return ret;
+		}
+
+		// first commit will open first sector
+		headSector_ = sectorsCount_ - 1;
+		headSequence_ = UINT32_MAX;
+		headOffset_ = sectorSize_;
+		mounted_ = true;
+		closeScopeGuard.release();
+		return 0;
+	}
+
+	// replay all sectors from the oldest one
+	size_t headEnd {};
+	for (size_t distance {sectorsCount_ - 1}; distance < sectorsCount_; --distance)
+	{
+		const auto sector = (headSector_ + sectorsCount_ - distance) % sectorsCount_;
+		const auto headerRet = readSectorHeader(sector);
+		if (headerRet.first != 0)
+			return headerRet.first;
+		if (headerRet.second.first == false || headSequence_ - headerRet.second.second != distance)
+			continue;
+
+		const auto ret = replaySector(sector);
+		if (ret.first != 0)
+			return ret.first;
+		headEnd = ret.second;
+	}
+
+	headOffset_ = headEnd;
+	{
+		const auto ret = findErasedTail(headSector_, headEnd);
+		if (ret.first != 0)
+			return ret.first;
+
+		// record interrupted by power failure is skipped with resynchronization record
+		if (ret.second != headEnd)
+		{
+			headOffset_ = sectorSize_;
+			if (ret.second + roundUp(sizeof(RecordHeader)) <= sectorSize_)
+			{
+				headOffset_ = ret.second;
+				const auto programRet = programRecord(headEnd, {}, {}, {}, resyncFlag);
+				if (programRet != 0)
+					return programRet;
+			}
+		}
+	}
+
+	// the sector after the newest one should be erased, otherwise garbage collection was interrupted
+	{
+		const auto sector = (headSector_ + 1) % sectorsCount_;
+		const auto headerRet = readSectorHeader(sector);
+		if (headerRet.first != 0)
+			return headerRet.first;
+
+		if (headerRet.second.first == true)
+		{
+			const auto ret = collect(sector);
+			if (ret != 0)
+				return ret;
+		}
+		else
+		{
+			const auto ret = findErasedTail(sector, {});
+			if (ret.first != 0)
+				return ret.first;
+			if (ret.second != 0)
+			{
+				const auto eraseRet = blockDevice_.erase(static_cast<uint64_t>(sector) * sectorSize_, sectorSize_);
+				if (eraseRet != 0)
+					return eraseRet;
+			}
+		}
+	}
+
+	mounted_ = true;
+	closeScopeGuard.release();
+	return 0;
+}
+
+int KeyValueStore::remove(const uint32_t key)
+{
+	const std::lock_guard<KeyValueStore> lockGuard {*this};
+
+	if (mounted_ == false)
+		return EBADF;
+
+	if (slots_[findSlot(key)].offset_ == emptySlot)
+		return ENOENT;
+
+	const Change change {key, nullptr, {}};
+	return commit(&change, 1);
+}
+
+int KeyValueStore::set(const uint32_t key, const void* const data, const size_t size)
+{
+	if (data == nullptr)
+		return EINVAL;
+
+	const Change change {key, data, size};
+	return commit(&change, 1);
+}
+
+int KeyValueStore::unlock()
+{
+	return blockDevice_.unlock();
+}
+
+int KeyValueStore::unmount()
+{
+	const std::lock_guard<KeyValueStore> lockGuard {*this};
+
+	if (mounted_ == false)
+		return EBADF;
+
+	const auto synchronizeRet = blockDevice_.synchronize();
+	const auto closeRet = blockDevice_.close();
+	mounted_ = false;
+
+	return synchronizeRet != 0 ? synchronizeRet : closeRet;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int KeyValueStore::advanceHead()
+{
+	const auto sector = (headSector_ + 1) % sectorsCount_;
+
+	{
+		SectorHeader sectorHeader;
+		sectorHeader.magic = sectorMagic;
+		sectorHeader.sequence = headSequence_ + 1;
+		sectorHeader.crc = internal::updateCrc32({}, &sectorHeader, sizeof(sectorHeader) - sizeof(sectorHeader.crc));
+
+		const auto bufferUint8 = static_cast<uint8_t*>(buffer_);
+		memcpy(bufferUint8, &sectorHeader, sizeof(sectorHeader));
+		memset(bufferUint8 + sizeof(sectorHeader), erasedValue_, roundUp(sizeof(sectorHeader)) - sizeof(sectorHeader));
+		const auto ret = blockDevice_.program(static_cast<uint64_t>(sector) * sectorSize_, buffer_,
+				roundUp(sizeof(sectorHeader)));
+		if (ret.first != 0)
+			return ret.first;
+	}
+
+	headSector_ = sector;
+	++headSequence_;
+	headOffset_ = roundUp(sizeof(SectorHeader));
+
+	return collect((sector + 1) % sectorsCount_);
+}
+
+int KeyValueStore::apply(const uint32_t key, const void* const data, const size_t size, const size_t sector)
+{
+	const auto slotIndex = findSlot(key);
+	auto& slot = slots_[slotIndex];
+	const auto used = slot.offset_ != emptySlot;
+	const auto valuesUint8 = static_cast<uint8_t*>(values_);
+
+	ValueHeader valueHeader;
+	size_t oldValueBlockSize {};
+	if (used == true)
+	{
+		memcpy(&valueHeader, valuesUint8 + slot.offset_, sizeof(valueHeader));
+		oldValueBlockSize = getValueBlockSize(valueHeader.size);
+	}
+
+	if (data == nullptr)
+	{
+		if (used == true)
+		{
+			liveValues_ -= oldValueBlockSize;
+			removeSlot(slotIndex);
+		}
+		return 0;
+	}
+
+	valueHeader.key = key;
+	valueHeader.size = size;
+	const auto valueBlockSize = getValueBlockSize(size);
+
+	if (used == true && valueBlockSize == oldValueBlockSize)	// value may be overwritten in place?
+	{
+		memcpy(valuesUint8 + slot.offset_, &valueHeader, sizeof(valueHeader));
+		memcpy(valuesUint8 + slot.offset_ + sizeof(valueHeader), data, size);
+		slot.sector_ = sector;
+		return 0;
+	}
+
+	if (used == false && usedSlots_ + 1 >= slotsCount_)
+		return ENOSPC;
+
+	if (usedValues_ + valueBlockSize > valuesSize_)
+	{
+		compactValues();
+		if (usedValues_ + valueBlockSize > valuesSize_)
+			return ENOSPC;
+	}
+
+	memcpy(valuesUint8 + usedValues_, &valueHeader, sizeof(valueHeader));
+	memcpy(valuesUint8 + usedValues_ + sizeof(valueHeader), data, size);
+	slot.key_ = key;
+	slot.offset_ = usedValues_;
+	slot.sector_ = sector;
+	usedValues_ += valueBlockSize;
+	liveValues_ += valueBlockSize - oldValueBlockSize;
+	if (used == false)
+		++usedSlots_;
+	return 0;
+}
+
+int KeyValueStore::collect(const size_t sector)
+{
+	const auto valuesUint8 = static_cast<const uint8_t*>(values_);
+	for (size_t i {}; i < slotsCount_; ++i)
+	{
+		auto& slot = slots_[i];
+		if (slot.offset_ == emptySlot || slot.sector_ != sector)
+			continue;
+
+		ValueHeader valueHeader;
+		memcpy(&valueHeader, valuesUint8 + slot.offset_, sizeof(valueHeader));
+		if (headOffset_ + roundUp(sizeof(RecordHeader) + valueHeader.size) > sectorSize_)
+			return ENOSPC;
+
+		const auto ret = programRecord(slot.key_, valuesUint8 + slot.offset_ + sizeof(valueHeader), valueHeader.size,
+				{}, {});
+		if (ret != 0)
+			return ret;
+
+		slot.sector_ = headSector_;
+	}
+
+	return blockDevice_.erase(static_cast<uint64_t>(sector) * sectorSize_, sectorSize_);
+}
+
+void KeyValueStore::compactValues()
+{
+	const auto valuesUint8 = static_cast<uint8_t*>(values_);
+	size_t write {};
+	for (size_t read {}; read < usedValues_;)
+	{
+		ValueHeader valueHeader;
+		memcpy(&valueHeader, valuesUint8 + read, sizeof(valueHeader));
+		const auto valueBlockSize = getValueBlockSize(valueHeader.size);
+
+		auto& slot = slots_[findSlot(valueHeader.key)];
+		if (slot.offset_ == read)	// value is live?
+		{
+			memmove(valuesUint8 + write, valuesUint8 + read, valueBlockSize);
+			slot.offset_ = write;
+			write += valueBlockSize;
+		}
+
+		read += valueBlockSize;
+	}
+
+	usedValues_ = write;
+}
+
+std::pair<int, size_t> KeyValueStore::findErasedTail(const size_t sector, const size_t begin) const
+{
+	if (blockDevice_.getErasedValue().first == false)
+		return {{}, sectorSize_};
+
+	const auto bufferUint8 = static_cast<const uint8_t*>(buffer_);
+	auto tail = begin;
+	for (auto offset = begin; offset < sectorSize_;)
+	{
+		const auto chunk = std::min(bufferSize_, sectorSize_ - offset);
+		const auto ret = blockDevice_.read(static_cast<uint64_t>(sector) * sectorSize_ + offset, buffer_, chunk);
+		if (ret.first != 0)
+			return {ret.first, {}};
+
+		const auto last = std::find_if(std::reverse_iterator<const uint8_t*>{bufferUint8 + chunk},
+				std::reverse_iterator<const uint8_t*>{bufferUint8},
+				[this](const uint8_t value)
+				{
+					return value != erasedValue_;
+				});
+		if (last.base() != bufferUint8)
+			tail = roundUp(offset + (last.base() - bufferUint8));
+
+		offset += chunk;
+	}
+
+	return {{}, tail};
+}
+
+size_t KeyValueStore::findSlot(const uint32_t key) const
+{
+	auto index = static_cast<uint32_t>(key * UINT32_C(2654435761)) % slotsCount_;
+	while (slots_[index].offset_ != emptySlot && slots_[index].key_ != key)
+		index = (index + 1) % slotsCount_;
+	return index;
+}
+
+int KeyValueStore::programRecord(const uint32_t key, const void* const data, const size_t size,
+		const uint8_t remaining, const uint8_t flags)
+{
+	RecordHeader recordHeader;
+	recordHeader.key = key;
+	recordHeader.size = size;
+	recordHeader.remaining = remaining;
+	recordHeader.flags = flags;
+	recordHeader.crc = internal::updateCrc32(internal::updateCrc32({}, &recordHeader.key,
+			sizeof(recordHeader) - sizeof(recordHeader.crc)), data, size);
+
+	// header and data are programmed with single operation
+	const auto recordSize = roundUp(sizeof(recordHeader) + size);
+	const auto bufferUint8 = static_cast<uint8_t*>(buffer_);
+	memcpy(bufferUint8, &recordHeader, sizeof(recordHeader));
+	if (size != 0)
+		memcpy(bufferUint8 + sizeof(recordHeader), data, size);
+	memset(bufferUint8 + sizeof(recordHeader) + size, erasedValue_, recordSize - sizeof(recordHeader) - size);
+
+	const auto offset = headOffset_;
+	headOffset_ = sectorSize_;	// if programming fails, next record will be programmed in next sector
+	const auto ret = blockDevice_.program(static_cast<uint64_t>(headSector_) * sectorSize_ + offset, buffer_,
+			recordSize);
+	if (ret.first != 0)
+		return ret.first;
+
+	headOffset_ = offset + recordSize;
+	return 0;
+}
+
+std::pair<int, size_t> KeyValueStore::readRecord(const size_t sector, const size_t offset) const
+{
+	const auto headerSize = roundUp(sizeof(RecordHeader));
+	if (offset + headerSize > sectorSize_)
+		return {{}, {}};
+
+	const auto address = static_cast<uint64_t>(sector) * sectorSize_ + offset;
+	const auto bufferUint8 = static_cast<uint8_t*>(buffer_);
+
+	{
+		const auto ret = blockDevice_.read(address, buffer_, headerSize);
+		if (ret.first != 0)
+			return {ret.first, {}};
+	}
+
+	RecordHeader recordHeader;
+	memcpy(&recordHeader, buffer_, sizeof(recordHeader));
+	const auto recordSize = roundUp(sizeof(recordHeader) + recordHeader.size);
+	if ((recordHeader.flags != 0 && recordHeader.flags != removedFlag && recordHeader.flags != resyncFlag) ||
+			(recordHeader.flags != 0 && recordHeader.size != 0) || recordSize > bufferSize_ ||
+			offset + recordSize > sectorSize_)
+		return {{}, {}};
+
+	if (recordSize > headerSize)
+	{
+		const auto ret = blockDevice_.read(address + headerSize, bufferUint8 + headerSize, recordSize - headerSize);
+		if (ret.first != 0)
+			return {ret.first, {}};
+	}
+
+	if (recordHeader.crc != internal::updateCrc32({}, bufferUint8 + sizeof(recordHeader.crc),
+			sizeof(recordHeader) - sizeof(recordHeader.crc) + recordHeader.size))
+		return {{}, {}};
+
+	return {{}, recordSize};
+}
+
+std::pair<int, std::pair<bool, uint32_t>> KeyValueStore::readSectorHeader(const size_t sector) const
+{
+	const auto ret = blockDevice_.read(static_cast<uint64_t>(sector) * sectorSize_, buffer_,
+			roundUp(sizeof(SectorHeader)));
+	if (ret.first != 0)
+		return {ret.first, {}};
+
+	SectorHeader sectorHeader;
+	memcpy(&sectorHeader, buffer_, sizeof(sectorHeader));
+	const auto crc = internal::updateCrc32({}, &sectorHeader, sizeof(sectorHeader) - sizeof(sectorHeader.crc));
+	const auto valid = sectorHeader.magic == sectorMagic && sectorHeader.crc == crc;
+	return {{}, {valid, sectorHeader.sequence}};
+}
+
+void KeyValueStore::removeSlot(size_t slot)
+{
+	slots_[slot].offset_ = emptySlot;
+	--usedSlots_;
+
+	// backward shift deletion - entries which would become unreachable are moved to the freed slot
+	for (auto index = (slot + 1) % slotsCount_; slots_[index].offset_ != emptySlot;
+			index = (index + 1) % slotsCount_)
+	{
+		const auto home = static_cast<uint32_t>(slots_[index].key_ * UINT32_C(2654435761)) % slotsCount_;
+		const auto reachable = slot <= index ? home > slot && home <= index : home > slot || home <= index;
+		if (reachable == true)
+			continue;
+
+		slots_[slot] = slots_[index];
+		slots_[index].offset_ = emptySlot;
+		slot = index;
+	}
+}
+
+std::pair<int, size_t> KeyValueStore::replaySector(const size_t sector)
+{
+	const auto bufferUint8 = static_cast<const uint8_t*>(buffer_);
+	auto offset = roundUp(sizeof(SectorHeader));
+	while (1)
+	{
+		// verify all records of the commit
+		auto end = offset;
+		size_t records {};
+		RecordHeader recordHeader {};
+		do
+		{
+			const auto ret = readRecord(sector, end);
+			if (ret.first != 0)
+				return {ret.first, {}};
+
+			const auto expectedRemaining = recordHeader.remaining - 1;
+			memcpy(&recordHeader, buffer_, sizeof(recordHeader));
+			if (ret.second == 0 || (records != 0 &&
+					(recordHeader.remaining != expectedRemaining || recordHeader.flags == resyncFlag)))
+			{
+				records = {};
+				break;
+			}
+
+			end += ret.second;
+			++records;
+		} while (recordHeader.remaining != 0);
+
+		if (records == 0)	// commit is not complete?
+		{
+			const auto tailRet = findErasedTail(sector, offset);
+			if (tailRet.first != 0)
+				return {tailRet.first, {}};
+			if (tailRet.second == offset)
+				return {{}, offset};
+
+			// look for resynchronization record which follows interrupted record
+			auto resyncOffset = offset + programBlockSize_;
+			for (; resyncOffset < tailRet.second; resyncOffset += programBlockSize_)
+			{
+				const auto ret = readRecord(sector, resyncOffset);
+				if (ret.first != 0)
+					return {ret.first, {}};
+
+				memcpy(&recordHeader, buffer_, sizeof(recordHeader));
+				if (ret.second != 0 && recordHeader.flags == resyncFlag && recordHeader.key == offset)
+				{
+					offset = resyncOffset + ret.second;
+					break;
+				}
+			}
+
+			if (resyncOffset >= tailRet.second)
+				return {{}, offset};
+
+			continue;
+		}
+
+		for (auto recordOffset = offset; recordOffset < end;)
+		{
+			if (records != 1)	// records of single-record commit are already in the buffer
+			{
+				const auto ret = readRecord(sector, recordOffset);
+				if (ret.first != 0)
+					return {ret.first, {}};
+			}
+
+			memcpy(&recordHeader, buffer_, sizeof(recordHeader));
+			if (recordHeader.flags != resyncFlag)
+			{
+				const auto ret = apply(recordHeader.key,
+						recordHeader.flags == removedFlag ? nullptr : bufferUint8 + sizeof(recordHeader),
+						recordHeader.size, sector);
+				if (ret != 0)
+					return {ret, {}};
+			}
+
+			recordOffset += roundUp(sizeof(recordHeader) + recordHeader.size);
+		}
+
+		offset = end;
+	}
+}
+
+}	// namespace distortos
@@ -0,0 +1,19 @@
+#
+# file: distortos-sources.cmake
+#
+# author: Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+#
+# This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+# distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+
+target_sources(distortos PRIVATE
+		${CMAKE_CURRENT_LIST_DIR}/CircularLog.cpp
+		${CMAKE_CURRENT_LIST_DIR}/KeyValueStore.cpp
+		${CMAKE_CURRENT_LIST_DIR}/updateCrc32Software.cpp)
+
+# updateCrc32() is provided by chip when hardware CRC-32 backend is enabled
+if(NOT STORAGE_HARDWARE_CRC32_ENABLE)
+	target_sources(distortos PRIVATE
+			${CMAKE_CURRENT_LIST_DIR}/updateCrc32.cpp)
+endif()
@@ -0,0 +1,31 @@
+/**
+ * \file
+ * \brief updateCrc32() definition
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/storage/updateCrc32.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+uint32_t updateCrc32(const uint32_t crc, const void* const buffer, const size_t size)
+{
+	return updateCrc32Software(crc, buffer, size);
+}
+
+}	// namespace internal
+
+}	// namespace distortos
@@ -0,0 +1,115 @@
+/**
+ * \file
+ * \brief Barrier class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/Barrier.hpp"
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+#include "distortos/internal/CHECK_FUNCTION_CONTEXT.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+std::pair<int, Barrier::Phase> Barrier::arrive()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+	return arriveInternal();
+}
+
+int Barrier::arriveAndDrop()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (expectedCount_ == 0)
+		return EINVAL;
+
+	--expectedCount_;
+	return arriveInternal().first;
+}
+
+int Barrier::arriveAndWait()
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	const auto ret = arriveInternal();
+	if (ret.first != 0)
+		return ret.first;
+
+	return waitInternal(nullptr, ret.second);
+}
+
+int Barrier::tryWaitFor(const TickClock::duration duration, const Phase phase)
+{
+	return tryWaitUntil(TickClock::now() + duration + TickClock::duration{1}, phase);
+}
+
+int Barrier::tryWaitUntil(const TickClock::time_point timePoint, const Phase phase)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+	return waitInternal(&timePoint, phase);
+}
+
+int Barrier::wait(const Phase phase)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+	return waitInternal(nullptr, phase);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+std::pair<int, Barrier::Phase> Barrier::arriveInternal()
+{
+	if (count_ == 0)
+		return {EINVAL, phase_};
+
+	const auto phase = phase_;
+	--count_;
+
+	if (count_ == 0)	// last arrival completes the phase
+	{
+		++phase_;
+		count_ = expectedCount_;
+		internal::getScheduler().unblockAll(blockedList_);
+	}
+
+	return {{}, phase};
+}
+
+int Barrier::waitInternal(const TickClock::time_point* const timePoint, const Phase phase)
+{
+	if (phase_ != phase)	// phase already completed?
+		return 0;
+
+	auto& scheduler = internal::getScheduler();
+	if (timePoint == nullptr)
+		return scheduler.block(blockedList_, ThreadState::blockedOnBarrier);
+
+	return scheduler.blockUntil(blockedList_, ThreadState::blockedOnBarrier, *timePoint);
+}
+
+}	// namespace distortos
@@ -2,7 +2,7 @@
  * \file
  * \brief FifoQueueBase class implementation
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -11,8 +11,21 @@
 
 #include "distortos/internal/synchronization/FifoQueueBase.hpp"
 
+#include "distortos/internal/synchronization/SemaphoreTryWaitForFunctor.hpp"
+#include "distortos/internal/synchronization/SemaphoreTryWaitFunctor.hpp"
+#include "distortos/internal/synchronization/SemaphoreTryWaitUntilFunctor.hpp"
+#include "distortos/internal/synchronization/SemaphoreWaitFunctor.hpp"
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+#include "distortos/internal/CHECK_FUNCTION_CONTEXT.hpp"
+
 #include "distortos/InterruptMaskingLock.hpp"
 
+#include <algorithm>
+#include <cerrno>
+
 namespace distortos
 {
 
@@ -25,6 +38,7 @@ namespace internal
 
 FifoQueueBase::FifoQueueBase(StorageUniquePointer&& storageUniquePointer, const size_t elementSize,
 		const size_t maxElements) :
+		producerList_{},
 		popSemaphore_{0, maxElements},
 		pushSemaphore_{maxElements, maxElements},
 		storageUniquePointer_{std::move(storageUniquePointer)},
@@ -38,7 +52,163 @@ FifoQueueBase::FifoQueueBase(StorageUniquePointer&& storageUniquePointer, const
 
 FifoQueueBase::~FifoQueueBase()
 {
+	const InterruptMaskingLock interruptMaskingLock;
+
+	while (producerList_.empty() == false)
+		unregisterProducer(producerList_.front());
+}
+
+int FifoQueueBase::overwritingPush(const QueueFunctor& dropFunctor, const QueueFunctor& functor,
+		size_t& overflowCount)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (pushSemaphore_.tryWait() == 0)	// queue is not full?
+	{
+		functor(writePosition_);
+		incrementPosition(writePosition_);
+		return popSemaphore_.post();
+	}
+
+	if (pushSemaphore_.getMaxValue() == 0)	// queue has no capacity?
+		return EAGAIN;
+
+	// Queue is full, but some of its elements may already be owned by consumers which were unblocked and didn't run
+	// yet, so popSemaphore_ may be locked. Such consumers take elements from readPosition_ only when they run, so the
+	// oldest element can be replaced without any changes to semaphores - the number of elements doesn't change.
+	dropFunctor(readPosition_);
+	incrementPosition(readPosition_);
+	functor(writePosition_);
+	incrementPosition(writePosition_);
+	++overflowCount;
+	return 0;
+}
+
+int FifoQueueBase::pop(const QueueFunctor& functor)
+{
+	const SemaphoreWaitFunctor semaphoreWaitFunctor;
+	return pop(semaphoreWaitFunctor, functor);
+}
+
+int FifoQueueBase::pop(const SemaphoreFunctor& waitSemaphoreFunctor, const QueueFunctor& functor)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (producerList_.empty() == true)
+		return popPush(waitSemaphoreFunctor, functor, popSemaphore_, pushSemaphore_, readPosition_);
+
+	if (popSemaphore_.getValue() == 0)	// current thread may block?
+		updateProducersPriority(getScheduler().getCurrentThreadControlBlock().getEffectivePriority());
+
+	const auto ret = popPush(waitSemaphoreFunctor, functor, popSemaphore_, pushSemaphore_, readPosition_);
+	updateProducersPriority();
+	return ret;
+}
+
+std::pair<int, size_t> FifoQueueBase::popBatch(const SemaphoreFunctor& waitSemaphoreFunctor,
+		const QueueFunctor& functor, const size_t maxElements)
+{
+	if (maxElements == 0)
+		return {EINVAL, {}};
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	auto ret = waitSemaphoreFunctor(popSemaphore_);
+	if (ret != 0)
+		return {ret, {}};
+
+	size_t popped {};
+	do
+	{
+		functor(readPosition_);
+		incrementPosition(readPosition_);
+		++popped;
+		ret = pushSemaphore_.post();
+	} while (ret == 0 && popped < maxElements && popSemaphore_.tryWait() == 0);
+
+	return {ret, popped};
+}
+
+int FifoQueueBase::push(const QueueFunctor& functor)
+{
+	const SemaphoreWaitFunctor semaphoreWaitFunctor;
+	return push(semaphoreWaitFunctor, functor);
+}
+
+int FifoQueueBase::push(const SemaphoreFunctor& waitSemaphoreFunctor, const QueueFunctor& functor)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	const auto ret = popPush(waitSemaphoreFunctor, functor, pushSemaphore_, popSemaphore_, writePosition_);
+	if (producerList_.empty() == false)
+		updateProducersPriority();
+	return ret;
+}
+
+int FifoQueueBase::registerProducer(QueueProducer& queueProducer)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (queueProducer.isRegistered() == true)
+		return EBUSY;
+
+	queueProducer.fifoQueueBase_ = this;
+	producerList_.push_back(queueProducer);
+	queueProducer.doLock();
+	updateProducersPriority();
+	return 0;
+}
+
+int FifoQueueBase::tryPop(const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
+	return pop(semaphoreTryWaitFunctor, functor);
+}
+
+int FifoQueueBase::tryPopFor(const TickClock::duration duration, const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
+	return pop(semaphoreTryWaitForFunctor, functor);
+}
+
+int FifoQueueBase::tryPopUntil(const TickClock::time_point timePoint, const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
+	return pop(semaphoreTryWaitUntilFunctor, functor);
+}
+
+int FifoQueueBase::tryPush(const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
+	return push(semaphoreTryWaitFunctor, functor);
+}
+
+int FifoQueueBase::tryPushFor(const TickClock::duration duration, const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
+	return push(semaphoreTryWaitForFunctor, functor);
+}
+
+int FifoQueueBase::tryPushUntil(const TickClock::time_point timePoint, const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
+	return push(semaphoreTryWaitUntilFunctor, functor);
+}
+
+int FifoQueueBase::unregisterProducer(QueueProducer& queueProducer)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (queueProducer.fifoQueueBase_ != this)
+		return EINVAL;
 
+	queueProducer.doUnlockOrTransferLock();
+	queueProducer.producerListNode.unlink();
+	queueProducer.fifoQueueBase_ = {};
+	getScheduler().maybeRequestContextSwitch();
+	return 0;
 }
 
 /*---------------------------------------------------------------------------------------------------------------------+
@@ -55,14 +225,25 @@ int FifoQueueBase::popPush(const SemaphoreFunctor& waitSemaphoreFunctor, const Q
 		return ret;
 
 	functor(storage);
-
-	storage = static_cast<uint8_t*>(storage) + elementSize_;
-	if (storage >= storageEnd_)
-		storage = storageUniquePointer_.get();
+	incrementPosition(storage);
 
 	return postSemaphore.post();
 }
 
+void FifoQueueBase::updateProducersPriority(const uint8_t priority)
+{
+	const auto& blockedList = popSemaphore_.blockedList_;
+	const auto inheritedPriority = blockedList.empty() == true ? priority :
+			std::max(priority, blockedList.front().getEffectivePriority());
+
+	for (auto& queueProducer : producerList_)
+		if (queueProducer.getPriorityCeiling() != inheritedPriority)
+			queueProducer.setPriorityCeiling(inheritedPriority);
+
+	// producer which lost its boosted priority may be the current thread
+	getScheduler().maybeRequestContextSwitch();
+}
+
 }	// namespace internal
 
 }	// namespace distortos
@@ -0,0 +1,134 @@
+/**
+ * \file
+ * \brief IpcCallControlBlock class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/synchronization/IpcCallControlBlock.hpp"
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// IpcCallControlBlockUnblockFunctor is a functor executed when unblocking a client thread that is blocked on
+/// IpcCallControlBlock
+class IpcCallControlBlockUnblockFunctor : public UnblockFunctor
+{
+public:
+
+	/**
+	 * \brief IpcCallControlBlockUnblockFunctor's constructor
+	 *
+	 * \param [in] ipcCallControlBlock is a reference to IpcCallControlBlock that blocked the thread
+	 */
+
+	constexpr explicit IpcCallControlBlockUnblockFunctor(IpcCallControlBlock& ipcCallControlBlock) :
+			ipcCallControlBlock_{ipcCallControlBlock}
+	{
+
+	}
+
+	/**
+	 * \brief IpcCallControlBlockUnblockFunctor's function call operator
+	 *
+	 * If the wait for reply was interrupted, the call is abandoned - it is removed from the endpoint and (if it was
+	 * already received) the server stops inheriting the priority of the client. Pointer to MutexControlBlock with
+	 * priorityInheritance protocol which caused the thread to block is reset to nullptr.
+	 *
+	 * \param [in] threadControlBlock is a reference to ThreadControlBlock that is being unblocked
+	 * \param [in] unblockReason is the reason of thread unblocking
+	 */
+
+	void operator()(ThreadControlBlock& threadControlBlock, const UnblockReason unblockReason) const override
+	{
+		threadControlBlock.setPriorityInheritanceMutexControlBlock(nullptr);
+
+		if (unblockReason != UnblockReason::unblockRequest)
+			ipcCallControlBlock_.abandon();
+	}
+
+private:
+
+	/// reference to IpcCallControlBlock that blocked the thread
+	IpcCallControlBlock& ipcCallControlBlock_;
+};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void IpcCallControlBlock::accept(ThreadControlBlock& server)
+{
+	doLock(server);
+
+	const auto client = getClient();
+	if (client == nullptr)	// client is not blocked yet? priority will be donated in block()
+		return;
+
+	client->setPriorityInheritanceMutexControlBlock(this);
+	server.updateBoostedPriority();
+}
+
+void IpcCallControlBlock::abandon()
+{
+	callListNode.unlink();
+
+	if (getOwner() != nullptr)
+		doUnlockOrTransferLock();
+}
+
+int IpcCallControlBlock::block(const TickClock::time_point* const timePoint)
+{
+	auto& scheduler = getScheduler();
+
+	if (getOwner() != nullptr)	// call was already accepted by the server?
+	{
+		auto& currentThreadControlBlock = scheduler.getCurrentThreadControlBlock();
+		currentThreadControlBlock.setPriorityInheritanceMutexControlBlock(this);
+
+		// calling thread is not yet on the blocked list, that's why it's effective priority is given explicitly
+		getOwner()->updateBoostedPriority(currentThreadControlBlock.getEffectivePriority());
+	}
+
+	const IpcCallControlBlockUnblockFunctor unblockFunctor {*this};
+	const auto ret = timePoint == nullptr ?
+			scheduler.block(getBlockedList(), ThreadState::blockedOnIpcEndpointCall, &unblockFunctor) :
+			scheduler.blockUntil(getBlockedList(), ThreadState::blockedOnIpcEndpointCall, *timePoint,
+					&unblockFunctor);
+	if (ret != 0)
+		return ret;
+
+	// the call was finished by the server, which transferred the ownership to the client - release it
+	doUnlockOrTransferLock();
+	return 0;
+}
+
+void IpcCallControlBlock::finish(const IpcMessage& message)
+{
+	callListNode.unlink();
+	message_ = message;
+	doUnlockOrTransferLock();
+}
+
+}	// namespace internal
+
+}	// namespace distortos
@@ -0,0 +1,143 @@
+/**
+ * \file
+ * \brief IpcEndpoint class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/IpcEndpoint.hpp"
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+#include "distortos/internal/CHECK_FUNCTION_CONTEXT.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int IpcEndpoint::call(IpcMessage& message)
+{
+	return callInternal(nullptr, message);
+}
+
+int IpcEndpoint::receive(IpcMessage& message)
+{
+	return receiveInternal(true, nullptr, message);
+}
+
+int IpcEndpoint::reply(const IpcMessage& message)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	const auto& currentThreadControlBlock = internal::getScheduler().getCurrentThreadControlBlock();
+	for (auto& ipcCallControlBlock : activeCallList_)
+		if (ipcCallControlBlock.getOwner() == &currentThreadControlBlock)
+		{
+			ipcCallControlBlock.finish(message);
+			return 0;
+		}
+
+	return EPERM;
+}
+
+int IpcEndpoint::tryCallFor(const TickClock::duration duration, IpcMessage& message)
+{
+	return tryCallUntil(TickClock::now() + duration + TickClock::duration{1}, message);
+}
+
+int IpcEndpoint::tryCallUntil(const TickClock::time_point timePoint, IpcMessage& message)
+{
+	return callInternal(&timePoint, message);
+}
+
+int IpcEndpoint::tryReceive(IpcMessage& message)
+{
+	return receiveInternal(false, nullptr, message);
+}
+
+int IpcEndpoint::tryReceiveFor(const TickClock::duration duration, IpcMessage& message)
+{
+	return tryReceiveUntil(TickClock::now() + duration + TickClock::duration{1}, message);
+}
+
+int IpcEndpoint::tryReceiveUntil(const TickClock::time_point timePoint, IpcMessage& message)
+{
+	return receiveInternal(true, &timePoint, message);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int IpcEndpoint::callInternal(const TickClock::time_point* const timePoint, IpcMessage& message)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	// don't hand the call over to the server if it would be abandoned immediately anyway
+	if (timePoint != nullptr && *timePoint <= TickClock::now())
+		return ETIMEDOUT;
+
+	internal::IpcCallControlBlock ipcCallControlBlock {message};
+
+	if (receiverList_.empty() == false)	// some server is waiting? hand the call over directly
+	{
+		auto& ipcReceiverControlBlock = receiverList_.front();
+		ipcCallControlBlock.accept(ipcReceiverControlBlock.getServer());
+		activeCallList_.push_front(ipcCallControlBlock);
+		// server is unblocked, but context switch will happen only when this thread blocks on the call
+		ipcReceiverControlBlock.deliver(message);
+	}
+	else
+		pendingCallList_.push_back(ipcCallControlBlock);
+
+	return ipcCallControlBlock.block(timePoint);
+}
+
+int IpcEndpoint::receiveInternal(const bool block, const TickClock::time_point* const timePoint,
+		IpcMessage& message)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (pendingCallList_.empty() == false)
+	{
+		// find the call of the highest priority client, in case of equal priorities the oldest call wins
+		auto iterator = pendingCallList_.begin();
+		for (auto candidate = std::next(iterator); candidate != pendingCallList_.end(); ++candidate)
+			if (candidate->getClient()->getEffectivePriority() > iterator->getClient()->getEffectivePriority())
+				iterator = candidate;
+
+		auto& ipcCallControlBlock = *iterator;
+		pendingCallList_.erase(iterator);
+		activeCallList_.push_front(ipcCallControlBlock);
+		ipcCallControlBlock.accept(internal::getScheduler().getCurrentThreadControlBlock());
+		message = ipcCallControlBlock.getMessage();
+		return 0;
+	}
+
+	if (block == false)
+		return EAGAIN;
+
+	internal::IpcReceiverControlBlock ipcReceiverControlBlock {message};
+	receiverList_.push_back(ipcReceiverControlBlock);
+	return ipcReceiverControlBlock.block(timePoint);
+}
+
+}	// namespace distortos
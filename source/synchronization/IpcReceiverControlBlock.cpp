@@ -0,0 +1,93 @@
+/**
+ * \file
+ * \brief IpcReceiverControlBlock class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/synchronization/IpcReceiverControlBlock.hpp"
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// IpcReceiverControlBlockUnblockFunctor is a functor executed when unblocking a server thread that is blocked on
+/// IpcReceiverControlBlock
+class IpcReceiverControlBlockUnblockFunctor : public UnblockFunctor
+{
+public:
+
+	/**
+	 * \brief IpcReceiverControlBlockUnblockFunctor's constructor
+	 *
+	 * \param [in] ipcReceiverControlBlock is a reference to IpcReceiverControlBlock that blocked the thread
+	 */
+
+	constexpr explicit IpcReceiverControlBlockUnblockFunctor(IpcReceiverControlBlock& ipcReceiverControlBlock) :
+			ipcReceiverControlBlock_{ipcReceiverControlBlock}
+	{
+
+	}
+
+	/**
+	 * \brief IpcReceiverControlBlockUnblockFunctor's function call operator
+	 *
+	 * Removes IpcReceiverControlBlock from the list of receivers in the endpoint, so that no client will try to
+	 * deliver a call to a server which is no longer waiting.
+	 *
+	 * \param [in] threadControlBlock is a reference to ThreadControlBlock that is being unblocked
+	 * \param [in] unblockReason is the reason of thread unblocking
+	 */
+
+	void operator()(ThreadControlBlock&, UnblockReason) const override
+	{
+		ipcReceiverControlBlock_.receiverListNode.unlink();
+	}
+
+private:
+
+	/// reference to IpcReceiverControlBlock that blocked the thread
+	IpcReceiverControlBlock& ipcReceiverControlBlock_;
+};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int IpcReceiverControlBlock::block(const TickClock::time_point* const timePoint)
+{
+	auto& scheduler = getScheduler();
+	const IpcReceiverControlBlockUnblockFunctor unblockFunctor {*this};
+	if (timePoint == nullptr)
+		return scheduler.block(blockedList_, ThreadState::blockedOnIpcEndpointReceive, &unblockFunctor);
+
+	return scheduler.blockUntil(blockedList_, ThreadState::blockedOnIpcEndpointReceive, *timePoint, &unblockFunctor);
+}
+
+void IpcReceiverControlBlock::deliver(const IpcMessage& message)
+{
+	message_ = message;
+	getScheduler().unblock(blockedList_.begin());
+}
+
+}	// namespace internal
+
+}	// namespace distortos
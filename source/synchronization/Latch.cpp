@@ -0,0 +1,104 @@
+/**
+ * \file
+ * \brief Latch class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/Latch.hpp"
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+#include "distortos/internal/CHECK_FUNCTION_CONTEXT.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int Latch::arriveAndWait(const Value value)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	const auto ret = countDownInternal(value);
+	if (ret != 0)
+		return ret;
+
+	return waitInternal(nullptr);
+}
+
+int Latch::countDown(const Value value)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+	return countDownInternal(value);
+}
+
+int Latch::tryWait() const
+{
+	return count_ == 0 ? 0 : EAGAIN;
+}
+
+int Latch::tryWaitFor(const TickClock::duration duration)
+{
+	return tryWaitUntil(TickClock::now() + duration + TickClock::duration{1});
+}
+
+int Latch::tryWaitUntil(const TickClock::time_point timePoint)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+	return waitInternal(&timePoint);
+}
+
+int Latch::wait()
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+	return waitInternal(nullptr);
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+int Latch::countDownInternal(const Value value)
+{
+	if (value == 0 || value > count_)
+		return EINVAL;
+
+	count_ -= value;
+
+	if (count_ == 0)
+		internal::getScheduler().unblockAll(blockedList_);
+
+	return 0;
+}
+
+int Latch::waitInternal(const TickClock::time_point* const timePoint)
+{
+	if (count_ == 0)
+		return 0;
+
+	auto& scheduler = internal::getScheduler();
+	if (timePoint == nullptr)
+		return scheduler.block(blockedList_, ThreadState::blockedOnBarrier);
+
+	return scheduler.blockUntil(blockedList_, ThreadState::blockedOnBarrier, *timePoint);
+}
+
+}	// namespace distortos
@@ -0,0 +1,58 @@
+/**
+ * \file
+ * \brief LatestValueBase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/synchronization/LatestValueBase.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <atomic>
+#include <cstring>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+LatestValueBase::Sequence LatestValueBase::read(void* const buffer, const void* const storage, const size_t size) const
+{
+	Sequence sequence;
+	do
+	{
+		sequence = updateNotifier_.getSequence();
+		std::atomic_signal_fence(std::memory_order_acquire);
+		memcpy(buffer, storage, size);
+		std::atomic_signal_fence(std::memory_order_acquire);
+	} while ((sequence & 1) != 0 || updateNotifier_.getSequence() != sequence);
+
+	return sequence;
+}
+
+void LatestValueBase::write(void* const storage, const void* const data, const size_t size)
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	updateNotifier_.increment();
+	std::atomic_signal_fence(std::memory_order_release);
+	memcpy(storage, data, size);
+	std::atomic_signal_fence(std::memory_order_release);
+	updateNotifier_.increment();
+
+	updateNotifier_.notifyAll();
+}
+
+}	// namespace internal
+
+}	// namespace distortos
@@ -2,7 +2,7 @@
  * \file
  * \brief MessageQueueBase class implementation
  *
- * \author Copyright (C) 2015-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2015-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -11,6 +11,11 @@
 
 #include "distortos/internal/synchronization/MessageQueueBase.hpp"
 
+#include "distortos/internal/synchronization/SemaphoreTryWaitForFunctor.hpp"
+#include "distortos/internal/synchronization/SemaphoreTryWaitFunctor.hpp"
+#include "distortos/internal/synchronization/SemaphoreTryWaitUntilFunctor.hpp"
+#include "distortos/internal/synchronization/SemaphoreWaitFunctor.hpp"
+
 #include "distortos/InterruptMaskingLock.hpp"
 
 namespace distortos
@@ -154,12 +159,24 @@ MessageQueueBase::~MessageQueueBase()
 
 }
 
+int MessageQueueBase::pop(uint8_t& priority, const QueueFunctor& functor)
+{
+	const SemaphoreWaitFunctor semaphoreWaitFunctor;
+	return pop(semaphoreWaitFunctor, priority, functor);
+}
+
 int MessageQueueBase::pop(const SemaphoreFunctor& waitSemaphoreFunctor, uint8_t& priority, const QueueFunctor& functor)
 {
 	const PopInternalFunctor popInternalFunctor {priority, functor};
 	return popPush(waitSemaphoreFunctor, popInternalFunctor, popSemaphore_, pushSemaphore_);
 }
 
+int MessageQueueBase::push(const uint8_t priority, const QueueFunctor& functor)
+{
+	const SemaphoreWaitFunctor semaphoreWaitFunctor;
+	return push(semaphoreWaitFunctor, priority, functor);
+}
+
 int MessageQueueBase::push(const SemaphoreFunctor& waitSemaphoreFunctor, const uint8_t priority,
 		const QueueFunctor& functor)
 {
@@ -167,6 +184,45 @@ int MessageQueueBase::push(const SemaphoreFunctor& waitSemaphoreFunctor, const u
 	return popPush(waitSemaphoreFunctor, pushInternalFunctor, pushSemaphore_, popSemaphore_);
 }
 
+int MessageQueueBase::tryPop(uint8_t& priority, const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
+	return pop(semaphoreTryWaitFunctor, priority, functor);
+}
+
+int MessageQueueBase::tryPopFor(const TickClock::duration duration, uint8_t& priority, const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
+	return pop(semaphoreTryWaitForFunctor, priority, functor);
+}
+
+int MessageQueueBase::tryPopUntil(const TickClock::time_point timePoint, uint8_t& priority,
+		const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
+	return pop(semaphoreTryWaitUntilFunctor, priority, functor);
+}
+
+int MessageQueueBase::tryPush(const uint8_t priority, const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitFunctor semaphoreTryWaitFunctor;
+	return push(semaphoreTryWaitFunctor, priority, functor);
+}
+
+int MessageQueueBase::tryPushFor(const TickClock::duration duration, const uint8_t priority,
+		const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitForFunctor semaphoreTryWaitForFunctor {duration};
+	return push(semaphoreTryWaitForFunctor, priority, functor);
+}
+
+int MessageQueueBase::tryPushUntil(const TickClock::time_point timePoint, const uint8_t priority,
+		const QueueFunctor& functor)
+{
+	const SemaphoreTryWaitUntilFunctor semaphoreTryWaitUntilFunctor {timePoint};
+	return push(semaphoreTryWaitUntilFunctor, priority, functor);
+}
+
 /*---------------------------------------------------------------------------------------------------------------------+
 | private functions
 +---------------------------------------------------------------------------------------------------------------------*/
@@ -2,7 +2,7 @@
  * \file
  * \brief MutexControlBlock class implementation
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -117,8 +117,12 @@ int MutexControlBlock::doBlockUntil(const TickClock::time_point timePoint)
 
 void MutexControlBlock::doLock()
 {
-	auto& scheduler = getScheduler();
-	owner_ = &scheduler.getCurrentThreadControlBlock();
+	doLock(getScheduler().getCurrentThreadControlBlock());
+}
+
+void MutexControlBlock::doLock(ThreadControlBlock& owner)
+{
+	owner_ = &owner;
 
 	if (getProtocol() == Protocol::none)
 		return;
@@ -149,6 +153,16 @@ void MutexControlBlock::doUnlockOrTransferLock()
 	getOwner()->updateBoostedPriority();
 }
 
+void MutexControlBlock::setPriorityCeiling(const uint8_t priorityCeiling)
+{
+	priorityCeiling_ = priorityCeiling;
+
+	if (getOwner() == nullptr)
+		return;
+
+	getOwner()->updateBoostedPriority();
+}
+
 /*---------------------------------------------------------------------------------------------------------------------+
 | private functions
 +---------------------------------------------------------------------------------------------------------------------*/
@@ -0,0 +1,35 @@
+/**
+ * \file
+ * \brief QueueProducer class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/QueueProducer.hpp"
+
+#include "distortos/internal/synchronization/FifoQueueBase.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+namespace distortos
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+QueueProducer::~QueueProducer()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (fifoQueueBase_ == nullptr)
+		return;
+
+	fifoQueueBase_->unregisterProducer(*this);
+}
+
+}	// namespace distortos
@@ -2,7 +2,7 @@
  * \file
  * \brief Semaphore class implementation
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -11,6 +11,8 @@
 
 #include "distortos/Semaphore.hpp"
 
+#include "distortos/architecture/isInInterruptContext.hpp"
+
 #include "distortos/internal/scheduler/getScheduler.hpp"
 #include "distortos/internal/scheduler/Scheduler.hpp"
 
@@ -27,73 +29,103 @@ namespace distortos
 | public functions
 +---------------------------------------------------------------------------------------------------------------------*/
 
-int Semaphore::post()
+int Semaphore::post(const Value units)
 {
+	if (units == 0)
+		return EINVAL;
+
 	const InterruptMaskingLock interruptMaskingLock;
 
-	if (value_ == maxValue_)
+	if (units > maxValue_ - value_)
 		return EOVERFLOW;
 
-	if (blockedList_.empty() == false)
-	{
-		internal::getScheduler().unblock(blockedList_.begin());
-		return 0;
-	}
-
-	++value_;
+	value_ += units;
+	unblockWaiters();
 
 	return 0;
 }
 
-int Semaphore::tryWait()
+int Semaphore::tryWait(const Value units)
 {
+	if (units == 0 || units > maxValue_)
+		return EINVAL;
+
 	const InterruptMaskingLock interruptMaskingLock;
-	return tryWaitInternal();
+	return tryWaitInternal(units);
 }
 
-int Semaphore::tryWaitFor(const TickClock::duration duration)
+int Semaphore::tryWaitFor(const TickClock::duration duration, const Value units)
 {
-	return tryWaitUntil(TickClock::now() + duration + TickClock::duration{1});
+	return tryWaitUntil(TickClock::now() + duration + TickClock::duration{1}, units);
 }
 
-int Semaphore::tryWaitUntil(const TickClock::time_point timePoint)
+int Semaphore::tryWaitUntil(const TickClock::time_point timePoint, const Value units)
 {
-	CHECK_FUNCTION_CONTEXT();
-
-	const InterruptMaskingLock interruptMaskingLock;
-
-	const auto ret = tryWaitInternal();
-	if (ret != EAGAIN)	// lock successful?
-		return ret;
-
-	return internal::getScheduler().blockUntil(blockedList_, ThreadState::blockedOnSemaphore, timePoint);
+	return waitInternal(&timePoint, units);
 }
 
-int Semaphore::wait()
+int Semaphore::wait(const Value units)
 {
-	CHECK_FUNCTION_CONTEXT();
-
-	const InterruptMaskingLock interruptMaskingLock;
-
-	const auto ret = tryWaitInternal();
-	if (ret != EAGAIN)	// lock successful?
-		return ret;
-
-	return internal::getScheduler().block(blockedList_, ThreadState::blockedOnSemaphore);
+	return waitInternal(nullptr, units);
 }
 
 /*---------------------------------------------------------------------------------------------------------------------+
 | private functions
 +---------------------------------------------------------------------------------------------------------------------*/
 
-int Semaphore::tryWaitInternal()
+int Semaphore::tryWaitInternal(const Value units)
 {
-	if (value_ == 0)	// lock not possible?
+	if (value_ < units)	// lock not possible?
+		return EAGAIN;
+
+	// don't overtake threads which are already waiting and would be unblocked before the calling thread - in interrupt
+	// context there is no calling thread (priority of interrupted thread is meaningless), so never overtake them
+	if (blockedList_.empty() == false && (architecture::isInInterruptContext() == true ||
+			blockedList_.front().getEffectivePriority() >=
+			internal::getScheduler().getCurrentThreadControlBlock().getEffectivePriority()))
 		return EAGAIN;
 
-	--value_;
+	value_ -= units;
 
 	return 0;
 }
 
+void Semaphore::unblockWaiters()
+{
+	auto& scheduler = internal::getScheduler();
+	while (blockedList_.empty() == false)
+	{
+		// all threads on blockedList_ were blocked by waitInternal(), so the number of requested units is always valid
+		const auto units = blockedList_.front().getRequestedSemaphoreUnits();
+		if (units > value_)	// first thread cannot be satisfied yet? don't let the following threads starve it
+			return;
+
+		value_ -= units;
+		scheduler.unblock(blockedList_.begin());
+	}
+}
+
+int Semaphore::waitInternal(const TickClock::time_point* const timePoint, const Value units)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	if (units == 0 || units > maxValue_)
+		return EINVAL;
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	const auto tryWaitRet = tryWaitInternal(units);
+	if (tryWaitRet != EAGAIN)	// lock successful?
+		return tryWaitRet;
+
+	auto& scheduler = internal::getScheduler();
+	scheduler.getCurrentThreadControlBlock().setRequestedSemaphoreUnits(units);
+	const auto ret = timePoint == nullptr ? scheduler.block(blockedList_, ThreadState::blockedOnSemaphore) :
+			scheduler.blockUntil(blockedList_, ThreadState::blockedOnSemaphore, *timePoint);
+	if (ret != 0)	// calling thread may have been blocking the threads waiting after it
+		unblockWaiters();
+
+	return ret;
+}
+
 }	// namespace distortos
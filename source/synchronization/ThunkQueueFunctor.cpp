@@ -0,0 +1,31 @@
+/**
+ * \file
+ * \brief ThunkQueueFunctor class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/synchronization/ThunkQueueFunctor.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void ThunkQueueFunctor::operator()(void* const storage) const
+{
+	thunk_(storage, object_);
+}
+
+}	// namespace internal
+
+}	// namespace distortos
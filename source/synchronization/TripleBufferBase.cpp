@@ -0,0 +1,82 @@
+/**
+ * \file
+ * \brief TripleBufferBase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/synchronization/TripleBufferBase.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <utility>
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void TripleBufferBase::publish()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	std::swap(backIndex_, middleIndex_);
+	updateNotifier_.increment();
+	updateNotifier_.notifyAll();
+}
+
+int TripleBufferBase::tryWaitFor(const TickClock::duration duration)
+{
+	const auto ret = updateNotifier_.tryWaitFor(duration, readSequence_);
+	if (ret != 0)
+		return ret;
+
+	update();
+	return 0;
+}
+
+int TripleBufferBase::tryWaitUntil(const TickClock::time_point timePoint)
+{
+	const auto ret = updateNotifier_.tryWaitUntil(timePoint, readSequence_);
+	if (ret != 0)
+		return ret;
+
+	update();
+	return 0;
+}
+
+bool TripleBufferBase::update()
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	const auto sequence = updateNotifier_.getSequence();
+	if (sequence == readSequence_)
+		return false;
+
+	std::swap(frontIndex_, middleIndex_);
+	readSequence_ = sequence;
+	return true;
+}
+
+int TripleBufferBase::wait()
+{
+	const auto ret = updateNotifier_.wait(readSequence_);
+	if (ret != 0)
+		return ret;
+
+	update();
+	return 0;
+}
+
+}	// namespace internal
+
+}	// namespace distortos
@@ -0,0 +1,68 @@
+/**
+ * \file
+ * \brief UpdateNotifier class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/synchronization/UpdateNotifier.hpp"
+
+#include "distortos/internal/scheduler/getScheduler.hpp"
+#include "distortos/internal/scheduler/Scheduler.hpp"
+
+#include "distortos/internal/CHECK_FUNCTION_CONTEXT.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void UpdateNotifier::notifyAll()
+{
+	while (blockedList_.empty() == false)
+		getScheduler().unblock(blockedList_.begin());
+}
+
+int UpdateNotifier::tryWaitFor(const TickClock::duration duration, const Sequence sequence)
+{
+	return tryWaitUntil(TickClock::now() + duration + TickClock::duration{1}, sequence);
+}
+
+int UpdateNotifier::tryWaitUntil(const TickClock::time_point timePoint, const Sequence sequence)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (sequence_ != sequence)
+		return 0;
+
+	return getScheduler().blockUntil(blockedList_, ThreadState::blockedOnNewValue, timePoint);
+}
+
+int UpdateNotifier::wait(const Sequence sequence)
+{
+	CHECK_FUNCTION_CONTEXT();
+
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (sequence_ != sequence)
+		return 0;
+
+	return getScheduler().block(blockedList_, ThreadState::blockedOnNewValue);
+}
+
+}	// namespace internal
+
+}	// namespace distortos
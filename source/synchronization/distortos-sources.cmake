@@ -8,16 +8,23 @@
 #
 
 target_sources(distortos PRIVATE
+		${CMAKE_CURRENT_LIST_DIR}/Barrier.cpp
 		${CMAKE_CURRENT_LIST_DIR}/ConditionVariable.cpp
 		${CMAKE_CURRENT_LIST_DIR}/DynamicRawFifoQueue.cpp
 		${CMAKE_CURRENT_LIST_DIR}/DynamicRawMessageQueue.cpp
 		${CMAKE_CURRENT_LIST_DIR}/DynamicSignalsReceiver.cpp
 		${CMAKE_CURRENT_LIST_DIR}/FifoQueueBase.cpp
+		${CMAKE_CURRENT_LIST_DIR}/IpcCallControlBlock.cpp
+		${CMAKE_CURRENT_LIST_DIR}/IpcEndpoint.cpp
+		${CMAKE_CURRENT_LIST_DIR}/IpcReceiverControlBlock.cpp
+		${CMAKE_CURRENT_LIST_DIR}/Latch.cpp
+		${CMAKE_CURRENT_LIST_DIR}/LatestValueBase.cpp
 		${CMAKE_CURRENT_LIST_DIR}/MemcpyPopQueueFunctor.cpp
 		${CMAKE_CURRENT_LIST_DIR}/MemcpyPushQueueFunctor.cpp
 		${CMAKE_CURRENT_LIST_DIR}/MessageQueueBase.cpp
 		${CMAKE_CURRENT_LIST_DIR}/MutexControlBlock.cpp
 		${CMAKE_CURRENT_LIST_DIR}/Mutex.cpp
+		${CMAKE_CURRENT_LIST_DIR}/QueueProducer.cpp
 		${CMAKE_CURRENT_LIST_DIR}/RawFifoQueue.cpp
 		${CMAKE_CURRENT_LIST_DIR}/RawMessageQueue.cpp
 		${CMAKE_CURRENT_LIST_DIR}/Semaphore.cpp
@@ -29,4 +36,7 @@ target_sources(distortos PRIVATE
 		${CMAKE_CURRENT_LIST_DIR}/SignalsCatcherControlBlock.cpp
 		${CMAKE_CURRENT_LIST_DIR}/SignalSet.cpp
 		${CMAKE_CURRENT_LIST_DIR}/SignalsReceiverControlBlock.cpp
-		${CMAKE_CURRENT_LIST_DIR}/ThisThread-Signals.cpp)
+		${CMAKE_CURRENT_LIST_DIR}/ThisThread-Signals.cpp
+		${CMAKE_CURRENT_LIST_DIR}/ThunkQueueFunctor.cpp
+		${CMAKE_CURRENT_LIST_DIR}/TripleBufferBase.cpp
+		${CMAKE_CURRENT_LIST_DIR}/UpdateNotifier.cpp)
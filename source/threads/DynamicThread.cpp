@@ -82,6 +82,20 @@ uint8_t DynamicThread::getEffectivePriority() const
 	return detachableThread_->getEffectivePriority();
 }
 
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+HeapStatistics DynamicThread::getHeapStatistics() const
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (detachableThread_ == nullptr)
+		return {};
+
+	return detachableThread_->getHeapStatistics();
+}
+
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
 ThreadIdentifier DynamicThread::getIdentifier() const
 {
 	const InterruptMaskingLock interruptMaskingLock;
@@ -116,6 +130,16 @@ uint8_t DynamicThread::getPriority() const
 	return detachableThread_->getPriority();
 }
 
+uint64_t DynamicThread::getRunTickCount() const
+{
+	const InterruptMaskingLock interruptMaskingLock;
+
+	if (detachableThread_ == nullptr)
+		return {};
+
+	return detachableThread_->getRunTickCount();
+}
+
 SchedulingPolicy DynamicThread::getSchedulingPolicy() const
 {
 	const InterruptMaskingLock interruptMaskingLock;
@@ -66,6 +66,16 @@ uint8_t ThreadCommon::getEffectivePriority() const
 	return getThreadControlBlock().getEffectivePriority();
 }
 
+#if CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
+HeapStatistics ThreadCommon::getHeapStatistics() const
+{
+	const InterruptMaskingLock interruptMaskingLock;
+	return getThreadControlBlock().getHeapStatistics();
+}
+
+#endif	// CONFIG_HEAP_ACCOUNTING_ENABLE == 1
+
 ThreadIdentifier ThreadCommon::getIdentifier() const
 {
 	const auto& threadControlBlock = getThreadControlBlock();
@@ -91,6 +101,12 @@ uint8_t ThreadCommon::getPriority() const
 	return getThreadControlBlock().getPriority();
 }
 
+uint64_t ThreadCommon::getRunTickCount() const
+{
+	const InterruptMaskingLock interruptMaskingLock;
+	return getThreadControlBlock().getRunTickCount();
+}
+
 SchedulingPolicy ThreadCommon::getSchedulingPolicy() const
 {
 	return getThreadControlBlock().getSchedulingPolicy();
@@ -2,7 +2,7 @@
  * \file
  * \brief threadExiter() definition
  *
- * \author Copyright (C) 2014-2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -30,6 +30,13 @@ namespace internal
 
 void threadExiter(RunnableThread& runnableThread)
 {
+#if CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+
+	// free blocks cached by exiting thread would be lost, return them to heap while the thread can still use the mutex
+	getScheduler().getCurrentThreadControlBlock().getThreadCache().flush();
+
+#endif	// CONFIG_THREAD_CACHING_ALLOCATOR_ENABLE == 1
+
 	{
 		const InterruptMaskingLock interruptMaskingLock;
 
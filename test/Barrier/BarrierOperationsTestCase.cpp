@@ -0,0 +1,181 @@
+/**
+ * \file
+ * \brief BarrierOperationsTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "BarrierOperationsTestCase.hpp"
+
+#include "SequenceAsserter.hpp"
+
+#include "distortos/Barrier.hpp"
+#include "distortos/DynamicThread.hpp"
+#include "distortos/ThisThread.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// single duration used in tests
+constexpr auto singleDuration = TickClock::duration{1};
+
+/// size of stack for test thread, bytes
+constexpr size_t testThreadStackSize {512};
+
+/// number of test threads in phase 2
+constexpr size_t totalThreads {3};
+
+/// number of phases of barrier completed in phase 2
+constexpr unsigned int totalRounds {4};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Test thread
+ *
+ * Arrives at the barrier and waits for completion of the phase \a totalRounds times, marking a sequence point after
+ * each completed phase.
+ *
+ * \param [in] barrier is a reference to shared barrier
+ * \param [in] sequenceAsserter is a reference to SequenceAsserter shared object
+ * \param [in] index is the index of thread, used to calculate its sequence points
+ * \param [out] result is a reference to variable into which the result of all waits will be written
+ */
+
+void thread(Barrier& barrier, SequenceAsserter& sequenceAsserter, const unsigned int index, bool& result)
+{
+	result = true;
+	for (unsigned int round {}; round < totalRounds; ++round)
+	{
+		if (barrier.arriveAndWait() != 0 || barrier.getPhase() != round + 1)
+			result = false;
+		sequenceAsserter.sequencePoint(round * (totalThreads + 1) + 1 + index);
+	}
+}
+
+/**
+ * \brief Phase 1 of test case.
+ *
+ * Tests non-blocking arrivals, dropping of participants and waiting for completed and not completed phases.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase1()
+{
+	{
+		Barrier barrier {2};
+
+		const auto ret1 = barrier.arrive();
+		if (ret1.first != 0 || ret1.second != 0 || barrier.getCount() != 1 || barrier.getPhase() != 0)
+			return false;
+		if (barrier.tryWaitFor(singleDuration, ret1.second) != ETIMEDOUT)
+			return false;
+
+		const auto ret2 = barrier.arrive();
+		if (ret2.first != 0 || ret2.second != 0 || barrier.getCount() != 2 || barrier.getPhase() != 1)
+			return false;
+		if (barrier.wait(ret2.second) != 0 || barrier.tryWaitFor(singleDuration, ret2.second) != 0)
+			return false;
+
+		if (barrier.arriveAndDrop() != 0 || barrier.getExpectedCount() != 1 || barrier.getCount() != 1 ||
+				barrier.getPhase() != 1)
+			return false;
+		if (barrier.arriveAndWait() != 0 || barrier.getCount() != 1 || barrier.getPhase() != 2)
+			return false;
+
+		if (barrier.arriveAndDrop() != 0 || barrier.getExpectedCount() != 0 || barrier.getPhase() != 3)
+			return false;
+		if (barrier.arrive().first != EINVAL || barrier.arriveAndDrop() != EINVAL || barrier.arriveAndWait() != EINVAL)
+			return false;
+	}
+	{
+		Barrier barrier {0};
+		if (barrier.arrive().first != EINVAL)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * \brief Phase 2 of test case.
+ *
+ * Several threads with priority higher than main thread and main thread itself use the barrier for several phases.
+ * Main thread arrives as the last one, so each phase is completed by main thread and all test threads must be unblocked
+ * before main thread continues.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase2()
+{
+	const auto priority = static_cast<uint8_t>(ThisThread::getPriority() + 1);
+	Barrier barrier {totalThreads + 1};
+	SequenceAsserter sequenceAsserter;
+	bool results[totalThreads] {};
+
+	auto thread0 = makeAndStartDynamicThread({testThreadStackSize, priority}, thread, std::ref(barrier),
+			std::ref(sequenceAsserter), 0, std::ref(results[0]));
+	auto thread1 = makeAndStartDynamicThread({testThreadStackSize, priority}, thread, std::ref(barrier),
+			std::ref(sequenceAsserter), 1, std::ref(results[1]));
+	auto thread2 = makeAndStartDynamicThread({testThreadStackSize, priority}, thread, std::ref(barrier),
+			std::ref(sequenceAsserter), 2, std::ref(results[2]));
+
+	bool result {true};
+	for (unsigned int round {}; round < totalRounds; ++round)
+	{
+		sequenceAsserter.sequencePoint(round * (totalThreads + 1));
+		if (barrier.getCount() != 1 || barrier.arriveAndWait() != 0)
+			result = false;
+	}
+	sequenceAsserter.sequencePoint(totalRounds * (totalThreads + 1));
+
+	thread0.join();
+	thread1.join();
+	thread2.join();
+
+	return result == true && results[0] == true && results[1] == true && results[2] == true &&
+			barrier.getPhase() == totalRounds &&
+			sequenceAsserter.assertSequence(totalRounds * (totalThreads + 1) + 1) == true;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool BarrierOperationsTestCase::run_() const
+{
+	for (const auto& function : {phase1, phase2})
+	{
+		const auto ret = function();
+		if (ret != true)
+			return ret;
+	}
+
+	return true;
+}
+
+}	// namespace test
+
+}	// namespace distortos
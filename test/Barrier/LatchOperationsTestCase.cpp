@@ -0,0 +1,147 @@
+/**
+ * \file
+ * \brief LatchOperationsTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "LatchOperationsTestCase.hpp"
+
+#include "SequenceAsserter.hpp"
+
+#include "distortos/DynamicThread.hpp"
+#include "distortos/Latch.hpp"
+#include "distortos/ThisThread.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// single duration used in tests
+constexpr auto singleDuration = TickClock::duration{1};
+
+/// size of stack for test thread, bytes
+constexpr size_t testThreadStackSize {512};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Test thread
+ *
+ * Waits for the latch and marks a sequence point.
+ *
+ * \param [in] latch is a reference to shared latch
+ * \param [in] sequenceAsserter is a reference to SequenceAsserter shared object
+ * \param [in] sequencePoint is the sequence point marked after the wait
+ * \param [out] ret is a reference to variable into which the value returned by wait() will be written
+ */
+
+void thread(Latch& latch, SequenceAsserter& sequenceAsserter, const unsigned int sequencePoint, int& ret)
+{
+	ret = latch.wait();
+	sequenceAsserter.sequencePoint(sequencePoint);
+}
+
+/**
+ * \brief Phase 1 of test case.
+ *
+ * Tests validation of arguments, non-blocking operations and timeouts.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase1()
+{
+	Latch latch {3};
+
+	if (latch.tryWait() != EAGAIN || latch.countDown(0) != EINVAL || latch.countDown(4) != EINVAL ||
+			latch.getCount() != 3)
+		return false;
+	if (latch.countDown(2) != 0 || latch.getCount() != 1 || latch.tryWaitFor(singleDuration) != ETIMEDOUT)
+		return false;
+	if (latch.arriveAndWait() != 0 || latch.getCount() != 0)
+		return false;
+	if (latch.tryWait() != 0 || latch.wait() != 0 || latch.tryWaitFor(singleDuration) != 0)
+		return false;
+	if (latch.countDown() != EINVAL || latch.arriveAndWait() != EINVAL)
+		return false;
+
+	return true;
+}
+
+/**
+ * \brief Phase 2 of test case.
+ *
+ * Several threads with priority higher than main thread wait for the latch. Single countDown() in main thread must
+ * unblock all of them before main thread continues.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase2()
+{
+	const auto priority = static_cast<uint8_t>(ThisThread::getPriority() + 1);
+	Latch latch {2};
+	SequenceAsserter sequenceAsserter;
+	int rets[3] {-1, -1, -1};
+
+	auto thread0 = makeAndStartDynamicThread({testThreadStackSize, priority}, thread, std::ref(latch),
+			std::ref(sequenceAsserter), 1, std::ref(rets[0]));
+	auto thread1 = makeAndStartDynamicThread({testThreadStackSize, priority}, thread, std::ref(latch),
+			std::ref(sequenceAsserter), 2, std::ref(rets[1]));
+	auto thread2 = makeAndStartDynamicThread({testThreadStackSize, priority}, thread, std::ref(latch),
+			std::ref(sequenceAsserter), 3, std::ref(rets[2]));
+
+	const auto blocked = thread0.getState() == ThreadState::blockedOnBarrier &&
+			thread1.getState() == ThreadState::blockedOnBarrier && thread2.getState() == ThreadState::blockedOnBarrier;
+
+	sequenceAsserter.sequencePoint(0);
+	const auto ret = latch.countDown(2);
+	sequenceAsserter.sequencePoint(4);
+
+	thread0.join();
+	thread1.join();
+	thread2.join();
+
+	return blocked == true && ret == 0 && rets[0] == 0 && rets[1] == 0 && rets[2] == 0 &&
+			sequenceAsserter.assertSequence(5) == true;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool LatchOperationsTestCase::run_() const
+{
+	for (const auto& function : {phase1, phase2})
+	{
+		const auto ret = function();
+		if (ret != true)
+			return ret;
+	}
+
+	return true;
+}
+
+}	// namespace test
+
+}	// namespace distortos
@@ -0,0 +1,47 @@
+/**
+ * \file
+ * \brief LatchOperationsTestCase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEST_BARRIER_LATCHOPERATIONSTESTCASE_HPP_
+#define TEST_BARRIER_LATCHOPERATIONSTESTCASE_HPP_
+
+#include "TestCaseCommon.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+/**
+ * \brief Tests various operations of latch.
+ *
+ * Tests validation of arguments, non-blocking operations, timeouts and whether decrementing the counter to zero
+ * unblocks all waiting threads at once.
+ */
+
+class LatchOperationsTestCase : public TestCaseCommon
+{
+private:
+
+	/**
+	 * \brief Runs the test case.
+	 *
+	 * \return true if the test case succeeded, false otherwise
+	 */
+
+	bool run_() const override;
+};
+
+}	// namespace test
+
+}	// namespace distortos
+
+#endif	// TEST_BARRIER_LATCHOPERATIONSTESTCASE_HPP_
@@ -0,0 +1,55 @@
+/**
+ * \file
+ * \brief barrierTestCases object definition
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "barrierTestCases.hpp"
+
+#include "BarrierOperationsTestCase.hpp"
+#include "LatchOperationsTestCase.hpp"
+
+#include "TestCaseGroup.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// BarrierOperationsTestCase instance
+const BarrierOperationsTestCase barrierOperationsTestCase;
+
+/// LatchOperationsTestCase instance
+const LatchOperationsTestCase latchOperationsTestCase;
+
+/// array with references to TestCase objects related to Barrier and Latch
+const TestCaseGroup::Range::value_type barrierTestCases_[]
+{
+		TestCaseGroup::Range::value_type{barrierOperationsTestCase},
+		TestCaseGroup::Range::value_type{latchOperationsTestCase},
+};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+const TestCaseGroup barrierTestCases {TestCaseGroup::Range{barrierTestCases_}};
+
+}	// namespace test
+
+}	// namespace distortos
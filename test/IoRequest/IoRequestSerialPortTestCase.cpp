@@ -0,0 +1,661 @@
+/**
+ * \file
+ * \brief IoRequestSerialPortTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "IoRequestSerialPortTestCase.hpp"
+
+#include "executeInInterrupt.hpp"
+
+#include "distortos/devices/communication/SerialPort.hpp"
+#include "distortos/devices/communication/UartBase.hpp"
+#include "distortos/devices/communication/UartLowLevel.hpp"
+
+#include "distortos/devices/io/IoCompletionQueue.hpp"
+#include "distortos/devices/io/IoRequest.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * SoftwareUartLowLevel class is a low-level UART driver without hardware.
+ *
+ * Reception and transmission of data is done by the test with receive() and transmit(), which should be called from
+ * interrupt context. Data received when no read operation is in progress is lost. Transmitted data is collected in
+ * internal buffer.
+ */
+
+class SoftwareUartLowLevel : public devices::UartLowLevel
+{
+public:
+
+	/**
+	 * \brief SoftwareUartLowLevel's constructor
+	 */
+
+	constexpr SoftwareUartLowLevel() :
+			transmitted_{},
+			uartBase_{},
+			readBuffer_{},
+			readPosition_{},
+			readSize_{},
+			transmittedSize_{},
+			writeBuffer_{},
+			writePosition_{},
+			writeSize_{},
+			transmitInProgress_{}
+	{
+
+	}
+
+	/**
+	 * \brief Clears collected transmitted data.
+	 */
+
+	void clearTransmitted()
+	{
+		transmittedSize_ = {};
+	}
+
+	/**
+	 * \return pointer to collected transmitted data
+	 */
+
+	const uint8_t* getTransmitted() const
+	{
+		return transmitted_;
+	}
+
+	/**
+	 * \return size of collected transmitted data, bytes
+	 */
+
+	size_t getTransmittedSize() const
+	{
+		return transmittedSize_;
+	}
+
+	/**
+	 * \brief Receives data.
+	 *
+	 * \param [in] data is a pointer to received data
+	 * \param [in] size is the size of \a data, bytes
+	 */
+
+	void receive(const void* const data, size_t size)
+	{
+		auto dataUint8 = static_cast<const uint8_t*>(data);
+		while (size != 0 && readBuffer_ != nullptr)
+		{
+			readBuffer_[readPosition_++] = *dataUint8++;
+			--size;
+
+			if (readPosition_ == readSize_)
+			{
+				const auto bytesRead = readPosition_;
+				readBuffer_ = {};
+				readPosition_ = {};
+				readSize_ = {};
+				uartBase_->readCompleteEvent(bytesRead);
+			}
+		}
+	}
+
+	/**
+	 * \brief Transmits data.
+	 *
+	 * When there is no write operation in progress after transmission of data, transmission is physically finished.
+	 *
+	 * \param [in] size is the maximum amount of data that will be transmitted, bytes
+	 */
+
+	void transmit(size_t size)
+	{
+		while (size != 0 && writeBuffer_ != nullptr)
+		{
+			if (transmittedSize_ < sizeof(transmitted_))
+				transmitted_[transmittedSize_++] = writeBuffer_[writePosition_];
+			++writePosition_;
+			--size;
+
+			if (writePosition_ == writeSize_)
+			{
+				const auto bytesWritten = writePosition_;
+				writeBuffer_ = {};
+				writePosition_ = {};
+				writeSize_ = {};
+				uartBase_->writeCompleteEvent(bytesWritten);
+			}
+		}
+
+		if (writeBuffer_ == nullptr && transmitInProgress_ == true)
+		{
+			transmitInProgress_ = false;
+			uartBase_->transmitCompleteEvent();
+		}
+	}
+
+	/**
+	 * \brief Mute mode is not supported, so this function does nothing.
+	 *
+	 * \return 0 on success
+	 */
+
+	int setMuteMode(devices::UartWakeup, uint8_t) override
+	{
+		return 0;
+	}
+
+	/**
+	 * \brief Starts low-level UART driver.
+	 *
+	 * \param [in] uartBase is a reference to UartBase object that will be associated with this one
+	 * \param [in] baudRate is the desired baud rate, bps
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and real baud rate; error codes:
+	 * - EBADF - the driver is not stopped;
+	 */
+
+	std::pair<int, uint32_t> start(devices::UartBase& uartBase, const uint32_t baudRate, uint8_t, devices::UartParity,
+			bool) override
+	{
+		if (uartBase_ != nullptr)
+			return {EBADF, {}};
+
+		uartBase_ = &uartBase;
+		return {{}, baudRate};
+	}
+
+	/**
+	 * \brief Starts asynchronous read operation.
+	 *
+	 * \param [out] buffer is the buffer to which the data will be written
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not started;
+	 * - EBUSY - read is in progress;
+	 * - EINVAL - \a buffer and/or \a size are invalid;
+	 */
+
+	int startRead(void* const buffer, const size_t size) override
+	{
+		if (uartBase_ == nullptr)
+			return EBADF;
+
+		if (readBuffer_ != nullptr)
+			return EBUSY;
+
+		if (buffer == nullptr || size == 0)
+			return EINVAL;
+
+		readBuffer_ = static_cast<uint8_t*>(buffer);
+		readSize_ = size;
+		return 0;
+	}
+
+	/**
+	 * \brief Starts asynchronous write operation.
+	 *
+	 * \param [in] buffer is the buffer with data that will be transmitted
+	 * \param [in] size is the size of \a buffer, bytes
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not started;
+	 * - EBUSY - write is in progress;
+	 * - EINVAL - \a buffer and/or \a size are invalid;
+	 */
+
+	int startWrite(const void* const buffer, const size_t size) override
+	{
+		if (uartBase_ == nullptr)
+			return EBADF;
+
+		if (writeBuffer_ != nullptr)
+			return EBUSY;
+
+		if (buffer == nullptr || size == 0)
+			return EINVAL;
+
+		writeBuffer_ = static_cast<const uint8_t*>(buffer);
+		writeSize_ = size;
+
+		if (transmitInProgress_ == false)
+		{
+			transmitInProgress_ = true;
+			uartBase_->transmitStartEvent();
+		}
+
+		return 0;
+	}
+
+	/**
+	 * \brief Stops low-level UART driver.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not started;
+	 * - EBUSY - read and/or write are in progress;
+	 */
+
+	int stop() override
+	{
+		if (uartBase_ == nullptr)
+			return EBADF;
+
+		if (readBuffer_ != nullptr || writeBuffer_ != nullptr)
+			return EBUSY;
+
+		uartBase_ = {};
+		return 0;
+	}
+
+	/**
+	 * \brief Stops asynchronous read operation.
+	 *
+	 * \return number of bytes already read
+	 */
+
+	size_t stopRead() override
+	{
+		const auto bytesRead = readPosition_;
+		readBuffer_ = {};
+		readPosition_ = {};
+		readSize_ = {};
+		return bytesRead;
+	}
+
+	/**
+	 * \brief Stops asynchronous write operation.
+	 *
+	 * \return number of bytes already written
+	 */
+
+	size_t stopWrite() override
+	{
+		const auto bytesWritten = writePosition_;
+		writeBuffer_ = {};
+		writePosition_ = {};
+		writeSize_ = {};
+		return bytesWritten;
+	}
+
+private:
+
+	/// buffer with collected transmitted data
+	uint8_t transmitted_[16];
+
+	/// pointer to UartBase object associated with this one, nullptr if the driver is not started
+	devices::UartBase* uartBase_;
+
+	/// buffer to which the data is written by current read operation, nullptr if no read operation is in progress
+	uint8_t* readBuffer_;
+
+	/// number of bytes already read by current read operation
+	size_t readPosition_;
+
+	/// size of \a readBuffer_, bytes
+	size_t readSize_;
+
+	/// size of collected transmitted data, bytes
+	size_t transmittedSize_;
+
+	/// buffer from which the data is read by current write operation, nullptr if no write operation is in progress
+	const uint8_t* writeBuffer_;
+
+	/// number of bytes already written by current write operation
+	size_t writePosition_;
+
+	/// size of \a writeBuffer_, bytes
+	size_t writeSize_;
+
+	/// true if transmission is physically in progress, false otherwise
+	bool transmitInProgress_;
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// baud rate used in tests, bps
+constexpr uint32_t baudRate {115200};
+
+/// data used in tests
+constexpr uint8_t testData[16] {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Phase 1 of test case.
+ *
+ * Tests completion of read request via IoCompletionQueue when its minimum size is received in two chunks from interrupt
+ * context. While the request is pending, blocking read() and start of other read request must fail with EBUSY. Data
+ * received after completion of request must be available for blocking read().
+ *
+ * \param [in] uart is a reference to low-level UART driver used by \a serialPort
+ * \param [in] serialPort is a reference to opened serial port
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase1(SoftwareUartLowLevel& uart, devices::SerialPort& serialPort)
+{
+	devices::IoCompletionQueue completionQueue;
+	devices::IoRequest request {completionQueue};
+	devices::IoRequest otherRequest {completionQueue};
+	uint8_t buffer[8] {};
+	uint8_t otherBuffer[sizeof(buffer)] {};
+	devices::IoRequest* poppedRequest {};
+
+	const auto startRet = serialPort.startRead(request, buffer, sizeof(buffer), sizeof(buffer));
+	const auto pending = request.isPending();
+	const auto readRet = serialPort.read(otherBuffer, sizeof(otherBuffer));
+	const auto otherStartRet = serialPort.startRead(otherRequest, otherBuffer, sizeof(otherBuffer));
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.receive(testData, 5);
+			});
+
+	const auto partialPending = request.isPending();
+	const auto partialPopRet = completionQueue.tryPop(poppedRequest);
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.receive(testData + 5, 5);
+			});
+
+	// request which was not popped yet cannot be started again
+	const auto notPoppedStartRet = serialPort.startRead(request, otherBuffer, sizeof(otherBuffer));
+	const auto popRet = completionQueue.tryPop(poppedRequest);
+	const auto result = request.getResult();
+	const auto remainingReadRet = serialPort.read(otherBuffer, sizeof(otherBuffer));
+	const auto closeRet = serialPort.close();
+
+	return startRet == 0 && pending == true && readRet == decltype(readRet){EBUSY, {}} && otherStartRet == EBUSY &&
+			partialPending == true && partialPopRet == EAGAIN && notPoppedStartRet == EBUSY && popRet == 0 &&
+			poppedRequest == &request && result == decltype(result){{}, sizeof(buffer)} &&
+			memcmp(buffer, testData, sizeof(buffer)) == 0 && remainingReadRet == decltype(remainingReadRet){{}, 2} &&
+			memcmp(otherBuffer, testData + sizeof(buffer), 2) == 0 && closeRet == 0;
+}
+
+/**
+ * \brief Phase 2 of test case.
+ *
+ * Tests cancellation of read request before any data is received and after part of data is received. Cancelled request
+ * must be completed with ECANCELED and with the amount of data received until cancellation. Second cancellation must
+ * fail with EINVAL. After cancellation blocking read() must work again.
+ *
+ * \param [in] uart is a reference to low-level UART driver used by \a serialPort
+ * \param [in] serialPort is a reference to opened serial port
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase2(SoftwareUartLowLevel& uart, devices::SerialPort& serialPort)
+{
+	devices::IoCompletionQueue completionQueue;
+	devices::IoRequest request {completionQueue};
+	uint8_t buffer[8] {};
+	devices::IoRequest* poppedRequest {};
+
+	const auto startRet1 = serialPort.startRead(request, buffer, sizeof(buffer), sizeof(buffer));
+	const auto cancelRet1 = serialPort.cancel(request);
+	const auto popRet1 = completionQueue.tryPop(poppedRequest);
+	const auto result1 = request.getResult();
+
+	poppedRequest = {};
+	const auto startRet2 = serialPort.startRead(request, buffer, sizeof(buffer), sizeof(buffer));
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.receive(testData, 3);
+			});
+
+	const auto cancelRet2 = serialPort.cancel(request);
+	const auto popRet2 = completionQueue.tryPop(poppedRequest);
+	const auto result2 = request.getResult();
+	const auto secondCancelRet = serialPort.cancel(request);
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.receive(testData + 3, 2);
+			});
+
+	uint8_t otherBuffer[sizeof(buffer)] {};
+	const auto readRet = serialPort.read(otherBuffer, sizeof(otherBuffer));
+	const auto closeRet = serialPort.close();
+
+	return startRet1 == 0 && cancelRet1 == 0 && popRet1 == 0 && result1 == decltype(result1){ECANCELED, {}} &&
+			startRet2 == 0 && cancelRet2 == 0 && popRet2 == 0 && poppedRequest == &request &&
+			result2 == decltype(result2){ECANCELED, 3} && memcmp(buffer, testData, 3) == 0 &&
+			secondCancelRet == EINVAL && readRet == decltype(readRet){{}, 2} &&
+			memcmp(otherBuffer, testData + 3, 2) == 0 && closeRet == 0;
+}
+
+/**
+ * \brief Phase 3 of test case.
+ *
+ * Tests cancellation of write request after part of data is transmitted and completion of the following write request
+ * which transmits the rest of data. Cancelled request must be completed with ECANCELED and with the amount of data
+ * transmitted until cancellation. While the request is pending, blocking write() and start of other write request must
+ * fail with EBUSY.
+ *
+ * \param [in] uart is a reference to low-level UART driver used by \a serialPort
+ * \param [in] serialPort is a reference to opened serial port
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase3(SoftwareUartLowLevel& uart, devices::SerialPort& serialPort)
+{
+	devices::IoCompletionQueue completionQueue;
+	devices::IoRequest request {completionQueue};
+	devices::IoRequest otherRequest {completionQueue};
+	devices::IoRequest* poppedRequest {};
+
+	uart.clearTransmitted();
+
+	const auto startRet1 = serialPort.startWrite(request, testData, 8);
+	const auto pending = request.isPending();
+	const auto writeRet = serialPort.write(testData, 1);
+	const auto otherStartRet = serialPort.startWrite(otherRequest, testData, 1);
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.transmit(3);
+			});
+
+	const auto partialPopRet = completionQueue.tryPop(poppedRequest);
+	const auto cancelRet = serialPort.cancel(request);
+	const auto popRet1 = completionQueue.tryPop(poppedRequest);
+	const auto result1 = request.getResult();
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.transmit(SIZE_MAX);
+			});
+
+	const auto cancelledTransmittedSize = uart.getTransmittedSize();
+
+	poppedRequest = {};
+	const auto startRet2 = serialPort.startWrite(request, testData + 3, 5);
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.transmit(SIZE_MAX);
+			});
+
+	const auto popRet2 = completionQueue.tryPop(poppedRequest);
+	const auto result2 = request.getResult();
+	const auto closeRet = serialPort.close();
+
+	return startRet1 == 0 && pending == true && writeRet == decltype(writeRet){EBUSY, {}} && otherStartRet == EBUSY &&
+			partialPopRet == EAGAIN && cancelRet == 0 && popRet1 == 0 && result1 == decltype(result1){ECANCELED, 3} &&
+			cancelledTransmittedSize == 3 && startRet2 == 0 && popRet2 == 0 && poppedRequest == &request &&
+			result2 == decltype(result2){{}, 5} && uart.getTransmittedSize() == 8 &&
+			memcmp(uart.getTransmitted(), testData, 8) == 0 && closeRet == 0;
+}
+
+/**
+ * \brief Phase 4 of test case.
+ *
+ * Tests whether requests are popped from IoCompletionQueue in the order of their completion - read and write requests
+ * are pending at the same time and are completed from interrupt context in both possible orders.
+ *
+ * \param [in] uart is a reference to low-level UART driver used by \a serialPort
+ * \param [in] serialPort is a reference to opened serial port
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase4(SoftwareUartLowLevel& uart, devices::SerialPort& serialPort)
+{
+	devices::IoCompletionQueue completionQueue;
+	devices::IoRequest readRequest {completionQueue};
+	devices::IoRequest writeRequest {completionQueue};
+	uint8_t buffer[4] {};
+	devices::IoRequest* firstRequest {};
+	devices::IoRequest* secondRequest {};
+
+	uart.clearTransmitted();
+
+	const auto readStartRet1 = serialPort.startRead(readRequest, buffer, sizeof(buffer), sizeof(buffer));
+	const auto writeStartRet1 = serialPort.startWrite(writeRequest, testData, 4);
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.transmit(SIZE_MAX);
+				uart.receive(testData + 4, 4);
+			});
+
+	const auto firstPopRet1 = completionQueue.tryPop(firstRequest);
+	const auto secondPopRet1 = completionQueue.tryPop(secondRequest);
+	const auto writeFirst = firstRequest == &writeRequest && secondRequest == &readRequest;
+	const auto readResult1 = readRequest.getResult();
+	const auto writeResult1 = writeRequest.getResult();
+	const auto readData1 = memcmp(buffer, testData + 4, sizeof(buffer)) == 0;
+
+	const auto readStartRet2 = serialPort.startRead(readRequest, buffer, sizeof(buffer), sizeof(buffer));
+	const auto writeStartRet2 = serialPort.startWrite(writeRequest, testData + 8, 4);
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.receive(testData + 12, 4);
+				uart.transmit(SIZE_MAX);
+			});
+
+	const auto firstPopRet2 = completionQueue.tryPop(firstRequest);
+	const auto secondPopRet2 = completionQueue.tryPop(secondRequest);
+	const auto readFirst = firstRequest == &readRequest && secondRequest == &writeRequest;
+	const auto readResult2 = readRequest.getResult();
+	const auto writeResult2 = writeRequest.getResult();
+	const auto readData2 = memcmp(buffer, testData + 12, sizeof(buffer)) == 0;
+	const auto closeRet = serialPort.close();
+
+	return readStartRet1 == 0 && writeStartRet1 == 0 && firstPopRet1 == 0 && secondPopRet1 == 0 &&
+			writeFirst == true && readResult1 == decltype(readResult1){{}, 4} &&
+			writeResult1 == decltype(writeResult1){{}, 4} && readData1 == true && readStartRet2 == 0 &&
+			writeStartRet2 == 0 && firstPopRet2 == 0 && secondPopRet2 == 0 && readFirst == true &&
+			readResult2 == decltype(readResult2){{}, 4} && writeResult2 == decltype(writeResult2){{}, 4} &&
+			readData2 == true && uart.getTransmittedSize() == 8 && memcmp(uart.getTransmitted(), testData, 4) == 0 &&
+			memcmp(uart.getTransmitted() + 4, testData + 8, 4) == 0 && closeRet == 0;
+}
+
+/**
+ * \brief Phase 5 of test case.
+ *
+ * Tests whether last close() cancels pending read request, which must be completed with ECANCELED and with the amount
+ * of data received until that moment.
+ *
+ * \param [in] uart is a reference to low-level UART driver used by \a serialPort
+ * \param [in] serialPort is a reference to opened serial port
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase5(SoftwareUartLowLevel& uart, devices::SerialPort& serialPort)
+{
+	devices::IoCompletionQueue completionQueue;
+	devices::IoRequest request {completionQueue};
+	uint8_t buffer[8] {};
+	devices::IoRequest* poppedRequest {};
+
+	const auto startRet = serialPort.startRead(request, buffer, sizeof(buffer), sizeof(buffer));
+
+	executeInInterrupt(
+			[&uart]()
+			{
+				uart.receive(testData, 1);
+			});
+
+	const auto closeRet = serialPort.close();
+	const auto popRet = completionQueue.tryPop(poppedRequest);
+	const auto result = request.getResult();
+
+	return startRet == 0 && closeRet == 0 && popRet == 0 && poppedRequest == &request &&
+			result == decltype(result){ECANCELED, 1} && buffer[0] == testData[0];
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool IoRequestSerialPortTestCase::run_() const
+{
+	SoftwareUartLowLevel uart;
+	uint8_t readBuffer[16];
+	uint8_t writeBuffer[16];
+	devices::SerialPort serialPort {uart, readBuffer, sizeof(readBuffer), writeBuffer, sizeof(writeBuffer)};
+
+	for (const auto& function : {phase1, phase2, phase3, phase4, phase5})
+	{
+		{
+			const auto ret = serialPort.open(baudRate, 8, devices::UartParity::none, false);
+			if (ret != 0)
+				return false;
+		}
+
+		// each phase closes the serial port
+		const auto ret = function(uart, serialPort);
+		if (ret != true)
+			return ret;
+	}
+
+	return true;
+}
+
+}	// namespace test
+
+}	// namespace distortos
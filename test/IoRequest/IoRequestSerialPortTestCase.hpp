@@ -0,0 +1,49 @@
+/**
+ * \file
+ * \brief IoRequestSerialPortTestCase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEST_IOREQUEST_IOREQUESTSERIALPORTTESTCASE_HPP_
+#define TEST_IOREQUEST_IOREQUESTSERIALPORTTESTCASE_HPP_
+
+#include "TestCaseCommon.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+/**
+ * \brief Tests asynchronous read and write requests of SerialPort.
+ *
+ * SerialPort uses software low-level UART driver, whose reception and transmission are driven from interrupt context by
+ * the test. Tests completion of requests via IoCompletionQueue (also the order of completions), cancellation of
+ * requests before and during the transfer (with partial transferred size), cancellation by close() and whether blocking
+ * read() and write() are rejected with EBUSY while asynchronous request is pending.
+ */
+
+class IoRequestSerialPortTestCase : public TestCaseCommon
+{
+private:
+
+	/**
+	 * \brief Runs the test case.
+	 *
+	 * \return true if the test case succeeded, false otherwise
+	 */
+
+	bool run_() const override;
+};
+
+}	// namespace test
+
+}	// namespace distortos
+
+#endif	// TEST_IOREQUEST_IOREQUESTSERIALPORTTESTCASE_HPP_
@@ -0,0 +1,505 @@
+/**
+ * \file
+ * \brief IoRequestSpiMasterProxyTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "IoRequestSpiMasterProxyTestCase.hpp"
+
+#include "executeInInterrupt.hpp"
+
+#include "distortos/devices/communication/SpiDevice.hpp"
+#include "distortos/devices/communication/SpiDeviceProxy.hpp"
+#include "distortos/devices/communication/SpiMaster.hpp"
+#include "distortos/devices/communication/SpiMasterBase.hpp"
+#include "distortos/devices/communication/SpiMasterErrorSet.hpp"
+#include "distortos/devices/communication/SpiMasterLowLevel.hpp"
+#include "distortos/devices/communication/SpiMasterOperation.hpp"
+#include "distortos/devices/communication/SpiMasterProxy.hpp"
+
+#include "distortos/devices/io/IoCompletionQueue.hpp"
+#include "distortos/devices/io/IoRequest.hpp"
+#include "distortos/devices/io/OutputPin.hpp"
+
+#include "distortos/InterruptMaskingLock.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * SoftwareSpiMasterLowLevel class is a low-level SPI master driver without hardware.
+ *
+ * Transfers are finished by the test with finishTransfer(), which should be called from interrupt context. Transferred
+ * data is looped back - data that is written is also read.
+ */
+
+class SoftwareSpiMasterLowLevel : public devices::SpiMasterLowLevel
+{
+public:
+
+	/**
+	 * \brief SoftwareSpiMasterLowLevel's constructor
+	 */
+
+	constexpr SoftwareSpiMasterLowLevel() :
+			spiMasterBase_{},
+			readBuffer_{},
+			writeBuffer_{},
+			size_{},
+			started_{}
+	{
+
+	}
+
+	/**
+	 * \brief Finishes current transfer.
+	 *
+	 * \param [in] errorSet is the set of error bits reported for the transfer, default - no errors
+	 */
+
+	void finishTransfer(const devices::SpiMasterErrorSet errorSet = {})
+	{
+		const auto spiMasterBase = spiMasterBase_;
+		if (spiMasterBase == nullptr)
+			return;
+
+		const auto size = size_;
+		if (readBuffer_ != nullptr)
+		{
+			if (writeBuffer_ != nullptr)
+				memcpy(readBuffer_, writeBuffer_, size);
+			else
+				memset(readBuffer_, dummyData, size);
+		}
+
+		spiMasterBase_ = {};
+		readBuffer_ = {};
+		writeBuffer_ = {};
+		size_ = {};
+		spiMasterBase->transferCompleteEvent(errorSet, errorSet.any() == false ? size : 0);
+	}
+
+	/**
+	 * \return true if transfer is in progress, false otherwise
+	 */
+
+	bool isTransferInProgress() const
+	{
+		return spiMasterBase_ != nullptr;
+	}
+
+	/**
+	 * \brief Configures parameters of low-level SPI master driver.
+	 *
+	 * \param [in] clockFrequency is the desired clock frequency, Hz
+	 *
+	 * \return pair with return code (0 on success, error code otherwise) and real clock frequency; error codes:
+	 * - EBADF - the driver is not started;
+	 * - EBUSY - transfer is in progress;
+	 */
+
+	std::pair<int, uint32_t> configure(devices::SpiMode, const uint32_t clockFrequency, uint8_t, bool, uint32_t)
+			override
+	{
+		if (started_ == false)
+			return {EBADF, {}};
+
+		if (spiMasterBase_ != nullptr)
+			return {EBUSY, {}};
+
+		return {{}, clockFrequency};
+	}
+
+	/**
+	 * \brief Starts low-level SPI master driver.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not stopped;
+	 */
+
+	int start() override
+	{
+		if (started_ == true)
+			return EBADF;
+
+		started_ = true;
+		return 0;
+	}
+
+	/**
+	 * \brief Starts asynchronous transfer.
+	 *
+	 * \param [in] spiMasterBase is a reference to SpiMasterBase object that will be notified about completed transfer
+	 * \param [in] writeBuffer is the buffer with data that will be written, nullptr to send dummy data
+	 * \param [out] readBuffer is the buffer with data that will be read, nullptr to ignore received data
+	 * \param [in] size is the size of transfer, bytes
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not started;
+	 * - EBUSY - transfer is in progress;
+	 * - EINVAL - \a size is invalid;
+	 */
+
+	int startTransfer(devices::SpiMasterBase& spiMasterBase, const void* const writeBuffer, void* const readBuffer,
+			const size_t size) override
+	{
+		if (started_ == false)
+			return EBADF;
+
+		if (spiMasterBase_ != nullptr)
+			return EBUSY;
+
+		if (size == 0)
+			return EINVAL;
+
+		// transfer may be finished from interrupt context as soon as spiMasterBase_ is set
+		const InterruptMaskingLock interruptMaskingLock;
+
+		readBuffer_ = static_cast<uint8_t*>(readBuffer);
+		writeBuffer_ = static_cast<const uint8_t*>(writeBuffer);
+		size_ = size;
+		spiMasterBase_ = &spiMasterBase;
+		return 0;
+	}
+
+	/**
+	 * \brief Stops low-level SPI master driver.
+	 *
+	 * \return 0 on success, error code otherwise:
+	 * - EBADF - the driver is not started;
+	 * - EBUSY - transfer is in progress;
+	 */
+
+	int stop() override
+	{
+		if (started_ == false)
+			return EBADF;
+
+		if (spiMasterBase_ != nullptr)
+			return EBUSY;
+
+		started_ = false;
+		return 0;
+	}
+
+	/// dummy data read when write buffer of transfer is nullptr
+	constexpr static uint8_t dummyData {0xff};
+
+private:
+
+	/// pointer to SpiMasterBase object of current transfer, nullptr if no transfer is in progress
+	devices::SpiMasterBase* volatile spiMasterBase_;
+
+	/// buffer to which the data is read by current transfer, nullptr to ignore received data
+	uint8_t* readBuffer_;
+
+	/// buffer from which the data is written by current transfer, nullptr to send dummy data
+	const uint8_t* writeBuffer_;
+
+	/// size of current transfer, bytes
+	size_t size_;
+
+	/// true if the driver is started, false otherwise
+	bool started_;
+};
+
+/// SoftwareOutputPin class is an output pin without hardware
+class SoftwareOutputPin : public devices::OutputPin
+{
+public:
+
+	/**
+	 * \brief SoftwareOutputPin's constructor
+	 */
+
+	constexpr SoftwareOutputPin() :
+			state_{}
+	{
+
+	}
+
+	/**
+	 * \return current state of pin
+	 */
+
+	bool get() const override
+	{
+		return state_;
+	}
+
+	/**
+	 * \brief Sets state of pin.
+	 *
+	 * \param [in] state is the new state of pin
+	 */
+
+	void set(const bool state) override
+	{
+		state_ = state;
+	}
+
+private:
+
+	/// current state of pin
+	bool state_;
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// single duration used in tests
+constexpr auto singleDuration = TickClock::duration{1};
+
+/// data used in tests
+constexpr uint8_t testData[6] {0x12, 0x34, 0x56, 0x78, 0x9a, 0xbc};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Finishes current transfer of low-level SPI master driver from interrupt context.
+ *
+ * \param [in] spiMaster is a reference to low-level SPI master driver
+ * \param [in] errorSet is the set of error bits reported for the transfer, default - no errors
+ */
+
+void finishTransfer(SoftwareSpiMasterLowLevel& spiMaster, const devices::SpiMasterErrorSet errorSet = {})
+{
+	executeInInterrupt(
+			[&spiMaster, errorSet]()
+			{
+				spiMaster.finishTransfer(errorSet);
+			});
+}
+
+/**
+ * \brief Phase 1 of test case.
+ *
+ * Tests completion of transaction with 3 operations via IoCompletionQueue. While the transaction is pending, blocking
+ * executeTransaction() and start of other transaction must fail with EBUSY. Transaction with no operations must be
+ * rejected with EINVAL.
+ *
+ * \param [in] spiMaster is a reference to low-level SPI master driver used by \a spiMasterProxy
+ * \param [in] spiMasterProxy is a reference to SpiMasterProxy used for transactions
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase1(SoftwareSpiMasterLowLevel& spiMaster, devices::SpiMasterProxy& spiMasterProxy)
+{
+	devices::IoCompletionQueue completionQueue;
+	devices::IoRequest request {completionQueue};
+	devices::IoRequest otherRequest {completionQueue};
+	uint8_t readBuffer[sizeof(testData)] {};
+	devices::SpiMasterOperation operations[]
+	{
+			{{testData, readBuffer, 2}},
+			{{testData + 2, readBuffer + 2, 2}},
+			{{nullptr, readBuffer + 4, 2}},
+	};
+	devices::IoRequest* poppedRequest {};
+
+	const auto emptyStartRet = spiMasterProxy.startTransaction(request, devices::SpiMasterOperationsRange{});
+	const auto startRet = spiMasterProxy.startTransaction(request, devices::SpiMasterOperationsRange{operations});
+	const auto pending = request.isPending();
+	const auto executeRet = spiMasterProxy.executeTransaction(devices::SpiMasterOperationsRange{operations});
+	const auto otherStartRet = spiMasterProxy.startTransaction(otherRequest,
+			devices::SpiMasterOperationsRange{operations});
+
+	finishTransfer(spiMaster);
+	finishTransfer(spiMaster);
+
+	const auto partialPending = request.isPending();
+	const auto partialPopRet = completionQueue.tryPop(poppedRequest);
+
+	finishTransfer(spiMaster);
+
+	const auto popRet = completionQueue.tryPop(poppedRequest);
+	const auto result = request.getResult();
+
+	return emptyStartRet == EINVAL && startRet == 0 && pending == true &&
+			executeRet == decltype(executeRet){EBUSY, {}} && otherStartRet == EBUSY && partialPending == true &&
+			partialPopRet == EAGAIN && popRet == 0 && poppedRequest == &request &&
+			result == decltype(result){{}, 3} && memcmp(readBuffer, testData, 4) == 0 &&
+			readBuffer[4] == SoftwareSpiMasterLowLevel::dummyData &&
+			readBuffer[5] == SoftwareSpiMasterLowLevel::dummyData && spiMaster.isTransferInProgress() == false;
+}
+
+/**
+ * \brief Phase 2 of test case.
+ *
+ * Tests cancellation of transaction. Transfer which is in progress is always finished, so cancelled transaction must be
+ * completed with ECANCELED and with the number of operations done until that moment - also when cancellation is
+ * requested before the first transfer is finished. Next operations must not be started and second cancellation must
+ * fail with EINVAL.
+ *
+ * \param [in] spiMaster is a reference to low-level SPI master driver used by \a spiMasterProxy
+ * \param [in] spiMasterProxy is a reference to SpiMasterProxy used for transactions
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase2(SoftwareSpiMasterLowLevel& spiMaster, devices::SpiMasterProxy& spiMasterProxy)
+{
+	devices::IoCompletionQueue completionQueue;
+	devices::IoRequest request {completionQueue};
+	uint8_t readBuffer[sizeof(testData)] {};
+	devices::SpiMasterOperation operations[]
+	{
+			{{testData, readBuffer, 2}},
+			{{testData + 2, readBuffer + 2, 2}},
+			{{testData + 4, readBuffer + 4, 2}},
+	};
+	devices::IoRequest* poppedRequest {};
+
+	const auto startRet1 = spiMasterProxy.startTransaction(request, devices::SpiMasterOperationsRange{operations});
+	const auto cancelRet1 = spiMasterProxy.cancel(request);
+	const auto cancelPending = request.isPending();
+
+	finishTransfer(spiMaster);
+
+	const auto transferInProgress1 = spiMaster.isTransferInProgress();
+	const auto popRet1 = completionQueue.tryPop(poppedRequest);
+	const auto result1 = request.getResult();
+
+	poppedRequest = {};
+	const auto startRet2 = spiMasterProxy.startTransaction(request, devices::SpiMasterOperationsRange{operations});
+
+	finishTransfer(spiMaster);
+
+	const auto cancelRet2 = spiMasterProxy.cancel(request);
+
+	finishTransfer(spiMaster);
+
+	const auto transferInProgress2 = spiMaster.isTransferInProgress();
+	const auto popRet2 = completionQueue.tryPop(poppedRequest);
+	const auto result2 = request.getResult();
+	const auto secondCancelRet = spiMasterProxy.cancel(request);
+
+	return startRet1 == 0 && cancelRet1 == 0 && cancelPending == true && transferInProgress1 == false &&
+			popRet1 == 0 && result1 == decltype(result1){ECANCELED, 1} && startRet2 == 0 && cancelRet2 == 0 &&
+			transferInProgress2 == false && popRet2 == 0 && poppedRequest == &request &&
+			result2 == decltype(result2){ECANCELED, 2} && memcmp(readBuffer, testData, 4) == 0 &&
+			readBuffer[4] == 0 && secondCancelRet == EINVAL;
+}
+
+/**
+ * \brief Phase 3 of test case.
+ *
+ * Tests whether cancellation of the last operation of transaction fails with EBUSY and whether failed transfer
+ * completes the transaction with EIO. After that blocking executeTransaction(), with transfers finished by periodic
+ * software timer, must succeed.
+ *
+ * \param [in] spiMaster is a reference to low-level SPI master driver used by \a spiMasterProxy
+ * \param [in] spiMasterProxy is a reference to SpiMasterProxy used for transactions
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase3(SoftwareSpiMasterLowLevel& spiMaster, devices::SpiMasterProxy& spiMasterProxy)
+{
+	devices::IoCompletionQueue completionQueue;
+	devices::IoRequest request {completionQueue};
+	uint8_t readBuffer[4] {};
+	devices::SpiMasterOperation operations[]
+	{
+			{{testData, readBuffer, 2}},
+			{{testData + 2, readBuffer + 2, 2}},
+	};
+	devices::IoRequest* poppedRequest {};
+
+	const auto startRet1 = spiMasterProxy.startTransaction(request, devices::SpiMasterOperationsRange{operations});
+
+	finishTransfer(spiMaster);
+
+	const auto cancelRet = spiMasterProxy.cancel(request);
+
+	finishTransfer(spiMaster);
+
+	const auto popRet1 = completionQueue.tryPop(poppedRequest);
+	const auto result1 = request.getResult();
+
+	devices::SpiMasterErrorSet errorSet;
+	errorSet[devices::SpiMasterErrorSet::overrunError] = true;
+	const auto startRet2 = spiMasterProxy.startTransaction(request, devices::SpiMasterOperationsRange{operations});
+
+	finishTransfer(spiMaster, errorSet);
+
+	const auto popRet2 = completionQueue.tryPop(poppedRequest);
+	const auto result2 = request.getResult();
+	const auto transferErrorSet = operations[0].getTransfer()->getErrorSet();
+
+	auto softwareTimer = makeStaticSoftwareTimer(
+			[&spiMaster]()
+			{
+				spiMaster.finishTransfer();
+			});
+	softwareTimer.start(singleDuration, singleDuration);
+	const auto executeRet = spiMasterProxy.executeTransaction(devices::SpiMasterOperationsRange{operations});
+	softwareTimer.stop();
+
+	return startRet1 == 0 && cancelRet == EBUSY && popRet1 == 0 && result1 == decltype(result1){{}, 2} &&
+			startRet2 == 0 && popRet2 == 0 && poppedRequest == &request && result2 == decltype(result2){EIO, {}} &&
+			transferErrorSet == errorSet && executeRet == decltype(executeRet){{}, 2} &&
+			memcmp(readBuffer, testData, sizeof(readBuffer)) == 0;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool IoRequestSpiMasterProxyTestCase::run_() const
+{
+	SoftwareSpiMasterLowLevel spiMasterLowLevel;
+	devices::SpiMaster spiMaster {spiMasterLowLevel};
+	SoftwareOutputPin slaveSelectPin;
+	devices::SpiDevice spiDevice {spiMaster, slaveSelectPin};
+
+	{
+		const auto ret = spiDevice.open();
+		if (ret != 0)
+			return false;
+	}
+
+	auto ret = true;
+	{
+		const devices::SpiDeviceProxy spiDeviceProxy {spiDevice};
+		devices::SpiMasterProxy spiMasterProxy {spiDeviceProxy};
+
+		for (const auto& function : {phase1, phase2, phase3})
+		{
+			ret = function(spiMasterLowLevel, spiMasterProxy);
+			if (ret != true)
+				break;
+		}
+	}
+
+	const auto closeRet = spiDevice.close();
+	return ret == true && closeRet == 0;
+}
+
+}	// namespace test
+
+}	// namespace distortos
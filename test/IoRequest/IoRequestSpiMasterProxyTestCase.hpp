@@ -0,0 +1,49 @@
+/**
+ * \file
+ * \brief IoRequestSpiMasterProxyTestCase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEST_IOREQUEST_IOREQUESTSPIMASTERPROXYTESTCASE_HPP_
+#define TEST_IOREQUEST_IOREQUESTSPIMASTERPROXYTESTCASE_HPP_
+
+#include "TestCaseCommon.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+/**
+ * \brief Tests asynchronous transactions of SpiMasterProxy.
+ *
+ * SpiMasterProxy uses software low-level SPI master driver, whose transfers are finished from interrupt context by the
+ * test. Tests completion of transactions via IoCompletionQueue, cancellation between operations (with the number of
+ * completed operations), rejection of cancellation of the last operation, failed transfers and whether blocking
+ * executeTransaction() is rejected with EBUSY while asynchronous transaction is pending.
+ */
+
+class IoRequestSpiMasterProxyTestCase : public TestCaseCommon
+{
+private:
+
+	/**
+	 * \brief Runs the test case.
+	 *
+	 * \return true if the test case succeeded, false otherwise
+	 */
+
+	bool run_() const override;
+};
+
+}	// namespace test
+
+}	// namespace distortos
+
+#endif	// TEST_IOREQUEST_IOREQUESTSPIMASTERPROXYTESTCASE_HPP_
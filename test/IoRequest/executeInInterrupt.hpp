@@ -0,0 +1,46 @@
+/**
+ * \file
+ * \brief executeInInterrupt() header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEST_IOREQUEST_EXECUTEININTERRUPT_HPP_
+#define TEST_IOREQUEST_EXECUTEININTERRUPT_HPP_
+
+#include "distortos/StaticSoftwareTimer.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+/**
+ * \brief Executes function in interrupt context and waits until it is done.
+ *
+ * The function is executed by software timer, the calling thread busy-waits for it, so the function is executed with
+ * this thread preempted - just like an interrupt handler of real hardware.
+ *
+ * \tparam Function is the type of function that will be executed
+ *
+ * \param [in] function is the function that will be executed
+ */
+
+template<typename Function>
+void executeInInterrupt(Function&& function)
+{
+	auto softwareTimer = makeStaticSoftwareTimer(std::forward<Function>(function));
+	softwareTimer.start(TickClock::duration{1});
+	while (softwareTimer.isRunning() == true);
+}
+
+}	// namespace test
+
+}	// namespace distortos
+
+#endif	// TEST_IOREQUEST_EXECUTEININTERRUPT_HPP_
@@ -0,0 +1,55 @@
+/**
+ * \file
+ * \brief ioRequestTestCases object definition
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "ioRequestTestCases.hpp"
+
+#include "IoRequestSerialPortTestCase.hpp"
+#include "IoRequestSpiMasterProxyTestCase.hpp"
+
+#include "TestCaseGroup.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// IoRequestSerialPortTestCase instance
+const IoRequestSerialPortTestCase serialPortTestCase;
+
+/// IoRequestSpiMasterProxyTestCase instance
+const IoRequestSpiMasterProxyTestCase spiMasterProxyTestCase;
+
+/// array with references to TestCase objects related to asynchronous I/O requests
+const TestCaseGroup::Range::value_type ioRequestTestCases_[]
+{
+		TestCaseGroup::Range::value_type{serialPortTestCase},
+		TestCaseGroup::Range::value_type{spiMasterProxyTestCase},
+};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+const TestCaseGroup ioRequestTestCases {TestCaseGroup::Range{ioRequestTestCases_}};
+
+}	// namespace test
+
+}	// namespace distortos
@@ -0,0 +1,268 @@
+/**
+ * \file
+ * \brief IpcEndpointOperationsTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "IpcEndpointOperationsTestCase.hpp"
+
+#include "waitForNextTick.hpp"
+
+#include "distortos/DynamicThread.hpp"
+#include "distortos/IpcEndpoint.hpp"
+#include "distortos/statistics.hpp"
+#include "distortos/ThisThread.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// single duration used in tests
+constexpr auto singleDuration = TickClock::duration{1};
+
+/// long duration used in tests
+constexpr auto longDuration = singleDuration * 10;
+
+/// size of stack for test thread, bytes
+constexpr size_t testThreadStackSize {512};
+
+/// priority of low priority server thread, lower than priority of main test thread
+constexpr uint8_t lowPriority {1};
+
+/// expected number of context switches in phase1 block involving tryReceiveFor(), tryReceiveUntil(), tryCallFor()
+/// (excluding waitForNextTick()): 1 - main thread blocks on endpoint (main -> idle), 2 - main thread wakes up
+/// (idle -> main)
+constexpr decltype(statistics::getContextSwitchCount()) phase1TryForUntilContextSwitchCount {2};
+
+/// expected number of context switches in phase2 block (excluding waitForNextTick()): 1 - test thread starts
+/// (main -> test), 2 - test thread blocks in receive() (test -> main), 3 - main thread hands the call directly to test
+/// thread (main -> test), 4 - test thread replies and terminates (test -> main)
+constexpr decltype(statistics::getContextSwitchCount()) phase2ContextSwitchCount {4};
+
+/// expected number of context switches in phase3 block: 1 - main thread blocks on the call (main -> test), 2 - test
+/// thread replies (test -> main), 3 - main thread waits for test thread to terminate (main -> test), 4 - test thread
+/// terminates (test -> main)
+constexpr decltype(statistics::getContextSwitchCount()) phase3ContextSwitchCount {4};
+
+/// expected number of context switches in waitForNextTick(): main -> idle -> main
+constexpr decltype(statistics::getContextSwitchCount()) waitForNextTickContextSwitchCount {2};
+
+/// value added by server thread to each word of the message
+constexpr uint32_t replyIncrement {0x1000};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Server thread which receives single call, sets last word of reply to its effective priority at that moment
+ * and adds replyIncrement to all other words of the message.
+ *
+ * \param [in] ipcEndpoint is a reference to IpcEndpoint used for receiving the call
+ */
+
+void serverThread(IpcEndpoint& ipcEndpoint)
+{
+	IpcMessage message {};
+	if (ipcEndpoint.receive(message) != 0)
+		return;
+
+	for (size_t i {}; i < message.size() - 1; ++i)
+		message[i] += replyIncrement;
+	message.back() = ThisThread::getEffectivePriority();
+	ipcEndpoint.reply(message);
+}
+
+/**
+ * \brief Phase 1 of test case.
+ *
+ * Tests whether all try*() functions properly return some error when there is no counterpart on the other side of the
+ * endpoint and whether reply() without received call fails.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase1()
+{
+	IpcEndpoint ipcEndpoint;
+	IpcMessage message {};
+
+	{
+		// no call is pending, so tryReceive() should fail immediately
+		waitForNextTick();
+		const auto start = TickClock::now();
+		const auto ret = ipcEndpoint.tryReceive(message);
+		if (ret != EAGAIN || start != TickClock::now())
+			return false;
+	}
+
+	{
+		// no call was received, so reply() should fail immediately
+		waitForNextTick();
+		const auto start = TickClock::now();
+		const auto ret = ipcEndpoint.reply(message);
+		if (ret != EPERM || start != TickClock::now())
+			return false;
+	}
+
+	{
+		waitForNextTick();
+
+		const auto contextSwitchCount = statistics::getContextSwitchCount();
+
+		// no call is pending, so tryReceiveFor() should time-out at expected time
+		const auto start = TickClock::now();
+		const auto ret = ipcEndpoint.tryReceiveFor(singleDuration, message);
+		const auto realDuration = TickClock::now() - start;
+		if (ret != ETIMEDOUT || realDuration != singleDuration + decltype(singleDuration){1} ||
+				statistics::getContextSwitchCount() - contextSwitchCount != phase1TryForUntilContextSwitchCount)
+			return false;
+	}
+
+	{
+		waitForNextTick();
+
+		const auto contextSwitchCount = statistics::getContextSwitchCount();
+
+		// no call is pending, so tryReceiveUntil() should time-out at exact expected time
+		const auto requestedTimePoint = TickClock::now() + singleDuration;
+		const auto ret = ipcEndpoint.tryReceiveUntil(requestedTimePoint, message);
+		if (ret != ETIMEDOUT || requestedTimePoint != TickClock::now() ||
+				statistics::getContextSwitchCount() - contextSwitchCount != phase1TryForUntilContextSwitchCount)
+			return false;
+	}
+
+	{
+		waitForNextTick();
+
+		const auto contextSwitchCount = statistics::getContextSwitchCount();
+
+		// no server is running, so tryCallFor() should time-out at expected time
+		const auto start = TickClock::now();
+		const auto ret = ipcEndpoint.tryCallFor(singleDuration, message);
+		const auto realDuration = TickClock::now() - start;
+		if (ret != ETIMEDOUT || realDuration != singleDuration + decltype(singleDuration){1} ||
+				statistics::getContextSwitchCount() - contextSwitchCount != phase1TryForUntilContextSwitchCount)
+			return false;
+	}
+
+	{
+		// time point is already in the past, so tryCallUntil() should fail immediately
+		waitForNextTick();
+		const auto start = TickClock::now();
+		const auto contextSwitchCount = statistics::getContextSwitchCount();
+		const auto ret = ipcEndpoint.tryCallUntil(start, message);
+		if (ret != ETIMEDOUT || start != TickClock::now() ||
+				statistics::getContextSwitchCount() != contextSwitchCount)
+			return false;
+	}
+
+	{
+		// the call which timed out must not be visible to the server
+		const auto ret = ipcEndpoint.tryReceive(message);
+		if (ret != EAGAIN)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * \brief Phase 2 of test case.
+ *
+ * Tests direct handoff - high priority server thread is already blocked in receive() when main thread makes the call,
+ * message is delivered and replied without going through the idle thread.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase2()
+{
+	IpcEndpoint ipcEndpoint;
+
+	waitForNextTick();
+
+	const auto contextSwitchCount = statistics::getContextSwitchCount();
+	auto thread = makeAndStartDynamicThread({testThreadStackSize, UINT8_MAX}, serverThread, std::ref(ipcEndpoint));
+
+	IpcMessage message {{1, 2, 3, 4}};
+	const auto ret = ipcEndpoint.tryCallFor(longDuration, message);
+	thread.join();
+	return ret == 0 && message[0] == 1 + replyIncrement && message[1] == 2 + replyIncrement &&
+			message[2] == 3 + replyIncrement && message[3] == UINT8_MAX &&
+			statistics::getContextSwitchCount() - contextSwitchCount == phase2ContextSwitchCount;
+}
+
+/**
+ * \brief Phase 3 of test case.
+ *
+ * Tests priority donation - main thread makes the call before low priority server thread reaches receive(), so the call
+ * is pending. When the server receives the call, it must run with the priority of main thread until it replies.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase3()
+{
+	IpcEndpoint ipcEndpoint;
+
+	auto thread = makeAndStartDynamicThread({testThreadStackSize, lowPriority}, serverThread, std::ref(ipcEndpoint));
+
+	IpcMessage message {{5, 6, 7, 8}};
+	const auto ret = ipcEndpoint.call(message);
+	const auto serverEffectivePriority = thread.getEffectivePriority();
+	thread.join();
+	return ret == 0 && message[0] == 5 + replyIncrement && message[1] == 6 + replyIncrement &&
+			message[2] == 7 + replyIncrement && message[3] == ThisThread::getEffectivePriority() &&
+			serverEffectivePriority == lowPriority;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool IpcEndpointOperationsTestCase::run_() const
+{
+	constexpr auto phase1ExpectedContextSwitchCount = 6 * waitForNextTickContextSwitchCount +
+			3 * phase1TryForUntilContextSwitchCount;
+	constexpr auto phase2ExpectedContextSwitchCount = 1 * waitForNextTickContextSwitchCount + phase2ContextSwitchCount;
+	constexpr auto phase3ExpectedContextSwitchCount = phase3ContextSwitchCount;
+	constexpr auto expectedContextSwitchCount = phase1ExpectedContextSwitchCount + phase2ExpectedContextSwitchCount +
+			phase3ExpectedContextSwitchCount;
+
+	const auto contextSwitchCount = statistics::getContextSwitchCount();
+
+	for (const auto& function : {phase1, phase2, phase3})
+	{
+		const auto ret = function();
+		if (ret != true)
+			return ret;
+	}
+
+	if (statistics::getContextSwitchCount() - contextSwitchCount != expectedContextSwitchCount)
+		return false;
+
+	return true;
+}
+
+}	// namespace test
+
+}	// namespace distortos
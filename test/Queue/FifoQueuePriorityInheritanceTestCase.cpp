@@ -0,0 +1,145 @@
+/**
+ * \file
+ * \brief FifoQueuePriorityInheritanceTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "FifoQueuePriorityInheritanceTestCase.hpp"
+
+#include "waitForNextTick.hpp"
+
+#include "distortos/DynamicThread.hpp"
+#include "distortos/StaticFifoQueue.hpp"
+#include "distortos/StaticSoftwareTimer.hpp"
+#include "distortos/ThisThread.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// single duration used in tests
+constexpr auto singleDuration = TickClock::duration{1};
+
+/// long duration used in tests
+constexpr auto longDuration = singleDuration * 10;
+
+/// size of stack for test thread, bytes
+constexpr size_t testThreadStackSize {512};
+
+/// priority of low priority producer thread, lower than priority of main test thread
+constexpr uint8_t lowPriority {1};
+
+/// value pushed by producer thread
+constexpr uint8_t pushedValue {0x5a};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// type of queue used in tests
+using TestFifoQueue = StaticFifoQueue<uint8_t, 1>;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Producer thread
+ *
+ * Registers itself in the queue, waits for the semaphore, saves its effective priority and pushes the value to the
+ * queue. At the end unregisters from the queue.
+ *
+ * \param [in] fifoQueue is a reference to queue in which the thread registers itself
+ * \param [in] semaphore is a reference to semaphore which will be waited for before pushing the value
+ * \param [out] inheritedPriority is a reference to variable into which effective priority of the thread right before
+ * pushing the value will be written
+ * \param [out] result is a reference to variable into which result of registration and unregistration will be written
+ */
+
+void producerThread(TestFifoQueue& fifoQueue, Semaphore& semaphore, uint8_t& inheritedPriority, bool& result)
+{
+	QueueProducer queueProducer;
+	if (fifoQueue.registerProducer(queueProducer) != 0 || fifoQueue.registerProducer(queueProducer) != EBUSY)
+		return;
+
+	semaphore.wait();
+	inheritedPriority = ThisThread::getEffectivePriority();
+	fifoQueue.push(pushedValue);
+
+	result = fifoQueue.unregisterProducer(queueProducer) == 0 &&
+			fifoQueue.unregisterProducer(queueProducer) == EINVAL && queueProducer.isRegistered() == false;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool FifoQueuePriorityInheritanceTestCase::run_() const
+{
+	const auto mainPriority = ThisThread::getEffectivePriority();
+	TestFifoQueue fifoQueue;
+	Semaphore semaphore {0};
+	uint8_t inheritedPriority {};
+	bool result {};
+
+	auto thread = makeAndStartDynamicThread({testThreadStackSize, lowPriority}, producerThread, std::ref(fifoQueue),
+			std::ref(semaphore), std::ref(inheritedPriority), std::ref(result));
+
+	ThisThread::sleepFor(singleDuration);	// let producer register itself and block on semaphore
+
+	// registration alone doesn't boost priority of producer
+	if (thread.getEffectivePriority() != lowPriority)
+	{
+		semaphore.post();
+		thread.join();
+		return false;
+	}
+
+	uint8_t sampledPriority {};
+	auto softwareTimer = makeStaticSoftwareTimer(
+			[&thread, &sampledPriority]()
+			{
+				sampledPriority = thread.getEffectivePriority();
+			});
+
+	waitForNextTick();
+	softwareTimer.start(singleDuration);
+
+	uint8_t value {};
+	// producer inherits priority of main thread while it waits for an element and loses it after timeout
+	const auto tryPopForRet = fifoQueue.tryPopFor(longDuration, value);
+	const auto priorityAfterTimeout = thread.getEffectivePriority();
+
+	// producer runs with priority of main thread only until it pushes the value
+	semaphore.post();
+	const auto popRet = fifoQueue.pop(value);
+	const auto priorityAfterPop = thread.getEffectivePriority();
+
+	thread.join();
+
+	return tryPopForRet == ETIMEDOUT && sampledPriority == mainPriority && priorityAfterTimeout == lowPriority &&
+			popRet == 0 && value == pushedValue && inheritedPriority == mainPriority &&
+			priorityAfterPop == lowPriority && result == true;
+}
+
+}	// namespace test
+
+}	// namespace distortos
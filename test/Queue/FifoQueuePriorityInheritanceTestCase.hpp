@@ -0,0 +1,48 @@
+/**
+ * \file
+ * \brief FifoQueuePriorityInheritanceTestCase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEST_QUEUE_FIFOQUEUEPRIORITYINHERITANCETESTCASE_HPP_
+#define TEST_QUEUE_FIFOQUEUEPRIORITYINHERITANCETESTCASE_HPP_
+
+#include "TestCaseCommon.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+/**
+ * \brief Tests priority inheritance across blocking on FifoQueue.
+ *
+ * Low priority producer thread registers itself in the queue. Main thread blocks on the queue - with timeout and
+ * without it - and the test checks whether the producer inherits the priority of main thread only while main thread is
+ * waiting for an element, and whether registration and unregistration report errors as expected.
+ */
+
+class FifoQueuePriorityInheritanceTestCase : public TestCaseCommon
+{
+private:
+
+	/**
+	 * \brief Runs the test case.
+	 *
+	 * \return true if the test case succeeded, false otherwise
+	 */
+
+	bool run_() const override;
+};
+
+}	// namespace test
+
+}	// namespace distortos
+
+#endif	// TEST_QUEUE_FIFOQUEUEPRIORITYINHERITANCETESTCASE_HPP_
@@ -0,0 +1,234 @@
+/**
+ * \file
+ * \brief RingQueueOperationsTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "RingQueueOperationsTestCase.hpp"
+
+#include "OperationCountingType.hpp"
+#include "waitForNextTick.hpp"
+
+#include "distortos/StaticRingQueue.hpp"
+#include "distortos/StaticSoftwareTimer.hpp"
+#include "distortos/statistics.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// single duration used in tests
+constexpr auto singleDuration = TickClock::duration{1};
+
+/// long duration used in tests
+constexpr auto longDuration = singleDuration * 10;
+
+/// capacity of queues used in tests
+constexpr size_t queueCapacity {4};
+
+/// expected number of context switches in block involving software timer (excluding waitForNextTick()): 1 - main
+/// thread blocks on queue (main -> idle), 2 - main thread is unblocked by interrupt (idle -> main)
+constexpr decltype(statistics::getContextSwitchCount()) softwareTimerContextSwitchCount {2};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// type of queue used in tests
+using TestRingQueue = StaticRingQueue<OperationCountingType, queueCapacity>;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Phase 1 of test case.
+ *
+ * Tests whether pushing to full queue overwrites the oldest elements, destroys them and increments overflow counter,
+ * and whether tryPop() and tryPopBatch() return elements in expected order.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase1()
+{
+	TestRingQueue ringQueue;
+	constexpr OperationCountingType::Value pushedElements {queueCapacity + 2};
+
+	OperationCountingType::resetCounters();
+	for (OperationCountingType::Value i {1}; i <= pushedElements; ++i)
+	{
+		// 1 construction, 1 move construction, 1 destruction (+ 1 destruction of dropped element)
+		const auto ret = ringQueue.push(OperationCountingType{i});
+		if (ret != 0)
+			return false;
+	}
+
+	if (ringQueue.getSize() != queueCapacity || ringQueue.getOverflowCount() != pushedElements - queueCapacity ||
+			OperationCountingType::checkCounters(pushedElements, 0, pushedElements,
+					pushedElements + pushedElements - queueCapacity, 0, 0, 0) != true)
+		return false;
+
+	OperationCountingType values[queueCapacity - 1];
+
+	{
+		OperationCountingType::resetCounters();
+		const auto ret = ringQueue.tryPopBatch(values, sizeof(values) / sizeof(*values));	// 3 swaps, 3 destructions
+		if (ret.first != 0 || ret.second != queueCapacity - 1 || values[0].getValue() != 3 ||
+				values[1].getValue() != 4 || values[2].getValue() != 5 || ringQueue.getSize() != 1 ||
+				OperationCountingType::checkCounters(0, 0, 0, 3, 0, 0, 3) != true)
+			return false;
+	}
+	{
+		OperationCountingType::resetCounters();
+		const auto ret = ringQueue.tryPop(values[0]);	// 1 swap, 1 destruction
+		if (ret != 0 || values[0].getValue() != 6 || ringQueue.getSize() != 0 ||
+				OperationCountingType::checkCounters(0, 0, 0, 1, 0, 0, 1) != true)
+			return false;
+	}
+	{
+		const auto ret = ringQueue.tryPop(values[0]);
+		if (ret != EAGAIN)
+			return false;
+	}
+	{
+		const auto ret = ringQueue.tryPopBatch(values, sizeof(values) / sizeof(*values));
+		if (ret.first != EAGAIN || ret.second != 0)
+			return false;
+	}
+	{
+		const auto ret = ringQueue.popBatch(values, 0);
+		if (ret.first != EINVAL || ret.second != 0)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * \brief Phase 2 of test case.
+ *
+ * Tests whether blocking popBatch() is unblocked by push() from interrupt context (software timer) and whether it pops
+ * all elements available at that moment.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase2()
+{
+	TestRingQueue ringQueue;
+	auto softwareTimer = makeStaticSoftwareTimer(
+			[&ringQueue]()
+			{
+				for (OperationCountingType::Value i {1}; i <= queueCapacity + 1; ++i)
+					ringQueue.emplace(i);
+			});
+
+	waitForNextTick();
+
+	const auto contextSwitchCount = statistics::getContextSwitchCount();
+	const auto wakeUpTimePoint = TickClock::now() + longDuration;
+	softwareTimer.start(wakeUpTimePoint);
+
+	OperationCountingType values[queueCapacity + 1];
+	const auto ret = ringQueue.popBatch(values, sizeof(values) / sizeof(*values));
+	const auto wokenUpTimePoint = TickClock::now();
+	return ret.first == 0 && ret.second == queueCapacity && wakeUpTimePoint == wokenUpTimePoint &&
+			values[0].getValue() == 2 && values[queueCapacity - 1].getValue() == queueCapacity + 1 &&
+			ringQueue.getOverflowCount() == 1 &&
+			statistics::getContextSwitchCount() - contextSwitchCount == softwareTimerContextSwitchCount;
+}
+
+/**
+ * \brief Phase 3 of test case.
+ *
+ * Tests whether push() to full queue from interrupt context (software timer) overwrites the oldest element when it is
+ * already assigned to main thread which was unblocked by the previous push(), but didn't run yet - the newest element
+ * must not be dropped.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase3()
+{
+	StaticRingQueue<OperationCountingType, 1> ringQueue;
+	int emplaceRets[2] {-1, -1};
+	auto softwareTimer = makeStaticSoftwareTimer(
+			[&ringQueue, &emplaceRets]()
+			{
+				emplaceRets[0] = ringQueue.emplace(1u);
+				emplaceRets[1] = ringQueue.emplace(2u);
+			});
+
+	waitForNextTick();
+
+	const auto wakeUpTimePoint = TickClock::now() + longDuration;
+	softwareTimer.start(wakeUpTimePoint);
+
+	OperationCountingType value;
+	const auto ret = ringQueue.pop(value);
+	const auto wokenUpTimePoint = TickClock::now();
+	return ret == 0 && emplaceRets[0] == 0 && emplaceRets[1] == 0 && wakeUpTimePoint == wokenUpTimePoint &&
+			value.getValue() == 2 && ringQueue.getSize() == 0 && ringQueue.getOverflowCount() == 1;
+}
+
+/**
+ * \brief Phase 4 of test case.
+ *
+ * Tests whether destructor of queue destroys all remaining elements.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase4()
+{
+	{
+		TestRingQueue ringQueue;
+		OperationCountingType::resetCounters();
+		ringQueue.emplace(1u);	// 1 construction
+		const OperationCountingType value {2};	// 1 construction
+		ringQueue.push(value);	// 1 copy construction
+		if (OperationCountingType::checkCounters(2, 1, 0, 0, 0, 0, 0) != true)
+			return false;
+	}	// 3 destructions
+
+	return OperationCountingType::checkCounters(2, 1, 0, 3, 0, 0, 0);
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool RingQueueOperationsTestCase::run_() const
+{
+	for (const auto& function : {phase1, phase2, phase3, phase4})
+	{
+		const auto ret = function();
+		if (ret != true)
+			return ret;
+	}
+
+	return true;
+}
+
+}	// namespace test
+
+}	// namespace distortos
@@ -0,0 +1,49 @@
+/**
+ * \file
+ * \brief RingQueueOperationsTestCase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEST_QUEUE_RINGQUEUEOPERATIONSTESTCASE_HPP_
+#define TEST_QUEUE_RINGQUEUEOPERATIONSTESTCASE_HPP_
+
+#include "TestCaseCommon.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+/**
+ * \brief Tests various operations of ring queue.
+ *
+ * Tests overwriting of the oldest elements when pushing to full queue (including destruction of dropped elements and
+ * overflow counter), batch pops (popBatch() and tryPopBatch()), pushing from interrupt context (software timer) to
+ * a queue on which main thread is blocked (also when the only element of full queue is already assigned to unblocked
+ * main thread) and destruction of elements remaining in the queue.
+ */
+
+class RingQueueOperationsTestCase : public TestCaseCommon
+{
+private:
+
+	/**
+	 * \brief Runs the test case.
+	 *
+	 * \return true if the test case succeeded, false otherwise
+	 */
+
+	bool run_() const override;
+};
+
+}	// namespace test
+
+}	// namespace distortos
+
+#endif	// TEST_QUEUE_RINGQUEUEOPERATIONSTESTCASE_HPP_
@@ -8,8 +8,10 @@
 #
 
 target_sources(distortosTest PRIVATE
+		${CMAKE_CURRENT_LIST_DIR}/FifoQueuePriorityInheritanceTestCase.cpp
 		${CMAKE_CURRENT_LIST_DIR}/FifoQueuePriorityTestCase.cpp
 		${CMAKE_CURRENT_LIST_DIR}/MessageQueuePriorityTestCase.cpp
 		${CMAKE_CURRENT_LIST_DIR}/QueueOperationsTestCase.cpp
 		${CMAKE_CURRENT_LIST_DIR}/queueTestCases.cpp
+		${CMAKE_CURRENT_LIST_DIR}/RingQueueOperationsTestCase.cpp
 		${CMAKE_CURRENT_LIST_DIR}/QueueWrappers.cpp)
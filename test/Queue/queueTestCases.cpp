@@ -2,7 +2,7 @@
  * \file
  * \brief queueTestCases object definition
  *
- * \author Copyright (C) 2015 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2015-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -13,7 +13,9 @@
 
 #include "QueueOperationsTestCase.hpp"
 #include "FifoQueuePriorityTestCase.hpp"
+#include "FifoQueuePriorityInheritanceTestCase.hpp"
 #include "MessageQueuePriorityTestCase.hpp"
+#include "RingQueueOperationsTestCase.hpp"
 
 #include "TestCaseGroup.hpp"
 
@@ -36,15 +38,23 @@ const QueueOperationsTestCase operationsTestCase;
 /// FifoQueuePriorityTestCase instance
 const FifoQueuePriorityTestCase fifoQueuePriorityTestCase;
 
+/// FifoQueuePriorityInheritanceTestCase instance
+const FifoQueuePriorityInheritanceTestCase fifoQueuePriorityInheritanceTestCase;
+
 /// MessageQueuePriorityTestCase instance
 const MessageQueuePriorityTestCase messageQueuePriorityTestCase;
 
+/// RingQueueOperationsTestCase instance
+const RingQueueOperationsTestCase ringQueueOperationsTestCase;
+
 /// array with references to TestCase objects related to queue
 const TestCaseGroup::Range::value_type queueTestCases_[]
 {
 		TestCaseGroup::Range::value_type{operationsTestCase},
 		TestCaseGroup::Range::value_type{fifoQueuePriorityTestCase},
+		TestCaseGroup::Range::value_type{fifoQueuePriorityInheritanceTestCase},
 		TestCaseGroup::Range::value_type{messageQueuePriorityTestCase},
+		TestCaseGroup::Range::value_type{ringQueueOperationsTestCase},
 };
 
 }	// namespace
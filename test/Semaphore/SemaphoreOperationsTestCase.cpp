@@ -2,7 +2,7 @@
  * \file
  * \brief SemaphoreOperationsTestCase class implementation
  *
- * \author Copyright (C) 2014-2016 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -329,7 +329,8 @@ bool phase3()
 bool phase4()
 {
 	Semaphore semaphore {0};
-	auto softwareTimer = makeStaticSoftwareTimer(&Semaphore::post, std::ref(semaphore));
+	auto softwareTimer = makeStaticSoftwareTimer(static_cast<int(Semaphore::*)()>(&Semaphore::post),
+			std::ref(semaphore));
 
 	{
 		waitForNextTick();
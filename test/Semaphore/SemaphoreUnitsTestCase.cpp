@@ -0,0 +1,339 @@
+/**
+ * \file
+ * \brief SemaphoreUnitsTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "SemaphoreUnitsTestCase.hpp"
+
+#include "SequenceAsserter.hpp"
+#include "waitForNextTick.hpp"
+
+#include "distortos/DynamicThread.hpp"
+#include "distortos/Semaphore.hpp"
+#include "distortos/StaticSoftwareTimer.hpp"
+#include "distortos/ThisThread.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// single duration used in tests
+constexpr auto singleDuration = TickClock::duration{1};
+
+/// long duration used in tests
+constexpr auto longDuration = singleDuration * 10;
+
+/// size of stack for test thread, bytes
+constexpr size_t testThreadStackSize {512};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Test thread which acquires units of semaphore with wait(Value).
+ *
+ * \param [in] semaphore is a reference to semaphore from which units will be acquired
+ * \param [in] units is the number of units that will be acquired
+ * \param [in] sequenceAsserter is a reference to SequenceAsserter shared object
+ * \param [in] sequencePoint is the sequence point marked after units are acquired
+ * \param [out] ret is a reference to variable into which the value returned by wait(Value) will be written
+ */
+
+void waitThread(Semaphore& semaphore, const Semaphore::Value units, SequenceAsserter& sequenceAsserter,
+		const unsigned int sequencePoint, int& ret)
+{
+	ret = semaphore.wait(units);
+	sequenceAsserter.sequencePoint(sequencePoint);
+}
+
+/**
+ * \brief Test thread which releases units of semaphore with post(Value).
+ *
+ * \param [in] semaphore is a reference to semaphore to which units will be released
+ * \param [in] units is the number of units that will be released
+ * \param [in] sequenceAsserter is a reference to SequenceAsserter shared object
+ * \param [in] sequencePoint is the sequence point marked before units are released
+ * \param [out] ret is a reference to variable into which the value returned by post(Value) will be written
+ */
+
+void postThread(Semaphore& semaphore, const Semaphore::Value units, SequenceAsserter& sequenceAsserter,
+		const unsigned int sequencePoint, int& ret)
+{
+	sequenceAsserter.sequencePoint(sequencePoint);
+	ret = semaphore.post(units);
+}
+
+/**
+ * \brief Test thread which tries to acquire units of semaphore with tryWaitFor(TickClock::duration, Value).
+ *
+ * \param [in] semaphore is a reference to semaphore from which units will be acquired
+ * \param [in] units is the number of units that will be acquired
+ * \param [in] sequenceAsserter is a reference to SequenceAsserter shared object
+ * \param [in] sequencePoint is the sequence point marked after the wait is finished
+ * \param [out] ret is a reference to variable into which the value returned by tryWaitFor() will be written
+ */
+
+void tryWaitForThread(Semaphore& semaphore, const Semaphore::Value units, SequenceAsserter& sequenceAsserter,
+		const unsigned int sequencePoint, int& ret)
+{
+	ret = semaphore.tryWaitFor(longDuration, units);
+	sequenceAsserter.sequencePoint(sequencePoint);
+}
+
+/**
+ * \brief Phase 1 of test case.
+ *
+ * Tests validation of arguments, overflow detection and non-blocking acquiring of multiple units.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase1()
+{
+	Semaphore semaphore {5, 8};
+
+	if (semaphore.tryWait(3) != 0 || semaphore.getValue() != 2)
+		return false;
+	if (semaphore.tryWait(3) != EAGAIN || semaphore.getValue() != 2)
+		return false;
+	if (semaphore.tryWait(0) != EINVAL || semaphore.tryWait(9) != EINVAL || semaphore.wait(9) != EINVAL ||
+			semaphore.tryWaitFor(singleDuration, 0) != EINVAL)
+		return false;
+	if (semaphore.post(0) != EINVAL || semaphore.post(7) != EOVERFLOW || semaphore.getValue() != 2)
+		return false;
+	if (semaphore.post(6) != 0 || semaphore.getValue() != 8)
+		return false;
+	if (semaphore.tryWaitFor(singleDuration, 8) != 0 || semaphore.getValue() != 0)
+		return false;
+
+	return true;
+}
+
+/**
+ * \brief Phase 2 of test case.
+ *
+ * Two threads with priority higher than main thread block on semaphore - first one requests 3 units, second one
+ * requests 1 unit. Posting 1 unit must not unblock the second thread, as it would overtake the first one. Posting 3
+ * more units must unblock both threads in one call.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase2()
+{
+	const auto priority = ThisThread::getPriority() + 1;
+	Semaphore semaphore {0};
+	SequenceAsserter sequenceAsserter;
+	int ret0 {-1};
+	int ret1 {-1};
+
+	auto thread0 = makeAndStartDynamicThread({testThreadStackSize, static_cast<uint8_t>(priority)}, waitThread,
+			std::ref(semaphore), 3, std::ref(sequenceAsserter), 1, std::ref(ret0));
+	auto thread1 = makeAndStartDynamicThread({testThreadStackSize, static_cast<uint8_t>(priority)}, waitThread,
+			std::ref(semaphore), 1, std::ref(sequenceAsserter), 2, std::ref(ret1));
+
+	sequenceAsserter.sequencePoint(0);
+	const auto post1Ret = semaphore.post(1);
+	const auto post1Value = semaphore.getValue();
+	const auto post1State = thread1.getState();
+	const auto post3Ret = semaphore.post(3);
+	sequenceAsserter.sequencePoint(3);
+
+	thread0.join();
+	thread1.join();
+
+	return post1Ret == 0 && post1Value == 1 && post1State == ThreadState::blockedOnSemaphore && post3Ret == 0 &&
+			ret0 == 0 && ret1 == 0 && semaphore.getValue() == 0 && sequenceAsserter.assertSequence(4) == true;
+}
+
+/**
+ * \brief Phase 3 of test case.
+ *
+ * Same as phase 2, but the first thread uses tryWaitFor() and its wait times out. Second thread must be unblocked at
+ * that moment with the units which were already available.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase3()
+{
+	const auto priority = ThisThread::getPriority() + 1;
+	Semaphore semaphore {0};
+	SequenceAsserter sequenceAsserter;
+	int ret0 {-1};
+	int ret1 {-1};
+
+	auto thread0 = makeAndStartDynamicThread({testThreadStackSize, static_cast<uint8_t>(priority)}, tryWaitForThread,
+			std::ref(semaphore), 3, std::ref(sequenceAsserter), 1, std::ref(ret0));
+	auto thread1 = makeAndStartDynamicThread({testThreadStackSize, static_cast<uint8_t>(priority)}, waitThread,
+			std::ref(semaphore), 1, std::ref(sequenceAsserter), 2, std::ref(ret1));
+
+	sequenceAsserter.sequencePoint(0);
+	const auto postRet = semaphore.post(1);
+
+	thread0.join();
+	thread1.join();
+	sequenceAsserter.sequencePoint(3);
+
+	return postRet == 0 && ret0 == ETIMEDOUT && ret1 == 0 && semaphore.getValue() == 0 &&
+			sequenceAsserter.assertSequence(4) == true;
+}
+
+/**
+ * \brief Phase 4 of test case.
+ *
+ * Main thread blocks on semaphore requesting 3 units (with wait() and tryWaitFor()), another thread with the same
+ * priority releases 3 units. Main thread must be unblocked with all requested units.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase4()
+{
+	for (const auto timed : {false, true})
+	{
+		Semaphore semaphore {0};
+		SequenceAsserter sequenceAsserter;
+		int postRet {-1};
+
+		auto thread = makeAndStartDynamicThread({testThreadStackSize, ThisThread::getPriority()}, postThread,
+				std::ref(semaphore), 3, std::ref(sequenceAsserter), 1, std::ref(postRet));
+
+		sequenceAsserter.sequencePoint(0);
+		const auto ret = timed == false ? semaphore.wait(3) : semaphore.tryWaitFor(longDuration, 3);
+		sequenceAsserter.sequencePoint(2);
+
+		thread.join();
+
+		if (ret != 0 || postRet != 0 || semaphore.getValue() != 0 || sequenceAsserter.assertSequence(3) == false)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * \brief Phase 5 of test case.
+ *
+ * Main thread blocks on semaphore requesting 3 units (with wait() and tryWaitFor()), software timer releases 3 units
+ * from interrupt context at specified time point. Main thread must be unblocked with all requested units in the same
+ * moment.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase5()
+{
+	Semaphore semaphore {0};
+	int postRet {-1};
+	auto softwareTimer = makeStaticSoftwareTimer(
+			[&semaphore, &postRet]()
+			{
+				postRet = semaphore.post(3);
+			});
+
+	for (const auto timed : {false, true})
+	{
+		waitForNextTick();
+
+		postRet = -1;
+		const auto wakeUpTimePoint = TickClock::now() + longDuration;
+		softwareTimer.start(wakeUpTimePoint);
+
+		const auto ret = timed == false ? semaphore.wait(3) :
+				semaphore.tryWaitFor(wakeUpTimePoint - TickClock::now() + longDuration, 3);
+		const auto wokenUpTimePoint = TickClock::now();
+		if (ret != 0 || postRet != 0 || wakeUpTimePoint != wokenUpTimePoint || semaphore.getValue() != 0)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * \brief Phase 6 of test case.
+ *
+ * Thread with priority lower than main thread blocks on semaphore requesting 3 units, then main thread releases 2
+ * units. Software timer tries to acquire 1 unit from interrupt context while main thread is running - this must fail,
+ * as threads waiting for the semaphore are never overtaken in interrupt context, regardless of the priority of the
+ * interrupted thread. Main thread itself must acquire 1 unit, as the waiting thread has lower priority.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase6()
+{
+	Semaphore semaphore {0};
+	SequenceAsserter sequenceAsserter;
+	int ret {-1};
+	int tryWaitRet {-1};
+	auto softwareTimer = makeStaticSoftwareTimer(
+			[&semaphore, &tryWaitRet]()
+			{
+				tryWaitRet = semaphore.tryWait();
+			});
+
+	auto thread = makeAndStartDynamicThread({testThreadStackSize, static_cast<uint8_t>(ThisThread::getPriority() - 1)},
+			waitThread, std::ref(semaphore), 3, std::ref(sequenceAsserter), 1, std::ref(ret));
+
+	waitForNextTick();
+
+	const auto waitState = thread.getState();
+	const auto postRet = semaphore.post(2);
+
+	softwareTimer.start(singleDuration);
+	while (softwareTimer.isRunning() == true);	// main thread is running when the software timer is executed
+
+	const auto isrValue = semaphore.getValue();
+	const auto threadTryWaitRet = semaphore.tryWait();
+	const auto threadValue = semaphore.getValue();
+
+	sequenceAsserter.sequencePoint(0);
+	const auto finalPostRet = semaphore.post(2);
+	thread.join();
+	sequenceAsserter.sequencePoint(2);
+
+	return waitState == ThreadState::blockedOnSemaphore && postRet == 0 && tryWaitRet == EAGAIN && isrValue == 2 &&
+			threadTryWaitRet == 0 && threadValue == 1 && finalPostRet == 0 && ret == 0 && semaphore.getValue() == 0 &&
+			sequenceAsserter.assertSequence(3) == true;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool SemaphoreUnitsTestCase::run_() const
+{
+	for (const auto& function : {phase1, phase2, phase3, phase4, phase5, phase6})
+	{
+		const auto ret = function();
+		if (ret != true)
+			return ret;
+	}
+
+	return true;
+}
+
+}	// namespace test
+
+}	// namespace distortos
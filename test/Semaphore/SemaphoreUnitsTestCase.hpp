@@ -0,0 +1,50 @@
+/**
+ * \file
+ * \brief SemaphoreUnitsTestCase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEST_SEMAPHORE_SEMAPHOREUNITSTESTCASE_HPP_
+#define TEST_SEMAPHORE_SEMAPHOREUNITSTESTCASE_HPP_
+
+#include "TestCaseCommon.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+/**
+ * \brief Tests acquiring and releasing multiple units of semaphore at once.
+ *
+ * Tests validation of arguments and overflow detection, whether a waiter requesting more units than available is not
+ * overtaken by waiters requesting less, whether single post(Value) unblocks all satisfiable waiters and whether waiters
+ * are unblocked when the first waiter stops waiting due to timeout. Also tests whether a thread blocked on semaphore is
+ * unblocked when requested units are released by another thread or from interrupt context and whether waiters are
+ * never overtaken by tryWait() called from interrupt context.
+ */
+
+class SemaphoreUnitsTestCase : public TestCaseCommon
+{
+private:
+
+	/**
+	 * \brief Runs the test case.
+	 *
+	 * \return true if the test case succeeded, false otherwise
+	 */
+
+	bool run_() const override;
+};
+
+}	// namespace test
+
+}	// namespace distortos
+
+#endif	// TEST_SEMAPHORE_SEMAPHOREUNITSTESTCASE_HPP_
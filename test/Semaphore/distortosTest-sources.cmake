@@ -10,4 +10,5 @@
 target_sources(distortosTest PRIVATE
 		${CMAKE_CURRENT_LIST_DIR}/SemaphoreOperationsTestCase.cpp
 		${CMAKE_CURRENT_LIST_DIR}/SemaphorePriorityTestCase.cpp
-		${CMAKE_CURRENT_LIST_DIR}/semaphoreTestCases.cpp)
+		${CMAKE_CURRENT_LIST_DIR}/semaphoreTestCases.cpp
+		${CMAKE_CURRENT_LIST_DIR}/SemaphoreUnitsTestCase.cpp)
@@ -2,7 +2,7 @@
  * \file
  * \brief semaphoreTestCases object definition
  *
- * \author Copyright (C) 2014-2015 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2014-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -13,6 +13,7 @@
 
 #include "SemaphorePriorityTestCase.hpp"
 #include "SemaphoreOperationsTestCase.hpp"
+#include "SemaphoreUnitsTestCase.hpp"
 
 #include "TestCaseGroup.hpp"
 
@@ -36,11 +37,15 @@ const SemaphorePriorityTestCase priorityTestCase;
 /// SemaphoreOperationsTestCase instance
 const SemaphoreOperationsTestCase operationsTestCase;
 
+/// SemaphoreUnitsTestCase instance
+const SemaphoreUnitsTestCase unitsTestCase;
+
 /// array with references to TestCase objects related to semaphores
 const TestCaseGroup::Range::value_type semaphoreTestCases_[]
 {
 		TestCaseGroup::Range::value_type{priorityTestCase},
 		TestCaseGroup::Range::value_type{operationsTestCase},
+		TestCaseGroup::Range::value_type{unitsTestCase},
 };
 
 }	// namespace
@@ -0,0 +1,180 @@
+/**
+ * \file
+ * \brief LatestValueOperationsTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "LatestValueOperationsTestCase.hpp"
+
+#include "waitForNextTick.hpp"
+
+#include "distortos/LatestValue.hpp"
+#include "distortos/StaticSoftwareTimer.hpp"
+#include "distortos/statistics.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// type of value used in tests
+struct TestValue
+{
+	/// first field
+	uint32_t a;
+
+	/// second field
+	uint16_t b;
+
+	/// third field
+	uint8_t c;
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// single duration used in tests
+constexpr auto singleDuration = TickClock::duration{1};
+
+/// long duration used in tests
+constexpr auto longDuration = singleDuration * 10;
+
+/// expected number of context switches in block involving waiting (excluding waitForNextTick()): 1 - main thread
+/// blocks on LatestValue (main -> idle), 2 - main thread wakes up (idle -> main)
+constexpr decltype(statistics::getContextSwitchCount()) waitContextSwitchCount {2};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Checks whether two TestValue objects are equal.
+ *
+ * \param [in] left is a reference to first compared object
+ * \param [in] right is a reference to second compared object
+ *
+ * \return true if objects are equal, false otherwise
+ */
+
+bool equal(const TestValue& left, const TestValue& right)
+{
+	return left.a == right.a && left.b == right.b && left.c == right.c;
+}
+
+/**
+ * \brief Phase 1 of test case.
+ *
+ * Tests reading, writing and sequence numbers without blocking.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase1()
+{
+	constexpr TestValue initialValue {0x4e28d1b7, 0x93c4, 0x1f};
+	constexpr TestValue newValue {0x7b1f52e3, 0x2a61, 0xd8};
+	LatestValue<TestValue> latestValue {initialValue};
+
+	TestValue value {};
+	const auto sequence = latestValue.read(value);
+	if (sequence != 0 || equal(value, initialValue) == false || latestValue.getSequence() != sequence)
+		return false;
+
+	latestValue.write(newValue);
+	const auto newSequence = latestValue.read(value);
+	if (newSequence == sequence || (newSequence & 1) != 0 || equal(value, newValue) == false)
+		return false;
+
+	{
+		// new value is already available, so waiting for it should succeed immediately
+		waitForNextTick();
+		const auto start = TickClock::now();
+		const auto ret = latestValue.tryWaitUntil(start + longDuration, sequence);
+		if (ret != 0 || TickClock::now() != start)
+			return false;
+	}
+	{
+		// no new value after newSequence, so waiting for it should time out
+		waitForNextTick();
+		const auto contextSwitchCount = statistics::getContextSwitchCount();
+		const auto start = TickClock::now();
+		const auto ret = latestValue.tryWaitFor(singleDuration, newSequence);
+		const auto realDuration = TickClock::now() - start;
+		if (ret != ETIMEDOUT || realDuration != singleDuration + decltype(singleDuration){1} ||
+				statistics::getContextSwitchCount() - contextSwitchCount != waitContextSwitchCount)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * \brief Phase 2 of test case.
+ *
+ * Tests whether thread waiting for new value is unblocked by write from interrupt context (software timer).
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase2()
+{
+	constexpr TestValue newValue {0x3c9e07a5, 0x6d13, 0x72};
+	LatestValue<TestValue> latestValue;
+	auto softwareTimer = makeStaticSoftwareTimer(
+			[&latestValue, &newValue]()
+			{
+				latestValue.write(newValue);
+			});
+
+	waitForNextTick();
+
+	const auto contextSwitchCount = statistics::getContextSwitchCount();
+	const auto wakeUpTimePoint = TickClock::now() + longDuration;
+	softwareTimer.start(wakeUpTimePoint);
+
+	TestValue value;
+	const auto sequence = latestValue.read(value);
+	const auto ret = latestValue.wait(sequence);
+	const auto wokenUpTimePoint = TickClock::now();
+	return ret == 0 && wokenUpTimePoint == wakeUpTimePoint && latestValue.read(value) != sequence &&
+			equal(value, newValue) == true &&
+			statistics::getContextSwitchCount() - contextSwitchCount == waitContextSwitchCount;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool LatestValueOperationsTestCase::run_() const
+{
+	for (const auto& function : {phase1, phase2})
+	{
+		const auto ret = function();
+		if (ret != true)
+			return ret;
+	}
+
+	return true;
+}
+
+}	// namespace test
+
+}	// namespace distortos
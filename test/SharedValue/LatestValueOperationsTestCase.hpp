@@ -0,0 +1,47 @@
+/**
+ * \file
+ * \brief LatestValueOperationsTestCase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEST_SHAREDVALUE_LATESTVALUEOPERATIONSTESTCASE_HPP_
+#define TEST_SHAREDVALUE_LATESTVALUEOPERATIONSTESTCASE_HPP_
+
+#include "TestCaseCommon.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+/**
+ * \brief Tests various LatestValue operations.
+ *
+ * Tests reading, writing and sequence numbers, waiting for new value (wait(), tryWaitFor() and tryWaitUntil()) and
+ * waking up of waiting thread by write from interrupt context (software timer).
+ */
+
+class LatestValueOperationsTestCase : public TestCaseCommon
+{
+private:
+
+	/**
+	 * \brief Runs the test case.
+	 *
+	 * \return true if the test case succeeded, false otherwise
+	 */
+
+	bool run_() const override;
+};
+
+}	// namespace test
+
+}	// namespace distortos
+
+#endif	// TEST_SHAREDVALUE_LATESTVALUEOPERATIONSTESTCASE_HPP_
@@ -0,0 +1,163 @@
+/**
+ * \file
+ * \brief TripleBufferOperationsTestCase class implementation
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "TripleBufferOperationsTestCase.hpp"
+
+#include "waitForNextTick.hpp"
+
+#include "distortos/StaticSoftwareTimer.hpp"
+#include "distortos/statistics.hpp"
+#include "distortos/TripleBuffer.hpp"
+
+#include <cerrno>
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local constants
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// single duration used in tests
+constexpr auto singleDuration = TickClock::duration{1};
+
+/// long duration used in tests
+constexpr auto longDuration = singleDuration * 10;
+
+/// expected number of context switches in block involving waiting (excluding waitForNextTick()): 1 - main thread
+/// blocks on TripleBuffer (main -> idle), 2 - main thread wakes up (idle -> main)
+constexpr decltype(statistics::getContextSwitchCount()) waitContextSwitchCount {2};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// type of TripleBuffer used in tests
+using TestTripleBuffer = TripleBuffer<uint32_t>;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Phase 1 of test case.
+ *
+ * Tests publishing and taking of frames without blocking.
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase1()
+{
+	TestTripleBuffer tripleBuffer;
+
+	if (tripleBuffer.update() != false || tripleBuffer.getReadBuffer() != 0)
+		return false;
+
+	tripleBuffer.getWriteBuffer() = 0x5d0f83a2;
+	tripleBuffer.publish();
+	if (tripleBuffer.update() != true || tripleBuffer.getReadBuffer() != 0x5d0f83a2 || tripleBuffer.update() != false ||
+			tripleBuffer.getReadBuffer() != 0x5d0f83a2)
+		return false;
+
+	// frames which were not taken are replaced by newer ones
+	tripleBuffer.write(0x1b7e64c9);
+	tripleBuffer.write(0xe2493d07);
+	tripleBuffer.write(0x86ac15f4);
+	if (tripleBuffer.update() != true || tripleBuffer.getReadBuffer() != 0x86ac15f4 || tripleBuffer.update() != false)
+		return false;
+
+	// producer and consumer never use the same buffer
+	if (&tripleBuffer.getReadBuffer() == &tripleBuffer.getWriteBuffer())
+		return false;
+
+	{
+		// new frame is already available, so waiting for it should succeed immediately
+		tripleBuffer.write(0x3f92c6e1);
+		waitForNextTick();
+		const auto start = TickClock::now();
+		const auto ret = tripleBuffer.tryWaitUntil(start + longDuration);
+		if (ret != 0 || TickClock::now() != start || tripleBuffer.getReadBuffer() != 0x3f92c6e1)
+			return false;
+	}
+	{
+		// no new frame, so waiting for it should time out
+		waitForNextTick();
+		const auto contextSwitchCount = statistics::getContextSwitchCount();
+		const auto start = TickClock::now();
+		const auto ret = tripleBuffer.tryWaitFor(singleDuration);
+		const auto realDuration = TickClock::now() - start;
+		if (ret != ETIMEDOUT || realDuration != singleDuration + decltype(singleDuration){1} ||
+				tripleBuffer.getReadBuffer() != 0x3f92c6e1 ||
+				statistics::getContextSwitchCount() - contextSwitchCount != waitContextSwitchCount)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * \brief Phase 2 of test case.
+ *
+ * Tests whether thread waiting for new frame is unblocked by publish from interrupt context (software timer).
+ *
+ * \return true if test succeeded, false otherwise
+ */
+
+bool phase2()
+{
+	TestTripleBuffer tripleBuffer;
+	auto softwareTimer = makeStaticSoftwareTimer(
+			[&tripleBuffer]()
+			{
+				tripleBuffer.write(0xa4c8e039);
+			});
+
+	waitForNextTick();
+
+	const auto contextSwitchCount = statistics::getContextSwitchCount();
+	const auto wakeUpTimePoint = TickClock::now() + longDuration;
+	softwareTimer.start(wakeUpTimePoint);
+
+	const auto ret = tripleBuffer.wait();
+	const auto wokenUpTimePoint = TickClock::now();
+	return ret == 0 && wokenUpTimePoint == wakeUpTimePoint && tripleBuffer.getReadBuffer() == 0xa4c8e039 &&
+			tripleBuffer.update() == false &&
+			statistics::getContextSwitchCount() - contextSwitchCount == waitContextSwitchCount;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| private functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+bool TripleBufferOperationsTestCase::run_() const
+{
+	for (const auto& function : {phase1, phase2})
+	{
+		const auto ret = function();
+		if (ret != true)
+			return ret;
+	}
+
+	return true;
+}
+
+}	// namespace test
+
+}	// namespace distortos
@@ -0,0 +1,48 @@
+/**
+ * \file
+ * \brief TripleBufferOperationsTestCase class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef TEST_SHAREDVALUE_TRIPLEBUFFEROPERATIONSTESTCASE_HPP_
+#define TEST_SHAREDVALUE_TRIPLEBUFFEROPERATIONSTESTCASE_HPP_
+
+#include "TestCaseCommon.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+/**
+ * \brief Tests various TripleBuffer operations.
+ *
+ * Tests publishing and taking of frames (including replacement of frames which were not taken), waiting for new frame
+ * (wait(), tryWaitFor() and tryWaitUntil()) and waking up of waiting thread by publish from interrupt context (software
+ * timer).
+ */
+
+class TripleBufferOperationsTestCase : public TestCaseCommon
+{
+private:
+
+	/**
+	 * \brief Runs the test case.
+	 *
+	 * \return true if the test case succeeded, false otherwise
+	 */
+
+	bool run_() const override;
+};
+
+}	// namespace test
+
+}	// namespace distortos
+
+#endif	// TEST_SHAREDVALUE_TRIPLEBUFFEROPERATIONSTESTCASE_HPP_
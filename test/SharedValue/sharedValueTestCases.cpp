@@ -0,0 +1,55 @@
+/**
+ * \file
+ * \brief sharedValueTestCases object definition
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "sharedValueTestCases.hpp"
+
+#include "LatestValueOperationsTestCase.hpp"
+#include "TripleBufferOperationsTestCase.hpp"
+
+#include "TestCaseGroup.hpp"
+
+namespace distortos
+{
+
+namespace test
+{
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// LatestValueOperationsTestCase instance
+const LatestValueOperationsTestCase latestValueOperationsTestCase;
+
+/// TripleBufferOperationsTestCase instance
+const TripleBufferOperationsTestCase tripleBufferOperationsTestCase;
+
+/// array with references to TestCase objects related to LatestValue and TripleBuffer
+const TestCaseGroup::Range::value_type sharedValueTestCases_[]
+{
+		TestCaseGroup::Range::value_type{latestValueOperationsTestCase},
+		TestCaseGroup::Range::value_type{tripleBufferOperationsTestCase},
+};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+const TestCaseGroup sharedValueTestCases {TestCaseGroup::Range{sharedValueTestCases_}};
+
+}	// namespace test
+
+}	// namespace distortos
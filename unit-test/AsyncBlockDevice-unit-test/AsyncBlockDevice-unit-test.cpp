@@ -0,0 +1,442 @@
+/**
+ * \file
+ * \brief AsyncBlockDevice and IoCompletionQueue test cases
+ *
+ * This test checks whether IoCompletionQueue returns requests in the order of their completion, whether
+ * AsyncBlockDevice completes requests with results of operations of underlying device (including partial transfers),
+ * whether it rejects concurrent requests with EBUSY and whether requests can be cancelled only before the worker thread
+ * takes them.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/io/IoCompletionQueue.hpp"
+
+#include "distortos/devices/memory/AsyncBlockDevice.hpp"
+
+#include "RamBlockDevice.hpp"
+#include "unit-test-common.hpp"
+
+#include <atomic>
+#include <thread>
+
+using distortos::devices::AsyncBlockDevice;
+using distortos::devices::IoCompletionQueue;
+using distortos::devices::IoRequest;
+using distortos::TickClock;
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// TestRamBlockDevice class is a RamBlockDevice in which read operations can be held until they are released
+class TestRamBlockDevice : public distortos::RamBlockDevice
+{
+public:
+
+	using RamBlockDevice::RamBlockDevice;
+
+	/**
+	 * \brief Holds all following read operations until releaseReads() is called.
+	 */
+
+	void holdReads()
+	{
+		readEntered_ = false;
+		holdReads_ = true;
+	}
+
+	std::pair<int, size_t> read(const uint64_t address, void* const buffer, const size_t size) override
+	{
+		readEntered_ = true;
+		while (holdReads_ == true)
+			std::this_thread::yield();
+
+		return RamBlockDevice::read(address, buffer, size);
+	}
+
+	/**
+	 * \brief Releases read operations held after holdReads().
+	 */
+
+	void releaseReads()
+	{
+		holdReads_ = false;
+	}
+
+	/**
+	 * \brief Waits until read operation is started by the worker thread.
+	 */
+
+	void waitForRead() const
+	{
+		while (readEntered_ == false)
+			std::this_thread::yield();
+	}
+
+private:
+
+	/// true if read operations are held, false otherwise
+	std::atomic<bool> holdReads_ {};
+
+	/// true if read operation was started, false otherwise
+	std::atomic<bool> readEntered_ {};
+};
+
+/// TestAsyncBlockDevice class is an AsyncBlockDevice with worker thread running on host
+class TestAsyncBlockDevice : public AsyncBlockDevice
+{
+public:
+
+	/**
+	 * \brief TestAsyncBlockDevice's constructor
+	 *
+	 * \param [in] blockDevice is a reference to underlying block device
+	 * \param [in] workerEnabled selects whether the worker thread is started with the first operation (true) or only
+	 * with enableWorker() (false)
+	 */
+
+	TestAsyncBlockDevice(TestRamBlockDevice& blockDevice, const bool workerEnabled) :
+			AsyncBlockDevice{blockDevice},
+			workerThread_{},
+			blockDevice_{blockDevice},
+			startWorkerRet_{},
+			workerEnabled_{workerEnabled}
+	{
+
+	}
+
+	/**
+	 * \brief TestAsyncBlockDevice's destructor
+	 *
+	 * Releases held read operations (in case the test failed), terminates worker thread (if it was started) and waits
+	 * for it to exit.
+	 */
+
+	~TestAsyncBlockDevice() override
+	{
+		if (workerThread_.joinable() == false)
+			return;
+
+		blockDevice_.releaseReads();
+		requestWorkerExit();
+		workerThread_.join();
+	}
+
+	/**
+	 * \brief Enables and starts worker thread.
+	 */
+
+	void enableWorker()
+	{
+		workerEnabled_ = true;
+		REQUIRE(startWorker() == 0);
+	}
+
+	/**
+	 * \param [in] ret is the value which will be returned by startWorker()
+	 */
+
+	void setStartWorkerRet(const int ret)
+	{
+		startWorkerRet_ = ret;
+	}
+
+protected:
+
+	int startWorker() override
+	{
+		if (startWorkerRet_ != 0)
+			return startWorkerRet_;
+
+		if (workerEnabled_ == true && workerThread_.joinable() == false)
+			workerThread_ = std::thread{&AsyncBlockDevice::runWorker, this};
+		return 0;
+	}
+
+private:
+
+	/// worker thread
+	std::thread workerThread_;
+
+	/// reference to underlying block device
+	TestRamBlockDevice& blockDevice_;
+
+	/// value returned by startWorker()
+	int startWorkerRet_;
+
+	/// true if worker thread may be started, false otherwise
+	bool workerEnabled_;
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// erase block size of underlying devices, bytes
+constexpr size_t eraseBlockSize {16};
+
+/// number of erase blocks of underlying devices
+constexpr size_t eraseBlocksCount {4};
+
+/// program block size of underlying devices, bytes
+constexpr size_t programBlockSize {4};
+
+/// number of calls of testCallback()
+size_t callbackCount;
+
+/// pointer to request passed to the last call of testCallback()
+IoRequest* callbackRequest;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Callback of IoRequest which records its call.
+ *
+ * \param [in] request is a reference to completed request
+ */
+
+void testCallback(IoRequest& request)
+{
+	REQUIRE(request.isPending() == false);
+	++callbackCount;
+	callbackRequest = &request;
+}
+
+/**
+ * \brief Pops request from completion queue, waiting for it if needed.
+ *
+ * \param [in] completionQueue is a reference to IoCompletionQueue from which the request will be popped
+ *
+ * \return pointer to popped request
+ */
+
+IoRequest* popRequest(IoCompletionQueue& completionQueue)
+{
+	IoRequest* request {};
+	REQUIRE(completionQueue.pop(request) == 0);
+	REQUIRE(request != nullptr);
+	return request;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing order of IoCompletionQueue", "[queue]")
+{
+	IoCompletionQueue completionQueue;
+	IoRequest request0 {completionQueue};
+	IoRequest request1 {completionQueue};
+	IoRequest request2 {completionQueue};
+	IoRequest* request {};
+
+	REQUIRE(completionQueue.tryPop(request) == EAGAIN);
+	REQUIRE(completionQueue.tryPopFor(std::chrono::milliseconds{1}, request) == ETIMEDOUT);
+
+	for (const auto pendingRequest : {&request0, &request1, &request2})
+	{
+		REQUIRE(pendingRequest->begin() == 0);
+		REQUIRE(pendingRequest->isPending() == true);
+		REQUIRE(pendingRequest->begin() == EBUSY);
+	}
+
+	request1.complete(0, 10);
+	request2.complete(EIO, 3);
+	request0.complete(ECANCELED, 0);
+
+	for (const auto completedRequest : {&request0, &request1, &request2})
+	{
+		REQUIRE(completedRequest->isPending() == false);
+		// request which was not popped from its queue cannot be started again
+		REQUIRE(completedRequest->begin() == EBUSY);
+	}
+
+	REQUIRE(completionQueue.tryPop(request) == 0);
+	REQUIRE(request == &request1);
+	REQUIRE(request1.getResult() == std::make_pair(0, size_t{10}));
+	REQUIRE(completionQueue.tryPopFor(std::chrono::milliseconds{1}, request) == 0);
+	REQUIRE(request == &request2);
+	REQUIRE(request2.getResult() == std::make_pair(EIO, size_t{3}));
+	REQUIRE(completionQueue.pop(request) == 0);
+	REQUIRE(request == &request0);
+	REQUIRE(request0.getResult() == std::make_pair(ECANCELED, size_t{}));
+
+	{
+		const TickClock tickClock;
+		ALLOW_CALL(tickClock, nowMock()).RETURN(TickClock::time_point{TickClock::duration{10}});
+		REQUIRE(completionQueue.tryPopUntil(TickClock::time_point{TickClock::duration{5}}, request) == ETIMEDOUT);
+	}
+
+	REQUIRE(request0.begin() == 0);
+	request0.abort();
+	REQUIRE(request0.isPending() == false);
+	REQUIRE(completionQueue.tryPop(request) == EAGAIN);
+}
+
+TEST_CASE("Testing IoRequest with callback", "[callback]")
+{
+	IoRequest request {testCallback};
+	callbackCount = {};
+	callbackRequest = {};
+
+	REQUIRE(request.begin() == 0);
+	REQUIRE(callbackCount == 0);
+	request.complete(0, 7);
+	REQUIRE(callbackCount == 1);
+	REQUIRE(callbackRequest == &request);
+	REQUIRE(request.getResult() == std::make_pair(0, size_t{7}));
+	// request with callback is not linked anywhere, so it can be started again immediately
+	REQUIRE(request.begin() == 0);
+	request.abort();
+}
+
+TEST_CASE("Testing AsyncBlockDevice", "[async]")
+{
+	TestRamBlockDevice blockDevice {eraseBlockSize, eraseBlocksCount, programBlockSize};
+	REQUIRE(blockDevice.open() == 0);
+	IoCompletionQueue completionQueue;
+	IoRequest request {completionQueue};
+	IoRequest otherRequest {completionQueue};
+	uint8_t buffer[eraseBlockSize];
+
+	SECTION("Operations are completed with results of underlying device")
+	{
+		TestAsyncBlockDevice asyncBlockDevice {blockDevice, true};
+
+		for (size_t i {}; i < sizeof(buffer); ++i)
+			buffer[i] = i;
+		REQUIRE(asyncBlockDevice.startProgram(request, 0, buffer, 8) == 0);
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(0, size_t{8}));
+
+		uint8_t readBuffer[8] {};
+		REQUIRE(asyncBlockDevice.startRead(request, 0, readBuffer, sizeof(readBuffer)) == 0);
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(0, sizeof(readBuffer)));
+		REQUIRE(memcmp(readBuffer, buffer, sizeof(readBuffer)) == 0);
+
+		// partial program - simulated power failure after 6 bytes
+		blockDevice.setProgramBudget(6);
+		REQUIRE(asyncBlockDevice.startProgram(request, eraseBlockSize, buffer, 8) == 0);
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(EIO, size_t{6}));
+		blockDevice.setProgramBudget(SIZE_MAX);
+
+		REQUIRE(asyncBlockDevice.startRead(request, eraseBlockSize * eraseBlocksCount, buffer, 8) == 0);
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(ENOSPC, size_t{}));
+
+		REQUIRE(asyncBlockDevice.startErase(request, 0, eraseBlockSize) == 0);
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(0, size_t{}));
+		REQUIRE(blockDevice.getEraseCount(0) == 1);
+		REQUIRE(blockDevice.getMemory()[0] == uint8_t{distortos::RamBlockDevice::erasedValue});
+
+		REQUIRE(asyncBlockDevice.startTrim(request, 0, eraseBlockSize + 1) == 0);
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(EINVAL, size_t{}));
+
+		REQUIRE(asyncBlockDevice.startSynchronize(request) == 0);
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(0, size_t{}));
+	}
+	SECTION("Requests of several devices are popped in the order of completion")
+	{
+		TestRamBlockDevice otherBlockDevice {eraseBlockSize, eraseBlocksCount, programBlockSize};
+		REQUIRE(otherBlockDevice.open() == 0);
+		TestAsyncBlockDevice asyncBlockDevice {blockDevice, true};
+		TestAsyncBlockDevice otherAsyncBlockDevice {otherBlockDevice, true};
+
+		blockDevice.holdReads();
+		REQUIRE(asyncBlockDevice.startRead(request, 0, buffer, sizeof(buffer)) == 0);
+		blockDevice.waitForRead();
+		REQUIRE(otherAsyncBlockDevice.startProgram(otherRequest, 0, buffer, programBlockSize) == 0);
+		REQUIRE(popRequest(completionQueue) == &otherRequest);
+		REQUIRE(otherRequest.getResult() == std::make_pair(0, programBlockSize));
+		REQUIRE(request.isPending() == true);
+
+		blockDevice.releaseReads();
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(0, sizeof(buffer)));
+		REQUIRE(otherBlockDevice.close() == 0);
+	}
+	SECTION("Only one request may be pending and it cannot be cancelled while it is executed")
+	{
+		TestRamBlockDevice otherBlockDevice {eraseBlockSize, eraseBlocksCount, programBlockSize};
+		REQUIRE(otherBlockDevice.open() == 0);
+		TestAsyncBlockDevice asyncBlockDevice {blockDevice, true};
+		TestAsyncBlockDevice otherAsyncBlockDevice {otherBlockDevice, true};
+
+		blockDevice.holdReads();
+		REQUIRE(asyncBlockDevice.startRead(request, 0, buffer, sizeof(buffer)) == 0);
+		blockDevice.waitForRead();
+
+		REQUIRE(asyncBlockDevice.startProgram(otherRequest, 0, buffer, programBlockSize) == EBUSY);
+		REQUIRE(otherRequest.isPending() == false);
+		REQUIRE(otherAsyncBlockDevice.startRead(request, 0, buffer, sizeof(buffer)) == EBUSY);
+		REQUIRE(asyncBlockDevice.cancel(otherRequest) == EINVAL);
+		REQUIRE(otherAsyncBlockDevice.cancel(request) == EINVAL);
+		REQUIRE(asyncBlockDevice.cancel(request) == EBUSY);
+		REQUIRE(request.isPending() == true);
+
+		blockDevice.releaseReads();
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(0, sizeof(buffer)));
+		REQUIRE(asyncBlockDevice.cancel(request) == EINVAL);
+		IoRequest* poppedRequest {};
+		REQUIRE(completionQueue.tryPop(poppedRequest) == EAGAIN);
+		REQUIRE(otherBlockDevice.getReadCount() == 0);
+		REQUIRE(otherBlockDevice.close() == 0);
+	}
+	SECTION("Request cancelled before it is taken by worker thread is not executed")
+	{
+		TestAsyncBlockDevice asyncBlockDevice {blockDevice, false};
+
+		REQUIRE(asyncBlockDevice.startRead(request, 0, buffer, sizeof(buffer)) == 0);
+		REQUIRE(request.isPending() == true);
+		REQUIRE(asyncBlockDevice.startRead(otherRequest, 0, buffer, sizeof(buffer)) == EBUSY);
+		REQUIRE(asyncBlockDevice.cancel(request) == 0);
+		REQUIRE(request.isPending() == false);
+		REQUIRE(asyncBlockDevice.cancel(request) == EINVAL);
+		IoRequest* poppedRequest {};
+		REQUIRE(completionQueue.tryPop(poppedRequest) == 0);
+		REQUIRE(poppedRequest == &request);
+		REQUIRE(request.getResult() == std::make_pair(ECANCELED, size_t{}));
+
+		asyncBlockDevice.enableWorker();
+		REQUIRE(asyncBlockDevice.startRead(otherRequest, 0, buffer, 8) == 0);
+		REQUIRE(popRequest(completionQueue) == &otherRequest);
+		REQUIRE(otherRequest.getResult() == std::make_pair(0, size_t{8}));
+		// cancelled request was skipped by worker thread
+		REQUIRE(blockDevice.getReadCount() == 1);
+	}
+	SECTION("Failure to start worker thread is reported")
+	{
+		TestAsyncBlockDevice asyncBlockDevice {blockDevice, true};
+
+		asyncBlockDevice.setStartWorkerRet(EAGAIN);
+		REQUIRE(asyncBlockDevice.startSynchronize(request) == EAGAIN);
+		REQUIRE(request.isPending() == false);
+		IoRequest* poppedRequest {};
+		REQUIRE(completionQueue.tryPop(poppedRequest) == EAGAIN);
+
+		asyncBlockDevice.setStartWorkerRet(0);
+		REQUIRE(asyncBlockDevice.startSynchronize(request) == 0);
+		REQUIRE(popRequest(completionQueue) == &request);
+		REQUIRE(request.getResult() == std::make_pair(0, size_t{}));
+	}
+
+	REQUIRE(blockDevice.close() == 0);
+}
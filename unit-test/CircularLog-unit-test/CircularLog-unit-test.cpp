@@ -0,0 +1,315 @@
+/**
+ * \file
+ * \brief CircularLog test cases
+ *
+ * This test checks whether CircularLog properly stores records on a block device, wraps around, recovers state during
+ * mount and ignores records interrupted by power failure.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/storage/CircularLog.hpp"
+
+#include "RamBlockDevice.hpp"
+#include "unit-test-common.hpp"
+
+#include <array>
+#include <chrono>
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// size of sector, bytes
+constexpr size_t sectorSize {256};
+
+/// number of sectors
+constexpr size_t sectorsCount {4};
+
+/// program block size, bytes
+constexpr size_t programBlockSize {8};
+
+/// size of record used for tests of wrapping, two such records fit in one sector
+constexpr size_t bigRecordSize {100};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Fills buffer with pattern unique for given record.
+ *
+ * \param [in] index is the index of record
+ * \param [out] buffer is the buffer which will be filled
+ * \param [in] size is the size of \a buffer, bytes
+ */
+
+void fillRecord(const size_t index, uint8_t* const buffer, const size_t size)
+{
+	for (size_t i {}; i < size; ++i)
+		buffer[i] = index * 7 + i;
+}
+
+/**
+ * \brief Reads next record and checks whether it matches the pattern of given record.
+ *
+ * \param [in] circularLog is a reference to tested CircularLog object
+ * \param [in,out] cursor is a reference to cursor used for reading
+ * \param [in] index is the index of expected record
+ * \param [in] size is the expected size of record, bytes
+ */
+
+void checkRecord(distortos::CircularLog& circularLog, distortos::CircularLog::Cursor& cursor, const size_t index,
+		const size_t size)
+{
+	std::array<uint8_t, sectorSize> expected;
+	fillRecord(index, expected.data(), size);
+	std::array<uint8_t, sectorSize> buffer;
+	const auto ret = circularLog.read(cursor, buffer.data(), buffer.size());
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == size);
+	REQUIRE(cursor.getRecordSequence() == index);
+	REQUIRE(memcmp(buffer.data(), expected.data(), size) == 0);
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing mount of empty and invalid block device", "[mount]")
+{
+	distortos::RamBlockDevice blockDevice {sectorSize, sectorsCount, programBlockSize};
+	std::array<uint8_t, 32> buffer;
+	distortos::CircularLog circularLog {blockDevice, buffer.data(), buffer.size()};
+
+	REQUIRE(circularLog.getMaxRecordSize() == 0);
+	REQUIRE(circularLog.append(buffer.data(), 1) == EBADF);
+
+	SECTION("Erased block device is an empty log")
+	{
+		REQUIRE(circularLog.mount() == 0);
+		REQUIRE(circularLog.mount() == EBUSY);
+		REQUIRE(circularLog.format() == EBUSY);
+		REQUIRE(circularLog.getMaxRecordSize() == sectorSize - 32);
+
+		auto tail = circularLog.getTail();
+		REQUIRE(tail.first == 0);
+		REQUIRE(circularLog.read(tail.second, buffer.data(), buffer.size()).first == ENODATA);
+		REQUIRE(circularLog.unmount() == 0);
+		REQUIRE(circularLog.unmount() == EBADF);
+	}
+	SECTION("Block device with unrelated contents is rejected")
+	{
+		blockDevice.getMemory()[3] = 0x5a;
+		REQUIRE(circularLog.mount() == EILSEQ);
+		REQUIRE(circularLog.format() == 0);
+		REQUIRE(circularLog.mount() == 0);
+	}
+	SECTION("Invalid buffer size is rejected")
+	{
+		distortos::CircularLog badCircularLog {blockDevice, buffer.data(), 12};
+		REQUIRE(badCircularLog.mount() == EINVAL);
+	}
+}
+
+TEST_CASE("Testing append and read", "[append]")
+{
+	distortos::RamBlockDevice blockDevice {sectorSize, sectorsCount, programBlockSize};
+	std::array<uint8_t, 32> buffer;
+	distortos::CircularLog circularLog {blockDevice, buffer.data(), buffer.size()};
+	REQUIRE(circularLog.mount() == 0);
+
+	std::array<uint8_t, sectorSize> record;
+	REQUIRE(circularLog.append(record.data(), 0) == EINVAL);
+	REQUIRE(circularLog.append(nullptr, 1) == EINVAL);
+	REQUIRE(circularLog.append(record.data(), circularLog.getMaxRecordSize() + 1) == EMSGSIZE);
+
+	constexpr size_t recordsCount {20};
+	const auto head = circularLog.getHead();
+	REQUIRE(head.first == 0);
+	for (size_t i {}; i < recordsCount; ++i)
+	{
+		fillRecord(i, record.data(), i + 1);
+		REQUIRE(circularLog.append(record.data(), i + 1) == 0);
+	}
+
+	// cursor obtained from empty log sees all records
+	auto cursor = head.second;
+	for (size_t i {}; i < recordsCount; ++i)
+		checkRecord(circularLog, cursor, i, i + 1);
+	REQUIRE(circularLog.read(cursor, record.data(), record.size()).first == ENODATA);
+
+	// cursor at the end sees new records
+	fillRecord(recordsCount, record.data(), 3);
+	REQUIRE(circularLog.append(record.data(), 3) == 0);
+	checkRecord(circularLog, cursor, recordsCount, 3);
+
+	SECTION("Too small buffer doesn't advance the cursor")
+	{
+		fillRecord(recordsCount + 1, record.data(), 50);
+		REQUIRE(circularLog.append(record.data(), 50) == 0);
+		const auto ret = circularLog.read(cursor, record.data(), 49);
+		REQUIRE(ret.first == EMSGSIZE);
+		REQUIRE(ret.second == 50);
+		checkRecord(circularLog, cursor, recordsCount + 1, 50);
+	}
+	SECTION("Records survive remount")
+	{
+		REQUIRE(circularLog.unmount() == 0);
+		REQUIRE(circularLog.mount() == 0);
+
+		fillRecord(recordsCount + 1, record.data(), 5);
+		REQUIRE(circularLog.append(record.data(), 5) == 0);
+
+		auto tail = circularLog.getTail();
+		REQUIRE(tail.first == 0);
+		for (size_t i {}; i <= recordsCount; ++i)
+			checkRecord(circularLog, tail.second, i, i < recordsCount ? i + 1 : 3);
+		checkRecord(circularLog, tail.second, recordsCount + 1, 5);
+		REQUIRE(circularLog.read(tail.second, record.data(), record.size()).first == ENODATA);
+	}
+}
+
+TEST_CASE("Testing wrap around", "[wrap]")
+{
+	distortos::RamBlockDevice blockDevice {sectorSize, sectorsCount, programBlockSize};
+	std::array<uint8_t, 32> buffer;
+	distortos::CircularLog circularLog {blockDevice, buffer.data(), buffer.size()};
+	REQUIRE(circularLog.mount() == 0);
+
+	auto oldCursor = circularLog.getTail().second;
+
+	std::array<uint8_t, bigRecordSize> record;
+	constexpr size_t recordsCount {41};
+	for (size_t i {}; i < recordsCount; ++i)
+	{
+		fillRecord(i, record.data(), record.size());
+		REQUIRE(circularLog.append(record.data(), record.size()) == 0);
+	}
+
+	// 41 records in 21 sectors - 3 full sectors and the newest one with 1 record remain
+	constexpr size_t firstRemainingRecord {recordsCount - 7};
+
+	REQUIRE(circularLog.read(oldCursor, record.data(), record.size()).first == EOVERFLOW);
+	for (size_t i {firstRemainingRecord}; i < recordsCount; ++i)
+		checkRecord(circularLog, oldCursor, i, record.size());
+	REQUIRE(circularLog.read(oldCursor, record.data(), record.size()).first == ENODATA);
+
+	for (size_t remount {}; remount < sectorsCount * 2; ++remount)
+	{
+		REQUIRE(circularLog.unmount() == 0);
+		REQUIRE(circularLog.mount() == 0);
+
+		const auto first = firstRemainingRecord + remount * 2;
+		auto tail = circularLog.getTail().second;
+		for (size_t i {first}; i < recordsCount + remount * 2; ++i)
+			checkRecord(circularLog, tail, i, record.size());
+		REQUIRE(circularLog.read(tail, record.data(), record.size()).first == ENODATA);
+
+		for (size_t i {}; i < 2; ++i)
+		{
+			fillRecord(recordsCount + remount * 2 + i, record.data(), record.size());
+			REQUIRE(circularLog.append(record.data(), record.size()) == 0);
+		}
+	}
+}
+
+TEST_CASE("Testing power failure during append", "[power-failure]")
+{
+	distortos::RamBlockDevice blockDevice {sectorSize, sectorsCount, programBlockSize};
+	std::array<uint8_t, 32> buffer;
+	constexpr size_t recordSize {60};
+	std::array<uint8_t, recordSize> record;
+	std::array<uint8_t, sectorSize> readBuffer;
+
+	// last append is interrupted at every possible byte, 6th record fills the first two sectors, 7th opens new one
+	for (size_t appendsCount {6}; appendsCount <= 7; ++appendsCount)
+		for (size_t budget {}; budget <= 96; ++budget)
+		{
+			{
+				distortos::CircularLog circularLog {blockDevice, buffer.data(), buffer.size()};
+				REQUIRE(circularLog.format() == 0);
+				REQUIRE(circularLog.mount() == 0);
+				for (size_t i {}; i < appendsCount; ++i)
+				{
+					if (i == appendsCount - 1)
+						blockDevice.setProgramBudget(budget);
+					fillRecord(i, record.data(), record.size());
+					circularLog.append(record.data(), record.size());
+				}
+				blockDevice.setProgramBudget(SIZE_MAX);
+			}
+
+			distortos::CircularLog circularLog {blockDevice, buffer.data(), buffer.size()};
+			REQUIRE(circularLog.mount() == 0);
+
+			// interrupted record is either complete or absent, the log remains usable
+			fillRecord(appendsCount, record.data(), record.size());
+			REQUIRE(circularLog.append(record.data(), record.size()) == 0);
+
+			auto tail = circularLog.getTail().second;
+			for (size_t i {}; i < appendsCount - 1; ++i)
+				checkRecord(circularLog, tail, i, record.size());
+
+			auto sequence = appendsCount - 1;
+			REQUIRE(circularLog.read(tail, readBuffer.data(), readBuffer.size()).first == 0);
+			fillRecord(appendsCount - 1, record.data(), record.size());
+			if (memcmp(readBuffer.data(), record.data(), record.size()) == 0)	// interrupted record is complete?
+			{
+				REQUIRE(tail.getRecordSequence() == sequence);
+				++sequence;
+				REQUIRE(circularLog.read(tail, readBuffer.data(), readBuffer.size()).first == 0);
+			}
+			fillRecord(appendsCount, record.data(), record.size());
+			REQUIRE(memcmp(readBuffer.data(), record.data(), record.size()) == 0);
+			REQUIRE(tail.getRecordSequence() == sequence);
+			REQUIRE(circularLog.read(tail, readBuffer.data(), readBuffer.size()).first == ENODATA);
+		}
+}
+
+TEST_CASE("Benchmark of append compared with raw program", "[.benchmark]")
+{
+	constexpr size_t benchmarkSectorSize {4096};
+	constexpr size_t benchmarkRecordSize {64};
+	constexpr size_t iterations {1000000};
+
+	distortos::RamBlockDevice blockDevice {benchmarkSectorSize, sectorsCount, programBlockSize};
+	std::array<uint8_t, 64> buffer;
+	std::array<uint8_t, benchmarkRecordSize> record {};
+
+	const auto rawStart = std::chrono::steady_clock::now();
+	{
+		REQUIRE(blockDevice.open() == 0);
+		uint64_t address {};
+		for (size_t i {}; i < iterations; ++i)
+		{
+			if (address % benchmarkSectorSize == 0)
+				blockDevice.erase(address, benchmarkSectorSize);
+			blockDevice.program(address, record.data(), record.size());
+			address = (address + record.size()) % blockDevice.getSize();
+		}
+		REQUIRE(blockDevice.close() == 0);
+	}
+	const auto rawDuration = std::chrono::steady_clock::now() - rawStart;
+
+	distortos::CircularLog circularLog {blockDevice, buffer.data(), buffer.size()};
+	REQUIRE(circularLog.format() == 0);
+	REQUIRE(circularLog.mount() == 0);
+	const auto logStart = std::chrono::steady_clock::now();
+	for (size_t i {}; i < iterations; ++i)
+		REQUIRE(circularLog.append(record.data(), record.size()) == 0);
+	const auto logDuration = std::chrono::steady_clock::now() - logStart;
+
+	using Nanoseconds = std::chrono::duration<double, std::nano>;
+	WARN("raw program: " << Nanoseconds{rawDuration}.count() / iterations << " ns per record, CircularLog::append(): " <<
+			Nanoseconds{logDuration}.count() / iterations << " ns per record");
+}
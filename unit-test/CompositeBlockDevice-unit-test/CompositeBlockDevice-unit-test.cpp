@@ -0,0 +1,308 @@
+/**
+ * \file
+ * \brief CompositeBlockDevice test cases
+ *
+ * This test checks whether CompositeBlockDevice properly maps ranges to underlying devices in striped and mirrored
+ * modes, involves only the members which take part in an operation and aggregates errors of members.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/memory/CompositeBlockDevice.hpp"
+#include "distortos/devices/memory/CompositeBlockDeviceMember.hpp"
+
+#include "RamBlockDevice.hpp"
+#include "unit-test-common.hpp"
+
+#include <array>
+
+using distortos::devices::CompositeBlockDevice;
+using distortos::devices::CompositeBlockDeviceMember;
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// erase block size of underlying devices, bytes, also size of stripe
+constexpr size_t eraseBlockSize {16};
+
+/// number of erase blocks of underlying devices
+constexpr size_t eraseBlocksCount {4};
+
+/// program block size of underlying devices, bytes
+constexpr size_t programBlockSize {4};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Fills buffer with a pattern which depends on address in composite device.
+ *
+ * \param [in] address is the address of \a buffer in composite device
+ * \param [out] buffer is the buffer which will be filled
+ * \param [in] size is the size of \a buffer, bytes
+ */
+
+void fillPattern(const uint64_t address, uint8_t* const buffer, const size_t size)
+{
+	for (size_t i {}; i < size; ++i)
+		buffer[i] = address + i;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing striped mapping", "[striped]")
+{
+	std::array<distortos::RamBlockDevice, 3> blockDevices
+	{{
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+	}};
+	CompositeBlockDeviceMember member0 {blockDevices[0]};
+	CompositeBlockDeviceMember member1 {blockDevices[1]};
+	CompositeBlockDeviceMember member2 {blockDevices[2]};
+	CompositeBlockDeviceMember* const members[] {&member0, &member1, &member2};
+	CompositeBlockDevice compositeBlockDevice {CompositeBlockDevice::Mode::striped,
+			CompositeBlockDevice::MembersRange{members}};
+
+	REQUIRE(compositeBlockDevice.open() == 0);
+	REQUIRE(compositeBlockDevice.getSize() == blockDevices.size() * eraseBlockSize * eraseBlocksCount);
+	REQUIRE(compositeBlockDevice.getEraseBlockSize() == eraseBlockSize);
+	REQUIRE(compositeBlockDevice.getProgramBlockSize() == programBlockSize);
+
+	// range starts in the middle of stripe 1 (member 1) and ends in the middle of stripe 3 (member 0)
+	constexpr uint64_t address {eraseBlockSize + 4};
+	std::array<uint8_t, 2 * eraseBlockSize + 8> buffer;
+	fillPattern(address, buffer.data(), buffer.size());
+	const auto ret = compositeBlockDevice.program(address, buffer.data(), buffer.size());
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == buffer.size());
+
+	// stripe N is stored in member N % 3 at address N / 3 * stripe size
+	std::array<std::vector<uint8_t>, 3> expectedMemories;
+	for (auto& expectedMemory : expectedMemories)
+		expectedMemory.assign(eraseBlockSize * eraseBlocksCount, uint8_t{distortos::RamBlockDevice::erasedValue});
+	for (size_t i {}; i < buffer.size(); ++i)
+	{
+		const auto stripe = (address + i) / eraseBlockSize;
+		expectedMemories[stripe % 3][stripe / 3 * eraseBlockSize + (address + i) % eraseBlockSize] = buffer[i];
+	}
+	for (size_t i {}; i < blockDevices.size(); ++i)
+	{
+		INFO("member: " << i);
+		REQUIRE(blockDevices[i].getMemory() == expectedMemories[i]);
+	}
+	REQUIRE(blockDevices[0].getMemory()[eraseBlockSize] == address + 2 * eraseBlockSize - 4);
+	REQUIRE(blockDevices[1].getMemory()[4] == address);
+	REQUIRE(blockDevices[2].getMemory()[0] == address + eraseBlockSize - 4);
+
+	// the whole device is read back in one operation, spanning all stripes
+	std::array<uint8_t, 3 * eraseBlockSize * eraseBlocksCount> readBuffer;
+	const auto readRet = compositeBlockDevice.read(0, readBuffer.data(), readBuffer.size());
+	REQUIRE(readRet.first == 0);
+	REQUIRE(readRet.second == readBuffer.size());
+	REQUIRE(std::equal(buffer.begin(), buffer.end(), readBuffer.begin() + address) == true);
+	REQUIRE(readBuffer[address - 1] == uint8_t{distortos::RamBlockDevice::erasedValue});
+	REQUIRE(readBuffer[address + buffer.size()] == uint8_t{distortos::RamBlockDevice::erasedValue});
+
+	REQUIRE(compositeBlockDevice.close() == 0);
+}
+
+TEST_CASE("Testing striped operations spanning fewer stripes than members", "[striped]")
+{
+	std::array<distortos::RamBlockDevice, 3> blockDevices
+	{{
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+	}};
+	CompositeBlockDeviceMember member0 {blockDevices[0]};
+	CompositeBlockDeviceMember member1 {blockDevices[1]};
+	CompositeBlockDeviceMember member2 {blockDevices[2]};
+	CompositeBlockDeviceMember* const members[] {&member0, &member1, &member2};
+	CompositeBlockDevice compositeBlockDevice {CompositeBlockDevice::Mode::striped,
+			CompositeBlockDevice::MembersRange{members}};
+
+	REQUIRE(compositeBlockDevice.open() == 0);
+
+	for (size_t i {}; i < blockDevices.size(); ++i)
+		fillPattern(i * 0x40, blockDevices[i].getMemory().data(), blockDevices[i].getMemory().size());
+
+	// part of stripe 4 - only member 1 is read, at address 16
+	std::array<uint8_t, eraseBlockSize> buffer;
+	auto ret = compositeBlockDevice.read(4 * eraseBlockSize + 4, buffer.data(), 8);
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == 8);
+	REQUIRE(blockDevices[0].getReadCount() == 0);
+	REQUIRE(blockDevices[1].getReadCount() == 1);
+	REQUIRE(blockDevices[2].getReadCount() == 0);
+	for (size_t i {}; i < 8; ++i)
+		REQUIRE(buffer[i] == 0x40 + eraseBlockSize + 4 + i);
+
+	// end of stripe 5 (member 2) and beginning of stripe 6 (member 0) - member 1 is not read
+	ret = compositeBlockDevice.read(5 * eraseBlockSize + 8, buffer.data(), buffer.size());
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == buffer.size());
+	REQUIRE(blockDevices[0].getReadCount() == 1);
+	REQUIRE(blockDevices[1].getReadCount() == 1);
+	REQUIRE(blockDevices[2].getReadCount() == 1);
+	for (size_t i {}; i < 8; ++i)
+	{
+		REQUIRE(buffer[i] == 0x80 + eraseBlockSize + 8 + i);
+		REQUIRE(buffer[8 + i] == 2 * eraseBlockSize + i);
+	}
+
+	// stripe 7 is block 2 of member 1
+	REQUIRE(compositeBlockDevice.erase(7 * eraseBlockSize, eraseBlockSize) == 0);
+	for (size_t i {}; i < blockDevices.size(); ++i)
+		for (size_t block {}; block < eraseBlocksCount; ++block)
+		{
+			INFO("member: " << i << ", block: " << block);
+			REQUIRE(blockDevices[i].getEraseCount(block) == (i == 1 && block == 2 ? 1 : 0));
+		}
+
+	REQUIRE(compositeBlockDevice.close() == 0);
+}
+
+TEST_CASE("Testing mirrored reads", "[mirrored]")
+{
+	std::array<distortos::RamBlockDevice, 3> blockDevices
+	{{
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+	}};
+	CompositeBlockDeviceMember member0 {blockDevices[0]};
+	CompositeBlockDeviceMember member1 {blockDevices[1]};
+	CompositeBlockDeviceMember member2 {blockDevices[2]};
+	CompositeBlockDeviceMember* const members[] {&member0, &member1, &member2};
+	CompositeBlockDevice compositeBlockDevice {CompositeBlockDevice::Mode::mirrored,
+			CompositeBlockDevice::MembersRange{members}};
+
+	REQUIRE(compositeBlockDevice.open() == 0);
+	REQUIRE(compositeBlockDevice.getSize() == eraseBlockSize * eraseBlocksCount);
+
+	// program is executed on all members
+	std::array<uint8_t, eraseBlockSize * eraseBlocksCount> buffer;
+	fillPattern(0, buffer.data(), buffer.size());
+	const auto ret = compositeBlockDevice.program(0, buffer.data(), buffer.size());
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == buffer.size());
+	for (size_t i {}; i < blockDevices.size(); ++i)
+	{
+		INFO("member: " << i);
+		REQUIRE(std::equal(buffer.begin(), buffer.end(), blockDevices[i].getMemory().begin()) == true);
+	}
+
+	// contents of members are made different, so that it's possible to tell which member executed each read
+	for (size_t i {}; i < blockDevices.size(); ++i)
+		blockDevices[i].getMemory().assign(buffer.size(), 0x10 * (i + 1));
+
+	// read of one erase block per member is split between all of them
+	auto readRet = compositeBlockDevice.read(0, buffer.data(), 3 * eraseBlockSize);
+	REQUIRE(readRet.first == 0);
+	REQUIRE(readRet.second == 3 * eraseBlockSize);
+	for (size_t i {}; i < 3 * eraseBlockSize; ++i)
+		REQUIRE(buffer[i] == 0x10 * (i / eraseBlockSize + 1));
+	for (auto& blockDevice : blockDevices)
+		REQUIRE(blockDevice.getReadCount() == 1);
+
+	// smaller reads are executed by members in turns
+	for (size_t i {}; i < 2 * blockDevices.size(); ++i)
+	{
+		INFO("iteration: " << i);
+		readRet = compositeBlockDevice.read(eraseBlockSize, buffer.data(), 2 * eraseBlockSize);
+		REQUIRE(readRet.first == 0);
+		REQUIRE(readRet.second == 2 * eraseBlockSize);
+		REQUIRE(buffer[0] == 0x10 * (i % blockDevices.size() + 1));
+		REQUIRE(buffer[2 * eraseBlockSize - 1] == 0x10 * (i % blockDevices.size() + 1));
+	}
+	for (auto& blockDevice : blockDevices)
+		REQUIRE(blockDevice.getReadCount() == 3);
+
+	REQUIRE(compositeBlockDevice.close() == 0);
+}
+
+TEST_CASE("Testing errors of members", "[error]")
+{
+	std::array<distortos::RamBlockDevice, 2> blockDevices
+	{{
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+			{eraseBlockSize, eraseBlocksCount, programBlockSize},
+	}};
+	CompositeBlockDeviceMember member0 {blockDevices[0]};
+	CompositeBlockDeviceMember member1 {blockDevices[1]};
+	CompositeBlockDeviceMember* const members[] {&member0, &member1};
+
+	std::array<uint8_t, 4 * eraseBlockSize> buffer;
+	fillPattern(0, buffer.data(), buffer.size());
+
+	SECTION("Striped program stops at the lowest failed address")
+	{
+		CompositeBlockDevice compositeBlockDevice {CompositeBlockDevice::Mode::striped,
+			CompositeBlockDevice::MembersRange{members}};
+		REQUIRE(compositeBlockDevice.open() == 0);
+
+		// member 0 fails in stripe 2 at address 36, member 1 fails in stripe 1 at address 24
+		blockDevices[0].setProgramBudget(eraseBlockSize + 4);
+		blockDevices[1].setProgramBudget(8);
+		auto ret = compositeBlockDevice.program(0, buffer.data(), buffer.size());
+		REQUIRE(ret.first == EIO);
+		REQUIRE(ret.second == eraseBlockSize + 8);
+
+		// only member 0 fails, at address 4
+		blockDevices[0].setProgramBudget(4);
+		blockDevices[1].setProgramBudget(SIZE_MAX);
+		ret = compositeBlockDevice.program(0, buffer.data(), buffer.size());
+		REQUIRE(ret.first == EIO);
+		REQUIRE(ret.second == 4);
+
+		// stripes of failed member are not needed
+		ret = compositeBlockDevice.program(eraseBlockSize, buffer.data(), eraseBlockSize);
+		REQUIRE(ret.first == 0);
+		REQUIRE(ret.second == eraseBlockSize);
+
+		REQUIRE(compositeBlockDevice.close() == 0);
+	}
+	SECTION("Striped erase fails if any member fails")
+	{
+		CompositeBlockDevice compositeBlockDevice {CompositeBlockDevice::Mode::striped,
+			CompositeBlockDevice::MembersRange{members}};
+		REQUIRE(compositeBlockDevice.open() == 0);
+
+		blockDevices[1].setProgramBudget(0);
+		REQUIRE(compositeBlockDevice.erase(0, 2 * eraseBlockSize) == EIO);
+		REQUIRE(blockDevices[0].getEraseCount(0) == 1);
+		REQUIRE(compositeBlockDevice.erase(2 * eraseBlockSize, eraseBlockSize) == 0);
+		REQUIRE(blockDevices[0].getEraseCount(1) == 1);
+
+		REQUIRE(compositeBlockDevice.close() == 0);
+	}
+	SECTION("Mirrored program reports the failed member")
+	{
+		CompositeBlockDevice compositeBlockDevice {CompositeBlockDevice::Mode::mirrored,
+			CompositeBlockDevice::MembersRange{members}};
+		REQUIRE(compositeBlockDevice.open() == 0);
+
+		blockDevices[1].setProgramBudget(12);
+		const auto ret = compositeBlockDevice.program(0, buffer.data(), buffer.size());
+		REQUIRE(ret.first == EIO);
+		REQUIRE(ret.second == 12);
+		REQUIRE(std::equal(buffer.begin(), buffer.end(), blockDevices[0].getMemory().begin()) == true);
+
+		REQUIRE(compositeBlockDevice.close() == 0);
+	}
+}
@@ -0,0 +1,410 @@
+/**
+ * \file
+ * \brief HighResolutionTimerService test cases
+ *
+ * This test runs HighResolutionTimerService against a fake hardware timer, which advances its counter one tick at a
+ * time and "executes" compare match interrupt when the counter reaches the value of compare channel. It checks whether
+ * timers expire exactly at their deadlines and in proper order, whether wrap-arounds of narrow counters are tracked and
+ * whether timers can be started and stopped from their own functions.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/devices/timers/HighResolutionTimerLowLevel.hpp"
+#include "distortos/devices/timers/HighResolutionTimerService.hpp"
+
+#include "distortos/architecture/enableInterruptMasking.hpp"
+#include "distortos/architecture/restoreInterruptMasking.hpp"
+
+#include <vector>
+
+using trompeloeil::_;
+using distortos::devices::HighResolutionTimer;
+using distortos::devices::HighResolutionTimerService;
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// fake free-running hardware counter with one compare channel
+class FakeTimer : public distortos::devices::HighResolutionTimerLowLevel
+{
+public:
+
+	/**
+	 * \brief FakeTimer's constructor
+	 *
+	 * \param [in] maxCounter is the maximum value of counter
+	 * \param [in] counter is the initial value of counter
+	 */
+
+	FakeTimer(const uint32_t maxCounter, const uint32_t counter) :
+			base_{},
+			compare_{},
+			compareMatches_{},
+			counter_{counter},
+			maxCounter_{maxCounter},
+			pending_{}
+	{
+
+	}
+
+	/**
+	 * \brief Advances counter and executes compare match interrupts.
+	 *
+	 * \param [in] ticks is the number of ticks by which the counter will be advanced
+	 */
+
+	void advance(const uint64_t ticks)
+	{
+		deliver();
+		for (uint64_t i {}; i < ticks; ++i)
+		{
+			counter_ = (counter_ + 1) & maxCounter_;
+			if (counter_ == compare_)
+				pending_ = true;
+			deliver();
+		}
+	}
+
+	/**
+	 * \brief Executes compare match interrupt if it is pending.
+	 */
+
+	void deliver()
+	{
+		while (base_ != nullptr && pending_ == true)
+		{
+			pending_ = false;
+			++compareMatches_;
+			base_->compareMatchEvent();
+		}
+	}
+
+	/**
+	 * \return number of executed compare match interrupts
+	 */
+
+	size_t getCompareMatches() const
+	{
+		return compareMatches_;
+	}
+
+	uint32_t getCounter() const override
+	{
+		return counter_;
+	}
+
+	uint32_t getFrequency() const override
+	{
+		return 1000000;
+	}
+
+	uint32_t getMaxCounter() const override
+	{
+		return maxCounter_;
+	}
+
+	void setCompare(const uint32_t value) override
+	{
+		REQUIRE(base_ != nullptr);
+		REQUIRE(value <= maxCounter_);
+		compare_ = value;
+		pending_ = false;
+	}
+
+	int start(distortos::devices::HighResolutionTimerBase& highResolutionTimerBase) override
+	{
+		REQUIRE(base_ == nullptr);
+		base_ = &highResolutionTimerBase;
+		return 0;
+	}
+
+	int stop() override
+	{
+		REQUIRE(base_ != nullptr);
+		base_ = {};
+		pending_ = false;
+		return 0;
+	}
+
+	void triggerCompareMatch() override
+	{
+		REQUIRE(base_ != nullptr);
+		pending_ = true;
+	}
+
+private:
+
+	/// pointer to associated HighResolutionTimerBase, nullptr if the timer is stopped
+	distortos::devices::HighResolutionTimerBase* base_;
+
+	/// value of compare channel
+	uint32_t compare_;
+
+	/// number of executed compare match interrupts
+	size_t compareMatches_;
+
+	/// value of counter
+	uint32_t counter_;
+
+	/// maximum value of counter
+	uint32_t maxCounter_;
+
+	/// true if compare match interrupt is pending, false otherwise
+	bool pending_;
+};
+
+/// HighResolutionTimer which records time points at which it expired
+class RecordingTimer : public HighResolutionTimer
+{
+public:
+
+	/**
+	 * \brief RecordingTimer's constructor
+	 *
+	 * \param [in] service is a reference to HighResolutionTimerService which will run this timer
+	 * \param [in] id is the identifier of timer
+	 * \param [in] log is a reference to log of expirations shared by all timers
+	 * \param [in] maxRuns is the number of runs after which the timer stops itself, 0 to never stop
+	 */
+
+	RecordingTimer(HighResolutionTimerService& service, const int id, std::vector<std::pair<int, uint64_t>>& log,
+			const size_t maxRuns = {}) :
+					HighResolutionTimer{service, &RecordingTimer::function},
+					log_{log},
+					service_{service},
+					maxRuns_{maxRuns},
+					runs_{},
+					id_{id}
+	{
+
+	}
+
+private:
+
+	/**
+	 * \brief Timer's function.
+	 *
+	 * \param [in] highResolutionTimer is a reference to RecordingTimer object which expired
+	 */
+
+	static void function(HighResolutionTimer& highResolutionTimer)
+	{
+		auto& that = static_cast<RecordingTimer&>(highResolutionTimer);
+		that.log_.emplace_back(that.id_, that.service_.getTime());
+		if (++that.runs_ == that.maxRuns_)
+			that.stop();
+	}
+
+	/// reference to log of expirations shared by all timers
+	std::vector<std::pair<int, uint64_t>>& log_;
+
+	/// reference to HighResolutionTimerService which runs this timer
+	HighResolutionTimerService& service_;
+
+	/// number of runs after which the timer stops itself, 0 to never stop
+	size_t maxRuns_;
+
+	/// number of runs
+	size_t runs_;
+
+	/// identifier of timer
+	int id_;
+};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing timers expiring in order of their deadlines", "[expiration]")
+{
+	distortos::architecture::EnableInterruptMaskingMock enableInterruptMaskingMock;
+	distortos::architecture::RestoreInterruptMaskingMock restoreInterruptMaskingMock;
+	ALLOW_CALL(enableInterruptMaskingMock, enableInterruptMasking()).RETURN(0u);
+	ALLOW_CALL(restoreInterruptMaskingMock, restoreInterruptMasking(_));
+
+	FakeTimer fakeTimer {UINT32_MAX, 0x12345678};
+	HighResolutionTimerService service {fakeTimer};
+	REQUIRE(service.start() == 0);
+	REQUIRE(service.getTime() == 0);
+
+	std::vector<std::pair<int, uint64_t>> log;
+	RecordingTimer timers[]
+	{
+			{service, 0, log},
+			{service, 1, log},
+			{service, 2, log},
+			{service, 3, log},
+	};
+	REQUIRE(timers[0].start(std::chrono::microseconds{137}) == 0);
+	REQUIRE(timers[1].start(std::chrono::nanoseconds{42001}) == 0);
+	REQUIRE(timers[2].start(std::chrono::milliseconds{1}) == 0);
+	REQUIRE(timers[3].startAt(500) == 0);
+	fakeTimer.deliver();
+	REQUIRE(log.empty() == true);
+
+	fakeTimer.advance(2000);
+	const decltype(log) expectedLog {{1, 43}, {0, 137}, {3, 500}, {2, 1000}};
+	REQUIRE(log == expectedLog);
+	for (auto& timer : timers)
+		REQUIRE(timer.isRunning() == false);
+	// 4 timers and no extra compare matches - next "keep-alive" compare match is half of counter period away
+	REQUIRE(fakeTimer.getCompareMatches() == 4);
+
+	REQUIRE(service.stop() == 0);
+}
+
+TEST_CASE("Testing wrap-arounds of narrow counter", "[wrap-around]")
+{
+	distortos::architecture::EnableInterruptMaskingMock enableInterruptMaskingMock;
+	distortos::architecture::RestoreInterruptMaskingMock restoreInterruptMaskingMock;
+	ALLOW_CALL(enableInterruptMaskingMock, enableInterruptMasking()).RETURN(0u);
+	ALLOW_CALL(restoreInterruptMaskingMock, restoreInterruptMasking(_));
+
+	FakeTimer fakeTimer {UINT16_MAX, 0xfff0};
+	HighResolutionTimerService service {fakeTimer};
+	REQUIRE(service.start() == 0);
+
+	std::vector<std::pair<int, uint64_t>> log;
+	RecordingTimer timers[]
+	{
+			{service, 0, log},
+			{service, 1, log},
+	};
+	REQUIRE(timers[0].startAt(200000) == 0);
+	REQUIRE(timers[1].startAt(65536) == 0);
+
+	fakeTimer.advance(250000);
+	const decltype(log) expectedLog {{1, 65536}, {0, 200000}};
+	REQUIRE(log == expectedLog);
+	REQUIRE(service.getTime() == 250000);
+
+	// no timers are running, but time must still be tracked
+	fakeTimer.advance(1000000);
+	REQUIRE(service.getTime() == 1250000);
+
+	REQUIRE(service.stop() == 0);
+}
+
+TEST_CASE("Testing repetitive timers", "[repetitive]")
+{
+	distortos::architecture::EnableInterruptMaskingMock enableInterruptMaskingMock;
+	distortos::architecture::RestoreInterruptMaskingMock restoreInterruptMaskingMock;
+	ALLOW_CALL(enableInterruptMaskingMock, enableInterruptMasking()).RETURN(0u);
+	ALLOW_CALL(restoreInterruptMaskingMock, restoreInterruptMasking(_));
+
+	FakeTimer fakeTimer {UINT16_MAX, {}};
+	HighResolutionTimerService service {fakeTimer};
+	REQUIRE(service.start() == 0);
+
+	std::vector<std::pair<int, uint64_t>> log;
+	RecordingTimer timers[]
+	{
+			{service, 0, log, 5},
+			{service, 1, log},
+	};
+	REQUIRE(timers[0].startAt(100, 100) == 0);
+	REQUIRE(timers[1].start(std::chrono::microseconds{250}, std::chrono::microseconds{300}) == 0);
+
+	fakeTimer.advance(1000);
+	const decltype(log) expectedLog {{0, 100}, {0, 200}, {1, 250}, {0, 300}, {0, 400}, {0, 500}, {1, 550},
+			{1, 850}};
+	REQUIRE(log == expectedLog);
+	REQUIRE(timers[0].isRunning() == false);
+	REQUIRE(timers[1].isRunning() == true);
+	REQUIRE(timers[1].getDeadline() == 1150);
+
+	REQUIRE(service.stop() == EBUSY);
+	timers[1].stop();
+	fakeTimer.advance(1000);
+	REQUIRE(log.size() == expectedLog.size());
+	REQUIRE(service.stop() == 0);
+}
+
+TEST_CASE("Testing timers with deadlines in the past", "[past]")
+{
+	distortos::architecture::EnableInterruptMaskingMock enableInterruptMaskingMock;
+	distortos::architecture::RestoreInterruptMaskingMock restoreInterruptMaskingMock;
+	ALLOW_CALL(enableInterruptMaskingMock, enableInterruptMasking()).RETURN(0u);
+	ALLOW_CALL(restoreInterruptMaskingMock, restoreInterruptMasking(_));
+
+	FakeTimer fakeTimer {UINT32_MAX, {}};
+	HighResolutionTimerService service {fakeTimer};
+	REQUIRE(service.start() == 0);
+	fakeTimer.advance(1000);
+
+	std::vector<std::pair<int, uint64_t>> log;
+	RecordingTimer timers[]
+	{
+			{service, 0, log},
+			{service, 1, log},
+	};
+	REQUIRE(timers[0].startAt(10) == 0);
+	REQUIRE(timers[1].start(std::chrono::nanoseconds{-1}) == 0);
+	// compare match is triggered by software, no counter ticks are needed
+	fakeTimer.deliver();
+	const decltype(log) expectedLog {{0, 1000}, {1, 1000}};
+	REQUIRE(log == expectedLog);
+
+	REQUIRE(service.stop() == 0);
+}
+
+TEST_CASE("Testing stopping of timers and service", "[stop]")
+{
+	distortos::architecture::EnableInterruptMaskingMock enableInterruptMaskingMock;
+	distortos::architecture::RestoreInterruptMaskingMock restoreInterruptMaskingMock;
+	ALLOW_CALL(enableInterruptMaskingMock, enableInterruptMasking()).RETURN(0u);
+	ALLOW_CALL(restoreInterruptMaskingMock, restoreInterruptMasking(_));
+
+	FakeTimer fakeTimer {UINT32_MAX, {}};
+	HighResolutionTimerService service {fakeTimer};
+	REQUIRE(service.stop() == EBADF);
+
+	std::vector<std::pair<int, uint64_t>> log;
+	RecordingTimer timer {service, 0, log};
+	REQUIRE(timer.startAt(100) == EBADF);
+	REQUIRE(timer.isRunning() == false);
+
+	REQUIRE(service.start() == 0);
+	REQUIRE(service.start() == EBADF);
+	REQUIRE(timer.startAt(100) == 0);
+	REQUIRE(timer.isRunning() == true);
+	REQUIRE(service.stop() == EBUSY);
+	timer.stop();
+	REQUIRE(timer.isRunning() == false);
+	fakeTimer.advance(200);
+	REQUIRE(log.empty() == true);
+	REQUIRE(service.stop() == 0);
+	REQUIRE(service.stop() == EBADF);
+
+	// time continues when the service is started again
+	REQUIRE(service.start() == 0);
+	fakeTimer.advance(50);
+	REQUIRE(service.getTime() == 250);
+	REQUIRE(service.stop() == 0);
+}
+
+TEST_CASE("Testing conversion of durations to counter ticks", "[conversion]")
+{
+	FakeTimer fakeTimer {UINT32_MAX, {}};
+	const HighResolutionTimerService service {fakeTimer};
+
+	REQUIRE(service.toTicks(std::chrono::nanoseconds{-1000}) == 0);
+	REQUIRE(service.toTicks(std::chrono::nanoseconds{}) == 0);
+	REQUIRE(service.toTicks(std::chrono::nanoseconds{1}) == 1);
+	REQUIRE(service.toTicks(std::chrono::nanoseconds{1000}) == 1);
+	REQUIRE(service.toTicks(std::chrono::nanoseconds{1001}) == 2);
+	REQUIRE(service.toTicks(std::chrono::microseconds{137}) == 137);
+	REQUIRE(service.toTicks(std::chrono::seconds{2} + std::chrono::nanoseconds{1}) == 2000001);
+	REQUIRE(service.toTicks(std::chrono::hours{24 * 365}) == 31536000000000);
+}
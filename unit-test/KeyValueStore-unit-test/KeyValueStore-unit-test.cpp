@@ -0,0 +1,302 @@
+/**
+ * \file
+ * \brief KeyValueStore test cases
+ *
+ * This test checks whether KeyValueStore properly stores values on a block device, collects garbage, recovers state
+ * during mount and keeps commits atomic in case of power failure.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/storage/StaticKeyValueStore.hpp"
+
+#include "RamBlockDevice.hpp"
+#include "unit-test-common.hpp"
+
+#include <array>
+#include <map>
+#include <random>
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// tested KeyValueStore with 32 slots, 1 kB for values and 128 bytes of buffer
+using TestKeyValueStore = distortos::StaticKeyValueStore<32, 1024, 128>;
+
+/// model of contents of the store
+using Model = std::map<uint32_t, std::vector<uint8_t>>;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// size of sector, bytes
+constexpr size_t sectorSize {512};
+
+/// program block size, bytes
+constexpr size_t programBlockSize {8};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Checks whether contents of the store match the model.
+ *
+ * \param [in] keyValueStore is a reference to tested KeyValueStore object
+ * \param [in] model is a reference to model of contents
+ * \param [in] keysCount is the number of checked keys, starting from 0
+ */
+
+void checkModel(distortos::KeyValueStore& keyValueStore, const Model& model, const uint32_t keysCount)
+{
+	for (uint32_t key {}; key < keysCount; ++key)
+	{
+		INFO("key: " << key);
+		std::array<uint8_t, 128> buffer;
+		const auto ret = keyValueStore.get(key, buffer.data(), buffer.size());
+		const auto iterator = model.find(key);
+		if (iterator == model.end())
+		{
+			REQUIRE(ret.first == ENOENT);
+			continue;
+		}
+
+		REQUIRE(ret.first == 0);
+		REQUIRE(ret.second == iterator->second.size());
+		REQUIRE(std::equal(iterator->second.begin(), iterator->second.end(), buffer.begin()) == true);
+	}
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing basic operations", "[basic]")
+{
+	distortos::RamBlockDevice blockDevice {sectorSize, 2, programBlockSize};
+	TestKeyValueStore keyValueStore {blockDevice};
+
+	REQUIRE(keyValueStore.set(1, "a", 1) == EBADF);
+	REQUIRE(keyValueStore.mount() == 0);
+	REQUIRE(keyValueStore.mount() == EBUSY);
+	REQUIRE(keyValueStore.getMaxValueSize() == 128 - 12);
+
+	std::array<uint8_t, 128> buffer;
+	REQUIRE(keyValueStore.get(1, buffer.data(), buffer.size()).first == ENOENT);
+	REQUIRE(keyValueStore.remove(1) == ENOENT);
+	REQUIRE(keyValueStore.set(1, nullptr, 1) == EINVAL);
+	REQUIRE(keyValueStore.set(1, buffer.data(), keyValueStore.getMaxValueSize() + 1) == EMSGSIZE);
+
+	const uint32_t value1 {0x12345678};
+	REQUIRE(keyValueStore.set(1, &value1, sizeof(value1)) == 0);
+	REQUIRE(keyValueStore.set(2, "hello", 5) == 0);
+	REQUIRE(keyValueStore.set(3, "", 0) == 0);
+
+	// reads don't access the block device
+	const auto readCount = blockDevice.getReadCount();
+	auto ret = keyValueStore.get(1, buffer.data(), buffer.size());
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == sizeof(value1));
+	REQUIRE(memcmp(buffer.data(), &value1, sizeof(value1)) == 0);
+	ret = keyValueStore.get(2, buffer.data(), 4);
+	REQUIRE(ret.first == EMSGSIZE);
+	REQUIRE(ret.second == 5);
+	ret = keyValueStore.get(3, buffer.data(), buffer.size());
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == 0);
+	REQUIRE(blockDevice.getReadCount() == readCount);
+
+	// each change is a single program operation, unchanged value is not programmed at all
+	auto programCount = blockDevice.getProgramCount();
+	REQUIRE(keyValueStore.set(2, "world!", 6) == 0);
+	REQUIRE(blockDevice.getProgramCount() == programCount + 1);
+	REQUIRE(keyValueStore.set(2, "world!", 6) == 0);
+	REQUIRE(blockDevice.getProgramCount() == programCount + 1);
+	REQUIRE(keyValueStore.remove(1) == 0);
+	REQUIRE(blockDevice.getProgramCount() == programCount + 2);
+
+	REQUIRE(keyValueStore.unmount() == 0);
+	REQUIRE(keyValueStore.get(2, buffer.data(), buffer.size()).first == EBADF);
+	REQUIRE(keyValueStore.mount() == 0);
+
+	const Model model {{2, {'w', 'o', 'r', 'l', 'd', '!'}}, {3, {}}};
+	checkModel(keyValueStore, model, 8);
+}
+
+TEST_CASE("Testing invalid block device", "[mount]")
+{
+	distortos::RamBlockDevice blockDevice {sectorSize, 2, programBlockSize};
+	TestKeyValueStore keyValueStore {blockDevice};
+
+	blockDevice.getMemory()[100] = 0;
+	REQUIRE(keyValueStore.mount() == EILSEQ);
+	REQUIRE(keyValueStore.format() == 0);
+	REQUIRE(keyValueStore.mount() == 0);
+
+	distortos::RamBlockDevice singleSectorBlockDevice {sectorSize, 1, programBlockSize};
+	TestKeyValueStore singleSectorKeyValueStore {singleSectorBlockDevice};
+	REQUIRE(singleSectorKeyValueStore.mount() == EINVAL);
+}
+
+TEST_CASE("Testing garbage collection and wear leveling", "[gc]")
+{
+	for (const size_t sectorsCount : {2, 3, 5})
+	{
+		distortos::RamBlockDevice blockDevice {sectorSize, sectorsCount, programBlockSize};
+		TestKeyValueStore keyValueStore {blockDevice};
+		REQUIRE(keyValueStore.mount() == 0);
+
+		// all values fit in one sector, which is the capacity of a store with 2 sectors
+		constexpr uint32_t keysCount {12};
+		std::minstd_rand randomGenerator {sectorsCount};
+		Model model;
+		for (size_t iteration {}; iteration < 2000; ++iteration)
+		{
+			INFO("sectors: " << sectorsCount << ", iteration: " << iteration);
+			const uint32_t key = randomGenerator() % keysCount;
+			if (randomGenerator() % 8 == 0)
+			{
+				REQUIRE(keyValueStore.remove(key) == (model.erase(key) != 0 ? 0 : ENOENT));
+			}
+			else
+			{
+				std::array<uint8_t, 24> value;
+				const auto size = randomGenerator() % value.size();
+				for (auto& byte : value)
+					byte = randomGenerator();
+				REQUIRE(keyValueStore.set(key, value.data(), size) == 0);
+				model[key].assign(value.begin(), value.begin() + size);
+			}
+
+			if (iteration % 97 == 0)
+			{
+				REQUIRE(keyValueStore.unmount() == 0);
+				REQUIRE(keyValueStore.mount() == 0);
+			}
+			if (iteration % 13 == 0)
+				checkModel(keyValueStore, model, keysCount);
+		}
+
+		checkModel(keyValueStore, model, keysCount);
+
+		size_t minEraseCount {SIZE_MAX};
+		size_t maxEraseCount {};
+		for (size_t sector {}; sector < sectorsCount; ++sector)
+		{
+			minEraseCount = std::min(minEraseCount, blockDevice.getEraseCount(sector));
+			maxEraseCount = std::max(maxEraseCount, blockDevice.getEraseCount(sector));
+		}
+		REQUIRE(minEraseCount > 10);
+		REQUIRE(maxEraseCount - minEraseCount <= 1);
+	}
+}
+
+TEST_CASE("Testing capacity limits", "[capacity]")
+{
+	distortos::RamBlockDevice blockDevice {sectorSize, 3, programBlockSize};
+	TestKeyValueStore keyValueStore {blockDevice};
+	REQUIRE(keyValueStore.mount() == 0);
+
+	// 31 of 32 slots may be used
+	const uint32_t value {};
+	for (uint32_t key {}; key < 31; ++key)
+		REQUIRE(keyValueStore.set(key, &value, sizeof(value)) == 0);
+	REQUIRE(keyValueStore.set(31, &value, sizeof(value)) == ENOSPC);
+
+	// removal of values with colliding keys must keep all other values reachable
+	for (uint32_t key {}; key < 31; key += 2)
+		REQUIRE(keyValueStore.remove(key) == 0);
+	for (uint32_t key {1}; key < 31; key += 2)
+	{
+		uint32_t readValue;
+		REQUIRE(keyValueStore.get(key, &readValue, sizeof(readValue)).first == 0);
+	}
+
+	std::array<distortos::KeyValueStore::Change, 20> changes;
+	for (size_t i {}; i < changes.size(); ++i)
+		changes[i] = {static_cast<uint32_t>(100 + i), &value, keyValueStore.getMaxValueSize()};
+	REQUIRE(keyValueStore.commit(changes.data(), changes.size()) == EMSGSIZE);
+	REQUIRE(keyValueStore.commit(changes.data(), 0) == EINVAL);
+}
+
+TEST_CASE("Testing power failure during commit", "[power-failure]")
+{
+	for (const size_t sectorsCount : {2, 3})
+	{
+		distortos::RamBlockDevice blockDevice {sectorSize, sectorsCount, programBlockSize};
+		std::array<uint8_t, 20> oldValue;
+		oldValue.fill(0x11);
+		std::array<uint8_t, 20> newValue;
+		newValue.fill(0x22);
+
+		// the interrupted commit is preceded by a number of changes, so that it may also trigger garbage collection
+		for (const size_t changesBefore : {0, 10, 11, 12, 13})
+		{
+			for (size_t budget {}; budget < 300; budget += 3)
+			{
+				INFO("sectors: " << sectorsCount << ", changes before: " << changesBefore << ", budget: " << budget);
+				Model model;
+				{
+					TestKeyValueStore keyValueStore {blockDevice};
+					REQUIRE(keyValueStore.format() == 0);
+					REQUIRE(keyValueStore.mount() == 0);
+					for (uint32_t key {}; key < 4; ++key)
+					{
+						REQUIRE(keyValueStore.set(key, oldValue.data(), oldValue.size()) == 0);
+						model[key].assign(oldValue.begin(), oldValue.end());
+					}
+					for (size_t i {}; i < changesBefore; ++i)
+					{
+						const uint32_t key = 4 + i % 3;
+						REQUIRE(keyValueStore.set(key, &i, sizeof(i)) == 0);
+						model[key].assign(reinterpret_cast<const uint8_t*>(&i), reinterpret_cast<const uint8_t*>(&i + 1));
+					}
+
+					blockDevice.setProgramBudget(budget);
+					const distortos::KeyValueStore::Change changes[]
+					{
+							{0, newValue.data(), newValue.size()},
+							{1, nullptr, {}},
+							{2, newValue.data(), 5},
+					};
+					keyValueStore.commit(changes, sizeof(changes) / sizeof(*changes));
+					blockDevice.setProgramBudget(SIZE_MAX);
+				}
+
+				TestKeyValueStore keyValueStore {blockDevice};
+				REQUIRE(keyValueStore.mount() == 0);
+
+				// either all or none of the changes are visible
+				std::array<uint8_t, 128> buffer;
+				if (keyValueStore.get(1, buffer.data(), buffer.size()).first == ENOENT)
+				{
+					model[0].assign(newValue.begin(), newValue.end());
+					model.erase(1);
+					model[2].assign(newValue.begin(), newValue.begin() + 5);
+				}
+				checkModel(keyValueStore, model, 8);
+
+				// the store remains usable
+				for (size_t i {}; i < 30; ++i)
+				{
+					REQUIRE(keyValueStore.set(7, &i, sizeof(i)) == 0);
+					model[7].assign(reinterpret_cast<const uint8_t*>(&i), reinterpret_cast<const uint8_t*>(&i + 1));
+				}
+				REQUIRE(keyValueStore.unmount() == 0);
+				REQUIRE(keyValueStore.mount() == 0);
+				checkModel(keyValueStore, model, 8);
+			}
+		}
+	}
+}
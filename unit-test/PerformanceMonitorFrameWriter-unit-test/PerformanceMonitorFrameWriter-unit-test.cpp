@@ -0,0 +1,207 @@
+/**
+ * \file
+ * \brief PerformanceMonitorFrameWriter test cases
+ *
+ * This test checks whether PerformanceMonitorFrameWriter assembles frames with the format described in documentation
+ * of PerformanceMonitor class. Stream with frames is also written to a file, which is then parsed by
+ * scripts/performanceMonitor.py with checkFrames.py.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "unit-test-common.hpp"
+
+#include "distortos/internal/monitor/PerformanceMonitorFrameWriter.hpp"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// Output class collects data "transmitted" by PerformanceMonitorFrameWriter
+class Output
+{
+public:
+
+	/**
+	 * \brief Appends data to collected data.
+	 *
+	 * \param [in] buffer is the buffer with data that will be appended
+	 * \param [in] size is the size of \a buffer, bytes
+	 */
+
+	void write(const void* const buffer, const size_t size)
+	{
+		const auto bufferUint8 = static_cast<const uint8_t*>(buffer);
+		data.insert(data.end(), bufferUint8, bufferUint8 + size);
+	}
+
+	/// collected data
+	std::vector<uint8_t> data;
+};
+
+/// tested type
+using FrameWriter = distortos::internal::PerformanceMonitorFrameWriter<Output>;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// type of description frame
+constexpr uint8_t descriptionFrameType {1};
+
+/// type of sample frame
+constexpr uint8_t sampleFrameType {2};
+
+/// size of frame header - magic, type and size of payload, bytes
+constexpr size_t headerSize {2 + 1 + 2};
+
+/// size of frame trailer - CRC-32, bytes
+constexpr size_t trailerSize {4};
+
+/// name of thread which is longer than buffer of PerformanceMonitorFrameWriter
+const std::string longName (100, 'x');
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \param [in] data is the data with frame
+ * \param [in] offset is the offset of value in \a data
+ *
+ * \return little-endian uint32_t value read from \a data
+ */
+
+uint32_t readU32(const std::vector<uint8_t>& data, const size_t offset)
+{
+	return data[offset] | data[offset + 1] << 8 | data[offset + 2] << 16 |
+			static_cast<uint32_t>(data[offset + 3]) << 24;
+}
+
+/**
+ * \brief Writes description frame with 2 threads and 1 queue.
+ *
+ * \param [in] output is a reference to object which collects frame
+ */
+
+void writeDescription(Output& output)
+{
+	const size_t payloadSize {8 + (4 + 1 + 4) + (4 + 1 + longName.size()) + (4 + 1 + 5)};
+	FrameWriter frameWriter {output, descriptionFrameType, payloadSize};
+	frameWriter.writeU8(1);
+	frameWriter.writeU8(2);
+	frameWriter.writeU8(1);
+	frameWriter.writeU8({});
+	frameWriter.writeU32(1000);
+	frameWriter.writeU32(2048);
+	frameWriter.writeName("main");
+	frameWriter.writeU32(512);
+	frameWriter.writeName(longName.c_str());
+	frameWriter.writeU32(16);
+	frameWriter.writeName("queue");
+	frameWriter.finish();
+}
+
+/**
+ * \brief Writes sample frame matching description written by writeDescription().
+ *
+ * \param [in] output is a reference to object which collects frame
+ * \param [in] sequence is the sequence number of sample
+ */
+
+void writeSample(Output& output, const uint32_t sequence)
+{
+	const size_t payloadSize {5 * 4 + 2 * 12 + 1 * 4};
+	FrameWriter frameWriter {output, sampleFrameType, payloadSize};
+	frameWriter.writeU32(sequence);
+	frameWriter.writeU32(2000 + sequence * 1000);
+	frameWriter.writeU32(100 + sequence * 50);
+	frameWriter.writeU32(4096);
+	frameWriter.writeU32(65536);
+
+	frameWriter.writeU32(500 + sequence * 250);
+	frameWriter.writeU32(1024);
+	frameWriter.writeU8(1);
+	frameWriter.writeU8(127);
+	frameWriter.writeU8(127);
+	frameWriter.writeU8({});
+
+	frameWriter.writeU32(1500 + sequence * 750);
+	frameWriter.writeU32(256);
+	frameWriter.writeU8(3);
+	frameWriter.writeU8(0);
+	frameWriter.writeU8(0);
+	frameWriter.writeU8({});
+
+	frameWriter.writeU32(7);
+	frameWriter.finish();
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing layout of frame", "[layout]")
+{
+	Output output;
+	writeDescription(output);
+
+	const auto& data = output.data;
+	const size_t payloadSize {data.size() - headerSize - trailerSize};
+	REQUIRE(data.size() > 64 + headerSize + trailerSize);
+	REQUIRE(data[0] == 'P');
+	REQUIRE(data[1] == 'M');
+	REQUIRE(data[2] == descriptionFrameType);
+	REQUIRE((data[3] | data[4] << 8) == payloadSize);
+	REQUIRE(std::string(data.begin() + headerSize + 8 + 4 + 1 + 4 + 4 + 1,
+			data.begin() + headerSize + 8 + 4 + 1 + 4 + 4 + 1 + longName.size()) == longName);
+
+	// CRC-32 covers type, size and payload, but not magic
+	const auto crc = distortos::internal::updateCrc32({}, data.data() + 2, headerSize - 2 + payloadSize);
+	REQUIRE(readU32(data, headerSize + payloadSize) == crc);
+}
+
+TEST_CASE("Testing name lengths", "[names]")
+{
+	REQUIRE(FrameWriter::getNameLength(nullptr) == 0);
+	REQUIRE(FrameWriter::getNameLength("") == 0);
+	REQUIRE(FrameWriter::getNameLength("main") == 4);
+	const std::string tooLongName (300, 'y');
+	REQUIRE(FrameWriter::getNameLength(tooLongName.c_str()) == UINT8_MAX);
+
+	Output output;
+	{
+		FrameWriter frameWriter {output, descriptionFrameType, 1 + UINT8_MAX};
+		frameWriter.writeName(tooLongName.c_str());
+		frameWriter.finish();
+	}
+	REQUIRE(output.data.size() == headerSize + 1 + UINT8_MAX + trailerSize);
+	REQUIRE(output.data[headerSize] == UINT8_MAX);
+}
+
+TEST_CASE("Writing stream for scripts/performanceMonitor.py", "[stream]")
+{
+	Output output;
+	// garbage before first frame, which must be skipped by the parser
+	output.data.assign({0x55, 'P', 0xaa});
+	writeDescription(output);
+	writeSample(output, 0);
+	writeSample(output, 1);
+
+	std::ofstream file {FRAMES_FILE, std::ios::binary};
+	file.write(reinterpret_cast<const char*>(output.data.data()), output.data.size());
+	REQUIRE(file.good() == true);
+}
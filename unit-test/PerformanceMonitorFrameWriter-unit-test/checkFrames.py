@@ -0,0 +1,64 @@
+#!/usr/bin/env python
+
+#
+# file: checkFrames.py
+#
+# author: Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+#
+# This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+# distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+
+from __future__ import print_function
+
+import sys
+
+########################################################################################################################
+# main
+########################################################################################################################
+
+if __name__ == '__main__':
+	if len(sys.argv) != 3:
+		sys.exit('usage: {} <directory with performanceMonitor.py> <file with frames>'.format(sys.argv[0]))
+
+	sys.path.insert(0, sys.argv[1])
+	import performanceMonitor
+
+	with open(sys.argv[2], 'rb') as stream:
+		frameReader = performanceMonitor.FrameReader(stream)
+		frames = []
+		while True:
+			frame = frameReader.read()
+			if frame is None:
+				break
+			frames.append(frame)
+
+	errors = []
+	def check(condition, message):
+		if condition != True:
+			errors.append(message)
+
+	check([frameType for frameType, _ in frames] == [performanceMonitor.descriptionType,
+			performanceMonitor.sampleType, performanceMonitor.sampleType], 'unexpected frames: {}'.format(frames))
+	if not errors:
+		description = performanceMonitor.parseDescription(frames[0][1])
+		check(description == {'frequency': 1000, 'threads': [('main', 2048), ('x' * 100, 512)],
+				'queues': [('queue', 16)]}, 'unexpected description: {}'.format(description))
+		samples = [performanceMonitor.parseSample(payload, description) for _, payload in frames[1:]]
+		check(samples[1] == {'sequence': 1, 'tickCount': 3000, 'contextSwitchCount': 150, 'heapUsed': 4096,
+				'heapSize': 65536, 'threads': [(750, 1024, 1, 127, 127, 0), (2250, 256, 3, 0, 0, 0)], 'queues': [7]},
+				'unexpected sample: {}'.format(samples[1]))
+
+	with open(sys.argv[2], 'rb') as stream:
+		shown = []
+		performanceMonitor.run(performanceMonitor.FrameReader(stream), shown.append, True)
+	check(len(shown) == 2, 'unexpected number of shown samples: {}'.format(len(shown)))
+	if len(shown) == 2:
+		check(shown[1][0] == 'sample 1, uptime 3.0 s, 50 context switches/s, heap 4096 / 65536 bytes',
+				'unexpected summary: {}'.format(shown[1][0]))
+
+	for error in errors:
+		print('error:', error)
+	if errors:
+		sys.exit(1)
+	print('All frames parsed by performanceMonitor.py')
@@ -0,0 +1,264 @@
+/**
+ * \file
+ * \brief RamBlockDevice class header
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UNIT_TEST_RAMBLOCKDEVICE_HPP_
+#define UNIT_TEST_RAMBLOCKDEVICE_HPP_
+
+#include "distortos/devices/memory/BlockDevice.hpp"
+
+#include <vector>
+
+#include <cerrno>
+#include <cstring>
+
+namespace distortos
+{
+
+/**
+ * RamBlockDevice class is a block device in RAM with semantics of NOR flash, used by unit tests of storage classes.
+ *
+ * Programming can only clear bits. Optionally the device "loses power" after selected number of programmed bytes - all
+ * further erase and program operations are ignored and fail with EIO.
+ */
+
+class RamBlockDevice : public devices::BlockDevice
+{
+public:
+
+	/// erased value of RamBlockDevice
+	constexpr static uint8_t erasedValue {0xff};
+
+	/**
+	 * \brief RamBlockDevice's constructor
+	 *
+	 * \param [in] eraseBlockSize is the erase block size, bytes
+	 * \param [in] eraseBlocksCount is the number of erase blocks
+	 * \param [in] programBlockSize is the program block size, bytes
+	 */
+
+	RamBlockDevice(const size_t eraseBlockSize, const size_t eraseBlocksCount, const size_t programBlockSize) :
+			memory_(eraseBlockSize * eraseBlocksCount, uint8_t{erasedValue}),
+			eraseCounts_(eraseBlocksCount),
+			eraseBlockSize_{eraseBlockSize},
+			programBlockSize_{programBlockSize},
+			programCount_{},
+			readCount_{},
+			programBudget_{SIZE_MAX},
+			openCount_{}
+	{
+
+	}
+
+	int close() override
+	{
+		if (openCount_ == 0)
+			return EBADF;
+
+		--openCount_;
+		return 0;
+	}
+
+	int erase(const uint64_t address, const uint64_t size) override
+	{
+		const auto ret = checkRange(address, size, eraseBlockSize_);
+		if (ret != 0)
+			return ret;
+		if (programBudget_ == 0)
+			return EIO;
+
+		memset(memory_.data() + address, erasedValue, size);
+		for (auto block = address / eraseBlockSize_; block < (address + size) / eraseBlockSize_; ++block)
+			++eraseCounts_[block];
+		return 0;
+	}
+
+	size_t getEraseBlockSize() const override
+	{
+		return eraseBlockSize_;
+	}
+
+	std::pair<bool, uint8_t> getErasedValue() const override
+	{
+		return {true, uint8_t{erasedValue}};
+	}
+
+	size_t getProgramBlockSize() const override
+	{
+		return programBlockSize_;
+	}
+
+	size_t getReadBlockSize() const override
+	{
+		return 1;
+	}
+
+	uint64_t getSize() const override
+	{
+		return memory_.size();
+	}
+
+	int lock() override
+	{
+		return 0;
+	}
+
+	int open() override
+	{
+		++openCount_;
+		return 0;
+	}
+
+	std::pair<int, size_t> program(const uint64_t address, const void* const buffer, const size_t size) override
+	{
+		const auto ret = checkRange(address, size, programBlockSize_);
+		if (ret != 0)
+			return {ret, {}};
+
+		const auto bufferUint8 = static_cast<const uint8_t*>(buffer);
+		for (size_t i {}; i < size; ++i)
+		{
+			if (programBudget_ == 0)
+				return {EIO, i};
+
+			--programBudget_;
+			memory_[address + i] &= bufferUint8[i];
+		}
+
+		++programCount_;
+		return {{}, size};
+	}
+
+	std::pair<int, size_t> read(const uint64_t address, void* const buffer, const size_t size) override
+	{
+		const auto ret = checkRange(address, size, 1);
+		if (ret != 0)
+			return {ret, {}};
+
+		memcpy(buffer, memory_.data() + address, size);
+		++readCount_;
+		return {{}, size};
+	}
+
+	int synchronize() override
+	{
+		return openCount_ != 0 ? 0 : EBADF;
+	}
+
+	int trim(const uint64_t address, const uint64_t size) override
+	{
+		return checkRange(address, size, eraseBlockSize_);
+	}
+
+	int unlock() override
+	{
+		return 0;
+	}
+
+	/**
+	 * \param [in] block is the index of erase block
+	 *
+	 * \return number of times \a block was erased
+	 */
+
+	size_t getEraseCount(const size_t block) const
+	{
+		return eraseCounts_[block];
+	}
+
+	/**
+	 * \return reference to contents of the device
+	 */
+
+	std::vector<uint8_t>& getMemory()
+	{
+		return memory_;
+	}
+
+	/**
+	 * \return number of program operations
+	 */
+
+	size_t getProgramCount() const
+	{
+		return programCount_;
+	}
+
+	/**
+	 * \return number of read operations
+	 */
+
+	size_t getReadCount() const
+	{
+		return readCount_;
+	}
+
+	/**
+	 * \brief Sets number of bytes which can be programmed before simulated power failure.
+	 *
+	 * \param [in] programBudget is the number of bytes which can be programmed, SIZE_MAX to disable power failure
+	 */
+
+	void setProgramBudget(const size_t programBudget)
+	{
+		programBudget_ = programBudget;
+	}
+
+private:
+
+	/**
+	 * \brief Checks whether range is valid for the device.
+	 *
+	 * \param [in] address is the address of range
+	 * \param [in] size is the size of range, bytes
+	 * \param [in] blockSize is the required alignment of \a address and \a size, bytes
+	 *
+	 * \return 0 if range is valid, error code otherwise
+	 */
+
+	int checkRange(const uint64_t address, const uint64_t size, const size_t blockSize) const
+	{
+		if (openCount_ == 0)
+			return EBADF;
+		if (size == 0 || address % blockSize != 0 || size % blockSize != 0)
+			return EINVAL;
+		if (address + size > memory_.size())
+			return ENOSPC;
+		return 0;
+	}
+
+	/// contents of the device
+	std::vector<uint8_t> memory_;
+
+	/// number of times each erase block was erased
+	std::vector<size_t> eraseCounts_;
+
+	/// erase block size, bytes
+	size_t eraseBlockSize_;
+
+	/// program block size, bytes
+	size_t programBlockSize_;
+
+	/// number of program operations
+	size_t programCount_;
+
+	/// number of read operations
+	size_t readCount_;
+
+	/// number of bytes which can be programmed before simulated power failure
+	size_t programBudget_;
+
+	/// number of times this device was opened but not yet closed
+	size_t openCount_;
+};
+
+}	// namespace distortos
+
+#endif	// UNIT_TEST_RAMBLOCKDEVICE_HPP_
@@ -0,0 +1,370 @@
+/**
+ * \file
+ * \brief ChipSpiMasterLowLevel test cases for SPIv2 in STM32
+ *
+ * This test runs transfers of SPIv2 low-level driver against a fake SPI peripheral with RX and TX FIFOs connected in
+ * loopback. It checks whether transferred data is correct, whether FIFOs never overflow and underflow and whether
+ * 8-bit frames are packed into 16-bit accesses of data register, which reduces the number of interrupts.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/chip/ChipSpiMasterLowLevel.hpp"
+
+#include "distortos/chip/CMSIS-proxy.h"
+#include "distortos/chip/STM32-SPIv2.hpp"
+
+#include "distortos/architecture/enableInterruptMasking.hpp"
+#include "distortos/architecture/restoreInterruptMasking.hpp"
+
+#include "distortos/devices/communication/SpiMasterBase.hpp"
+
+#include <deque>
+#include <vector>
+
+using trompeloeil::_;
+using Register = distortos::SpiRegistersMock::Register;
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// model of SPIv2 peripheral with RX and TX FIFOs, MOSI connected to MISO
+class SpiModel
+{
+public:
+
+	/**
+	 * \return true if any interrupt of SPI is enabled and pending, false otherwise
+	 */
+
+	bool isInterruptPending() const
+	{
+		const auto sr = getSr();
+		return ((sr & SPI_SR_RXNE) != 0 && (cr2_ & SPI_CR2_RXNEIE) != 0) ||
+				((sr & SPI_SR_TXE) != 0 && (cr2_ & SPI_CR2_TXEIE) != 0) ||
+				((sr & (SPI_SR_MODF | SPI_SR_OVR | SPI_SR_CRCERR)) != 0 && (cr2_ & SPI_CR2_ERRIE) != 0);
+	}
+
+	/**
+	 * \brief Reads register of SPI.
+	 *
+	 * \param [in] spiRegister is the register that will be read
+	 *
+	 * \return value of register
+	 */
+
+	uint32_t read(const Register spiRegister) const
+	{
+		if (spiRegister == Register::cr1)
+			return cr1_;
+		if (spiRegister == Register::cr2)
+			return cr2_;
+		if (spiRegister == Register::sr)
+			return getSr();
+
+		FAIL("Unexpected read of SPI register");
+		return {};
+	}
+
+	/**
+	 * \brief Reads data register of SPI.
+	 *
+	 * \param [in] size is the size of access, bytes
+	 *
+	 * \return value read from RX FIFO
+	 */
+
+	uint16_t readDataRegister(const size_t size)
+	{
+		REQUIRE(rxFifo_.size() >= size);
+		++dataRegisterAccesses_;
+		uint16_t value {};
+		for (size_t i {}; i < size; ++i)
+		{
+			value |= rxFifo_.front() << (i * 8);
+			rxFifo_.pop_front();
+		}
+		return value;
+	}
+
+	/**
+	 * \brief Transfers frames from TX FIFO to RX FIFO.
+	 *
+	 * \param [in] frames is the max number of frames that will be transferred
+	 */
+
+	void shift(const size_t frames)
+	{
+		const size_t frameSize = getWordLength() <= 8 ? 1 : 2;
+		for (size_t frame {}; frame < frames && txFifo_.size() >= frameSize; ++frame)
+			for (size_t i {}; i < frameSize; ++i)
+			{
+				REQUIRE(rxFifo_.size() < distortos::chip::spiFifoSize);	// RX FIFO overflow?
+				rxFifo_.push_back(txFifo_.front());
+				txFifo_.pop_front();
+			}
+	}
+
+	/**
+	 * \brief Writes register of SPI.
+	 *
+	 * \param [in] spiRegister is the register that will be written
+	 * \param [in] value is the value that will be written
+	 */
+
+	void write(const Register spiRegister, const uint32_t value)
+	{
+		if (spiRegister == Register::cr1)
+			cr1_ = value;
+		else if (spiRegister == Register::cr2)
+			cr2_ = value;
+		else
+			FAIL("Unexpected write of SPI register");
+	}
+
+	/**
+	 * \brief Writes data register of SPI.
+	 *
+	 * \param [in] size is the size of access, bytes
+	 * \param [in] value is the value that will be written to TX FIFO
+	 */
+
+	void writeDataRegister(const size_t size, const uint16_t value)
+	{
+		REQUIRE(txFifo_.size() + size <= distortos::chip::spiFifoSize);	// TX FIFO overflow?
+		++dataRegisterAccesses_;
+		for (size_t i {}; i < size; ++i)
+			txFifo_.push_back(value >> (i * 8));
+	}
+
+	/**
+	 * \return number of 8-bit and 16-bit accesses to data register
+	 */
+
+	size_t getDataRegisterAccesses() const
+	{
+		return dataRegisterAccesses_;
+	}
+
+	/**
+	 * \return current word length, bits
+	 */
+
+	uint8_t getWordLength() const
+	{
+		return ((cr2_ & SPI_CR2_DS) >> SPI_CR2_DS_Pos) + 1;
+	}
+
+private:
+
+	/**
+	 * \return current value of SR register
+	 */
+
+	uint32_t getSr() const
+	{
+		const size_t rxneThreshold = (cr2_ & SPI_CR2_FRXTH) != 0 ? 1 : 2;
+		return (rxFifo_.size() >= rxneThreshold) << SPI_SR_RXNE_Pos |
+				(txFifo_.size() <= distortos::chip::spiFifoSize / 2) << SPI_SR_TXE_Pos |
+				(txFifo_.empty() == false) << SPI_SR_BSY_Pos;
+	}
+
+	/// RX FIFO
+	std::deque<uint8_t> rxFifo_;
+
+	/// TX FIFO
+	std::deque<uint8_t> txFifo_;
+
+	/// number of 8-bit and 16-bit accesses to data register
+	size_t dataRegisterAccesses_ {};
+
+	/// value of CR1 register
+	uint32_t cr1_ {};
+
+	/// value of CR2 register
+	uint32_t cr2_ {};
+};
+
+/// SpiMasterBase which saves the result of transfer
+class TestSpiMasterBase : public distortos::devices::SpiMasterBase
+{
+public:
+
+	/**
+	 * \brief Saves the result of transfer.
+	 *
+	 * \param [in] errorSet is the set of error bits
+	 * \param [in] bytesTransfered is the number of bytes transferred by low-level SPI master driver
+	 */
+
+	void transferCompleteEvent(const distortos::devices::SpiMasterErrorSet errorSet, const size_t bytesTransfered)
+			override
+	{
+		REQUIRE(completed == false);
+		REQUIRE(errorSet.none() == true);
+		completed = true;
+		transferredBytes = bytesTransfered;
+	}
+
+	/// number of bytes transferred by low-level SPI master driver
+	size_t transferredBytes {};
+
+	/// true if transfer was completed, false otherwise
+	bool completed {};
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// dummy data sent when write buffer is nullptr
+constexpr uint32_t dummyData {0x1234};
+
+/// tested word lengths, bits
+constexpr uint8_t wordLengths[] {8, 16};
+
+/// tested numbers of frames transferred by SPI between checks of pending interrupts
+constexpr size_t framesPerInterrupts[] {1, 2, 3, 4};
+
+/// tested sizes of transfers, bytes
+constexpr size_t sizes[] {1, 2, 3, 4, 5, 7, 8, 64};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Runs single transfer to completion on fake SPI peripheral.
+ *
+ * \param [in] wordLength is the word length, bits
+ * \param [in] framesPerInterrupt is the number of frames transferred by SPI between checks of pending interrupts
+ * \param [in] writeBuffer is the buffer with data that will be written, nullptr to send dummy data
+ * \param [out] readBuffer is the buffer with data that will be read, nullptr to ignore received data
+ * \param [in] size is the size of transfer, bytes
+ *
+ * \return pair with number of executed interrupt handlers and number of accesses to data register
+ */
+
+std::pair<size_t, size_t> runTransfer(const uint8_t wordLength, const size_t framesPerInterrupt,
+		const void* const writeBuffer, void* const readBuffer, const size_t size)
+{
+	distortos::architecture::EnableInterruptMaskingMock enableInterruptMaskingMock;
+	distortos::architecture::RestoreInterruptMaskingMock restoreInterruptMaskingMock;
+	ALLOW_CALL(enableInterruptMaskingMock, enableInterruptMasking()).RETURN(0u);
+	ALLOW_CALL(restoreInterruptMaskingMock, restoreInterruptMasking(_));
+
+	distortos::SpiRegistersMock spiRegistersMock;
+	SpiModel spiModel;
+	ALLOW_CALL(spiRegistersMock, read(_)).LR_RETURN(spiModel.read(_1));
+	ALLOW_CALL(spiRegistersMock, write(_, _)).LR_SIDE_EFFECT(spiModel.write(_1, _2));
+	ALLOW_CALL(spiRegistersMock, readDataRegister(_)).LR_RETURN(spiModel.readDataRegister(_1));
+	ALLOW_CALL(spiRegistersMock, writeDataRegister(_, _)).LR_SIDE_EFFECT(spiModel.writeDataRegister(_1, _2));
+	distortos::SpiRegistersMock::getProxyInstance() = &spiRegistersMock;
+
+	distortos::chip::ChipSpiMasterLowLevel chipSpiMasterLowLevel {
+			distortos::chip::ChipSpiMasterLowLevel::spi1Parameters};
+	REQUIRE(chipSpiMasterLowLevel.start() == 0);
+	REQUIRE(chipSpiMasterLowLevel.configure({}, 1000000, wordLength, {}, dummyData).first == 0);
+
+	TestSpiMasterBase spiMasterBase;
+	REQUIRE(chipSpiMasterLowLevel.startTransfer(spiMasterBase, writeBuffer, readBuffer, size) == 0);
+
+	size_t interrupts {};
+	for (size_t iteration {}; spiMasterBase.completed == false; ++iteration)
+	{
+		REQUIRE(iteration < size * 4);	// transfer stalled?
+		spiModel.shift(framesPerInterrupt);
+		if (spiModel.isInterruptPending() == true)
+		{
+			chipSpiMasterLowLevel.interruptHandler();
+			++interrupts;
+		}
+	}
+
+	REQUIRE(spiMasterBase.transferredBytes == size);
+	REQUIRE(spiModel.isInterruptPending() == false);
+	REQUIRE(chipSpiMasterLowLevel.stop() == 0);
+	distortos::SpiRegistersMock::getProxyInstance() = {};
+	return {interrupts, spiModel.getDataRegisterAccesses()};
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing transfers with write and read buffers", "[transfer]")
+{
+	for (const auto wordLength : wordLengths)
+		for (const auto framesPerInterrupt : framesPerInterrupts)
+			for (const auto size : sizes)
+			{
+				// transfers of long frames must have even size
+				if (wordLength > 8 && size % 2 != 0)
+					continue;
+
+				INFO("word length: " << static_cast<int>(wordLength) << ", frames per interrupt: " <<
+						framesPerInterrupt << ", size: " << size);
+
+				std::vector<uint8_t> writeBuffer (size);
+				for (size_t i {}; i < writeBuffer.size(); ++i)
+					writeBuffer[i] = i * 7 + 1;
+				std::vector<uint8_t> readBuffer (size);
+
+				const auto ret = runTransfer(wordLength, framesPerInterrupt, writeBuffer.data(), readBuffer.data(),
+						size);
+				REQUIRE(readBuffer == writeBuffer);
+				// single interrupt for each 16 bits, instead of separate TXE and RXNE interrupts for each frame
+				REQUIRE(ret.first <= (size + 1) / 2);
+				// two short frames are packed into single 16-bit access, only the last odd one is not
+				REQUIRE(ret.second == (size + 1) / 2 * 2);
+			}
+}
+
+TEST_CASE("Testing transfers without write buffer", "[transfer]")
+{
+	for (const auto wordLength : wordLengths)
+		for (const auto framesPerInterrupt : framesPerInterrupts)
+			for (const auto size : sizes)
+			{
+				// transfers of long frames must have even size
+				if (wordLength > 8 && size % 2 != 0)
+					continue;
+
+				INFO("word length: " << static_cast<int>(wordLength) << ", frames per interrupt: " <<
+						framesPerInterrupt << ", size: " << size);
+
+				std::vector<uint8_t> readBuffer (size);
+				runTransfer(wordLength, framesPerInterrupt, nullptr, readBuffer.data(), size);
+				for (size_t i {}; i < readBuffer.size(); ++i)
+					REQUIRE(readBuffer[i] == (wordLength <= 8 || i % 2 == 0 ? (dummyData & 0xff) : dummyData >> 8));
+			}
+}
+
+TEST_CASE("Testing transfers without read buffer", "[transfer]")
+{
+	for (const auto wordLength : wordLengths)
+		for (const auto framesPerInterrupt : framesPerInterrupts)
+			for (const auto size : sizes)
+			{
+				// transfers of long frames must have even size
+				if (wordLength > 8 && size % 2 != 0)
+					continue;
+
+				INFO("word length: " << static_cast<int>(wordLength) << ", frames per interrupt: " <<
+						framesPerInterrupt << ", size: " << size);
+
+				const std::vector<uint8_t> writeBuffer (size, 0x5a);
+				const auto ret = runTransfer(wordLength, framesPerInterrupt, writeBuffer.data(), nullptr, size);
+				REQUIRE(ret.first <= (size + 1) / 2);
+			}
+}
@@ -0,0 +1,194 @@
+/**
+ * \file
+ * \brief STM32F4 FLASH programming test cases
+ *
+ * This test checks whether STM32F4 FLASH programming functions access registers of FLASH peripheral in proper sequence.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/chip/STM32F4-FLASH.hpp"
+
+#include "distortos/chip/CMSIS-proxy.h"
+
+#include <array>
+
+using Register = distortos::FlashRegistersMock::Register;
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// mask with all error flags in FLASH->SR
+constexpr uint32_t errorFlags {FLASH_SR_WRPERR | FLASH_SR_PGAERR | FLASH_SR_PGPERR | FLASH_SR_PGSERR};
+
+/// expected value of PSIZE field in FLASH->CR for 3.3 V supply - x32 parallelism
+constexpr uint32_t psizeX32 {2 << FLASH_CR_PSIZE_Pos};
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing flash parameters", "[parameters]")
+{
+	REQUIRE(distortos::chip::flashProgramSize == 4);
+
+	REQUIRE(distortos::chip::getFlashSectorAddress(0) == 0x08000000);
+	REQUIRE(distortos::chip::getFlashSectorAddress(3) == 0x0800c000);
+	REQUIRE(distortos::chip::getFlashSectorAddress(4) == 0x08010000);
+	REQUIRE(distortos::chip::getFlashSectorAddress(5) == 0x08020000);
+	REQUIRE(distortos::chip::getFlashSectorAddress(11) == 0x080e0000);
+	REQUIRE(distortos::chip::getFlashSectorAddress(12) == 0x08100000);
+	REQUIRE(distortos::chip::getFlashSectorAddress(17) == 0x08120000);
+	REQUIRE(distortos::chip::getFlashSectorAddress(23) == 0x081e0000);
+
+	REQUIRE(distortos::chip::getFlashSectorSize(0) == 16 * 1024);
+	REQUIRE(distortos::chip::getFlashSectorSize(4) == 64 * 1024);
+	REQUIRE(distortos::chip::getFlashSectorSize(11) == 128 * 1024);
+	REQUIRE(distortos::chip::getFlashSectorSize(15) == 16 * 1024);
+	REQUIRE(distortos::chip::getFlashSectorSize(16) == 64 * 1024);
+	REQUIRE(distortos::chip::getFlashSectorSize(23) == 128 * 1024);
+}
+
+TEST_CASE("Testing unlockFlash() and lockFlash()", "[lock]")
+{
+	distortos::FlashRegistersMock flashRegistersMock;
+	distortos::FlashRegistersMock::getProxyInstance() = &flashRegistersMock;
+	trompeloeil::sequence sequence {};
+
+	SECTION("Unlocking locked flash writes both keys")
+	{
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence).RETURN(FLASH_CR_LOCK);
+		REQUIRE_CALL(flashRegistersMock, write(Register::keyr, 0x45670123u)).IN_SEQUENCE(sequence);
+		REQUIRE_CALL(flashRegistersMock, write(Register::keyr, 0xcdef89abu)).IN_SEQUENCE(sequence);
+		distortos::chip::unlockFlash();
+	}
+	SECTION("Unlocking already unlocked flash writes no keys")
+	{
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence).RETURN(0u);
+		distortos::chip::unlockFlash();
+	}
+	SECTION("Locking flash sets LOCK bit")
+	{
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence).RETURN(psizeX32);
+		REQUIRE_CALL(flashRegistersMock, write(Register::cr, psizeX32 | FLASH_CR_LOCK)).IN_SEQUENCE(sequence);
+		distortos::chip::lockFlash();
+	}
+
+	distortos::FlashRegistersMock::getProxyInstance() = {};
+}
+
+TEST_CASE("Testing programFlash()", "[program]")
+{
+	distortos::FlashRegistersMock flashRegistersMock;
+	distortos::FlashRegistersMock::getProxyInstance() = &flashRegistersMock;
+	trompeloeil::sequence sequence {};
+
+	std::array<uint32_t, 3> memory {{0xffffffff, 0xffffffff, 0xffffffff}};
+	const auto address = reinterpret_cast<uintptr_t>(memory.data());
+	// source is intentionally misaligned
+	const std::array<uint8_t, 9> buffer {{0xaa, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08}};
+
+	REQUIRE_CALL(flashRegistersMock, write(Register::sr, errorFlags)).IN_SEQUENCE(sequence);
+	REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence)
+			.RETURN(FLASH_CR_SER | 5 << FLASH_CR_SNB_Pos);
+	REQUIRE_CALL(flashRegistersMock, write(Register::cr, psizeX32 | FLASH_CR_PG)).IN_SEQUENCE(sequence);
+
+	SECTION("Successful program of two units")
+	{
+		// first unit - flash is busy once, second unit - flash is not busy at all
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence)
+				.LR_SIDE_EFFECT(REQUIRE(memory[0] == 0x04030201)).RETURN(FLASH_SR_BSY);
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence).RETURN(0u);
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence).RETURN(0u);
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence)
+				.LR_SIDE_EFFECT(REQUIRE(memory[1] == 0x08070605)).RETURN(0u);
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence).RETURN(0u);
+		REQUIRE_CALL(flashRegistersMock, write(Register::sr, 0u)).IN_SEQUENCE(sequence);
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence).RETURN(psizeX32 | FLASH_CR_PG);
+		REQUIRE_CALL(flashRegistersMock, write(Register::cr, psizeX32)).IN_SEQUENCE(sequence);
+
+		REQUIRE(distortos::chip::programFlash(address, buffer.data() + 1, 8) == 0);
+		REQUIRE(memory[0] == 0x04030201);
+		REQUIRE(memory[1] == 0x08070605);
+		REQUIRE(memory[2] == 0xffffffff);
+	}
+	SECTION("Program is stopped after first error")
+	{
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence).RETURN(0u);
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence).RETURN(FLASH_SR_PGPERR);
+		REQUIRE_CALL(flashRegistersMock, write(Register::sr, FLASH_SR_PGPERR)).IN_SEQUENCE(sequence);
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence).RETURN(psizeX32 | FLASH_CR_PG);
+		REQUIRE_CALL(flashRegistersMock, write(Register::cr, psizeX32)).IN_SEQUENCE(sequence);
+
+		REQUIRE(distortos::chip::programFlash(address, buffer.data() + 1, 8) == EIO);
+		REQUIRE(memory[0] == 0x04030201);
+		REQUIRE(memory[1] == 0xffffffff);
+	}
+
+	distortos::FlashRegistersMock::getProxyInstance() = {};
+}
+
+TEST_CASE("Testing sector erase", "[erase]")
+{
+	distortos::FlashRegistersMock flashRegistersMock;
+	distortos::FlashRegistersMock::getProxyInstance() = &flashRegistersMock;
+	trompeloeil::sequence sequence {};
+
+	SECTION("Sector of first bank")
+	{
+		constexpr uint32_t cr {psizeX32 | 7 << FLASH_CR_SNB_Pos | FLASH_CR_SER};
+		REQUIRE_CALL(flashRegistersMock, write(Register::sr, errorFlags)).IN_SEQUENCE(sequence);
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence).RETURN(FLASH_CR_PG);
+		REQUIRE_CALL(flashRegistersMock, write(Register::cr, cr)).IN_SEQUENCE(sequence);
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence).RETURN(cr);
+		REQUIRE_CALL(flashRegistersMock, write(Register::cr, cr | FLASH_CR_STRT)).IN_SEQUENCE(sequence);
+		distortos::chip::startFlashSectorErase(7);
+	}
+	SECTION("Sector of second bank")
+	{
+		constexpr uint32_t cr {psizeX32 | 17 << FLASH_CR_SNB_Pos | FLASH_CR_SER};
+		REQUIRE_CALL(flashRegistersMock, write(Register::sr, errorFlags)).IN_SEQUENCE(sequence);
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence).RETURN(0u);
+		REQUIRE_CALL(flashRegistersMock, write(Register::cr, cr)).IN_SEQUENCE(sequence);
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence).RETURN(cr);
+		REQUIRE_CALL(flashRegistersMock, write(Register::cr, cr | FLASH_CR_STRT)).IN_SEQUENCE(sequence);
+		distortos::chip::startFlashSectorErase(13);
+	}
+	SECTION("Busy flash")
+	{
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence).RETURN(FLASH_SR_BSY);
+		REQUIRE(distortos::chip::isFlashBusy() == true);
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence).RETURN(FLASH_SR_PGSERR);
+		REQUIRE(distortos::chip::isFlashBusy() == false);
+	}
+	SECTION("Successful finish")
+	{
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence).RETURN(0u);
+		REQUIRE_CALL(flashRegistersMock, write(Register::sr, 0u)).IN_SEQUENCE(sequence);
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence)
+				.RETURN(psizeX32 | 7 << FLASH_CR_SNB_Pos | FLASH_CR_SER);
+		REQUIRE_CALL(flashRegistersMock, write(Register::cr, psizeX32)).IN_SEQUENCE(sequence);
+		REQUIRE(distortos::chip::finishFlashOperation() == 0);
+	}
+	SECTION("Finish with error")
+	{
+		REQUIRE_CALL(flashRegistersMock, read(Register::sr)).IN_SEQUENCE(sequence).RETURN(FLASH_SR_WRPERR);
+		REQUIRE_CALL(flashRegistersMock, write(Register::sr, FLASH_SR_WRPERR)).IN_SEQUENCE(sequence);
+		REQUIRE_CALL(flashRegistersMock, read(Register::cr)).IN_SEQUENCE(sequence)
+				.RETURN(psizeX32 | 7 << FLASH_CR_SNB_Pos | FLASH_CR_SER);
+		REQUIRE_CALL(flashRegistersMock, write(Register::cr, psizeX32)).IN_SEQUENCE(sequence);
+		REQUIRE(distortos::chip::finishFlashOperation() == EIO);
+	}
+
+	distortos::FlashRegistersMock::getProxyInstance() = {};
+}
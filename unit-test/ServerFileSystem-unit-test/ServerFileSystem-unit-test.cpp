@@ -0,0 +1,402 @@
+/**
+ * \file
+ * \brief ServerFileSystem test cases
+ *
+ * This test checks whether ServerFileSystem properly merges small writes in write buffers of files and whether errors
+ * of deferred writes - including short writes - are reported by operations which caused them.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/FileSystem/server/ServerFileSystem.hpp"
+
+#include "distortos/FileSystem/tmp/TmpFileSystem.hpp"
+
+#include "distortos/internal/FileSystem/TmpStorage.hpp"
+
+#include "unit-test-common.hpp"
+
+#include <algorithm>
+#include <array>
+#include <thread>
+
+#include <fcntl.h>
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// TestTmpFileSystem class is a TmpFileSystem which counts writes of its files and optionally makes them short
+class TestTmpFileSystem : public distortos::TmpFileSystem
+{
+public:
+
+	/**
+	 * \brief TestTmpFileSystem's constructor
+	 *
+	 * \param [in] sizeLimit is the max total size of chunks, bytes, 0 means no limit
+	 * \param [in] chunkSize is the size of single chunk (including its header), bytes
+	 */
+
+	explicit TestTmpFileSystem(const size_t sizeLimit = {}, const size_t chunkSize = defaultChunkSize) :
+			TmpFileSystem{sizeLimit, chunkSize},
+			maxWriteSize_{SIZE_MAX},
+			writesCount_{}
+	{
+
+	}
+
+	/**
+	 * \return number of writes of files
+	 */
+
+	size_t getWritesCount() const
+	{
+		return writesCount_;
+	}
+
+	std::pair<int, std::unique_ptr<distortos::File>> openFile(const char* path, int flags) override;
+
+	/**
+	 * \param [in] maxWriteSize is the max number of bytes accepted by single write of file, further bytes are silently
+	 * ignored
+	 */
+
+	void setMaxWriteSize(const size_t maxWriteSize)
+	{
+		maxWriteSize_ = maxWriteSize;
+	}
+
+private:
+
+	friend class TestFile;
+
+	/// max number of bytes accepted by single write of file
+	size_t maxWriteSize_;
+
+	/// number of writes of files
+	size_t writesCount_;
+};
+
+/// TestFile class is a file of TestTmpFileSystem, which forwards all operations to file of TmpFileSystem
+class TestFile : public distortos::File
+{
+public:
+
+	/**
+	 * \brief TestFile's constructor
+	 *
+	 * \param [in] fileSystem is a reference to owner file system
+	 * \param [in] file is the opened file of TmpFileSystem
+	 */
+
+	TestFile(TestTmpFileSystem& fileSystem, std::unique_ptr<distortos::File> file) :
+			file_{std::move(file)},
+			fileSystem_{fileSystem}
+	{
+
+	}
+
+	int close() override
+	{
+		return file_->close();
+	}
+
+	std::pair<int, off_t> getPosition() override
+	{
+		return file_->getPosition();
+	}
+
+	std::pair<int, off_t> getSize() override
+	{
+		return file_->getSize();
+	}
+
+	std::pair<int, struct stat> getStatus() override
+	{
+		return file_->getStatus();
+	}
+
+	std::pair<int, bool> isATerminal() override
+	{
+		return file_->isATerminal();
+	}
+
+	int lock() override
+	{
+		return file_->lock();
+	}
+
+	std::pair<int, size_t> read(void* const buffer, const size_t size) override
+	{
+		return file_->read(buffer, size);
+	}
+
+	int rewind() override
+	{
+		return file_->rewind();
+	}
+
+	std::pair<int, off_t> seek(const Whence whence, const off_t offset) override
+	{
+		return file_->seek(whence, offset);
+	}
+
+	int synchronize() override
+	{
+		return file_->synchronize();
+	}
+
+	int unlock() override
+	{
+		return file_->unlock();
+	}
+
+	std::pair<int, size_t> write(const void* const buffer, const size_t size) override
+	{
+		++fileSystem_.writesCount_;
+		return file_->write(buffer, std::min(size, fileSystem_.maxWriteSize_));
+	}
+
+private:
+
+	/// opened file of TmpFileSystem
+	std::unique_ptr<distortos::File> file_;
+
+	/// reference to owner file system
+	TestTmpFileSystem& fileSystem_;
+};
+
+/// TestServerFileSystem class is a ServerFileSystem with server thread running on host
+class TestServerFileSystem : public distortos::ServerFileSystem
+{
+public:
+
+	/**
+	 * \brief TestServerFileSystem's constructor
+	 *
+	 * \param [in] fileSystem is a reference to underlying file system
+	 * \param [in] writeBufferSize is the size of write buffer allocated for each file opened for writing, bytes
+	 */
+
+	TestServerFileSystem(FileSystem& fileSystem, const size_t writeBufferSize) :
+			ServerFileSystem{fileSystem, writeBufferSize},
+			serverThread_{}
+	{
+
+	}
+
+	/**
+	 * \brief TestServerFileSystem's destructor
+	 *
+	 * Terminates server thread (if it was started) and waits for it to exit.
+	 */
+
+	~TestServerFileSystem() override
+	{
+		if (serverThread_.joinable() == false)
+			return;
+
+		requestServerExit();
+		serverThread_.join();
+	}
+
+protected:
+
+	int startServer() override
+	{
+		if (serverThread_.joinable() == false)
+			serverThread_ = std::thread{&ServerFileSystem::runServer, this};
+		return 0;
+	}
+
+private:
+
+	/// server thread
+	std::thread serverThread_;
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// path of tested file
+constexpr char filePath[] {"/file"};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Returns size of file in underlying file system.
+ *
+ * \param [in] fileSystem is a reference to ServerFileSystem
+ *
+ * \return size of tested file in underlying file system, bytes
+ */
+
+off_t getFileSize(distortos::ServerFileSystem& fileSystem)
+{
+	const auto ret = fileSystem.getFileStatus(filePath);
+	REQUIRE(ret.first == 0);
+	return ret.second.st_size;
+}
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| TestTmpFileSystem's public functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+std::pair<int, std::unique_ptr<distortos::File>> TestTmpFileSystem::openFile(const char* const path, const int flags)
+{
+	auto ret = TmpFileSystem::openFile(path, flags);
+	if (ret.first != 0)
+		return ret;
+
+	std::unique_ptr<distortos::File> file {new TestFile{*this, std::move(ret.second)}};
+	return {0, std::move(file)};
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing merging of writes", "[write]")
+{
+	TestTmpFileSystem tmpFileSystem;
+	TestServerFileSystem serverFileSystem {tmpFileSystem, 16};
+	REQUIRE(serverFileSystem.formatAndMount(nullptr) == 0);
+
+	std::array<uint8_t, 64> data;
+	for (size_t i {}; i < data.size(); ++i)
+		data[i] = i;
+
+	auto openRet = serverFileSystem.openFile(filePath, O_CREAT | O_WRONLY);
+	REQUIRE(openRet.first == 0);
+	auto& file = *openRet.second;
+
+	// small writes are merged in write buffer
+	auto ret = file.write(data.data(), 3);
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == 3);
+	ret = file.write(data.data() + 3, 10);
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == 10);
+	REQUIRE(tmpFileSystem.getWritesCount() == 0);
+	REQUIRE(getFileSize(serverFileSystem) == 0);
+
+	// write which doesn't fit in the buffer flushes it first
+	ret = file.write(data.data() + 13, 5);
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == 5);
+	REQUIRE(tmpFileSystem.getWritesCount() == 1);
+	REQUIRE(getFileSize(serverFileSystem) == 13);
+
+	// any other operation flushes the buffer
+	REQUIRE(file.synchronize() == 0);
+	REQUIRE(tmpFileSystem.getWritesCount() == 2);
+	REQUIRE(getFileSize(serverFileSystem) == 18);
+
+	// write which is not smaller than the buffer is forwarded directly
+	ret = file.write(data.data() + 18, 16);
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == 16);
+	REQUIRE(tmpFileSystem.getWritesCount() == 3);
+	REQUIRE(getFileSize(serverFileSystem) == 34);
+
+	ret = file.write(data.data() + 34, 4);
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == 4);
+	REQUIRE(file.close() == 0);
+	REQUIRE(tmpFileSystem.getWritesCount() == 4);
+	REQUIRE(getFileSize(serverFileSystem) == 38);
+
+	openRet = serverFileSystem.openFile(filePath, O_RDONLY);
+	REQUIRE(openRet.first == 0);
+	std::array<uint8_t, 64> buffer;
+	ret = openRet.second->read(buffer.data(), buffer.size());
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second == 38);
+	REQUIRE(std::equal(buffer.begin(), buffer.begin() + 38, data.begin()) == true);
+	REQUIRE(openRet.second->close() == 0);
+}
+
+TEST_CASE("Testing errors of deferred writes", "[error]")
+{
+	// file system with single chunk
+	constexpr size_t chunkSize {64};
+	constexpr off_t capacity {chunkSize - sizeof(distortos::internal::TmpChunk)};
+	std::array<uint8_t, 64> data {};
+
+	SECTION("Error of underlying file is reported by operation which flushed the buffer")
+	{
+		TestTmpFileSystem tmpFileSystem {chunkSize, chunkSize};
+		TestServerFileSystem serverFileSystem {tmpFileSystem, 64};
+		REQUIRE(serverFileSystem.formatAndMount(nullptr) == 0);
+
+		const auto openRet = serverFileSystem.openFile(filePath, O_CREAT | O_WRONLY);
+		REQUIRE(openRet.first == 0);
+		auto& file = *openRet.second;
+
+		auto ret = file.write(data.data(), 40);
+		REQUIRE(ret.first == 0);
+		REQUIRE(ret.second == 40);
+		ret = file.write(data.data(), 40);
+		REQUIRE(ret.first == 0);
+		REQUIRE(ret.second == 40);
+		REQUIRE(getFileSize(serverFileSystem) == 40);
+
+		REQUIRE(file.synchronize() == ENOSPC);
+		REQUIRE(getFileSize(serverFileSystem) == capacity);
+
+		// failed flush leaves the buffer empty, new data is not accepted when the buffer cannot be flushed
+		REQUIRE(file.synchronize() == 0);
+		ret = file.write(data.data(), 40);
+		REQUIRE(ret.first == 0);
+		REQUIRE(ret.second == 40);
+		ret = file.write(data.data(), 40);
+		REQUIRE(ret.first == ENOSPC);
+		REQUIRE(ret.second == 0);
+		REQUIRE(file.close() == 0);
+	}
+	SECTION("Short write of underlying file is reported as ENOSPC")
+	{
+		TestTmpFileSystem tmpFileSystem;
+		TestServerFileSystem serverFileSystem {tmpFileSystem, 32};
+		REQUIRE(serverFileSystem.formatAndMount(nullptr) == 0);
+		tmpFileSystem.setMaxWriteSize(8);
+
+		const auto openRet = serverFileSystem.openFile(filePath, O_CREAT | O_WRONLY);
+		REQUIRE(openRet.first == 0);
+		auto& file = *openRet.second;
+
+		auto ret = file.write(data.data(), 20);
+		REQUIRE(ret.first == 0);
+		REQUIRE(ret.second == 20);
+		REQUIRE(file.synchronize() == ENOSPC);
+		REQUIRE(getFileSize(serverFileSystem) == 8);
+
+		ret = file.write(data.data(), 12);
+		REQUIRE(ret.first == 0);
+		REQUIRE(ret.second == 12);
+		REQUIRE(file.close() == ENOSPC);
+		REQUIRE(getFileSize(serverFileSystem) == 16);
+
+		// short write which is not merged is returned directly
+		const auto reopenRet = serverFileSystem.openFile(filePath, O_WRONLY | O_APPEND);
+		REQUIRE(reopenRet.first == 0);
+		ret = reopenRet.second->write(data.data(), data.size());
+		REQUIRE(ret.first == 0);
+		REQUIRE(ret.second == 8);
+		REQUIRE(reopenRet.second->close() == 0);
+		REQUIRE(getFileSize(serverFileSystem) == 24);
+	}
+}
@@ -0,0 +1,261 @@
+/**
+ * \file
+ * \brief ThreadCache test cases
+ *
+ * This test checks whether ThreadCache properly selects size classes, transfers batches of blocks to and from backing
+ * heap and locks backing heap only for these transfers. Hidden test case tagged with "[benchmark]" compares throughput
+ * of several threads allocating and deallocating small blocks with ThreadCache and directly from a heap protected by
+ * single mutex - run it with `ThreadCache-unit-test [benchmark]`.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/memory/ThreadCache.hpp"
+
+#include "unit-test-common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using distortos::internal::ThreadCache;
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// ThreadCache which returns all free blocks to backing heap when destroyed
+class FlushingThreadCache : public ThreadCache
+{
+public:
+
+	/**
+	 * \brief FlushingThreadCache's destructor
+	 */
+
+	~FlushingThreadCache()
+	{
+		flush();
+	}
+};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// mutex which emulates the mutex protecting backing heap
+std::recursive_mutex backingHeapMutex;
+
+/// number of times backing heap was locked
+std::atomic<size_t> backingHeapLocksCount;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \return reference to ThreadCache of current thread
+ */
+
+ThreadCache& getThreadCache()
+{
+	thread_local FlushingThreadCache threadCache;
+	return threadCache;
+}
+
+/**
+ * \brief Runs allocation-heavy workload in several threads.
+ *
+ * Each thread keeps a small working set of blocks of various sizes and repeatedly replaces them.
+ *
+ * \param [in] threadsCount is the number of threads
+ * \param [in] iterations is the number of replaced blocks in each thread
+ * \param [in] allocate is the function used to allocate block of given size
+ * \param [in] deallocate is the function used to deallocate block
+ *
+ * \return duration of the workload, milliseconds
+ */
+
+template<typename Allocate, typename Deallocate>
+double runWorkload(const size_t threadsCount, const size_t iterations, const Allocate& allocate,
+		const Deallocate& deallocate)
+{
+	const auto begin = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (size_t threadIndex {}; threadIndex < threadsCount; ++threadIndex)
+		threads.emplace_back([iterations, &allocate, &deallocate]()
+				{
+					constexpr size_t workingSetSize {16};
+					void* workingSet[workingSetSize] {};
+					for (size_t i {}; i < iterations; ++i)
+					{
+						auto& block = workingSet[i % workingSetSize];
+						deallocate(block);
+						block = allocate(8 + (i * 37) % 200);
+					}
+					for (auto& block : workingSet)
+						deallocate(block);
+				});
+	for (auto& thread : threads)
+		thread.join();
+
+	return std::chrono::duration<double, std::milli>{std::chrono::steady_clock::now() - begin}.count();
+}
+
+}	// namespace
+
+namespace distortos
+{
+
+namespace internal
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+void lockBackingHeap()
+{
+	backingHeapMutex.lock();
+	++backingHeapLocksCount;
+}
+
+void unlockBackingHeap()
+{
+	backingHeapMutex.unlock();
+}
+
+}	// namespace internal
+
+}	// namespace distortos
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing getSizeClass()", "[getSizeClass]")
+{
+	REQUIRE(ThreadCache::getSizeClass(0) == 0);
+	REQUIRE(ThreadCache::getSizeClass(1) == 0);
+	REQUIRE(ThreadCache::getSizeClass(8) == 0);
+	REQUIRE(ThreadCache::getSizeClass(9) == 1);
+	REQUIRE(ThreadCache::getSizeClass(33) == 4);
+	REQUIRE(ThreadCache::getSizeClass(ThreadCache::maxCachedSize) == ThreadCache::sizeClassesCount - 1);
+	REQUIRE(ThreadCache::getSizeClass(ThreadCache::maxCachedSize + 1) == ThreadCache::sizeClassesCount);
+	REQUIRE(ThreadCache::getSizeClass(SIZE_MAX) == ThreadCache::sizeClassesCount);
+}
+
+TEST_CASE("Testing transfers between cache and backing heap", "[transfers]")
+{
+	ThreadCache threadCache;
+	const auto sizeClass = ThreadCache::getSizeClass(24);
+	backingHeapLocksCount = {};
+
+	SECTION("Allocation from empty cache refills it with a batch")
+	{
+		const auto block = threadCache.allocate(24);
+		REQUIRE(block != nullptr);
+		REQUIRE(reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t) == 0);
+		REQUIRE(backingHeapLocksCount == 1);
+		REQUIRE(threadCache.getFreeBlocksCount(sizeClass) == ThreadCache::batchSize - 1);
+
+		std::vector<void*> blocks {block};
+		for (size_t i {1}; i < ThreadCache::batchSize; ++i)
+			blocks.emplace_back(threadCache.allocate(24));
+		REQUIRE(backingHeapLocksCount == 1);
+		REQUIRE(threadCache.getFreeBlocksCount(sizeClass) == 0);
+
+		blocks.emplace_back(threadCache.allocate(24));
+		REQUIRE(backingHeapLocksCount == 2);
+
+		for (const auto allocatedBlock : blocks)
+			threadCache.deallocate(allocatedBlock);
+		REQUIRE(backingHeapLocksCount == 2);
+		REQUIRE(threadCache.getFreeBlocksCount(sizeClass) == 2 * ThreadCache::batchSize);
+	}
+	SECTION("Cache holding more than two batches returns one batch to backing heap")
+	{
+		std::vector<void*> blocks;
+		for (size_t i {}; i < 3 * ThreadCache::batchSize; ++i)
+			blocks.emplace_back(threadCache.allocate(24));
+		REQUIRE(backingHeapLocksCount == 3);
+
+		for (const auto block : blocks)
+			threadCache.deallocate(block);
+		REQUIRE(backingHeapLocksCount == 4);
+		REQUIRE(threadCache.getFreeBlocksCount(sizeClass) == 2 * ThreadCache::batchSize);
+	}
+	SECTION("Large blocks bypass the cache")
+	{
+		const auto block = threadCache.allocate(ThreadCache::maxCachedSize + 1);
+		REQUIRE(block != nullptr);
+		REQUIRE(reinterpret_cast<uintptr_t>(block) % alignof(std::max_align_t) == 0);
+		threadCache.deallocate(block);
+		REQUIRE(backingHeapLocksCount == 0);
+		for (size_t i {}; i < ThreadCache::sizeClassesCount; ++i)
+			REQUIRE(threadCache.getFreeBlocksCount(i) == 0);
+	}
+	SECTION("Block may be deallocated by another cache")
+	{
+		ThreadCache otherThreadCache;
+		const auto block = threadCache.allocate(24);
+		otherThreadCache.deallocate(block);
+		REQUIRE(otherThreadCache.getFreeBlocksCount(sizeClass) == 1);
+		REQUIRE(otherThreadCache.allocate(20) == block);
+		otherThreadCache.deallocate(block);
+		otherThreadCache.flush();
+	}
+	SECTION("Deallocation of nullptr is ignored")
+	{
+		threadCache.deallocate(nullptr);
+		REQUIRE(threadCache.getFreeBlocksCount(0) == 0);
+	}
+
+	threadCache.flush();
+	for (size_t i {}; i < ThreadCache::sizeClassesCount; ++i)
+		REQUIRE(threadCache.getFreeBlocksCount(i) == 0);
+}
+
+TEST_CASE("Benchmark of allocations from several threads", "[.][benchmark]")
+{
+	constexpr size_t threadsCount {4};
+	constexpr size_t iterations {1000000};
+
+	std::mutex heapMutex;
+	const auto lockedHeapDuration = runWorkload(threadsCount, iterations,
+			[&heapMutex](const size_t size)
+			{
+				const std::lock_guard<std::mutex> lockGuard {heapMutex};
+				return malloc(size);
+			},
+			[&heapMutex](void* const block)
+			{
+				const std::lock_guard<std::mutex> lockGuard {heapMutex};
+				free(block);
+			});
+
+	backingHeapLocksCount = {};
+	const auto threadCacheDuration = runWorkload(threadsCount, iterations,
+			[](const size_t size)
+			{
+				return getThreadCache().allocate(size);
+			},
+			[](void* const block)
+			{
+				getThreadCache().deallocate(block);
+			});
+
+	WARN(threadsCount << " threads x " << iterations << " allocations: heap with single mutex - " <<
+			lockedHeapDuration << " ms, " << 2 * threadsCount * iterations << " locks; ThreadCache - " <<
+			threadCacheDuration << " ms, " << backingHeapLocksCount << " locks");
+}
@@ -0,0 +1,302 @@
+/**
+ * \file
+ * \brief TmpStorage test cases
+ *
+ * This test checks whether TmpStorage properly manages the tree of files and directories, whether contents of files
+ * are properly stored in chunks and whether the limit of size is respected.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/FileSystem/TmpStorage.hpp"
+
+#include "unit-test-common.hpp"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// TmpChunk
+using TmpChunk = distortos::internal::TmpChunk;
+
+/// TmpCursor<TmpChunk>
+using ChunkCursor = distortos::internal::TmpCursor<TmpChunk>;
+
+/// TmpCursor<TmpNode>
+using NodeCursor = distortos::internal::TmpCursor<distortos::internal::TmpNode>;
+
+/// TmpNode
+using TmpNode = distortos::internal::TmpNode;
+
+/// TmpStorage
+using TmpStorage = distortos::internal::TmpStorage;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// size of single chunk used in tests, bytes
+constexpr size_t chunkSize {sizeof(TmpChunk) + 16};
+
+/// size of payload of single chunk used in tests, bytes
+constexpr size_t payloadSize {chunkSize - sizeof(TmpChunk)};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Lists names of nodes in directory.
+ *
+ * \param [in] storage is a reference to mounted storage
+ * \param [in] path is the path of directory
+ *
+ * \return vector with names of nodes in directory named by \a path
+ */
+
+std::vector<std::string> listDirectory(TmpStorage& storage, const char* const path)
+{
+	const auto ret = storage.find(path);
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second->directory == true);
+
+	std::vector<std::string> names;
+	NodeCursor cursor {};
+	for (size_t i {}; const auto node = storage.getChild(*ret.second, cursor, i); ++i)
+		names.emplace_back(node->name);
+	return names;
+}
+
+/**
+ * \brief Reads whole contents of file.
+ *
+ * \param [in] storage is a reference to mounted storage
+ * \param [in] file is a reference to file node
+ *
+ * \return contents of \a file
+ */
+
+std::string readFile(const TmpStorage& storage, TmpNode& file)
+{
+	std::string contents (file.size, '\0');
+	ChunkCursor cursor {};
+	REQUIRE(storage.read(file, cursor, 0, &contents[0], contents.size()) == file.size);
+	return contents;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing mount() with invalid configurations", "[mount]")
+{
+	alignas(TmpChunk) char pool[chunkSize * 4];
+
+	REQUIRE((TmpStorage{0, sizeof(TmpChunk), nullptr}.mount() == EINVAL));
+	REQUIRE((TmpStorage{0, chunkSize + 1, nullptr}.mount() == EINVAL));
+	REQUIRE((TmpStorage{sizeof(pool) - 1, chunkSize, pool + 1}.mount() == EINVAL));
+	REQUIRE((TmpStorage{chunkSize - 1, chunkSize, pool}.mount() == EINVAL));
+
+	TmpStorage storage {sizeof(pool), chunkSize, pool};
+	REQUIRE(storage.create("file", false).first == EBADF);
+	REQUIRE(storage.mount() == 0);
+	REQUIRE(storage.isMounted() == true);
+	REQUIRE(storage.getChunksLimit() == 4);
+	REQUIRE(storage.mount() == EBUSY);
+	storage.unmount();
+	REQUIRE(storage.isMounted() == false);
+	REQUIRE(storage.find("/").first == EBADF);
+
+	TmpStorage unlimitedStorage {0, chunkSize, nullptr};
+	REQUIRE(unlimitedStorage.mount() == 0);
+	REQUIRE(unlimitedStorage.getChunksLimit() == SIZE_MAX);
+}
+
+TEST_CASE("Testing tree of files and directories", "[tree]")
+{
+	TmpStorage storage {0, chunkSize, nullptr};
+	REQUIRE(storage.mount() == 0);
+
+	REQUIRE(storage.create("a", true).first == 0);
+	REQUIRE(storage.create("/a/b/", true).first == 0);
+	REQUIRE(storage.create("a/b/file", false).first == 0);
+	REQUIRE(storage.create("a/other", false).first == 0);
+
+	SECTION("Lookups")
+	{
+		for (const auto path : {"", "/", "//", ".", "..", "a/..", "a/b/../.."})
+		{
+			const auto ret = storage.find(path);
+			REQUIRE(ret.first == 0);
+			REQUIRE(ret.second->parent == nullptr);
+		}
+
+		REQUIRE(storage.find("a/b/file").first == 0);
+		REQUIRE(storage.find("a//b/./file").first == 0);
+		REQUIRE(storage.find("a/b/../other").first == 0);
+		REQUIRE(storage.find(nullptr).first == EINVAL);
+		REQUIRE(storage.find("nonexistent").first == ENOENT);
+		REQUIRE(storage.find("a/b/fil").first == ENOENT);
+		REQUIRE(storage.find("nonexistent/file").first == ENOENT);
+		REQUIRE(storage.find("a/other/").first == ENOTDIR);
+		REQUIRE(storage.find("a/other/file").first == ENOTDIR);
+		const std::string tooLong (256, 'x');
+		REQUIRE(storage.find(tooLong.c_str()).first == ENAMETOOLONG);
+		REQUIRE(storage.create(tooLong.c_str(), false).first == ENAMETOOLONG);
+	}
+	SECTION("Creating")
+	{
+		REQUIRE(storage.create("a", false).first == EEXIST);
+		REQUIRE(storage.create("a/b/file", true).first == EEXIST);
+		REQUIRE(storage.create("/", true).first == EEXIST);
+		REQUIRE(storage.create("a/..", true).first == EEXIST);
+		REQUIRE(storage.create("new/", false).first == ENOTDIR);
+		REQUIRE(storage.create("nonexistent/new", false).first == ENOENT);
+		REQUIRE(storage.create("a/other/new", false).first == ENOTDIR);
+		REQUIRE((listDirectory(storage, "a") == std::vector<std::string>{"other", "b"}));
+	}
+	SECTION("Removing")
+	{
+		REQUIRE(storage.remove("a") == ENOTEMPTY);
+		REQUIRE(storage.remove("a/b") == ENOTEMPTY);
+		REQUIRE(storage.remove("/") == EINVAL);
+		REQUIRE(storage.remove("a/.") == EINVAL);
+		REQUIRE(storage.remove("a/nonexistent") == ENOENT);
+		REQUIRE(storage.remove("a/other/") == ENOTDIR);
+
+		const auto ret = storage.find("a/other");
+		REQUIRE(ret.first == 0);
+		++ret.second->openedCount;
+		REQUIRE(storage.remove("a/other") == EBUSY);
+		--ret.second->openedCount;
+
+		REQUIRE(storage.remove("a/other") == 0);
+		REQUIRE(storage.remove("a/b/file") == 0);
+		REQUIRE(storage.remove("a/b/") == 0);
+		REQUIRE(storage.remove("a") == 0);
+		REQUIRE(listDirectory(storage, "/").empty() == true);
+	}
+	SECTION("Renaming")
+	{
+		REQUIRE(storage.rename("a/other", "a/b") == EEXIST);
+		REQUIRE(storage.rename("a", "a/b/c") == EINVAL);
+		REQUIRE(storage.rename("a", "a/c") == EINVAL);
+		REQUIRE(storage.rename("/", "c") == EINVAL);
+		REQUIRE(storage.rename("nonexistent", "c") == ENOENT);
+		REQUIRE(storage.rename("a/other", "c/") == ENOTDIR);
+		REQUIRE(storage.rename("a/other", "a/other") == 0);
+
+		const auto ret = storage.find("a/b");
+		REQUIRE(ret.first == 0);
+		REQUIRE(storage.rename("a/b", "renamed-directory") == 0);
+		REQUIRE(storage.find("renamed-directory").second == ret.second);
+		REQUIRE(storage.find("renamed-directory/file").first == 0);
+		REQUIRE(storage.find("a/b").first == ENOENT);
+		REQUIRE(storage.rename("a/other", "renamed-directory/file-with-much-longer-name") == 0);
+		REQUIRE((listDirectory(storage, "renamed-directory") ==
+				std::vector<std::string>{"file-with-much-longer-name", "file"}));
+		REQUIRE(listDirectory(storage, "a").empty() == true);
+	}
+	SECTION("Cursor of directory is invalidated by changes")
+	{
+		const auto ret = storage.find("a");
+		REQUIRE(ret.first == 0);
+		NodeCursor cursor {};
+		REQUIRE(storage.getChild(*ret.second, cursor, 1) != nullptr);
+		REQUIRE(storage.remove("a/other") == 0);
+		REQUIRE(std::string{storage.getChild(*ret.second, cursor, 0)->name} == "b");
+		REQUIRE(storage.getChild(*ret.second, cursor, 1) == nullptr);
+	}
+
+	storage.unmount();
+}
+
+TEST_CASE("Testing contents of files", "[file]")
+{
+	alignas(TmpChunk) char pool[chunkSize * 4];
+	TmpStorage storage {sizeof(pool), chunkSize, pool};
+	REQUIRE(storage.mount() == 0);
+
+	const auto ret = storage.create("file", false);
+	REQUIRE(ret.first == 0);
+	auto& file = *ret.second;
+	ChunkCursor cursor {};
+
+	SECTION("Writes spanning multiple chunks")
+	{
+		std::string contents;
+		for (size_t i {}; i < payloadSize * 3; ++i)
+			contents += static_cast<char>('a' + i % 26);
+
+		REQUIRE(storage.write(file, cursor, 0, contents.data(), 5) == (std::pair<int, size_t>{0, 5}));
+		REQUIRE(storage.write(file, cursor, 5, contents.data() + 5, contents.size() - 5) ==
+				(std::pair<int, size_t>{0, contents.size() - 5}));
+		REQUIRE(storage.getUsedChunks() == 3);
+		REQUIRE(readFile(storage, file) == contents);
+
+		std::string part (payloadSize, '\0');
+		REQUIRE(storage.read(file, cursor, payloadSize / 2, &part[0], part.size()) == part.size());
+		REQUIRE(part == contents.substr(payloadSize / 2, payloadSize));
+		REQUIRE(storage.read(file, cursor, contents.size() - 1, &part[0], part.size()) == 1);
+		REQUIRE(storage.read(file, cursor, contents.size(), &part[0], part.size()) == 0);
+
+		REQUIRE(storage.write(file, cursor, 1, "XYZ", 3) == (std::pair<int, size_t>{0, 3}));
+		contents.replace(1, 3, "XYZ");
+		REQUIRE(readFile(storage, file) == contents);
+	}
+	SECTION("Writes beyond the end of file fill the gap with zeroes")
+	{
+		REQUIRE(storage.write(file, cursor, payloadSize + 2, "end", 3) == (std::pair<int, size_t>{0, 3}));
+		REQUIRE(file.size == payloadSize + 5);
+		REQUIRE(readFile(storage, file) == std::string(payloadSize + 2, '\0') + "end");
+	}
+	SECTION("Size limit is respected")
+	{
+		const std::string contents (payloadSize * 5, 'x');
+		REQUIRE(storage.write(file, cursor, 0, contents.data(), contents.size()) ==
+				(std::pair<int, size_t>{ENOSPC, payloadSize * 4}));
+		REQUIRE(storage.getUsedChunks() == 4);
+		REQUIRE(file.size == payloadSize * 4);
+		REQUIRE(storage.write(file, cursor, file.size, "x", 1) == (std::pair<int, size_t>{ENOSPC, 0}));
+
+		const auto otherRet = storage.create("other", false);
+		REQUIRE(otherRet.first == 0);
+		ChunkCursor otherCursor {};
+		REQUIRE(storage.write(*otherRet.second, otherCursor, 0, "x", 1) == (std::pair<int, size_t>{ENOSPC, 0}));
+
+		storage.truncate(file);
+		REQUIRE(file.size == 0);
+		REQUIRE(storage.getUsedChunks() == 0);
+		REQUIRE(storage.write(*otherRet.second, otherCursor, 0, contents.data(), payloadSize * 4) ==
+				(std::pair<int, size_t>{0, payloadSize * 4}));
+		REQUIRE(storage.remove("other") == 0);
+		REQUIRE(storage.getUsedChunks() == 0);
+	}
+	SECTION("Cursor of file is invalidated by truncation")
+	{
+		const std::string contents (payloadSize * 3, 'x');
+		REQUIRE(storage.write(file, cursor, 0, contents.data(), contents.size()).first == 0);
+		char byte;
+		REQUIRE(storage.read(file, cursor, payloadSize, &byte, 1) == 1);
+		storage.truncate(file);
+		const std::string newContents (payloadSize * 2, 'y');
+		REQUIRE(storage.write(file, cursor, 0, newContents.data(), newContents.size()).first == 0);
+		REQUIRE(storage.read(file, cursor, 1, &byte, 1) == 1);
+		REQUIRE(byte == 'y');
+	}
+
+	storage.unmount();
+	REQUIRE(storage.getUsedChunks() == 0);
+}
@@ -0,0 +1,218 @@
+/**
+ * \file
+ * \brief XipImage test cases
+ *
+ * This test checks whether images generated by scripts/packXipImage.py are properly validated and whether lookups of
+ * paths and iteration over directories in such images work as expected.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/FileSystem/XipImage.hpp"
+
+#include "unit-test-common.hpp"
+
+#include <string>
+#include <vector>
+
+#include <cstring>
+
+extern "C"
+{
+
+/// image generated by scripts/packXipImage.py
+extern const uint8_t xipImage[];
+
+/// size of image generated by scripts/packXipImage.py, bytes
+extern const size_t xipImageSize;
+
+}	// extern "C"
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local types
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// XipImage::Entry
+using Entry = distortos::internal::XipImage::Entry;
+
+/// XipImage
+using XipImage = distortos::internal::XipImage;
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Lists names of entries in directory.
+ *
+ * \param [in] image is a reference to mounted image
+ * \param [in] directory is a reference to entry of directory
+ *
+ * \return vector with names of entries in \a directory
+ */
+
+std::vector<std::string> listDirectory(const XipImage& image, const Entry& directory)
+{
+	std::vector<std::string> names;
+	const auto descendants = image.getDescendants(directory);
+	for (auto entry = descendants.first; entry < descendants.second;
+			entry += 1 + (entry->type == XipImage::directoryType ? entry->size : 0))
+		names.emplace_back(image.getName(*entry));
+	return names;
+}
+
+/**
+ * \brief Reads contents of file.
+ *
+ * \param [in] image is a reference to mounted image
+ * \param [in] path is the path of file
+ *
+ * \return contents of file named by \a path
+ */
+
+std::string readFile(const XipImage& image, const char* const path)
+{
+	const auto ret = image.find(path);
+	REQUIRE(ret.first == 0);
+	REQUIRE(ret.second->type == uint8_t{XipImage::fileType});
+	return {reinterpret_cast<const char*>(image.getData(*ret.second)), ret.second->size};
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing mount() with invalid images", "[mount]")
+{
+	XipImage image;
+
+	REQUIRE(image.mount(nullptr, xipImageSize) == EINVAL);
+	REQUIRE(image.mount(xipImage + 1, xipImageSize - 1) == EINVAL);
+	REQUIRE(image.mount(xipImage, 19) == EILSEQ);
+	REQUIRE(image.mount(xipImage, xipImageSize - 1) == EILSEQ);
+	REQUIRE(image.isMounted() == false);
+
+	SECTION("Any corruption of metadata is detected")
+	{
+		uint32_t metadataSize;
+		memcpy(&metadataSize, xipImage + 12, sizeof(metadataSize));
+		REQUIRE(metadataSize < xipImageSize);
+
+		std::vector<uint32_t> copy ((xipImageSize + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+		const auto copyUint8 = reinterpret_cast<uint8_t*>(copy.data());
+		memcpy(copyUint8, xipImage, xipImageSize);
+		for (size_t i {}; i < metadataSize; ++i)
+		{
+			copyUint8[i] ^= 0x10;
+			REQUIRE(image.mount(copyUint8, xipImageSize) == EILSEQ);
+			copyUint8[i] ^= 0x10;
+		}
+
+		REQUIRE(image.mount(copyUint8, xipImageSize) == 0);
+	}
+	SECTION("Already mounted image cannot be mounted again")
+	{
+		REQUIRE(image.mount(xipImage, xipImageSize) == 0);
+		REQUIRE(image.isMounted() == true);
+		REQUIRE(image.mount(xipImage, xipImageSize) == EBUSY);
+		image.unmount();
+		REQUIRE(image.isMounted() == false);
+		REQUIRE(image.mount(xipImage, xipImageSize) == 0);
+	}
+}
+
+TEST_CASE("Testing find()", "[find]")
+{
+	XipImage image;
+	REQUIRE(image.mount(xipImage, xipImageSize) == 0);
+	REQUIRE(image.getImageSize() == xipImageSize);
+
+	SECTION("Root directory")
+	{
+		for (const auto path : {"", "/", "//"})
+		{
+			const auto ret = image.find(path);
+			REQUIRE(ret.first == 0);
+			REQUIRE(ret.second->type == uint8_t{XipImage::directoryType});
+			REQUIRE(ret.second->size == image.getEntriesCount());
+		}
+	}
+	SECTION("Files")
+	{
+		REQUIRE(readFile(image, "index.html") == "<html><body>distortos</body></html>\n");
+		REQUIRE(readFile(image, "/index.html") == "<html><body>distortos</body></html>\n");
+		REQUIRE(readFile(image, "empty") == "");
+		REQUIRE(readFile(image, "fonts.txt") == "font-8.bin, font-16.bin\n");
+		REQUIRE(readFile(image, "/fonts/font-8.bin") == "8x8 glyphs");
+		REQUIRE(readFile(image, "fonts/font-16.bin") == "16x16 glyphs");
+		REQUIRE(readFile(image, "deep/a/b/c/file.txt") == "deep");
+		for (int i {}; i < 64; ++i)
+		{
+			const auto path = "lookup/table" + std::to_string(i) + ".bin";
+			REQUIRE(readFile(image, path.c_str()) == "table " + std::to_string(i));
+		}
+	}
+	SECTION("Contents of files are aligned as requested")
+	{
+		for (const auto path : {"index.html", "fonts/font-8.bin", "fonts/font-16.bin", "lookup/table13.bin"})
+		{
+			const auto ret = image.find(path);
+			REQUIRE(ret.first == 0);
+			REQUIRE(reinterpret_cast<uintptr_t>(image.getData(*ret.second)) % 16 == 0);
+		}
+	}
+	SECTION("Directories")
+	{
+		for (const auto path : {"fonts", "/fonts/", "deep/a/b", "empty-directory", "lookup"})
+		{
+			const auto ret = image.find(path);
+			REQUIRE(ret.first == 0);
+			REQUIRE(ret.second->type == uint8_t{XipImage::directoryType});
+		}
+	}
+	SECTION("Errors")
+	{
+		REQUIRE(image.find(nullptr).first == EINVAL);
+		REQUIRE(image.find("nonexistent").first == ENOENT);
+		REQUIRE(image.find("font").first == ENOENT);
+		REQUIRE(image.find("fonts/font-32.bin").first == ENOENT);
+		REQUIRE(image.find("nonexistent/file").first == ENOENT);
+		REQUIRE(image.find("fonts//font-8.bin").first == ENOENT);
+		REQUIRE(image.find("deep/a/x/c/file.txt").first == ENOENT);
+		REQUIRE(image.find("index.html/").first == ENOTDIR);
+		REQUIRE(image.find("index.html/file").first == ENOTDIR);
+		REQUIRE(image.find("deep/a/b/c/file.txt/x/y").first == ENOTDIR);
+		const std::string tooLong (UINT16_MAX + 1, 'x');
+		REQUIRE(image.find(tooLong.c_str()).first == ENAMETOOLONG);
+	}
+}
+
+TEST_CASE("Testing iteration over directories", "[directory]")
+{
+	XipImage image;
+	REQUIRE(image.mount(xipImage, xipImageSize) == 0);
+
+	const auto list = [&image](const char* const path)
+			{
+				const auto ret = image.find(path);
+				REQUIRE(ret.first == 0);
+				return listDirectory(image, *ret.second);
+			};
+
+	REQUIRE((list("/") == std::vector<std::string>{"deep", "empty", "empty-directory", "fonts", "fonts.txt",
+			"index.html", "lookup"}));
+	REQUIRE((list("fonts") == std::vector<std::string>{"font-16.bin", "font-8.bin"}));
+	REQUIRE((list("deep") == std::vector<std::string>{"a"}));
+	REQUIRE((list("deep/a/b/c") == std::vector<std::string>{"file.txt"}));
+	REQUIRE(list("empty-directory").empty() == true);
+	REQUIRE(list("lookup").size() == 64);
+}
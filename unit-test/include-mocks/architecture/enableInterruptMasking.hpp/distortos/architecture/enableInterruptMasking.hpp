@@ -2,7 +2,7 @@
  * \file
  * \brief Mocks of enableInterruptMasking()
  *
- * \author Copyright (C) 2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2017-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -55,7 +55,7 @@ private:
 	}
 };
 
-InterruptMask enableInterruptMasking()
+inline InterruptMask enableInterruptMasking()
 {
 	return EnableInterruptMaskingMock::getInstance().enableInterruptMasking();
 }
@@ -0,0 +1,65 @@
+/**
+ * \file
+ * \brief Mocks of isInInterruptContext()
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UNIT_TEST_INCLUDE_MOCKS_ARCHITECTURE_ISININTERRUPTCONTEXT_HPP_DISTORTOS_ARCHITECTURE_ISININTERRUPTCONTEXT_HPP_
+#define UNIT_TEST_INCLUDE_MOCKS_ARCHITECTURE_ISININTERRUPTCONTEXT_HPP_DISTORTOS_ARCHITECTURE_ISININTERRUPTCONTEXT_HPP_
+
+#include "unit-test-common.hpp"
+
+namespace distortos
+{
+
+namespace architecture
+{
+
+class IsInInterruptContextMock
+{
+public:
+
+	IsInInterruptContextMock()
+	{
+		REQUIRE(getInstanceInternal() == nullptr);
+		getInstanceInternal() = this;
+	}
+
+	~IsInInterruptContextMock()
+	{
+		REQUIRE(getInstanceInternal() != nullptr);
+		getInstanceInternal() = {};
+	}
+
+	MAKE_CONST_MOCK0(isInInterruptContext, bool());
+
+	static const IsInInterruptContextMock& getInstance()
+	{
+		REQUIRE(getInstanceInternal() != nullptr);
+		return *getInstanceInternal();
+	}
+
+private:
+
+	static const IsInInterruptContextMock*& getInstanceInternal()
+	{
+		static const IsInInterruptContextMock* instance;
+		return instance;
+	}
+};
+
+inline bool isInInterruptContext()
+{
+	return IsInInterruptContextMock::getInstance().isInInterruptContext();
+}
+
+}	// namespace architecture
+
+}	// namespace distortos
+
+#endif	// UNIT_TEST_INCLUDE_MOCKS_ARCHITECTURE_ISININTERRUPTCONTEXT_HPP_DISTORTOS_ARCHITECTURE_ISININTERRUPTCONTEXT_HPP_
@@ -0,0 +1,320 @@
+/**
+ * \file
+ * \brief Mock of CMSIS-proxy.h with fake FLASH peripheral of STM32F4 and fake RCC and SPI peripherals of STM32
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UNIT_TEST_INCLUDE_MOCKS_CHIP_CMSIS_PROXY_H_DISTORTOS_CHIP_CMSIS_PROXY_H_
+#define UNIT_TEST_INCLUDE_MOCKS_CHIP_CMSIS_PROXY_H_DISTORTOS_CHIP_CMSIS_PROXY_H_
+
+#include "unit-test-common.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#define FLASH_SR_WRPERR_Pos		(4U)
+#define FLASH_SR_WRPERR_Msk		(0x1U << FLASH_SR_WRPERR_Pos)
+#define FLASH_SR_WRPERR			FLASH_SR_WRPERR_Msk
+#define FLASH_SR_PGAERR_Pos		(5U)
+#define FLASH_SR_PGAERR_Msk		(0x1U << FLASH_SR_PGAERR_Pos)
+#define FLASH_SR_PGAERR			FLASH_SR_PGAERR_Msk
+#define FLASH_SR_PGPERR_Pos		(6U)
+#define FLASH_SR_PGPERR_Msk		(0x1U << FLASH_SR_PGPERR_Pos)
+#define FLASH_SR_PGPERR			FLASH_SR_PGPERR_Msk
+#define FLASH_SR_PGSERR_Pos		(7U)
+#define FLASH_SR_PGSERR_Msk		(0x1U << FLASH_SR_PGSERR_Pos)
+#define FLASH_SR_PGSERR			FLASH_SR_PGSERR_Msk
+#define FLASH_SR_BSY_Pos		(16U)
+#define FLASH_SR_BSY_Msk		(0x1U << FLASH_SR_BSY_Pos)
+#define FLASH_SR_BSY			FLASH_SR_BSY_Msk
+
+#define FLASH_CR_PG_Pos			(0U)
+#define FLASH_CR_PG_Msk			(0x1U << FLASH_CR_PG_Pos)
+#define FLASH_CR_PG				FLASH_CR_PG_Msk
+#define FLASH_CR_SER_Pos		(1U)
+#define FLASH_CR_SER_Msk		(0x1U << FLASH_CR_SER_Pos)
+#define FLASH_CR_SER			FLASH_CR_SER_Msk
+#define FLASH_CR_SNB_Pos		(3U)
+#define FLASH_CR_SNB_Msk		(0x1FU << FLASH_CR_SNB_Pos)
+#define FLASH_CR_SNB			FLASH_CR_SNB_Msk
+#define FLASH_CR_PSIZE_Pos		(8U)
+#define FLASH_CR_PSIZE_Msk		(0x3U << FLASH_CR_PSIZE_Pos)
+#define FLASH_CR_PSIZE			FLASH_CR_PSIZE_Msk
+#define FLASH_CR_STRT_Pos		(16U)
+#define FLASH_CR_STRT_Msk		(0x1U << FLASH_CR_STRT_Pos)
+#define FLASH_CR_STRT			FLASH_CR_STRT_Msk
+#define FLASH_CR_LOCK_Pos		(31U)
+#define FLASH_CR_LOCK_Msk		(0x1U << FLASH_CR_LOCK_Pos)
+#define FLASH_CR_LOCK			FLASH_CR_LOCK_Msk
+
+#define RCC_APB2ENR_SPI1EN_Pos		(12U)
+#define RCC_APB2ENR_SPI1EN_Msk		(0x1U << RCC_APB2ENR_SPI1EN_Pos)
+#define RCC_APB2ENR_SPI1EN			RCC_APB2ENR_SPI1EN_Msk
+
+#define RCC_APB2RSTR_SPI1RST_Pos	(12U)
+#define RCC_APB2RSTR_SPI1RST_Msk	(0x1U << RCC_APB2RSTR_SPI1RST_Pos)
+#define RCC_APB2RSTR_SPI1RST		RCC_APB2RSTR_SPI1RST_Msk
+
+#define SPI_CR1_CPHA_Pos		(0U)
+#define SPI_CR1_CPHA_Msk		(0x1U << SPI_CR1_CPHA_Pos)
+#define SPI_CR1_CPHA			SPI_CR1_CPHA_Msk
+#define SPI_CR1_CPOL_Pos		(1U)
+#define SPI_CR1_CPOL_Msk		(0x1U << SPI_CR1_CPOL_Pos)
+#define SPI_CR1_CPOL			SPI_CR1_CPOL_Msk
+#define SPI_CR1_MSTR_Pos		(2U)
+#define SPI_CR1_MSTR_Msk		(0x1U << SPI_CR1_MSTR_Pos)
+#define SPI_CR1_MSTR			SPI_CR1_MSTR_Msk
+#define SPI_CR1_BR_Pos			(3U)
+#define SPI_CR1_BR_Msk			(0x7U << SPI_CR1_BR_Pos)
+#define SPI_CR1_BR				SPI_CR1_BR_Msk
+#define SPI_CR1_SPE_Pos			(6U)
+#define SPI_CR1_SPE_Msk			(0x1U << SPI_CR1_SPE_Pos)
+#define SPI_CR1_SPE				SPI_CR1_SPE_Msk
+#define SPI_CR1_LSBFIRST_Pos	(7U)
+#define SPI_CR1_LSBFIRST_Msk	(0x1U << SPI_CR1_LSBFIRST_Pos)
+#define SPI_CR1_LSBFIRST		SPI_CR1_LSBFIRST_Msk
+#define SPI_CR1_SSI_Pos			(8U)
+#define SPI_CR1_SSI_Msk			(0x1U << SPI_CR1_SSI_Pos)
+#define SPI_CR1_SSI				SPI_CR1_SSI_Msk
+#define SPI_CR1_SSM_Pos			(9U)
+#define SPI_CR1_SSM_Msk			(0x1U << SPI_CR1_SSM_Pos)
+#define SPI_CR1_SSM				SPI_CR1_SSM_Msk
+
+#define SPI_CR2_ERRIE_Pos		(5U)
+#define SPI_CR2_ERRIE_Msk		(0x1U << SPI_CR2_ERRIE_Pos)
+#define SPI_CR2_ERRIE			SPI_CR2_ERRIE_Msk
+#define SPI_CR2_RXNEIE_Pos		(6U)
+#define SPI_CR2_RXNEIE_Msk		(0x1U << SPI_CR2_RXNEIE_Pos)
+#define SPI_CR2_RXNEIE			SPI_CR2_RXNEIE_Msk
+#define SPI_CR2_TXEIE_Pos		(7U)
+#define SPI_CR2_TXEIE_Msk		(0x1U << SPI_CR2_TXEIE_Pos)
+#define SPI_CR2_TXEIE			SPI_CR2_TXEIE_Msk
+#define SPI_CR2_DS_Pos			(8U)
+#define SPI_CR2_DS_Msk			(0xFU << SPI_CR2_DS_Pos)
+#define SPI_CR2_DS				SPI_CR2_DS_Msk
+#define SPI_CR2_FRXTH_Pos		(12U)
+#define SPI_CR2_FRXTH_Msk		(0x1U << SPI_CR2_FRXTH_Pos)
+#define SPI_CR2_FRXTH			SPI_CR2_FRXTH_Msk
+
+#define SPI_SR_RXNE_Pos			(0U)
+#define SPI_SR_RXNE_Msk			(0x1U << SPI_SR_RXNE_Pos)
+#define SPI_SR_RXNE				SPI_SR_RXNE_Msk
+#define SPI_SR_TXE_Pos			(1U)
+#define SPI_SR_TXE_Msk			(0x1U << SPI_SR_TXE_Pos)
+#define SPI_SR_TXE				SPI_SR_TXE_Msk
+#define SPI_SR_CRCERR_Pos		(4U)
+#define SPI_SR_CRCERR_Msk		(0x1U << SPI_SR_CRCERR_Pos)
+#define SPI_SR_CRCERR			SPI_SR_CRCERR_Msk
+#define SPI_SR_MODF_Pos			(5U)
+#define SPI_SR_MODF_Msk			(0x1U << SPI_SR_MODF_Pos)
+#define SPI_SR_MODF				SPI_SR_MODF_Msk
+#define SPI_SR_OVR_Pos			(6U)
+#define SPI_SR_OVR_Msk			(0x1U << SPI_SR_OVR_Pos)
+#define SPI_SR_OVR				SPI_SR_OVR_Msk
+#define SPI_SR_BSY_Pos			(7U)
+#define SPI_SR_BSY_Msk			(0x1U << SPI_SR_BSY_Pos)
+#define SPI_SR_BSY				SPI_SR_BSY_Msk
+
+/// count leading zeros
+#define __CLZ					__builtin_clz
+
+/// fake FLASH peripheral
+#define FLASH					(&distortos::FakeFlash::getInstance())
+
+/// base address of fake RCC peripheral
+#define RCC_BASE				(reinterpret_cast<uintptr_t>(&distortos::getFakeRcc()))
+
+/// base address of fake SPI1 peripheral
+#define SPI1_BASE				(reinterpret_cast<uintptr_t>(&distortos::FakeSpi::getInstance()))
+
+/// fake registers of RCC peripheral, only those which are used by tested code, all accesses go directly to memory
+struct RCC_TypeDef
+{
+	uint32_t APB1ENR;
+	uint32_t APB2ENR;
+	uint32_t APB1RSTR;
+	uint32_t APB2RSTR;
+};
+
+namespace distortos
+{
+
+/// mock of bus accesses to registers of FLASH peripheral
+class FlashRegistersMock
+{
+public:
+
+	/// registers of FLASH peripheral
+	enum class Register
+	{
+		acr,
+		keyr,
+		optkeyr,
+		sr,
+		cr,
+		optcr,
+	};
+
+	MAKE_MOCK1(read, uint32_t(Register));
+	MAKE_MOCK2(write, void(Register, uint32_t));
+
+	static FlashRegistersMock*& getProxyInstance()
+	{
+		static FlashRegistersMock* proxyInstance;
+		return proxyInstance;
+	}
+};
+
+/// fake register of FLASH peripheral, which forwards all accesses to FlashRegistersMock
+class FakeFlashRegister
+{
+public:
+
+	constexpr explicit FakeFlashRegister(const FlashRegistersMock::Register flashRegister) :
+			register_{flashRegister}
+	{
+
+	}
+
+	operator uint32_t() const
+	{
+		REQUIRE(FlashRegistersMock::getProxyInstance() != nullptr);
+		return FlashRegistersMock::getProxyInstance()->read(register_);
+	}
+
+	FakeFlashRegister& operator=(const uint32_t value)
+	{
+		REQUIRE(FlashRegistersMock::getProxyInstance() != nullptr);
+		FlashRegistersMock::getProxyInstance()->write(register_, value);
+		return *this;
+	}
+
+	FakeFlashRegister(const FakeFlashRegister&) = delete;
+	FakeFlashRegister& operator=(const FakeFlashRegister&) = delete;
+
+private:
+
+	/// register represented by this object
+	FlashRegistersMock::Register register_;
+};
+
+/// fake FLASH peripheral, names of registers match FLASH_TypeDef
+struct FakeFlash
+{
+	FakeFlashRegister ACR {FlashRegistersMock::Register::acr};
+	FakeFlashRegister KEYR {FlashRegistersMock::Register::keyr};
+	FakeFlashRegister OPTKEYR {FlashRegistersMock::Register::optkeyr};
+	FakeFlashRegister SR {FlashRegistersMock::Register::sr};
+	FakeFlashRegister CR {FlashRegistersMock::Register::cr};
+	FakeFlashRegister OPTCR {FlashRegistersMock::Register::optcr};
+
+	static FakeFlash& getInstance()
+	{
+		static FakeFlash instance;
+		return instance;
+	}
+};
+
+/**
+ * \return reference to fake RCC peripheral
+ */
+
+inline RCC_TypeDef& getFakeRcc()
+{
+	static RCC_TypeDef instance;
+	return instance;
+}
+
+/// mock of bus accesses to registers of SPI peripheral
+class SpiRegistersMock
+{
+public:
+
+	/// registers of SPI peripheral
+	enum class Register
+	{
+		cr1,
+		cr2,
+		sr,
+		dr,
+		crcpr,
+		rxcrcr,
+		txcrcr,
+	};
+
+	MAKE_MOCK1(read, uint32_t(Register));
+	MAKE_MOCK2(write, void(Register, uint32_t));
+
+	/// 8-bit or 16-bit accesses to DR register, first argument is the size of access in bytes
+	MAKE_MOCK1(readDataRegister, uint16_t(size_t));
+	MAKE_MOCK2(writeDataRegister, void(size_t, uint16_t));
+
+	static SpiRegistersMock*& getProxyInstance()
+	{
+		static SpiRegistersMock* proxyInstance;
+		return proxyInstance;
+	}
+};
+
+/// fake register of SPI peripheral, which forwards all accesses to SpiRegistersMock
+class FakeSpiRegister
+{
+public:
+
+	constexpr explicit FakeSpiRegister(const SpiRegistersMock::Register spiRegister) :
+			register_{spiRegister}
+	{
+
+	}
+
+	operator uint32_t() const
+	{
+		REQUIRE(SpiRegistersMock::getProxyInstance() != nullptr);
+		return SpiRegistersMock::getProxyInstance()->read(register_);
+	}
+
+	FakeSpiRegister& operator=(const uint32_t value)
+	{
+		REQUIRE(SpiRegistersMock::getProxyInstance() != nullptr);
+		SpiRegistersMock::getProxyInstance()->write(register_, value);
+		return *this;
+	}
+
+	FakeSpiRegister(const FakeSpiRegister&) = delete;
+	FakeSpiRegister& operator=(const FakeSpiRegister&) = delete;
+
+private:
+
+	/// register represented by this object
+	SpiRegistersMock::Register register_;
+};
+
+/// fake SPI peripheral, names of registers match SPI_TypeDef
+struct FakeSpi
+{
+	FakeSpiRegister CR1 {SpiRegistersMock::Register::cr1};
+	FakeSpiRegister CR2 {SpiRegistersMock::Register::cr2};
+	FakeSpiRegister SR {SpiRegistersMock::Register::sr};
+	FakeSpiRegister DR {SpiRegistersMock::Register::dr};
+	FakeSpiRegister CRCPR {SpiRegistersMock::Register::crcpr};
+	FakeSpiRegister RXCRCR {SpiRegistersMock::Register::rxcrcr};
+	FakeSpiRegister TXCRCR {SpiRegistersMock::Register::txcrcr};
+
+	static FakeSpi& getInstance()
+	{
+		static FakeSpi instance;
+		return instance;
+	}
+};
+
+}	// namespace distortos
+
+/// type of fake SPI peripheral
+using SPI_TypeDef = distortos::FakeSpi;
+
+#endif	// UNIT_TEST_INCLUDE_MOCKS_CHIP_CMSIS_PROXY_H_DISTORTOS_CHIP_CMSIS_PROXY_H_
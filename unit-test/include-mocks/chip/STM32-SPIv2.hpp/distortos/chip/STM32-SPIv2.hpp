@@ -0,0 +1,54 @@
+/**
+ * \file
+ * \brief Mock of STM32-SPIv2.hpp, which forwards accesses to DR register of fake SPI peripheral to SpiRegistersMock
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UNIT_TEST_INCLUDE_MOCKS_CHIP_STM32_SPIV2_HPP_DISTORTOS_CHIP_STM32_SPIV2_HPP_
+#define UNIT_TEST_INCLUDE_MOCKS_CHIP_STM32_SPIV2_HPP_DISTORTOS_CHIP_STM32_SPIV2_HPP_
+
+#include "distortos/chip/CMSIS-proxy.h"
+
+namespace distortos
+{
+
+namespace chip
+{
+
+/// size of RX FIFO and TX FIFO of SPIv2, bytes
+constexpr size_t spiFifoSize {4};
+
+inline uint8_t readDataRegister8(SPI_TypeDef&)
+{
+	REQUIRE(SpiRegistersMock::getProxyInstance() != nullptr);
+	return SpiRegistersMock::getProxyInstance()->readDataRegister(1);
+}
+
+inline uint16_t readDataRegister16(SPI_TypeDef&)
+{
+	REQUIRE(SpiRegistersMock::getProxyInstance() != nullptr);
+	return SpiRegistersMock::getProxyInstance()->readDataRegister(2);
+}
+
+inline void writeDataRegister8(SPI_TypeDef&, const uint8_t value)
+{
+	REQUIRE(SpiRegistersMock::getProxyInstance() != nullptr);
+	SpiRegistersMock::getProxyInstance()->writeDataRegister(1, value);
+}
+
+inline void writeDataRegister16(SPI_TypeDef&, const uint16_t value)
+{
+	REQUIRE(SpiRegistersMock::getProxyInstance() != nullptr);
+	SpiRegistersMock::getProxyInstance()->writeDataRegister(2, value);
+}
+
+}	// namespace chip
+
+}	// namespace distortos
+
+#endif	// UNIT_TEST_INCLUDE_MOCKS_CHIP_STM32_SPIV2_HPP_DISTORTOS_CHIP_STM32_SPIV2_HPP_
@@ -0,0 +1,35 @@
+/**
+ * \file
+ * \brief Mock of getBusFrequency()
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UNIT_TEST_INCLUDE_MOCKS_CHIP_GETBUSFREQUENCY_HPP_DISTORTOS_CHIP_GETBUSFREQUENCY_HPP_
+#define UNIT_TEST_INCLUDE_MOCKS_CHIP_GETBUSFREQUENCY_HPP_DISTORTOS_CHIP_GETBUSFREQUENCY_HPP_
+
+#include <cstdint>
+
+namespace distortos
+{
+
+namespace chip
+{
+
+/// frequency of all buses, Hz
+constexpr uint32_t fakeBusFrequency {80000000};
+
+constexpr uint32_t getBusFrequency(uintptr_t)
+{
+	return fakeBusFrequency;
+}
+
+}	// namespace chip
+
+}	// namespace distortos
+
+#endif	// UNIT_TEST_INCLUDE_MOCKS_CHIP_GETBUSFREQUENCY_HPP_DISTORTOS_CHIP_GETBUSFREQUENCY_HPP_
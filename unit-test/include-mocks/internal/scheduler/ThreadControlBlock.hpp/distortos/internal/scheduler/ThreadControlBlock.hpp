@@ -2,7 +2,7 @@
  * \file
  * \brief Mock of ThreadControlBlock class
  *
- * \author Copyright (C) 2017 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ * \author Copyright (C) 2017-2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
  *
  * \par License
  * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
@@ -32,7 +32,9 @@ class ThreadControlBlock : public ThreadListNode
 public:
 
 	MAKE_MOCK0(getOwnedProtocolMutexList, MutexList&());
+	MAKE_CONST_MOCK0(getRequestedSemaphoreUnits, unsigned int());
 	MAKE_MOCK1(setPriorityInheritanceMutexControlBlock, void(const MutexControlBlock*));
+	MAKE_MOCK1(setRequestedSemaphoreUnits, void(unsigned int));
 	MAKE_MOCK0(updateBoostedPriority, void());
 	MAKE_MOCK1(updateBoostedPriority, void(uint8_t));
 };
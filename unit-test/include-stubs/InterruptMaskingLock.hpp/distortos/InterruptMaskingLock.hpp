@@ -0,0 +1,57 @@
+/**
+ * \file
+ * \brief Stub of InterruptMaskingLock class
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UNIT_TEST_INCLUDE_STUBS_INTERRUPTMASKINGLOCK_HPP_DISTORTOS_INTERRUPTMASKINGLOCK_HPP_
+#define UNIT_TEST_INCLUDE_STUBS_INTERRUPTMASKINGLOCK_HPP_DISTORTOS_INTERRUPTMASKINGLOCK_HPP_
+
+#include <mutex>
+
+namespace distortos
+{
+
+/**
+ * Stub of InterruptMaskingLock, for tested objects which are shared with host threads.
+ *
+ * All locks share one recursive mutex, so critical sections of different host threads exclude each other and may be
+ * nested, just like with masked interrupts.
+ */
+
+class InterruptMaskingLock
+{
+public:
+
+	InterruptMaskingLock()
+	{
+		getMutex().lock();
+	}
+
+	~InterruptMaskingLock()
+	{
+		getMutex().unlock();
+	}
+
+	InterruptMaskingLock(const InterruptMaskingLock&) = delete;
+	InterruptMaskingLock(InterruptMaskingLock&&) = delete;
+	const InterruptMaskingLock& operator=(const InterruptMaskingLock&) = delete;
+	InterruptMaskingLock& operator=(InterruptMaskingLock&&) = delete;
+
+private:
+
+	static std::recursive_mutex& getMutex()
+	{
+		static std::recursive_mutex mutex;
+		return mutex;
+	}
+};
+
+}	// namespace distortos
+
+#endif	// UNIT_TEST_INCLUDE_STUBS_INTERRUPTMASKINGLOCK_HPP_DISTORTOS_INTERRUPTMASKINGLOCK_HPP_
@@ -0,0 +1,80 @@
+/**
+ * \file
+ * \brief Stub of Mutex class
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UNIT_TEST_INCLUDE_STUBS_MUTEX_HPP_DISTORTOS_MUTEX_HPP_
+#define UNIT_TEST_INCLUDE_STUBS_MUTEX_HPP_DISTORTOS_MUTEX_HPP_
+
+#include "distortos/MutexProtocol.hpp"
+#include "distortos/MutexType.hpp"
+
+#include <cerrno>
+#include <cstddef>
+
+namespace distortos
+{
+
+/**
+ * Stub of Mutex, for tested objects which own a mutex, but are used by one thread only.
+ *
+ * Only the number of recursive locks is tracked, so that unbalanced lock() and unlock() calls are detected.
+ */
+
+class Mutex
+{
+public:
+
+	using Protocol = MutexProtocol;
+	using Type = MutexType;
+
+	constexpr explicit Mutex(const Type type = Type::normal, const Protocol = Protocol::none, const uint8_t = {}) :
+			locksCount_{},
+			type_{type}
+	{
+
+	}
+
+	int lock()
+	{
+		if (locksCount_ != 0 && type_ != Type::recursive)
+			return EDEADLK;
+
+		++locksCount_;
+		return 0;
+	}
+
+	int tryLock()
+	{
+		if (locksCount_ != 0 && type_ != Type::recursive)
+			return EBUSY;
+
+		++locksCount_;
+		return 0;
+	}
+
+	int unlock()
+	{
+		if (locksCount_ == 0)
+			return EPERM;
+
+		--locksCount_;
+		return 0;
+	}
+
+private:
+
+	size_t locksCount_;
+
+	Type type_;
+};
+
+}	// namespace distortos
+
+#endif	// UNIT_TEST_INCLUDE_STUBS_MUTEX_HPP_DISTORTOS_MUTEX_HPP_
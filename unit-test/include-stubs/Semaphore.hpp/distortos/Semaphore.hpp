@@ -0,0 +1,117 @@
+/**
+ * \file
+ * \brief Stub of Semaphore class
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#ifndef UNIT_TEST_INCLUDE_STUBS_SEMAPHORE_HPP_DISTORTOS_SEMAPHORE_HPP_
+#define UNIT_TEST_INCLUDE_STUBS_SEMAPHORE_HPP_DISTORTOS_SEMAPHORE_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <thread>
+
+#include <cerrno>
+
+namespace distortos
+{
+
+/**
+ * Stub of Semaphore, for tested objects which own a semaphore and use it to communicate with host threads.
+ *
+ * Blocking functions yield the thread in a loop until the semaphore can be locked or until the timeout expires -
+ * durations are measured with host's std::chrono::steady_clock, time points with their own clock.
+ */
+
+class Semaphore
+{
+public:
+
+	using Value = unsigned int;
+
+	constexpr explicit Semaphore(const Value value, const Value maxValue = std::numeric_limits<Value>::max()) :
+			value_{value < maxValue ? value : maxValue},
+			maxValue_{maxValue}
+	{
+
+	}
+
+	Value getMaxValue() const
+	{
+		return maxValue_;
+	}
+
+	Value getValue() const
+	{
+		return value_;
+	}
+
+	int post()
+	{
+		auto value = value_.load();
+		do
+		{
+			if (value == maxValue_)
+				return EOVERFLOW;
+		} while (value_.compare_exchange_weak(value, value + 1) == false);
+
+		return 0;
+	}
+
+	int tryWait()
+	{
+		auto value = value_.load();
+		do
+		{
+			if (value == 0)
+				return EAGAIN;
+		} while (value_.compare_exchange_weak(value, value - 1) == false);
+
+		return 0;
+	}
+
+	template<typename Rep, typename Period>
+	int tryWaitFor(const std::chrono::duration<Rep, Period> duration)
+	{
+		const auto timePoint = std::chrono::steady_clock::now() + duration;
+		return tryWaitUntil(std::chrono::time_point_cast<std::chrono::steady_clock::duration>(timePoint));
+	}
+
+	template<typename Clock, typename Duration>
+	int tryWaitUntil(const std::chrono::time_point<Clock, Duration> timePoint)
+	{
+		while (tryWait() != 0)
+		{
+			if (Clock::now() >= timePoint)
+				return ETIMEDOUT;
+
+			std::this_thread::yield();
+		}
+
+		return 0;
+	}
+
+	int wait()
+	{
+		while (tryWait() != 0)
+			std::this_thread::yield();
+
+		return 0;
+	}
+
+private:
+
+	std::atomic<Value> value_;
+
+	Value maxValue_;
+};
+
+}	// namespace distortos
+
+#endif	// UNIT_TEST_INCLUDE_STUBS_SEMAPHORE_HPP_DISTORTOS_SEMAPHORE_HPP_
@@ -0,0 +1,210 @@
+/**
+ * \file
+ * \brief updateCrc32() test cases
+ *
+ * This test checks whether all implementations of CRC-32 give results bit-exact with a bitwise reference
+ * implementation and with the original software implementation of littlefs. Hidden test case tagged "[benchmark]"
+ * compares throughput of these implementations on the host.
+ *
+ * \author Copyright (C) 2018 Kamil Szczygiel http://www.distortec.com http://www.freddiechopin.info
+ *
+ * \par License
+ * This Source Code Form is subject to the terms of the Mozilla Public License, v. 2.0. If a copy of the MPL was not
+ * distributed with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+#include "distortos/internal/storage/updateCrc32.hpp"
+
+#include "unit-test-common.hpp"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <cstring>
+
+extern "C" void lfs_crc(uint32_t* crc, const void* buffer, size_t size);
+
+namespace
+{
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local objects
++---------------------------------------------------------------------------------------------------------------------*/
+
+/// max size of data used for comparisons with reference implementation, bytes
+constexpr size_t maxSize {300};
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| local functions
++---------------------------------------------------------------------------------------------------------------------*/
+
+/**
+ * \brief Bitwise reference implementation of CRC-32.
+ *
+ * \param [in] crc is the CRC-32 of preceding data, 0 for first chunk
+ * \param [in] buffer is the buffer with data
+ * \param [in] size is the size of \a buffer, bytes
+ *
+ * \return CRC-32 of preceding data and \a buffer
+ */
+
+uint32_t referenceCrc32(uint32_t crc, const void* const buffer, const size_t size)
+{
+	crc = ~crc;
+	const auto bufferUint8 = static_cast<const uint8_t*>(buffer);
+	for (size_t i {}; i < size; ++i)
+	{
+		crc ^= bufferUint8[i];
+		for (size_t bit {}; bit < 8; ++bit)
+			crc = (crc >> 1) ^ ((crc & 1) != 0 ? 0xedb88320 : 0);
+	}
+	return ~crc;
+}
+
+/**
+ * \brief Original software implementation of CRC-32 from littlefs' lfs_util.c.
+ *
+ * \param [in,out] crc is a pointer to CRC-32 of preceding data, 0xffffffff for first chunk
+ * \param [in] buffer is the buffer with data
+ * \param [in] size is the size of \a buffer, bytes
+ */
+
+void referenceLfsCrc(uint32_t* const crc, const void* const buffer, const size_t size)
+{
+	static const uint32_t rtable[16]
+	{
+			0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+			0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+	};
+
+	const auto data = static_cast<const uint8_t*>(buffer);
+	for (size_t i {}; i < size; ++i)
+	{
+		*crc = (*crc >> 4) ^ rtable[(*crc ^ (data[i] >> 0)) & 0xf];
+		*crc = (*crc >> 4) ^ rtable[(*crc ^ (data[i] >> 4)) & 0xf];
+	}
+}
+
+/**
+ * \brief Generates random data.
+ *
+ * \param [in] size is the size of generated data, bytes
+ *
+ * \return vector with \a size random bytes, generated with fixed seed
+ */
+
+std::vector<uint8_t> generateData(const size_t size)
+{
+	std::mt19937 generator {size};
+	std::uniform_int_distribution<int> distribution {0, UINT8_MAX};
+	std::vector<uint8_t> data (size);
+	for (auto& byte : data)
+		byte = distribution(generator);
+	return data;
+}
+
+}	// namespace
+
+/*---------------------------------------------------------------------------------------------------------------------+
+| global test cases
++---------------------------------------------------------------------------------------------------------------------*/
+
+TEST_CASE("Testing updateCrc32Software() with check values", "[software]")
+{
+	constexpr char check[] {"123456789"};
+	REQUIRE(distortos::internal::updateCrc32Software({}, check, strlen(check)) == 0xcbf43926);
+	REQUIRE(distortos::internal::updateCrc32Software({}, check, 0) == 0);
+	REQUIRE(distortos::internal::updateCrc32Software(0xcbf43926, check, 0) == 0xcbf43926);
+
+	const uint8_t zeroes[32] {};
+	REQUIRE(distortos::internal::updateCrc32Software({}, zeroes, sizeof(zeroes)) == 0x190a55ad);
+}
+
+TEST_CASE("Testing updateCrc32Software() against reference implementation", "[software]")
+{
+	const auto data = generateData(maxSize + sizeof(uint32_t));
+
+	SECTION("Whole buffer, all sizes and alignments")
+	{
+		for (size_t offset {}; offset < sizeof(uint32_t); ++offset)
+			for (size_t size {}; size <= maxSize; ++size)
+			{
+				INFO("offset: " << offset << ", size: " << size);
+				REQUIRE(distortos::internal::updateCrc32Software({}, data.data() + offset, size) ==
+						referenceCrc32({}, data.data() + offset, size));
+			}
+	}
+	SECTION("Buffer split into two chunks")
+	{
+		const auto expected = referenceCrc32({}, data.data(), maxSize);
+		for (size_t split {}; split <= maxSize; ++split)
+		{
+			INFO("split: " << split);
+			const auto crc = distortos::internal::updateCrc32Software({}, data.data(), split);
+			REQUIRE(distortos::internal::updateCrc32Software(crc, data.data() + split, maxSize - split) == expected);
+		}
+	}
+}
+
+TEST_CASE("Testing updateCrc32() against reference implementation", "[facade]")
+{
+	const auto data = generateData(maxSize);
+	for (size_t size {}; size <= maxSize; ++size)
+	{
+		INFO("size: " << size);
+		REQUIRE(distortos::internal::updateCrc32({}, data.data(), size) == referenceCrc32({}, data.data(), size));
+	}
+}
+
+TEST_CASE("Testing lfs_crc() against littlefs implementation", "[littlefs]")
+{
+	const auto data = generateData(maxSize);
+	for (size_t size {}; size <= maxSize; ++size)
+	{
+		INFO("size: " << size);
+		uint32_t crc {0xffffffff};
+		lfs_crc(&crc, data.data(), size);
+		uint32_t expected {0xffffffff};
+		referenceLfsCrc(&expected, data.data(), size);
+		REQUIRE(crc == expected);
+
+		// continuation with arbitrary state
+		lfs_crc(&crc, data.data(), maxSize - size);
+		referenceLfsCrc(&expected, data.data(), maxSize - size);
+		REQUIRE(crc == expected);
+	}
+}
+
+TEST_CASE("Benchmark of CRC-32 implementations", "[.][benchmark]")
+{
+	constexpr size_t size {1024 * 1024};
+	constexpr size_t rounds {16};
+	const auto data = generateData(size);
+
+	const auto measure = [&data](const char* const name, uint32_t (* const function)(uint32_t, const void*, size_t))
+			{
+				uint32_t crc {};
+				const auto start = std::chrono::steady_clock::now();
+				for (size_t round {}; round < rounds; ++round)
+					crc = function(crc, data.data(), data.size());
+				const std::chrono::duration<double> duration {std::chrono::steady_clock::now() - start};
+				WARN(name << ": " << size * rounds / duration.count() / 1024 / 1024 << " MB/s");
+				return crc;
+			};
+
+	const auto reference = measure("bitwise reference", referenceCrc32);
+	const auto lfs = measure("littlefs (4-bit table)",
+			[](const uint32_t crc, const void* const buffer, const size_t bufferSize)
+			{
+				auto state = ~crc;
+				referenceLfsCrc(&state, buffer, bufferSize);
+				return ~state;
+			});
+	const auto software = measure("updateCrc32Software() (slice-by-4)", distortos::internal::updateCrc32Software);
+	const auto facade = measure("updateCrc32()", distortos::internal::updateCrc32);
+
+	REQUIRE(lfs == reference);
+	REQUIRE(software == reference);
+	REQUIRE(facade == reference);
+}